@@ -161,7 +161,18 @@ class OmArchive
     /// \return Entry file compression method
     ///
     int32_t entryMethod(size_t i) const;
-
+
+    /// \brief Get entry CRC-32
+    ///
+    /// Returns the CRC-32 of the specified entry uncompressed data as
+    /// recorded in zip central-directory.
+    ///
+    /// \param[in] i       : Entry index
+    ///
+    /// \return Entry file CRC-32 value
+    ///
+    uint32_t entryCrc(size_t i) const;
+
     /// \brief Extract and save as file
     ///
     /// Extract and save specified entry as file
@@ -206,6 +217,20 @@ class OmArchive
     ///
     uint32_t entryLocate(const OmWString& filename) const;
 
+    /// \brief Copy entry from another zip
+    ///
+    /// Copy the specified entry of another zip opened for reading to this
+    /// zip opened for writing. Entry data is copied as raw compressed data
+    /// without being decompressed then compressed again.
+    ///
+    /// \param[in] source  : Source zip opened for reading
+    /// \param[in] i       : Source entry index
+    /// \param[in] dst     : Destination entry filename/path
+    ///
+    /// \return True if operation succeed, false otherwise
+    ///
+    bool entryCopy(const OmArchive& source, size_t i, const OmWString& dst) const;
+
     /// \brief Close and finalize the zip file.
     ///
     /// Close the zip file handle, and finalize archive if zip was
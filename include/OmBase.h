@@ -64,6 +64,12 @@ typedef std::wstring OmWString;
 ///
 typedef std::vector<OmWString> OmWStringArray;
 
+/// \brief STL string array
+///
+/// Typedef for an STL vector of STL char string type
+///
+typedef std::vector<OmCString> OmCStringArray;
+
 /// \brief STL wstring queue
 ///
 /// Typedef for an STL deque of STL wide char string type
@@ -46,10 +46,13 @@
 #define OM_XMAGIC_BCK             L"Open_Mod_Manager_Backup"
 
 #define OM_XMAGIC_REP             L"Open_Mod_Manager_Repository"
+#define OM_XMAGIC_RBC             L"Open_Mod_Manager_Build_Cache"
 
 #define OM_XML_DEF_EXT            L"omx"
 #define OM_PKG_FILE_EXT           L"ozp"
 #define OM_BCK_FILE_EXT           L"ozb"
+#define OM_REP_IDX_FILE_EXT       L"omr"
+#define OM_REP_BLD_CACHE_EXT      L"cache"
 
 #define OM_MODHUB_FILENAME        L"hub.omx"
 #define OM_MODCHN_FILENAME        L"channel.omx"
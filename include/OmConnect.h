@@ -18,7 +18,6 @@
 #define OMCONNECT_H
 
 #include "OmBase.h"
-#include "OmBaseWin.h"
 
 /// \brief Network socket object
 ///
@@ -53,6 +52,22 @@ class OmConnect
     ///
     OmResult requestHttpGet(const OmWString& url, OmCString* reponse, uint32_t rate = 0);
 
+    /// \brief Http Get request stream
+    ///
+    /// Send an HTTP GET request then provides received data chunks to callback
+    /// as they arrive, without buffering the whole response. This function does
+    /// not use thread and block until response or time out. The callback may
+    /// call abortRequest() to stop the transfer.
+    ///
+    /// \param[in] url          : Target URL for HTTP request.
+    /// \param[in] response_cb  : Callback to receive response data chunks.
+    /// \param[in] user_ptr     : Custom pointer to pass to callback.
+    /// \param[in] limit        : Download max rate in bytes per seconds (0 for no limit)
+    ///
+    /// \return Result code of the request
+    ///
+    OmResult requestHttpStream(const OmWString& url, Om_responseCb response_cb, void* user_ptr = nullptr, uint32_t rate = 0);
+
     /// \brief Http Get request once
     ///
     /// Send an HTTP GET request then provides received data once done.
@@ -186,12 +201,16 @@ class OmConnect
 
     void*               _perform_hwo;
 
-    static DWORD WINAPI _perform_run_fn(void*);
+    static uint32_t     _perform_run_fn(void*);
 
-    static VOID WINAPI  _perform_end_fn(void*,uint8_t);
+    static void         _perform_end_fn(void*,uint8_t);
+
+    OmResult            _perform_sync(const OmWString&, bool, uint32_t);
 
     static size_t       _perform_write_mem_fn(char*, size_t, size_t, void*);
 
+    static size_t       _perform_write_cbk_fn(char*, size_t, size_t, void*);
+
     static size_t       _perform_write_fio_fn(char*, size_t, size_t, void*);
 
     static int          _perform_progress_fn(void*, int64_t, int64_t, int64_t, int64_t);
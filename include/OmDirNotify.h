@@ -18,12 +18,26 @@
 #define OMDIRNOTIFY_H
 
 #include "OmBase.h"
-#include "OmBaseWin.h"
+
+/// \brief Directory changes batch callback.
+///
+/// Callback function for coalesced directory changes notifications.
+///
+/// \param[in]  ptr     : User data pointer.
+/// \param[in]  created : Paths to created items, available for read/write.
+/// \param[in]  altered : Paths to modified items.
+/// \param[in]  deleted : Paths to deleted or renamed items.
+///
+typedef void (*Om_dirBatchCb)(void* ptr, const OmWStringArray& created, const OmWStringArray& altered, const OmWStringArray& deleted);
 
 /// \brief Directory monitoring class
 ///
 /// Class to provide directory changes monitoring
 ///
+/// Changes are accumulated and coalesced until no new change is received
+/// during a delay, then delivered either at once to the batch callback or
+/// one by one to the notification callback.
+///
 class OmDirNotify
 {
   public:
@@ -52,6 +66,28 @@ class OmDirNotify
     ///
     void setCallback(Om_notifyCb notify_cb, void* user_ptr);
 
+    /// \brief Set batch callback
+    ///
+    /// Set callback function and custom pointer for coalesced changes
+    /// notifications. If defined, the batch callback is used instead of
+    /// the notification callback.
+    ///
+    /// \param[in] batch_cb   : Callback for coalesced changes
+    /// \param[in] user_ptr   : Custom pointer passed to callback
+    ///
+    void setBatchCallback(Om_dirBatchCb batch_cb, void* user_ptr);
+
+    /// \brief Set batch delay
+    ///
+    /// Set delay without new change to wait for before delivering the
+    /// accumulated changes.
+    ///
+    /// \param[in] delay      : Delay in milliseconds
+    ///
+    void setBatchDelay(uint32_t delay) {
+      this->_batch_delay = delay;
+    }
+
     /// \brief Start monitoring
     ///
     /// Starts the monitoring of the directory specified in path.
@@ -84,29 +120,41 @@ class OmDirNotify
 
     void*                 _user_ptr;
 
+    Om_dirBatchCb         _batch_cb;
+
+    void*                 _batch_ptr;
+
 
     OmWStringArray        _added_queue;
 
-    OmWStringArray        _modif_queue;
+    std::vector<uint64_t> _added_stamp;
 
+    void                  _added_push(const OmWString& path, uint64_t stamp);
 
-    void*                 _stop_hev;
+    void                  _added_check(uint64_t stamp);
 
 
-    void*                 _changes_hth;
+    OmWStringArray        _batch_created;
 
-    static DWORD WINAPI   _changes_run_fn(void*);
+    OmWStringArray        _batch_altered;
 
+    OmWStringArray        _batch_deleted;
 
-    void*                 _access_check_hth;
+    uint64_t              _batch_stamp;
 
-    void*                 _access_check_hwo;
+    uint32_t              _batch_delay;
 
-    void                  _access_check_add(const OmWString& path);
+    void                  _batch_push(OmNotify notify, const OmWString& path);
 
-    static DWORD WINAPI   _access_check_run_fn(void*);
+    void                  _batch_flush();
+
+
+    void*                 _stop_hev;
+
+
+    void*                 _changes_hth;
 
-    static VOID WINAPI    _access_check_end_fn(void*,uint8_t);
+    static uint32_t       _changes_run_fn(void*);
 
 };
 
@@ -18,7 +18,10 @@
 #define OMIMAGE_H
 
 #include "OmBase.h"
-#include "OmBaseWin.h"
+
+#ifdef _WIN32
+  #include "OmBaseWin.h"    //< HBITMAP
+#endif
 
 #include "OmUtilImg.h"
 
@@ -209,9 +212,11 @@ class OmImage
     ///
     /// \return Last generated thumbnail bitmap or null if none was generated.
     ///
+    #ifdef _WIN32
     HBITMAP hbmp() const {
       return _hbmp;
     }
+    #endif
 
     /// \brief Clear instance.
     ///
@@ -237,7 +242,9 @@ class OmImage
 
     unsigned            _height;      //< Image height
 
+    #ifdef _WIN32
     HBITMAP             _hbmp;        //< Corresponding HBITMAP
+    #endif
 
     bool                _valid;       //< Valid image
 
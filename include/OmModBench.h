@@ -0,0 +1,240 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OMMODBENCH_H
+#define OMMODBENCH_H
+
+#include "OmBase.h"
+
+class OmModMan;
+class OmModChan;
+
+/// \brief Benchmark dependency shapes
+///
+/// Shapes of dependency graph between generated Mods
+///
+enum OmBenchDepends : int32_t
+{
+  OM_BENCH_DEPENDS_NONE   = 0,  //< no dependency
+  OM_BENCH_DEPENDS_CHAIN  = 1,  //< each Mod depends on the previous one
+  OM_BENCH_DEPENDS_STAR   = 2,  //< each Mod depends on the first one
+  OM_BENCH_DEPENDS_TREE   = 3   //< each Mod depends on its binary tree parent
+};
+
+/// \brief Benchmark steps
+///
+/// Steps to run as bit flags, the Mod operations step uses the generated
+/// library, other steps time and verify single processing kernels.
+///
+enum OmBenchSteps : uint32_t
+{
+  OM_BENCH_STEP_MODS      = 0x1,  //< Mod operations passes
+  OM_BENCH_STEP_UTF       = 0x2,  //< UTF-8/UTF-16 transcoder
+  OM_BENCH_STEP_TREE      = 0x4,  //< Folder tree walker
+  OM_BENCH_STEP_IMAGE     = 0x8,  //< Image resampler
+  OM_BENCH_STEP_QUANTIZE  = 0x10, //< GIF palette quantizer
+  OM_BENCH_STEP_HASH      = 0x20, //< Files checksums
+  OM_BENCH_STEP_INDEX     = 0x40, //< Repository binary index
+  OM_BENCH_STEP_LOG       = 0x80, //< Log contention
+  OM_BENCH_STEP_XML       = 0x100 //< XML children iteration
+};
+
+/// \brief Benchmark default parameters
+///
+/// Default parameters of synthetic library generation
+///
+#define OM_BENCH_DEF_MODS       50
+#define OM_BENCH_DEF_FILES      100
+#define OM_BENCH_DEF_SIZE       65536
+#define OM_BENCH_DEF_OVERLAP    10
+#define OM_BENCH_DEF_PASSES     3
+#define OM_BENCH_DEF_STEPS      0xFFFFFFFF
+
+/// \brief Benchmark configuration
+///
+/// Structure to describe synthetic library to generate and how
+/// benchmark is run.
+///
+typedef struct OmModBenchCfg_
+{
+  size_t        mods;       ///< Count of generated Mods
+  size_t        files;      ///< Count of files per Mod
+  uint64_t      size;       ///< Size of each file in bytes
+  unsigned      overlap;    ///< Percentage of each Mod files shared with other Mods
+  int32_t       depends;    ///< Dependency graph shape
+  int32_t       method;     ///< Packages compression method
+  int32_t       level;      ///< Packages compression level
+  unsigned      passes;     ///< Count of benchmark passes
+  uint32_t      steps;      ///< Steps to run, combination of OmBenchSteps flags
+
+} OmModBenchCfg_t;
+
+/// \brief Mod operations benchmark
+///
+/// Object to generate a synthetic Mod library with its Mod Hub, Channel
+/// and target directory, then time the Channel operations on it. Timings
+/// are recorded as performance spans.
+///
+class OmModBench
+{
+  public: ///         - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    /// \brief Constructor.
+    ///
+    /// Constructor with Mod Manager.
+    ///
+    /// \param[in]  ModMan  : Mod Manager used to create Mod Hub and Channel.
+    ///
+    OmModBench(OmModMan* ModMan);
+
+    /// \brief Destructor.
+    ///
+    /// Default destructor.
+    ///
+    ~OmModBench();
+
+    /// \brief Initialize configuration
+    ///
+    /// Sets benchmark configuration to default parameters.
+    ///
+    /// \param[out] cfg     : Pointer to configuration to initialize.
+    ///
+    static void initConfig(OmModBenchCfg_t* cfg);
+
+    /// \brief Parse configuration parameter
+    ///
+    /// Parses the given <key>=<value> parameter string and sets the
+    /// corresponding configuration member.
+    ///
+    /// \param[out] cfg     : Pointer to configuration to modify.
+    /// \param[in]  param   : Parameter string to parse.
+    ///
+    /// \return True if parameter was recognized, false otherwise.
+    ///
+    static bool parseConfig(OmModBenchCfg_t* cfg, const OmWString& param);
+
+    /// \brief Configuration string
+    ///
+    /// Returns the given configuration as <key>=<value> parameters list.
+    ///
+    /// \param[in]  cfg     : Configuration to describe.
+    ///
+    /// \return Configuration string.
+    ///
+    static OmWString configString(const OmModBenchCfg_t& cfg);
+
+    /// \brief Generate library
+    ///
+    /// Creates synthetic Mod packages, repository definition, Mod Hub and
+    /// Channel in the specified folder, which must be empty or not exist.
+    /// Generated data only depends on configuration.
+    ///
+    /// \param[in]  path        : Path to benchmark working folder.
+    /// \param[in]  cfg         : Benchmark configuration.
+    /// \param[in]  progress_cb : Optional callback for generation progress.
+    /// \param[in]  user_ptr    : Custom pointer to be passed to callback.
+    ///
+    /// \return Operation result code.
+    ///
+    OmResult generate(const OmWString& path, const OmModBenchCfg_t& cfg, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
+
+    /// \brief Run benchmark
+    ///
+    /// Runs the configured steps. The Mod operations step runs the configured
+    /// count of passes over the generated library, each pass reloads library,
+    /// installs then restores all Mods. If a repository URL is given, the
+    /// repository definition is queried once then network library is refreshed
+    /// in each pass. Other steps run their kernel the configured count of passes
+    /// and fail if results differ from reference.
+    ///
+    /// \param[in]  repo_url    : Base URL where working folder is served, or
+    ///                           empty string to skip network library.
+    /// \param[in]  progress_cb : Optional callback for passes progress.
+    /// \param[in]  user_ptr    : Custom pointer to be passed to callback.
+    ///
+    /// \return Operation result code.
+    ///
+    OmResult run(const OmWString& repo_url, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
+
+    /// \brief Save results
+    ///
+    /// Saves recorded timings as JSON to the specified file.
+    ///
+    /// \param[in]  path    : Path to file to write.
+    ///
+    /// \return True if operation succeed, false otherwise.
+    ///
+    bool saveResults(const OmWString& path);
+
+    /// \brief Get last error string
+    ///
+    /// Returns last error message string.
+    ///
+    /// \return Last error message string.
+    ///
+    const OmWString& lastError() const {
+      return this->_lasterr;
+    }
+
+  private: ///          - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    // linking
+    OmModMan*           _ModMan;
+
+    // parameters
+    OmModBenchCfg_t     _cfg;
+
+    OmWString           _path;
+
+    // generation
+    bool                _gen_source(size_t index, const OmWString& path);
+
+    // benchmark
+    OmResult            _run_pass(OmModChan* ModChan);
+
+    OmResult            _query_repository(OmModChan* ModChan, const OmWString& repo_url);
+
+    OmResult            _step_utf();
+
+    OmResult            _step_tree();
+
+    OmResult            _step_image();
+
+    OmResult            _step_quantize();
+
+    OmResult            _step_hash();
+
+    OmResult            _step_index();
+
+    OmResult            _step_log();
+
+    OmResult            _step_xml();
+
+    void*               _query_hev;
+
+    OmResult            _query_result;
+
+    static void         _query_result_fn(void* ptr, OmResult result, uint64_t param);
+
+    static void         _query_notify_fn(void* ptr, OmNotify notify, uint64_t param);
+
+    // logs and errors
+    OmWString           _lasterr;
+
+    void                _error(const OmWString& origin, const OmWString& detail);
+};
+
+#endif // OMMODBENCH_H
@@ -61,13 +61,37 @@ class OmModChan
 
     /// \brief Open Mod Channel.
     ///
-    /// Load Mod Channel from specified file.
+    /// Load Mod Channel from specified file. If deferred, only the definition
+    /// is parsed and Mod Library loading is postponed until the channel is
+    /// activated.
     ///
     /// \param[in]  path    : File path of Mod Channel to be loaded.
+    /// \param[in]  defer   : Do not load Mod Library.
     ///
     /// \return True if operation succeed, false otherwise.
     ///
-    bool open(const OmWString& path);
+    bool open(const OmWString& path, bool defer = false);
+
+    /// \brief Activate Mod Channel.
+    ///
+    /// Load Mod Library and starts library monitoring if not already done,
+    /// this is required before any access to a channel opened with deferred
+    /// loading.
+    ///
+    /// \return True if Mod Library was loaded by this call, false if channel
+    ///         was already activated.
+    ///
+    bool activate();
+
+    /// \brief Check whether activated.
+    ///
+    /// Checks whether Mod Library was loaded.
+    ///
+    /// \return True if channel is activated, false otherwise.
+    ///
+    bool activated() const {
+      return this->_activated;
+    }
 
     /// \brief Rename Mod Channel
     ///
@@ -348,6 +372,19 @@ class OmModChan
     ///
     OmModPack* findModDepend(const OmWString& filter, bool installed = false) const;
 
+    /// \brief find best suitable dependency
+    ///
+    /// Search for the most suitable Mod version according dependency of the
+    /// given Mod at specified index, using its precompiled identity filter.
+    ///
+    /// \param[in] ModPack    : Mod to get dependency from.
+    /// \param[in] i          : Index of dependency.
+    /// \param[in] installed  : Search among installed Mods only.
+    ///
+    /// \return Most suitable Mod or nullptr if not found.
+    ///
+    OmModPack* findModDepend(const OmModPack* ModPack, size_t i, bool installed = false) const;
+
     /// \brief Check whether is dependency
     ///
     /// Check whether the specified Mod is a dependency of any other in the current Library
@@ -424,6 +461,24 @@ class OmModChan
     ///
     void prepareCleaning(const OmPModPackArray& selection, OmPModPackArray* restores, OmWStringArray* depends, OmWStringArray* overlappers, OmWStringArray* dependents) const;
 
+    /// \brief Prepare Preset transition
+    ///
+    /// Computes the Mods operations required to switch from the current installed
+    /// state to the given Mods selection. Installed Mods that are part of the
+    /// selection, or required by it as dependency, are kept in place unless they
+    /// overlap or depend on a Mod to be restored, in which case they are restored
+    /// then installed again in their original order.
+    ///
+    /// Restores list is sorted so each Mod can be restored without implying other
+    /// restoration, installs list is sorted so dependencies are installed first.
+    ///
+    /// \param[in]  selection     : List of Mods that should be installed.
+    /// \param[in]  install_only  : Do not restore Mods outside the selection.
+    /// \param[out] restores      : Ordered list of Mods to be restored.
+    /// \param[out] installs      : Ordered list of Mods to be installed.
+    ///
+    void preparePreset(const OmPModPackArray& selection, bool install_only, OmPModPackArray* restores, OmPModPackArray* installs) const;
+
     /// \brief Add Mods to Mod-Operations queue
     ///
     /// Add to Mod-Operations queue the given Mods.
@@ -505,7 +560,7 @@ class OmModChan
     /// \return True if Mod library is locked, false otherwise
     ///
     bool lockedModLibrary() const {
-      return this->_locked_mod_library;
+      return (this->_locked_mod_library != 0);
     }
 
     /// \brief Discard all backup data
@@ -1108,6 +1163,25 @@ class OmModChan
     ///
     void setBackupOverlap(bool enable);
 
+    /// \brief Parallel Restore option
+    ///
+    /// Returns Parallel Backup Restore option value.
+    ///
+    /// \return Parallel Restore option value.
+    ///
+    bool backupParallel() const {
+      return this->_backup_parallel;
+    }
+
+    /// \brief Set Parallel Restore option.
+    ///
+    /// Define Parallel Backup Restore option value. When enabled, Backup
+    /// files are restored using several worker threads.
+    ///
+    /// \param[in]  enable    : Parallel Restore enable or disable.
+    ///
+    void setBackupParallel(bool enable);
+
     /// \brief Get package legacy support size option.
     ///
     /// Returns package legacy support option value.
@@ -1432,6 +1506,8 @@ class OmModChan
 
     int32_t               _index;
 
+    bool                  _activated;
+
     // channel main paths
     OmWString             _target_path;
 
@@ -1459,7 +1535,9 @@ class OmModChan
     // library monitoring
     OmDirNotify           _monitor;
 
-    static void           _monitor_notify_fn(void*, OmNotify, uint64_t);
+    static void           _monitor_batch_fn(void*, const OmWStringArray&, const OmWStringArray&, const OmWStringArray&);
+
+    static bool           _monitor_job_fn(void*, size_t, unsigned);
 
     Om_notifyCb           _modpack_notify_cb;
 
@@ -1485,7 +1563,7 @@ class OmModChan
     void                  _get_replace_breaking(const OmNetPack*, OmWStringArray*) const;
 
     // threads management
-    bool                  _locked_mod_library;
+    volatile int32_t      _locked_mod_library;
 
     bool                  _locked_net_library;
 
@@ -1502,11 +1580,11 @@ class OmModChan
 
     uint32_t              _modops_percent;
 
-    static DWORD WINAPI   _modops_run_fn(void*);
+    static uint32_t       _modops_run_fn(void*);
 
     static bool           _modops_progress_fn(void*, size_t, size_t, uint64_t);
 
-    static VOID WINAPI    _modops_end_fn(void*,uint8_t);
+    static void          _modops_end_fn(void*,uint8_t);
 
     Om_beginCb            _modops_begin_cb;
 
@@ -1535,14 +1613,22 @@ class OmModChan
 
     void*                 _download_start_hwo;
 
-    static DWORD WINAPI   _download_start_run_fn(void*);
+    static uint32_t       _download_start_run_fn(void*);
 
-    static VOID WINAPI    _download_start_end_fn(void*,uint8_t);
+    static void          _download_start_end_fn(void*,uint8_t);
 
     static void           _download_result_fn(void*, OmResult, uint64_t);
 
     static bool           _download_download_fn(void*, int64_t, int64_t, int64_t, uint64_t);
 
+    void                  _download_close(OmNetPack*, OmResult);
+
+    OmPNetPackArray       _download_final;
+
+    bool                  _download_finalizing;
+
+    void*                 _download_final_lk;
+
     Om_beginCb            _download_begin_cb;
 
     Om_downloadCb         _download_download_cb;
@@ -1566,11 +1652,11 @@ class OmModChan
 
     uint32_t              _supersed_percent;
 
-    static DWORD WINAPI   _supersed_run_fn(void*);
+    static uint32_t       _supersed_run_fn(void*);
 
     static bool           _supersed_progress_fn(void*, size_t, size_t, uint64_t);
 
-    static VOID WINAPI    _supersed_end_fn(void*,uint8_t);
+    static void          _supersed_end_fn(void*,uint8_t);
 
     Om_beginCb            _supersed_begin_cb;
 
@@ -1595,9 +1681,11 @@ class OmModChan
 
     uint32_t              _query_percent;
 
-    static DWORD WINAPI   _query_run_fn(void*);
+    static uint32_t       _query_run_fn(void*);
+
+    static bool           _query_ref_fn(void*, const OmNetRef_t*);
 
-    static VOID WINAPI    _query_end_fn(void*,uint8_t);
+    static void          _query_end_fn(void*,uint8_t);
 
     Om_beginCb            _query_begin_cb;
 
@@ -1624,6 +1712,8 @@ class OmModChan
 
     bool                  _backup_overlap;
 
+    bool                  _backup_parallel;
+
     bool                  _warn_extra_unin;
 
     bool                  _warn_extra_dnld;
@@ -1655,6 +1745,8 @@ class OmModChan
     static bool           _compare_net_cate(const OmNetPack* a, const OmNetPack* b);
     static bool           _compare_net_size(const OmNetPack* a, const OmNetPack* b);
 
+    void                  _insert_modpack(OmModPack* ModPack);
+
     // logs and errors
     void                  _log(unsigned level, const OmWString& origin, const OmWString& detail) const;
 
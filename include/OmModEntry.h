@@ -0,0 +1,287 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OMMODENTRY_H
+#define OMMODENTRY_H
+
+#include "OmBase.h"
+#include <unordered_map>
+
+/// \brief Mod Entry Attributes
+///
+/// Attributes mask for Mod Entry structure
+///
+enum OmModEntAttr : int32_t {
+  OM_MODENTRY_DIR    =   0x1,
+  OM_MODENTRY_DEL    =   0x2
+};
+
+/// \brief Mod Entry structure
+///
+/// Structure to describe a Mod entry, which is a file or folder to be
+/// installed or restored which Package or Backup contain or references.
+///
+typedef struct OmModEntry_
+{
+  int32_t       attr;   ///< Entry attributes bits
+  OmWString     path;   ///< Entry relative path
+  int32_t       cdid;   ///< Entry zip central-directory index
+
+} OmModEntry_t;
+
+/// \brief OmModEntry_t array
+///
+/// Typedef for an STL vector of OmModEntry_t type
+///
+typedef std::vector<OmModEntry_t> OmModEntryArray;
+
+/// \brief Mod Entry table
+///
+/// Compact storage for Mod entries list. Directory parts of entries path
+/// are interned as a tree of segments, so common parent directories are
+/// stored only once, names are stored in a single character pool and each
+/// entry is a small fixed-size record referencing its parent directory.
+///
+/// Each entry also holds a case-insensitive hash of its full path, computed
+/// while adding, to quickly sort out paths that cannot match. Entries are
+/// indexed by this hash, so an entry can be found without walking the
+/// whole table.
+///
+/// Entries are given back as OmModEntry_t view structures with path built
+/// on demand. Table can be read concurrently but must not be modified
+/// while being read.
+///
+class OmModEntryTable
+{
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// Default constructor.
+    ///
+    OmModEntryTable();
+
+    /// \brief Destructor.
+    ///
+    /// Default destructor.
+    ///
+    ~OmModEntryTable();
+
+    /// \brief Entry count
+    ///
+    /// Returns count of entries in table.
+    ///
+    /// \return Entry count.
+    ///
+    size_t size() const {
+      return this->_entry.size();
+    }
+
+    /// \brief Check whether empty
+    ///
+    /// Checks whether table has no entry.
+    ///
+    /// \return True if table is empty, false otherwise.
+    ///
+    bool empty() const {
+      return this->_entry.empty();
+    }
+
+    /// \brief Add entry
+    ///
+    /// Adds a new entry at end of table.
+    ///
+    /// \param[in]  entry   : Entry to add.
+    ///
+    void push_back(const OmModEntry_t& entry) {
+      this->add(entry.path, entry.attr, entry.cdid);
+    }
+
+    /// \brief Add entry
+    ///
+    /// Adds a new entry at end of table.
+    ///
+    /// \param[in]  path    : Entry relative path.
+    /// \param[in]  attr    : Entry attributes bits.
+    /// \param[in]  cdid    : Entry zip central-directory index.
+    ///
+    void add(const OmWString& path, int32_t attr, int32_t cdid);
+
+    /// \brief Get entry
+    ///
+    /// Returns view of entry at specified index.
+    ///
+    /// \param[in]  i       : Entry index.
+    ///
+    /// \return Entry structure.
+    ///
+    OmModEntry_t operator[](size_t i) const;
+
+    /// \brief Get entry attributes
+    ///
+    /// Returns attributes bits of entry at specified index.
+    ///
+    /// \param[in]  i       : Entry index.
+    ///
+    /// \return Entry attributes bits.
+    ///
+    int32_t attr(size_t i) const {
+      return this->_entry[i].attr;
+    }
+
+    /// \brief Get entry central-directory index
+    ///
+    /// Returns zip central-directory index of entry at specified index.
+    ///
+    /// \param[in]  i       : Entry index.
+    ///
+    /// \return Zip central-directory index.
+    ///
+    int32_t cdid(size_t i) const {
+      return this->_entry[i].cdid;
+    }
+
+    /// \brief Get entry path hash
+    ///
+    /// Returns case-insensitive hash of entry path, as computed by
+    /// the hashPath function.
+    ///
+    /// \param[in]  i       : Entry index.
+    ///
+    /// \return Path hash value.
+    ///
+    uint64_t hash(size_t i) const {
+      return this->_entry[i].hash;
+    }
+
+    /// \brief Get entry path
+    ///
+    /// Builds relative path of entry at specified index.
+    ///
+    /// \param[in]  i       : Entry index.
+    ///
+    /// \return Entry relative path.
+    ///
+    OmWString path(size_t i) const;
+
+    /// \brief Get entry path
+    ///
+    /// Builds relative path of entry at specified index into the given
+    /// string, so its buffer can be reused.
+    ///
+    /// \param[in]  i       : Entry index.
+    /// \param[out] path    : Pointer to string that receive path.
+    ///
+    void getPath(size_t i, OmWString* path) const;
+
+    /// \brief Find entry
+    ///
+    /// Search for entry with the specified path and attributes.
+    ///
+    /// \param[in]  path    : Entry relative path, case sensitive.
+    /// \param[in]  attr    : Entry attributes bits.
+    ///
+    /// \return Entry index or -1 if not found.
+    ///
+    int32_t indexOf(const OmWString& path, int32_t attr) const;
+
+    /// \brief Find first entry by hash
+    ///
+    /// Search for the first entry whose path has the specified hash, other
+    /// entries with the same hash are then given by nextOfHash().
+    ///
+    /// \param[in]  hash    : Path hash as computed by hashPath().
+    ///
+    /// \return Entry index or -1 if not found.
+    ///
+    int32_t firstOfHash(uint64_t hash) const;
+
+    /// \brief Find next entry by hash
+    ///
+    /// Returns the next entry whose path has the same hash than entry at
+    /// specified index.
+    ///
+    /// \param[in]  i       : Entry index.
+    ///
+    /// \return Entry index or -1 if no more entry.
+    ///
+    int32_t nextOfHash(size_t i) const;
+
+    /// \brief Clear table
+    ///
+    /// Removes all entries and releases memory.
+    ///
+    void clear();
+
+    /// \brief Swap tables
+    ///
+    /// Exchanges content with the other table.
+    ///
+    /// \param[in]  other   : Other table.
+    ///
+    void swap(OmModEntryTable& other);
+
+    /// \brief Path hash
+    ///
+    /// Computes case-insensitive hash of the given path, the same way it is
+    /// computed for table entries.
+    ///
+    /// \param[in]  path    : Path to compute hash.
+    ///
+    /// \return Path hash value.
+    ///
+    static uint64_t hashPath(const OmWString& path);
+
+  private:
+
+    // directory segment node
+    typedef struct {
+      uint32_t          parent;   //< parent node, __NO_NODE at root
+      uint32_t          name_off; //< name offset in pool
+      uint32_t          name_len; //< name length
+      uint32_t          path_len; //< full path length
+      uint64_t          hash;     //< case-insensitive full path hash
+    } _node_t;
+
+    // entry record
+    typedef struct {
+      uint32_t          parent;   //< parent node, __NO_NODE at root
+      uint32_t          name_off; //< name offset in pool
+      uint32_t          name_len; //< name length
+      int32_t           attr;     //< attributes bits
+      int32_t           cdid;     //< zip central-directory index
+      uint32_t          next;     //< next entry with same hash, __NO_NODE at end
+      uint64_t          hash;     //< case-insensitive full path hash
+    } _entry_t;
+
+    std::vector<_entry_t> _entry;
+
+    std::vector<_node_t>  _node;
+
+    std::vector<wchar_t>  _pool;
+
+    // segment lookup, keyed by parent node and name hash
+    std::map<uint64_t, uint32_t> _node_map;
+
+    // entry lookup, first entry keyed by path hash
+    std::unordered_map<uint64_t, uint32_t> _hash_map;
+
+    uint32_t            _get_node(uint32_t parent, const wchar_t* name, size_t len);
+
+    void                _get_path(uint32_t parent, const wchar_t* name, size_t len, OmWString* path) const;
+};
+
+#endif // OMMODENTRY_H
@@ -19,7 +19,10 @@
 #define OMMODHUB_H
 
 #include "OmBase.h"
-#include "OmBaseWin.h"
+
+#ifdef _WIN32
+  #include "OmBaseWin.h"    //< HICON
+#endif
 
 #include "OmXmlConf.h"
 
@@ -28,6 +31,25 @@ class OmModMan;
 #include "OmModPset.h"
 #include "OmDirNotify.h"
 
+/// \brief Mod Channel operations structure
+///
+/// Structure to describe Mod operations to be performed on a Mod Channel
+/// by the Mod Hub operations scheduler.
+///
+typedef struct OmModOps_
+{
+  OmModChan*        ModChan;  ///< Mod Channel to operate on
+  OmPModPackArray   restores; ///< Mods to be restored, in order
+  OmPModPackArray   installs; ///< Mods to be installed, in order
+
+} OmModOps_t;
+
+/// \brief OmModOps_t array
+///
+/// Typedef for an STL vector of OmModOps_t type
+///
+typedef std::vector<OmModOps_t> OmModOpsArray;
+
 /// \brief Mod Hub object.
 ///
 /// The Mod Hub object describe a global environment for package management.
@@ -139,9 +161,11 @@ class OmModHub
     ///
     /// \return Banner bitmap handle.
     ///
+    #ifdef _WIN32
     const HICON& icon() const {
       return this->_icon_handle;
     }
+    #endif
     /// \brief Get Mod Hub icon source path.
     ///
     /// Returns Mod Hub icon source path.
@@ -245,6 +269,15 @@ class OmModHub
     ///
     void sortChannels();
 
+    /// \brief Activate Mod Channels.
+    ///
+    /// Ensures Mod Library of every Mod Channel is loaded. Mod Channels are
+    /// opened with deferred library loading and activated once selected, this
+    /// must be called before any operation involving all Mod Channels libraries
+    /// such as Presets setup.
+    ///
+    void activateChannels();
+
     /// \brief Select Mod Channel.
     ///
     /// Sets the specified Mod Channel as active one.
@@ -399,22 +432,69 @@ class OmModHub
       return this->_locked_presets;
     }
 
+    /// \brief Check Mod Channels storage overlap
+    ///
+    /// Checks whether the two given Mod Channels share a target, library
+    /// or backup directory, or have one nested in another, meaning their
+    /// Mod operations cannot be performed concurrently.
+    ///
+    /// \param[in] ModChanA    : First Mod Channel to check
+    /// \param[in] ModChanB    : Second Mod Channel to check
+    ///
+    /// \return True if storage overlaps, false otherwise
+    ///
+    static bool channelsOverlap(const OmModChan* ModChanA, const OmModChan* ModChanB);
+
+    /// \brief Execute Mod operations on several Mod Channels
+    ///
+    /// Performs restores then installs of each given Mod Channel operations set.
+    /// Mod Channels with overlapping storage are grouped and processed one after
+    /// another, independent groups are processed concurrently, within the limit
+    /// of the specified count of simultaneous groups.
+    ///
+    /// Callbacks are the same as for Mod Channel Mod operations, they are
+    /// called from worker threads but never simultaneously. Progress is
+    /// reported as global progress of all operations, where each Mod Channel
+    /// takes its share according its count of Mod operations.
+    ///
+    /// \param[in] operations   : Mod operations to perform per Mod Channel
+    /// \param[in] begin_cb     : Callback for each Mod operation begin
+    /// \param[in] progress_cb  : Callback for Mod operation progression
+    /// \param[in] result_cb    : Callback for each Mod operation result
+    /// \param[in] user_ptr     : User pointer to pass to callbacks
+    /// \param[in] io_limit     : Maximum count of groups processed simultaneously, 0 for default
+    ///
+    /// \return Operation result code
+    ///
+    OmResult execModOps(const OmModOpsArray& operations, Om_beginCb begin_cb = nullptr, Om_progressCb progress_cb = nullptr, Om_resultCb result_cb = nullptr, void* user_ptr = nullptr, unsigned io_limit = 0);
+
+    /// \brief Abort Mod operations on several Mod Channels
+    ///
+    /// Abort processing Mod operations started with execModOps.
+    ///
+    void abortModOps();
+
     /// \brief Add Mod Preset to execution queue
     ///
     /// Adds the given Mod Preset to the execution queue. The Presets will be executed sequentially
     /// and according their position in queue.
     ///
-    /// The Presets execution does not performs install or uninstall of referenced Mod Packs by
-    /// itself. Instead,  pointers to referenced Mod Pack objects are supplied sequentially as
-    /// \c param parameter through the \c progress_cb callback function. It is up to client to
-    /// perform proper action (either install, uninstall or abort) within the callback function.
+    /// Mod operations are performed by the Mod Hub itself, concurrently for Mod Channels with
+    /// independent storage (see execModOps), and changes are reported through Mod Library
+    /// notifications. Mod Channels whose library is locked by another operation are skipped.
+    /// If Presets quiet mode is disabled, install warnings are written to log.
+    ///
+    /// The \c progress_cb callback function is called from worker threads, serialized, with
+    /// the processed Mod Pack object as \c param parameter and the global progress of the
+    /// Preset as \c tot and \c cur parameters, where each Mod Channel takes its share
+    /// according its count of Mod operations. Returning false aborts the Preset execution.
     ///
     /// Within this context, the \c param parameter of \c begin_cb and \c result_cb callback
     /// functions is a pointer to the currently processing Mod Preset object.
     ///
     /// \param[in] ModPset      : Mod Preset to execute
     /// \param[in] begin_cb     : Callback called each Preset execution begin
-    /// \param[in] progress_cb  : Callback called each Mod Pack reference to be processed
+    /// \param[in] progress_cb  : Callback called each Mod operation progress
     /// \param[in] result_cb    : Callback called each Preset execution end
     /// \param[in] user_ptr     : User pointer to pass to result callback
     ///
@@ -598,7 +678,12 @@ class OmModHub
 
     OmWString             _icon_source;
 
+    #ifdef _WIN32
     HICON                 _icon_handle;
+    #endif
+
+    // Channel deferred library loading
+    void                  _channel_activate(OmModChan* ModChan);
 
     // Active Channel libraries monitoring
     void                  _modlib_notify_enable(bool enable);
@@ -641,9 +726,19 @@ class OmModHub
 
     uint32_t              _psexec_percent;
 
-    static DWORD WINAPI   _psexec_run_fn(void*);
+    static uint32_t       _psexec_run_fn(void*);
+
+    static void          _psexec_end_fn(void*,uint8_t);
+
+    bool                  _chnops_abort;
+
+    static bool           _chnops_job_fn(void*, size_t, unsigned);
+
+    static void           _chnops_begin_fn(void*, uint64_t);
+
+    static bool           _chnops_progress_fn(void*, size_t, size_t, uint64_t);
 
-    static VOID WINAPI    _psexec_end_fn(void*,uint8_t);
+    static void           _chnops_result_fn(void*, OmResult, uint64_t);
 
     Om_beginCb            _psexec_begin_cb;
 
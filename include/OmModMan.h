@@ -37,6 +37,15 @@ typedef bool (*Om_onlogCb)(void* ptr, const OmWString& log);
 // maximum count of recent file path to store
 #define OM_MANAGER_MAX_RECENT     10
 
+// count of log entries the log queue can hold, must be power of two
+#define OM_MANAGER_LOG_QUEUE      1024
+
+// maximum size in characters of in-memory log
+#define OM_MANAGER_LOG_TAIL       262144
+
+// minimum delay in milliseconds between log notifications
+#define OM_MANAGER_LOG_DELAY      100
+
 /// \brief Main manager application object.
 ///
 /// This is the main "back end" application entry point object.
@@ -360,6 +369,26 @@ class OmModMan
     ///
     void setLinkConfirm(bool enable);
 
+    /// \brief Get performance trace option.
+    ///
+    /// Returns performance trace option value.
+    ///
+    /// \return True if enabled, false otherwise.
+    ///
+    bool perfTrace() const {
+      return this->_perf_trace;
+    }
+
+    /// \brief Set performance trace option.
+    ///
+    /// Define and save performance trace option value. When enabled, timing
+    /// of core operations is recorded and saved as trace file in application
+    /// home folder when quitting.
+    ///
+    /// \param[in]  enable  : Boolean value to set.
+    ///
+    void setPerfTrace(bool enable);
+
     /// \brief Start active Channel Local Library changes notifications
     ///
     /// Set parameters and enable active channel Local Library changes notifications
@@ -392,16 +421,25 @@ class OmModMan
 
     /// \brief Add log callback
     ///
-    /// Add callback function to be called when new log is added
+    /// Add callback function to be called when new log is added. Callback
+    /// is called from log writer thread, it must not wait for a thread that
+    /// may be logging.
     ///
-    /// \param[in] notify_cb  : Pointer to callback function
-    /// \param[in] user_ptr  : Custom user pointer to be passed to callback
+    /// If a string is supplied, it receives the current log, taken at
+    /// registration so no log entry is either missed or duplicated between
+    /// this string and the following notifications.
     ///
-    void addLogNotify(Om_notifyCb notify_cb, void* user_ptr);
+    /// \param[in] notify_cb    : Pointer to callback function
+    /// \param[in] user_ptr     : Custom user pointer to be passed to callback
+    /// \param[out] current_log : Optional string to receive current log.
+    ///
+    void addLogNotify(Om_notifyCb notify_cb, void* user_ptr, OmWString* current_log = nullptr);
 
     /// \brief Remove log callback
     ///
-    /// Remove the specified callback function
+    /// Remove the specified callback function, if callback is currently
+    /// running this waits for it to return, so its user data can be
+    /// released once this function returned.
     ///
     /// \param[in] notify_cb  : Pointer to callback function to remove
     ///
@@ -425,12 +463,22 @@ class OmModMan
 
     /// \brief Get log string.
     ///
-    /// Returns log string.
+    /// Returns most recent log entries, the in-memory log being limited
+    /// to its last OM_MANAGER_LOG_TAIL characters.
     ///
     /// \return Log string.
     ///
-    const OmWString& currentLog() const {
-      return this->_log_str;
+    OmWString currentLog();
+
+    /// \brief Get count of dropped log entries.
+    ///
+    /// Returns count of log entries that were dropped because the log
+    /// queue was full, producers never wait for the log writer.
+    ///
+    /// \return Count of dropped log entries.
+    ///
+    uint64_t droppedLog() const {
+      return static_cast<ULONG>(this->_log_drops);
     }
 
     /// \brief Escalate log.
@@ -483,6 +531,28 @@ class OmModMan
 
     OmPVoidArray          _log_user_ptr;
 
+    CRITICAL_SECTION      _log_lock;
+
+    void*                 _log_queue;
+
+    volatile LONG         _log_head;
+
+    volatile LONG         _log_drops;
+
+    LONG                  _log_tail;
+
+    void*                 _log_hth;
+
+    void*                 _log_hev;
+
+    void*                 _log_hidle;
+
+    volatile bool         _log_quit;
+
+    static DWORD WINAPI   _log_run_fn(void*);
+
+    void                  _log_drain(OmWString* batch);
+
     // general options
     unsigned              _icon_size;
 
@@ -490,6 +560,8 @@ class OmModMan
 
     bool                  _link_confirm;
 
+    bool                  _perf_trace;
+
     // logs and errors
     void                  _log(unsigned level, const OmWString& origin, const OmWString& detail);
 
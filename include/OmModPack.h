@@ -21,37 +21,10 @@
 
 #include "OmImage.h"
 #include "OmVersion.h"
+#include "OmModEntry.h"
 
 class OmModChan;
 
-/// \brief Mod Entry Attributes
-///
-/// Attributes mask for Mod Entry structure
-///
-enum OmModEntAttr : int32_t {
-  OM_MODENTRY_DIR    =   0x1,
-  OM_MODENTRY_DEL    =   0x2
-};
-
-/// \brief Mod Entry structure
-///
-/// Structure to describe a Mod entry, which is a file or folder to be
-/// installed or restored which Package or Backup contain or references.
-///
-typedef struct OmModEntry_
-{
-  int32_t       attr;   ///< Entry attributes bits
-  OmWString     path;   ///< Entry relative path
-  int32_t       cdid;   ///< Entry zip central-directory index
-
-} OmModEntry_t;
-
-/// \brief OmModEntry_t array
-///
-/// Typedef for an STL vector of OmModEntry_t type
-///
-typedef std::vector<OmModEntry_t> OmModEntryArray;
-
 /// \brief Package default category count.
 ///
 /// Package default Mod category count.
@@ -183,13 +156,14 @@ class OmModPack
 
     /// \brief Get Source entry
     ///
-    /// Returns Source entry at specified index
+    /// Returns Source entry at specified index, entry path is built
+    /// from compact entry table.
     ///
     /// \param[in] i  : Entry index to get
     ///
-    /// \return wide string
+    /// \return Entry structure
     ///
-    const OmModEntry_t& getSourceEntry(size_t i) const {
+    OmModEntry_t getSourceEntry(size_t i) const {
       return this->_src_entry[i];
     }
 
@@ -262,13 +236,14 @@ class OmModPack
 
     /// \brief Get Backup entry
     ///
-    /// Returns Backup entry at specified index
+    /// Returns Backup entry at specified index, entry path is built
+    /// from compact entry table.
     ///
     /// \param[in] i  : Entry index to get
     ///
-    /// \return wide string
+    /// \return Entry structure
     ///
-    const OmModEntry_t& getBackupEntry(size_t i) const {
+    OmModEntry_t getBackupEntry(size_t i) const {
       return this->_bck_entry[i];
     }
 
@@ -301,6 +276,17 @@ class OmModPack
       return this->_iden;
     }
 
+    /// \brief Mod identity sort key
+    ///
+    /// Mod identity string converted to upper case, used to sort Mods
+    /// without case conversion at each comparison.
+    ///
+    /// \return Wide string
+    ///
+    const OmWString& idenKey() const {
+      return this->_iden_key;
+    }
+
     /// \brief Mod displayed name
     ///
     /// Mod displayed name string parsed from Mod identity.
@@ -341,15 +327,24 @@ class OmModPack
       return this->_category;
     }
 
+    /// \brief Mod category sort key.
+    ///
+    /// Mod category converted to upper case, used to sort Mods
+    /// without case conversion at each comparison.
+    ///
+    /// \return Wide string.
+    ///
+    const OmWString& categoryKey() const {
+      return this->_category_key;
+    }
+
     /// \brief Set Mod category.
     ///
     /// Set or replace the Mod category.
     ///
     /// \param[in]  cate  : Category to set.
     ///
-    void setCategory(const OmWString& cate) {
-      this->_category = cate;
-    }
+    void setCategory(const OmWString& cate);
 
     /// \brief Mod description.
     ///
@@ -452,6 +447,32 @@ class OmModPack
       return this->_src_depend[i];
     }
 
+    /// \brief Dependency Mod core name
+    ///
+    /// Returns dependency Mod core name at specified index, as parsed
+    /// from identity filter.
+    ///
+    /// \param[in] i   : Reference index to get
+    ///
+    /// \return Wide string
+    ///
+    const OmWString& getDependCore(size_t i) const {
+      return this->_src_depend_core[i];
+    }
+
+    /// \brief Dependency Mod version filter
+    ///
+    /// Returns dependency Mod precompiled version filter at specified index,
+    /// the filter is not valid if identity does not define any version.
+    ///
+    /// \param[in] i   : Reference index to get
+    ///
+    /// \return Version filter
+    ///
+    const OmVersionFilter& getDependFilter(size_t i) const {
+      return this->_src_depend_filter[i];
+    }
+
     /// \brief Check for dependency Mod identity
     ///
     /// Checks whether dependency Mod identity is referenced by this Mod.
@@ -479,7 +500,7 @@ class OmModPack
     /// \param[in] iden  : Mod identity to add
     ///
     void addDependIden(const OmWString& iden) {
-      this->_src_depend.push_back(iden);
+      this->_depend_add(iden);
     }
 
     /// \brief Remove dependency entry
@@ -495,7 +516,7 @@ class OmModPack
     /// Remove all dependency Mod identity reference for this Mod.
     ///
     void clearDepend() {
-      this->_src_depend.clear();
+      this->_depend_clear();
     }
 
     /// \brief Get install footprint.
@@ -612,6 +633,40 @@ class OmModPack
     ///
     OmResult applySource(Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
 
+    /// \brief Check whether can replace installed Mod
+    ///
+    /// Checks whether this Mod can be installed in place of the specified
+    /// installed Mod using differential replacement.
+    ///
+    /// \param[in] ModPack      : Installed Mod to be replaced
+    ///
+    /// \return True if differential replacement is possible, false otherwise
+    ///
+    bool canReplace(const OmModPack* ModPack) const;
+
+    /// \brief Replace installed Mod
+    ///
+    /// Install this Mod in place of the specified installed Mod by applying
+    /// only differences between them. Files with same path, size and CRC-32
+    /// in both Mod sources are left untouched in Target, Backup data of the
+    /// replaced Mod is taken over and completed for new files, and files no
+    /// longer part of this Mod are restored from Backup.
+    ///
+    /// \param[in] ModPack      : Installed Mod to be replaced
+    /// \param[in] progress_cb  : Optional progression callback function
+    /// \param[in] user_ptr     : Optional user pointer to be passed to callback
+    ///
+    /// Once Backup data is taken over, the operation cannot be reverted. An abort
+    /// requested from this point stops writing files to Target but the replaced Mod
+    /// is uninstalled anyway, the partly installed Mod should then be undone.
+    ///
+    /// \return OM_RESULT_OK if operation succeed, OM_RESULT_ERROR if an error occurred
+    ///         and OM_RESULT_ABORT if invalid call or aborted. If this Mod has Backup
+    ///         data after the call, the replaced Mod is no longer installed, otherwise
+    ///         it stay installed unchanged.
+    ///
+    OmResult replaceData(OmModPack* ModPack, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
+
     /// \brief Discard Backup data
     ///
     /// Permanently delete Backup data to avoid having restoring it to prevent
@@ -735,6 +790,8 @@ class OmModPack
     // common properties
     OmWString           _iden;
 
+    OmWString           _iden_key;
+
     uint64_t            _hash;
 
     OmWString           _core;
@@ -746,6 +803,8 @@ class OmModPack
     // optional properties
     OmWString           _category;
 
+    OmWString           _category_key;
+
     OmWString           _description;
 
     time_t              _description_time;
@@ -755,7 +814,7 @@ class OmModPack
     time_t              _thumbnail_time;
 
     // source parse helper
-    static void         _src_parse_dir(OmModEntryArray*, const OmWString&, const OmWString&);
+    static void         _src_parse_dir(OmModEntryTable*, const OmWString&);
 
     // pack source properties
     bool                _has_src;
@@ -770,10 +829,18 @@ class OmModPack
 
     OmWString           _src_root;
 
-    OmModEntryArray     _src_entry;
+    OmModEntryTable     _src_entry;
 
     OmWStringArray      _src_depend;
 
+    OmWStringArray      _src_depend_core;
+
+    std::vector<OmVersionFilter> _src_depend_filter;
+
+    void                _depend_add(const OmWString& iden);
+
+    void                _depend_clear();
+
     time_t              _src_depend_time;
 
     // backup data properties
@@ -785,10 +852,19 @@ class OmModPack
 
     OmWString           _bck_root;
 
-    OmModEntryArray     _bck_entry;
+    OmModEntryTable     _bck_entry;
 
     OmUint64Array       _bck_overlap;
 
+    // backup restore helpers
+    void                _restore_progress(void*);
+
+    static bool         _restore_job_fn(void*, size_t, unsigned);
+
+    static bool         _delete_job_fn(void*, size_t, unsigned);
+
+    static bool         _rmdir_job_fn(void*, size_t, unsigned);
+
     // analytical properties
     bool                _has_broken_dep;
 
@@ -0,0 +1,183 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OMNETINDEX_H
+#define OMNETINDEX_H
+
+#include "OmBase.h"
+
+#include "OmNetRepo.h"
+
+/// \brief Repository index version
+///
+/// Current version of repository binary index format
+///
+#define OM_NETINDEX_VERSION   1
+
+/// \brief Repository binary index
+///
+/// Compact binary form of repository definition, written alongside the XML
+/// definition. It is made of a fixed header, a table of Mod references sorted
+/// by identity, a string pool and raw JPEG thumbnails and deflated descriptions
+/// blobs addressed by offset.
+///
+/// The index is read in place, either from a memory mapped file or from a
+/// received data buffer, references are extracted on demand and identities
+/// can be searched by binary search.
+///
+class OmNetIndex
+{
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// Default constructor.
+    ///
+    OmNetIndex();
+
+    /// \brief Destructor.
+    ///
+    /// Default destructor.
+    ///
+    ~OmNetIndex();
+
+    /// \brief Open index file
+    ///
+    /// Maps the specified index file into memory and checks its validity.
+    ///
+    /// \param[in]  path    : Path to index file.
+    ///
+    /// \return True if operation succeed, false otherwise.
+    ///
+    bool open(const OmWString& path);
+
+    /// \brief Attach index data
+    ///
+    /// Use the given memory buffer as index data and checks its validity. The
+    /// buffer is not copied and must remain valid until instance is closed.
+    ///
+    /// \param[in]  data    : Pointer to index data.
+    /// \param[in]  size    : Size of index data.
+    ///
+    /// \return True if data is a valid index, false otherwise.
+    ///
+    bool attach(const uint8_t* data, size_t size);
+
+    /// \brief Close index
+    ///
+    /// Unmaps file or detaches data and reset instance.
+    ///
+    void close();
+
+    /// \brief Check validity
+    ///
+    /// Checks whether instance currently holds a valid index.
+    ///
+    /// \return True if index is valid, false otherwise.
+    ///
+    bool valid() const {
+      return (this->_data != nullptr);
+    }
+
+    /// \brief Get UUID
+    ///
+    /// Returns repository UUID.
+    ///
+    /// \return Repository UUID.
+    ///
+    OmWString uuid() const;
+
+    /// \brief Get title
+    ///
+    /// Returns repository title.
+    ///
+    /// \return Repository title.
+    ///
+    OmWString title() const;
+
+    /// \brief Get download path
+    ///
+    /// Returns repository common download path.
+    ///
+    /// \return Repository download path.
+    ///
+    OmWString downpath() const;
+
+    /// \brief Get reference count
+    ///
+    /// Returns count of Mod references in index.
+    ///
+    /// \return References count.
+    ///
+    size_t referenceCount() const;
+
+    /// \brief Get reference
+    ///
+    /// Extracts Mod reference parameters at specified index. Raw thumbnail
+    /// and description pointers address index data directly and remain valid
+    /// until instance is closed.
+    ///
+    /// \param[in]  index   : Index of reference, in identity order.
+    /// \param[out] ref     : Pointer to structure that receive parameters.
+    ///
+    /// \return True if operation succeed, false if index is out of bound or
+    ///         reference data is corrupted.
+    ///
+    bool getReference(size_t index, OmNetRef_t* ref) const;
+
+    /// \brief Find reference
+    ///
+    /// Search for the Mod reference with specified identity using binary
+    /// search.
+    ///
+    /// \param[in]  ident   : Mod identity to search.
+    ///
+    /// \return Reference index or -1 if not found.
+    ///
+    int32_t indexOfReference(const OmWString& ident) const;
+
+    /// \brief Write index file
+    ///
+    /// Creates index file from the given repository parameters and Mod
+    /// references. References thumbnail and description are taken from raw
+    /// data pointers.
+    ///
+    /// \param[in]  path    : Path to index file to write.
+    /// \param[in]  uuid    : Repository UUID.
+    /// \param[in]  title   : Repository title.
+    /// \param[in]  downpath: Repository download path.
+    /// \param[in]  refs    : Mod references to write.
+    ///
+    /// \return True if operation succeed, false otherwise.
+    ///
+    static bool write(const OmWString& path, const OmWString& uuid, const OmWString& title, const OmWString& downpath, const OmNetRefArray& refs);
+
+  private:
+
+    const uint8_t*      _data;
+
+    size_t              _size;
+
+    void*               _hfile;
+
+    void*               _hmap;
+
+    static bool         _check(const uint8_t*, size_t);
+
+    bool                _get_str(const void*, OmWString*) const;
+};
+
+#endif // OMNETINDEX_H
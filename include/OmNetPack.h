@@ -23,6 +23,7 @@
 #include "OmImage.h"
 #include "OmVersion.h"
 #include "OmConnect.h"
+#include "OmNetRepo.h"
 
 class OmModChan;
 class OmNetRepo;
@@ -63,6 +64,18 @@ class OmNetPack
     ///
     bool parseReference(OmNetRepo* NetRepo, size_t i);
 
+    /// \brief Parse Repository Mod
+    ///
+    /// Try to parse Mod Repository reference structure to be used as
+    /// online (downloadable) Mod.
+    ///
+    /// \param[in]  ModRepo : Mod Repository the reference belongs to.
+    /// \param[in]  ref     : Repository reference to parse.
+    ///
+    /// \return True operation succeed, false otherwise
+    ///
+    bool parseReference(OmNetRepo* NetRepo, const OmNetRef_t* ref);
+
     /// \brief Mod hash value
     ///
     /// Mod filename hash value the backup data is related to
@@ -83,6 +96,17 @@ class OmNetPack
       return this->_iden;
     }
 
+    /// \brief Mod identity sort key
+    ///
+    /// Mod identity string converted to upper case, used to sort Mods
+    /// without case conversion at each comparison.
+    ///
+    /// \return Wide string
+    ///
+    const OmWString& idenKey() const {
+      return this->_iden_key;
+    }
+
     /// \brief Mod displayed name
     ///
     /// Mod displayed name string parsed from Mod identity.
@@ -123,6 +147,17 @@ class OmNetPack
       return this->_category;
     }
 
+    /// \brief Mod category sort key.
+    ///
+    /// Mod category converted to upper case, used to sort Mods
+    /// without case conversion at each comparison.
+    ///
+    /// \return Wide string.
+    ///
+    const OmWString& categoryKey() const {
+      return this->_category_key;
+    }
+
     /// \brief Mod description.
     ///
     /// Returns Mod description as defined by Mod author.
@@ -420,7 +455,8 @@ class OmNetPack
     /// \brief Close download
     ///
     /// Finalize download process by checking download result and downloaded
-    /// file integrity then rename temporary file to make it valid Mod.
+    /// file integrity then rename temporary file to make it valid Mod. The
+    /// checksum is not computed again if it was verified by verifyDownloads.
     ///
     /// This function must be called after download process ended.
     ///
@@ -428,6 +464,17 @@ class OmNetPack
     ///
     bool finalizeDownload();
 
+    /// \brief Verify downloads
+    ///
+    /// Verifies checksums of several completed downloads at once using
+    /// batch hashing, before they are finalized. Downloads whose checksum
+    /// matches are marked verified for finalizeDownload, the others are left
+    /// to its own checksum verification.
+    ///
+    /// \param[in]  selection : Completed downloads to verify.
+    ///
+    static void verifyDownloads(const std::vector<OmNetPack*>& selection);
+
     /// \brief Check whether is upgraded
     ///
     /// Checks whether this instance is currently in upgrading operation
@@ -503,6 +550,8 @@ class OmNetPack
     // reference Mod properties
     OmWString           _iden;
 
+    OmWString           _iden_key;
+
     uint64_t            _hash;
 
     OmWString           _core;
@@ -513,6 +562,8 @@ class OmNetPack
 
     OmWString           _category;
 
+    OmWString           _category_key;
+
     OmWString           _description;
 
     OmImage             _thumbnail;
@@ -573,6 +624,10 @@ class OmNetPack
 
     uint32_t            _dnl_percent;
 
+    uint64_t            _dnl_perf;
+
+    bool                _dnl_csum_ok;
+
     static void         _dnl_result_fn(void*, OmResult, uint64_t);
 
     static bool         _dnl_download_fn(void*, int64_t, int64_t, int64_t, uint64_t);
@@ -25,6 +25,52 @@
 class OmModChan;
 class OmModPack;
 class OmImage;
+
+/// \brief Mod reference structure
+///
+/// Structure to describe a repository Mod reference independently of
+/// the XML definition, as filled by streaming parser or extracted from
+/// the loaded definition.
+///
+typedef struct OmNetRef_
+{
+  OmWString       ident;        ///< Mod identity
+  OmWString       file;         ///< Package file name
+  uint64_t        bytes;        ///< Package file size
+  OmWString       xxhsum;       ///< Package XXHash checksum
+  OmWString       md5sum;       ///< Package MD5 checksum
+  OmWString       category;     ///< Mod category
+  OmWString       url;          ///< Custom download URL
+  OmWString       thumbnail;    ///< Thumbnail DataURI
+  OmWString       description;  ///< Description DataURI
+  uint64_t        desc_bytes;   ///< Description uncompressed size
+  OmWStringArray  depends;      ///< Dependencies identities
+  const uint8_t*  thumb_data;   ///< Raw thumbnail JPEG data, if any
+  size_t          thumb_size;   ///< Raw thumbnail JPEG data size
+  const uint8_t*  desc_data;    ///< Raw description deflate data, if any
+  size_t          desc_size;    ///< Raw description deflate data size
+  bool            thumb_failed; ///< Thumbnail encode failed, existing one is kept
+  bool            desc_failed;  ///< Description encode failed, existing one is kept
+
+} OmNetRef_t;
+
+/// \brief OmNetRef_t array
+///
+/// Typedef for an STL vector of OmNetRef_t type
+///
+typedef std::vector<OmNetRef_t> OmNetRefArray;
+
+/// \brief Mod reference callback.
+///
+/// Generic callback function for Mod reference read from repository
+/// definition while it is being received.
+///
+/// \param[in]  ptr     : User data pointer.
+/// \param[in]  ref     : Mod reference read from definition.
+///
+/// \return True to continue, false to abort the query.
+///
+typedef bool (*Om_referenceCb)(void* ptr, const OmNetRef_t* ref);
 
 /// \brief Network Mod repository object
 ///
@@ -109,13 +155,25 @@ class OmNetRepo
 
     /// \brief Save repository definition
     ///
-    /// Save repository definition to local file system.
+    /// Save repository definition to local file system. The binary index is
+    /// written alongside and declared in definition by an <index> node with
+    /// its checksum, so clients only use an index matching the definition.
     ///
     /// \param[in] path     : Path to file to save XML definition
     ///
     /// \return Operation result code.
     ///
     OmResult save(const OmWString& path);
+
+    /// \brief Check for binary index
+    ///
+    /// Checks whether definition declares a binary index.
+    ///
+    /// \return True if binary index is declared, false otherwise.
+    ///
+    bool hasIndex() const {
+      return this->_xml.hasChild(L"index");
+    }
 
     /// \brief Query repository.
     ///
@@ -126,6 +184,27 @@ class OmNetRepo
     ///
     OmResult query();
 
+    /// \brief Query repository streaming.
+    ///
+    /// Try connect to repository and parse definition as data is received,
+    /// without building the XML document. Each Mod reference is passed to
+    /// the given callback as soon as it has been read. This function does not
+    /// use thread and block until request response or timeout.
+    ///
+    /// If definition declares a binary index, transfer is stopped and index
+    /// is loaded instead, provided its checksum matches the declared one,
+    /// otherwise definition is queried again and parsed entirely.
+    ///
+    /// Since definition document is not kept, reference list of this instance
+    /// is empty after this call and response data is not stored.
+    ///
+    /// \param[in]  ref_cb    : Callback to receive Mod references.
+    /// \param[in]  user_ptr  : Custom pointer to be passed to callback.
+    ///
+    /// \return Operation result code.
+    ///
+    OmResult query(Om_referenceCb ref_cb, void* user_ptr = nullptr);
+
     /// \brief Abort query
     ///
     /// Abort the current pending query if any
@@ -270,6 +349,17 @@ class OmNetRepo
       return this->_reference_list[index];
     }
 
+    /// \brief Get Mod reference.
+    ///
+    /// Extracts repository Mod reference parameters.
+    ///
+    /// \param[in]  index  : Index of reference to get
+    /// \param[out] ref    : Pointer to structure that receive parameters.
+    ///
+    /// \return True if reference exists, false otherwise.
+    ///
+    bool getReference(size_t index, OmNetRef_t* ref) const;
+
     /// \brief Check for reference.
     ///
     /// Checks whether this instance has Mod identity as reference
@@ -331,6 +421,76 @@ class OmNetRepo
     ///
     int32_t addReference(const OmModPack* ModPack);
 
+    /// \brief Add Mod reference
+    ///
+    /// Add new or update existing Mod reference from prepared parameters.
+    /// Custom URL of existing reference is left untouched.
+    ///
+    /// \param[in] ref     : Mod reference parameters, as made by makeReference
+    ///
+    /// \return If reference with same identity was found, the
+    ///         index of updated reference, otherwise -1 is returned
+    ///
+    int32_t addReference(const OmNetRef_t* ref);
+
+    /// \brief Make Mod reference
+    ///
+    /// Computes Mod reference parameters from the given Mod Pack, including
+    /// package checksum, encoded thumbnail and compressed description. This
+    /// function does not access any instance data and can be called from
+    /// any thread.
+    ///
+    /// \param[in]  ModPack : Pointer to Mod Pack to make reference from
+    /// \param[out] ref     : Pointer to structure that receive parameters
+    ///
+    static void makeReference(const OmModPack* ModPack, OmNetRef_t* ref);
+
+    /// \brief Build Mod references
+    ///
+    /// Add or update Mod references for the specified package files, packages
+    /// are parsed and processed concurrently. Parameters of processed packages
+    /// are stored in build cache keyed by path, size and last write time, so
+    /// unchanged packages are taken from cache at next build.
+    ///
+    /// References are added in the given packages order, packages that
+    /// failed to parse are skipped.
+    ///
+    /// \param[in] paths       : Mod package files to build references from
+    /// \param[in] cache_path  : Build cache file path, empty for no cache
+    /// \param[in] progress_cb : Optional progression callback, param is the processed package index
+    /// \param[in] user_ptr    : Optional user pointer to be passed to callback
+    /// \param[in] threads     : Maximum worker threads, 0 for logical processors count
+    ///
+    /// \return Operation result code, OM_RESULT_ERROR if one or more package failed
+    ///
+    OmResult build(const OmWStringArray& paths, const OmWString& cache_path, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr, unsigned threads = 0);
+
+    /// \brief Build errors
+    ///
+    /// Returns error messages of packages that failed to parse during
+    /// last build, in packages order.
+    ///
+    /// \return Array of error messages
+    ///
+    const OmWStringArray& buildErrors() const {
+      return this->_build_errors;
+    }
+
+    /// \brief Verify Mod packages
+    ///
+    /// Verifies package files of the specified folder against checksums of
+    /// Mod references. Checksums are computed concurrently, with MD5 each
+    /// worker hashes several files at once.
+    ///
+    /// \param[in]  pkg_dir   : Folder where referenced package files are searched
+    /// \param[out] mismatch  : Pointer to array that receive identities of Mods whose package checksum mismatch
+    /// \param[out] missing   : Pointer to array that receive identities of Mods whose package file was not found
+    /// \param[in]  io_limit  : Maximum concurrent file reads, 0 for default
+    ///
+    /// \return Count of packages whose checksum matches
+    ///
+    size_t verify(const OmWString& pkg_dir, OmWStringArray* mismatch, OmWStringArray* missing, unsigned io_limit = 0);
+
     /// \brief Set Mod reference custom URL
     ///
     /// Set or replace Custom URL of the Mod reference at specified index
@@ -498,11 +658,19 @@ class OmNetRepo
 
     OmWString           _query_lasterr;
 
+    void                _query_urls(OmWStringArray*) const;
+
+    OmResult            _query_index(const OmWString&, uint64_t, Om_referenceCb, void*);
+
     // reference build helpers
     bool                _save_thumbnail(OmXmlNode&, const OmImage&, uint8_t level = 70);
 
     bool                _save_description(OmXmlNode&, const OmWString&, uint8_t level = 6);
 
+    static bool         _build_job_fn(void*, size_t, unsigned);
+
+    OmWStringArray      _build_errors;
+
     // logs and errors
     void                _log(unsigned level, const OmWString& origin, const OmWString& detail) const;
 
@@ -466,8 +466,6 @@ class OmUiMan : public OmDialog
     // Preset setup processing
     int32_t             _psexec_count;
 
-    int32_t             _psexec_idch;
-
     bool                _psexec_abort;
 
     void                _psexec_add(OmModPset*);
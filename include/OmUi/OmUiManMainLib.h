@@ -163,6 +163,33 @@ class OmUiManMainLib : public OmDialog
     ///
     void queueCleaning(bool silent = false);
 
+    /// \brief Begin Preset execution
+    ///
+    /// Enter processing state for a Preset execution performed by the
+    /// Mod Hub, and reset abort state.
+    ///
+    void presetBegin();
+
+    /// \brief Preset execution progress
+    ///
+    /// Update processing state for a Mod operation performed by the Mod Hub
+    /// during Preset execution. This function may be called from a worker
+    /// thread.
+    ///
+    /// \param[in] ModPack  : Mod Pack being processed
+    /// \param[in] percent  : Global Preset execution progress
+    ///
+    /// \return False if user requested abort, true otherwise
+    ///
+    bool presetProgress(OmModPack* ModPack, uint32_t percent);
+
+    /// \brief End Preset execution
+    ///
+    /// Leave processing state for a Preset execution performed by the
+    /// Mod Hub.
+    ///
+    void presetEnd();
+
     /// \brief Abort all running operation
     ///
     /// Abort all the running operation and empty queues.
@@ -19,6 +19,24 @@
 
 #include "OmBase.h"
 
+/// \brief Tree item structure
+///
+/// Structure to describe a file or folder found while exploring a
+/// folder tree.
+///
+typedef struct OmTreeItem_
+{
+  OmWString     path;   ///< Item path relative to tree origin
+  bool          isdir;  ///< Item is a folder
+
+} OmTreeItem_t;
+
+/// \brief OmTreeItem_t array
+///
+/// Typedef for an STL vector of OmTreeItem_t type
+///
+typedef std::vector<OmTreeItem_t> OmTreeItemArray;
+
 /// \brief Check empty folder
 ///
 /// Checks whether the specified folder is empty.
@@ -35,7 +53,7 @@ bool Om_isDirEmpty(const OmWString& path);
 ///
 /// \param[in]  path   : Path of folder to create.
 ///
-/// \return 0 if operation succeed, WinAPI error code otherwise.
+/// \return 0 if operation succeed, system error code otherwise.
 ///
 int Om_dirCreate(const OmWString& path);
 
@@ -45,7 +63,7 @@ int Om_dirCreate(const OmWString& path);
 ///
 /// \param[in]  path   : Path of folder(s) to create
 ///
-/// \return 0 if operation succeed, WinAPI error code otherwise.
+/// \return 0 if operation succeed, system error code otherwise.
 ///
 int Om_dirCreateRecursive(const OmWString& path);
 
@@ -55,7 +73,7 @@ int Om_dirCreateRecursive(const OmWString& path);
 ///
 /// \param[in]  path   : Path of folder to delete.
 ///
-/// \return 0 if operation succeed, WinAPI error code otherwise.
+/// \return 0 if operation succeed, system error code otherwise.
 ///
 int Om_dirDelete(const OmWString& path);
 
@@ -65,7 +83,7 @@ int Om_dirDelete(const OmWString& path);
 ///
 /// \param[in]  path   : Path of folder to delete.
 ///
-/// \return 0 if operation succeed, WinAPI error code otherwise.
+/// \return 0 if operation succeed, system error code otherwise.
 ///
 int Om_dirDeleteRecursive(const OmWString& path);
 
@@ -77,7 +95,7 @@ int Om_dirDeleteRecursive(const OmWString& path);
 /// \param[in]  dst    : Destination file path.
 /// \param[in]  ow     : Overwrite destination if exists.
 ///
-/// \return 0 if operation succeed, WinAPI error code otherwise.
+/// \return 0 if operation succeed, system error code otherwise.
 ///
 int Om_fileCopy(const OmWString& src, const OmWString& dst, bool ow = true);
 
@@ -88,7 +106,7 @@ int Om_fileCopy(const OmWString& src, const OmWString& dst, bool ow = true);
 /// \param[in]  src    : Source file path to copy.
 /// \param[in]  dst    : Destination file path.
 ///
-/// \return 0 if operation succeed, WinAPI error code otherwise.
+/// \return 0 if operation succeed, system error code otherwise.
 ///
 int Om_fileMove(const OmWString& src, const OmWString& dst);
 
@@ -98,7 +116,7 @@ int Om_fileMove(const OmWString& src, const OmWString& dst);
 ///
 /// \param[in]  path   : Path to file to delete.
 ///
-/// \return 0 if operation succeed, WinAPI error code otherwise.
+/// \return 0 if operation succeed, system error code otherwise.
 ///
 int Om_fileDelete(const OmWString& path);
 
@@ -152,29 +170,6 @@ bool Om_pathExists(const OmWString& path);
 ///
 bool Om_pathIsNetwork(const OmWString& path);
 
-/// \brief Set item attribute
-///
-/// Set attribute to specified item, either file or folder.
-///
-/// \param[in]  path   : Path to item to set attribute.
-/// \param[in]  attr   : Attribute to set.
-///
-/// \return True if operation succeed, false otherwise.
-///
-bool Om_itemSetAttr(const OmWString& path, uint32_t attr);
-
-/// \brief Check item attributes
-///
-/// Check whether item has the specified attribute mask, either file
-/// or folder.
-///
-/// \param[in]  path   : Path to item to check attributes.
-/// \param[in]  mask   : Attributes mask to check.
-///
-/// \return True if mask matches item attributes, false otherwise.
-///
-bool Om_itemHasAttr(const OmWString& path, uint32_t mask);
-
 /// \brief Check valid Zip file
 ///
 /// Checks whether the specified item is file with Zip signature.
@@ -190,7 +185,7 @@ bool Om_isFileZip(const OmWString& path, bool quick = true);
 ///
 /// Checks whether the specified item is file with Zip signature.
 ///
-/// \param[in]  hFile  : file HANDLE to check.
+/// \param[in]  hFile  : File handle as returned by Om_pltFileOpen.
 /// \param[in]  quick  : Perform quick check without Central-Directory verification.
 ///
 /// \return True if item is actually a file with Zip signature, false otherwise.
@@ -274,6 +269,21 @@ void Om_lsAll(OmWStringArray* ls, const OmWString& origin, bool abs = true, bool
 ///
 void Om_lsAllRecursive(OmWStringArray* ls, const OmWString& origin, bool abs = true, bool hidden = false);
 
+/// \brief List folder tree
+///
+/// Retrieves the list of files and folders contained in the specified origin
+/// location, exploring sub-folders recursively. Sub-folders of the same depth
+/// are explored in parallel by worker threads, items are however returned in
+/// the same depth-first order as a sequential exploration. When called from a
+/// parallel for job, the tree is explored by the calling thread alone.
+///
+/// \param[out] ls      : Pointer to array of OmTreeItem_t to be filled with result.
+/// \param[in]  origin  : Path where to list items from.
+/// \param[in]  hidden  : Include items marked as Hidden.
+/// \param[in]  threads : Maximum worker threads, 0 for logical processors count.
+///
+void Om_lsTree(OmTreeItemArray* ls, const OmWString& origin, bool hidden = false, unsigned threads = 0);
+
 /// \brief List folders and files with custom filter
 ///
 /// Retrieves the list of folders and files contained in the specified origin location
@@ -315,7 +325,7 @@ time_t Om_itemTime(const OmWString& path);
 ///
 /// \param[in]  path    : Item path.
 ///
-/// \return 0 if operation succeed, WinAPI error code otherwise.
+/// \return 0 if operation succeed, system error code otherwise.
 ///
 int Om_moveToTrash(const OmWString& path);
 
@@ -323,31 +333,31 @@ int Om_moveToTrash(const OmWString& path);
 ///
 /// Access mask for directory read/traverse content
 ///
-#define OM_ACCESS_DIR_READ     (FILE_LIST_DIRECTORY|FILE_TRAVERSE|FILE_READ_ATTRIBUTES)
+#define OM_ACCESS_DIR_READ     0x1
 
 /// \brief Write into directory access mask
 ///
 /// Access mask for directory write/add content
 ///
-#define OM_ACCESS_DIR_WRITE    (FILE_ADD_FILE|FILE_ADD_SUBDIRECTORY|FILE_WRITE_ATTRIBUTES)
+#define OM_ACCESS_DIR_WRITE    0x2
 
 /// \brief Execute file access mask
 ///
 /// Access mask for fie execute
 ///
-#define OM_ACCESS_FILE_EXEC    FILE_EXECUTE
+#define OM_ACCESS_FILE_EXEC    0x4
 
 /// \brief Read file access mask
 ///
 /// Access mask for file read data
 ///
-#define OM_ACCESS_FILE_READ    (FILE_READ_DATA|FILE_READ_ATTRIBUTES)
+#define OM_ACCESS_FILE_READ    0x8
 
 /// \brief Write file access mask
 ///
 /// Access mask for file write/append data
 ///
-#define OM_ACCESS_FILE_WRITE   (FILE_WRITE_DATA|FILE_APPEND_DATA|FILE_WRITE_ATTRIBUTES)
+#define OM_ACCESS_FILE_WRITE   0x10
 
 /// \brief check file or directory permission
 ///
@@ -397,12 +407,15 @@ uint8_t* Om_loadBinary(uint64_t* size, const OmWString& path);
 ///
 /// Get size of the specified file
 ///
-/// \param[in]  hFile   : File Handle.
+/// \param[in]  hFile   : File handle as returned by Om_pltFileOpen.
 ///
 /// \return File size in bytes
 ///
 uint64_t Om_fileSize(void* hFile);
 
+// rename and delete through handle have no POSIX equivalent
+#ifdef _WIN32
+
 /// \brief Rename file
 ///
 /// Rename file pointed by given Handle
@@ -425,6 +438,8 @@ int32_t Om_fileRename(void* hFile, const OmWString& name, bool replace = true);
 ///
 int32_t Om_fileDelete(void* hFile);
 
+#endif // _WIN32
+
 /// \brief Search files
 ///
 /// Search the supplied files path recursively starting at the given origin
@@ -19,6 +19,13 @@
 
 #include "OmBase.h"
 
+/// \brief Checksum algorithms
+///
+/// Checksum algorithms for batch file hashing
+///
+#define OM_HASH_XXH3    0     //< XXHash3 64 bits
+#define OM_HASH_MD5     1     //< MD5
+
 /// \brief Get hexadecimal string representation.
 ///
 /// Create hexadecimal string representation of the given bytes sequence in
@@ -218,6 +225,43 @@ bool Om_cmpMD5sum(const OmWString& path, const OmWString& str);
 ///
 bool Om_cmpMD5sum(void* hFile, const OmWString& str);
 
+/// \brief Get files checksums.
+///
+/// Computes checksum strings of several files concurrently. Files are hashed
+/// by worker threads, each one having one read pending while hashing, so the
+/// count of workers bounds the count of concurrent I/O. With MD5 algorithm
+/// and SIMD capable build, each worker hashes several files at once using
+/// multi-buffer MD5.
+///
+/// Checksum of files that failed to be read are left empty.
+///
+/// \param[out] sums        : Pointer to array that receive checksums, in files order.
+/// \param[in]  paths       : Paths to files to generate checksums.
+/// \param[in]  algo        : Checksum algorithm, either OM_HASH_XXH3 or OM_HASH_MD5.
+/// \param[in]  io_limit    : Maximum concurrent file reads, 0 for default.
+/// \param[in]  progress_cb : Optional progression callback, param is the processed file index.
+/// \param[in]  user_ptr    : Optional user pointer to be passed to callback.
+///
+/// \return Count of files successfully hashed.
+///
+size_t Om_getFileSums(OmWStringArray* sums, const OmWStringArray& paths, unsigned algo, unsigned io_limit = 0, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
+
+/// \brief Verify files checksums.
+///
+/// Computes checksums of several files concurrently and compares them to
+/// the given checksum strings. With MD5 algorithm and SIMD capable build,
+/// several files are hashed at once by each worker using multi-buffer MD5.
+///
+/// \param[out] mismatch    : Pointer to array that receive indexes of files that failed verification.
+/// \param[in]  paths       : Paths to files to verify.
+/// \param[in]  sums        : Expected checksum strings, in files order.
+/// \param[in]  algo        : Checksum algorithm, either OM_HASH_XXH3 or OM_HASH_MD5.
+/// \param[in]  io_limit    : Maximum concurrent file reads, 0 for default.
+///
+/// \return Count of files whose checksum matches.
+///
+size_t Om_cmpFileSums(OmIndexArray* mismatch, const OmWStringArray& paths, const OmWStringArray& sums, unsigned algo, unsigned io_limit = 0);
+
 /// \brief Calculate CRC64 value.
 ///
 /// Calculates and returns the CRC64 unsigned integer value of the given
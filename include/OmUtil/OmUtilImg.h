@@ -18,7 +18,10 @@
 #define OMUTILIMG_H
 
 #include "OmBase.h"
-#include "OmBaseWin.h"
+
+#ifdef _WIN32
+  #include "OmBaseWin.h"    //< HBITMAP
+#endif
 
 enum OmImgType : unsigned {
   OM_IMAGE_BMP = 1,
@@ -100,6 +103,7 @@ uint8_t* Om_imgLoadFile(unsigned* out_w, unsigned* out_h, const OmWString& in_pa
 ///
 uint8_t* Om_imgLoadData(unsigned* out_w, unsigned* out_h, const uint8_t* in_data, uint64_t in_size, bool flip_y = false);
 
+#ifdef _WIN32
 /// \brief Load HBITMAP data.
 ///
 /// Load HBITMAP data.
@@ -112,6 +116,7 @@ uint8_t* Om_imgLoadData(unsigned* out_w, unsigned* out_h, const uint8_t* in_data
 /// \return Pointer to RGBA image data or nullptr if failed.
 ///
 uint8_t* Om_imgLoadHBmp(unsigned* dst_w, unsigned* dst_h, HBITMAP in_hbmp);
+#endif // _WIN32
 
 /// \brief Save image as BMP.
 ///
@@ -232,6 +237,7 @@ uint8_t* Om_imgEncodePng(uint64_t* out_size, const uint8_t* in_rgb, unsigned in_
 ///
 uint8_t* Om_imgEncodeGif(uint64_t* out_size, const uint8_t* in_rgb, unsigned in_w, unsigned in_h, unsigned in_c);
 
+#ifdef _WIN32
 /// \brief Encode DDB data.
 ///
 /// Encode Device Dependant Bitmap (HBITMAP) version of the given image data.
@@ -244,6 +250,7 @@ uint8_t* Om_imgEncodeGif(uint64_t* out_size, const uint8_t* in_rgb, unsigned in_
 /// \return New HBITMAP or null if error.
 ///
 HBITMAP Om_imgEncodeHbmp(const uint8_t* src_pix, unsigned src_w, unsigned src_h, unsigned src_c);
+#endif // _WIN32
 
 /// \brief Copy and resample.
 ///
@@ -310,6 +317,21 @@ void Om_imgDrawCanvas(uint8_t* cv_pix, unsigned cv_w, unsigned cv_h, const uint8
 ///
 uint8_t* Om_imgMakeThumb(unsigned span, OmSizeMode mode, const uint8_t* src_pix, unsigned src_w, unsigned src_h);
 
+/// \brief Load image thumbnail.
+///
+/// Load image data from buffer in memory and create thumbnail. Image is
+/// decoded at reduced resolution when format allows it, either in DCT domain
+/// for Jpeg or while decoding rows for Png and Gif.
+///
+/// \param[in]  span    : Thumbnail target span.
+/// \param[in]  mode    : Thumbnail resize mode.
+/// \param[in]  in_data : Input image data to decode.
+/// \param[in]  in_size : Input image data size in bytes.
+///
+/// \return New pointer to thumbnail image data or null if error.
+///
+uint8_t* Om_imgLoadThumb(unsigned span, OmSizeMode mode, const uint8_t* in_data, uint64_t in_size);
+
 /// \brief Swap Red and Blue components.
 ///
 /// Swap Rend and Blue components of the given data buffer.
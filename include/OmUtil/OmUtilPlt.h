@@ -0,0 +1,590 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OMUTILPLT_H
+#define OMUTILPLT_H
+
+#include "OmBase.h"
+
+/// \brief Infinite timeout
+///
+/// Timeout value to wait without time limit
+///
+#define OM_PLT_INFINITE       0xFFFFFFFF
+
+/// \brief File open modes
+///
+/// Mode bits for file open function
+///
+#define OM_PLT_FILE_READ      0x1   //< open for reading
+#define OM_PLT_FILE_WRITE     0x2   //< open for writing
+#define OM_PLT_FILE_CREATE    0x4   //< create or truncate file
+#define OM_PLT_FILE_EXCL      0x8   //< deny access to other processes, where supported
+
+/// \brief Item probe results
+///
+/// Results of item probe function
+///
+#define OM_PLT_ITEM_NONE      0     //< item does not exist
+#define OM_PLT_ITEM_BUSY      1     //< item exists but is in use
+#define OM_PLT_ITEM_READY     2     //< item exists and is available
+
+/// \brief Item access modes
+///
+/// Mode bits for item access check function
+///
+#define OM_PLT_ACCESS_READ    0x1   //< read file data or list directory
+#define OM_PLT_ACCESS_WRITE   0x2   //< write file data or add directory items
+#define OM_PLT_ACCESS_EXEC    0x4   //< execute file or traverse directory
+
+/// \brief Directory change actions
+///
+/// Actions of directory change structure
+///
+#define OM_PLT_CHANGE_ADDED     1   //< item created or renamed to
+#define OM_PLT_CHANGE_REMOVED   2   //< item deleted or renamed from
+#define OM_PLT_CHANGE_MODIFIED  3   //< item content modified
+
+/// \brief Directory watch wait results
+///
+/// Results of directory watch wait function
+///
+#define OM_PLT_WATCH_TIMEOUT  0     //< timeout elapsed without change
+#define OM_PLT_WATCH_CHANGES  1     //< changes were received
+#define OM_PLT_WATCH_STOPPED  2     //< stop event was signaled
+#define OM_PLT_WATCH_ERROR    -1    //< watch failed
+
+/// \brief Thread function.
+///
+/// Thread function to be called at thread start.
+///
+/// \param[in]  ptr     : User data pointer.
+///
+/// \return Thread result value.
+///
+typedef uint32_t (*Om_pltThreadFn)(void* ptr);
+
+/// \brief Thread end function.
+///
+/// Function to be called once watched thread ended.
+///
+/// \param[in]  ptr     : User data pointer.
+/// \param[in]  fired   : Wait timed out, always zero as wait has no timeout.
+///
+typedef void (*Om_pltThreadEndFn)(void* ptr, uint8_t fired);
+
+/// \brief Directory entry structure
+///
+/// Structure to describe an item found while enumerating directory.
+///
+typedef struct OmPltDirEnt_
+{
+  OmWString     name;     ///< Item name
+  bool          isdir;    ///< Item is a directory
+  bool          hidden;   ///< Item is hidden
+  bool          islink;   ///< Item is a symbolic link or junction
+
+} OmPltDirEnt_t;
+
+/// \brief Item status structure
+///
+/// Structure to describe a file or directory status.
+///
+typedef struct OmPltItemStat_
+{
+  bool          isdir;    ///< Item is a directory
+  bool          hidden;   ///< Item is hidden
+  uint64_t      size;     ///< File size in bytes, zero for directory
+  time_t        mtime;    ///< Last write time
+
+} OmPltItemStat_t;
+
+/// \brief Directory change structure
+///
+/// Structure to describe a change received from directory watch.
+///
+typedef struct OmPltDirChange_
+{
+  int32_t       action;   ///< Change action
+  OmWString     path;     ///< Item path relative to watched directory
+
+} OmPltDirChange_t;
+
+/// \brief OmPltDirChange_t array
+///
+/// Typedef for an STL vector of OmPltDirChange_t type
+///
+typedef std::vector<OmPltDirChange_t> OmPltDirChangeArray;
+
+/// \brief Get error string
+///
+/// Returns readable description of the given system error code as
+/// returned by platform functions.
+///
+/// \param[in]  code    : System error code.
+///
+/// \return Error description string.
+///
+OmWString Om_pltErrorStr(int32_t code);
+
+/// \brief Get logical processors count
+///
+/// Returns count of logical processors available to the process.
+///
+/// \return Count of logical processors, at least 1.
+///
+unsigned Om_pltCpuCount();
+
+/// \brief Create thread
+///
+/// Creates and starts a new thread.
+///
+/// \param[in]  thread_fn : Function to be called at thread start.
+/// \param[in]  user_ptr  : Custom pointer to be passed to thread function.
+///
+/// \return Thread handle or nullptr if creation failed.
+///
+void* Om_pltThreadCreate(Om_pltThreadFn thread_fn, void* user_ptr);
+
+/// \brief Join thread
+///
+/// Waits for thread end then releases its handle.
+///
+/// \param[in]  hth     : Thread handle.
+///
+/// \return Thread result value.
+///
+uint32_t Om_pltThreadJoin(void* hth);
+
+/// \brief Watch thread end
+///
+/// Registers a function to be called once thread ended. The function is
+/// called from another thread than the caller, except if thread already
+/// ended, in which case it is called before this function returns.
+///
+/// \param[in]  hth      : Thread handle.
+/// \param[in]  end_fn   : Function to be called at thread end.
+/// \param[in]  user_ptr : Custom pointer to be passed to end function.
+///
+/// \return Wait handle or nullptr if registration failed.
+///
+void* Om_pltThreadWatch(void* hth, Om_pltThreadEndFn end_fn, void* user_ptr);
+
+/// \brief Wait thread
+///
+/// Waits for thread end without releasing its handle.
+///
+/// \param[in]  hth     : Thread handle.
+/// \param[in]  timeout : Timeout in milliseconds or OM_PLT_INFINITE.
+///
+/// \return True if thread ended, false if timeout elapsed.
+///
+bool Om_pltThreadWait(void* hth, uint32_t timeout = OM_PLT_INFINITE);
+
+/// \brief Clear thread
+///
+/// Releases thread and wait handles without waiting for thread end, this
+/// is the way to release a watched thread, including from its end function.
+///
+/// \param[in]  hth     : Thread handle, may be nullptr.
+/// \param[in]  hwait   : Wait handle, may be nullptr.
+///
+void Om_pltThreadClear(void* hth, void* hwait);
+
+/// \brief Get current thread identifier
+///
+/// Returns system identifier of the calling thread.
+///
+/// \return Thread identifier.
+///
+uint32_t Om_pltThreadId();
+
+/// \brief Sleep
+///
+/// Suspends the calling thread for the specified delay.
+///
+/// \param[in]  ms      : Delay in milliseconds.
+///
+void Om_pltSleep(uint32_t ms);
+
+/// \brief Create event
+///
+/// Creates a new event object, initially not signaled.
+///
+/// \param[in]  manual  : If true event remains signaled until reset,
+///                       otherwise it is reset once a single wait returns.
+///
+/// \return Event handle or nullptr if creation failed.
+///
+void* Om_pltEventCreate(bool manual);
+
+/// \brief Set event
+///
+/// Sets event to signaled state.
+///
+/// \param[in]  hev     : Event handle.
+///
+void Om_pltEventSet(void* hev);
+
+/// \brief Reset event
+///
+/// Sets event to non-signaled state.
+///
+/// \param[in]  hev     : Event handle.
+///
+void Om_pltEventReset(void* hev);
+
+/// \brief Wait event
+///
+/// Waits for event to be signaled.
+///
+/// \param[in]  hev     : Event handle.
+/// \param[in]  timeout : Timeout in milliseconds or OM_PLT_INFINITE.
+///
+/// \return True if event was signaled, false if timeout elapsed.
+///
+bool Om_pltEventWait(void* hev, uint32_t timeout = OM_PLT_INFINITE);
+
+/// \brief Close event
+///
+/// Releases event object.
+///
+/// \param[in]  hev     : Event handle.
+///
+void Om_pltEventClose(void* hev);
+
+/// \brief Create lock
+///
+/// Creates a new recursive mutual exclusion lock.
+///
+/// \return Lock handle.
+///
+void* Om_pltLockCreate();
+
+/// \brief Acquire lock
+///
+/// Waits for and takes ownership of the lock.
+///
+/// \param[in]  hlk     : Lock handle.
+///
+void Om_pltLockEnter(void* hlk);
+
+/// \brief Release lock
+///
+/// Releases ownership of the lock.
+///
+/// \param[in]  hlk     : Lock handle.
+///
+void Om_pltLockLeave(void* hlk);
+
+/// \brief Close lock
+///
+/// Releases lock object.
+///
+/// \param[in]  hlk     : Lock handle.
+///
+void Om_pltLockClose(void* hlk);
+
+/// \brief Atomic increment
+///
+/// Atomically increments the given value.
+///
+/// \param[in]  val     : Pointer to value to increment.
+///
+/// \return Incremented value.
+///
+int64_t Om_pltAtomicInc(volatile int64_t* val);
+
+/// \brief Atomic exchange
+///
+/// Atomically sets the given value.
+///
+/// \param[in]  val     : Pointer to value to set.
+/// \param[in]  set     : Value to set.
+///
+/// \return Previous value.
+///
+int32_t Om_pltAtomicSet(volatile int32_t* val, int32_t set);
+
+/// \brief Get tick count
+///
+/// Returns monotonic time elapsed since system start.
+///
+/// \return Time in milliseconds.
+///
+uint64_t Om_pltTickCount();
+
+/// \brief Get precise time
+///
+/// Returns monotonic time from high resolution clock, with an arbitrary
+/// but fixed origin.
+///
+/// \return Time in microseconds.
+///
+uint64_t Om_pltTimeUs();
+
+/// \brief Open file
+///
+/// Opens or creates file with the specified mode.
+///
+/// \param[in]  path    : Path to file.
+/// \param[in]  mode    : Open mode bits.
+///
+/// \return File handle or nullptr if open failed.
+///
+void* Om_pltFileOpen(const OmWString& path, unsigned mode);
+
+/// \brief Read file
+///
+/// Reads data from file at current position.
+///
+/// \param[in]  hfile   : File handle.
+/// \param[out] buf     : Buffer that receive data.
+/// \param[in]  len     : Count of bytes to read.
+///
+/// \return Count of bytes read or -1 if read failed.
+///
+int64_t Om_pltFileRead(void* hfile, void* buf, size_t len);
+
+/// \brief Write file
+///
+/// Writes data to file at current position.
+///
+/// \param[in]  hfile   : File handle.
+/// \param[in]  buf     : Data to write.
+/// \param[in]  len     : Count of bytes to write.
+///
+/// \return Count of bytes written or -1 if write failed.
+///
+int64_t Om_pltFileWrite(void* hfile, const void* buf, size_t len);
+
+/// \brief Seek file
+///
+/// Moves file position.
+///
+/// \param[in]  hfile   : File handle.
+/// \param[in]  offset  : Offset from file start in bytes.
+///
+/// \return True if operation succeed, false otherwise.
+///
+bool Om_pltFileSeek(void* hfile, uint64_t offset);
+
+/// \brief Get file size
+///
+/// Returns size of opened file.
+///
+/// \param[in]  hfile   : File handle.
+///
+/// \return File size in bytes.
+///
+uint64_t Om_pltFileSize(void* hfile);
+
+/// \brief Close file
+///
+/// Closes file handle.
+///
+/// \param[in]  hfile   : File handle.
+///
+void Om_pltFileClose(void* hfile);
+
+/// \brief Probe item
+///
+/// Checks whether the specified file or directory exists and can be taken
+/// for exclusive access, this is used to know whether a newly created item
+/// is still being written.
+///
+/// \param[in]  path    : Path to item.
+///
+/// \return Item probe result.
+///
+int32_t Om_pltItemProbe(const OmWString& path);
+
+/// \brief Get item identity
+///
+/// Retrieves the identity of the specified file or directory, links
+/// being resolved, so two paths to the same item give the same identity.
+///
+/// \param[in]  path    : Path to item.
+/// \param[out] volume  : Pointer to value that receive volume identifier.
+/// \param[out] index   : Pointer to value that receive item index on volume.
+///
+/// \return True if operation succeed, false otherwise.
+///
+bool Om_pltItemIdent(const OmWString& path, uint64_t* volume, uint64_t* index);
+
+/// \brief Get item status
+///
+/// Retrieves status of the specified file or directory.
+///
+/// \param[in]  path    : Path to item.
+/// \param[out] stat    : Pointer to structure that receive status.
+///
+/// \return True if operation succeed, false if item does not exist.
+///
+bool Om_pltItemStat(const OmWString& path, OmPltItemStat_t* stat);
+
+/// \brief Check item access
+///
+/// Checks whether the current process is granted the specified access
+/// to file or directory.
+///
+/// \param[in]  path    : Path to item.
+/// \param[in]  mode    : Access mode bits.
+///
+/// \return True if access is granted, false otherwise.
+///
+bool Om_pltItemAccess(const OmWString& path, unsigned mode);
+
+/// \brief Move item to trash
+///
+/// Moves the specified file or directory to user trash so it can be
+/// restored later.
+///
+/// \param[in]  path    : Path to item.
+///
+/// \return Zero if operation succeed, system error code otherwise.
+///
+int32_t Om_pltItemTrash(const OmWString& path);
+
+/// \brief Check network path
+///
+/// Checks whether the specified path is located on a network share.
+///
+/// \param[in]  path    : Path to check.
+///
+/// \return True if path is on network share, false otherwise.
+///
+bool Om_pltPathIsNetwork(const OmWString& path);
+
+/// \brief Create directory
+///
+/// Creates the specified directory, parent directory must exist.
+///
+/// \param[in]  path    : Path to directory.
+///
+/// \return Zero if operation succeed, system error code otherwise.
+///
+int32_t Om_pltDirCreate(const OmWString& path);
+
+/// \brief Delete directory
+///
+/// Deletes the specified empty directory, directory link is deleted
+/// without its target.
+///
+/// \param[in]  path    : Path to directory.
+///
+/// \return Zero if operation succeed, system error code otherwise.
+///
+int32_t Om_pltDirDelete(const OmWString& path);
+
+/// \brief Copy file
+///
+/// Copies file data, attributes and last write time, existing
+/// destination file is replaced.
+///
+/// \param[in]  src     : Path to source file.
+/// \param[in]  dst     : Path to destination file.
+///
+/// \return Zero if operation succeed, system error code otherwise.
+///
+int32_t Om_pltFileCopy(const OmWString& src, const OmWString& dst);
+
+/// \brief Move file
+///
+/// Moves or renames file, existing destination file is replaced and file
+/// is copied then deleted if moved to another volume.
+///
+/// \param[in]  src     : Path to source file.
+/// \param[in]  dst     : Path to destination file.
+///
+/// \return Zero if operation succeed, system error code otherwise.
+///
+int32_t Om_pltFileMove(const OmWString& src, const OmWString& dst);
+
+/// \brief Delete file
+///
+/// Deletes the specified file.
+///
+/// \param[in]  path    : Path to file.
+///
+/// \return Zero if operation succeed, system error code otherwise.
+///
+int32_t Om_pltFileDelete(const OmWString& path);
+
+/// \brief Open directory
+///
+/// Starts enumeration of the specified directory items.
+///
+/// \param[in]  path    : Path to directory.
+///
+/// \return Directory handle or nullptr if open failed.
+///
+void* Om_pltDirOpen(const OmWString& path);
+
+/// \brief Next directory entry
+///
+/// Retrieves the next directory item, current and parent directory
+/// entries are skipped.
+///
+/// \param[in]  hdir    : Directory handle.
+/// \param[out] ent     : Pointer to structure that receive item.
+///
+/// \return True if an item was retrieved, false if there is no more item.
+///
+bool Om_pltDirNext(void* hdir, OmPltDirEnt_t* ent);
+
+/// \brief Close directory
+///
+/// Ends directory enumeration.
+///
+/// \param[in]  hdir    : Directory handle.
+///
+void Om_pltDirClose(void* hdir);
+
+/// \brief Open directory watch
+///
+/// Starts watching changes in the specified directory and its subtree.
+///
+/// \param[in]  path    : Path to directory.
+///
+/// \return Watch handle or nullptr if watch failed.
+///
+void* Om_pltWatchOpen(const OmWString& path);
+
+/// \brief Wait directory changes
+///
+/// Waits for changes in watched directory. The wait returns early if the
+/// given stop event is signaled. Received changes are appended to array,
+/// an empty array after changes were received means some changes were lost.
+///
+/// \param[in]  hwatch  : Watch handle.
+/// \param[in]  hstop   : Stop event handle.
+/// \param[in]  timeout : Timeout in milliseconds or OM_PLT_INFINITE.
+/// \param[out] changes : Pointer to array to be filled with changes.
+///
+/// \return Watch wait result.
+///
+int32_t Om_pltWatchWait(void* hwatch, void* hstop, uint32_t timeout, OmPltDirChangeArray* changes);
+
+/// \brief Close directory watch
+///
+/// Stops watching directory.
+///
+/// \param[in]  hwatch  : Watch handle.
+///
+void Om_pltWatchClose(void* hwatch);
+
+#endif // OMUTILPLT_H
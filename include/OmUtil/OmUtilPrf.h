@@ -0,0 +1,248 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OMUTILPRF_H
+#define OMUTILPRF_H
+
+#include "OmBase.h"
+
+/// \brief Performance spans capacity
+///
+/// Maximum count of recorded spans, once reached the oldest spans are
+/// overwritten.
+///
+#define OM_PERF_MAX_SPANS   65536
+
+/// \brief Performance span structure
+///
+/// Structure to describe a recorded timed operation.
+///
+typedef struct OmPerfSpan_
+{
+  OmWString     name;     ///< Operation name
+  OmWString     detail;   ///< Operation subject, such as Mod identity
+  uint32_t      thread;   ///< Identifier of thread which did the operation
+  uint64_t      start;    ///< Start time in microseconds since recording start
+  uint64_t      length;   ///< Duration in microseconds
+  uint64_t      files;    ///< Count of processed files
+  uint64_t      bytes;    ///< Count of processed bytes
+
+} OmPerfSpan_t;
+
+/// \brief OmPerfSpan_t array
+///
+/// Typedef for an STL vector of OmPerfSpan_t type
+///
+typedef std::vector<OmPerfSpan_t> OmPerfSpanArray;
+
+/// \brief Performance statistic structure
+///
+/// Structure to describe aggregated statistics of spans sharing the
+/// same operation name.
+///
+typedef struct OmPerfStat_
+{
+  OmWString     name;     ///< Operation name
+  uint64_t      count;    ///< Count of recorded spans
+  uint64_t      total;    ///< Total duration in microseconds
+  uint64_t      longest;  ///< Longest duration in microseconds
+  uint64_t      files;    ///< Total count of processed files
+  uint64_t      bytes;    ///< Total count of processed bytes
+
+} OmPerfStat_t;
+
+/// \brief OmPerfStat_t array
+///
+/// Typedef for an STL vector of OmPerfStat_t type
+///
+typedef std::vector<OmPerfStat_t> OmPerfStatArray;
+
+/// \brief Enable performance recording
+///
+/// Enables or disables recording of performance spans. While disabled
+/// spans cost a single test and nothing is recorded.
+///
+/// \param[in]  enable  : Boolean value to set.
+///
+void Om_perfEnable(bool enable);
+
+/// \brief Check performance recording
+///
+/// Checks whether performance spans recording is enabled.
+///
+/// \return True if recording is enabled, false otherwise.
+///
+bool Om_perfEnabled();
+
+/// \brief Performance time
+///
+/// Returns current time in microseconds since recording start, using high
+/// resolution performance counter.
+///
+/// \return Time in microseconds.
+///
+uint64_t Om_perfTime();
+
+/// \brief Record performance span
+///
+/// Records a timed operation span, this does nothing if recording is
+/// disabled.
+///
+/// \param[in]  name    : Operation name.
+/// \param[in]  detail  : Operation subject.
+/// \param[in]  start   : Start time as returned by Om_perfTime.
+/// \param[in]  files   : Count of processed files.
+/// \param[in]  bytes   : Count of processed bytes.
+///
+void Om_perfRecord(const wchar_t* name, const OmWString& detail, uint64_t start, uint64_t files, uint64_t bytes);
+
+/// \brief Get performance spans
+///
+/// Retrieves recorded performance spans, in recording order.
+///
+/// \param[out] spans   : Pointer to array to be filled with spans.
+///
+void Om_perfGetSpans(OmPerfSpanArray* spans);
+
+/// \brief Get performance statistics
+///
+/// Retrieves statistics of recorded performance spans aggregated by
+/// operation name.
+///
+/// \param[out] stats   : Pointer to array to be filled with statistics.
+///
+void Om_perfGetStats(OmPerfStatArray* stats);
+
+/// \brief Clear performance spans
+///
+/// Discards all recorded performance spans.
+///
+void Om_perfClear();
+
+/// \brief Save performance spans
+///
+/// Saves recorded performance spans and statistics to file as JSON.
+///
+/// \param[in]  path    : Path to file to write.
+///
+/// \return True if operation succeed, false otherwise.
+///
+bool Om_perfSaveJson(const OmWString& path);
+
+/// \brief Save performance trace
+///
+/// Saves recorded performance spans to file using the Chrome trace event
+/// format, to be opened with chrome://tracing or compatible viewers.
+///
+/// \param[in]  path    : Path to file to write.
+///
+/// \return True if operation succeed, false otherwise.
+///
+bool Om_perfSaveTrace(const OmWString& path);
+
+/// \brief Performance span scope
+///
+/// Helper object to record a performance span for the duration of its
+/// scope. Span is recorded at destruction or when end() is called. Nothing
+/// is done if recording was disabled at construction.
+///
+class OmPerfScope
+{
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// Starts span with the given operation name.
+    ///
+    /// \param[in]  name    : Operation name, must be a static string.
+    ///
+    OmPerfScope(const wchar_t* name) :
+      _name(name), _start(0), _files(0), _bytes(0), _enabled(Om_perfEnabled())
+    {
+      if(this->_enabled) this->_start = Om_perfTime();
+    }
+
+    /// \brief Constructor.
+    ///
+    /// Starts span with the given operation name and subject.
+    ///
+    /// \param[in]  name    : Operation name, must be a static string.
+    /// \param[in]  detail  : Operation subject.
+    ///
+    OmPerfScope(const wchar_t* name, const OmWString& detail) :
+      _name(name), _start(0), _files(0), _bytes(0), _enabled(Om_perfEnabled())
+    {
+      if(this->_enabled) {
+        this->_detail = detail;
+        this->_start = Om_perfTime();
+      }
+    }
+
+    /// \brief Destructor.
+    ///
+    /// Records span if not already done.
+    ///
+    ~OmPerfScope() {
+      this->end();
+    }
+
+    /// \brief Add files count
+    ///
+    /// Adds to count of processed files.
+    ///
+    /// \param[in]  count   : Count to add.
+    ///
+    void addFiles(uint64_t count) {
+      this->_files += count;
+    }
+
+    /// \brief Add bytes count
+    ///
+    /// Adds to count of processed bytes.
+    ///
+    /// \param[in]  count   : Count to add.
+    ///
+    void addBytes(uint64_t count) {
+      this->_bytes += count;
+    }
+
+    /// \brief End span
+    ///
+    /// Records span now instead of at destruction.
+    ///
+    void end() {
+      if(this->_enabled) {
+        Om_perfRecord(this->_name, this->_detail, this->_start, this->_files, this->_bytes);
+        this->_enabled = false;
+      }
+    }
+
+  private:
+
+    const wchar_t*      _name;
+
+    OmWString           _detail;
+
+    uint64_t            _start;
+
+    uint64_t            _files;
+
+    uint64_t            _bytes;
+
+    bool                _enabled;
+};
+
+#endif // OMUTILPRF_H
@@ -0,0 +1,80 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OMUTILTHD_H
+#define OMUTILTHD_H
+
+#include "OmBase.h"
+
+/// \brief Parallel job callback.
+///
+/// Callback function for parallel job processing.
+///
+/// \param[in]  ptr     : User data pointer.
+/// \param[in]  index   : Index of the job item to process.
+/// \param[in]  worker  : Index of the worker thread processing the item.
+///
+/// \return True to continue, false to abort the whole process.
+///
+typedef bool (*Om_jobCb)(void* ptr, size_t index, unsigned worker);
+
+/// \brief Get logical processors count
+///
+/// Returns count of logical processors available to the process.
+///
+/// \return Count of logical processors, at least 1.
+///
+unsigned Om_cpuCount();
+
+/// \brief Get worker threads count
+///
+/// Returns the count of worker threads that should be used to process
+/// the specified count of items according the requested maximum. This is
+/// always 1 when called from a parallel for job.
+///
+/// \param[in]  count   : Count of items to process.
+/// \param[in]  threads : Maximum worker threads, 0 for logical processors count.
+///
+/// \return Count of worker threads to use.
+///
+unsigned Om_workerCount(size_t count, unsigned threads = 0);
+
+/// \brief Parallel for loop
+///
+/// Process the specified count of items using worker threads, each
+/// worker threads fetch the next item index to process until all items
+/// are processed. The function returns once all items are processed.
+///
+/// Item indexes are distributed in ascending order but may complete in
+/// any order. Each worker is identified by an index lower than the value
+/// returned by Om_workerCount with the same parameters, so caller can
+/// allocate per-worker resources (such as file handles) beforehand.
+///
+/// When called from a job of another parallel for loop, items are all
+/// processed by the calling worker, so nested loops never multiply the
+/// count of running threads.
+///
+/// \param[in]  count   : Count of items to process.
+/// \param[in]  job_cb  : Callback function to process an item.
+/// \param[in]  user_ptr: Custom pointer to be passed to callback.
+/// \param[in]  threads : Maximum worker threads, 0 for logical processors count.
+///
+/// \return True if all items were processed, false if a job callback
+///         returned false and process was aborted.
+///
+bool Om_parallelFor(size_t count, Om_jobCb job_cb, void* user_ptr, unsigned threads = 0);
+
+#endif // OMUTILTHD_H
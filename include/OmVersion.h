@@ -191,7 +191,9 @@ class OmVersion
     ///
     /// \return True if this instance is less than the other, false otherwise.
     ///
-    bool operator<(const OmVersion& other) const;
+    bool operator<(const OmVersion& other) const {
+      return (this->compare(other) < 0);
+    }
 
     /// \brief Greater operator.
     ///
@@ -201,7 +203,9 @@ class OmVersion
     ///
     /// \return True if this instance is greater than the other, false otherwise.
     ///
-    bool operator>(const OmVersion& other) const;
+    bool operator>(const OmVersion& other) const {
+      return (this->compare(other) > 0);
+    }
 
     /// \brief Less or equal operator.
     ///
@@ -211,7 +215,9 @@ class OmVersion
     ///
     /// \return True if this instance is less or equal to the other, false otherwise.
     ///
-    bool operator<=(const OmVersion& other) const;
+    bool operator<=(const OmVersion& other) const {
+      return (this->compare(other) <= 0);
+    }
 
     /// \brief Greater or equal operator.
     ///
@@ -221,11 +227,32 @@ class OmVersion
     ///
     /// \return True if this instance is greater or equal to the other, false otherwise.
     ///
-    bool operator>=(const OmVersion& other) const;
+    bool operator>=(const OmVersion& other) const {
+      return (this->compare(other) >= 0);
+    }
+
+    /// \brief Compare versions.
+    ///
+    /// Three-way comparison between two instances, computed without
+    /// branching: each component comparison gives -1, 0 or 1 weighted
+    /// according its significance, so the sign of the sum is the sign
+    /// of the first differing component.
+    ///
+    /// \param[in]  other   : Other instance to compare.
+    ///
+    /// \return Negative value if this instance is less than the other, zero
+    ///         if both are equal, positive value otherwise.
+    ///
+    int compare(const OmVersion& other) const {
+      return ((static_cast<int>(_maj > other._maj) - static_cast<int>(_maj < other._maj)) << 2) +
+             ((static_cast<int>(_min > other._min) - static_cast<int>(_min < other._min)) << 1) +
+              (static_cast<int>(_rev > other._rev) - static_cast<int>(_rev < other._rev));
+    }
 
     /// \brief Version filter test.
     ///
-    /// Check this version against a filter with wildcards.
+    /// Check this version against a filter with wildcards. The filter string
+    /// is parsed at each call, use OmVersionFilter for repeated tests.
     ///
     /// \param[in] filter   : Filter string.
     ///
@@ -251,7 +278,7 @@ class OmVersion
 
   private: ///          - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-    OmWStringArray     _str;   //< version as string
+    OmWString          _str;   //< version as string
 
     uint32_t           _maj;   //< version major number
 
@@ -260,4 +287,86 @@ class OmVersion
     uint32_t           _rev;   //< version revision number
 };
 
+/// \brief Version filter object.
+///
+/// This class provide precompiled version filter with wildcards, to
+/// test versions against the same filter without parsing it again.
+///
+class OmVersionFilter
+{
+  public: ///         - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    /// \brief Constructor.
+    ///
+    /// Default constructor.
+    ///
+    OmVersionFilter();
+
+    /// \brief Constructor.
+    ///
+    /// Initialization constructor.
+    ///
+    /// \param[in]  str     : Filter string to parse.
+    ///
+    OmVersionFilter(const OmWString& str);
+
+    /// \brief Parse filter string.
+    ///
+    /// Parses the supplied filter string, components defined as wildcard
+    /// '*' are ignored during test.
+    ///
+    /// \param[in]  str     : Filter string to parse.
+    ///
+    /// \return True if parsing succeed, false otherwise.
+    ///
+    bool parse(const OmWString& str);
+
+    /// \brief Check validity
+    ///
+    /// Check whether this instance has parsed filter.
+    ///
+    /// \return True if filter is valid, false otherwise
+    ///
+    bool valid() const {
+      return _valid;
+    }
+
+    /// \brief Version filter test.
+    ///
+    /// Check the given version against this filter. Test is done in constant
+    /// time by comparing masked components.
+    ///
+    /// \param[in] version  : Version to test.
+    ///
+    /// \return True if version pass filter, false otherwise.
+    ///
+    bool match(const OmVersion& version) const {
+      return (((version.major() ^ _maj) & _maj_mask) |
+              ((version.minor() ^ _min) & _min_mask) |
+              ((version.revis() ^ _rev) & _rev_mask)) == 0;
+    }
+
+    /// \brief Clear instance
+    ///
+    /// Reset instance to its initial values, matching any version
+    ///
+    void clear();
+
+  private: ///          - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    uint32_t           _maj;       //< filter major number
+
+    uint32_t           _min;       //< filter minor number
+
+    uint32_t           _rev;       //< filter revision number
+
+    uint32_t           _maj_mask;  //< major number mask, zero for wildcard
+
+    uint32_t           _min_mask;  //< minor number mask, zero for wildcard
+
+    uint32_t           _rev_mask;  //< revision number mask, zero for wildcard
+
+    bool               _valid;     //< filter was parsed
+};
+
 #endif // OMVERSION_H
@@ -19,8 +19,17 @@
 
 #include "OmBase.h"
 
+/// \brief Default write-behind delay
+///
+/// Default delay in milliseconds without change before XML config
+/// deferred saving occurs.
+///
+#define OM_XMLCONF_DELAY    500
+
 class OmXmlNode;
 
+class OmXmlNodeRange;
+
 /// \brief OmXmlNode pointer array
 ///
 /// Typedef for an STL vector of OmXmlNode type
@@ -29,12 +38,15 @@ typedef std::vector<OmXmlNode> OmXmlNodeArray;
 
 /// \brief Xml node interface.
 ///
-/// Generic XML node, part of an XML data structure.
+/// Generic XML node, part of an XML data structure. This is a lightweight
+/// handle to a node owned by its document, it can be copied freely and
+/// remains valid as long as the node exists in document.
 ///
 class OmXmlNode
 {
   friend class OmXmlDoc;
   friend class OmXmlConf;
+  friend class OmXmlNodeRange;
 
   public: ///         - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -44,30 +56,6 @@ class OmXmlNode
     ///
     OmXmlNode();
 
-    /// \brief Constructor
-    ///
-    /// \param[in]  other : Other instance to copy.
-    ///
-    /// Copy constructor.
-    ///
-    OmXmlNode(const OmXmlNode& other);
-
-    /// \brief Destructor
-    ///
-    /// Default object destructor
-    ///
-    ~OmXmlNode();
-
-    /// \brief Assign operator.
-    ///
-    /// Copy from another instance.
-    ///
-    /// \param[in]  other : Other instance to copy.
-    ///
-    /// \return Reference to this
-    ///
-    OmXmlNode& operator=(const OmXmlNode& other);
-
     /// \brief Check empty.
     ///
     /// Check whether this instance is empty and does not represent any existing
@@ -233,6 +221,27 @@ class OmXmlNode
     ///
     OmXmlNode parent() const;
 
+    /// \brief Get next sibling.
+    ///
+    /// Returns the next sibling node of this instance, this allow to
+    /// iterate over children without building a list.
+    ///
+    /// \return Next sibling node or empty node if none.
+    ///
+    OmXmlNode next() const;
+
+    /// \brief Get next sibling by tag name.
+    ///
+    /// Returns the next sibling node of this instance with the specified
+    /// tag name, this allow to iterate over children with specified tag
+    /// name without building a list.
+    ///
+    /// \param[in]  name  : Sibling tag name.
+    ///
+    /// \return Next sibling node or empty node if none.
+    ///
+    OmXmlNode next(const OmWString& name) const;
+
     /// \brief Check whether node has child by tag name.
     ///
     /// Checks whether this node has at least one child with the specified
@@ -308,13 +317,14 @@ class OmXmlNode
     ///
     OmXmlNode child(const OmWString& name, const OmWString& attr, const OmWString& value);
 
-    /// \brief Get children list.
+    /// \brief Get children range.
     ///
-    /// Returns list of direct children of this instance.
+    /// Returns range over direct children of this instance, to be used
+    /// in range-based for loop without allocating list.
     ///
-    /// \return List of children.
+    /// \return Range of children.
     ///
-    OmXmlNodeArray children() const;
+    OmXmlNodeRange children() const;
 
     /// \brief Get children list.
     ///
@@ -324,13 +334,17 @@ class OmXmlNode
     ///
     void children(OmXmlNodeArray& ret) const;
 
-    /// \brief Get children list by tag name.
+    /// \brief Get children range by tag name.
+    ///
+    /// Returns range over direct children with specified tag name of this
+    /// instance, to be used in range-based for loop without allocating list.
     ///
-    /// Returns list of direct children with specified tag name of this instance.
+    /// \param[in]  name  : Children tag name, must remain valid during
+    ///                     iteration, typically a string literal.
     ///
-    /// \return List of children.
+    /// \return Range of children.
     ///
-    OmXmlNodeArray children(const OmWString& name) const;
+    OmXmlNodeRange children(const wchar_t* name) const;
 
     /// \brief Get children list by tag name.
     ///
@@ -351,6 +365,18 @@ class OmXmlNode
     ///
     OmXmlNode addChild(const OmWString& name);
 
+    /// \brief Insert new child.
+    ///
+    /// Creates a new node child of this instance, placed before the
+    /// specified existing child.
+    ///
+    /// \param[in]  name  : Tag name of child to create.
+    /// \param[in]  next  : Existing child to insert new node before.
+    ///
+    /// \return Created node, or empty node if next is not a child.
+    ///
+    OmXmlNode insertChild(const OmWString& name, const OmXmlNode& next);
+
     /// \brief Remove child.
     ///
     /// Deletes the specified child node.
@@ -379,10 +405,79 @@ class OmXmlNode
 
   private: ///          - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-    void*               _node;    //< XML node class pointer
+    void*               _node;    //< XML node internal structure pointer
+
+    void*               _lock;    //< Owner document lock pointer
 
 };
 
+/// \brief Xml node children range
+///
+/// Lightweight range over direct children of a node, optionally only those
+/// with a given tag name. Iterating over it does not allocate any memory
+/// unlike children list.
+///
+class OmXmlNodeRange
+{
+  public: ///         - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    /// \brief Range iterator
+    ///
+    /// Forward iterator over children nodes.
+    ///
+    class iterator
+    {
+      public:
+
+        iterator(const OmXmlNode& node, const wchar_t* name) :
+          _node(node), _name(name) {}
+
+        const OmXmlNode& operator*() const {
+          return _node;
+        }
+
+        const OmXmlNode* operator->() const {
+          return &_node;
+        }
+
+        iterator& operator++();
+
+        bool operator!=(const iterator& other) const {
+          return _node._node != other._node._node;
+        }
+
+      private:
+
+        OmXmlNode           _node;    //< Current node
+
+        const wchar_t*      _name;    //< Tag name filter, or null
+    };
+
+    /// \brief Constructor
+    ///
+    /// Constructor with first node of range.
+    ///
+    /// \param[in]  first : First node of range, empty node for empty range.
+    /// \param[in]  name  : Tag name filter, or null for all nodes.
+    ///
+    OmXmlNodeRange(const OmXmlNode& first, const wchar_t* name) :
+      _first(first), _name(name) {}
+
+    iterator begin() const {
+      return iterator(_first, _name);
+    }
+
+    iterator end() const {
+      return iterator(OmXmlNode(), _name);
+    }
+
+  private: ///          - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    OmXmlNode           _first;   //< First node of range
+
+    const wchar_t*      _name;    //< Tag name filter, or null
+};
+
 
 /// \brief Xml document interface
 ///
@@ -519,13 +614,14 @@ class OmXmlDoc
     ///
     OmXmlNode child(const OmWString& name, unsigned i = 0) const;
 
-    /// \brief Get children list.
+    /// \brief Get children range.
     ///
-    /// Returns list of direct children of this instance.
+    /// Returns range over direct children of this instance, to be used
+    /// in range-based for loop without allocating list.
     ///
-    /// \return List of children.
+    /// \return Range of children.
     ///
-    OmXmlNodeArray children() const;
+    OmXmlNodeRange children() const;
 
     /// \brief Get children list.
     ///
@@ -535,15 +631,17 @@ class OmXmlDoc
     ///
     void children(OmXmlNodeArray& ret) const;
 
-    /// \brief Get children list by tag name.
+    /// \brief Get children range by tag name.
     ///
-    /// Returns list of direct children with specified tag name of this instance.
+    /// Returns range over direct children with specified tag name of this
+    /// instance, to be used in range-based for loop without allocating list.
     ///
-    /// \param[in]  name    : Children tag name.
+    /// \param[in]  name    : Children tag name, must remain valid during
+    ///                       iteration, typically a string literal.
     ///
-    /// \return List of children.
+    /// \return Range of children.
     ///
-    OmXmlNodeArray children(const OmWString& name) const;
+    OmXmlNodeRange children(const wchar_t* name) const;
 
     /// \brief Get children list by tag name.
     ///
@@ -564,6 +662,18 @@ class OmXmlDoc
     ///
     OmXmlNode addChild(const OmWString& name);
 
+    /// \brief Insert new child.
+    ///
+    /// Creates a new node child of this instance, placed before the
+    /// specified existing child.
+    ///
+    /// \param[in]  name  : Tag name of child to create.
+    /// \param[in]  next  : Existing child to insert new node before.
+    ///
+    /// \return Created node, or empty node if next is not a child.
+    ///
+    OmXmlNode insertChild(const OmWString& name, const OmXmlNode& next);
+
     /// \brief Remove child.
     ///
     /// Deletes the specified child node.
@@ -694,7 +804,11 @@ class OmXmlConf
 
     /// \brief Save loaded XML config.
     ///
-    /// Save a previously loaded XML config file.
+    /// Save a previously loaded XML config file. The file is first written
+    /// to a temporary file then renamed, so it is never left truncated.
+    ///
+    /// If write-behind is enabled, this only marks the document as modified,
+    /// a snapshot is then taken and written by a background thread.
     ///
     /// \return True if operation succeed, false otherwise.
     ///
@@ -702,12 +816,32 @@ class OmXmlConf
 
     /// \brief Save XML config.
     ///
-    /// Save XML config file as specified filename and location.
+    /// Save XML config file as specified filename and location. The file
+    /// is first written to a temporary file then renamed.
     ///
     /// \return True if operation succeed, false otherwise.
     ///
     bool save(const OmWString& path);
 
+    /// \brief Set write-behind delay.
+    ///
+    /// Enable or disable deferred saving. Once enabled, save() calls are
+    /// coalesced and the file is written by a background thread once no
+    /// new save() call occurred during the specified delay.
+    ///
+    /// \param[in]  delay   : Delay in milliseconds, zero to disable.
+    ///
+    void setWriteBehind(uint32_t delay);
+
+    /// \brief Flush pending save.
+    ///
+    /// Writes immediately any save pending in write-behind mode, and
+    /// waits for it to complete.
+    ///
+    /// \return False if a deferred save failed since last flush.
+    ///
+    bool flush();
+
     /// \brief Get XML data string.
     ///
     /// Returns XML document data as string.
@@ -794,13 +928,14 @@ class OmXmlConf
     ///
     OmXmlNode child(const OmWString& name, const OmWString& attr, const OmWString& value);
 
-    /// \brief Get children list.
+    /// \brief Get children range.
     ///
-    /// Returns list of direct children of this instance.
+    /// Returns range over direct children of this instance, to be used
+    /// in range-based for loop without allocating list.
     ///
-    /// \return List of children.
+    /// \return Range of children.
     ///
-    OmXmlNodeArray children() const;
+    OmXmlNodeRange children() const;
 
     /// \brief Get children list.
     ///
@@ -810,15 +945,17 @@ class OmXmlConf
     ///
     void children(OmXmlNodeArray& ret) const;
 
-    /// \brief Get children list by tag name.
+    /// \brief Get children range by tag name.
     ///
-    /// Returns list of direct children with specified tag name of this instance.
+    /// Returns range over direct children with specified tag name of this
+    /// instance, to be used in range-based for loop without allocating list.
     ///
-    /// \param[in]  name    : Children tag name.
+    /// \param[in]  name    : Children tag name, must remain valid during
+    ///                       iteration, typically a string literal.
     ///
-    /// \return List of children.
+    /// \return Range of children.
     ///
-    OmXmlNodeArray children(const OmWString& name) const;
+    OmXmlNodeRange children(const wchar_t* name) const;
 
     /// \brief Get children list by tag name.
     ///
@@ -839,6 +976,18 @@ class OmXmlConf
     ///
     OmXmlNode addChild(const OmWString& name);
 
+    /// \brief Insert new child.
+    ///
+    /// Creates a new node child of this instance, placed before the
+    /// specified existing child.
+    ///
+    /// \param[in]  name  : Tag name of child to create.
+    /// \param[in]  next  : Existing child to insert new node before.
+    ///
+    /// \return Created node, or empty node if next is not a child.
+    ///
+    OmXmlNode insertChild(const OmWString& name, const OmXmlNode& next);
+
     /// \brief Remove child.
     ///
     /// Deletes the specified child node.
@@ -861,7 +1010,8 @@ class OmXmlConf
 
     /// \brief Clear document.
     ///
-    /// Reset document XML data structure.
+    /// Reset document XML data structure, pending deferred save is
+    /// written before.
     ///
     void clear();
 
@@ -881,6 +1031,10 @@ class OmXmlConf
 
     OmWString           _path;        //< Saved file path
 
+    void*               _lock;        //< Document modification lock
+
+    void*               _flush;       //< Write-behind context pointer
+
     unsigned            _ercode;      //< last error code
 
     uint64_t            _erpoff;      //< last error position offset
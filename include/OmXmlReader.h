@@ -0,0 +1,210 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OMXMLREADER_H
+#define OMXMLREADER_H
+
+#include "OmBase.h"
+
+/// \brief XML reader events
+///
+/// Events returned by the XML reader while reading data
+///
+#define OM_XMLREAD_ERROR    -1    //< Malformed data
+#define OM_XMLREAD_MORE     0     //< More data needed
+#define OM_XMLREAD_OPEN     1     //< Element start tag
+#define OM_XMLREAD_CLOSE    2     //< Element end tag
+#define OM_XMLREAD_END      3     //< Document end
+
+/// \brief Streaming XML reader
+///
+/// Forward-only XML pull reader that parses UTF-8 data as it is fed, without
+/// building any document. Data can be supplied in chunks of any size, the
+/// reader only keeps the currently incomplete token in memory.
+///
+/// Each call to next() returns the next event. Attributes are available with
+/// OM_XMLREAD_OPEN event, character data enclosed within an element (text and
+/// CDATA sections) is available with the OM_XMLREAD_CLOSE event. Comments,
+/// processing instructions and document type declaration are skipped.
+///
+class OmXmlReader
+{
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// Default constructor.
+    ///
+    OmXmlReader();
+
+    /// \brief Destructor.
+    ///
+    /// Default destructor.
+    ///
+    ~OmXmlReader();
+
+    /// \brief Clear reader.
+    ///
+    /// Reset reader to initial state, discarding any pending data.
+    ///
+    void clear();
+
+    /// \brief Feed data.
+    ///
+    /// Append the given chunk of UTF-8 data to be parsed.
+    ///
+    /// \param[in]  data    : Pointer to data to append.
+    /// \param[in]  size    : Size of data in bytes.
+    ///
+    void feed(const uint8_t* data, size_t size);
+
+    /// \brief Finish data.
+    ///
+    /// Tell the reader no more data will be fed, so the end of
+    /// supplied data is the end of document.
+    ///
+    void finish() {
+      this->_done = true;
+    }
+
+    /// \brief Read next event.
+    ///
+    /// Parses data until the next event. If data is incomplete the
+    /// OM_XMLREAD_MORE is returned and the call should be repeated once
+    /// more data was fed.
+    ///
+    /// \return Event type, OM_XMLREAD_ERROR if data is malformed.
+    ///
+    int next();
+
+    /// \brief Current element depth.
+    ///
+    /// Returns depth of the element related to the last event, the root
+    /// element having depth 1.
+    ///
+    /// \return Element depth.
+    ///
+    unsigned depth() const {
+      return this->_depth;
+    }
+
+    /// \brief Current element name.
+    ///
+    /// Returns name of the element related to the last event.
+    ///
+    /// \return UTF-8 element name.
+    ///
+    const OmCString& name() const {
+      return this->_name;
+    }
+
+    /// \brief Check element name.
+    ///
+    /// Checks whether name of the element related to the last event
+    /// matches the specified one.
+    ///
+    /// \param[in]  name    : UTF-8 name to compare.
+    ///
+    /// \return True if name matches, false otherwise.
+    ///
+    bool isName(const char* name) const {
+      return (this->_name.compare(name) == 0);
+    }
+
+    /// \brief Check attribute.
+    ///
+    /// Checks whether the current element has the specified attribute.
+    ///
+    /// \param[in]  name    : UTF-8 attribute name.
+    ///
+    /// \return True if attribute exists, false otherwise.
+    ///
+    bool hasAttr(const char* name) const;
+
+    /// \brief Get attribute.
+    ///
+    /// Returns the specified attribute value of the current element
+    /// as UTF-16 string.
+    ///
+    /// \param[in]  name    : UTF-8 attribute name.
+    ///
+    /// \return Attribute value or empty string if not found.
+    ///
+    OmWString attrAsString(const char* name) const;
+
+    /// \brief Get attribute.
+    ///
+    /// Returns the specified attribute value of the current element
+    /// as 64-bit unsigned integer.
+    ///
+    /// \param[in]  name    : UTF-8 attribute name.
+    ///
+    /// \return Attribute value or 0 if not found.
+    ///
+    uint64_t attrAsUint64(const char* name) const;
+
+    /// \brief Get content.
+    ///
+    /// Returns character data enclosed within the element being closed.
+    ///
+    /// \return UTF-16 content string.
+    ///
+    OmWString content() const;
+
+    /// \brief Get raw content.
+    ///
+    /// Returns character data enclosed within the element being closed.
+    ///
+    /// \return UTF-8 content string.
+    ///
+    const OmCString& text() const {
+      return this->_text;
+    }
+
+  private:
+
+    // incoming data
+    OmCString           _buf;
+
+    size_t              _pos;
+
+    bool                _done;
+
+    // current state
+    OmCStringArray      _stack;
+
+    unsigned            _depth;
+
+    bool                _empty;
+
+    bool                _root;
+
+    bool                _reset;
+
+    OmCString           _name;
+
+    OmCStringArray      _attr_name;
+
+    OmCStringArray      _attr_value;
+
+    OmCString           _text;
+
+    bool                _parse_tag(size_t end);
+
+    const OmCString*    _find_attr(const char* name) const;
+};
+
+#endif // OMXMLREADER_H
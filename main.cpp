@@ -18,11 +18,341 @@
 #include "OmUiMan.h"
 
 #include "OmUtilWin.h"
+#include "OmUtilFs.h"
+#include "OmUtilStr.h"
+#include "OmNetRepo.h"
+#include "OmModBench.h"
+#include "OmUtilPrf.h"
 
+#include <cstdio>
+#include <algorithm>          //< std::sort
+
+/// \brief Repository build progress
+///
+/// Progression callback for command line repository build, prints
+/// processed package to console.
+///
+static bool __build_repo_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t param)
+{
+  const OmWStringArray* paths = static_cast<const OmWStringArray*>(ptr);
+
+  wprintf(L"[%u/%u] %ls\n", static_cast<unsigned>(cur), static_cast<unsigned>(tot),
+          Om_getFilePart((*paths)[param]).c_str());
+
+  return true;
+}
+
+/// \brief Command line repository build
+///
+/// Headless repository build mode, adds or updates references of the
+/// given repository definition for all packages of the specified folder
+/// then saves it. Usage:
+///
+///   OpenModMan.exe --build-repo <definition.omx> <packages folder> [threads]
+///
+/// \return Process exit code, 0 if succeed, 1 if some packages failed,
+///         2 on error.
+///
+static int __build_repo_cli()
+{
+  // we are a GUI program, attach to caller console for output
+  if(AttachConsole(ATTACH_PARENT_PROCESS))
+    freopen("CONOUT$", "w", stdout);
+
+  int argc;
+  wchar_t** argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+
+  if(!argv || argc < 4) {
+    wprintf(L"usage: OpenModMan.exe --build-repo <definition.omx> <packages folder> [threads]\n");
+    if(argv) LocalFree(argv);
+    return 2;
+  }
+
+  OmWString rep_path = argv[2];
+  OmWString pkg_dir = argv[3];
+  unsigned threads = (argc > 4) ? wcstoul(argv[4], nullptr, 10) : 0;
+
+  LocalFree(argv);
+
+  OmNetRepo NetRepo(nullptr);
+
+  // update existing definition or create a new one
+  if(Om_isFile(rep_path)) {
+    if(NetRepo.load(rep_path) != OM_RESULT_OK) {
+      wprintf(L"error: unable to load repository definition: %ls\n", NetRepo.lastError().c_str());
+      return 2;
+    }
+  } else {
+    NetRepo.init(Om_getNamePart(rep_path));
+  }
+
+  // gather package files, sorted so definition does not depend on file system order
+  OmWStringArray ls, paths;
+  Om_lsFile(&ls, pkg_dir, true);
+
+  for(size_t i = 0; i < ls.size(); ++i)
+    if(Om_extensionMatches(ls[i], OM_PKG_FILE_EXT))
+      paths.push_back(ls[i]);
+
+  std::sort(paths.begin(), paths.end());
+
+  OmWString cache_path = Om_concatPathsExt(Om_getDirPart(rep_path), Om_getNamePart(rep_path), OM_REP_BLD_CACHE_EXT);
+
+  OmResult result = NetRepo.build(paths, cache_path, __build_repo_progress_fn, &paths, threads);
+
+  if(NetRepo.save(rep_path) != OM_RESULT_OK) {
+    wprintf(L"error: unable to save repository definition: %ls\n", NetRepo.lastError().c_str());
+    return 2;
+  }
+
+  wprintf(L"%u references written to %ls\n", static_cast<unsigned>(NetRepo.referenceCount()), rep_path.c_str());
+
+  if(result != OM_RESULT_OK) {
+    for(size_t i = 0; i < NetRepo.buildErrors().size(); ++i)
+      wprintf(L"warning: %ls\n", NetRepo.buildErrors()[i].c_str());
+    return 1;
+  }
+
+  return 0;
+}
+
+/// \brief Command line library verification
+///
+/// Headless library verification mode, verifies checksums of packages in
+/// the specified folder against references of the given repository
+/// definition. Usage:
+///
+///   OpenModMan.exe --verify-library <definition.omx> <packages folder> [threads]
+///
+/// \return Process exit code, 0 if all referenced packages match, 1 if some
+///         packages mismatch or are missing, 2 on error.
+///
+static int __verify_library_cli()
+{
+  // we are a GUI program, attach to caller console for output
+  if(AttachConsole(ATTACH_PARENT_PROCESS))
+    freopen("CONOUT$", "w", stdout);
+
+  int argc;
+  wchar_t** argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+
+  if(!argv || argc < 4) {
+    wprintf(L"usage: OpenModMan.exe --verify-library <definition.omx> <packages folder> [threads]\n");
+    if(argv) LocalFree(argv);
+    return 2;
+  }
+
+  OmWString rep_path = argv[2];
+  OmWString pkg_dir = argv[3];
+  unsigned threads = (argc > 4) ? wcstoul(argv[4], nullptr, 10) : 0;
+
+  LocalFree(argv);
+
+  OmNetRepo NetRepo(nullptr);
+
+  if(NetRepo.load(rep_path) != OM_RESULT_OK) {
+    wprintf(L"error: unable to load repository definition: %ls\n", NetRepo.lastError().c_str());
+    return 2;
+  }
+
+  OmWStringArray mismatch, missing;
+
+  size_t matches = NetRepo.verify(pkg_dir, &mismatch, &missing, threads);
+
+  for(size_t i = 0; i < mismatch.size(); ++i)
+    wprintf(L"mismatch: %ls\n", mismatch[i].c_str());
+
+  for(size_t i = 0; i < missing.size(); ++i)
+    wprintf(L"missing: %ls\n", missing[i].c_str());
+
+  wprintf(L"%u packages verified, %u mismatch, %u missing\n", static_cast<unsigned>(matches),
+          static_cast<unsigned>(mismatch.size()), static_cast<unsigned>(missing.size()));
+
+  return (mismatch.empty() && missing.empty()) ? 0 : 1;
+}
+
+/// \brief Command line repository index conversion
+///
+/// Headless repository index mode, loads the given XML repository
+/// definition then saves it back, which writes the binary index alongside
+/// and declares it in definition. Usage:
+///
+///   OpenModMan.exe --index-repo <definition.omx>
+///
+/// \return Process exit code, 0 if succeed, 1 if index was not written,
+///         2 on error.
+///
+static int __index_repo_cli()
+{
+  // we are a GUI program, attach to caller console for output
+  if(AttachConsole(ATTACH_PARENT_PROCESS))
+    freopen("CONOUT$", "w", stdout);
+
+  int argc;
+  wchar_t** argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+
+  if(!argv || argc < 3) {
+    wprintf(L"usage: OpenModMan.exe --index-repo <definition.omx>\n");
+    if(argv) LocalFree(argv);
+    return 2;
+  }
+
+  OmWString rep_path = argv[2];
+
+  LocalFree(argv);
+
+  OmNetRepo NetRepo(nullptr);
+
+  if(NetRepo.load(rep_path) != OM_RESULT_OK) {
+    wprintf(L"error: unable to load repository definition: %ls\n", NetRepo.lastError().c_str());
+    return 2;
+  }
+
+  if(NetRepo.save(rep_path) != OM_RESULT_OK) {
+    wprintf(L"error: unable to save repository definition: %ls\n", NetRepo.lastError().c_str());
+    return 2;
+  }
+
+  OmWString idx_path = Om_concatPathsExt(Om_getDirPart(rep_path), Om_getNamePart(rep_path), OM_REP_IDX_FILE_EXT);
+
+  // index is not declared if it failed to be written
+  if(!NetRepo.hasIndex()) {
+    wprintf(L"error: unable to write repository index: %ls\n", idx_path.c_str());
+    return 1;
+  }
+
+  wprintf(L"%u references indexed to %ls\n", static_cast<unsigned>(NetRepo.referenceCount()), idx_path.c_str());
+
+  return 0;
+}
+
+/// \brief Benchmark progress
+///
+/// Progression callback for command line benchmark, prints current
+/// step to console.
+///
+static bool __bench_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t param)
+{
+  OM_UNUSED(param);
+
+  wprintf(L"%ls [%u/%u]\n", static_cast<const wchar_t*>(ptr), static_cast<unsigned>(cur), static_cast<unsigned>(tot));
+
+  return true;
+}
+
+/// \brief Command line benchmark
+///
+/// Headless benchmark mode, generates a synthetic library in the given
+/// working folder then times Mod operations on it and saves timings as
+/// JSON. Network library is benchmarked only if the working folder is
+/// served over HTTP at the given URL. Usage:
+///
+///   OpenModMan.exe --bench <working folder> [mods=N] [files=N] [size=N]
+///     [overlap=N] [depends=none|chain|star|tree]
+///     [method=store|deflate|lzma|lzma2|zstd] [level=N] [passes=N]
+///     [repo=<url>] [out=<results.json>]
+///
+/// \return Process exit code, 0 if succeed, 1 if benchmark failed,
+///         2 on error.
+///
+static int __bench_cli()
+{
+  // we are a GUI program, attach to caller console for output
+  if(AttachConsole(ATTACH_PARENT_PROCESS))
+    freopen("CONOUT$", "w", stdout);
+
+  int argc;
+  wchar_t** argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+
+  if(!argv || argc < 3) {
+    wprintf(L"usage: OpenModMan.exe --bench <working folder> [mods=N] [files=N] [size=N] [overlap=N] "
+            L"[depends=none|chain|star|tree] [method=store|deflate|lzma|lzma2|zstd] [level=N] "
+            L"[passes=N] [steps=all|<step>,...] [repo=<url>] [out=<results.json>]\n");
+    if(argv) LocalFree(argv);
+    return 2;
+  }
+
+  OmWString work_path = argv[2];
+  OmWString repo_url;
+  OmWString out_path = Om_concatPaths(work_path, L"results.json");
+
+  OmModBenchCfg_t cfg;
+  OmModBench::initConfig(&cfg);
+
+  for(int i = 3; i < argc; ++i) {
+
+    OmWString param = argv[i];
+
+    if(param.compare(0, 5, L"repo=") == 0) {
+      repo_url = param.substr(5);
+    } else if(param.compare(0, 4, L"out=") == 0) {
+      out_path = param.substr(4);
+    } else if(!OmModBench::parseConfig(&cfg, param)) {
+      wprintf(L"error: invalid parameter: %ls\n", param.c_str());
+      LocalFree(argv);
+      return 2;
+    }
+  }
+
+  LocalFree(argv);
+
+  OmModMan manager;
+  OmModBench bench(&manager);
+
+  wprintf(L"generating library: %ls\n", OmModBench::configString(cfg).c_str());
+
+  if(bench.generate(work_path, cfg, __bench_progress_fn, const_cast<wchar_t*>(L"generate")) != OM_RESULT_OK) {
+    wprintf(L"error: %ls\n", bench.lastError().c_str());
+    return 2;
+  }
+
+  if(repo_url.empty())
+    wprintf(L"no repository URL given, network library is skipped\n");
+
+  OmResult result = bench.run(repo_url, __bench_progress_fn, const_cast<wchar_t*>(L"pass"));
+
+  if(result != OM_RESULT_OK)
+    wprintf(L"error: %ls\n", bench.lastError().c_str());
+
+  // summary, full results are in JSON file
+  OmPerfStatArray stats;
+  Om_perfGetStats(&stats);
+
+  for(size_t i = 0; i < stats.size(); ++i) {
+    wprintf(L"%-24ls %8u %12.3f ms\n", stats[i].name.c_str(), static_cast<unsigned>(stats[i].count),
+            static_cast<double>(stats[i].total) / 1000.0);
+  }
+
+  if(!bench.saveResults(out_path)) {
+    wprintf(L"error: %ls\n", bench.lastError().c_str());
+    return 2;
+  }
+
+  wprintf(L"results written to %ls\n", out_path.c_str());
+
+  return (result == OM_RESULT_OK) ? 0 : 1;
+}
+
 int APIENTRY WinMain(HINSTANCE hInst, HINSTANCE hPrevInst, LPSTR lpCmdLine, int nShowCmd)
 {
   OM_UNUSED(hPrevInst); OM_UNUSED(nShowCmd);
 
+  // headless repository build, runs without main dialog
+  if(strncmp(lpCmdLine, "--build-repo", 12) == 0)
+    return __build_repo_cli();
+
+  // headless library verification against repository definition
+  if(strncmp(lpCmdLine, "--verify-library", 16) == 0)
+    return __verify_library_cli();
+
+  // headless repository binary index conversion
+  if(strncmp(lpCmdLine, "--index-repo", 12) == 0)
+    return __index_repo_cli();
+
+  // headless benchmark on synthetic library
+  if(strncmp(lpCmdLine, "--bench", 7) == 0)
+    return __bench_cli();
+
   // Check if another instance already running
   HANDLE hMutex = OpenMutexW(MUTEX_ALL_ACCESS, false, L"OpenModMan.Mutex");
   if(hMutex) {
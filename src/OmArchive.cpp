@@ -27,10 +27,9 @@
 #include "minizip-ng/mz_zip.h"
 #include "minizip-ng/mz_zip_rw.h"
 
-#include "OmBaseWin.h"        //< WinAPI
-#include "OmUtilWin.h"
 #include "OmUtilStr.h"
 #include "OmUtilFs.h"
+#include "OmUtilPlt.h"
 
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 #include "OmArchive.h"
@@ -86,6 +85,8 @@ typedef struct zip_entry_
 
   uint64_t        file_size;
 
+  uint32_t        file_crc;
+
   wchar_t         file_path[OM_MAX_PATH];
 
 } zip_entry_t;
@@ -275,6 +276,8 @@ bool OmArchive::read(const OmWString& path)
 
   mz_zip_file *file_info = nullptr;
 
+  OmWString file_path;
+
   do {
     mz_err = mz_zip_entry_get_info(zctx->zip_hnd, &file_info);
     if(mz_err != MZ_OK) break;
@@ -283,11 +286,13 @@ bool OmArchive::read(const OmWString& path)
     zent->method = file_info->compression_method;
     zent->is_dir = (mz_zip_entry_is_dir(zctx->zip_hnd) == MZ_OK);
     zent->file_size = file_info->uncompressed_size;
-    // convert filename UTF-8 to UTF-16
-    MultiByteToWideChar(CP_UTF8, 0, file_info->filename, -1, zent->file_path, OM_MAX_PATH);
-    // replace slash by back-slash
-    for(size_t i = 0; zent->file_path[i] != 0; ++i)
-      if(zent->file_path[i] == L'/') zent->file_path[i] = L'\\';
+    zent->file_crc = file_info->crc;
+    // convert filename UTF-8 to UTF-16 and replace slash by back-slash
+    Om_toUTF16(&file_path, file_info->filename);
+    size_t n = 0;
+    for(; n < file_path.size() && n < OM_MAX_PATH - 1; ++n)
+      zent->file_path[n] = (file_path[n] == L'/') ? L'\\' : file_path[n];
+    zent->file_path[n] = 0;
 
     // next entry
     zent++;
@@ -363,6 +368,17 @@ int32_t OmArchive::entryMethod(size_t i) const
   return -1;
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint32_t OmArchive::entryCrc(size_t i) const
+{
+  if(i < this->_zent_size)
+    return static_cast<zip_entry_t*>(this->_zent)[i].file_crc;
+
+  return 0;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -396,7 +412,7 @@ bool OmArchive::entrySave(size_t i, const OmWString& dst, Om_progressCb progress
       if(!Om_isDir(dst)) {
         // we simply create directory
         mz_err = Om_dirCreateRecursive(dst);
-        if(mz_err != ERROR_SUCCESS) {
+        if(mz_err != 0) {
           zctx->mz_err = mz_err;  zctx->ws_err = L"create directory error";
           return false;
         }
@@ -413,7 +429,7 @@ bool OmArchive::entrySave(size_t i, const OmWString& dst, Om_progressCb progress
     if(!Om_isDir(dst_dir)) {
       // we simply create directory
       mz_err = Om_dirCreateRecursive(dst_dir);
-      if(mz_err != ERROR_SUCCESS) {
+      if(mz_err != 0) {
         zctx->mz_err = mz_err;  zctx->ws_err = L"create directory error";
         return false;
       }
@@ -661,7 +677,7 @@ bool OmArchive::write(const OmWString& path, int32_t method, int32_t level)
   if(!Om_isDir(path_dir)) {
     // we simply create directory
     mz_err = Om_dirCreateRecursive(path_dir);
-    if(mz_err != ERROR_SUCCESS) {
+    if(mz_err != 0) {
       zctx->mz_err = mz_err;  zctx->ws_err = L"create directory error";
       return false;
     }
@@ -778,7 +794,7 @@ bool OmArchive::entryAdd(const OmWString& src, const OmWString& dst, Om_progress
         }
 
         #ifdef DEBUG
-        Sleep(20); //< for debug
+        Om_pltSleep(20); //< for debug
         #endif
 
       }
@@ -897,7 +913,7 @@ bool OmArchive::entryAdd(const void* data, uint64_t size, const OmWString& dst,
         }
 
         #ifdef DEBUG
-        Sleep(20); //< for debug
+        Om_pltSleep(20); //< for debug
         #endif
       }
     }
@@ -941,6 +957,110 @@ uint32_t OmArchive::entryLocate(const OmWString& entry) const
 }
 
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmArchive::entryCopy(const OmArchive& source, size_t i, const OmWString& dst) const
+{
+  int32_t mz_err;
+
+  if(!(this->_stat & ZIP_WRITER) || !(source._stat & ZIP_READER))
+    return false;
+
+  zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
+
+  if(i >= source._zent_size) {
+    zctx->mz_err = MZ_PARAM_ERROR;  zctx->ws_err = L"source entry index error";
+    return false;
+  }
+
+  zip_context_t* sctx = static_cast<zip_context_t*>(source._zctx);
+  zip_entry_t* szent = static_cast<zip_entry_t*>(source._zent);
+
+  mz_err = mz_zip_goto_entry(sctx->zip_hnd, szent[i].offset);
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err;  zctx->ws_err = L"source entry goto error";
+    return false;
+  }
+
+  // get zipped file info
+  mz_zip_file *src_info = nullptr;
+  mz_err = mz_zip_entry_get_info(sctx->zip_hnd, &src_info);
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err;  zctx->ws_err = L"source entry info error";
+    return false;
+  }
+
+  OmCString zcdr_dst;
+  Om_toZipCDR(&zcdr_dst, dst);
+
+  // keep source entry properties, only the path changes
+  mz_zip_file file_info = *src_info;
+  file_info.filename = zcdr_dst.c_str();
+  file_info.filename_size = zcdr_dst.size();
+
+  // open source entry for raw reading
+  mz_err = mz_zip_entry_read_open(sctx->zip_hnd, 1, nullptr);
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err;  zctx->ws_err = L"source entry read open error";
+    return false;
+  }
+
+  // open destination entry for raw writing
+  mz_err = mz_zip_entry_write_open(zctx->zip_hnd, &file_info, zctx->cmp_level, 1, nullptr);
+  if(mz_err != MZ_OK) {
+    mz_zip_entry_close(sctx->zip_hnd);
+    zctx->mz_err = mz_err;  zctx->ws_err = L"entry write open error";
+    return false;
+  }
+
+  // if source is not directory, copy compressed data
+  if(mz_zip_attrib_is_dir(file_info.external_fa, file_info.version_madeby) != MZ_OK) {
+
+    int32_t wb = 0;
+    int32_t rb = 0;
+
+    while(mz_err == MZ_OK) {
+      rb = mz_zip_entry_read(sctx->zip_hnd, zctx->buffer, sizeof(zctx->buffer));
+      if(rb > 0) {
+          wb = mz_zip_entry_write(zctx->zip_hnd, zctx->buffer, rb);
+          if(wb != rb) {
+            mz_err = MZ_WRITE_ERROR;
+            break;
+          }
+      } else if(rb < 0) {
+        mz_err = rb;
+        break;
+      } else {
+        mz_err = MZ_END_OF_STREAM;
+        break;
+      }
+    }
+  }
+
+  if(mz_err != MZ_OK && mz_err != MZ_END_OF_STREAM ) {
+    mz_zip_entry_close(sctx->zip_hnd);
+    mz_zip_entry_close(zctx->zip_hnd);
+    zctx->mz_err = mz_err; zctx->ws_err = L"stream error";
+    return false;
+  }
+
+  uint32_t crc32 = 0;
+  int64_t compressed_size = 0;
+  int64_t uncompressed_size = 0;
+
+  mz_err = mz_zip_entry_read_close(sctx->zip_hnd, &crc32, &compressed_size, &uncompressed_size);
+  if(mz_err == MZ_OK)
+    mz_err = mz_zip_entry_write_close(zctx->zip_hnd, crc32, compressed_size, uncompressed_size);
+
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err; zctx->ws_err = L"entry close error";
+    return false;
+  }
+
+  return true;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -1052,7 +1172,7 @@ OmWString OmArchive::lastErrorStr() const
     default: err_str += L"DEFAULT_ERROR"; break;
     }
   } else {
-    err_str += Om_getErrorStr(zctx->mz_err);
+    err_str += Om_pltErrorStr(zctx->mz_err);
   }
 
   err_str +=  L")";
@@ -15,10 +15,13 @@
   along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
 */
 #include "OmUtilStr.h"
+#include "OmUtilPlt.h"
 
 #include <curl/curl.h>
 
-#include <winsock.h>
+#ifdef _WIN32
+  #include <winsock.h>
+#endif
 
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 #include "OmConnect.h"
@@ -102,7 +105,7 @@ OmConnect::~OmConnect()
 ///
 void OmConnect::clear()
 {
-  Om_threadClear(this->_perform_hth, this->_perform_hwo);
+  Om_pltThreadClear(this->_perform_hth, this->_perform_hwo);
   this->_perform_hth = nullptr;
   this->_perform_hwo = nullptr;
 
@@ -157,6 +160,50 @@ OmResult OmConnect::requestHttpGet(const OmWString& url, OmCString* reponse, uin
 
   this->clear();
 
+  OmResult result = this->_perform_sync(url, false, rate);
+
+  if(result == OM_RESULT_OK) {
+
+    // in the extremely improbable case capacity is not
+    //  enough to add null char we reallocate buffer
+    if(this->_get_data_len + 1 > this->_get_data_cap) {
+      this->_get_data_cap++;
+      this->_get_data_buf = static_cast<uint8_t*>(Om_realloc(this->_get_data_buf, this->_get_data_cap));
+    }
+
+    // add null-char or die
+    if(this->_get_data_buf) {
+      this->_get_data_buf[this->_get_data_len] = '\0';
+      reponse->assign(reinterpret_cast<char*>(this->_get_data_buf), this->_get_data_len);
+    } else {
+      this->_get_data_len = 0;
+      this->_get_data_cap = 0;
+    }
+  }
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmConnect::requestHttpStream(const OmWString& url, Om_responseCb response_cb, void* user_ptr, uint32_t rate)
+{
+  __curl_init();
+
+  this->clear();
+
+  this->_req_response_cb = response_cb;
+  this->_req_user_ptr = user_ptr;
+
+  return this->_perform_sync(url, true, rate);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmConnect::_perform_sync(const OmWString& url, bool stream, uint32_t rate)
+{
   this->_heasy = curl_easy_init();
   this->_hmult = curl_multi_init();
 
@@ -171,7 +218,12 @@ OmResult OmConnect::requestHttpGet(const OmWString& url, OmCString* reponse, uin
 
   curl_easy_setopt(curl_easy, CURLOPT_HTTPGET, 1L);
 
-  curl_easy_setopt(curl_easy, CURLOPT_WRITEFUNCTION, OmConnect::_perform_write_mem_fn);
+  if(stream) {
+    // received data is passed to callback as it arrives
+    curl_easy_setopt(curl_easy, CURLOPT_WRITEFUNCTION, OmConnect::_perform_write_cbk_fn);
+  } else {
+    curl_easy_setopt(curl_easy, CURLOPT_WRITEFUNCTION, OmConnect::_perform_write_mem_fn);
+  }
   curl_easy_setopt(curl_easy, CURLOPT_WRITEDATA, this);
 
   curl_easy_setopt(curl_easy, CURLOPT_NOPROGRESS, 1L);
@@ -255,24 +307,6 @@ OmResult OmConnect::requestHttpGet(const OmWString& url, OmCString* reponse, uin
 
     this->_get_data_len = 0;
     this->_get_data_cap = 0;
-
-  } else {
-
-    // in the extremely improbable case capacity is not
-    //  enough to add null char we reallocate buffer
-    if(this->_get_data_len + 1 > this->_get_data_cap) {
-      this->_get_data_cap++;
-      this->_get_data_buf = static_cast<uint8_t*>(Om_realloc(this->_get_data_buf, this->_get_data_cap));
-    }
-
-    // add null-char or die
-    if(this->_get_data_buf) {
-      this->_get_data_buf[this->_get_data_len] = '\0';
-      *reponse = reinterpret_cast<char*>(this->_get_data_buf);
-    } else {
-      this->_get_data_len = 0;
-      this->_get_data_cap = 0;
-    }
   }
 
   OmResult result;
@@ -328,10 +362,10 @@ bool OmConnect::requestHttpGet(const OmWString& url, Om_responseCb response_cb,
   this->_req_abort = false;
 
   // launch new download thread
-  this->_perform_hth = Om_threadCreate(OmConnect::_perform_run_fn, this);
+  this->_perform_hth = Om_pltThreadCreate(OmConnect::_perform_run_fn, this);
 
   // register wait object to track thread end
-  this->_perform_hwo = Om_threadWaitEnd(this->_perform_hth, OmConnect::_perform_end_fn, this);
+  this->_perform_hwo = Om_pltThreadWatch(this->_perform_hth, OmConnect::_perform_end_fn, this);
 
   return true;
 }
@@ -348,26 +382,23 @@ bool OmConnect::requestHttpGet(const OmWString& url, const OmWString& path, bool
 
   this->clear();
 
-  DWORD disp = resume ? OPEN_ALWAYS : CREATE_ALWAYS;
-
-  this->_get_file_hnd = CreateFileW(  path.c_str(),
-                                      GENERIC_WRITE,
-                                      FILE_SHARE_READ,
-                                      nullptr,
-                                      disp,
-                                      FILE_ATTRIBUTE_NORMAL,
-                                      nullptr);
-
-  if(this->_get_file_hnd == INVALID_HANDLE_VALUE) {
-    return false;
+  // open existing file to resume, or create it
+  this->_get_file_hnd = nullptr;
+
+  if(resume)
+    this->_get_file_hnd = Om_pltFileOpen(path, OM_PLT_FILE_WRITE);
+
+  if(!this->_get_file_hnd)
+    this->_get_file_hnd = Om_pltFileOpen(path, OM_PLT_FILE_WRITE|OM_PLT_FILE_CREATE);
+
+  if(!this->_get_file_hnd) {
+    return false;
   }
 
   // to close file handle at end
   this->_get_file_own = true;
-
-  LARGE_INTEGER FileSize;
-  GetFileSizeEx(static_cast<HANDLE>(this->_get_file_hnd), &FileSize);
-  int64_t resume_off = FileSize.QuadPart;
+
+  int64_t resume_off = Om_pltFileSize(this->_get_file_hnd);
 
   this->_heasy = curl_easy_init();
   this->_hmult = curl_multi_init();
@@ -397,7 +428,7 @@ bool OmConnect::requestHttpGet(const OmWString& url, const OmWString& path, bool
     std::cout << "DEBUG => OmConnect::requestHttpGet : resume from :" << resume_off << "\n";
     #endif // DEBUG
 
-    SetFilePointer(static_cast<HANDLE>(this->_get_file_hnd), 0, nullptr, FILE_END);
+    Om_pltFileSeek(this->_get_file_hnd, resume_off);
     curl_easy_setopt(curl_easy, CURLOPT_RESUME_FROM_LARGE, resume_off);
     this->_progress_off = resume_off;
   }
@@ -420,9 +451,9 @@ bool OmConnect::requestHttpGet(const OmWString& url, const OmWString& path, bool
   this->_req_abort = false;
 
   // launch new download thread
-  this->_perform_hth = Om_threadCreate(OmConnect::_perform_run_fn, this);
+  this->_perform_hth = Om_pltThreadCreate(OmConnect::_perform_run_fn, this);
   // register wait object to track thread end
-  this->_perform_hwo = Om_threadWaitEnd(this->_perform_hth, OmConnect::_perform_end_fn, this);
+  this->_perform_hwo = Om_pltThreadWatch(this->_perform_hth, OmConnect::_perform_end_fn, this);
 
   return true;
 }
@@ -441,7 +472,7 @@ bool OmConnect::requestHttpGet(const OmWString& url, void* hfile, bool resume, O
 
   this->_get_file_hnd =hfile;
 
-  if(this->_get_file_hnd == INVALID_HANDLE_VALUE) {
+  if(!this->_get_file_hnd) {
     return false;
   }
 
@@ -450,11 +481,8 @@ bool OmConnect::requestHttpGet(const OmWString& url, void* hfile, bool resume, O
 
   int64_t resume_off = 0L;
 
-  if(resume) {
-    LARGE_INTEGER FileSize;
-    GetFileSizeEx(static_cast<HANDLE>(this->_get_file_hnd), &FileSize);
-    resume_off = FileSize.QuadPart;
-  }
+  if(resume)
+    resume_off = Om_pltFileSize(this->_get_file_hnd);
 
   this->_heasy = curl_easy_init();
   this->_hmult = curl_multi_init();
@@ -484,7 +512,7 @@ bool OmConnect::requestHttpGet(const OmWString& url, void* hfile, bool resume, O
     std::cout << "DEBUG => OmConnect::requestHttpGet : resume from :" << resume_off << "\n";
     #endif // DEBUG
 
-    SetFilePointer(static_cast<HANDLE>(this->_get_file_hnd), 0, nullptr, FILE_END);
+    Om_pltFileSeek(this->_get_file_hnd, resume_off);
     curl_easy_setopt(curl_easy, CURLOPT_RESUME_FROM_LARGE, resume_off);
     this->_progress_off = resume_off;
   }
@@ -507,9 +535,9 @@ bool OmConnect::requestHttpGet(const OmWString& url, void* hfile, bool resume, O
   this->_req_abort = false;
 
   // launch new download thread
-  this->_perform_hth = Om_threadCreate(OmConnect::_perform_run_fn, this);
+  this->_perform_hth = Om_pltThreadCreate(OmConnect::_perform_run_fn, this);
   // register wait object to track thread end
-  this->_perform_hwo = Om_threadWaitEnd(this->_perform_hth, OmConnect::_perform_end_fn, this);
+  this->_perform_hwo = Om_pltThreadWatch(this->_perform_hth, OmConnect::_perform_end_fn, this);
 
   return true;
 }
@@ -543,7 +571,7 @@ bool OmConnect::isPerforming() const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-DWORD WINAPI OmConnect::_perform_run_fn(void* ptr)
+uint32_t OmConnect::_perform_run_fn(void* ptr)
 {
   #ifdef DEBUG
   std::cout << "DEBUG => OmConnect::_perform_run_fn : enter\n";
@@ -620,11 +648,11 @@ DWORD WINAPI OmConnect::_perform_run_fn(void* ptr)
   std::cout << "DEBUG => OmConnect::_perform_run_fn : _req_result=" << std::to_string(self->_req_result) << " (" << curl_easy_strerror((CURLcode)self->_req_result) << ")\n";
   #endif // DEBUG
 
-  DWORD resultCode = 0;
+  uint32_t resultCode = 0;
 
   // close file handle if instance created it
   if(self->_get_file_own && self->_get_file_hnd) {
-    CloseHandle(self->_get_file_hnd);
+    Om_pltFileClose(self->_get_file_hnd);
     self->_get_file_hnd = nullptr;
   }
 
@@ -668,7 +696,7 @@ DWORD WINAPI OmConnect::_perform_run_fn(void* ptr)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-VOID CALLBACK OmConnect::_perform_end_fn(void* ptr, uint8_t timer)
+void OmConnect::_perform_end_fn(void* ptr, uint8_t timer)
 {
   OM_UNUSED(timer);
 
@@ -679,7 +707,7 @@ VOID CALLBACK OmConnect::_perform_end_fn(void* ptr, uint8_t timer)
   OmConnect* self = static_cast<OmConnect*>(ptr);
 
   // free and reset all thread data
-  Om_threadClear(self->_perform_hth, self->_perform_hwo);
+  Om_pltThreadClear(self->_perform_hth, self->_perform_hwo);
   self->_perform_hth = nullptr;
   self->_perform_hwo = nullptr;
 
@@ -753,22 +781,36 @@ size_t OmConnect::_perform_write_mem_fn(char *recv_data, size_t recv_s, size_t r
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-size_t OmConnect::_perform_write_fio_fn(char *recv_data, size_t recv_s, size_t recv_n, void *ptr)
+size_t OmConnect::_perform_write_cbk_fn(char *recv_data, size_t recv_s, size_t recv_n, void *ptr)
 {
   OmConnect* self = static_cast<OmConnect*>(ptr);
 
-  DWORD dwBytesWritten;
+  size_t recv_len = recv_s * recv_n;
+
+  if(self->_req_response_cb)
+    self->_req_response_cb(self->_req_user_ptr, reinterpret_cast<uint8_t*>(recv_data), recv_len, 0);
+
+  // callback may have aborted the request
+  if(self->_req_abort)
+    return CURL_WRITEFUNC_ERROR;
+
+  return recv_len;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+size_t OmConnect::_perform_write_fio_fn(char *recv_data, size_t recv_s, size_t recv_n, void *ptr)
+{
+  OmConnect* self = static_cast<OmConnect*>(ptr);
 
-  WriteFile(static_cast<HANDLE>(  self->_get_file_hnd),
-                                  recv_data,
-                                  recv_s * recv_n,
-                                  &dwBytesWritten,
-                                  nullptr);
+  int64_t wb = Om_pltFileWrite(self->_get_file_hnd, recv_data, recv_s * recv_n);
 
   if(self->_req_abort)
     return CURL_WRITEFUNC_ERROR;
 
-  return dwBytesWritten;
+  // a short count is seen by libCURL as write error
+  return (wb > 0) ? wb : 0;
 }
 
 
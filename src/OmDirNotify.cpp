@@ -17,32 +17,39 @@
 #include "OmBase.h"
 #include "OmUtilAlg.h"
 #include "OmUtilStr.h"
+#include "OmUtilPlt.h"
 
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 #include "OmDirNotify.h"
 
-/// Routine to extract FILE_NOTIFY_INFORMATION Filename to proper
-/// null-terminated string and indicating whether it is subtree item
-static inline bool __get_item_name(wchar_t* dst, const wchar_t* src, size_t src_len)
+/// \brief Default batch delay
+///
+/// Default delay in milliseconds without new change before delivering
+/// accumulated changes.
+///
+#define OM_DIRNOTIFY_DELAY    250
+
+/// \brief Added items poll delay
+///
+/// Delay in milliseconds an added item must stay without change before
+/// its availability is tested.
+///
+#define OM_DIRNOTIFY_POLL     50
+
+/// Routine to extract changed item path to its direct child name and
+/// indicating whether it is subtree item
+static inline bool __get_item_name(OmWString* dst, const OmWString& src)
 {
-  // supplied length is in bytes count
-  size_t num_char = src_len / sizeof(wchar_t);
-
-  size_t len;
+  // we stop at the first '\' indicating this is subitem, we
+  // keep only the direct child, no subitem
+  size_t pos = src.find(L'\\');
 
-  for(len = 0; len < num_char; ++len) {
-
-    // we stop at the first '\' indicating this is subitem, we
-    // keep only the direct child, no subitem
-    if(src[len] == L'\\') {
-      dst[len] = 0;
-      return true;
-    }
-
-    dst[len] = src[len];
+  if(pos != OmWString::npos) {
+    dst->assign(src, 0, pos);
+    return true;
   }
 
-  dst[len] = 0;
+  dst->assign(src);
 
   return false;
 }
@@ -53,10 +60,12 @@ static inline bool __get_item_name(wchar_t* dst, const wchar_t* src, size_t src_
 OmDirNotify::OmDirNotify() :
   _notify_cb(nullptr),
   _user_ptr(nullptr),
+  _batch_cb(nullptr),
+  _batch_ptr(nullptr),
+  _batch_stamp(0),
+  _batch_delay(OM_DIRNOTIFY_DELAY),
   _stop_hev(nullptr),
-  _changes_hth(nullptr),
-  _access_check_hth(nullptr),
-  _access_check_hwo(nullptr)
+  _changes_hth(nullptr)
 {
   //ctor
 }
@@ -67,6 +76,9 @@ OmDirNotify::OmDirNotify() :
 OmDirNotify::~OmDirNotify()
 {
   this->stopMonitor();
+
+  if(this->_stop_hev)
+    Om_pltEventClose(this->_stop_hev);
 }
 
 ///
@@ -81,25 +93,32 @@ void OmDirNotify::setCallback(Om_notifyCb notify_cb, void* user_ptr)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmDirNotify::stopMonitor()
+void OmDirNotify::setBatchCallback(Om_dirBatchCb batch_cb, void* user_ptr)
 {
-  // set 'stop' event
-  SetEvent(this->_stop_hev);
-
-  if(this->_access_check_hth) {
-    // wait for threads to quit
-    WaitForSingleObject(this->_access_check_hth, INFINITE);
-    this->_added_queue.clear();
-  }
+  this->_batch_cb = batch_cb;
+  this->_batch_ptr = user_ptr;
+}
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmDirNotify::stopMonitor()
+{
   if(this->_changes_hth) {
+    // set 'stop' event
+    Om_pltEventSet(this->_stop_hev);
     // wait for threads to quit
-    WaitForSingleObject(this->_changes_hth, INFINITE);
-    CloseHandle(this->_changes_hth);
+    Om_pltThreadJoin(this->_changes_hth);
     this->_changes_hth = nullptr;
-    this->_modif_queue.clear();
   }
 
+  // pending changes are discarded
+  this->_added_queue.clear();
+  this->_added_stamp.clear();
+  this->_batch_created.clear();
+  this->_batch_altered.clear();
+  this->_batch_deleted.clear();
+
   #ifdef DEBUG
   std::wcout << L"DEBUG => OmDirNotify::stopMonitor (" << this->_path << ")\n";
   #endif
@@ -112,59 +131,46 @@ void OmDirNotify::stopMonitor()
 ///
 void OmDirNotify::startMonitor(const OmWString& path)
 {
+  if(this->_changes_hth)
+    this->stopMonitor();
+
   this->_path = path;
 
   #ifdef DEBUG
   std::wcout << L"DEBUG => OmDirNotify::startMonitor (" << path << L")\n";
   #endif
 
-  if(this->_access_check_hth || this->_changes_hth)
-    this->stopMonitor();
-
   // create or reset custom 'stop' event
   if(this->_stop_hev) {
-    ResetEvent(this->_stop_hev);
+    Om_pltEventReset(this->_stop_hev);
   } else {
-    this->_stop_hev = CreateEvent(nullptr, true, false, nullptr);
+    this->_stop_hev = Om_pltEventCreate(true);
   }
 
-  this->_changes_hth = Om_threadCreate(OmDirNotify::_changes_run_fn, this);
+  this->_changes_hth = Om_pltThreadCreate(OmDirNotify::_changes_run_fn, this);
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-DWORD WINAPI OmDirNotify::_changes_run_fn(void* ptr)
+uint32_t OmDirNotify::_changes_run_fn(void* ptr)
 {
   OmDirNotify* self = static_cast<OmDirNotify*>(ptr);
 
-  // get handle to library directory
-  HANDLE hDirectory = CreateFileW(self->_path.c_str(),
-                                  GENERIC_READ,
-                                  FILE_SHARE_READ|FILE_SHARE_DELETE|FILE_SHARE_WRITE,
-                                  nullptr,
-                                  OPEN_EXISTING,
-                                  FILE_FLAG_BACKUP_SEMANTICS|FILE_FLAG_OVERLAPPED, 0);
-
+  // start watching library directory
+  void* hwatch = Om_pltWatchOpen(self->_path);
 
-  // Overlapped structure with event
-  OVERLAPPED Overlapped;
-  Overlapped.hEvent = CreateEvent(nullptr, false, false, nullptr);
-
-  // Array of events to be waited for, the custom 'stop' event at the second position
-  HANDLE hEvents[] = {Overlapped.hEvent, self->_stop_hev};
-
-  // notify filter for read changes
-  DWORD NotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME|FILE_NOTIFY_CHANGE_DIR_NAME|FILE_NOTIFY_CHANGE_LAST_WRITE;
-
-  // buffer for received notifications
-  uint8_t FileNotifyBuf[512000];
+  if(!hwatch) {
+    // nothing to monitor, we simply wait to be stopped
+    Om_pltEventWait(self->_stop_hev);
+    return 0;
+  }
 
-  // Request for changes in directory
-  ReadDirectoryChangesW(hDirectory, FileNotifyBuf, 512000, true, NotifyFilter, nullptr, &Overlapped, nullptr);
+  // received changes
+  OmPltDirChangeArray changes;
 
   // Buffer for file name
-  wchar_t FileName[OM_MAX_PATH];
+  OmWString FileName;
 
   // Flag for subtree item notification
   bool is_subitem = false;
@@ -173,50 +179,68 @@ DWORD WINAPI OmDirNotify::_changes_run_fn(void* ptr)
 
   while(true) {
 
-    DWORD result = WaitForMultipleObjects(2, hEvents, false, INFINITE);
+    // We wake up periodically while added items are waiting to be available
+    // or changes are waiting to be delivered, otherwise we wait for changes
+    uint32_t timeout = OM_PLT_INFINITE;
+
+    if(self->_added_queue.size())
+      timeout = OM_DIRNOTIFY_POLL;
+
+    if(self->_batch_created.size() || self->_batch_altered.size() || self->_batch_deleted.size()) {
+
+      uint64_t elapsed = Om_pltTickCount() - self->_batch_stamp;
+      uint32_t remain = (elapsed < self->_batch_delay) ? static_cast<uint32_t>(self->_batch_delay - elapsed) : 0;
 
-    if(result == 1) //< custom stop object
+      if(remain < timeout)
+        timeout = remain;
+    }
+
+    changes.clear();
+
+    int32_t result = Om_pltWatchWait(hwatch, self->_stop_hev, timeout, &changes);
+
+    if(result == OM_PLT_WATCH_STOPPED || result == OM_PLT_WATCH_ERROR)
       break;
 
-    if(result == 0) { //< event received
+    if(result == OM_PLT_WATCH_CHANGES) { //< changes received
 
       #ifdef DEBUG
       std::wcout << L"DEBUG => OmDirNotify : CHANGES\n";
       #endif
 
-      DWORD bytesTransferred;
-
-      GetOverlappedResult(hDirectory, &Overlapped, &bytesTransferred, false);
+      uint64_t stamp = Om_pltTickCount();
 
-      FILE_NOTIFY_INFORMATION* Notify = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(FileNotifyBuf);
+      // empty changes means buffer overflow, changes are lost
+      for(size_t c = 0; c < changes.size(); ++c) {
 
-      while(true) {
-
-        // We extract item filename from notify structure. We extract only the direct child
+        // We extract item filename from change path. We extract only the direct child
         // of the tracked folder, removing any subtree items from the path. If notification
         // is about subtree item the function return true, so we can make specific operations
         // for such case.
-        is_subitem = __get_item_name(FileName, Notify->FileName, Notify->FileNameLength);
+        is_subitem = __get_item_name(&FileName, changes[c].path);
 
         Om_concatPaths(FilePath, self->_path, FileName);
 
-        switch(Notify->Action)
+        switch(changes[c].action)
         {
-        case FILE_ACTION_ADDED:
+        case OM_PLT_CHANGE_ADDED:
+
+          // In case of file rename, the system may send both renamed and added
+          // notifications, added queue does not allow duplicates.
 
           if(is_subitem) {
 
             // If notification is about subtree item, we treat it as modification of its parent
-            Om_push_backUnique(self->_modif_queue, FilePath);
+            self->_batch_push(OM_NOTIFY_ALTERED, FilePath);
 
           } else {
 
-            self->_access_check_add(FilePath);
+            self->_added_push(FilePath, stamp);
           }
 
           break;
 
-        case FILE_ACTION_REMOVED:
+        case OM_PLT_CHANGE_REMOVED:
 
           #ifdef DEBUG
           std::wcout << L"DEBUG => OmDirNotify : FILE_ACTION_REMOVED (" << FilePath << L")\n";
@@ -225,92 +249,48 @@ DWORD WINAPI OmDirNotify::_changes_run_fn(void* ptr)
           if(is_subitem) {
 
             // If notification is about subtree item, we treat it as modification of its parent
-            Om_push_backUnique(self->_modif_queue, FilePath);
-
-          } else {
-
-            if(self->_notify_cb)
-              self->_notify_cb(self->_user_ptr, OM_NOTIFY_DELETED, reinterpret_cast<uint64_t>(FilePath.c_str()));
-          }
-
-          break;
-
-        case FILE_ACTION_MODIFIED:
-
-            if(!Om_arrayContain(self->_added_queue, FilePath))
-              Om_push_backUnique(self->_modif_queue, FilePath);
-
-          break;
-
-        case FILE_ACTION_RENAMED_OLD_NAME:
-
-          #ifdef DEBUG
-          std::wcout << L"DEBUG => OmDirNotify : FILE_ACTION_RENAMED_OLD_NAME (" << FileName << L")\n";
-          #endif // DEBUG
-
-          if(is_subitem) {
-
-            // If notification is about subtree item, we treat it as modification of its parent
-            Om_push_backUnique(self->_modif_queue, FilePath);
+            self->_batch_push(OM_NOTIFY_ALTERED, FilePath);
 
           } else {
 
-            if(self->_notify_cb)
-              self->_notify_cb(self->_user_ptr, OM_NOTIFY_DELETED, reinterpret_cast<uint64_t>(FilePath.c_str()));
+            self->_batch_push(OM_NOTIFY_DELETED, FilePath);
           }
 
           break;
 
-        case FILE_ACTION_RENAMED_NEW_NAME:
-
-          #ifdef DEBUG
-          std::wcout << L"DEBUG => OmDirNotify : FILE_ACTION_RENAMED_NEW_NAME (" << FileName << L")\n";
-          #endif // DEBUG
+        case OM_PLT_CHANGE_MODIFIED:
 
-          // In case of file rename, the system send both FILE_ACTION_RENAMED_NEW_NAME
-          // and FILE_ACTION_ADDED, so to prevent concurrency bug due to notification
-          // called twice from two threads, we add to queue like another file creation,
-          // verifying it is not already in queue.
-
-          if(is_subitem) {
-
-            // If notification is about subtree item, we treat it as modification of its parent
-            Om_push_backUnique(self->_modif_queue, FilePath);
-
-          } else {
-
-            self->_access_check_add(FilePath);
-          }
+          self->_batch_push(OM_NOTIFY_ALTERED, FilePath);
 
           break;
         }
-
-        if(Notify->NextEntryOffset == 0)
-          break;
-
-        Notify = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(reinterpret_cast<uint8_t*>(Notify) + Notify->NextEntryOffset);
       }
 
-      // Flushes the modification queue, effectively sending notification to client
-      size_t i = self->_modif_queue.size();
-      while(i--) {
-
-        #ifdef DEBUG
-        std::wcout << L"DEBUG => OmDirNotify : File Mod (" << self->_modif_queue[i] << L")\n";
-        #endif // DEBUG
-
-        if(self->_notify_cb)
-          self->_notify_cb(self->_user_ptr, OM_NOTIFY_ALTERED, reinterpret_cast<uint64_t>(self->_modif_queue[i].c_str()));
-
-        self->_modif_queue.erase(self->_modif_queue.begin() + i);
+      // Changes in an added item delay its availability test, so we do not
+      // try to open a file that is still being copied
+      for(size_t i = 0; i < self->_added_queue.size(); ++i) {
+        if(self->_batch_altered.size() && Om_arrayContain(self->_batch_altered, self->_added_queue[i])) {
+          Om_eraseValue(self->_batch_altered, self->_added_queue[i]);
+          self->_added_stamp[i] = stamp;
+        }
       }
+
+      self->_batch_stamp = stamp;
     }
 
-    ReadDirectoryChangesW(hDirectory, FileNotifyBuf, 512000, false, NotifyFilter, nullptr, &Overlapped, nullptr);
+    // test availability of added items
+    if(self->_added_queue.size())
+      self->_added_check(Om_pltTickCount());
+
+    // Deliver accumulated changes once nothing happened during delay
+    if(self->_batch_created.size() || self->_batch_altered.size() || self->_batch_deleted.size()) {
+      if(Om_pltTickCount() - self->_batch_stamp >= self->_batch_delay)
+        self->_batch_flush();
+    }
   }
 
-  // close handle to directory
-  CloseHandle(hDirectory);
+  // stop watching
+  Om_pltWatchClose(hwatch);
 
   return 0;
 }
@@ -318,110 +298,137 @@ DWORD WINAPI OmDirNotify::_changes_run_fn(void* ptr)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmDirNotify::_access_check_add(const OmWString& path)
+void OmDirNotify::_added_push(const OmWString& path, uint64_t stamp)
 {
-  Om_push_backUnique(this->_added_queue, path);
-
-  // start thread
-  if(!this->_access_check_hth) {
-    this->_access_check_hth = Om_threadCreate(OmDirNotify::_access_check_run_fn, this);
-    this->_access_check_hwo = Om_threadWaitEnd(this->_access_check_hth, OmDirNotify::_access_check_end_fn, this);
+  for(size_t i = 0; i < this->_added_queue.size(); ++i) {
+    if(this->_added_queue[i] == path) {
+      this->_added_stamp[i] = stamp;
+      return;
+    }
   }
+
+  this->_added_queue.push_back(path);
+  this->_added_stamp.push_back(stamp);
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-DWORD WINAPI OmDirNotify::_access_check_run_fn(void* ptr)
+void OmDirNotify::_added_check(uint64_t stamp)
 {
-  #ifdef DEBUG
-  std::wcout << L"DEBUG => OmDirNotify::_access_check_run_fn : enter\n";
-  #endif // DEBUG
-
-  OmDirNotify* self = static_cast<OmDirNotify*>(ptr);
-
-  HANDLE hFile;
-  DWORD FileAttr;
-  DWORD Flags;
+  // test added files true availability, so we are sure once notification is sent the file
+  // is available for read/write operation
+  size_t i = this->_added_queue.size();
+  while(i--) {
 
-  while(self->_added_queue.size()) {
+    // item still changing, test it later
+    if(stamp - this->_added_stamp[i] < OM_DIRNOTIFY_POLL)
+      continue;
 
-    // test added files true availability, so we are sure once notification is sent the file
-    // is available for read/write operation
-    size_t i = self->_added_queue.size();
-    while(i--) {
+    int32_t probe = Om_pltItemProbe(this->_added_queue[i]);
 
-      FileAttr = GetFileAttributesW(self->_added_queue[i].c_str());
-
-      // If file does not exist, remove it from queue
-      if(FileAttr == INVALID_FILE_ATTRIBUTES) {
-        #ifdef DEBUG
-        std::wcout << L"DEBUG => OmDirNotify::_access_check_run_fn : removed from invalid file (" << self->_added_queue[i] << L")\n";
-        #endif // DEBUG
-        self->_added_queue.erase(self->_added_queue.begin() + i);
-        continue;
-      }
+    // If file does not exist, remove it from queue
+    if(probe == OM_PLT_ITEM_NONE) {
+      #ifdef DEBUG
+      std::wcout << L"DEBUG => OmDirNotify::_added_check : removed from invalid file (" << this->_added_queue[i] << L")\n";
+      #endif // DEBUG
+      this->_added_queue.erase(this->_added_queue.begin() + i);
+      this->_added_stamp.erase(this->_added_stamp.begin() + i);
+      continue;
+    }
 
-      if(FileAttr & FILE_ATTRIBUTE_DIRECTORY) {
-        Flags = FILE_FLAG_BACKUP_SEMANTICS;
-      } else {
-        Flags = 0;
-      }
+    if(probe == OM_PLT_ITEM_READY) {
 
-      hFile = CreateFileW(self->_added_queue[i].c_str(),
-                          GENERIC_READ|GENERIC_WRITE,
-                          0, //< try to take exclusive control to ensure file is fully available
-                          nullptr,OPEN_EXISTING,Flags,nullptr);
+      #ifdef DEBUG
+      std::wcout << L"DEBUG => OmDirNotify : File Add (" << this->_added_queue[i] << L")\n";
+      #endif // DEBUG
 
-      if(hFile != INVALID_HANDLE_VALUE) {
+      this->_batch_push(OM_NOTIFY_CREATED, this->_added_queue[i]);
+      this->_batch_stamp = stamp;
 
-        CloseHandle(hFile);
+      this->_added_queue.erase(this->_added_queue.begin() + i);
+      this->_added_stamp.erase(this->_added_stamp.begin() + i);
 
-        #ifdef DEBUG
-        std::wcout << L"DEBUG => OmDirNotify : File Add (" << self->_added_queue[i] << L")\n";
-        #endif // DEBUG
+    } else {
 
-        if(self->_notify_cb)
-          self->_notify_cb(self->_user_ptr, OM_NOTIFY_CREATED, reinterpret_cast<uint64_t>(self->_added_queue[i].c_str()));
+      // wait before next try to prevent flood of probes
+      this->_added_stamp[i] = stamp;
+    }
+  }
+}
 
-        self->_added_queue.erase(self->_added_queue.begin() + i);
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmDirNotify::_batch_push(OmNotify notify, const OmWString& path)
+{
+  switch(notify)
+  {
+  case OM_NOTIFY_CREATED:
+    // item deleted then created again is notified as created, the
+    // client already knowing it will handle it as alteration
+    Om_eraseValue(this->_batch_deleted, path);
+    Om_eraseValue(this->_batch_altered, path);
+    Om_push_backUnique(this->_batch_created, path);
+    break;
+
+  case OM_NOTIFY_ALTERED:
+    // alteration of created item is meaningless
+    if(!Om_arrayContain(this->_batch_created, path))
+      Om_push_backUnique(this->_batch_altered, path);
+    break;
+
+  case OM_NOTIFY_DELETED:
+    // item that is no longer there do not need to be checked
+    for(size_t i = 0; i < this->_added_queue.size(); ++i) {
+      if(this->_added_queue[i] == path) {
+        this->_added_queue.erase(this->_added_queue.begin() + i);
+        this->_added_stamp.erase(this->_added_stamp.begin() + i);
+        break;
       }
     }
+    Om_eraseValue(this->_batch_created, path);
+    Om_eraseValue(this->_batch_altered, path);
+    Om_push_backUnique(this->_batch_deleted, path);
+    break;
 
-    // Check for 'stop' event, wait 50 MS each loop to prevent flood of 'CreateFileW'
-    if(0 == WaitForSingleObject(self->_stop_hev, 50))
-      break;
+  default:
+    break;
   }
-
-  #ifdef DEBUG
-  std::wcout << L"DEBUG => OmDirNotify::_access_check_run_fn : leave\n";
-  #endif // DEBUG
-
-  return 0;
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-VOID WINAPI OmDirNotify::_access_check_end_fn(void* ptr, uint8_t fired)
+void OmDirNotify::_batch_flush()
 {
+  // we move changes to local arrays so new changes can be accumulated
+  // while client is processing these
+  OmWStringArray created, altered, deleted;
+
+  created.swap(this->_batch_created);
+  altered.swap(this->_batch_altered);
+  deleted.swap(this->_batch_deleted);
+
   #ifdef DEBUG
-  std::wcout << L"DEBUG => OmDirNotify::_access_check_end_fn\n";
+  std::wcout << L"DEBUG => OmDirNotify::_batch_flush : ++" << created.size()
+             << L" ~=" << altered.size() << L" --" << deleted.size() << L"\n";
   #endif // DEBUG
 
-  OM_UNUSED(fired);
+  if(this->_batch_cb) {
+    this->_batch_cb(this->_batch_ptr, created, altered, deleted);
+    return;
+  }
 
-  OmDirNotify* self = static_cast<OmDirNotify*>(ptr);
+  if(!this->_notify_cb)
+    return;
 
-  Om_threadClear(self->_access_check_hth, self->_access_check_hwo);
+  for(size_t i = 0; i < deleted.size(); ++i)
+    this->_notify_cb(this->_user_ptr, OM_NOTIFY_DELETED, reinterpret_cast<uint64_t>(deleted[i].c_str()));
 
-  // An item may be added in the queue after exiting the loop but before thread
-  // closing so if item remain in queue, we restart the thread right now.
-  if(self->_added_queue.size()) {
-    self->_access_check_hth = Om_threadCreate(OmDirNotify::_access_check_run_fn, self);
-    self->_access_check_hwo = Om_threadWaitEnd(self->_access_check_hth, OmDirNotify::_access_check_end_fn, self);
-  } else {
-    self->_access_check_hth = nullptr;
-    self->_access_check_hwo = nullptr;
-  }
+  for(size_t i = 0; i < created.size(); ++i)
+    this->_notify_cb(this->_user_ptr, OM_NOTIFY_CREATED, reinterpret_cast<uint64_t>(created[i].c_str()));
+
+  for(size_t i = 0; i < altered.size(); ++i)
+    this->_notify_cb(this->_user_ptr, OM_NOTIFY_ALTERED, reinterpret_cast<uint64_t>(altered[i].c_str()));
 }
@@ -272,19 +272,13 @@ bool OmImage::loadThumbnail(const OmWString& path, unsigned span, OmSizeMode mod
   int type = Om_imgGetType(data);
   if(type == 0) { //< unknown image format
     this->_ercode = OM_IMAGE_ERR_TYPE;
+    delete [] data;
     return false;
   }
 
-  unsigned w, h;
-  uint8_t* rgb = Om_imgLoadData(&w, &h, data, size, false);
-
-  if(!rgb) {
-    this->_ercode = OM_IMAGE_ERR_LOAD;
-    return false;
-  }
-
-  this->_data = Om_imgMakeThumb(span, mode, rgb, w, h);
-  Om_free(rgb);
+  // decode image at reduced resolution and create thumbnail
+  this->_data = Om_imgLoadThumb(span, mode, data, size);
+  delete [] data;
 
   if(!this->_data) {
     this->_ercode = OM_IMAGE_ERR_LOAD;
@@ -321,16 +315,8 @@ bool OmImage::loadThumbnail(uint8_t* data, size_t size, unsigned span, OmSizeMod
     return false;
   }
 
-  unsigned w, h;
-  uint8_t* rgb = Om_imgLoadData(&w, &h, data, size, false);
-
-  if(!rgb) {
-    this->_ercode = OM_IMAGE_ERR_LOAD;
-    return false;
-  }
-
-  this->_data = Om_imgMakeThumb(span, mode, rgb, w, h);
-  Om_free(rgb);
+  // decode image at reduced resolution and create thumbnail
+  this->_data = Om_imgLoadThumb(span, mode, data, size);
 
   if(!this->_data) {
     this->_ercode = OM_IMAGE_ERR_LOAD;
@@ -0,0 +1,1739 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
+#include <algorithm>          //< std::sort
+#include <cmath>              //< floor, ceil
+
+#include "OmBaseApp.h"
+
+#include "OmArchive.h"
+
+#include "OmUtilFs.h"
+#include "OmUtilStr.h"
+#include "OmUtilErr.h"
+#include "OmUtilPlt.h"
+#include "OmUtilPrf.h"
+#include "OmUtilImg.h"
+#include "OmUtilHsh.h"
+#include "OmUtilThd.h"
+#include "OmUtilB64.h"
+
+#include "OmModMan.h"
+#include "OmModHub.h"
+#include "OmModChan.h"
+#include "OmModPack.h"
+#include "OmNetRepo.h"
+#include "OmNetIndex.h"
+
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmModBench.h"
+
+/// \brief Benchmark folders
+///
+/// Names of folders created in benchmark working folder
+///
+#define __BENCH_SOURCE    L"Source"
+#define __BENCH_LIBRARY   L"Library"
+#define __BENCH_TARGET    L"Target"
+
+/// \brief Benchmark repository name
+///
+/// Name of generated repository definition, the working folder being
+/// the repository base.
+///
+#define __BENCH_REPO      L"Bench"
+
+/// \brief Write buffer size
+///
+/// Size of buffer used to write generated files
+///
+#define __BENCH_BUFFER    65536
+
+/// \brief Dependency shape names
+///
+/// Names of dependency shapes as used in configuration string, in
+/// OmBenchDepends order.
+///
+static const wchar_t* __depends_name[] = {L"none", L"chain", L"star", L"tree"};
+
+/// \brief Compression method names
+///
+/// Names and values of compression methods as used in configuration string
+///
+static const wchar_t* __method_name[] = {L"store", L"deflate", L"lzma", L"lzma2", L"zstd"};
+static const int32_t  __method_value[] = {OM_METHOD_STORE, OM_METHOD_DEFLATE, OM_METHOD_LZMA, OM_METHOD_LZMA2, OM_METHOD_ZSTD};
+
+/// \brief Step names
+///
+/// Names and flags of benchmark steps as used in configuration string
+///
+static const wchar_t* __step_name[] = {L"mods", L"utf", L"tree", L"image", L"quantize", L"hash", L"index", L"log", L"xml"};
+static const uint32_t __step_value[] = {OM_BENCH_STEP_MODS, OM_BENCH_STEP_UTF, OM_BENCH_STEP_TREE, OM_BENCH_STEP_IMAGE, OM_BENCH_STEP_QUANTIZE, OM_BENCH_STEP_HASH, OM_BENCH_STEP_INDEX, OM_BENCH_STEP_LOG, OM_BENCH_STEP_XML};
+#define __BENCH_STEPS     (sizeof(__step_value) / sizeof(uint32_t))
+
+/// \brief Transcoder corpus size
+///
+/// Size in bytes of UTF-8 corpora used by transcoder step
+///
+#define __BENCH_UTF_SIZE  4194304
+
+/// \brief Tree walker step shapes
+///
+/// Folder name and shapes of trees generated for tree walker step, the
+/// deep tree is a single chain of folders, the wide tree has many folders
+/// at each depth.
+///
+#define __BENCH_TREE          L"Tree"
+#define __BENCH_TREE_DEEP     32
+#define __BENCH_TREE_FANOUT   16
+#define __BENCH_TREE_LEVELS   3
+#define __BENCH_TREE_FILES    2
+
+/// \brief Image step filters
+///
+/// Resampling filters checked by image step, as selected by the resampler
+/// for each case.
+///
+#define __BENCH_IMG_BOX       0
+#define __BENCH_IMG_LIN       1
+#define __BENCH_IMG_CUB       2
+
+/// \brief Image step tolerance
+///
+/// Maximum difference per component between resampler output and reference,
+/// resampler uses fixed-point weights and rounds its intermediate pass to
+/// 8 bits while reference is computed in double precision.
+///
+#define __BENCH_IMG_TOLERANCE 2
+
+/// \brief Quantizer step minimum quality
+///
+/// Minimum PSNR in dB of RGB components between image and its GIF encoded
+/// then decoded version. On the generated images, a uniform 3-3-2 bits
+/// palette gives about 30.5 dB, the GifLib median cut 26.3 and 32.6 dB, and
+/// this quantizer 31.9 and 33.9 dB. Quantizer only uses integer arithmetic
+/// so results do not depend on platform.
+///
+#define __BENCH_QZ_MIN_PSNR   31.5
+
+/// \brief Hash step vectors folder
+///
+/// Folder where MD5 test vectors files are written by hash step
+///
+#define __BENCH_HASH          L"Hash"
+
+/// \brief Log step contention
+///
+/// Count of threads logging simultaneously in log step and count of lines
+/// each one logs, total lines exceed log queue capacity so the dropping
+/// policy is exercised when the writer cannot keep up.
+///
+#define __BENCH_LOG_THREADS   8
+#define __BENCH_LOG_LINES     4096
+
+/// \brief XML step document size
+///
+/// Count of <cpy> and <del> entries of the backup-like definition parsed
+/// and iterated by XML step, one <del> is inserted every 4 <cpy> so tag
+/// name filtering has to skip nodes.
+///
+#define __BENCH_XML_ENTRIES   65536
+
+/// \brief Mod identity
+///
+/// Composes identity of the generated Mod at the given index.
+///
+/// \param[in]  index   : Mod index.
+///
+/// \return Mod identity.
+///
+static OmWString __mod_iden(size_t index)
+{
+  wchar_t buf[64];
+  swprintf(buf, 64, L"Bench_Mod_%04u_v1.0", static_cast<unsigned>(index));
+  return OmWString(buf);
+}
+
+/// \brief Mod dependency
+///
+/// Returns index of the Mod the given one depends on according the
+/// dependency shape.
+///
+/// \param[in]  index   : Mod index.
+/// \param[in]  shape   : Dependency shape.
+///
+/// \return Index of Mod to depend on or -1 if none.
+///
+static int32_t __mod_depend(size_t index, int32_t shape)
+{
+  if(index == 0)
+    return -1;
+
+  switch(shape)
+  {
+  case OM_BENCH_DEPENDS_CHAIN:  return index - 1;
+  case OM_BENCH_DEPENDS_STAR:   return 0;
+  case OM_BENCH_DEPENDS_TREE:   return (index - 1) / 2;
+  }
+
+  return -1;
+}
+
+/// \brief Generate text
+///
+/// Fills buffer with deterministic pseudo-random text. Text is drawn from
+/// a small alphabet so content compresses about as well as usual game
+/// assets.
+///
+/// \param[out] buf     : Buffer to fill.
+/// \param[in]  len     : Count of bytes to write.
+/// \param[in]  state   : Pointer to random generator state, must not be zero.
+///
+static void __gen_text(char* buf, size_t len, uint64_t* state)
+{
+  static const char alphabet[] = "etaoinshrdlu \n.,";
+
+  uint64_t x = *state;
+
+  for(size_t i = 0; i < len; ++i) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    buf[i] = alphabet[x & 0xF];
+  }
+
+  *state = x;
+}
+
+/// \brief Write generated file
+///
+/// Creates file filled with deterministic pseudo-random text.
+///
+/// \param[in]  path    : Path to file to create.
+/// \param[in]  size    : Size of file in bytes.
+/// \param[in]  seed    : Random generator seed.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __write_file(const OmWString& path, uint64_t size, uint64_t seed)
+{
+  void* hfile = Om_pltFileOpen(path, OM_PLT_FILE_WRITE|OM_PLT_FILE_CREATE);
+  if(!hfile)
+    return false;
+
+  char buf[__BENCH_BUFFER];
+
+  // xorshift generator must not be seeded with zero
+  uint64_t x = seed | 1;
+
+  bool result = true;
+
+  while(size && result) {
+
+    size_t len = (size < __BENCH_BUFFER) ? static_cast<size_t>(size) : __BENCH_BUFFER;
+
+    __gen_text(buf, len, &x);
+
+    result = (Om_pltFileWrite(hfile, buf, len) == static_cast<int64_t>(len));
+
+    size -= len;
+  }
+
+  Om_pltFileClose(hfile);
+
+  return result;
+}
+
+/// \brief Generate folder tree
+///
+/// Creates folder tree with empty files, each folder holding the same
+/// count of files and sub-folders.
+///
+/// \param[in]  path    : Path to tree root folder to create.
+/// \param[in]  fanout  : Count of sub-folders per folder.
+/// \param[in]  depth   : Count of sub-folders levels.
+/// \param[out] items   : Pointer to counter incremented by created items.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __gen_tree(const OmWString& path, unsigned fanout, unsigned depth, size_t* items)
+{
+  if(Om_dirCreateRecursive(path) != 0)
+    return false;
+
+  wchar_t buf[32];
+
+  for(unsigned i = 0; i < __BENCH_TREE_FILES; ++i) {
+    swprintf(buf, 32, L"File_%02u.dat", i);
+    if(!__write_file(Om_concatPaths(path, buf), 0, 1))
+      return false;
+    (*items)++;
+  }
+
+  if(depth == 0)
+    return true;
+
+  for(unsigned i = 0; i < fanout; ++i) {
+    swprintf(buf, 32, L"D%02u", i);
+    if(!__gen_tree(Om_concatPaths(path, buf), fanout, depth - 1, items))
+      return false;
+    (*items)++;
+  }
+
+  return true;
+}
+
+/// \brief Generate image
+///
+/// Creates deterministic RGBA image with smooth gradients, sharp checker
+/// edges and noise, so all filter lobes and clamping are exercised.
+///
+/// \param[out] pix     : Pixel buffer to fill.
+/// \param[in]  w       : Image width.
+/// \param[in]  h       : Image height.
+/// \param[in]  seed    : Random generator seed.
+///
+static void __gen_image(std::vector<uint8_t>* pix, unsigned w, unsigned h, uint64_t seed)
+{
+  pix->resize(w * h * 4);
+
+  uint8_t* p = pix->data();
+
+  // xorshift generator must not be seeded with zero
+  uint64_t r = seed | 1;
+
+  for(unsigned y = 0; y < h; ++y) {
+    for(unsigned x = 0; x < w; ++x, p += 4) {
+      r ^= r << 13; r ^= r >> 7; r ^= r << 17;
+      p[0] = (x * 255) / (w - 1);
+      p[1] = (y * 255) / (h - 1);
+      p[2] = (((x / 16) + (y / 16)) & 1) ? 224 : 32;
+      p[3] = r & 0xFF;
+    }
+  }
+}
+
+/// \brief Reference filter taps
+///
+/// Computes filter taps for the given sample position in double precision,
+/// following the resampler definition where pixel centers lie at integer
+/// positions and edge pixels are repeated.
+///
+/// \param[in]  filter  : Filter, one of __BENCH_IMG_* value.
+/// \param[in]  p       : Sample position.
+/// \param[in]  box_n   : Box width in pixels, for box filter.
+/// \param[in]  max_n   : Index of last source pixel.
+/// \param[out] idx     : Array that receive taps source indexes.
+/// \param[out] wgt     : Array that receive taps weights.
+///
+/// \return Count of taps.
+///
+static size_t __ref_taps(int filter, double p, int box_n, int max_n, int* idx, double* wgt)
+{
+  size_t n = 0;
+
+  if(filter == __BENCH_IMG_BOX) {
+
+    int b = static_cast<int>((p + 0.5) - (0.5 * box_n));
+
+    for(int k = 0; k < box_n; ++k)
+      if(b + k >= 0 && b + k <= max_n)
+        idx[n++] = b + k;
+
+    if(n == 0)
+      idx[n++] = (b < 0) ? 0 : max_n;
+
+    for(size_t k = 0; k < n; ++k)
+      wgt[k] = 1.0 / n;
+
+  } else {
+
+    double b = std::floor(p);
+    double t = p - b;
+
+    int s = static_cast<int>(b) - ((filter == __BENCH_IMG_CUB) ? 1 : 0);
+
+    if(filter == __BENCH_IMG_CUB) {
+      // Catmull-Rom spline
+      wgt[0] = 0.5 * (-t + 2.0 * t * t - t * t * t);
+      wgt[1] = 1.0 + 0.5 * (-5.0 * t * t + 3.0 * t * t * t);
+      wgt[2] = 0.5 * (t + 4.0 * t * t - 3.0 * t * t * t);
+      wgt[3] = 0.5 * (-t * t + t * t * t);
+      n = 4;
+    } else {
+      wgt[0] = 1.0 - t;
+      wgt[1] = t;
+      n = 2;
+    }
+
+    for(size_t k = 0; k < n; ++k) {
+      int x = s + static_cast<int>(k);
+      idx[k] = (x < 0) ? 0 : (x > max_n) ? max_n : x;
+    }
+  }
+
+  return n;
+}
+
+/// \brief Reference resampling
+///
+/// Resamples the given source rectangle in double precision, sample
+/// position of each destination pixel is rec + (index * rec / dst) - 0.5
+/// as in resampler. Horizontal sums are clamped before vertical filtering
+/// like resampler intermediate pass, but not rounded.
+///
+/// \param[out] dst     : Destination pixels buffer.
+/// \param[in]  dst_w   : Destination width.
+/// \param[in]  dst_h   : Destination height.
+/// \param[in]  src     : Source pixels buffer.
+/// \param[in]  src_w   : Source width.
+/// \param[in]  src_h   : Source height.
+/// \param[in]  rec_x   : Source rectangle left.
+/// \param[in]  rec_y   : Source rectangle top.
+/// \param[in]  rec_w   : Source rectangle width.
+/// \param[in]  rec_h   : Source rectangle height.
+/// \param[in]  filter  : Filter, one of __BENCH_IMG_* value.
+///
+static void __ref_resample(uint8_t* dst, unsigned dst_w, unsigned dst_h, const uint8_t* src, unsigned src_w, unsigned src_h,
+                           unsigned rec_x, unsigned rec_y, unsigned rec_w, unsigned rec_h, int filter)
+{
+  double f_x = static_cast<double>(rec_w) / dst_w;
+  double f_y = static_cast<double>(rec_h) / dst_h;
+
+  int box_w = static_cast<int>(std::ceil(f_x));
+  int box_h = static_cast<int>(std::ceil(f_y));
+
+  int idx_x[64], idx_y[64];
+  double wgt_x[64], wgt_y[64];
+
+  for(unsigned y = 0; y < dst_h; ++y) {
+
+    size_t n_y = __ref_taps(filter, (rec_y - 0.5) + (y * f_y), box_h, src_h - 1, idx_y, wgt_y);
+
+    for(unsigned x = 0; x < dst_w; ++x) {
+
+      size_t n_x = __ref_taps(filter, (rec_x - 0.5) + (x * f_x), box_w, src_w - 1, idx_x, wgt_x);
+
+      for(unsigned c = 0; c < 4; ++c) {
+
+        double v = 0.0;
+
+        for(size_t j = 0; j < n_y; ++j) {
+
+          double s = 0.0;
+
+          for(size_t i = 0; i < n_x; ++i)
+            s += wgt_x[i] * src[(((idx_y[j] * src_w) + idx_x[i]) * 4) + c];
+
+          v += wgt_y[j] * ((s < 0.0) ? 0.0 : (s > 255.0) ? 255.0 : s);
+        }
+
+        v = std::floor(v + 0.5);
+        dst[(((y * dst_w) + x) * 4) + c] = (v < 0.0) ? 0 : (v > 255.0) ? 255 : static_cast<uint8_t>(v);
+      }
+    }
+  }
+}
+
+/// \brief Compare raw blob
+///
+/// Compares Data URI content with raw data of binary index.
+///
+/// \param[in]  uri     : Data URI from XML definition.
+/// \param[in]  data    : Raw data from binary index.
+/// \param[in]  size    : Raw data size.
+///
+/// \return True if both hold same data, false otherwise.
+///
+static bool __same_blob(const OmWString& uri, const uint8_t* data, size_t size)
+{
+  if(uri.empty())
+    return (size == 0);
+
+  OmWString mime_type, charset;
+  size_t uri_size = 0;
+
+  uint8_t* uri_data = Om_decodeDataUri(&uri_size, mime_type, charset, uri);
+  if(!uri_data)
+    return false;
+
+  bool result = (uri_size == size && memcmp(uri_data, data, size) == 0);
+
+  Om_free(uri_data);
+
+  return result;
+}
+
+/// \brief Compare references
+///
+/// Compares Mod reference read from XML definition with the one read
+/// from binary index.
+///
+/// \param[in]  xml_ref : Reference from XML definition.
+/// \param[in]  idx_ref : Reference from binary index.
+///
+/// \return True if references are identical, false otherwise.
+///
+static bool __same_ref(const OmNetRef_t& xml_ref, const OmNetRef_t& idx_ref)
+{
+  return xml_ref.ident == idx_ref.ident && xml_ref.file == idx_ref.file &&
+         xml_ref.bytes == idx_ref.bytes && xml_ref.xxhsum == idx_ref.xxhsum &&
+         xml_ref.md5sum == idx_ref.md5sum && xml_ref.category == idx_ref.category &&
+         xml_ref.url == idx_ref.url && xml_ref.desc_bytes == idx_ref.desc_bytes &&
+         xml_ref.depends == idx_ref.depends &&
+         __same_blob(xml_ref.thumbnail, idx_ref.thumb_data, idx_ref.thumb_size) &&
+         __same_blob(xml_ref.description, idx_ref.desc_data, idx_ref.desc_size);
+}
+
+/// \brief Log step job
+///
+/// Parallel job of log step, logs the configured count of lines to the
+/// Mod Manager log as fast as possible.
+///
+/// \param[in]  ptr     : Mod Manager.
+/// \param[in]  index   : Thread index.
+/// \param[in]  worker  : Worker index.
+///
+/// \return Always true.
+///
+static bool __log_job_fn(void* ptr, size_t index, unsigned worker)
+{
+  OM_UNUSED(worker);
+
+  OmModMan* ModMan = static_cast<OmModMan*>(ptr);
+
+  wchar_t line[64];
+
+  for(unsigned i = 0; i < __BENCH_LOG_LINES; ++i) {
+    swprintf(line, 64, L"thread %02u line %04u", static_cast<unsigned>(index), i);
+    ModMan->escalateLog(OM_LOG_OK, L"ModBench.log", line);
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmModBench::OmModBench(OmModMan* ModMan) :
+  _ModMan(ModMan),
+  _query_hev(nullptr),
+  _query_result(OM_RESULT_UNKNOW)
+{
+  OmModBench::initConfig(&this->_cfg);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmModBench::~OmModBench()
+{
+  if(this->_query_hev)
+    Om_pltEventClose(this->_query_hev);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModBench::initConfig(OmModBenchCfg_t* cfg)
+{
+  cfg->mods = OM_BENCH_DEF_MODS;
+  cfg->files = OM_BENCH_DEF_FILES;
+  cfg->size = OM_BENCH_DEF_SIZE;
+  cfg->overlap = OM_BENCH_DEF_OVERLAP;
+  cfg->depends = OM_BENCH_DEPENDS_NONE;
+  cfg->method = OM_METHOD_ZSTD;
+  cfg->level = OM_LEVEL_SLOW;
+  cfg->passes = OM_BENCH_DEF_PASSES;
+  cfg->steps = OM_BENCH_DEF_STEPS;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModBench::parseConfig(OmModBenchCfg_t* cfg, const OmWString& param)
+{
+  size_t eq = param.find(L'=');
+  if(eq == OmWString::npos)
+    return false;
+
+  OmWString key = param.substr(0, eq);
+  OmWString val = param.substr(eq + 1);
+
+  if(val.empty())
+    return false;
+
+  if(key == L"mods") {
+    cfg->mods = wcstoul(val.c_str(), nullptr, 10);
+    return (cfg->mods > 0);
+  }
+
+  if(key == L"files") {
+    cfg->files = wcstoul(val.c_str(), nullptr, 10);
+    return (cfg->files > 0);
+  }
+
+  if(key == L"size") {
+    cfg->size = wcstoull(val.c_str(), nullptr, 10);
+    return true;
+  }
+
+  if(key == L"overlap") {
+    cfg->overlap = wcstoul(val.c_str(), nullptr, 10);
+    return (cfg->overlap <= 100);
+  }
+
+  if(key == L"passes") {
+    cfg->passes = wcstoul(val.c_str(), nullptr, 10);
+    return (cfg->passes > 0);
+  }
+
+  if(key == L"level") {
+    cfg->level = wcstol(val.c_str(), nullptr, 10);
+    return (cfg->level >= 0);
+  }
+
+  if(key == L"depends") {
+    for(size_t i = 0; i < 4; ++i) {
+      if(val == __depends_name[i]) {
+        cfg->depends = i;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  if(key == L"method") {
+    for(size_t i = 0; i < 5; ++i) {
+      if(val == __method_name[i]) {
+        cfg->method = __method_value[i];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  if(key == L"steps") {
+
+    if(val == L"all") {
+      cfg->steps = OM_BENCH_DEF_STEPS;
+      return true;
+    }
+
+    OmWStringArray names;
+    Om_splitString(val, L",", &names);
+
+    cfg->steps = 0;
+
+    for(size_t n = 0; n < names.size(); ++n) {
+
+      size_t i = 0;
+      while(i < __BENCH_STEPS && names[n] != __step_name[i])
+        ++i;
+
+      if(i == __BENCH_STEPS)
+        return false;
+
+      cfg->steps |= __step_value[i];
+    }
+
+    return (cfg->steps != 0);
+  }
+
+  return false;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmModBench::configString(const OmModBenchCfg_t& cfg)
+{
+  const wchar_t* method = L"unknown";
+  for(size_t i = 0; i < 5; ++i)
+    if(cfg.method == __method_value[i])
+      method = __method_name[i];
+
+  const wchar_t* depends = L"unknown";
+  if(cfg.depends >= 0 && cfg.depends < 4)
+    depends = __depends_name[cfg.depends];
+
+  OmWString steps;
+  for(size_t i = 0; i < __BENCH_STEPS; ++i) {
+    if(OM_HAS_BIT(cfg.steps, __step_value[i])) {
+      if(!steps.empty()) steps += L",";
+      steps += __step_name[i];
+    }
+  }
+
+  wchar_t buf[256];
+  swprintf(buf, 256, L"mods=%u files=%u size=%llu overlap=%u depends=%ls method=%ls level=%d passes=%u steps=",
+           static_cast<unsigned>(cfg.mods), static_cast<unsigned>(cfg.files),
+           static_cast<unsigned long long>(cfg.size), cfg.overlap, depends, method,
+           static_cast<int>(cfg.level), cfg.passes);
+
+  return OmWString(buf) + steps;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModBench::_gen_source(size_t index, const OmWString& path)
+{
+  wchar_t buf[64];
+
+  swprintf(buf, 64, L"Data\\Mod_%04u", static_cast<unsigned>(index));
+  OmWString own_dir = Om_concatPaths(path, buf);
+  OmWString shr_dir = Om_concatPaths(path, L"Data\\Shared");
+
+  int32_t result = Om_dirCreateRecursive(own_dir);
+  if(result == 0)
+    result = Om_dirCreateRecursive(shr_dir);
+
+  if(result != 0) {
+    this->_error(L"generate", Om_errCreate(L"source directory", path, result));
+    return false;
+  }
+
+  // the first files of each Mod go to the shared folder, their names are
+  // shifted by Mod index so each Mod overlaps a different subset of others
+  size_t shared = (this->_cfg.files * this->_cfg.overlap) / 100;
+
+  for(size_t i = 0; i < this->_cfg.files; ++i) {
+
+    OmWString file_path;
+
+    if(i < shared) {
+      swprintf(buf, 64, L"File_%04u.dat", static_cast<unsigned>((index + i) % this->_cfg.files));
+      file_path = Om_concatPaths(shr_dir, buf);
+    } else {
+      swprintf(buf, 64, L"File_%04u.dat", static_cast<unsigned>(i));
+      file_path = Om_concatPaths(own_dir, buf);
+    }
+
+    uint64_t seed = (static_cast<uint64_t>(index + 1) * 0x9e3779b97f4a7c15ULL) ^ static_cast<uint64_t>(i);
+
+    if(!__write_file(file_path, this->_cfg.size, seed)) {
+      this->_error(L"generate", Om_errWriteAccess(L"source file", file_path));
+      return false;
+    }
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::generate(const OmWString& path, const OmModBenchCfg_t& cfg, Om_progressCb progress_cb, void* user_ptr)
+{
+  this->_cfg = cfg;
+  this->_path = path;
+
+  // we never write into existing data
+  if(Om_isDir(path)) {
+    if(!Om_isDirEmpty(path)) {
+      this->_error(L"generate", L"working folder already exists and is not empty");
+      return OM_RESULT_ABORT;
+    }
+  } else {
+    int32_t result = Om_dirCreateRecursive(path);
+    if(result != 0) {
+      this->_error(L"generate", Om_errCreate(L"working folder", path, result));
+      return OM_RESULT_ERROR_IO;
+    }
+  }
+
+  OmWString src_root = Om_concatPaths(path, __BENCH_SOURCE);
+  OmWString lib_path = Om_concatPaths(path, __BENCH_LIBRARY);
+  OmWString tgt_path = Om_concatPaths(path, __BENCH_TARGET);
+
+  Om_dirCreate(src_root);
+  Om_dirCreate(lib_path);
+  Om_dirCreate(tgt_path);
+
+  OmWStringArray pkg_paths;
+
+  for(size_t i = 0; i < cfg.mods; ++i) {
+
+    OmWString iden = __mod_iden(i);
+    OmWString src_path = Om_concatPaths(src_root, iden);
+
+    if(!this->_gen_source(i, src_path))
+      return OM_RESULT_ERROR_IO;
+
+    OmModPack ModPack;
+
+    if(!ModPack.parseSource(src_path)) {
+      this->_error(L"generate", ModPack.lastError());
+      return OM_RESULT_ERROR;
+    }
+
+    int32_t depend = __mod_depend(i, cfg.depends);
+    if(depend >= 0)
+      ModPack.addDependIden(__mod_iden(depend));
+
+    OmWString pkg_path = Om_concatPathsExt(lib_path, iden, OM_PKG_FILE_EXT);
+
+    if(ModPack.saveAs(pkg_path, cfg.method, cfg.level) != OM_RESULT_OK) {
+      this->_error(L"generate", ModPack.lastError());
+      return OM_RESULT_ERROR;
+    }
+
+    pkg_paths.push_back(pkg_path);
+
+    // source is no longer needed, keep disk usage low
+    Om_dirDeleteRecursive(src_path);
+
+    if(progress_cb)
+      if(!progress_cb(user_ptr, cfg.mods, i + 1, 0))
+        return OM_RESULT_ABORT;
+  }
+
+  Om_dirDeleteRecursive(src_root);
+
+  // repository definition sits at working folder root so the whole folder
+  // can be served as repository base
+  OmNetRepo NetRepo(nullptr);
+  NetRepo.init(L"Benchmark Repository");
+  NetRepo.setDownpath(__BENCH_LIBRARY L"/");
+
+  std::sort(pkg_paths.begin(), pkg_paths.end());
+
+  if(NetRepo.build(pkg_paths, L"") != OM_RESULT_OK) {
+    this->_error(L"generate", NetRepo.lastError());
+    return OM_RESULT_ERROR;
+  }
+
+  OmWString rep_path = Om_concatPathsExt(path, __BENCH_REPO, OM_XML_DEF_EXT);
+
+  if(NetRepo.save(rep_path) != OM_RESULT_OK) {
+    this->_error(L"generate", NetRepo.lastError());
+    return OM_RESULT_ERROR_IO;
+  }
+
+  // Mod Hub and Channel, opening Channel loads the library
+  if(this->_ModMan->createHub(path, L"Hub", true) != OM_RESULT_OK) {
+    this->_error(L"generate", this->_ModMan->lastError());
+    return OM_RESULT_ERROR;
+  }
+
+  OmModHub* ModHub = this->_ModMan->activeHub();
+
+  if(!ModHub || !ModHub->createChannel(L"Bench", tgt_path, lib_path, L"")) {
+    this->_error(L"generate", ModHub ? ModHub->lastError() : this->_ModMan->lastError());
+    return OM_RESULT_ERROR;
+  }
+
+  // passes install overlapping Mods as a user accepting overlaps does,
+  // which the default No-Overlapping mode would refuse
+  if(ModHub->activeChannel())
+    ModHub->activeChannel()->setBackupOverlap(true);
+
+  // generation timings are not part of results
+  Om_perfClear();
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_run_pass(OmModChan* ModChan)
+{
+  ModChan->reloadModLibrary();
+
+  OmPModPackArray selection;
+  for(size_t i = 0; i < ModChan->modpackCount(); ++i)
+    selection.push_back(ModChan->getModpack(i));
+
+  // install all, overlaps and dependencies are accepted as user would do
+  OmPModPackArray installs;
+  OmWStringArray overlaps, depends, missings, conflicts;
+
+  ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings, &conflicts);
+
+  for(size_t i = 0; i < installs.size(); ++i) {
+
+    OmModPack* ModPack = installs[i];
+
+    OmResult result = ModPack->makeBackup();
+    if(result == OM_RESULT_OK)
+      result = ModPack->applySource();
+
+    ModChan->refreshModLibrary();
+
+    if(result != OM_RESULT_OK) {
+      ModPack->restoreData(nullptr, nullptr, true);
+      this->_error(L"run", ModPack->lastError());
+      return result;
+    }
+  }
+
+  // network library status depends on installed Mods
+  if(ModChan->repositoryCount())
+    ModChan->refreshNetLibrary();
+
+  // restore all
+  selection.clear();
+  for(size_t i = 0; i < ModChan->modpackCount(); ++i)
+    if(ModChan->getModpack(i)->hasBackup())
+      selection.push_back(ModChan->getModpack(i));
+
+  OmPModPackArray restores;
+  OmWStringArray overlappers, dependents;
+
+  ModChan->prepareRestores(selection, &restores, &overlappers, &dependents);
+
+  for(size_t i = 0; i < restores.size(); ++i) {
+
+    OmResult result = restores[i]->restoreData();
+
+    ModChan->refreshModLibrary();
+
+    if(result != OM_RESULT_OK) {
+      this->_error(L"run", restores[i]->lastError());
+      return result;
+    }
+  }
+
+  // restore order must have brought target back to its initial state,
+  // which is empty
+  for(size_t i = 0; i < ModChan->modpackCount(); ++i) {
+    if(ModChan->getModpack(i)->hasBackup()) {
+      this->_error(L"run", L"Mod left installed after restore: " + ModChan->getModpack(i)->iden());
+      return OM_RESULT_ERROR;
+    }
+  }
+
+  if(!Om_isDirEmpty(ModChan->targetPath())) {
+    this->_error(L"run", L"target folder not empty after restore");
+    return OM_RESULT_ERROR;
+  }
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModBench::_query_result_fn(void* ptr, OmResult result, uint64_t param)
+{
+  OM_UNUSED(param);
+
+  OmModBench* self = static_cast<OmModBench*>(ptr);
+
+  self->_query_result = result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModBench::_query_notify_fn(void* ptr, OmNotify notify, uint64_t param)
+{
+  OM_UNUSED(param);
+
+  OmModBench* self = static_cast<OmModBench*>(ptr);
+
+  // network library is unlocked once query thread ended
+  if(notify == OM_NOTIFY_ENDED)
+    Om_pltEventSet(self->_query_hev);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_query_repository(OmModChan* ModChan, const OmWString& repo_url)
+{
+  if(!ModChan->addRepository(repo_url, __BENCH_REPO)) {
+    this->_error(L"run", ModChan->lastError());
+    return OM_RESULT_ERROR;
+  }
+
+  if(!this->_query_hev)
+    this->_query_hev = Om_pltEventCreate(false);
+
+  this->_query_result = OM_RESULT_UNKNOW;
+
+  OmPNetRepoArray selection;
+  selection.push_back(ModChan->getRepository(ModChan->repositoryCount() - 1));
+
+  ModChan->queueQueries(selection, nullptr, OmModBench::_query_result_fn, OmModBench::_query_notify_fn, this);
+
+  // query runs in its own thread, connection has its own timeouts
+  Om_pltEventWait(this->_query_hev);
+
+  if(this->_query_result != OM_RESULT_OK) {
+    this->_error(L"run", L"repository query failed: " + selection[0]->queryLastError());
+    return OM_RESULT_ERROR;
+  }
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_step_utf()
+{
+  // multilingual corpus mixes two, three and four bytes sequences, pieces
+  // are given with their expected wide form
+  static const char* utf8_piece[] = {"Mod ", "caf\xC3\xA9 ", "\xD0\x9C\xD0\xBE\xD0\xB4 ",
+                                     "\xE6\xA8\xA1\xE7\xB5\x84 ", "\xF0\x9F\x98\x80\n"};
+  static const wchar_t* wide_piece[] = {L"Mod ", L"caf\u00E9 ", L"\u041C\u043E\u0434 ",
+                                        L"\u6A21\u7D44 ", L"\U0001F600\n"};
+
+  // ill-formed sequences (overlong, surrogate, truncated, stray continuation)
+  // with their expected replacement
+  static const char* bad_utf8[] = {"a\xC0\xAFz", "a\xED\xA0\x80z", "a\xE6\xA8", "\x80\xBF"};
+  static const wchar_t* bad_wide[] = {L"a\uFFFD\uFFFDz", L"a\uFFFD\uFFFD\uFFFDz", L"a\uFFFD", L"\uFFFD\uFFFD"};
+
+  OmCString corpus[2];
+  OmWString expect[2];
+  static const wchar_t* corpus_name[] = {L"ascii", L"multilingual"};
+
+  corpus[0].resize(__BENCH_UTF_SIZE);
+  uint64_t x = 1;
+  __gen_text(&corpus[0][0], __BENCH_UTF_SIZE, &x);
+  expect[0].assign(corpus[0].begin(), corpus[0].end());
+
+  for(size_t i = 0; corpus[1].size() < __BENCH_UTF_SIZE; i = (i + 1) % 5) {
+    corpus[1] += utf8_piece[i];
+    expect[1] += wide_piece[i];
+  }
+
+  for(size_t i = 0; i < 4; ++i) {
+    if(Om_toUTF16(bad_utf8[i]) != bad_wide[i]) {
+      this->_error(L"run", L"UTF-8 decoder does not replace ill-formed sequences as expected");
+      return OM_RESULT_ERROR;
+    }
+  }
+
+  OmWString wide;
+  OmCString utf8;
+
+  for(unsigned p = 0; p < this->_cfg.passes; ++p) {
+
+    for(size_t c = 0; c < 2; ++c) {
+
+      OmPerfScope dec_perf(L"utf8 decode", corpus_name[c]);
+      dec_perf.addBytes(corpus[c].size());
+      Om_toUTF16(&wide, corpus[c]);
+      dec_perf.end();
+
+      OmPerfScope enc_perf(L"utf8 encode", corpus_name[c]);
+      enc_perf.addBytes(corpus[c].size());
+      Om_toUTF8(&utf8, wide);
+      enc_perf.end();
+
+      if(wide != expect[c] || utf8 != corpus[c]) {
+        this->_error(L"run", OmWString(L"UTF-8 transcoder result differs from reference on ") + corpus_name[c] + L" corpus");
+        return OM_RESULT_ERROR;
+      }
+    }
+  }
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_step_tree()
+{
+  static const wchar_t* shape_name[] = {L"deep", L"wide"};
+  static const unsigned shape_fanout[] = {1, __BENCH_TREE_FANOUT};
+  static const unsigned shape_depth[] = {__BENCH_TREE_DEEP, __BENCH_TREE_LEVELS};
+
+  OmWString tree_root = Om_concatPaths(this->_path, __BENCH_TREE);
+
+  OmResult result = OM_RESULT_OK;
+
+  for(size_t t = 0; t < 2 && result == OM_RESULT_OK; ++t) {
+
+    OmWString origin = Om_concatPaths(tree_root, shape_name[t]);
+
+    size_t items = 0;
+
+    if(!__gen_tree(origin, shape_fanout[t], shape_depth[t], &items)) {
+      this->_error(L"run", Om_errWriteAccess(L"tree folder", origin));
+      result = OM_RESULT_ERROR_IO;
+      break;
+    }
+
+    OmTreeItemArray serial, parallel;
+
+    for(unsigned p = 0; p < this->_cfg.passes; ++p) {
+
+      serial.clear();
+      parallel.clear();
+
+      OmPerfScope ser_perf(L"tree walk serial", shape_name[t]);
+      Om_lsTree(&serial, origin, false, 1);
+      ser_perf.addFiles(serial.size());
+      ser_perf.end();
+
+      OmPerfScope par_perf(L"tree walk parallel", shape_name[t]);
+      Om_lsTree(&parallel, origin, false, 0);
+      par_perf.addFiles(parallel.size());
+      par_perf.end();
+
+      // parallel walk must give the same items in the same order
+      bool match = (serial.size() == items && parallel.size() == items);
+
+      for(size_t i = 0; i < items && match; ++i)
+        match = (serial[i].path == parallel[i].path && serial[i].isdir == parallel[i].isdir);
+
+      if(!match) {
+        this->_error(L"run", OmWString(L"tree walker results differ on ") + shape_name[t] + L" tree");
+        result = OM_RESULT_ERROR;
+        break;
+      }
+    }
+  }
+
+  Om_dirDeleteRecursive(tree_root);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_step_image()
+{
+  // bilinear resample above and below the parallel threshold, then square
+  // thumbnails of source center taking box and bicubic filters
+  static const wchar_t* case_name[] = {L"bilinear", L"bilinear small", L"box thumb", L"cubic thumb"};
+  static const unsigned case_src_w[] = {1024, 160, 1024, 300};
+  static const unsigned case_src_h[] = {768, 120, 768, 200};
+  static const unsigned case_dst_w[] = {1280, 200, 256, 512};
+  static const unsigned case_dst_h[] = {960, 150, 256, 512};
+  static const int case_filter[] = {__BENCH_IMG_LIN, __BENCH_IMG_LIN, __BENCH_IMG_BOX, __BENCH_IMG_CUB};
+
+  std::vector<uint8_t> src, ref, first, out;
+
+  for(size_t c = 0; c < 4; ++c) {
+
+    unsigned src_w = case_src_w[c], src_h = case_src_h[c];
+    unsigned dst_w = case_dst_w[c], dst_h = case_dst_h[c];
+
+    size_t dst_bytes = dst_w * dst_h * 4;
+
+    __gen_image(&src, src_w, src_h, c + 1);
+
+    // thumbnails sample the centered square of source
+    unsigned rec_x = 0, rec_y = 0, rec_w = src_w, rec_h = src_h;
+
+    if(case_filter[c] != __BENCH_IMG_LIN) {
+      rec_w = rec_h = (src_w < src_h) ? src_w : src_h;
+      rec_x = (src_w - rec_w) / 2;
+      rec_y = (src_h - rec_h) / 2;
+    }
+
+    ref.resize(dst_bytes);
+    __ref_resample(ref.data(), dst_w, dst_h, src.data(), src_w, src_h, rec_x, rec_y, rec_w, rec_h, case_filter[c]);
+
+    out.resize(dst_bytes);
+
+    for(unsigned p = 0; p < this->_cfg.passes; ++p) {
+
+      OmPerfScope perf(L"image resample", case_name[c]);
+      perf.addBytes(dst_bytes);
+
+      bool done = true;
+
+      if(case_filter[c] == __BENCH_IMG_LIN) {
+        Om_imgResample(out.data(), dst_w, dst_h, src.data(), src_w, src_h);
+      } else {
+        uint8_t* thumb = Om_imgMakeThumb(dst_w, OM_SIZE_FILL, src.data(), src_w, src_h);
+        if(thumb) {
+          memcpy(out.data(), thumb, dst_bytes);
+          Om_free(thumb);
+        } else {
+          done = false;
+        }
+      }
+
+      perf.end();
+
+      if(!done) {
+        this->_error(L"run", L"image thumbnail creation failed");
+        return OM_RESULT_ERROR_ALLOC;
+      }
+
+      // first pass is checked against reference, the others must give
+      // exactly the same pixels
+      bool match = true;
+
+      if(p == 0) {
+
+        for(size_t i = 0; i < dst_bytes && match; ++i)
+          match = (std::abs(out[i] - ref[i]) <= __BENCH_IMG_TOLERANCE);
+
+        first = out;
+
+      } else {
+        match = (out == first);
+      }
+
+      if(!match) {
+        this->_error(L"run", OmWString(L"image resampler result differs from reference on ") + case_name[c] + L" case");
+        return OM_RESULT_ERROR;
+      }
+    }
+  }
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_step_quantize()
+{
+  // large image is split across worker threads, small one is not
+  static const wchar_t* case_name[] = {L"large", L"small"};
+  static const unsigned case_w[] = {1024, 128};
+  static const unsigned case_h[] = {768, 96};
+
+  std::vector<uint8_t> src;
+
+  for(size_t c = 0; c < 2; ++c) {
+
+    unsigned w = case_w[c], h = case_h[c];
+
+    __gen_image(&src, w, h, c + 1);
+
+    uint8_t* first = nullptr;
+    uint64_t first_size = 0;
+
+    OmResult result = OM_RESULT_OK;
+
+    for(unsigned p = 0; p < this->_cfg.passes && result == OM_RESULT_OK; ++p) {
+
+      OmPerfScope perf(L"gif encode", case_name[c]);
+      perf.addBytes(src.size());
+
+      uint64_t gif_size = 0;
+      uint8_t* gif_data = Om_imgEncodeGif(&gif_size, src.data(), w, h, 4);
+
+      perf.end();
+
+      if(!gif_data) {
+        this->_error(L"run", L"GIF encoding failed");
+        result = OM_RESULT_ERROR;
+        break;
+      }
+
+      if(p == 0) {
+
+        // decode first pass image and check quantization error
+        unsigned dec_w, dec_h;
+        uint8_t* dec = Om_imgLoadData(&dec_w, &dec_h, gif_data, gif_size);
+
+        double sse = 0.0;
+
+        if(dec && dec_w == w && dec_h == h) {
+          for(size_t i = 0; i < src.size(); i += 4) {
+            for(size_t k = 0; k < 3; ++k) {
+              double d = static_cast<double>(src[i + k]) - dec[i + k];
+              sse += d * d;
+            }
+          }
+        }
+
+        double psnr = 0.0;
+
+        if(dec && dec_w == w && dec_h == h)
+          psnr = (sse > 0.0) ? 10.0 * std::log10((255.0 * 255.0 * 3 * w * h) / sse) : 99.0;
+
+        if(dec) Om_free(dec);
+
+        if(psnr < __BENCH_QZ_MIN_PSNR) {
+          wchar_t buf[128];
+          swprintf(buf, 128, L"GIF quantization PSNR %.1f dB is below %.1f dB on %ls image", psnr, __BENCH_QZ_MIN_PSNR, case_name[c]);
+          this->_error(L"run", buf);
+          result = OM_RESULT_ERROR;
+        }
+
+        first = gif_data;
+        first_size = gif_size;
+
+      } else {
+
+        // other passes must encode exactly the same data
+        if(gif_size != first_size || memcmp(gif_data, first, gif_size) != 0) {
+          this->_error(L"run", OmWString(L"GIF encoding result differs between passes on ") + case_name[c] + L" image");
+          result = OM_RESULT_ERROR;
+        }
+
+        Om_free(gif_data);
+      }
+    }
+
+    if(first) Om_free(first);
+
+    if(result != OM_RESULT_OK)
+      return result;
+  }
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_step_hash()
+{
+  static const wchar_t* algo_name[] = {L"xxh3", L"md5"};
+  static const unsigned algo_value[] = {OM_HASH_XXH3, OM_HASH_MD5};
+
+  // RFC 1321 test suite
+  static const char* md5_text[] = {"", "a", "abc", "message digest", "abcdefghijklmnopqrstuvwxyz",
+                                   "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+                                   "12345678901234567890123456789012345678901234567890123456789012345678901234567890"};
+  static const wchar_t* md5_text_sum[] = {L"d41d8cd98f00b204e9800998ecf8427e", L"0cc175b9c0f1b6a831c399e269772661",
+                                          L"900150983cd24fb0d6963f7d28e17f72", L"f96b697d7cb7938d525a2f31aaf161d0",
+                                          L"c3fcd3d76192e4007dfb496cca67e13b", L"d174ab98d277d9f5a5611c2c9f419d9f",
+                                          L"57edf4a22be3c955ac49da2e2107b67a"};
+
+  // sizes around MD5 block and padding limits and around read buffer size
+  static const uint64_t md5_size[] = {1, 55, 56, 63, 64, 65, 119, 120, 127, 128,
+                                      524287, 524288, 524289, 1048576, 1048579};
+
+  OmWString vect_root = Om_concatPaths(this->_path, __BENCH_HASH);
+
+  if(Om_dirCreateRecursive(vect_root) != 0) {
+    this->_error(L"run", Om_errWriteAccess(L"hash vectors folder", vect_root));
+    return OM_RESULT_ERROR_IO;
+  }
+
+  OmWStringArray vect_paths, vect_sums;
+
+  bool written = true;
+  wchar_t name[32];
+
+  for(size_t i = 0; i < 7 && written; ++i) {
+
+    swprintf(name, 32, L"Text_%02u.dat", static_cast<unsigned>(i));
+    vect_paths.push_back(Om_concatPaths(vect_root, name));
+    vect_sums.push_back(md5_text_sum[i]);
+
+    void* hfile = Om_pltFileOpen(vect_paths.back(), OM_PLT_FILE_WRITE|OM_PLT_FILE_CREATE);
+    if(!hfile) {
+      written = false;
+      break;
+    }
+
+    size_t len = strlen(md5_text[i]);
+    written = (Om_pltFileWrite(hfile, md5_text[i], len) == static_cast<int64_t>(len));
+
+    Om_pltFileClose(hfile);
+  }
+
+  for(size_t i = 0; i < 15 && written; ++i) {
+
+    swprintf(name, 32, L"Size_%02u.dat", static_cast<unsigned>(i));
+    vect_paths.push_back(Om_concatPaths(vect_root, name));
+
+    written = __write_file(vect_paths.back(), md5_size[i], i + 1);
+
+    // single stream MD5 is the reference
+    if(written)
+      vect_sums.push_back(Om_getMD5sum(vect_paths.back()));
+  }
+
+  if(!written) {
+    this->_error(L"run", Om_errWriteAccess(L"hash vector file", vect_paths.back()));
+    Om_dirDeleteRecursive(vect_root);
+    return OM_RESULT_ERROR_IO;
+  }
+
+  // vectors are hashed by batch, with several files at once in multi-buffer
+  // MD5 lanes, single stream MD5 must give the RFC results as well
+  OmIndexArray failed;
+  Om_cmpFileSums(&failed, vect_paths, vect_sums, OM_HASH_MD5);
+
+  for(size_t i = 0; i < 7 && failed.empty(); ++i)
+    if(Om_getMD5sum(vect_paths[i]) != vect_sums[i])
+      failed.push_back(i);
+
+  Om_dirDeleteRecursive(vect_root);
+
+  if(!failed.empty()) {
+    this->_error(L"run", L"MD5 result differs from reference on vector " + Om_getFilePart(vect_paths[failed[0]]));
+    return OM_RESULT_ERROR;
+  }
+
+  // generated packages are the hashed files
+  OmWStringArray paths;
+  Om_lsFile(&paths, Om_concatPaths(this->_path, __BENCH_LIBRARY), true);
+
+  if(paths.empty()) {
+    this->_error(L"run", L"no package in library to hash");
+    return OM_RESULT_ERROR;
+  }
+
+  uint64_t bytes = 0;
+  for(size_t i = 0; i < paths.size(); ++i)
+    bytes += Om_itemSize(paths[i]);
+
+  char buf[__BENCH_BUFFER];
+
+  OmWStringArray sums, refs(paths.size());
+
+  for(unsigned p = 0; p < this->_cfg.passes; ++p) {
+
+    // plain sequential read, hashing throughput is bound by it
+    OmPerfScope read_perf(L"hash raw read");
+    read_perf.addFiles(paths.size());
+    read_perf.addBytes(bytes);
+
+    for(size_t i = 0; i < paths.size(); ++i) {
+
+      void* hfile = Om_pltFileOpen(paths[i], OM_PLT_FILE_READ);
+      if(!hfile) {
+        this->_error(L"run", Om_errReadAccess(L"package file", paths[i]));
+        return OM_RESULT_ERROR_IO;
+      }
+
+      while(Om_pltFileRead(hfile, buf, __BENCH_BUFFER) > 0);
+
+      Om_pltFileClose(hfile);
+    }
+
+    read_perf.end();
+
+    for(size_t a = 0; a < 2; ++a) {
+
+      OmPerfScope batch_perf(L"hash batch", algo_name[a]);
+      batch_perf.addFiles(paths.size());
+      batch_perf.addBytes(bytes);
+      size_t done = Om_getFileSums(&sums, paths, algo_value[a]);
+      batch_perf.end();
+
+      // one file at a time with the single stream hash as reference
+      OmPerfScope single_perf(L"hash single", algo_name[a]);
+      single_perf.addFiles(paths.size());
+      single_perf.addBytes(bytes);
+      for(size_t i = 0; i < paths.size(); ++i)
+        refs[i] = (algo_value[a] == OM_HASH_MD5) ? Om_getMD5sum(paths[i]) : Om_getXXHsum(paths[i]);
+      single_perf.end();
+
+      if(done != paths.size() || sums != refs) {
+        this->_error(L"run", OmWString(L"batch ") + algo_name[a] + L" checksums differ from single file checksums");
+        return OM_RESULT_ERROR;
+      }
+    }
+  }
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_step_index()
+{
+  OmWString rep_path = Om_concatPathsExt(this->_path, __BENCH_REPO, OM_XML_DEF_EXT);
+  OmWString idx_path = Om_concatPathsExt(this->_path, __BENCH_REPO, OM_REP_IDX_FILE_EXT);
+
+  OmNetRepo NetRepo(nullptr);
+  OmNetIndex NetIndex;
+
+  OmNetRefArray xml_refs, idx_refs;
+
+  for(unsigned p = 0; p < this->_cfg.passes; ++p) {
+
+    // XML definition parse, as the editor and non-streaming query do
+    OmPerfScope xml_perf(L"index xml load");
+    xml_perf.addBytes(Om_itemSize(rep_path));
+
+    if(NetRepo.load(rep_path) != OM_RESULT_OK) {
+      this->_error(L"run", NetRepo.lastError());
+      return OM_RESULT_ERROR_PARSE;
+    }
+
+    xml_refs.resize(NetRepo.referenceCount());
+    for(size_t i = 0; i < xml_refs.size(); ++i)
+      NetRepo.getReference(i, &xml_refs[i]);
+
+    xml_perf.addFiles(xml_refs.size());
+    xml_perf.end();
+
+    // binary index mapping, as the streaming query does with received data
+    OmPerfScope idx_perf(L"index binary load");
+    idx_perf.addBytes(Om_itemSize(idx_path));
+
+    if(!NetIndex.open(idx_path)) {
+      this->_error(L"run", Om_errOpen(L"repository index", idx_path, L"invalid index"));
+      return OM_RESULT_ERROR_PARSE;
+    }
+
+    idx_refs.resize(NetIndex.referenceCount());
+    for(size_t i = 0; i < idx_refs.size(); ++i) {
+      if(!NetIndex.getReference(i, &idx_refs[i])) {
+        this->_error(L"run", Om_errOpen(L"repository index", idx_path, L"corrupted reference"));
+        return OM_RESULT_ERROR_PARSE;
+      }
+    }
+
+    idx_perf.addFiles(idx_refs.size());
+    idx_perf.end();
+
+    // identity lookup, linear in XML nodes and binary search in index
+    OmIndexArray found(xml_refs.size());
+    size_t xml_miss = 0;
+
+    OmPerfScope xml_find_perf(L"index xml search");
+    xml_find_perf.addFiles(xml_refs.size());
+    for(size_t i = 0; i < xml_refs.size(); ++i)
+      if(NetRepo.indexOfReference(xml_refs[i].ident) != static_cast<int32_t>(i))
+        ++xml_miss;
+    xml_find_perf.end();
+
+    OmPerfScope idx_find_perf(L"index binary search");
+    idx_find_perf.addFiles(xml_refs.size());
+    for(size_t i = 0; i < xml_refs.size(); ++i)
+      found[i] = NetIndex.indexOfReference(xml_refs[i].ident);
+    idx_find_perf.end();
+
+    // index must hold the same references as the definition it is declared in
+    if(!NetRepo.hasIndex() || idx_refs.size() != xml_refs.size() || xml_miss) {
+      this->_error(L"run", L"repository index does not match definition");
+      return OM_RESULT_ERROR;
+    }
+
+    for(size_t i = 0; i < xml_refs.size(); ++i) {
+      if(found[i] >= idx_refs.size() || !__same_ref(xml_refs[i], idx_refs[found[i]])) {
+        this->_error(L"run", L"repository index reference differs from definition: " + xml_refs[i].ident);
+        return OM_RESULT_ERROR;
+      }
+    }
+
+    NetIndex.close();
+  }
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_step_log()
+{
+  if(!this->_ModMan) {
+    this->_error(L"run", L"no Mod Manager to log to");
+    return OM_RESULT_ERROR;
+  }
+
+  uint64_t lines = __BENCH_LOG_THREADS * __BENCH_LOG_LINES;
+
+  for(unsigned p = 0; p < this->_cfg.passes; ++p) {
+
+    uint64_t dropped = this->_ModMan->droppedLog();
+
+    // producers never wait for the writer, span gives lines per second
+    // offered to the log, dropped lines are recorded apart
+    OmPerfScope perf(L"log write");
+    perf.addFiles(lines);
+
+    uint64_t start = Om_perfTime();
+
+    Om_parallelFor(__BENCH_LOG_THREADS, __log_job_fn, this->_ModMan, __BENCH_LOG_THREADS);
+
+    perf.end();
+
+    dropped = this->_ModMan->droppedLog() - dropped;
+
+    Om_perfRecord(L"log dropped", L"", start, dropped, 0);
+
+    wchar_t buf[128];
+    uint64_t elapsed = Om_perfTime() - start;
+    swprintf(buf, 128, L"%llu lines in %llu us, %llu lines/s, %llu dropped",
+             static_cast<unsigned long long>(lines), static_cast<unsigned long long>(elapsed),
+             static_cast<unsigned long long>(elapsed ? (lines * 1000000) / elapsed : 0),
+             static_cast<unsigned long long>(dropped));
+
+    this->_ModMan->escalateLog(OM_LOG_OK, L"ModBench.log", buf);
+  }
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::_step_xml()
+{
+  // compose backup-like definition, expected sums are computed along
+  OmXmlConf src_cfg;
+  src_cfg.init(OM_XMAGIC_BCK);
+
+  uint64_t cpy_count = 0, cpy_sum = 0;
+  wchar_t path[64];
+
+  for(unsigned i = 0; i < __BENCH_XML_ENTRIES; ++i) {
+
+    swprintf(path, 64, L"Folder_%02u\\File_%06u.dat", i % 37, i);
+
+    if(i % 5 == 4) {
+      OmXmlNode del_node = src_cfg.addChild(L"del");
+      del_node.setAttr(L"dir", 0);
+      del_node.setContent(path);
+    } else {
+      OmXmlNode cpy_node = src_cfg.addChild(L"cpy");
+      cpy_node.setAttr(L"cdi", static_cast<int>(i));
+      cpy_node.setContent(path);
+      cpy_count++;
+      cpy_sum += i + wcslen(path);
+    }
+  }
+
+  OmWString xml_data = Om_toUTF16(src_cfg.data());
+
+  OmXmlConf xml_cfg;
+  OmXmlNodeArray xml_list;
+
+  for(unsigned p = 0; p < this->_cfg.passes; ++p) {
+
+    OmPerfScope parse_perf(L"xml parse");
+    parse_perf.addBytes(xml_data.size() * sizeof(wchar_t));
+    if(!xml_cfg.parse(xml_data, OM_XMAGIC_BCK)) {
+      this->_error(L"run", L"XML parser failed on generated definition: " + xml_cfg.lastErrorStr());
+      return OM_RESULT_ERROR;
+    }
+    parse_perf.end();
+
+    // range-based iteration, nothing is allocated
+    uint64_t range_count = 0, range_sum = 0;
+
+    OmPerfScope range_perf(L"xml children range");
+    range_perf.addFiles(cpy_count);
+    for(const OmXmlNode& xml_node : xml_cfg.children(L"cpy")) {
+      range_count++;
+      range_sum += xml_node.attrAsInt(L"cdi") + wcslen(xml_node.content());
+    }
+    range_perf.end();
+
+    // node list, as filled by children list getter
+    uint64_t list_count = 0, list_sum = 0;
+
+    OmPerfScope list_perf(L"xml children list");
+    list_perf.addFiles(cpy_count);
+    xml_cfg.children(xml_list, L"cpy");
+    for(size_t i = 0; i < xml_list.size(); ++i) {
+      list_count++;
+      list_sum += xml_list[i].attrAsInt(L"cdi") + wcslen(xml_list[i].content());
+    }
+    list_perf.end();
+
+    if(range_count != cpy_count || range_sum != cpy_sum || list_count != cpy_count || list_sum != cpy_sum) {
+      this->_error(L"run", L"XML children iteration result differs from generated definition");
+      return OM_RESULT_ERROR;
+    }
+  }
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModBench::run(const OmWString& repo_url, Om_progressCb progress_cb, void* user_ptr)
+{
+  OmModChan* ModChan = this->_ModMan->activeChannel();
+
+  if(!ModChan) {
+    this->_error(L"run", L"no library was generated");
+    return OM_RESULT_ERROR;
+  }
+
+  Om_perfEnable(true);
+
+  // root span holds configuration so results are self-describing
+  OmPerfScope perf(L"bench", OmModBench::configString(this->_cfg));
+  perf.addFiles(this->_cfg.mods * this->_cfg.files);
+  perf.addBytes(this->_cfg.mods * this->_cfg.files * this->_cfg.size);
+
+  OmResult result = OM_RESULT_OK;
+
+  if(OM_HAS_BIT(this->_cfg.steps, OM_BENCH_STEP_MODS)) {
+
+    if(!repo_url.empty())
+      result = this->_query_repository(ModChan, repo_url);
+
+    for(unsigned p = 0; p < this->_cfg.passes && result == OM_RESULT_OK; ++p) {
+
+      OmPerfScope pass_perf(L"bench pass");
+
+      result = this->_run_pass(ModChan);
+
+      if(progress_cb)
+        if(!progress_cb(user_ptr, this->_cfg.passes, p + 1, 0))
+          result = OM_RESULT_ABORT;
+    }
+  }
+
+  if(result == OM_RESULT_OK && OM_HAS_BIT(this->_cfg.steps, OM_BENCH_STEP_UTF))
+    result = this->_step_utf();
+
+  if(result == OM_RESULT_OK && OM_HAS_BIT(this->_cfg.steps, OM_BENCH_STEP_TREE))
+    result = this->_step_tree();
+
+  if(result == OM_RESULT_OK && OM_HAS_BIT(this->_cfg.steps, OM_BENCH_STEP_IMAGE))
+    result = this->_step_image();
+
+  if(result == OM_RESULT_OK && OM_HAS_BIT(this->_cfg.steps, OM_BENCH_STEP_QUANTIZE))
+    result = this->_step_quantize();
+
+  if(result == OM_RESULT_OK && OM_HAS_BIT(this->_cfg.steps, OM_BENCH_STEP_HASH))
+    result = this->_step_hash();
+
+  if(result == OM_RESULT_OK && OM_HAS_BIT(this->_cfg.steps, OM_BENCH_STEP_INDEX))
+    result = this->_step_index();
+
+  if(result == OM_RESULT_OK && OM_HAS_BIT(this->_cfg.steps, OM_BENCH_STEP_LOG))
+    result = this->_step_log();
+
+  if(result == OM_RESULT_OK && OM_HAS_BIT(this->_cfg.steps, OM_BENCH_STEP_XML))
+    result = this->_step_xml();
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModBench::saveResults(const OmWString& path)
+{
+  if(!Om_perfSaveJson(path)) {
+    this->_error(L"saveResults", Om_errWriteAccess(L"results file", path));
+    return false;
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModBench::_error(const OmWString& origin, const OmWString& detail)
+{
+  this->_lasterr = detail;
+
+  if(this->_ModMan)
+    this->_ModMan->escalateLog(OM_LOG_ERR, L"ModBench." + origin, detail);
+}
@@ -15,6 +15,7 @@
   along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
 */
 #include <algorithm>            //< std::find
+#include <set>
 
 #include "OmBaseApp.h"
 
@@ -23,11 +24,13 @@
 #include "OmUtilErr.h"
 #include "OmUtilStr.h"
 #include "OmUtilAlg.h"
+#include "OmUtilThd.h"
+#include "OmUtilPrf.h"
 #include "OmUtilPkg.h"
+#include "OmUtilPlt.h"
 
 #include "OmArchive.h"          //< Archive compression methods / level
 
-#include "OmModMan.h"
 #include "OmModHub.h"
 #include "OmNetRepo.h"
 
@@ -43,6 +46,7 @@
 OmModChan::OmModChan(OmModHub* ModHub) :
   _Modhub(ModHub),
   _index(0),
+  _activated(false),
   _cust_library_path(false),
   _cust_backup_path(false),
   _modpack_list_sort(OM_SORT_NAME),
@@ -68,6 +72,8 @@ OmModChan::OmModChan(OmModHub* ModHub) :
   _download_percent(0),
   _download_start_hth(nullptr),
   _download_start_hwo(nullptr),
+  _download_finalizing(false),
+  _download_final_lk(Om_pltLockCreate()),
   _download_begin_cb(nullptr),
   _download_download_cb(nullptr),
   _download_result_cb(nullptr),
@@ -100,6 +106,7 @@ OmModChan::OmModChan(OmModHub* ModHub) :
   _backup_method(OM_METHOD_ZSTD),
   _backup_level(OM_LEVEL_FAST),
   _backup_overlap(false),
+  _backup_parallel(true),
   _warn_extra_unin(true),
   _warn_extra_dnld(true),
   _warn_miss_deps(true),
@@ -111,7 +118,7 @@ OmModChan::OmModChan(OmModHub* ModHub) :
   _layout_repositories_span(70)
 {
   // set parameters for library monitor
-  this->_monitor.setCallback(OmModChan::_monitor_notify_fn, this);
+  this->_monitor.setBatchCallback(OmModChan::_monitor_batch_fn, this);
 }
 
 ///
@@ -120,6 +127,8 @@ OmModChan::OmModChan(OmModHub* ModHub) :
 OmModChan::~OmModChan()
 {
   this->close();
+
+  Om_pltLockClose(this->_download_final_lk);
 }
 
 ///
@@ -130,31 +139,33 @@ void OmModChan::close()
   // stop library monitoring
   this->_monitor.stopMonitor();
 
+  this->_activated = false;
+
   // stop and clear ModOps thread
   if(this->_modops_hth) {
     this->_modops_abort = true;
-    WaitForSingleObject(this->_modops_hth, 1000);
+    Om_pltThreadWait(this->_modops_hth, 1000);
   }
 
-  Om_threadClear(this->_modops_hth, this->_modops_hwo);
+  Om_pltThreadClear(this->_modops_hth, this->_modops_hwo);
   this->_modops_hth = nullptr;
   this->_modops_hwo = nullptr;
 
   // stop and clear Supersed thread
   if(this->_supersed_hth) {
     this->_supersed_abort = true;
-    WaitForSingleObject(this->_supersed_hth, 1000);
+    Om_pltThreadWait(this->_supersed_hth, 1000);
   }
-  Om_threadClear(this->_supersed_hth, this->_supersed_hwo);
+  Om_pltThreadClear(this->_supersed_hth, this->_supersed_hwo);
   this->_supersed_hth = nullptr;
   this->_supersed_hwo = nullptr;
 
   // stop and clear Queries thread
   if(this->_query_hth) {
     this->_query_abort = true;
-    WaitForSingleObject(this->_query_hth, 1000);
+    Om_pltThreadWait(this->_query_hth, 1000);
   }
-  Om_threadClear(this->_query_hth, this->_query_hwo);
+  Om_pltThreadClear(this->_query_hth, this->_query_hwo);
   this->_query_hth = nullptr;
   this->_query_hwo = nullptr;
 
@@ -163,7 +174,7 @@ void OmModChan::close()
     // FIXME : Je ne sais pas si ce truc fonctionne
     this->stopDownloads();
     while(this->_download_queue.size())
-      Sleep(50);
+      Om_pltSleep(50);
   }
 
   this->_lasterr.clear();
@@ -214,6 +225,7 @@ void OmModChan::close()
   this->_download_start_hwo = nullptr;
   this->_download_queue.clear();
   this->_download_array.clear();
+  this->_download_final.clear();
   this->_download_begin_cb = nullptr;
   this->_download_download_cb = nullptr;
   this->_download_result_cb = nullptr;
@@ -248,6 +260,7 @@ void OmModChan::close()
   this->_cust_backup_path = false;
   this->_backup_method = OM_METHOD_ZSTD;
   this->_backup_level = OM_LEVEL_FAST;
+  this->_backup_parallel = true;
   this->_warn_extra_unin = true;
   this->_warn_extra_dnld = true;
   this->_warn_miss_deps = true;
@@ -262,7 +275,7 @@ void OmModChan::close()
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmModChan::open(const OmWString& path)
+bool OmModChan::open(const OmWString& path, bool defer)
 {
   this->close();
 
@@ -278,6 +291,9 @@ bool OmModChan::open(const OmWString& path)
     this->close(); return false;
   }
 
+  // settings changes are coalesced and written in background
+  this->_xml.setWriteBehind(OM_XMLCONF_DELAY);
+
   this->_path = path;
 
   this->_home = Om_getDirPart(this->_path);
@@ -407,6 +423,13 @@ bool OmModChan::open(const OmWString& path)
     this->setBackupOverlap(this->_backup_overlap); //< create default
   }
 
+  if(this->_xml.hasChild(L"backup_parallel")) {
+    this->_backup_parallel = this->_xml.child(L"backup_parallel").attrAsInt(L"enable");
+  } else {
+    // create default values
+    this->setBackupParallel(this->_backup_parallel); //< create default
+  }
+
   if(this->_xml.hasChild(L"library_sort")) {
     this->_modpack_list_sort = this->_xml.child(L"library_sort").attrAsInt(L"sort");
   } else {
@@ -583,7 +606,29 @@ bool OmModChan::open(const OmWString& path)
     this->setModsSourcesPath(L"");
   }
 
-  this->_log(OM_LOG_OK, L"open", L"OK");
+  if(defer) {
+
+    this->_log(OM_LOG_OK, L"open", L"Defered loading");
+
+  } else {
+
+    this->activate();
+
+    this->_log(OM_LOG_OK, L"open", L"OK");
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModChan::activate()
+{
+  if(this->_activated || !this->_xml.valid())
+    return false;
+
+  this->_activated = true;
 
   // Load library
   this->reloadModLibrary();
@@ -610,6 +655,7 @@ OmResult OmModChan::rename(const OmWString& title)
 
   // store old parameter since we close the instance
   OmWString old_home = this->_home;
+  bool was_activated = this->_activated;
 
   // Close Mod Channel to safe rename and reload it after
   this->close();
@@ -633,7 +679,7 @@ OmResult OmModChan::rename(const OmWString& title)
   Om_concatPaths(new_path, new_home, OM_MODCHN_FILENAME);
 
   // Reload location
-  this->open(new_path);
+  this->open(new_path, !was_activated);
 
   if(!has_error) {
     this->_log(OM_LOG_OK, L"renameHome", L"successfully renamed to \""+new_home+L"\"");
@@ -798,131 +844,225 @@ void OmModChan::notifyNetLibraryStop()
   this->_netpack_notify_ptr = nullptr;
 }
 
+/// \brief Maximum sorted insertions
+///
+/// Maximum count of new Mod Packs inserted one by one at their sorted
+/// position in Library, beyond this the whole Library is sorted again.
+///
+#define OM_MONITOR_INSERT_MAX   8
+
+/// \brief Monitor parse job
+///
+/// Structure describing a Mod Pack source parse to be done by a worker
+/// while processing library changes.
+///
+typedef struct {
+
+  OmWString         path;
+
+  OmModPack*        ModPack;
+
+  bool              is_new;
+
+  bool              refresh;
+
+  bool              result;
+
+} __monitor_job_t;
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModChan::_monitor_job_fn(void* ptr, size_t index, unsigned worker)
+{
+  OM_UNUSED(worker);
+
+  __monitor_job_t* job = static_cast<std::vector<__monitor_job_t>*>(ptr)->data() + index;
+
+  if(job->refresh) {
+    job->ModPack->refreshSource();
+    job->result = true;
+  } else {
+    job->result = job->ModPack->parseSource(job->path);
+  }
+
+  return true;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::_monitor_notify_fn(void* ptr, OmNotify notify, uint64_t param)
+void OmModChan::_monitor_batch_fn(void* ptr, const OmWStringArray& created, const OmWStringArray& altered, const OmWStringArray& deleted)
 {
   OmModChan* self = static_cast<OmModChan*>(ptr);
 
-  OmWString mod_path = reinterpret_cast<wchar_t*>(param);
+  #ifdef DEBUG
+  clock_t t = clock();
+  #endif
 
-  // ignore hidden file except if required
-  if(!self->_library_showhidden && Om_isHidden(mod_path))
-      return;
+  // hashes of Mod Packs to forward notification for
+  std::vector<uint64_t> altered_hash;
+  std::vector<uint64_t> deleted_hash;
 
-  // ignore directories except in dev mode
-  if(!self->_library_devmode && Om_isDir(mod_path))
-      return;
+  // items that are not Mod Pack, may be thumbnail or description files
+  OmWStringArray others;
+
+  // Mod Packs sources to be parsed
+  std::vector<__monitor_job_t> jobs;
+
+  OmModPack* ModPack;
 
-  // get name hash
-  uint64_t name_hash = Om_getXXHash3(Om_getFilePart(mod_path));
+  // deleted items are processed first, this is fast
+  for(size_t i = 0; i < deleted.size(); ++i) {
 
-  // Forwarded notification type
-  OmNotify fw_notify = OM_NOTIFY_UNDEFINED;
+    // ignore hidden file except if required
+    if(!self->_library_showhidden && Om_isHidden(deleted[i]))
+      continue;
+
+    uint64_t name_hash = Om_getXXHash3(Om_getFilePart(deleted[i]));
 
-  // search for Mod Pack object
-  OmModPack* ModPack = self->findModpack(name_hash);
+    ModPack = self->findModpack(name_hash);
 
-  if(notify == OM_NOTIFY_ALTERED) {
+    if(!ModPack) {
+      others.push_back(deleted[i]);
+      continue;
+    }
 
-    // refresh Mod Pack source
-    if(ModPack) {
-      ModPack->refreshSource();
+    // check whether Mod Pack has backup data (is installed)
+    if(ModPack->hasBackup()) {
+      // Clear Mod Pack source side and
+      ModPack->clearSource();
       // forward alternation notification
-      fw_notify = OM_NOTIFY_ALTERED;
+      altered_hash.push_back(name_hash);
+    } else {
+      // Remove Mod Pack from Mod Library
+      int32_t p = self->indexOfModpack(ModPack);
+      self->_modpack_list.erase(self->_modpack_list.begin() + p);
+      delete ModPack;
+      // forward deletion notification
+      deleted_hash.push_back(name_hash);
     }
+  }
 
-    #ifdef DEBUG
-    if(fw_notify)
-      std::cout << "DEBUG => OmModChan::_monitor_notify_fn ~=\n";
-    #endif
+  // altered Mod Packs sources are refreshed
+  for(size_t i = 0; i < altered.size(); ++i) {
+
+    // ignore hidden file except if required
+    if(!self->_library_showhidden && Om_isHidden(altered[i]))
+      continue;
+
+    // ignore directories except in dev mode
+    if(!self->_library_devmode && Om_isDir(altered[i]))
+      continue;
+
+    ModPack = self->findModpack(Om_getXXHash3(Om_getFilePart(altered[i])));
+
+    if(!ModPack) {
+      others.push_back(altered[i]);
+      continue;
+    }
+
+    __monitor_job_t job;
+    job.path = altered[i];
+    job.ModPack = ModPack;
+    job.is_new = false;
+    job.refresh = true;
+    job.result = false;
+    jobs.push_back(job);
   }
 
-  if(notify == OM_NOTIFY_CREATED) {
+  // created Mod Packs sources are parsed
+  for(size_t i = 0; i < created.size(); ++i) {
 
-    // filter by directory / file extension
-    if(Om_isDir(mod_path) ||
-       Om_extensionMatches(mod_path, L"zip") ||
-       Om_extensionMatches(mod_path, OM_PKG_FILE_EXT)) {
-
-      // check whether this Mod Source matches an existing Backup
-      if(ModPack) {
-        ModPack->parseSource(mod_path);
-        // forward alternation notification
-        fw_notify = OM_NOTIFY_ALTERED;
-      } else {
-        // no Backup found for this Mod Source, adding new
-        ModPack = new OmModPack(self);
-        if(ModPack->parseSource(mod_path)) {
-          self->_modpack_list.push_back(ModPack);
-          // forward creation notification
-          fw_notify = OM_NOTIFY_CREATED;
-        } else {
-          delete ModPack;
-        }
-      }
+    // ignore hidden file except if required
+    if(!self->_library_showhidden && Om_isHidden(created[i]))
+      continue;
+
+    // ignore directories except in dev mode
+    if(!self->_library_devmode && Om_isDir(created[i]))
+      continue;
 
-      #ifdef DEBUG
-      if(fw_notify)
-        std::cout << "DEBUG => OmModChan::_monitor_notify_fn ++\n";
-      #endif
+    // filter by directory / file extension
+    if(!Om_isDir(created[i]) &&
+       !Om_extensionMatches(created[i], L"zip") &&
+       !Om_extensionMatches(created[i], OM_PKG_FILE_EXT)) {
+      others.push_back(created[i]);
+      continue;
     }
+
+    // check whether this Mod Source matches an existing Backup
+    ModPack = self->findModpack(Om_getXXHash3(Om_getFilePart(created[i])));
+
+    __monitor_job_t job;
+    job.path = created[i];
+    job.is_new = (ModPack == nullptr);
+    job.ModPack = job.is_new ? new OmModPack(self) : ModPack;
+    job.refresh = false;
+    job.result = false;
+    jobs.push_back(job);
   }
 
-  if(notify == OM_NOTIFY_DELETED) {
+  // parse sources, each parse being independent, this is done in parallel
+  Om_parallelFor(jobs.size(), OmModChan::_monitor_job_fn, &jobs);
+
+  // new Mod Packs to be added to list
+  OmPModPackArray added;
 
-    // delete or modify Mod Pack
-    if(ModPack) {
-      // check whether Mod Pack has backup data (is installed)
-      if(ModPack->hasBackup()) {
-        // Clear Mod Pack source side and
-        ModPack->clearSource();
-        // forward alternation notification
-        fw_notify = OM_NOTIFY_ALTERED;
+  for(size_t i = 0; i < jobs.size(); ++i) {
+
+    if(jobs[i].is_new) {
+      // no Backup found for this Mod Source, adding new
+      if(jobs[i].result) {
+        added.push_back(jobs[i].ModPack);
       } else {
-        // Remove Mod Pack from Mod Library
-        int32_t p = self->indexOfModpack(ModPack);
-        self->_modpack_list.erase(self->_modpack_list.begin() + p);
-        delete ModPack;
-        // forward deletion notification
-        fw_notify = OM_NOTIFY_DELETED;
+        delete jobs[i].ModPack;
       }
+    } else {
+      // forward alternation notification
+      altered_hash.push_back(jobs[i].ModPack->hash());
     }
-
-    #ifdef DEBUG
-    if(fw_notify)
-      std::cout << "DEBUG => OmModChan::_monitor_notify_fn --\n";
-    #endif
   }
 
-  if(fw_notify) {
+  // few elements are inserted at their sorted position, otherwise the list
+  // is sorted again and rebuilt
+  bool rebuild = (added.size() > OM_MONITOR_INSERT_MAX);
 
-    // if an element was added to list we need to sort again
-    if(fw_notify == OM_NOTIFY_CREATED) {
+  if(rebuild) {
 
-      self->sortModLibrary(); //< this will send rebuild notification
+    self->_modpack_list.insert(self->_modpack_list.end(), added.begin(), added.end());
 
-    } else {
+    self->sortModLibrary(); //< this will send rebuild notification
 
-      // this is a simple alteration we can optimize changes
-      if(self->_modpack_notify_cb)
-        self->_modpack_notify_cb(self->_modpack_notify_ptr, fw_notify, name_hash);
+  } else {
+
+    // these are simple alterations we can optimize changes
+    if(self->_modpack_notify_cb) {
+
+      for(size_t i = 0; i < deleted_hash.size(); ++i)
+        self->_modpack_notify_cb(self->_modpack_notify_ptr, OM_NOTIFY_DELETED, deleted_hash[i]);
+
+      for(size_t i = 0; i < altered_hash.size(); ++i)
+        self->_modpack_notify_cb(self->_modpack_notify_ptr, OM_NOTIFY_ALTERED, altered_hash[i]);
     }
 
-    // As changes in local library may change status in Network library
-    // we refresh Network library
+    for(size_t i = 0; i < added.size(); ++i)
+      self->_insert_modpack(added[i]); //< this will send creation notification
+  }
+
+  // As changes in local library may change status in Network library
+  // we refresh Network library
+  if(added.size() || deleted_hash.size() || altered_hash.size())
     self->refreshNetLibrary();
 
-  } else {
+  // at this point, remaining items are not Mod Pack, so we check whether
+  // they are image or text file used as thumbnail or description for a
+  // dev Mod directory
+  if(self->_library_devmode) {
 
-    // at this point, if not changes was made this mean the file is not a
-    // Mod Pack, so we check whether this is an image or text file used
-    // as thumbnail or description for a dev Mod directory
-    if(self->_library_devmode) {
+    for(size_t i = 0; i < others.size(); ++i) {
 
       // get presumed mod 'identity' from file name
-      OmWString iden = Om_getNamePart(mod_path);
+      OmWString iden = Om_getNamePart(others[i]);
 
       for(size_t p = 0; p < self->_modpack_list.size(); ++p) {
 
@@ -941,16 +1081,15 @@ void OmModChan::_monitor_notify_fn(void* ptr, OmNotify notify, uint64_t param)
           // forward alteration notification
           if(self->_modpack_notify_cb)
             self->_modpack_notify_cb(self->_modpack_notify_ptr, OM_NOTIFY_ALTERED, ModPack->hash());
-
-          #ifdef DEBUG
-          std::cout << "DEBUG => OmModChan::_monitor_notify_fn //\n";
-          #endif
         }
       }
-
-
     }
   }
+
+  #ifdef DEBUG
+  std::cout << "DEBUG => OmModChan::_monitor_batch_fn ++" << created.size() << " ~=" << altered.size()
+            << " --" << deleted.size() << " (" << ((float)(clock()-t)/CLOCKS_PER_SEC) << "s)\n";
+  #endif
 }
 
 ///
@@ -972,6 +1111,12 @@ void OmModChan::clearModLibrary()
 ///
 void OmModChan::reloadModLibrary()
 {
+  // library is loaded once channel is activated
+  if(!this->_activated)
+    return;
+
+  OmPerfScope perf(L"library reload", this->_title);
+
   // clear current library
   if(!this->_modpack_list.empty()) {
 
@@ -1041,6 +1186,8 @@ void OmModChan::reloadModLibrary()
     }
   }
 
+  perf.addFiles(this->_modpack_list.size());
+
   // sort library
   this->sortModLibrary(); //< this will send rebuild notification
 
@@ -1061,6 +1208,9 @@ void OmModChan::reloadModLibrary()
 ///
 bool OmModChan::refreshModLibrary()
 {
+  OmPerfScope perf(L"library refresh", this->_title);
+  perf.addFiles(this->_modpack_list.size());
+
   bool has_change = false;
 
   for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
@@ -1185,7 +1335,7 @@ OmResult OmModChan::addToLibrary(const OmWStringArray& files, Om_progressCb prog
     }
 
     #ifdef DEBUG
-    Sleep(100);
+    Om_pltSleep(100);
     #endif // DEBUG
   }
 
@@ -1247,7 +1397,7 @@ OmResult OmModChan::importToLibrary(const OmWStringArray& paths, Om_progressCb p
     }
 
     #ifdef DEBUG
-    Sleep(100);
+    Om_pltSleep(100);
     #endif // DEBUG
   }
 
@@ -1324,31 +1474,10 @@ OmModPack* OmModChan::findModpack(const OmWString& iden, bool nodir) const
 ///
 bool OmModChan::_compare_mod_name(const OmModPack* a, const OmModPack* b)
 {
-  // test against the shorter string
-  size_t l = a->iden().size() < b->iden().size() ? b->iden().size() : a->iden().size();
-
-  const wchar_t* a_srt = a->iden().c_str();
-  const wchar_t* b_str = b->iden().c_str();
-
-  // test for ASCII value greater than the other
-  for(unsigned i = 0; i < l; ++i) {
-
-    wchar_t a_chr = towupper(a_srt[i]);
-    wchar_t b_chr = towupper(b_str[i]);
-
-    if(a_chr != b_chr) {
-      if(a_chr < b_chr) {
-        return true;
-      } else {
-        return false;
-      }
-    }
-  }
-
-  // strings are equals in tester portion, sort by string size
-  if(a->iden().size() != b->iden().size())
-    if(a->iden().size() < b->iden().size())
-      return true;
+  // compare upper case identities
+  int c = a->idenKey().compare(b->idenKey());
+  if(c != 0)
+    return (c < 0);
 
   // strings are strictly equals, we sort by "IsZip" status
   if(!a->sourceIsDir() && b->sourceIsDir())
@@ -1386,31 +1515,10 @@ bool OmModChan::_compare_mod_vers(const OmModPack* a, const OmModPack* b)
 ///
 bool OmModChan::_compare_mod_cate(const OmModPack* a, const OmModPack* b)
 {
-  // test against the shorter string
-  size_t l = a->category().size() < b->category().size() ? b->category().size() : a->category().size();
-
-  const wchar_t* a_srt = a->category().c_str();
-  const wchar_t* b_str = b->category().c_str();
-
-  // test for ASCII value greater than the other
-  for(unsigned i = 0; i < l; ++i) {
-
-    wchar_t a_chr = towupper(a_srt[i]);
-    wchar_t b_chr = towupper(b_str[i]);
-
-    if(a_chr != b_chr) {
-      if(a_chr < b_chr) {
-        return true;
-      } else {
-        return false;
-      }
-    }
-  }
-
-  // strings are equals in tester portion, sort by string size
-  if(a->category().size() != b->category().size())
-    if(a->category().size() < b->category().size())
-      return true;
+  // compare upper case categories
+  int c = a->categoryKey().compare(b->categoryKey());
+  if(c != 0)
+    return (c < 0);
 
   // strings are strictly equals, we sort by name
   return OmModChan::_compare_mod_name(a, b);
@@ -1440,6 +1548,45 @@ void OmModChan::sortModLibrary()
     this->_modpack_notify_cb(this->_modpack_notify_ptr, OM_NOTIFY_REBUILD, 0);
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_insert_modpack(OmModPack* ModPack)
+{
+  bool(*compare_func)(const OmModPack*,const OmModPack*) = nullptr;
+
+  if(OM_HAS_BIT(this->_modpack_list_sort,OM_SORT_STAT)) compare_func = OmModChan::_compare_mod_stat;
+  if(OM_HAS_BIT(this->_modpack_list_sort,OM_SORT_NAME)) compare_func = OmModChan::_compare_mod_name;
+  if(OM_HAS_BIT(this->_modpack_list_sort,OM_SORT_VERS)) compare_func = OmModChan::_compare_mod_vers;
+  if(OM_HAS_BIT(this->_modpack_list_sort,OM_SORT_CATE)) compare_func = OmModChan::_compare_mod_cate;
+
+  bool invert = OM_HAS_BIT(this->_modpack_list_sort,OM_SORT_INVT);
+
+  // binary search for insert position in the sorted list
+  size_t lo = 0, hi = this->_modpack_list.size();
+
+  if(compare_func) {
+
+    while(lo < hi) {
+
+      size_t mid = (lo + hi) / 2;
+
+      bool before = invert ? compare_func(this->_modpack_list[mid], ModPack)
+                           : compare_func(ModPack, this->_modpack_list[mid]);
+      if(before) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+  }
+
+  this->_modpack_list.insert(this->_modpack_list.begin() + lo, ModPack);
+
+  if(this->_modpack_notify_cb)
+    this->_modpack_notify_cb(this->_modpack_notify_ptr, OM_NOTIFY_CREATED, ModPack->hash());
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -1555,8 +1702,11 @@ OmModPack* OmModChan::findModDepend(const OmWString& filter, bool installed) con
 
   if(Om_parseModIdent(filter, &core, &vers, nullptr)) {
 
-    // gather candidates
-    OmPModPackArray candidates;
+    // filter is compiled once for all candidates
+    OmVersionFilter vers_filter(vers);
+
+    // keep the highest matching version
+    OmModPack* best = nullptr;
 
     for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
 
@@ -1566,20 +1716,14 @@ OmModPack* OmModChan::findModDepend(const OmWString& filter, bool installed) con
       if(this->_modpack_list[i]->core() != core)
         continue;
 
-      if(!this->_modpack_list[i]->version().match(vers))
+      if(!vers_filter.match(this->_modpack_list[i]->version()))
         continue;
 
-      candidates.push_back(this->_modpack_list[i]);
+      if(!best || _compare_mod_vers(best, this->_modpack_list[i]))
+        best = this->_modpack_list[i];
     }
 
-    if(candidates.size()) {
-
-      // more than one candidate, sort by version
-      if(candidates.size() > 1)
-        std::sort(candidates.begin(), candidates.end(), _compare_mod_vers);
-
-      return candidates[candidates.size()-1];
-    }
+    return best;
 
   } else {
 
@@ -1596,6 +1740,50 @@ OmModPack* OmModChan::findModDepend(const OmWString& filter, bool installed) con
   return nullptr;
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmModPack* OmModChan::findModDepend(const OmModPack* ModPack, size_t i, bool installed) const
+{
+  const OmWString& core = ModPack->getDependCore(i);
+  const OmVersionFilter& vers_filter = ModPack->getDependFilter(i);
+
+  // identity without version must match exactly
+  if(!vers_filter.valid()) {
+
+    for(size_t j = 0; j < this->_modpack_list.size(); ++j) {
+
+      if(installed && !this->_modpack_list[j]->hasBackup())
+        continue;
+
+      if(this->_modpack_list[j]->iden() == core)
+        return this->_modpack_list[j];
+    }
+
+    return nullptr;
+  }
+
+  // keep the highest matching version
+  OmModPack* best = nullptr;
+
+  for(size_t j = 0; j < this->_modpack_list.size(); ++j) {
+
+    if(installed && !this->_modpack_list[j]->hasBackup())
+      continue;
+
+    if(this->_modpack_list[j]->core() != core)
+      continue;
+
+    if(!vers_filter.match(this->_modpack_list[j]->version()))
+      continue;
+
+    if(!best || _compare_mod_vers(best, this->_modpack_list[j]))
+      best = this->_modpack_list[j];
+  }
+
+  return best;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -1646,7 +1834,7 @@ bool OmModChan::hasMissingDepend(const OmModPack* ModPack) const
       }
     }
 */
-    OmModPack* DepMod = this->findModDepend(ModPack->getDependIden(i));
+    OmModPack* DepMod = this->findModDepend(ModPack, i);
 
     if(DepMod && !DepMod->sourceIsDir()) {
 
@@ -1690,7 +1878,7 @@ bool OmModChan::hasBrokenDepend(const OmModPack* ModPack) const
       }
     }
 */
-    OmModPack* DepMod = this->findModDepend(ModPack->getDependIden(i), true);
+    OmModPack* DepMod = this->findModDepend(ModPack, i, true);
 
     // ignore directory Mods
     if(DepMod && !DepMod->sourceIsDir()) {
@@ -1748,7 +1936,7 @@ void OmModChan::_get_modops_depends(const OmModPack* ModPack, OmPModPackArray* d
     }
     */
 
-    OmModPack* DepMod = this->findModDepend(ModPack->getDependIden(i));
+    OmModPack* DepMod = this->findModDepend(ModPack, i);
 
     if(DepMod && !DepMod->sourceIsDir()) {
 
@@ -1773,6 +1961,9 @@ void OmModChan::_get_modops_depends(const OmModPack* ModPack, OmPModPackArray* d
 ///
 void OmModChan::prepareInstalls(const OmPModPackArray& selection, OmPModPackArray* installs, OmWStringArray* overlaps, OmWStringArray* depends, OmWStringArray* missings, OmWStringArray* conflicts) const
 {
+  OmPerfScope perf(L"overlap analysis", this->_title);
+  perf.addFiles(selection.size());
+
   // Force refresh Mod content
   for(size_t i = 0; i < selection.size(); ++i)
     selection[i]->refreshSource();
@@ -1861,8 +2052,11 @@ void OmModChan::_get_backup_relations(const OmModPack* ModPack, OmPModPackArray*
     if(is_overlapper || is_dependent) {
 
       // we go for recursive search to get a properly sorted list of
-      // packages in depth-first search order.
-      this->_get_backup_relations(this->_modpack_list[i], relations, overlappers, dependents);
+      // packages in depth-first search order. A package already listed
+      // had its own relations listed before it, exploring it again would
+      // make the search exponential with chains of overlapping Mods.
+      if(!Om_arrayContain(*relations, this->_modpack_list[i]))
+        this->_get_backup_relations(this->_modpack_list[i], relations, overlappers, dependents);
 
       // we now add to the proper lists
       if(is_overlapper)
@@ -1882,6 +2076,9 @@ void OmModChan::_get_backup_relations(const OmModPack* ModPack, OmPModPackArray*
 ///
 void OmModChan::prepareRestores(const OmPModPackArray& selection, OmPModPackArray* restores, OmWStringArray* overlappers, OmWStringArray* dependents) const
 {
+  OmPerfScope perf(L"restore analysis", this->_title);
+  perf.addFiles(selection.size());
+
   // get overlapping packages list to be uninstalled before selection
   for(size_t i = 0; i < selection.size(); ++i) {
 
@@ -1958,8 +2155,9 @@ void OmModChan::_get_cleaning_relations(const OmModPack* ModPack, const OmPModPa
     if(is_overlapper) {
 
       // we go for recursive search to get a properly sorted list of
-      // packages in depth-first search order.
-      this->_get_cleaning_relations(this->_modpack_list[i], selection, relations, overlappers);
+      // packages in depth-first search order, see _get_backup_relations
+      if(!Om_arrayContain(*relations, this->_modpack_list[i]))
+        this->_get_cleaning_relations(this->_modpack_list[i], selection, relations, overlappers);
 
       // we now add to the proper lists
       if(is_overlapper)
@@ -2010,6 +2208,159 @@ void OmModChan::prepareCleaning(const OmPModPackArray& selection, OmPModPackArra
   }
 }
 
+/// \brief Preset transition required Mods
+///
+/// Recursively adds the given Mod and its dependencies to the set of
+/// Mods required by Preset.
+///
+/// \param[in]  ModChan   : Mod Channel to search dependencies in.
+/// \param[in]  ModPack   : Mod to add.
+/// \param[out] required  : Set of required Mods.
+///
+static void __plan_required(const OmModChan* ModChan, OmModPack* ModPack, std::set<const OmModPack*>* required)
+{
+  if(!required->insert(ModPack).second)
+    return;
+
+  for(size_t i = 0; i < ModPack->dependCount(); ++i) {
+
+    OmModPack* DepMod = ModChan->findModDepend(ModPack, i);
+
+    if(DepMod && !DepMod->sourceIsDir())
+      __plan_required(ModChan, DepMod, required);
+  }
+}
+
+/// \brief Preset transition restores
+///
+/// Depth-first walk of installed Mods relations, adding Mods that overlap
+/// or depend on the given one before it, so each Mod of the resulting list
+/// can be restored without implying other restoration.
+///
+/// \param[in]  ModPack   : Mod to restore.
+/// \param[in]  uppers    : Installed Mods that overlap or depend on each Mod.
+/// \param[out] visited   : Set of already processed Mods.
+/// \param[out] restores  : Ordered restores list.
+///
+static void __plan_restores(OmModPack* ModPack, const std::map<const OmModPack*, OmPModPackArray>& uppers, std::set<const OmModPack*>* visited, OmPModPackArray* restores)
+{
+  if(!visited->insert(ModPack).second)
+    return;
+
+  std::map<const OmModPack*, OmPModPackArray>::const_iterator it = uppers.find(ModPack);
+  if(it != uppers.end()) {
+    for(size_t i = 0; i < it->second.size(); ++i)
+      __plan_restores(it->second[i], uppers, visited, restores);
+  }
+
+  restores->push_back(ModPack);
+}
+
+/// \brief Preset transition installs
+///
+/// Adds the given Mod to installs list, preceded by its dependencies which
+/// are not installed or will be restored.
+///
+/// \param[in]  ModChan   : Mod Channel to search dependencies in.
+/// \param[in]  ModPack   : Mod to install.
+/// \param[in]  restored  : Set of Mods to be restored.
+/// \param[out] visited   : Set of already processed Mods.
+/// \param[out] installs  : Ordered installs list.
+///
+static void __plan_installs(const OmModChan* ModChan, OmModPack* ModPack, const std::set<const OmModPack*>& restored, std::set<const OmModPack*>* visited, OmPModPackArray* installs)
+{
+  if(!visited->insert(ModPack).second)
+    return;
+
+  // installed Mod that is kept in place
+  if(ModPack->hasBackup() && !restored.count(ModPack))
+    return;
+
+  for(size_t i = 0; i < ModPack->dependCount(); ++i) {
+
+    OmModPack* DepMod = ModChan->findModDepend(ModPack, i);
+
+    if(DepMod && !DepMod->sourceIsDir())
+      __plan_installs(ModChan, DepMod, restored, visited, installs);
+  }
+
+  installs->push_back(ModPack);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::preparePreset(const OmPModPackArray& selection, bool install_only, OmPModPackArray* restores, OmPModPackArray* installs) const
+{
+  // index installed Mods by hash
+  std::map<uint64_t, OmModPack*> hash_map;
+
+  OmPModPackArray installed;
+
+  for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
+
+    OmModPack* ModPack = this->_modpack_list[i];
+
+    if(!ModPack->hasBackup())
+      continue;
+
+    installed.push_back(ModPack);
+    hash_map.insert(std::pair<uint64_t, OmModPack*>(ModPack->hash(), ModPack));
+  }
+
+  // build reverse relations graph, for each installed Mod, the list of
+  // installed Mods which overlap or depend on it
+  std::map<const OmModPack*, OmPModPackArray> uppers;
+
+  for(size_t i = 0; i < installed.size(); ++i) {
+
+    OmModPack* ModPack = installed[i];
+
+    for(size_t j = 0; j < ModPack->overlapCount(); ++j) {
+      std::map<uint64_t, OmModPack*>::const_iterator it = hash_map.find(ModPack->getOverlapHash(j));
+      if(it != hash_map.end() && it->second != ModPack)
+        Om_push_backUnique(uppers[it->second], ModPack);
+    }
+
+    // dependencies may be declared with version filter, resolve them the
+    // same way install does, among installed Mods only
+    for(size_t j = 0; j < ModPack->dependCount(); ++j) {
+      OmModPack* DepMod = this->findModDepend(ModPack, j, true);
+      if(DepMod && DepMod != ModPack)
+        Om_push_backUnique(uppers[DepMod], ModPack);
+    }
+  }
+
+  // Mods required by selection, including dependencies
+  std::set<const OmModPack*> required;
+  for(size_t i = 0; i < selection.size(); ++i)
+    __plan_required(this, selection[i], &required);
+
+  // restore installed Mods no longer required, along with Mods that
+  // overlap or depend on them
+  std::set<const OmModPack*> visited;
+
+  if(!install_only) {
+    for(size_t i = 0; i < installed.size(); ++i)
+      if(!required.count(installed[i]))
+        __plan_restores(installed[i], uppers, &visited, restores);
+  }
+
+  std::set<const OmModPack*> restored(restores->begin(), restores->end());
+
+  visited.clear();
+
+  // required Mods restored as side effect are installed again first, in
+  // reverse restoration order, which is their original install order
+  for(size_t i = restores->size(); i-- > 0; )
+    if(required.count(restores->at(i)))
+      __plan_installs(this, restores->at(i), restored, &visited, installs);
+
+  // then selection Mods not yet installed
+  for(size_t i = 0; i < selection.size(); ++i)
+    __plan_installs(this, selection[i], restored, &visited, installs);
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -2026,8 +2377,9 @@ void OmModChan::queueModOps(const OmPModPackArray& selection, Om_beginCb begin_c
 {
   if(this->_modops_queue.empty()) {
 
-    // another operation is currently processing
-    if(this->_locked_mod_library) {
+    // another operation is currently processing, library is claimed
+    // atomically since Mod Hub may run operations from its own threads
+    if(Om_pltAtomicSet(&this->_locked_mod_library, 1)) {
 
       this->_log(OM_LOG_WRN, L"queueModOps", L"local library is locked by another operation");
 
@@ -2061,9 +2413,6 @@ void OmModChan::queueModOps(const OmPModPackArray& selection, Om_beginCb begin_c
     }
   }
 
-  // lock the local library to prevent concurrent array manipulation
-  this->_locked_mod_library = true;
-
   // reset abort flag
   this->_modops_abort = false;
 
@@ -2073,8 +2422,8 @@ void OmModChan::queueModOps(const OmPModPackArray& selection, Om_beginCb begin_c
   if(!this->_modops_hth) {
 
     // launch thread
-    this->_modops_hth = Om_threadCreate(OmModChan::_modops_run_fn, this);
-    this->_modops_hwo = Om_threadWaitEnd(this->_modops_hth, OmModChan::_modops_end_fn, this);
+    this->_modops_hth = Om_pltThreadCreate(OmModChan::_modops_run_fn, this);
+    this->_modops_hwo = Om_pltThreadWatch(this->_modops_hth, OmModChan::_modops_end_fn, this);
   }
 }
 
@@ -2091,8 +2440,9 @@ OmResult OmModChan::execModOps(const OmPModPackArray& selection, Om_beginCb begi
     invalid_call = true;
   }
 
-  // another operation is currently processing
-  if(this->_locked_mod_library) {
+  // another operation is currently processing, otherwise library is
+  // claimed for this call
+  if(!invalid_call && Om_pltAtomicSet(&this->_locked_mod_library, 1)) {
     this->_log(OM_LOG_WRN, L"execModOps", L"local library is locked by another operation");
     invalid_call = true;
   }
@@ -2115,9 +2465,6 @@ OmResult OmModChan::execModOps(const OmPModPackArray& selection, Om_beginCb begi
   this->_modops_dones = 0;
   this->_modops_percent = 0;
 
-  // lock the local library to prevent concurrent array manipulation
-  this->_locked_mod_library = true;
-
   // reset abort flag
   this->_modops_abort = false;
 
@@ -2134,11 +2481,11 @@ OmResult OmModChan::execModOps(const OmPModPackArray& selection, Om_beginCb begi
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-DWORD WINAPI OmModChan::_modops_run_fn(void* ptr)
+uint32_t OmModChan::_modops_run_fn(void* ptr)
 {
   OmModChan* self = static_cast<OmModChan*>(ptr);
 
-  DWORD exit_code = OM_RESULT_OK;
+  uint32_t exit_code = OM_RESULT_OK;
 
   #ifdef DEBUG
   std::wcout << "DEBUG => OmModChan::_modops_run_fn : enter\n";
@@ -2253,7 +2600,7 @@ bool OmModChan::_modops_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-VOID WINAPI OmModChan::_modops_end_fn(void* ptr, uint8_t fired)
+void OmModChan::_modops_end_fn(void* ptr, uint8_t fired)
 {
   OM_UNUSED(fired);
 
@@ -2270,7 +2617,7 @@ VOID WINAPI OmModChan::_modops_end_fn(void* ptr, uint8_t fired)
   self->_locked_mod_library = false;
 
   //DWORD exit_code = Om_threadExitCode(self->_modops_hth);
-  Om_threadClear(self->_modops_hth, self->_modops_hwo);
+  Om_pltThreadClear(self->_modops_hth, self->_modops_hwo);
 
   // call notify callback
   if(self->_modops_notify_cb)
@@ -2344,6 +2691,9 @@ void OmModChan::clearNetLibrary()
 ///
 bool OmModChan::refreshNetLibrary()
 {
+  OmPerfScope perf(L"net library refresh", this->_title);
+  perf.addFiles(this->_netpack_list.size());
+
   bool has_change = false;
 
   for(size_t i = 0; i < this->_netpack_list.size(); ++i) {
@@ -2426,7 +2776,7 @@ void OmModChan::_get_missing_depends(const OmModPack* ModPack, OmWStringArray* m
     }
 */
 
-    OmModPack* DepMod = this->findModDepend(ModPack->getDependIden(i));
+    OmModPack* DepMod = this->findModDepend(ModPack, i);
 
     if(DepMod && !DepMod->sourceIsDir()) {
 
@@ -2802,15 +3152,15 @@ void OmModChan::_download_srart_queued()
 {
   // prevent simultaneous startings
   if(!this->_download_start_hth) {
-    this->_download_start_hth = Om_threadCreate(OmModChan::_download_start_run_fn, this);
-    this->_download_start_hwo = Om_threadWaitEnd(this->_download_start_hth, OmModChan::_download_start_end_fn, this);
+    this->_download_start_hth = Om_pltThreadCreate(OmModChan::_download_start_run_fn, this);
+    this->_download_start_hwo = Om_pltThreadWatch(this->_download_start_hth, OmModChan::_download_start_end_fn, this);
   }
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-DWORD WINAPI OmModChan::_download_start_run_fn(void* ptr)
+uint32_t OmModChan::_download_start_run_fn(void* ptr)
 {
   OmModChan* self = static_cast<OmModChan*>(ptr);
 
@@ -2818,7 +3168,7 @@ DWORD WINAPI OmModChan::_download_start_run_fn(void* ptr)
 
     if(self->_down_max_thread > 0) {
       if(self->_download_array.size() >= self->_down_max_thread) {
-        Sleep(250);
+        Om_pltSleep(250);
         continue;
       }
     }
@@ -2841,7 +3191,7 @@ DWORD WINAPI OmModChan::_download_start_run_fn(void* ptr)
     self->_download_queue.pop_front();
 
     // wait a bit to prevent flood
-    Sleep(250);
+    Om_pltSleep(250);
   }
 
   return 0;
@@ -2850,7 +3200,7 @@ DWORD WINAPI OmModChan::_download_start_run_fn(void* ptr)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-VOID WINAPI OmModChan::_download_start_end_fn(void* ptr, uint8_t fired)
+void OmModChan::_download_start_end_fn(void* ptr, uint8_t fired)
 {
   OM_UNUSED(fired);
 
@@ -2862,7 +3212,7 @@ VOID WINAPI OmModChan::_download_start_end_fn(void* ptr, uint8_t fired)
   // unlock the network library
   self->_locked_net_library = false;
 
-  Om_threadClear(self->_download_start_hth, self->_download_start_hwo);
+  Om_pltThreadClear(self->_download_start_hth, self->_download_start_hwo);
 
   self->_download_start_hth = nullptr;
   self->_download_start_hwo = nullptr;
@@ -2898,62 +3248,97 @@ void OmModChan::_download_result_fn(void* ptr, OmResult result, uint64_t param)
 
   OmNetPack* NetPack = reinterpret_cast<OmNetPack*>(param);
 
-  // the final result, including download close operation
-  OmResult final_result;
+  if(result != OM_RESULT_OK) {
+    // this is probably an abort
+    self->_download_close(NetPack, result);
+    return;
+  }
 
-  // finalize the download, this verify checksum and rename
-  // temporary partial download file to regular file name
-  if(result == OM_RESULT_OK) {
+  // completed downloads are finalized by batch so their checksums are
+  // computed at once, the first thread to find no running batch processes
+  // pending downloads, including those completed meanwhile
+  Om_pltLockEnter(self->_download_final_lk);
 
-    if(NetPack->finalizeDownload()) {
-      final_result = OM_RESULT_OK;
-    } else {
-      final_result = OM_RESULT_ERROR;
-    }
+  self->_download_final.push_back(NetPack);
 
-  } else {
+  bool running = self->_download_finalizing;
+  self->_download_finalizing = true;
 
-    // this is probably an abort
-    final_result = result;
+  Om_pltLockLeave(self->_download_final_lk);
+
+  if(running)
+    return;
+
+  OmPNetPackArray batch;
+
+  while(true) {
+
+    Om_pltLockEnter(self->_download_final_lk);
+
+    batch.swap(self->_download_final);
+    self->_download_final.clear();
+
+    if(batch.empty())
+      self->_download_finalizing = false;
+
+    Om_pltLockLeave(self->_download_final_lk);
+
+    if(batch.empty())
+      break;
+
+    OmNetPack::verifyDownloads(batch);
+
+    // finalize the downloads, this verify checksum if not already done
+    // and rename temporary partial download file to regular file name
+    for(size_t i = 0; i < batch.size(); ++i)
+      self->_download_close(batch[i], batch[i]->finalizeDownload() ? OM_RESULT_OK : OM_RESULT_ERROR);
+
+    batch.clear();
   }
+}
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_download_close(OmNetPack* NetPack, OmResult result)
+{
   // update status and send propers notifications
-  self->refreshNetLibrary();
+  this->refreshNetLibrary();
 
   // remove download from stack
-  Om_eraseValue(self->_download_array, NetPack);
+  Om_eraseValue(this->_download_array, NetPack);
 
   // increase download done count
-  self->_download_dones++;
+  this->_download_dones++;
 
   // call client callback
-  if(self->_download_result_cb)
-    self->_download_result_cb(self->_download_user_ptr, final_result, param);
+  if(this->_download_result_cb)
+    this->_download_result_cb(this->_download_user_ptr, result, reinterpret_cast<uint64_t>(NetPack));
 
-  if(self->_download_array.size()) {
+  if(this->_download_array.size()) {
 
     // if abort request was fired, we must stop downloads sequentially to
     // prevent callback concurrent calls that mess up all process
-    if(self->_download_abort) {
-      self->_download_array.back()->stopDownload();
+    if(this->_download_abort) {
+      this->_download_array.back()->stopDownload();
     }
 
   } else {
 
-    self->_locked_net_library = false;
+    this->_locked_net_library = false;
 
     // call notify callback
-    if(self->_download_notify_cb)
-      self->_download_notify_cb(self->_download_user_ptr, OM_NOTIFY_ENDED, reinterpret_cast<uint64_t>(self));
+    if(this->_download_notify_cb)
+      this->_download_notify_cb(this->_download_user_ptr, OM_NOTIFY_ENDED, reinterpret_cast<uint64_t>(this));
 
-    self->_download_dones = 0;
-    self->_download_percent = 0;
+    this->_download_dones = 0;
+    this->_download_percent = 0;
 
-    self->_download_user_ptr = nullptr;
-    self->_download_begin_cb = nullptr;
-    self->_download_download_cb = nullptr;
-    self->_download_result_cb = nullptr;
-    self->_download_notify_cb = nullptr;
+    this->_download_user_ptr = nullptr;
+    this->_download_begin_cb = nullptr;
+    this->_download_download_cb = nullptr;
+    this->_download_result_cb = nullptr;
+    this->_download_notify_cb = nullptr;
   }
 }
 
@@ -2965,7 +3350,7 @@ void OmModChan::queueSupersede(const OmPNetPackArray& selection, Om_beginCb begi
   if(this->_supersed_queue.empty()) {
 
     // another operation is currently processing
-    if(this->_locked_mod_library) {
+    if(Om_pltAtomicSet(&this->_locked_mod_library, 1)) {
 
       this->_log(OM_LOG_WRN, L"queueSupersede", L"local library is locked by another operation");
 
@@ -2999,9 +3384,6 @@ void OmModChan::queueSupersede(const OmPNetPackArray& selection, Om_beginCb begi
     }
   }
 
-  // lock the local library to prevent concurrent array manipulation
-  this->_locked_mod_library = true;
-
   // reset abort flag
   this->_supersed_abort = false;
 
@@ -3011,8 +3393,8 @@ void OmModChan::queueSupersede(const OmPNetPackArray& selection, Om_beginCb begi
   if(!this->_supersed_hth) {
 
     // launch thread
-    this->_supersed_hth = Om_threadCreate(OmModChan::_supersed_run_fn, this);
-    this->_supersed_hwo = Om_threadWaitEnd(this->_supersed_hth, OmModChan::_supersed_end_fn, this);
+    this->_supersed_hth = Om_pltThreadCreate(OmModChan::_supersed_run_fn, this);
+    this->_supersed_hwo = Om_pltThreadWatch(this->_supersed_hth, OmModChan::_supersed_end_fn, this);
   }
 }
 
@@ -3028,11 +3410,11 @@ void OmModChan::abortSupersede()
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-DWORD WINAPI OmModChan::_supersed_run_fn(void* ptr)
+uint32_t OmModChan::_supersed_run_fn(void* ptr)
 {
   OmModChan* self = static_cast<OmModChan*>(ptr);
 
-  DWORD exit_code = 0;
+  uint32_t exit_code = 0;
 
   #ifdef DEBUG
   std::wcout << "DEBUG => OmModChan::_supersed_run_fn : enter\n";
@@ -3106,7 +3488,7 @@ bool OmModChan::_supersed_progress_fn(void* ptr, size_t tot, size_t cur, uint64_
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-VOID WINAPI OmModChan::_supersed_end_fn(void* ptr, uint8_t fired)
+void OmModChan::_supersed_end_fn(void* ptr, uint8_t fired)
 {
   OM_UNUSED(fired);
 
@@ -3120,7 +3502,7 @@ VOID WINAPI OmModChan::_supersed_end_fn(void* ptr, uint8_t fired)
   self->_locked_mod_library = false;
 
   //DWORD exit_code = Om_threadExitCode(self->_supersed_hth);
-  Om_threadClear(self->_supersed_hth, self->_supersed_hwo);
+  Om_pltThreadClear(self->_supersed_hth, self->_supersed_hwo);
 
   self->_supersed_hth = nullptr;
   self->_supersed_hwo = nullptr;
@@ -3144,33 +3526,8 @@ VOID WINAPI OmModChan::_supersed_end_fn(void* ptr, uint8_t fired)
 ///
 bool OmModChan::_compare_net_name(const OmNetPack* a, const OmNetPack* b)
 {
-  // test against the shorter string
-  size_t l = a->iden().size() < b->iden().size() ? b->iden().size() : a->iden().size();
-
-  const wchar_t* a_srt = a->iden().c_str();
-  const wchar_t* b_str = b->iden().c_str();
-
-  // test for ASCII value greater than the other
-  for(unsigned i = 0; i < l; ++i) {
-
-    wchar_t a_chr = towupper(a_srt[i]);
-    wchar_t b_chr = towupper(b_str[i]);
-
-    if(a_chr != b_chr) {
-      if(a_chr < b_chr) {
-        return true;
-      } else {
-        return false;
-      }
-    }
-  }
-
-  // strings are equals in tester portion, sort by string size
-  if(a->iden().size() != b->iden().size())
-    if(a->iden().size() < b->iden().size())
-      return true;
-
-  return false;
+  // compare upper case identities
+  return (a->idenKey().compare(b->idenKey()) < 0);
 }
 
 ///
@@ -3255,31 +3612,10 @@ bool OmModChan::_compare_net_vers(const OmNetPack* a, const OmNetPack* b)
 ///
 bool OmModChan::_compare_net_cate(const OmNetPack* a, const OmNetPack* b)
 {
-  // test against the shorter string
-  size_t l = a->category().size() < b->category().size() ? b->category().size() : a->category().size();
-
-  const wchar_t* a_srt = a->category().c_str();
-  const wchar_t* b_str = b->category().c_str();
-
-  // test for ASCII value greater than the other
-  for(unsigned i = 0; i < l; ++i) {
-
-    wchar_t a_chr = towupper(a_srt[i]);
-    wchar_t b_chr = towupper(b_str[i]);
-
-    if(a_chr != b_chr) {
-      if(a_chr < b_chr) {
-        return true;
-      } else {
-        return false;
-      }
-    }
-  }
-
-  // strings are equals in tester portion, sort by string size
-  if(a->category().size() != b->category().size())
-    if(a->category().size() < b->category().size())
-      return true;
+  // compare upper case categories
+  int c = a->categoryKey().compare(b->categoryKey());
+  if(c != 0)
+    return (c < 0);
 
   // strings are strictly equals, we sort by name
   return OmModChan::_compare_net_name(a, b);
@@ -3542,16 +3878,51 @@ void OmModChan::queueQueries(const OmPNetRepoArray& selection, Om_beginCb begin_
   if(!this->_query_hth) {
 
     // launch thread
-    this->_query_hth = Om_threadCreate(OmModChan::_query_run_fn, this);
-    this->_query_hwo = Om_threadWaitEnd(this->_query_hth, OmModChan::_query_end_fn, this);
+    this->_query_hth = Om_pltThreadCreate(OmModChan::_query_run_fn, this);
+    this->_query_hwo = Om_pltThreadWatch(this->_query_hth, OmModChan::_query_end_fn, this);
   }
 }
 
 
+/// \brief Query references context
+///
+/// Structure to collect Net Packs parsed from references while
+/// repository definition is being received.
+///
+typedef struct {
+
+  OmModChan*        ModChan;
+
+  OmNetRepo*        NetRepo;
+
+  OmPNetPackArray   NetPacks;
+
+} __query_refs_t;
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-DWORD WINAPI OmModChan::_query_run_fn(void* ptr)
+bool OmModChan::_query_ref_fn(void* ptr, const OmNetRef_t* ref)
+{
+  __query_refs_t* refs = static_cast<__query_refs_t*>(ptr);
+
+  OmNetPack* NetPack = new OmNetPack(refs->ModChan);
+
+  if(NetPack->parseReference(refs->NetRepo, ref)) {
+    refs->NetPacks.push_back(NetPack);
+  } else {
+    refs->ModChan->_log(OM_LOG_WRN, L"queryNetRepository", NetPack->lastError());
+    delete NetPack;
+  }
+
+  // stop receiving definition if queries were aborted
+  return !refs->ModChan->_query_abort;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint32_t OmModChan::_query_run_fn(void* ptr)
 {
   #ifdef DEBUG
   std::wcout << "DEBUG => OmModChan::_query_run : enter\n";
@@ -3559,7 +3930,7 @@ DWORD WINAPI OmModChan::_query_run_fn(void* ptr)
 
   OmModChan* self = static_cast<OmModChan*>(ptr);
 
-  DWORD exit_code = 0;
+  uint32_t exit_code = 0;
 
   while(self->_query_queue.size()) {
 
@@ -3584,7 +3955,12 @@ DWORD WINAPI OmModChan::_query_run_fn(void* ptr)
     if(self->_query_begin_cb)
       self->_query_begin_cb(self->_query_user_ptr, reinterpret_cast<uint64_t>(NetRepo));
 
-    OmResult result = NetRepo->query();
+    // Net Packs are parsed while definition is received
+    __query_refs_t refs;
+    refs.ModChan = self;
+    refs.NetRepo = NetRepo;
+
+    OmResult result = NetRepo->query(OmModChan::_query_ref_fn, &refs);
 
     if(result == OM_RESULT_OK) {
 
@@ -3616,39 +3992,36 @@ DWORD WINAPI OmModChan::_query_run_fn(void* ptr)
         }
       }
 
-      // 2. parse and add referenced Mods in lists
-      for(size_t r = 0; r < NetRepo->referenceCount(); ++r) {
-
-        OmNetPack* NetPack = new OmNetPack(self);
+      // 2. add parsed referenced Mods in lists
+      for(size_t r = 0; r < refs.NetPacks.size(); ++r) {
 
-        if(NetPack->parseReference(NetRepo, r)) {
+        OmNetPack* NetPack = refs.NetPacks[r];
 
-          // we want to be sure Net Pack is unique in list
-          bool is_unique = true;
+        // we want to be sure Net Pack is unique in list
+        bool is_unique = true;
 
-          for(size_t j = 0; j < self->_netpack_list.size(); ++j) {
+        for(size_t j = 0; j < self->_netpack_list.size(); ++j) {
 
-            if(self->_netpack_list[j]->iden() == NetPack->iden()) {
-              delete self->_netpack_list[j]; //< remove previous
-              self->_netpack_list[j] = NetPack; //< replace object
-              is_unique = false; break;
-            }
+          if(self->_netpack_list[j]->iden() == NetPack->iden()) {
+            delete self->_netpack_list[j]; //< remove previous
+            self->_netpack_list[j] = NetPack; //< replace object
+            is_unique = false; break;
           }
-
-          if(is_unique)
-            self->_netpack_list.push_back(NetPack);
-
-        } else {
-
-          self->_log(OM_LOG_WRN, L"queryNetRepository", NetPack->lastError());
-          delete NetPack;
         }
+
+        if(is_unique)
+          self->_netpack_list.push_back(NetPack);
       }
 
       self->sortNetLibrary(); //< this will send rebuild notification
 
       self->refreshNetLibrary();
 
+    } else {
+
+      // discard Net Packs parsed from incomplete definition
+      for(size_t r = 0; r < refs.NetPacks.size(); ++r)
+        delete refs.NetPacks[r];
     }
 
     // update queue progress before sending result
@@ -3671,7 +4044,7 @@ DWORD WINAPI OmModChan::_query_run_fn(void* ptr)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-VOID WINAPI OmModChan::_query_end_fn(void* ptr, uint8_t fired)
+void OmModChan::_query_end_fn(void* ptr, uint8_t fired)
 {
   OM_UNUSED(fired);
 
@@ -3685,7 +4058,7 @@ VOID WINAPI OmModChan::_query_end_fn(void* ptr, uint8_t fired)
   self->_locked_net_library = false;
 
   //DWORD exit_code = Om_threadExitCode(self->_query_hth);
-  Om_threadClear(self->_query_hth, self->_query_hwo);
+  Om_pltThreadClear(self->_query_hth, self->_query_hwo);
 
   self->_query_hth = nullptr;
   self->_query_hwo = nullptr;
@@ -3819,7 +4192,7 @@ OmResult OmModChan::setCustLibraryPath(const OmWString& path)
   this->reloadModLibrary();
 
   // restart monitoring for the new directory
-  if(this->accessesLibrary(OM_ACCESS_DIR_READ))
+  if(this->_activated && this->accessesLibrary(OM_ACCESS_DIR_READ))
     this->_monitor.startMonitor(this->_library_path);
 
   return OM_RESULT_OK;
@@ -3857,7 +4230,7 @@ OmResult OmModChan::setDefLibraryPath()
   this->reloadModLibrary();
 
   // restart monitoring for the new directory
-  if(this->accessesLibrary(OM_ACCESS_DIR_READ))
+  if(this->_activated && this->accessesLibrary(OM_ACCESS_DIR_READ))
     this->_monitor.startMonitor(this->_library_path);
 
   return OM_RESULT_OK;
@@ -4065,6 +4438,25 @@ void OmModChan::setBackupOverlap(bool enable)
   this->_xml.save();
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::setBackupParallel(bool enable)
+{
+  if(!this->_xml.valid())
+    return;
+
+  this->_backup_parallel = enable;
+
+  if(this->_xml.hasChild(L"backup_parallel")) {
+    this->_xml.child(L"backup_parallel").setAttr(L"enable", this->_backup_parallel ? 1 : 0);
+  } else {
+    this->_xml.addChild(L"backup_parallel").setAttr(L"enable", this->_backup_parallel ? 1 : 0);
+  }
+
+  this->_xml.save();
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -0,0 +1,334 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
+#include <cwctype>            //< towupper
+
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmModEntry.h"
+
+/// \brief No node
+///
+/// Parent node index for entries and segments at root
+///
+#define __NO_NODE       0xFFFFFFFF
+
+/// \brief FNV-1a constants
+///
+/// 64-bit FNV-1a offset basis and prime
+///
+#define __FNV_OFFSET    0xcbf29ce484222325ULL
+#define __FNV_PRIME     0x00000100000001b3ULL
+
+/// \brief Case-insensitive hash step
+///
+/// Continues FNV-1a hash with the given characters, converted to upper case.
+///
+/// \param[in]  hash    : Current hash value.
+/// \param[in]  str     : Characters to hash.
+/// \param[in]  len     : Count of characters to hash.
+///
+/// \return Updated hash value.
+///
+static inline uint64_t __hash_upper(uint64_t hash, const wchar_t* str, size_t len)
+{
+  for(size_t i = 0; i < len; ++i) {
+    hash ^= static_cast<uint64_t>(towupper(str[i]));
+    hash *= __FNV_PRIME;
+  }
+
+  return hash;
+}
+
+/// \brief Segment key
+///
+/// Computes lookup key of directory segment from its exact name and parent
+/// node index.
+///
+/// \param[in]  parent  : Parent node index.
+/// \param[in]  name    : Segment name.
+/// \param[in]  len     : Segment name length.
+///
+/// \return Lookup key.
+///
+static inline uint64_t __node_key(uint32_t parent, const wchar_t* name, size_t len)
+{
+  uint64_t hash = __FNV_OFFSET;
+
+  for(size_t i = 0; i < len; ++i) {
+    hash ^= static_cast<uint64_t>(name[i]);
+    hash *= __FNV_PRIME;
+  }
+
+  return hash ^ (static_cast<uint64_t>(parent) * 0x9e3779b97f4a7c15ULL);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmModEntryTable::OmModEntryTable()
+{
+
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmModEntryTable::~OmModEntryTable()
+{
+
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint32_t OmModEntryTable::_get_node(uint32_t parent, const wchar_t* name, size_t len)
+{
+  uint64_t key = __node_key(parent, name, len);
+
+  std::map<uint64_t, uint32_t>::const_iterator it = this->_node_map.find(key);
+
+  if(it != this->_node_map.end()) {
+
+    const _node_t& node = this->_node[it->second];
+
+    // verify this is not a key collision
+    if(node.parent == parent && node.name_len == len)
+      if(0 == wmemcmp(this->_pool.data() + node.name_off, name, len))
+        return it->second;
+  }
+
+  _node_t node;
+  node.parent = parent;
+  node.name_off = this->_pool.size();
+  node.name_len = len;
+
+  if(parent != __NO_NODE) {
+    const _node_t& pnode = this->_node[parent];
+    node.path_len = pnode.path_len + 1 + len;
+    node.hash = __hash_upper(__hash_upper(pnode.hash, L"\\", 1), name, len);
+  } else {
+    node.path_len = len;
+    node.hash = __hash_upper(__FNV_OFFSET, name, len);
+  }
+
+  this->_pool.insert(this->_pool.end(), name, name + len);
+
+  uint32_t index = this->_node.size();
+
+  this->_node.push_back(node);
+
+  // in case of key collision the segment is simply not shared
+  if(it == this->_node_map.end())
+    this->_node_map[key] = index;
+
+  return index;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModEntryTable::_get_path(uint32_t parent, const wchar_t* name, size_t len, OmWString* path) const
+{
+  path->clear();
+
+  if(parent == __NO_NODE) {
+    path->append(name, len);
+    return;
+  }
+
+  path->reserve(this->_node[parent].path_len + 1 + len);
+
+  // gather segments from leaf to root
+  uint32_t chain[OM_MAX_PATH];
+  size_t n = 0;
+
+  for(uint32_t p = parent; p != __NO_NODE && n < OM_MAX_PATH; p = this->_node[p].parent)
+    chain[n++] = p;
+
+  while(n--) {
+    const _node_t& node = this->_node[chain[n]];
+    path->append(this->_pool.data() + node.name_off, node.name_len);
+    path->push_back(L'\\');
+  }
+
+  path->append(name, len);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModEntryTable::add(const OmWString& path, int32_t attr, int32_t cdid)
+{
+  _entry_t entry;
+  entry.attr = attr;
+  entry.cdid = cdid;
+  entry.next = __NO_NODE;
+
+  // intern each directory segment
+  uint32_t parent = __NO_NODE;
+
+  size_t s = 0, e;
+  while((e = path.find(L'\\', s)) != OmWString::npos) {
+    parent = this->_get_node(parent, path.c_str() + s, e - s);
+    s = e + 1;
+  }
+
+  size_t len = path.size() - s;
+
+  entry.parent = parent;
+  entry.name_off = this->_pool.size();
+  entry.name_len = len;
+
+  if(parent != __NO_NODE) {
+    entry.hash = __hash_upper(__hash_upper(this->_node[parent].hash, L"\\", 1), path.c_str() + s, len);
+  } else {
+    entry.hash = __hash_upper(__FNV_OFFSET, path.c_str() + s, len);
+  }
+
+  this->_pool.insert(this->_pool.end(), path.c_str() + s, path.c_str() + s + len);
+
+  uint32_t index = this->_entry.size();
+
+  this->_entry.push_back(entry);
+
+  // chain with entries of same hash, keeping insertion order
+  std::pair<std::unordered_map<uint64_t, uint32_t>::iterator, bool> ins;
+  ins = this->_hash_map.insert(std::make_pair(entry.hash, index));
+
+  if(!ins.second) {
+    uint32_t last = ins.first->second;
+    while(this->_entry[last].next != __NO_NODE)
+      last = this->_entry[last].next;
+    this->_entry[last].next = index;
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmModEntry_t OmModEntryTable::operator[](size_t i) const
+{
+  const _entry_t& entry = this->_entry[i];
+
+  OmModEntry_t view;
+  view.attr = entry.attr;
+  view.cdid = entry.cdid;
+
+  this->_get_path(entry.parent, this->_pool.data() + entry.name_off, entry.name_len, &view.path);
+
+  return view;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmModEntryTable::path(size_t i) const
+{
+  OmWString path;
+
+  this->getPath(i, &path);
+
+  return path;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModEntryTable::getPath(size_t i, OmWString* path) const
+{
+  const _entry_t& entry = this->_entry[i];
+
+  this->_get_path(entry.parent, this->_pool.data() + entry.name_off, entry.name_len, path);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t OmModEntryTable::indexOf(const OmWString& path, int32_t attr) const
+{
+  OmWString entry_path;
+
+  // only entries with the same hash are compared
+  for(int32_t i = this->firstOfHash(OmModEntryTable::hashPath(path)); i >= 0; i = this->nextOfHash(i)) {
+
+    if(this->_entry[i].attr != attr)
+      continue;
+
+    this->getPath(i, &entry_path);
+
+    if(entry_path == path)
+      return i;
+  }
+
+  return -1;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t OmModEntryTable::firstOfHash(uint64_t hash) const
+{
+  std::unordered_map<uint64_t, uint32_t>::const_iterator it = this->_hash_map.find(hash);
+
+  if(it == this->_hash_map.end())
+    return -1;
+
+  return it->second;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t OmModEntryTable::nextOfHash(size_t i) const
+{
+  uint32_t next = this->_entry[i].next;
+
+  return (next != __NO_NODE) ? static_cast<int32_t>(next) : -1;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModEntryTable::clear()
+{
+  // swap with empty containers to actually release memory
+  std::vector<_entry_t>().swap(this->_entry);
+  std::vector<_node_t>().swap(this->_node);
+  std::vector<wchar_t>().swap(this->_pool);
+  this->_node_map.clear();
+  std::unordered_map<uint64_t, uint32_t>().swap(this->_hash_map);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModEntryTable::swap(OmModEntryTable& other)
+{
+  this->_entry.swap(other._entry);
+  this->_node.swap(other._node);
+  this->_pool.swap(other._pool);
+  this->_node_map.swap(other._node_map);
+  this->_hash_map.swap(other._hash_map);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint64_t OmModEntryTable::hashPath(const OmWString& path)
+{
+  return __hash_upper(__FNV_OFFSET, path.c_str(), path.size());
+}
@@ -16,6 +16,7 @@
 */
 #include "OmBase.h"
 #include <algorithm>            //< std::sort
+#include <ctime>
 
 #include "OmBaseApp.h"
 
@@ -29,6 +30,8 @@
 #include "OmUtilErr.h"
 #include "OmUtilStr.h"
 #include "OmUtilWin.h"
+#include "OmUtilThd.h"
+#include "OmUtilPlt.h"
 
 #include <commctrl.h>           //< ExtractIconW
 
@@ -59,6 +62,7 @@ OmModHub::OmModHub(OmModMan* ModMan) :
   _psexec_progress_cb(nullptr),
   _psexec_result_cb(nullptr),
   _psexec_user_ptr(nullptr),
+  _chnops_abort(false),
   _presets_quietmode(true),
   _layout_channels_show(true),
   _layout_channels_span(70),
@@ -85,7 +89,7 @@ void OmModHub::close()
 {
   if(this->_psexec_hth) {
     this->_psexec_abort = true;
-    WaitForSingleObject(this->_psexec_hth, 1000);
+    Om_pltThreadWait(this->_psexec_hth, 1000);
   }
 
   this->_modlib_notify_cb = nullptr;
@@ -94,7 +98,7 @@ void OmModHub::close()
   this->_netlib_notify_cb = nullptr;
   this->_netlib_notify_ptr = nullptr;
 
-  Om_threadClear(this->_psexec_hth, this->_psexec_hwo);
+  Om_pltThreadClear(this->_psexec_hth, this->_psexec_hwo);
   this->_psexec_hth = nullptr;
   this->_psexec_hwo = nullptr;
 
@@ -160,6 +164,9 @@ bool OmModHub::open(const OmWString& path, bool defer)
     return false;
   }
 
+  // settings changes are coalesced and written in background
+  this->_xml.setWriteBehind(OM_XMLCONF_DELAY);
+
   // right now this Mod Hub appear usable, even if it is empty
   this->_path = path;
   this->_home = Om_getDirPart(path);
@@ -267,7 +274,8 @@ bool OmModHub::load()
 
         OmModChan* ModChan = new OmModChan(this);
 
-        if(ModChan->open(files[j])) {
+        // library is loaded once channel is selected
+        if(ModChan->open(files[j], true)) {
           this->_channel_list.push_back(ModChan);
           break;
         } else {
@@ -469,6 +477,9 @@ OmResult OmModHub::deleteChannel(size_t index, Om_progressCb progress_cb, void*
 
   OmModChan* ModChan = this->_channel_list[index];
 
+  // library is required to uninstall Mods
+  ModChan->activate();
+
   // get list of installed Mod Pack
   OmPModPackArray selection;
 
@@ -597,6 +608,29 @@ void OmModHub::sortChannels()
   sort(this->_channel_list.begin(), this->_channel_list.end(), OmModHub::_compare_chn_index);
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModHub::_channel_activate(OmModChan* ModChan)
+{
+  if(!ModChan->activate())
+    return;
+
+  // Presets references to this channel library could not be checked
+  // until now, so repair them
+  for(size_t i = 0; i < this->_preset_list.size(); ++i)
+    this->_preset_list[i]->repair();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModHub::activateChannels()
+{
+  for(size_t i = 0; i < this->_channel_list.size(); ++i)
+    this->_channel_activate(this->_channel_list[i]);
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -612,6 +646,9 @@ bool OmModHub::selectChannel(int32_t index)
 
       this->_active_channel = index;
 
+      // load library if not yet done
+      this->_channel_activate(this->_channel_list[index]);
+
       // get library notifications from new channel
       this->_netlib_notify_enable(true);
       this->_modlib_notify_enable(true);
@@ -648,6 +685,9 @@ bool OmModHub::selectChannel(const OmWString& uuid)
 
       this->_active_channel = i;
 
+      // load library if not yet done
+      this->_channel_activate(this->_channel_list[i]);
+
       // get library notifications from new channel
       this->_netlib_notify_enable(true);
       this->_modlib_notify_enable(true);
@@ -1058,12 +1098,321 @@ void OmModHub::loadLayout(bool* chnlv, int* chnlv_h, bool* pstlv, int* pstlv_w,
 }
 */
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+#define MODOPS_IO_LIMIT 4
+
+/// \brief Paths nesting check
+///
+/// Checks whether the two given paths are the same or one is
+/// nested within the other.
+///
+/// \param[in] a   : First path to check
+/// \param[in] b   : Second path to check
+///
+/// \return True if paths overlap, false otherwise
+///
+static bool __paths_overlap(const OmWString& a, const OmWString& b)
+{
+  if(a.empty() || b.empty())
+    return false;
+
+  // strip trailing separator
+  size_t a_len = a.size(), b_len = b.size();
+  while(a_len > 1 && (a[a_len-1] == L'\\' || a[a_len-1] == L'/')) a_len--;
+  while(b_len > 1 && (b[b_len-1] == L'\\' || b[b_len-1] == L'/')) b_len--;
+
+  const OmWString& l = (a_len <= b_len) ? a : b; //< shortest
+  const OmWString& r = (a_len <= b_len) ? b : a; //< longest
+  size_t l_len = (a_len <= b_len) ? a_len : b_len;
+  size_t r_len = (a_len <= b_len) ? b_len : a_len;
+
+  if(!Om_namesMatches(l.substr(0, l_len), r.substr(0, l_len)))
+    return false;
+
+  // same path or longest one continues with a separator
+  return (r_len == l_len || r[l_len] == L'\\' || r[l_len] == L'/');
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModHub::channelsOverlap(const OmModChan* ModChanA, const OmModChan* ModChanB)
+{
+  if(ModChanA == ModChanB)
+    return true;
+
+  const OmWString* paths_a[3] = {&ModChanA->targetPath(), &ModChanA->libraryPath(), &ModChanA->backupPath()};
+  const OmWString* paths_b[3] = {&ModChanB->targetPath(), &ModChanB->libraryPath(), &ModChanB->backupPath()};
+
+  // library is only read, two libraries can be shared
+  for(unsigned i = 0; i < 3; ++i)
+    for(unsigned j = 0; j < 3; ++j)
+      if(!(i == 1 && j == 1) && __paths_overlap(*paths_a[i], *paths_b[j]))
+        return true;
+
+  return false;
+}
+
+/// \brief Mod Channels operations context
+///
+/// Shared context for concurrent Mod Channels operations.
+///
+typedef struct {
+  OmModHub*                 ModHub;
+  const OmModOpsArray*      operations;
+  std::vector<OmIndexArray> groups;
+  CRITICAL_SECTION          lock;
+  Om_beginCb                begin_cb;
+  Om_progressCb             progress_cb;
+  Om_resultCb               result_cb;
+  void*                     user_ptr;
+  bool                      has_error;
+  bool                      has_abort;
+  size_t                    total;      ///< Count of Mod operations of all Mod Channels
+  std::vector<size_t>       dones;      ///< Count of done Mod operations per Mod Channel
+  std::vector<uint32_t>     percent;    ///< Current Mod operation progress per Mod Channel
+} __chnops_ctx_t;
+
+/// \brief Operations index of Mod Pack
+///
+/// Finds index of the Mod Channel operations the given Mod Pack belongs to.
+///
+/// \param[in] ctx      : Mod Channels operations context
+/// \param[in] ModPack  : Mod Pack to search
+///
+/// \return Index of Mod Channel operations, or -1 if not found
+///
+static int32_t __chnops_index(const __chnops_ctx_t* ctx, const OmModPack* ModPack)
+{
+  for(size_t i = 0; i < ctx->operations->size(); ++i)
+    if(ctx->operations->at(i).ModChan == ModPack->ModChan())
+      return i;
+
+  return -1;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModHub::_chnops_begin_fn(void* ptr, uint64_t param)
+{
+  __chnops_ctx_t* ctx = static_cast<__chnops_ctx_t*>(ptr);
+
+  if(!ctx->begin_cb)
+    return;
+
+  EnterCriticalSection(&ctx->lock);
+  ctx->begin_cb(ctx->user_ptr, param);
+  LeaveCriticalSection(&ctx->lock);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModHub::_chnops_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t param)
+{
+  __chnops_ctx_t* ctx = static_cast<__chnops_ctx_t*>(ptr);
+
+  EnterCriticalSection(&ctx->lock);
+
+  OM_UNUSED(tot); OM_UNUSED(cur);
+
+  if(ctx->ModHub->_chnops_abort)
+    ctx->has_abort = true;
+
+  // each Mod Channel takes its share of global progress according
+  // its count of Mod operations
+  const OmModPack* ModPack = reinterpret_cast<const OmModPack*>(param);
+
+  int32_t index = __chnops_index(ctx, ModPack);
+  if(index >= 0)
+    ctx->percent[index] = ModPack->operationProgress();
+
+  size_t progress = 0;
+  for(size_t i = 0; i < ctx->dones.size(); ++i)
+    progress += (ctx->dones[i] * 100) + ctx->percent[i];
+
+  if(!ctx->has_abort && ctx->progress_cb)
+    if(!ctx->progress_cb(ctx->user_ptr, ctx->total * 100, progress, param))
+      ctx->has_abort = true;
+
+  bool keep_on = !ctx->has_abort;
+
+  LeaveCriticalSection(&ctx->lock);
+
+  return keep_on;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModHub::_chnops_result_fn(void* ptr, OmResult result, uint64_t param)
+{
+  __chnops_ctx_t* ctx = static_cast<__chnops_ctx_t*>(ptr);
+
+  EnterCriticalSection(&ctx->lock);
+
+  if(result == OM_RESULT_ABORT)
+    ctx->has_abort = true;
+
+  if(result == OM_RESULT_ERROR)
+    ctx->has_error = true;
+
+  int32_t index = __chnops_index(ctx, reinterpret_cast<const OmModPack*>(param));
+  if(index >= 0) {
+    ctx->dones[index]++;
+    ctx->percent[index] = 0;
+  }
+
+  if(ctx->result_cb)
+    ctx->result_cb(ctx->user_ptr, result, param);
+
+  LeaveCriticalSection(&ctx->lock);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModHub::_chnops_job_fn(void* ptr, size_t index, unsigned worker)
+{
+  OM_UNUSED(worker);
+
+  __chnops_ctx_t* ctx = static_cast<__chnops_ctx_t*>(ptr);
+
+  const OmIndexArray& group = ctx->groups[index];
+
+  // Mod Channels of the same group share storage, they are processed in
+  // sequence, restores first then installs
+  for(size_t i = 0; i < group.size(); ++i) {
+
+    const OmModOps_t& ops = ctx->operations->at(group[i]);
+
+    OmModChan* ModChan = ops.ModChan;
+
+    if(ctx->has_abort || ctx->ModHub->_chnops_abort)
+      break;
+
+    // checks for proper access on all required directories, error
+    // is logged by Mod Channel
+    if(!ModChan->accessesTarget() || !ModChan->accessesLibrary() || !ModChan->accessesBackup()) {
+      EnterCriticalSection(&ctx->lock);
+      ctx->has_error = true;
+      LeaveCriticalSection(&ctx->lock);
+      continue;
+    }
+
+    OmResult result = OM_RESULT_OK;
+
+    if(ops.restores.size())
+      result = ModChan->execModOps(ops.restores, OmModHub::_chnops_begin_fn, OmModHub::_chnops_progress_fn, OmModHub::_chnops_result_fn, ctx);
+
+    if(result != OM_RESULT_ABORT && ops.installs.size())
+      result = ModChan->execModOps(ops.installs, OmModHub::_chnops_begin_fn, OmModHub::_chnops_progress_fn, OmModHub::_chnops_result_fn, ctx);
+
+    if(result == OM_RESULT_ABORT) {
+      EnterCriticalSection(&ctx->lock);
+      ctx->has_abort = true;
+      LeaveCriticalSection(&ctx->lock);
+    }
+  }
+
+  return !ctx->has_abort;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModHub::execModOps(const OmModOpsArray& operations, Om_beginCb begin_cb, Om_progressCb progress_cb, Om_resultCb result_cb, void* user_ptr, unsigned io_limit)
+{
+  if(operations.empty())
+    return OM_RESULT_OK;
+
+  clock_t time = clock();
+
+  __chnops_ctx_t ctx;
+  ctx.ModHub = this;
+  ctx.operations = &operations;
+  ctx.begin_cb = begin_cb;
+  ctx.progress_cb = progress_cb;
+  ctx.result_cb = result_cb;
+  ctx.user_ptr = user_ptr;
+  ctx.has_error = false;
+  ctx.has_abort = false;
+  ctx.total = 0;
+  ctx.dones.assign(operations.size(), 0);
+  ctx.percent.assign(operations.size(), 0);
+
+  for(size_t i = 0; i < operations.size(); ++i)
+    ctx.total += operations[i].restores.size() + operations[i].installs.size();
+
+  // group Mod Channels which share storage, groups are merged each time
+  // a Mod Channel overlaps several of them
+  for(size_t i = 0; i < operations.size(); ++i) {
+
+    OmIndexArray merged(1, i);
+
+    for(size_t g = 0; g < ctx.groups.size(); ) {
+
+      bool overlap = false;
+
+      for(size_t k = 0; k < ctx.groups[g].size(); ++k) {
+        if(OmModHub::channelsOverlap(operations[i].ModChan, operations[ctx.groups[g][k]].ModChan)) {
+          overlap = true; break;
+        }
+      }
+
+      if(overlap) {
+        // keep Mod Channels in given order within the group
+        merged.insert(merged.begin(), ctx.groups[g].begin(), ctx.groups[g].end());
+        ctx.groups.erase(ctx.groups.begin() + g);
+      } else {
+        ++g;
+      }
+    }
+
+    std::sort(merged.begin(), merged.end());
+    ctx.groups.push_back(merged);
+  }
+
+  this->_chnops_abort = false;
+
+  InitializeCriticalSection(&ctx.lock);
+
+  Om_parallelFor(ctx.groups.size(), OmModHub::_chnops_job_fn, &ctx, io_limit ? io_limit : MODOPS_IO_LIMIT);
+
+  DeleteCriticalSection(&ctx.lock);
+
+  // making report
+  wchar_t done_str[64];
+  swprintf(done_str, 64, L"%u channel(s) in %u group(s) done in %.2fs", static_cast<unsigned>(operations.size()),
+           static_cast<unsigned>(ctx.groups.size()), (double)(clock()-time)/CLOCKS_PER_SEC);
+  this->_log(OM_LOG_OK, L"execModOps", done_str);
+
+  if(ctx.has_abort)
+    return OM_RESULT_ABORT;
+
+  return ctx.has_error ? OM_RESULT_ERROR : OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModHub::abortModOps()
+{
+  this->_chnops_abort = true;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 void OmModHub::abortPresets()
 {
   this->_psexec_abort = true;
+
+  // Mod operations may be performed by Mod Hub itself
+  this->_chnops_abort = true;
 }
 
 ///
@@ -1071,6 +1420,9 @@ void OmModHub::abortPresets()
 ///
 void OmModHub::queuePresets(OmModPset* ModPset, Om_beginCb begin_cb, Om_progressCb progress_cb, Om_resultCb result_cb, void* user_ptr)
 {
+  // Presets setup involves all channels libraries
+  this->activateChannels();
+
   if(this->_psexec_queue.empty()) {
 
     this->_psexec_begin_cb = begin_cb;
@@ -1105,24 +1457,24 @@ void OmModHub::queuePresets(OmModPset* ModPset, Om_beginCb begin_cb, Om_progress
   if(!this->_psexec_hth) {
 
     // launch thread
-    this->_psexec_hth = Om_threadCreate(OmModHub::_psexec_run_fn, this);
-    this->_psexec_hwo = Om_threadWaitEnd(this->_psexec_hth, OmModHub::_psexec_end_fn, this);
+    this->_psexec_hth = Om_pltThreadCreate(OmModHub::_psexec_run_fn, this);
+    this->_psexec_hwo = Om_pltThreadWatch(this->_psexec_hth, OmModHub::_psexec_end_fn, this);
   }
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-DWORD WINAPI OmModHub::_psexec_run_fn(void* ptr)
+uint32_t OmModHub::_psexec_run_fn(void* ptr)
 {
   OmModHub* self = static_cast<OmModHub*>(ptr);
-  DWORD exit_code = 0;
+  uint32_t exit_code = 0;
 
   #ifdef DEBUG
   std::wcout << "DEBUG => OmModHub::_psexec_run_fn : enter\n";
   #endif // DEBUG
 
-  OmPModPackArray entrylist, installs, restores;
+  OmPModPackArray entrylist, installs;
 
   while(self->_psexec_queue.size()) {
 
@@ -1149,58 +1501,65 @@ DWORD WINAPI OmModHub::_psexec_run_fn(void* ptr)
 
     OmResult result = OM_RESULT_OK;
 
-    // perform setup for each existing Mod Channel
+    // Mod operations are performed here, concurrently for Mod Channels
+    // that do not share storage, client is reported global progress
+    OmModOpsArray operations;
+
     for(size_t i = 0; i < self->_channel_list.size(); ++i) {
 
       OmModChan* ModChan = self->_channel_list[i];
 
+      // Channel is processing operations started elsewhere
+      if(ModChan->lockedModLibrary()) {
+        self->_log(OM_LOG_WRN, L"_psexec_run_fn", L"Channel \""+ModChan->title()+L"\": Mod library is locked by another operation, skipped");
+        result = OM_RESULT_ERROR;
+        continue;
+      }
+
       entrylist.clear();
       ModPset->getSetupEntryList(ModChan, &entrylist);
 
-      installs.clear();
-      restores.clear();
-
-      for(size_t j = 0; j < ModChan->modpackCount(); ++j) {
+      OmModOps_t ops;
+      ops.ModChan = ModChan;
 
-        OmModPack* ModPack = ModChan->getModpack(j);
+      // compute minimal transition from current state
+      ModChan->preparePreset(entrylist, ModPset->installOnly(), &ops.restores, &ops.installs);
 
-        if(Om_arrayContain(entrylist, ModPack)) {
-
-          // add to the installs list
-          if(!ModPack->hasBackup())
-            installs.push_back(ModPack);
-
-        } else {
+      // apply Channel install policy, as it would be for silent user install
+      OmWStringArray overlaps, depends, missings, conflicts;
+      installs.clear();
+      ModChan->prepareInstalls(ops.installs, &installs, &overlaps, &depends, &missings, &conflicts);
 
-          // add to the restores list
-          if(!ModPset->installOnly() && ModPack->hasBackup())
-            restores.push_back(ModPack);
-        }
+      if(conflicts.size()) {
+        self->_log(OM_LOG_WRN, L"_psexec_run_fn", L"Channel \""+ModChan->title()+L"\": conflicting Mods in No-Overlapping mode, skipped");
+        result = OM_RESULT_ERROR;
+        continue;
       }
 
-      if(self->_psexec_progress_cb) {
+      // operations run in worker threads where no dialog can be shown,
+      // warnings the user did not silence are logged instead
+      if(!self->_presets_quietmode) {
+        if(missings.size())
+          self->_log(OM_LOG_WRN, L"_psexec_run_fn", L"Channel \""+ModChan->title()+L"\": missing dependencies: "+Om_concatStrings(missings, L", "));
+        if(depends.size())
+          self->_log(OM_LOG_WRN, L"_psexec_run_fn", L"Channel \""+ModChan->title()+L"\": extra dependencies installed: "+Om_concatStrings(depends, L", "));
+        if(overlaps.size())
+          self->_log(OM_LOG_WRN, L"_psexec_run_fn", L"Channel \""+ModChan->title()+L"\": overlapped Mods: "+Om_concatStrings(overlaps, L", "));
+      }
 
-        size_t tot, cur;
+      ops.installs.swap(installs);
 
-        tot = 0; cur = restores.size();
-        // we send restores fisrt
-        for(size_t j = 0; j < restores.size(); ++j)
-          if(!self->_psexec_progress_cb(self->_psexec_user_ptr, tot, cur--, reinterpret_cast<uint64_t>(restores[j]))) {
-            self->abortPresets(); break;
-          }
+      if(ops.restores.size() || ops.installs.size())
+        operations.push_back(ops);
+    }
 
-        tot = installs.size(); cur = 0;
-        // then send installs
-        for(size_t j = 0; j < installs.size(); ++j)
-          if(!self->_psexec_progress_cb(self->_psexec_user_ptr, tot, ++cur, reinterpret_cast<uint64_t>(installs[j]))) {
-            self->abortPresets(); break;
-          }
-      }
+    OmResult exec_result = self->execModOps(operations, nullptr, self->_psexec_progress_cb, nullptr, self->_psexec_user_ptr);
+    if(exec_result != OM_RESULT_OK)
+      result = exec_result;
 
-      if(self->_psexec_abort) {
-        result = OM_RESULT_ABORT; break;
-      }
-    }
+    // client aborted, flush remaining queue
+    if(result == OM_RESULT_ABORT)
+      self->_psexec_abort = true;
 
     if(self->_psexec_result_cb)
       self->_psexec_result_cb(self->_psexec_user_ptr, result, reinterpret_cast<uint64_t>(ModPset));
@@ -1221,7 +1580,7 @@ DWORD WINAPI OmModHub::_psexec_run_fn(void* ptr)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-VOID WINAPI OmModHub::_psexec_end_fn(void* ptr,uint8_t fired)
+void OmModHub::_psexec_end_fn(void* ptr,uint8_t fired)
 {
   OM_UNUSED(fired);
 
@@ -1232,7 +1591,7 @@ VOID WINAPI OmModHub::_psexec_end_fn(void* ptr,uint8_t fired)
   #endif // DEBUG
 
   //DWORD exit_code = Om_threadExitCode(self->_install_hth);
-  Om_threadClear(self->_psexec_hth, self->_psexec_hwo);
+  Om_pltThreadClear(self->_psexec_hth, self->_psexec_hwo);
 
   self->_psexec_dones = 0;
   self->_psexec_percent = 0;
@@ -30,6 +30,8 @@
 #include "OmUtilDlg.h"
 #include "OmUtilErr.h"
 #include "OmUtilSys.h"
+#include "OmUtilThd.h"
+#include "OmUtilPrf.h"
 
 #include "OmDialog.h"
 
@@ -39,6 +41,16 @@
 #include "OmModMan.h"
 
 
+/// \brief Log queue slot
+///
+/// Slot of the log entries queue. Sequence number tells whether
+/// slot is free for producers or holds an entry for the writer.
+///
+typedef struct {
+  volatile LONG   seq;
+  OmWString       entry;
+} __log_slot_t;
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -49,11 +61,32 @@ OmModMan::OmModMan() :
   _netlib_notify_cb(nullptr),
   _netlib_notify_ptr(nullptr),
   _log_hfile(nullptr),
+  _log_queue(nullptr),
+  _log_head(0),
+  _log_drops(0),
+  _log_tail(0),
+  _log_hth(nullptr),
+  _log_hev(nullptr),
+  _log_hidle(nullptr),
+  _log_quit(false),
   _icon_size(16),
   _no_markdown(false),
-  _link_confirm(true)
+  _link_confirm(true),
+  _perf_trace(false)
 {
+  InitializeCriticalSection(&this->_log_lock);
+
+  // create log queue, each slot sequence is initialized to its index
+  __log_slot_t* queue = new __log_slot_t[OM_MANAGER_LOG_QUEUE];
+  for(LONG i = 0; i < OM_MANAGER_LOG_QUEUE; ++i)
+    queue[i].seq = i;
 
+  this->_log_queue = queue;
+
+  // start log writer
+  this->_log_hev = CreateEventW(nullptr, false, false, nullptr);
+  this->_log_hidle = CreateEventW(nullptr, true, true, nullptr);
+  this->_log_hth = Om_threadCreate(OmModMan::_log_run_fn, this);
 }
 
 ///
@@ -64,6 +97,24 @@ OmModMan::~OmModMan()
   for(size_t i = 0; i < this->_hub_list.size(); ++i)
     delete this->_hub_list[i];
 
+  // stop log writer, remaining entries are written before it quits
+  if(this->_log_hth) {
+    this->_log_quit = true;
+    SetEvent(this->_log_hev);
+    WaitForSingleObject(this->_log_hth, INFINITE);
+    CloseHandle(this->_log_hth);
+  }
+
+  if(this->_log_hev)
+    CloseHandle(this->_log_hev);
+
+  if(this->_log_hidle)
+    CloseHandle(this->_log_hidle);
+
+  delete [] static_cast<__log_slot_t*>(this->_log_queue);
+
+  DeleteCriticalSection(&this->_log_lock);
+
   // close log file
   if(this->_log_hfile) {
     CloseHandle(this->_log_hfile);
@@ -119,7 +170,7 @@ bool OmModMan::init(const char* arg)
 
     this->_log(OM_LOG_WRN, L"Manager.init", L"missing configuration file, create new one");
 
-    this->_xml.init(OM_XMAGIC_APP);
+    this->_xml.init(conf_path, OM_XMAGIC_APP);
 
     if(!this->_xml.save(conf_path)) {
       // this is not a fatal error, but this will surely be a problem...
@@ -132,6 +183,9 @@ bool OmModMan::init(const char* arg)
     this->setIconsSize(this->_icon_size);
   }
 
+  // settings changes are coalesced and written in background
+  this->_xml.setWriteBehind(OM_XMLCONF_DELAY);
+
   // load saved parameters
   if(this->_xml.hasChild(L"icon_size")) {
     this->_icon_size = this->_xml.child(L"icon_size").attrAsInt(L"pixels");
@@ -153,6 +207,15 @@ bool OmModMan::init(const char* arg)
     this->setLinkConfirm(this->_link_confirm); //< set default
   }
 
+  // load saved performance trace option
+  if(this->_xml.hasChild(L"perf_trace")) {
+    this->_perf_trace = this->_xml.child(L"perf_trace").attrAsInt(L"enable");
+  } else {
+    this->setPerfTrace(this->_perf_trace); //< set default
+  }
+
+  Om_perfEnable(this->_perf_trace);
+
   // load startup Mod Hub files if any
   bool autoload;
   OmWStringArray path_ls;
@@ -337,6 +400,18 @@ bool OmModMan::quit()
 
   this->_hub_list.clear();
 
+  // write pending configuration changes
+  this->_xml.flush();
+
+  // write recorded performance spans
+  if(this->_perf_trace) {
+    if(Om_perfSaveTrace(Om_concatPaths(this->_home, L"perf_trace.json"))) {
+      this->_log(OM_LOG_OK, L"Manager.quit", L"performance trace saved");
+    } else {
+      this->_log(OM_LOG_WRN, L"Manager.quit", L"unable to save performance trace");
+    }
+  }
+
   this->_log(OM_LOG_OK, L"Manager.quit", L"goodbye");
 
   return true;
@@ -756,6 +831,30 @@ void OmModMan::setLinkConfirm(bool enable)
   this->_xml.save();
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModMan::setPerfTrace(bool enable)
+{
+  this->_perf_trace = enable;
+
+  Om_perfEnable(this->_perf_trace);
+
+  if(!this->_xml.valid())
+    return;
+
+  if(this->_xml.hasChild(L"perf_trace")) {
+
+    this->_xml.child(L"perf_trace").setAttr(L"enable", (int)this->_perf_trace);
+
+  } else {
+
+    this->_xml.addChild(L"perf_trace").setAttr(L"enable", (int)this->_perf_trace);
+  }
+
+  this->_xml.save();
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -1050,8 +1149,15 @@ void OmModMan::notifyNetLibraryStop()
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModMan::addLogNotify(Om_notifyCb notify_cb, void* user_ptr)
+void OmModMan::addLogNotify(Om_notifyCb notify_cb, void* user_ptr, OmWString* current_log)
 {
+  EnterCriticalSection(&this->_log_lock);
+
+  // in-memory log and callbacks list are updated together by writer, the
+  // current log holds exactly what was notified before registration
+  if(current_log)
+    *current_log = this->_log_str;
+
   if(!Om_arrayContain(this->_log_notify_cb, notify_cb)) {
 
     this->_log_notify_cb.push_back(notify_cb);
@@ -1059,6 +1165,8 @@ void OmModMan::addLogNotify(Om_notifyCb notify_cb, void* user_ptr)
     this->_log_user_ptr.push_back(user_ptr);
 
   }
+
+  LeaveCriticalSection(&this->_log_lock);
 }
 
 
@@ -1067,6 +1175,8 @@ void OmModMan::addLogNotify(Om_notifyCb notify_cb, void* user_ptr)
 ///
 void OmModMan::removeLogNotify(Om_notifyCb notify_cb)
 {
+  EnterCriticalSection(&this->_log_lock);
+
   for(size_t i = 0; i < this->_log_notify_cb.size(); ++i) {
 
     if(this->_log_notify_cb[i] == notify_cb) {
@@ -1078,6 +1188,154 @@ void OmModMan::removeLogNotify(Om_notifyCb notify_cb)
       break;
     }
   }
+
+  LeaveCriticalSection(&this->_log_lock);
+
+  // removed callback may still be running from writer thread, wait for it
+  // unless we are called from the callback itself
+  if(GetCurrentThreadId() == GetThreadId(this->_log_hth))
+    return;
+
+  // callbacks commonly send messages to window of calling thread, those
+  // must be processed while waiting or both threads would be stuck
+  while(MsgWaitForMultipleObjects(1, &this->_log_hidle, false, INFINITE, QS_SENDMESSAGE) == WAIT_OBJECT_0 + 1) {
+    MSG msg;
+    PeekMessageW(&msg, nullptr, 0, 0, PM_NOREMOVE|PM_QS_SENDMESSAGE);
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmModMan::currentLog()
+{
+  EnterCriticalSection(&this->_log_lock);
+  OmWString log_str = this->_log_str;
+  LeaveCriticalSection(&this->_log_lock);
+
+  return log_str;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModMan::_log_drain(OmWString* batch)
+{
+  __log_slot_t* queue = static_cast<__log_slot_t*>(this->_log_queue);
+
+  // single consumer, take every published entry in order
+  while(true) {
+
+    __log_slot_t* slot = &queue[this->_log_tail & (OM_MANAGER_LOG_QUEUE - 1)];
+
+    if(slot->seq != this->_log_tail + 1)
+      break;
+
+    batch->append(slot->entry);
+    slot->entry.clear();
+
+    // release slot for next round
+    InterlockedExchange(&slot->seq, this->_log_tail + OM_MANAGER_LOG_QUEUE);
+
+    this->_log_tail++;
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+DWORD WINAPI OmModMan::_log_run_fn(void* ptr)
+{
+  OmModMan* self = static_cast<OmModMan*>(ptr);
+
+  OmWString batch, pending;
+
+  OmNotifyCbArray notify_cb;
+  OmPVoidArray user_ptr;
+
+  uint64_t last_notify = 0;
+
+  LONG drops = 0;
+
+  while(true) {
+
+    // wait for signal or timeout, timeout also rules notifications rate
+    WaitForSingleObject(self->_log_hev, OM_MANAGER_LOG_DELAY);
+
+    bool quit = self->_log_quit;
+
+    batch.clear();
+    self->_log_drain(&batch);
+
+    // report dropped entries once queue was drained
+    LONG new_drops = self->_log_drops;
+    if(new_drops != drops) {
+
+      int t_h, t_m, t_s;
+      Om_getTime(&t_s, &t_m, &t_h);
+
+      wchar_t line[128];
+      swprintf(line, 128, L"[%02d:%02d:%02d] ! Manager.log: %lu log entries dropped (queue full)\r\n",
+               t_h, t_m, t_s, static_cast<ULONG>(new_drops - drops));
+
+      batch += line;
+      drops = new_drops;
+    }
+
+    if(!batch.empty()) {
+
+      // write to log file, once for the whole batch
+      if(self->_log_hfile) {
+
+        DWORD wb;
+
+        OmCString utf8_batch = Om_toUTF8(batch);
+
+        WriteFile(self->_log_hfile, utf8_batch.c_str(), utf8_batch.size(), &wb, nullptr);
+      }
+
+      pending += batch;
+    }
+
+    // send new logs to callback functions, at limited rate
+    uint64_t now = GetTickCount64();
+
+    if(!pending.empty() && (quit || now - last_notify >= OM_MANAGER_LOG_DELAY)) {
+
+      // callbacks are called outside lock so they can freely interact
+      // with other threads, the idle event is reset within the lock so
+      // removeLogNotify knows a removed callback may still be running
+      EnterCriticalSection(&self->_log_lock);
+
+      // in-memory log is updated along with callbacks list, so addLogNotify
+      // can supply exactly what was notified before registration
+      self->_log_str += pending;
+
+      // keep in-memory log bounded, cut at line boundary
+      if(self->_log_str.size() > OM_MANAGER_LOG_TAIL) {
+        size_t cut = self->_log_str.find(L'\n', self->_log_str.size() - OM_MANAGER_LOG_TAIL);
+        self->_log_str.erase(0, (cut != OmWString::npos) ? cut + 1 : self->_log_str.size() - OM_MANAGER_LOG_TAIL);
+      }
+
+      notify_cb = self->_log_notify_cb;
+      user_ptr = self->_log_user_ptr;
+      ResetEvent(self->_log_hidle);
+      LeaveCriticalSection(&self->_log_lock);
+
+      for(size_t i = 0; i < notify_cb.size(); ++i)
+        notify_cb[i](user_ptr[i], OM_NOTIFY_CREATED, reinterpret_cast<uint64_t>(pending.c_str()));
+
+      SetEvent(self->_log_hidle);
+
+      pending.clear();
+      last_notify = now;
+    }
+
+    if(quit)
+      break;
+  }
+
+  return 0;
 }
 
 ///
@@ -1115,21 +1373,50 @@ void OmModMan::_log(unsigned level, const OmWString& origin, const OmWString& de
   std::wcout << log_entry; //< print to standard output
   #endif
 
-  // send new log to callback functions
-  for(size_t i = 0; i < this->_log_notify_cb.size(); ++i)
-    this->_log_notify_cb[i](this->_log_user_ptr[i], OM_NOTIFY_CREATED, reinterpret_cast<uint64_t>(log_entry.c_str()));
+  __log_slot_t* queue = static_cast<__log_slot_t*>(this->_log_queue);
+  __log_slot_t* slot;
 
-  // write to log file
-  if(this->_log_hfile) {
+  // reserve a slot in queue, multiple producers compete for head position
+  LONG pos = this->_log_head;
+
+  while(true) {
+
+    slot = &queue[pos & (OM_MANAGER_LOG_QUEUE - 1)];
+
+    LONG dif = static_cast<LONG>(static_cast<ULONG>(slot->seq) - static_cast<ULONG>(pos));
+
+    if(dif == 0) {
+
+      // slot is free, try to take it
+      LONG cur = InterlockedCompareExchange(&this->_log_head, pos + 1, pos);
+      if(cur == pos)
+        break;
 
-    DWORD wb;
+      pos = cur;
 
-    OmCString utf8_entry = Om_toUTF8(log_entry);
+    } else if(dif < 0) {
 
-    WriteFile(this->_log_hfile, utf8_entry.c_str(), utf8_entry.size(), &wb, nullptr);
+      // queue is full, drop entry rather than waiting for the writer, which
+      // may itself be waiting for this thread through a notify callback
+      InterlockedIncrement(&this->_log_drops);
+      SetEvent(this->_log_hev);
+      return;
+
+    } else {
+
+      // taken by another producer
+      pos = this->_log_head;
+    }
   }
 
-  this->_log_str += log_entry;
+  slot->entry.swap(log_entry);
+
+  // publish entry
+  InterlockedExchange(&slot->seq, pos + 1);
+
+  // errors are written without delay
+  if(level == OM_LOG_ERR)
+    SetEvent(this->_log_hev);
 }
 
 ///
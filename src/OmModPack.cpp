@@ -25,7 +25,11 @@
 #include "OmUtilHsh.h"
 #include "OmUtilPkg.h"
 #include "OmUtilB64.h"
+#include "OmUtilThd.h"
+#include "OmUtilPrf.h"
+#include "OmUtilPlt.h"
 #include <ctime>
+#include <algorithm>            //< std::max
 
 #include "OmModChan.h"
 
@@ -37,6 +41,8 @@
 #define SAVEAS_README_NAME      L"readme.md"
 #define SAVEAS_MODDEF_NAME      L"modpack.xml"
 
+#define OM_RESTORE_PARALLEL_MIN 32    //< minimum entries count to restore using workers
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -98,6 +104,7 @@ void OmModPack::clearAll()
 
   // General properties
   this->_iden.clear();
+  this->_iden_key.clear();
   this->_hash = 0;
   this->_core.clear();
   this->_name.clear();
@@ -173,11 +180,12 @@ void OmModPack::clearSource()
   this->_src_isdir = false;
   this->_src_root.clear();
   this->_src_entry.clear();
-  this->_src_depend.clear();
+  this->_depend_clear();
   this->_src_depend_time = 0;
 
   // Optional properties liked to source
   this->_category.clear();
+  this->_category_key.clear();
   this->_description.clear();
   this->_description_time = 0;
   this->_thumbnail.clear();
@@ -187,50 +195,15 @@ void OmModPack::clearSource()
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModPack::_src_parse_dir(OmModEntryArray* entries, const OmWString& orig, const OmWString& from)
+void OmModPack::_src_parse_dir(OmModEntryTable* entries, const OmWString& path)
 {
-  OmWString item;
-  OmWString root;
-
-  OmModEntry_t entry;
-  entry.cdid = -1;
-
-  OmWString srch(orig);
-  srch += L"\\*";
-
-  WIN32_FIND_DATAW fd;
-  HANDLE hnd = FindFirstFileW(srch.c_str(), &fd);
-  if(hnd != INVALID_HANDLE_VALUE) {
-    do {
-      // skip this and parent folder
-      if(!wcscmp(fd.cFileName, L".")) continue;
-      if(!wcscmp(fd.cFileName, L"..")) continue;
-
-      // prevent leading back-slash
-      if(from.empty()) {
-        item = L"";
-      } else {
-        item = from; item += L"\\";
-      }
-
-      item += fd.cFileName;
-
-      entry.path = item;
+  // folder tree is explored by worker threads, items are given in
+  // depth-first order as entries are expected
+  OmTreeItemArray tree;
+  Om_lsTree(&tree, path, true);
 
-      if(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-
-        entry.attr = OM_MODENTRY_DIR;
-        entries->push_back(entry);
-        // go deep in tree
-        root = orig + L"\\"; root += fd.cFileName;
-        OmModPack::_src_parse_dir(entries, root, item);
-      } else {
-        entry.attr = 0;
-        entries->push_back(entry);
-      }
-    } while(FindNextFileW(hnd, &fd));
-  }
-  FindClose(hnd);
+  for(size_t i = 0; i < tree.size(); ++i)
+    entries->add(tree[i].path, tree[i].isdir ? OM_MODENTRY_DIR : 0, -1);
 }
 
 ///
@@ -238,6 +211,8 @@ void OmModPack::_src_parse_dir(OmModEntryArray* entries, const OmWString& orig,
 ///
 bool OmModPack::parseSource(const OmWString& path)
 {
+  OmPerfScope perf(L"parseSource", path);
+
   this->clearSource();
 
   bool isdir = false;
@@ -250,7 +225,7 @@ bool OmModPack::parseSource(const OmWString& path)
 
     isdir = true;
 
-    OmModPack::_src_parse_dir(&this->_src_entry, path, L"");
+    OmModPack::_src_parse_dir(&this->_src_entry, path);
     src_root = path;
 
     src_iden = Om_getFilePart(path);
@@ -315,13 +290,11 @@ bool OmModPack::parseSource(const OmWString& path)
       // search for <dependencies>
       if(source_cfg.hasChild(L"dependencies")) {
 
-        OmXmlNodeArray xml_iden_ls;
-
-        source_cfg.child(L"dependencies").children(xml_iden_ls, L"ident");
+        OmXmlNode xml_depends = source_cfg.child(L"dependencies");
 
-        for(size_t i = 0; i < xml_iden_ls.size(); ++i) {
+        for(const OmXmlNode& xml_iden : xml_depends.children(L"ident")) {
 
-          dep_iden = xml_iden_ls[i].content();
+          dep_iden = xml_iden.content();
 
           // Prevent dependency to self
           if(Om_namesMatches(this->_iden, dep_iden)) {
@@ -329,13 +302,15 @@ bool OmModPack::parseSource(const OmWString& path)
             continue;
           }
 
-          this->_src_depend.push_back(dep_iden);
+          this->_depend_add(dep_iden);
         }
       }
 
       // search for <category>
       if(source_cfg.hasChild(L"category")) {
         this->_category = source_cfg.child(L"category").content();
+        this->_category_key = this->_category;
+        Om_strToUpper(&this->_category_key);
       }
 
       // search for <description>
@@ -475,6 +450,8 @@ bool OmModPack::parseSource(const OmWString& path)
     this->_hash = src_hash;
 
     this->_iden = src_iden;
+    this->_iden_key = src_iden;
+    Om_strToUpper(&this->_iden_key);
 
     // parse other Mod common infos from identity
     OmWString vers_str;
@@ -504,6 +481,8 @@ bool OmModPack::parseSource(const OmWString& path)
 
   this->_has_src = true;
 
+  perf.addFiles(this->_src_entry.size());
+
   return true;
 }
 
@@ -530,7 +509,7 @@ bool OmModPack::parseEntries(const OmWString& path)
     this->_src_entry.clear();
 
     // Parse directory
-    OmModPack::_src_parse_dir(&this->_src_entry, path, L"");
+    OmModPack::_src_parse_dir(&this->_src_entry, path);
 
   } else {
 
@@ -573,6 +552,16 @@ bool OmModPack::refreshSource()
   return false;
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModPack::setCategory(const OmWString& cate)
+{
+  this->_category = cate;
+  this->_category_key = cate;
+  Om_strToUpper(&this->_category_key);
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -731,17 +720,20 @@ bool OmModPack::loadDirDepend()
   if(found) {
     time_t new_time = Om_itemTime(found_path);
     if(new_time != this->_src_depend_time) {
-      this->_src_depend.clear();
+      this->_depend_clear();
       // load text file data
       OmWString dep_txt;
       Om_loadToUTF16(&dep_txt, found_path);
       // split string
-      Om_splitString(dep_txt, L"\r\n", &this->_src_depend);
+      OmWStringArray dep_list;
+      Om_splitString(dep_txt, L"\r\n", &dep_list);
+      for(size_t i = 0; i < dep_list.size(); ++i)
+        this->_depend_add(dep_list[i]);
       this->_src_depend_time = new_time;
       changed = true;
     }
   } else {
-    this->_src_depend.clear();
+    this->_depend_clear();
     this->_src_depend_time = 0;
   }
 
@@ -793,21 +785,17 @@ bool OmModPack::hasDepend(const OmWString& ident) const
 ///
 bool OmModPack::matchDepend(const OmModPack* ModPack) const
 {
-  OmWString core, vers;
-
   for(size_t i = 0; i < this->_src_depend.size(); ++i) {
 
-    if(Om_parseModIdent(this->_src_depend[i], &core, &vers, nullptr)) {
-
-      if(ModPack->_core == core && ModPack->_version.match(vers))
-        return true;
-
-    } else {
+    if(ModPack->_core != this->_src_depend_core[i])
+      continue;
 
-      if(ModPack->_core == core)
-        return true;
-    }
+    // filter without version matches any version
+    if(!this->_src_depend_filter[i].valid())
+      return true;
 
+    if(this->_src_depend_filter[i].match(ModPack->_version))
+      return true;
   }
 
   return false;
@@ -818,8 +806,41 @@ bool OmModPack::matchDepend(const OmModPack* ModPack) const
 ///
 void OmModPack::deleteDepend(size_t index)
 {
-  if(index < this->_src_depend.size())
+  if(index < this->_src_depend.size()) {
     this->_src_depend.erase(this->_src_depend.begin() + index);
+    this->_src_depend_core.erase(this->_src_depend_core.begin() + index);
+    this->_src_depend_filter.erase(this->_src_depend_filter.begin() + index);
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModPack::_depend_add(const OmWString& iden)
+{
+  // identity filter is parsed once here so dependency lookups only
+  // compare core name and test precompiled version filter
+  OmWString core, vers;
+
+  this->_src_depend.push_back(iden);
+
+  if(Om_parseModIdent(iden, &core, &vers, nullptr)) {
+    this->_src_depend_filter.push_back(OmVersionFilter(vers));
+  } else {
+    this->_src_depend_filter.push_back(OmVersionFilter());
+  }
+
+  this->_src_depend_core.push_back(core);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModPack::_depend_clear()
+{
+  this->_src_depend.clear();
+  this->_src_depend_core.clear();
+  this->_src_depend_filter.clear();
 }
 
 ///
@@ -945,50 +966,40 @@ bool OmModPack::parseBackup(const OmWString& path)
     bck_hash = Om_strToUint64(backup_cfg.child(L"hash").content());
 
 
-    OmXmlNodeArray xml_node_ls;
-
     // get list of installed files, they are listed in the
     // backup definition, either as <cpy> or <del> entries.
-    backup_cfg.children(xml_node_ls, L"cpy");
-
-    for(size_t i = 0; i < xml_node_ls.size(); ++i) {
+    for(const OmXmlNode& xml_node : backup_cfg.children(L"cpy")) {
 
       OmModEntry_t entry;
-      entry.cdid = xml_node_ls[i].attrAsInt(L"cdi");
+      entry.cdid = xml_node.attrAsInt(L"cdi");
       entry.attr = 0;
-      if(xml_node_ls[i].attrAsInt(L"dir") > 0)
+      if(xml_node.attrAsInt(L"dir") > 0)
         entry.attr |= OM_MODENTRY_DIR;
-      entry.path = xml_node_ls[i].content();
+      entry.path = xml_node.content();
 
       this->_bck_entry.push_back(entry);
     }
 
-    backup_cfg.children(xml_node_ls, L"del");
-
-    for(size_t i = 0; i < xml_node_ls.size(); ++i) {
+    for(const OmXmlNode& xml_node : backup_cfg.children(L"del")) {
 
       OmModEntry_t entry;
       entry.cdid = -1;
       entry.attr = OM_MODENTRY_DEL;
-      if(xml_node_ls[i].attrAsInt(L"dir") > 0)
+      if(xml_node.attrAsInt(L"dir") > 0)
         entry.attr |= OM_MODENTRY_DIR;
       // note for me in the future, this does not work properly:
-      // entry.attr = OM_MODENTRY_DEL | (xml_node_ls[i].attrAsInt(L"dir") > 0) ? OM_MODENTRY_DIR : 0;
-      entry.path = xml_node_ls[i].content();
+      // entry.attr = OM_MODENTRY_DEL | (xml_node.attrAsInt(L"dir") > 0) ? OM_MODENTRY_DIR : 0;
+      entry.path = xml_node.content();
 
       this->_bck_entry.push_back(entry);
     }
 
     // retrieve the backup overlap list, they are stored as a list of Hash values
     // corresponding to package file name
-    if(backup_cfg.hasChild(L"overlap")) {
-
-      OmXmlNodeArray xml_hash_ls;
-      backup_cfg.child(L"overlap").children(xml_hash_ls, L"hash");
+    OmXmlNode xml_overlap = backup_cfg.child(L"overlap");
 
-      for(size_t i = 0; i < xml_hash_ls.size(); ++i)
-        this->_bck_overlap.push_back(Om_strToUint64(xml_hash_ls[i].content()));
-    }
+    for(const OmXmlNode& xml_hash : xml_overlap.children(L"hash"))
+      this->_bck_overlap.push_back(Om_strToUint64(xml_hash.content()));
 
   } else {
     this->_error(L"parseBackup", L"definition not found in location \""+path+L"\"");
@@ -1009,6 +1020,8 @@ bool OmModPack::parseBackup(const OmWString& path)
     this->_hash = bck_hash;
 
     this->_iden = bck_iden;
+    this->_iden_key = bck_iden;
+    Om_strToUpper(&this->_iden_key);
 
     // parse other Mod common infos from identity
     OmWString vers_str;
@@ -1035,13 +1048,7 @@ bool OmModPack::parseBackup(const OmWString& path)
 ///
 bool OmModPack::backupHasEntry(const OmWString& path, int32_t attr) const
 {
-  for(size_t i = 0; i < this->_bck_entry.size(); ++i) {
-    if(this->_bck_entry[i].attr == attr)
-      if(this->_bck_entry[i].path == path)
-        return true;
-  }
-
-  return false;
+  return (this->_bck_entry.indexOf(path, attr) >= 0);
 }
 
 ///
@@ -1061,10 +1068,10 @@ void OmModPack::getFootprint(OmModEntryArray* footprint) const
 
   for(size_t i = 0; i < this->_src_entry.size(); ++i) {
 
-    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), this->_src_entry[i].path);
+    this->_src_entry.getPath(i, &entry.path);
+    entry.attr = this->_src_entry.attr(i);
 
-    entry.path = this->_src_entry[i].path;
-    entry.attr = this->_src_entry[i].attr;
+    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), entry.path);
 
     if(!Om_pathExists(tgt_file))
       entry.attr |= OM_MODENTRY_DEL;
@@ -1091,19 +1098,28 @@ bool OmModPack::hasOverlap(uint64_t hash) const
 ///
 bool OmModPack::canOverlap(const OmModPack* other) const
 {
+  OmWString path, other_path;
+
   // you don't like raw loops ? I LOVE row loops...
   for(size_t i = 0; i < this->_src_entry.size(); ++i) {
 
-    if(OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR)) //< we don't care directories
+    if(OM_HAS_BIT(this->_src_entry.attr(i), OM_MODENTRY_DIR)) //< we don't care directories
       continue;
 
-    for(size_t j = 0; j < other->_src_entry.size(); ++j) {
+    // paths hashes are case-insensitive, only entries with same hash can
+    // match, they are found through the other table hash index
+    int32_t j = other->_src_entry.firstOfHash(this->_src_entry.hash(i));
 
-      if(OM_HAS_BIT(other->_src_entry[j].attr, OM_MODENTRY_DIR)) //< we don't care directories
+    for(; j >= 0; j = other->_src_entry.nextOfHash(j)) {
+
+      if(OM_HAS_BIT(other->_src_entry.attr(j), OM_MODENTRY_DIR)) //< we don't care directories
         continue;
 
+      this->_src_entry.getPath(i, &path);
+      other->_src_entry.getPath(j, &other_path);
+
       // same path mean overlap
-      if(Om_namesMatches(this->_src_entry[i].path, other->_src_entry[j].path))
+      if(Om_namesMatches(path, other_path))
         return true;
     }
   }
@@ -1116,19 +1132,27 @@ bool OmModPack::canOverlap(const OmModPack* other) const
 ///
 bool OmModPack::canOverlap(const OmModEntryArray& footprint) const
 {
+  OmWString path;
+
   // you don't like raw loops ? I LOVE row loops...
-  for(size_t i = 0; i < this->_src_entry.size(); ++i) {
+  for(size_t j = 0; j < footprint.size(); ++j) {
 
-    if(OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR)) //< we don't care directories
+    if(OM_HAS_BIT(footprint[j].attr, OM_MODENTRY_DIR)) //< we don't care directories
       continue;
 
-    for(size_t j = 0; j < footprint.size(); ++j) {
+    // only entries with same path hash can match, they are found through
+    // the table hash index
+    int32_t i = this->_src_entry.firstOfHash(OmModEntryTable::hashPath(footprint[j].path));
 
-      if(OM_HAS_BIT(footprint[j].attr, OM_MODENTRY_DIR)) //< we don't care directories
+    for(; i >= 0; i = this->_src_entry.nextOfHash(i)) {
+
+      if(OM_HAS_BIT(this->_src_entry.attr(i), OM_MODENTRY_DIR)) //< we don't care directories
         continue;
 
+      this->_src_entry.getPath(i, &path);
+
       // same path mean overlap
-      if(this->_src_entry[i].path == footprint[j].path)
+      if(path == footprint[j].path)
         return true;
     }
   }
@@ -1162,6 +1186,10 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
   // initialize chrono
   clock_t time = clock();
 
+  // performance span, processed entries are counted at start
+  OmPerfScope perf(L"backup", this->_iden);
+  perf.addFiles(this->_src_entry.size());
+
   // initialize progression callback
   size_t progress_tot = 0, progress_cur = 0;
   if(progress_cb) {
@@ -1227,8 +1255,8 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
   for(size_t i = 0, z = 0; i < this->_src_entry.size(); ++i) {
 
     OmModEntry_t entry;
-    entry.path = this->_src_entry[i].path;
-    entry.attr = this->_src_entry[i].attr;
+    this->_src_entry.getPath(i, &entry.path);
+    entry.attr = this->_src_entry.attr(i);
     entry.cdid = -1; //< invalid zip central-directory index
 
     Om_concatPaths(tgt_file, this->_ModChan->targetPath(), entry.path);
@@ -1330,7 +1358,7 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
     }
 
     #ifdef DEBUG
-    Sleep(50); //< for debug
+    Om_pltSleep(50); //< for debug
     #endif
   }
 
@@ -1403,6 +1431,190 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
   return OM_RESULT_OK;
 }
 
+/// \brief Restore context
+///
+/// Structure shared by workers during Backup data restoration
+///
+typedef struct {
+
+  OmModPack*        ModPack;
+
+  OmIndexArray      restore_ls;
+
+  OmIndexArray      delete_ls;
+
+  OmIndexArray      rmdir_ls;
+
+  OmArchive*        zips;
+
+  Om_progressCb     progress_cb;
+
+  void*             user_ptr;
+
+  size_t            progress_tot;
+
+  size_t            progress_cur;
+
+  bool              isundo;
+
+  bool              has_error;
+
+  bool              has_abort;
+
+  void*             lock;
+
+} __restore_ctx_t;
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModPack::_restore_progress(void* ptr)
+{
+  __restore_ctx_t* ctx = static_cast<__restore_ctx_t*>(ptr);
+
+  // must be called within context lock
+  if(ctx->progress_cb) {
+    if(ctx->isundo) ctx->progress_cur--; else ctx->progress_cur++;
+    this->_op_progress = ((double)ctx->progress_cur / ctx->progress_tot) * 100;
+    if(!ctx->progress_cb(ctx->user_ptr, ctx->progress_tot, ctx->progress_cur, reinterpret_cast<uint64_t>(this)))
+      ctx->has_abort = true; //< process continue but will return with abort code
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::_restore_job_fn(void* ptr, size_t index, unsigned worker)
+{
+  __restore_ctx_t* ctx = static_cast<__restore_ctx_t*>(ptr);
+  OmModPack* self = ctx->ModPack;
+
+  OmModEntry_t entry = self->_bck_entry[ctx->restore_ls[index]];
+
+  OmWString tgt_file, bck_file;
+  Om_concatPaths(tgt_file, self->_ModChan->targetPath(), entry.path);
+
+  OmWString error;
+
+  if(self->_bck_isdir) {
+
+    Om_concatPaths(bck_file, self->_bck_root, entry.path);
+
+    // move file from backup to target, overwriting existing
+    int32_t result = Om_fileMove(bck_file, tgt_file);
+    if(result != 0)
+      error = Om_errMove(L"Backup to Target file", tgt_file, result);
+
+  } else {
+
+    // extract from backup archive to target, overwriting existing
+    if(!ctx->zips[worker].entrySave(entry.cdid, tgt_file)) { //< TODO: des erreur d'index ici, le cdid est incohrent... data perdue ? mal pars ?
+      error = Om_errZipExtr(L"Backup to Target file", entry.path, ctx->zips[worker].lastErrorStr());
+    }
+  }
+
+  Om_pltLockEnter(ctx->lock);
+
+  if(!error.empty()) {
+    self->_error(L"restoreData", error);
+    ctx->has_error = true;
+  }
+
+  // call progression callback
+  self->_restore_progress(ctx);
+
+  Om_pltLockLeave(ctx->lock);
+
+  #ifdef DEBUG
+  Om_pltSleep(50); //< for debug
+  #endif
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::_delete_job_fn(void* ptr, size_t index, unsigned worker)
+{
+  OM_UNUSED(worker);
+
+  __restore_ctx_t* ctx = static_cast<__restore_ctx_t*>(ptr);
+  OmModPack* self = ctx->ModPack;
+
+  OmModEntry_t entry = self->_bck_entry[ctx->delete_ls[index]];
+
+  OmWString tgt_file;
+  Om_concatPaths(tgt_file, self->_ModChan->targetPath(), entry.path);
+
+  // if undo the file may not be installed yet, we prevent warnings
+  if(ctx->isundo && !Om_pathExists(tgt_file))
+    return true;
+
+  int32_t result = Om_fileDelete(tgt_file);
+
+  Om_pltLockEnter(ctx->lock);
+
+  if(result != 0) {
+    // do not throw error, simple warning
+    self->_log(OM_LOG_WRN, L"restoreData", Om_errDelete(L"file in Target", tgt_file, result));
+  }
+
+  // call progression callback
+  self->_restore_progress(ctx);
+
+  Om_pltLockLeave(ctx->lock);
+
+  #ifdef DEBUG
+  Om_pltSleep(50); //< for debug
+  #endif
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::_rmdir_job_fn(void* ptr, size_t index, unsigned worker)
+{
+  OM_UNUSED(worker);
+
+  __restore_ctx_t* ctx = static_cast<__restore_ctx_t*>(ptr);
+  OmModPack* self = ctx->ModPack;
+
+  OmModEntry_t entry = self->_bck_entry[ctx->rmdir_ls[index]];
+
+  OmWString tgt_file;
+  Om_concatPaths(tgt_file, self->_ModChan->targetPath(), entry.path);
+
+  // if undo the directory may not be created yet, we prevent warnings
+  if(ctx->isundo && !Om_pathExists(tgt_file))
+    return true;
+
+  // delete folder only if empty
+  int32_t result = 0;
+  if(Om_isDirEmpty(tgt_file))
+    result = Om_dirDelete(tgt_file);
+
+  Om_pltLockEnter(ctx->lock);
+
+  if(result != 0) {
+    // do not throw error, simple warning
+    self->_log(OM_LOG_WRN, L"restoreData", Om_errDelete(L"directory in Target", tgt_file, result));
+  }
+
+  // call progression callback
+  self->_restore_progress(ctx);
+
+  Om_pltLockLeave(ctx->lock);
+
+  #ifdef DEBUG
+  Om_pltSleep(50); //< for debug
+  #endif
+
+  return true;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -1426,6 +1638,10 @@ OmResult OmModPack::restoreData(Om_progressCb progress_cb, void* user_ptr, bool
   // initialize chrono
   clock_t time = clock();
 
+  // performance span, processed entries are counted at start
+  OmPerfScope perf(L"restore", this->_iden);
+  perf.addFiles(this->_bck_entry.size());
+
   // initialize progression callback
   size_t progress_tot = 0, progress_cur = 0;
   if(progress_cb) {
@@ -1443,123 +1659,90 @@ OmResult OmModPack::restoreData(Om_progressCb progress_cb, void* user_ptr, bool
     }
   }
 
-  OmArchive backup_zip;
-
-  // verify we have data to restore
-  if(this->_bck_isdir) {
-    if(!Om_isDir(this->_bck_root)) {
-      this->_error(L"restoreData", Om_errNotDir(L"Backup root directory", this->_bck_root));
-      this->_op_restore = false;
-      return OM_RESULT_ERROR;
-    }
-  } else {
-    if(!backup_zip.read(this->_bck_path)) {
-      this->_error(L"restoreData", Om_errLoad(L"Backup archive file", this->_bck_path, backup_zip.lastErrorStr()));
-      this->_op_restore = false;
-      return OM_RESULT_ERROR;
-    }
-  }
-
-  bool has_error = false;
-  bool has_abort = false;
+  // gather entries to be processed by each pass, files to restore, then
+  // files to delete, then directories to delete.
+  __restore_ctx_t ctx;
 
-  // restore original files from Backup to Target
   for(size_t i = 0; i < this->_bck_entry.size(); ++i) {
-
-    if(OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DEL))
-      continue;
-
-    OmWString tgt_file, bck_file;
-    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), this->_bck_entry[i].path);
-
-    if(this->_bck_isdir) {
-
-      Om_concatPaths(bck_file, this->_bck_root, this->_bck_entry[i].path);
-
-      // move file from backup to target, overwriting existing
-      int32_t result = Om_fileMove(bck_file, tgt_file);
-      if(result != 0) {
-        this->_error(L"restoreData", Om_errMove(L"Backup to Target file", tgt_file, result));
-        has_error = true;
-      }
-
+    if(OM_HAS_BIT(this->_bck_entry.attr(i), OM_MODENTRY_DEL)) {
+      if(!OM_HAS_BIT(this->_bck_entry.attr(i), OM_MODENTRY_DIR))
+        ctx.delete_ls.push_back(i);
     } else {
-
-      // extract from backup archive to target, overwriting existing
-      if(!backup_zip.entrySave(this->_bck_entry[i].cdid, tgt_file)) { //< TODO: des erreur d'index ici, le cdid est incohrent... data perdue ? mal pars ?
-        this->_error(L"restoreData", Om_errZipExtr(L"Backup to Target file", this->_bck_entry[i].path, backup_zip.lastErrorStr()));
-        has_error = true;
-      }
-    }
-
-    // call progression callback
-    if(progress_cb) {
-      if(isundo) progress_cur--; else progress_cur++;
-      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
-      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this)))
-        has_abort = true; //< process continue but will return with abort code
+      ctx.restore_ls.push_back(i);
     }
-
-    #ifdef DEBUG
-    Sleep(50); //< for debug
-    #endif
   }
 
-  // close backup archive file
-  if(!this->_bck_isdir) backup_zip.close();
-
-  // delete added files and/or folders Mod may have created in Target
-  //
   // the "To Delete" entries are listed according tree hierarchy in depth-first
   // order, so we walk list in backward to have the proper deletion sequence.
-
   size_t i = this->_bck_entry.size();
   while(i--) {
+    if(OM_HAS_BIT(this->_bck_entry.attr(i), OM_MODENTRY_DEL|OM_MODENTRY_DIR))
+      ctx.rmdir_ls.push_back(i);
+  }
 
-    if(!OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DEL))
-      continue;
-
-    OmWString tgt_file;
-    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), this->_bck_entry[i].path);
-
-    // if undo the file may not be installed yet, we prevent warnings
-    if(isundo && !Om_pathExists(tgt_file))
-      continue;
-
-    if(OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DIR)) {
+  // Files are restored and deleted by several workers if parallel restore
+  // is enabled, each worker has its own Backup archive reader.
+  unsigned threads = this->_ModChan->backupParallel() ? 0 : 1;
 
-      // delete folder only if empty
-      if(Om_isDirEmpty(tgt_file)) {
+  if(ctx.restore_ls.size() < OM_RESTORE_PARALLEL_MIN && ctx.delete_ls.size() < OM_RESTORE_PARALLEL_MIN)
+    threads = 1;
 
-        int32_t result = Om_dirDelete(tgt_file);
-        if(result != 0) {
-          // do not throw error, simple warning
-          this->_log(OM_LOG_WRN, L"restoreData", Om_errDelete(L"directory in Target", tgt_file, result));
-        }
-      }
+  unsigned workers = Om_workerCount(std::max(ctx.restore_ls.size(), ctx.delete_ls.size()), threads);
 
-    } else {
+  ctx.ModPack = this;
+  ctx.zips = nullptr;
+  ctx.progress_cb = progress_cb;
+  ctx.user_ptr = user_ptr;
+  ctx.progress_tot = progress_tot;
+  ctx.progress_cur = progress_cur;
+  ctx.isundo = isundo;
+  ctx.has_error = false;
+  ctx.has_abort = false;
 
-      int32_t result = Om_fileDelete(tgt_file);
-      if(result != 0) {
-        // do not throw error, simple warning
-        this->_log(OM_LOG_WRN, L"restoreData", Om_errDelete(L"file in Target", tgt_file, result));
+  // verify we have data to restore
+  if(this->_bck_isdir) {
+    if(!Om_isDir(this->_bck_root)) {
+      this->_error(L"restoreData", Om_errNotDir(L"Backup root directory", this->_bck_root));
+      this->_op_restore = false;
+      return OM_RESULT_ERROR;
+    }
+  } else {
+    ctx.zips = new OmArchive[workers];
+    for(unsigned w = 0; w < workers; ++w) {
+      if(!ctx.zips[w].read(this->_bck_path)) {
+        this->_error(L"restoreData", Om_errLoad(L"Backup archive file", this->_bck_path, ctx.zips[w].lastErrorStr()));
+        delete [] ctx.zips;
+        this->_op_restore = false;
+        return OM_RESULT_ERROR;
       }
     }
+  }
 
-    // call progression callback
-    if(progress_cb) {
-      if(isundo) progress_cur--; else progress_cur++;
-      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
-      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this)))
-        has_abort = true; //< process continue but will return with abort code
-    }
+  ctx.lock = Om_pltLockCreate();
 
-    #ifdef DEBUG
-    Sleep(50); //< for debug
-    #endif
+  // restore original files from Backup to Target
+  Om_parallelFor(ctx.restore_ls.size(), OmModPack::_restore_job_fn, &ctx, workers);
+
+  // close backup archive files
+  if(ctx.zips) {
+    for(unsigned w = 0; w < workers; ++w)
+      ctx.zips[w].close();
+    delete [] ctx.zips;
   }
 
+  // delete added files Mod may have created in Target, files have no
+  // order dependency so they can be deleted concurrently
+  Om_parallelFor(ctx.delete_ls.size(), OmModPack::_delete_job_fn, &ctx, workers);
+
+  // delete added folders Mod may have created in Target, this is done
+  // sequentially once all children files are gone
+  Om_parallelFor(ctx.rmdir_ls.size(), OmModPack::_rmdir_job_fn, &ctx, 1);
+
+  Om_pltLockClose(ctx.lock);
+
+  bool has_error = ctx.has_error;
+  bool has_abort = ctx.has_abort;
+
   // if no error, cleanup backup data
   if(!has_abort && !has_error) {
 
@@ -1617,6 +1800,10 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
   // initialize chrono
   clock_t time = clock();
 
+  // performance span, processed entries are counted at start
+  OmPerfScope perf(L"extract", this->_iden);
+  perf.addFiles(this->_src_entry.size());
+
   // initialize progression callback
   size_t progress_tot = 0, progress_cur = 0;
   if(progress_cb) {
@@ -1648,13 +1835,15 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
   bool has_error = false;
   bool has_abort = false;
 
-  OmWString tgt_file, src_file;
+  OmWString ent_path, tgt_file, src_file;
 
   for(size_t i = 0; i < this->_src_entry.size(); ++i) {
 
-    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), this->_src_entry[i].path);
+    this->_src_entry.getPath(i, &ent_path);
+
+    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), ent_path);
 
-    if(OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR)) {
+    if(OM_HAS_BIT(this->_src_entry.attr(i), OM_MODENTRY_DIR)) {
 
       // if directory does not exists in Target, create it
       if(!Om_isDir(tgt_file)) {
@@ -1669,7 +1858,7 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
 
       if(this->_src_isdir) {
 
-        Om_concatPaths(src_file, this->_src_root, this->_src_entry[i].path);
+        Om_concatPaths(src_file, this->_src_root, ent_path);
 
         // Copy and overwrite
         int32_t result = Om_fileCopy(src_file, tgt_file, true);
@@ -1681,7 +1870,9 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
       } else {
 
         // extract to destination
-        if(!source_zip.entrySave(this->_src_entry[i].cdid, tgt_file)) {
+        perf.addBytes(source_zip.entrySize(this->_src_entry.cdid(i)));
+
+        if(!source_zip.entrySave(this->_src_entry.cdid(i), tgt_file)) {
           this->_error(L"applySource", Om_errZipExtr(L"Source file to Target", tgt_file, source_zip.lastErrorStr()));
           has_error = true; break;
         }
@@ -1701,7 +1892,7 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
     }
 
     #ifdef DEBUG
-    Sleep(50); //< for debug
+    Om_pltSleep(50); //< for debug
     #endif
   }
 
@@ -1726,13 +1917,604 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmResult OmModPack::discardBackup()
+bool OmModPack::canReplace(const OmModPack* ModPack) const
 {
+  if(!this->_ModChan || !ModPack || ModPack == this || ModPack->_ModChan != this->_ModChan)
+    return false;
 
-  // initialize local timer
-  clock_t time = clock();
+  // replaced Mod must be installed and not overlapped, otherwise Backup data
+  // chain of overlapping Mods would be corrupted
+  if(this->_has_bck || !ModPack->_has_bck || ModPack->_is_overlapped)
+    return false;
 
-  bool has_error = false;
+  // changed files are detected using zip central-directory CRC-32
+  if(!this->_has_src || this->_src_isdir || !ModPack->_has_src || ModPack->_src_isdir)
+    return false;
+
+  // Backup data to take over must be of the kind current settings create
+  if(ModPack->_bck_isdir != (this->_ModChan->backupCompMethod() < 0))
+    return false;
+
+  // all dependencies must be already installed
+  for(size_t i = 0; i < this->_src_depend.size(); ++i) {
+    OmModPack* DepMod = this->_ModChan->findModDepend(this, i, true);
+    if(!DepMod || DepMod == ModPack)
+      return false;
+  }
+
+  // in No-Overlapping mode, this Mod must not overlap other installed Mods
+  if(!this->_ModChan->backupOverlap()) {
+
+    OmPModPackArray overlaps;
+    this->_ModChan->findOverlaps(this, &overlaps);
+
+    for(size_t i = 0; i < overlaps.size(); ++i)
+      if(overlaps[i] != ModPack)
+        return false;
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModPack::replaceData(OmModPack* ModPack, Om_progressCb progress_cb, void* user_ptr)
+{
+  if(!this->canReplace(ModPack))
+    return OM_RESULT_ABORT;
+
+  OmArchive source_zip, replace_zip;
+
+  if(!source_zip.read(this->_src_path)) {
+    this->_error(L"replaceData", Om_errLoad(L"Source archive file", this->_src_path, source_zip.lastErrorStr()));
+    return OM_RESULT_ERROR;
+  }
+
+  if(!replace_zip.read(ModPack->_src_path)) {
+    this->_error(L"replaceData", Om_errLoad(L"Source archive file", ModPack->_src_path, replace_zip.lastErrorStr()));
+    return OM_RESULT_ERROR;
+  }
+
+  // index entries of replaced Mod by path, paths are case-insensitive
+  std::map<OmWString, size_t> rep_src_map, rep_bck_map, src_map;
+
+  OmWString key;
+
+  for(size_t i = 0; i < ModPack->_src_entry.size(); ++i) {
+    key = ModPack->_src_entry.path(i); Om_strToUpper(&key);
+    rep_src_map[key] = i;
+  }
+
+  for(size_t i = 0; i < ModPack->_bck_entry.size(); ++i) {
+    key = ModPack->_bck_entry.path(i); Om_strToUpper(&key);
+    rep_bck_map[key] = i;
+  }
+
+  // sort out this Mod entries: inherited (path already installed by replaced
+  // Mod) and changed (must be written to Target)
+  std::vector<int32_t> inherit_ls(this->_src_entry.size(), -1);
+  std::vector<bool> change_ls(this->_src_entry.size(), true);
+
+  for(size_t i = 0; i < this->_src_entry.size(); ++i) {
+
+    OmModEntry_t entry = this->_src_entry[i];
+
+    key = entry.path; Om_strToUpper(&key);
+    src_map[key] = i;
+
+    std::map<OmWString, size_t>::const_iterator it = rep_src_map.find(key);
+    if(it == rep_src_map.end())
+      continue;
+
+    OmModEntry_t rep_entry = ModPack->_src_entry[it->second];
+
+    // a file replaced by a directory (or the reverse) cannot be handled here,
+    // nothing was changed so caller can fall back to standard process
+    if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR) != OM_HAS_BIT(rep_entry.attr, OM_MODENTRY_DIR))
+      return OM_RESULT_ERROR;
+
+    std::map<OmWString, size_t>::const_iterator bt = rep_bck_map.find(key);
+    if(bt != rep_bck_map.end())
+      inherit_ls[i] = bt->second;
+
+    if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR)) {
+      change_ls[i] = false;
+    } else {
+      change_ls[i] = (source_zip.entrySize(entry.cdid) != replace_zip.entrySize(rep_entry.cdid) ||
+                      source_zip.entryCrc(entry.cdid) != replace_zip.entryCrc(rep_entry.cdid));
+    }
+  }
+
+  // replaced Mod Backup entries no longer part of this Mod, to be restored
+  OmIndexArray remove_ls;
+
+  for(size_t i = 0; i < ModPack->_bck_entry.size(); ++i) {
+    key = ModPack->_bck_entry.path(i); Om_strToUpper(&key);
+    if(src_map.find(key) == src_map.end())
+      remove_ls.push_back(i);
+  }
+
+  replace_zip.close();
+
+  // start install operation
+  this->_op_apply = true;
+
+  // initialize chrono
+  clock_t time = clock();
+
+  // performance span, processed entries are counted at start
+  OmPerfScope perf(L"replace", this->_iden);
+  perf.addFiles(this->_src_entry.size());
+
+  // initialize progression callback
+  size_t progress_tot = 0, progress_cur = 0;
+  if(progress_cb) {
+    progress_tot = this->_src_entry.size() * 2 + remove_ls.size();   //< backup + install + restore
+    progress_cur = 0;
+    this->_op_progress =((double)progress_cur / progress_tot) * 100;
+    if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this))) {
+      this->_op_apply = false;
+      return OM_RESULT_ABORT;
+    }
+  }
+
+  OmArchive backup_zip, rep_backup_zip;
+
+  bool isdir = ModPack->_bck_isdir;
+
+  OmWString bck_root;
+
+  OmWString bck_name = Om_getFilePart(this->_src_path);
+
+  OmWString bck_path = this->_ModChan->backupPath() + L"\\";
+
+  if(isdir) {
+
+    bck_path += bck_name;
+
+    bck_root = bck_path + L"\\" + BACKUP_DATA_ROOT_DIR;
+
+    // take over the replaced Mod Backup directory
+    int32_t result = Om_fileMove(ModPack->_bck_path, bck_path);
+    if(result != 0) {
+      this->_error(L"replaceData", Om_errMove(L"Backup directory", ModPack->_bck_path, result));
+      this->_op_apply = false;
+      return OM_RESULT_ERROR;
+    }
+
+  } else {
+
+    bck_name += L"." OM_BCK_FILE_EXT;
+    bck_path += bck_name;
+
+    bck_root = BACKUP_DATA_ROOT_DIR;
+
+    if(!rep_backup_zip.read(ModPack->_bck_path)) {
+      this->_error(L"replaceData", Om_errLoad(L"Backup archive file", ModPack->_bck_path, rep_backup_zip.lastErrorStr()));
+      this->_op_apply = false;
+      return OM_RESULT_ERROR;
+    }
+
+    // initialize zip archive
+    if(!backup_zip.write(bck_path, this->_ModChan->backupCompMethod(), this->_ModChan->backupCompLevel())) {
+      this->_error(L"replaceData", Om_errInit(L"Backup archive file", bck_path, backup_zip.lastErrorStr()));
+      this->_op_apply = false;
+      return OM_RESULT_ERROR;
+    }
+  }
+
+  // initialize backup XML config
+  OmXmlConf backup_cfg(OM_XMAGIC_BCK);
+
+  backup_cfg.addChild(L"ident").setContent(this->_iden);
+  backup_cfg.addChild(L"hash").setContent(Om_uint64ToStr(this->_hash));
+  backup_cfg.addChild(L"backup").setContent(BACKUP_DATA_ROOT_DIR);
+
+  bool has_error = false;
+  bool has_abort = false;
+
+  OmWString tgt_file, bck_file;
+  OmXmlNode bck_node;
+
+  OmModEntryTable bck_entry;
+
+  // Target files moved to Backup directory, to be moved back if failed
+  OmWStringArray moved_ls;
+
+  // 1. create Backup data, taking over the replaced Mod Backup entries and
+  //    saving Target files for new paths. Target is not modified here except
+  //    for files moved to Backup directory, so this can be reverted.
+
+  for(size_t i = 0, z = 0; i < this->_src_entry.size(); ++i) {
+
+    OmModEntry_t entry;
+    this->_src_entry.getPath(i, &entry.path);
+    entry.attr = this->_src_entry.attr(i);
+    entry.cdid = -1; //< invalid zip central-directory index
+
+    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), entry.path);
+    Om_concatPaths(bck_file, bck_root, entry.path);
+
+    if(inherit_ls[i] >= 0) {
+
+      // path is already saved in replaced Mod Backup
+      OmModEntry_t rep_entry = ModPack->_bck_entry[inherit_ls[i]];
+
+      entry.attr = rep_entry.attr;
+
+      if(!OM_HAS_BIT(entry.attr, OM_MODENTRY_DEL)) {
+
+        if(!isdir) {
+
+          // set zip central-directory index
+          entry.cdid = z;
+
+          // copy entry without recompression
+          if(!backup_zip.entryCopy(rep_backup_zip, rep_entry.cdid, bck_file)) {
+            this->_error(L"replaceData", Om_errZipComp(L"Backup entry", entry.path, backup_zip.lastErrorStr()));
+            has_error = true; break;
+          }
+
+          z++; //< increment zip central-directory index
+        }
+      }
+
+      bck_node = backup_cfg.addChild(OM_HAS_BIT(entry.attr, OM_MODENTRY_DEL) ? L"del" : L"cpy");
+      bck_node.setContent(entry.path);
+      bck_node.setAttr(L"cdi", (int)entry.cdid);
+      bck_node.setAttr(L"dir", OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR) ? 1 : 0 );
+
+      bck_entry.push_back(entry);
+
+    } else if(!Om_pathExists(tgt_file)) {
+
+      // file or directory does not exists in Target, this is a added/created file
+      // by the Mod that must be deleted at uninstall
+      entry.attr |= OM_MODENTRY_DEL;
+
+      bck_node = backup_cfg.addChild(L"del");
+      bck_node.setContent(entry.path);
+      bck_node.setAttr(L"cdi", (int)entry.cdid);
+      bck_node.setAttr(L"dir", OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR) ? 1 : 0 );
+
+      bck_entry.push_back(entry);
+
+    } else if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR)) {
+
+      // directory was not created by the replaced Mod, check whether it
+      // was created by another Mod, see makeBackup
+      if(this->_ModChan->backupEntryExists(entry.path, entry.attr)) {
+
+        entry.attr |= OM_MODENTRY_DEL;
+
+        bck_node = backup_cfg.addChild(L"del");
+        bck_node.setContent(entry.path);
+        bck_node.setAttr(L"cdi", (int)entry.cdid);
+        bck_node.setAttr(L"dir", 1);
+
+        bck_entry.push_back(entry);
+      }
+
+      if(isdir) {
+
+        if(!Om_isDir(bck_file)) {
+          int32_t result = Om_dirCreate(bck_file);
+          if(result != 0) {
+            this->_error(L"replaceData", Om_errCreate(L"directory in Backup", bck_file, result));
+            has_error = true; break;
+          }
+        }
+      }
+
+    } else {
+
+      if(isdir) {
+
+        // create required directory tree before moving file
+        OmWString bck_tree = Om_getDirPart(bck_file);
+
+        if(!Om_isDir(bck_tree)) {
+          int32_t result = Om_dirCreateRecursive(bck_tree);
+          if(result != 0) {
+            this->_error(L"replaceData", Om_errCreate(L"tree in Backup", bck_tree, result));
+            has_error = true; break;
+          }
+        }
+
+        int32_t result = Om_fileMove(tgt_file, bck_file);
+        if(result != 0) {
+          this->_error(L"replaceData", Om_errMove(L"Backup from Target file", tgt_file, result));
+          has_error = true; break;
+        }
+
+        moved_ls.push_back(entry.path);
+
+      } else {
+
+        // set zip central-directory index
+        entry.cdid = z;
+
+        // add zip entry
+        if(!backup_zip.entryAdd(tgt_file, bck_file)) {
+          this->_error(L"replaceData", Om_errZipComp(L"Backup from Target file", tgt_file, backup_zip.lastErrorStr()));
+          has_error = true; break;
+        }
+
+        z++; //< increment zip central-directory index
+      }
+
+      bck_node = backup_cfg.addChild(L"cpy");
+      bck_node.setContent(entry.path);
+      bck_node.setAttr(L"cdi", (int)entry.cdid);
+      bck_node.setAttr(L"dir", 0);
+
+      bck_entry.push_back(entry);
+    }
+
+    // call progression callback
+    if(progress_cb) {
+      progress_cur++;
+      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
+      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this))) {
+        this->_log(OM_LOG_WRN, L"replaceData", L"process aborted by user.");
+        has_abort = true; break;
+      }
+    }
+  }
+
+  if(!has_error && !has_abort) {
+
+    // retrieve overlapped Mod list and add to XML config, the replaced
+    // Mod is still installed at this stage and must be ignored
+    OmUint64Array bck_overlap;
+
+    this->_ModChan->findOverlaps(this, &bck_overlap);
+
+    OmXmlNode xml_overlap;
+
+    for(size_t i = 0; i < bck_overlap.size(); ++i) {
+
+      if(bck_overlap[i] == ModPack->_hash)
+        continue;
+
+      if(xml_overlap.empty())
+        xml_overlap = backup_cfg.addChild(L"overlap");
+
+      xml_overlap.addChild(L"hash").setContent(Om_uint64ToStr(bck_overlap[i]));
+
+      this->_bck_overlap.push_back(bck_overlap[i]);
+    }
+
+    if(isdir) {
+
+      OmWString cfg_path = bck_path + L"\\ModBack.xml";
+
+      if(!backup_cfg.save(cfg_path)) {
+        this->_error(L"replaceData", Om_errSave(L"definition file", cfg_path, backup_cfg.lastErrorStr()));
+        has_error = true;
+      }
+
+    } else {
+
+      // get backup definition XML data
+      OmCString xml_data = backup_cfg.data();
+      if(!backup_zip.entryAdd(xml_data.c_str(), xml_data.size(), L"ModBack.xml")) {
+        this->_error(L"replaceData", Om_errZipComp(L"definition file", L"ModBack.xml", backup_zip.lastErrorStr()));
+        has_error = true;
+      }
+    }
+  }
+
+  // finalize zip archive
+  if(!isdir) backup_zip.close();
+
+  // revert to replaced Mod Backup data if anything gone wrong
+  if(has_error || has_abort) {
+
+    this->_bck_overlap.clear();
+
+    if(isdir) {
+
+      // move back Target files to their place
+      for(size_t i = 0; i < moved_ls.size(); ++i) {
+        Om_concatPaths(tgt_file, this->_ModChan->targetPath(), moved_ls[i]);
+        Om_concatPaths(bck_file, bck_root, moved_ls[i]);
+        Om_fileMove(bck_file, tgt_file);
+      }
+
+      // restore Backup directory name, the ModBack.xml file is unchanged
+      // unless new one was successfully saved
+      Om_fileMove(bck_path, ModPack->_bck_path);
+
+    } else {
+
+      Om_fileDelete(bck_path);
+    }
+
+    this->_op_apply = false;
+    return has_error ? OM_RESULT_ERROR_BACKP : OM_RESULT_ABORT;
+  }
+
+  // 2. write new and changed files to Target, from here the replaced Mod
+  //    Backup data is no longer valid and cannot be reverted
+
+  for(size_t i = 0; i < this->_src_entry.size(); ++i) {
+
+    // Backup data already covers all entries, remaining ones are skipped
+    if(has_abort)
+      break;
+
+    if(change_ls[i]) {
+
+      Om_concatPaths(tgt_file, this->_ModChan->targetPath(), this->_src_entry.path(i));
+
+      if(OM_HAS_BIT(this->_src_entry.attr(i), OM_MODENTRY_DIR)) {
+
+        // if directory does not exists in Target, create it
+        if(!Om_isDir(tgt_file)) {
+          int32_t result = Om_dirCreate(tgt_file);
+          if(result != 0) {
+            this->_error(L"replaceData", Om_errCreate(L"directory in Target", tgt_file, result));
+            has_error = true;
+          }
+        }
+
+      } else {
+
+        // extract to destination
+        if(!source_zip.entrySave(this->_src_entry.cdid(i), tgt_file)) {
+          this->_error(L"replaceData", Om_errZipExtr(L"Source file to Target", tgt_file, source_zip.lastErrorStr()));
+          has_error = true;
+        }
+      }
+    }
+
+    // call progression callback
+    if(progress_cb) {
+      progress_cur++;
+      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
+      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this))) {
+        this->_log(OM_LOG_WRN, L"replaceData", L"process aborted by user.");
+        has_abort = true;
+      }
+    }
+  }
+
+  source_zip.close();
+
+  // 3. restore files of the replaced Mod that are no longer part of this one,
+  //    files first, then directories in backward order. Their Backup data is
+  //    not taken over, so this stage cannot be interrupted, abort is only
+  //    recorded.
+
+  for(size_t i = 0; i < remove_ls.size(); ++i) {
+
+    OmModEntry_t entry = ModPack->_bck_entry[remove_ls[i]];
+
+    if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR))
+      continue;
+
+    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), entry.path);
+
+    if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DEL)) {
+
+      int32_t result = Om_fileDelete(tgt_file);
+      if(result != 0) {
+        // do not throw error, simple warning
+        this->_log(OM_LOG_WRN, L"replaceData", Om_errDelete(L"file in Target", tgt_file, result));
+      }
+
+    } else if(isdir) {
+
+      // Backup file now lies in this Mod Backup directory
+      Om_concatPaths(bck_file, bck_root, entry.path);
+
+      int32_t result = Om_fileMove(bck_file, tgt_file);
+      if(result != 0) {
+        this->_error(L"replaceData", Om_errMove(L"Backup to Target file", tgt_file, result));
+        has_error = true;
+      }
+
+    } else {
+
+      if(!rep_backup_zip.entrySave(entry.cdid, tgt_file)) {
+        this->_error(L"replaceData", Om_errZipExtr(L"Backup to Target file", entry.path, rep_backup_zip.lastErrorStr()));
+        has_error = true;
+      }
+    }
+
+    // call progression callback
+    if(progress_cb) {
+      progress_cur++;
+      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
+      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this)))
+        has_abort = true;
+    }
+  }
+
+  size_t r = remove_ls.size();
+  while(r--) {
+
+    OmModEntry_t entry = ModPack->_bck_entry[remove_ls[r]];
+
+    if(!OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR))
+      continue;
+
+    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), entry.path);
+
+    // delete folder only if empty
+    if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DEL) && Om_isDirEmpty(tgt_file)) {
+
+      int32_t result = Om_dirDelete(tgt_file);
+      if(result != 0) {
+        // do not throw error, simple warning
+        this->_log(OM_LOG_WRN, L"replaceData", Om_errDelete(L"directory in Target", tgt_file, result));
+      }
+    }
+
+    // call progression callback
+    if(progress_cb) {
+      progress_cur++;
+      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
+      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this)))
+        has_abort = true;
+    }
+  }
+
+  // delete replaced Mod Backup archive
+  if(!isdir) {
+
+    rep_backup_zip.close();
+
+    int32_t result = Om_fileDelete(ModPack->_bck_path);
+    if(result != 0) {
+      this->_error(L"replaceData", Om_errDelete(L"Backup archive file", ModPack->_bck_path, result));
+      has_error = true;
+    }
+  }
+
+  // replaced Mod is now uninstalled
+  ModPack->clearBackup();
+
+  // this Mod is now installed
+  this->_bck_path = bck_path;
+
+  this->_bck_isdir = isdir;
+
+  this->_bck_root = bck_root;
+
+  this->_bck_entry.swap(bck_entry);
+
+  this->_has_bck = true;
+
+  // end install operation
+  this->_op_apply = false;
+
+  if(has_abort)
+    return OM_RESULT_ABORT;
+
+  if(has_error)
+    return OM_RESULT_ERROR_APPLY;
+
+  // making report
+  wchar_t done_str[32];
+  swprintf(done_str, 32, L"done in %.2fs", (double)(clock()-time)/CLOCKS_PER_SEC);
+  this->_log(OM_LOG_OK, L"replaceData", done_str);
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModPack::discardBackup()
+{
+
+  // initialize local timer
+  clock_t time = clock();
+
+  bool has_error = false;
 
   // cleanup backup data either zip file or sub-directory...
   if(this->_bck_isdir) {
@@ -1772,6 +2554,10 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
   // initialize local timer
   clock_t time = clock();
 
+  // performance span
+  OmPerfScope perf(L"save", path);
+  perf.addFiles(this->_src_entry.size());
+
   OmArchive source_zip;
 
   if(!this->_src_entry.empty()) {
@@ -1813,7 +2599,7 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
   bool has_error = false;
   bool has_abort = false;
 
-  OmWString out_file;
+  OmWString ent_path, out_file;
 
   // If no entry, simply create the root folder in zip file
   if(this->_src_entry.empty()) {
@@ -1827,10 +2613,12 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
   // transfer data from source to output zip
   for(size_t i = 0; i < this->_src_entry.size(); ++i) {
 
+    this->_src_entry.getPath(i, &ent_path);
+
     // output file path (in zip)
-    Om_concatPaths(out_file, out_root, this->_src_entry[i].path);
+    Om_concatPaths(out_file, out_root, ent_path);
 
-    if(OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR)) {
+    if(OM_HAS_BIT(this->_src_entry.attr(i), OM_MODENTRY_DIR)) {
 
       // add folder to destination archive
       if(!output_zip.entryAdd(nullptr, 0, out_file)) {
@@ -1844,7 +2632,7 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
 
         // source file path
         OmWString src_file;
-        Om_concatPaths(src_file, this->_src_root, this->_src_entry[i].path);
+        Om_concatPaths(src_file, this->_src_root, ent_path);
 
         if(!output_zip.entryAdd(src_file, out_file, compress_cb, user_ptr)) {
           this->_error(L"saveAs", Om_errZipComp(L"Source file to destination", src_file, output_zip.lastErrorStr()));
@@ -1854,16 +2642,16 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
       } else {
 
         //transfers data from source to destination via memory buffer
-        uint64_t data_len = source_zip.entrySize(this->_src_entry[i].cdid);
+        uint64_t data_len = source_zip.entrySize(this->_src_entry.cdid(i));
         uint8_t* data_buf = new(std::nothrow) uint8_t[data_len];
 
         if(!data_buf) {
-          this->_error(L"saveAs", Om_errBadAlloc(L"Source file extraction", this->_src_entry[i].path));
+          this->_error(L"saveAs", Om_errBadAlloc(L"Source file extraction", ent_path));
           has_error = true; break;
         }
 
-        if(!source_zip.entrySave(this->_src_entry[i].cdid, data_buf, compress_cb, user_ptr)) {
-          this->_error(L"saveAs", Om_errZipExtr(L"Source file", this->_src_entry[i].path, source_zip.lastErrorStr()));
+        if(!source_zip.entrySave(this->_src_entry.cdid(i), data_buf, compress_cb, user_ptr)) {
+          this->_error(L"saveAs", Om_errZipExtr(L"Source file", ent_path, source_zip.lastErrorStr()));
           delete [] data_buf; has_error = true; break;
         }
 
@@ -1886,7 +2674,7 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
     }
 
     #ifdef DEBUG
-    Sleep(50); //< for debug
+    Om_pltSleep(50); //< for debug
     #endif
   }
 
@@ -1949,7 +2737,7 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
     "files to be copied :\r\n"
     "\r\n");
     for(size_t i = 0; i < this->_src_entry.size(); ++i) {
-      reamde.append(" - "); reamde.append(Om_toUTF8(this->_src_entry[i].path)); reamde.append("\r\n");
+      reamde.append(" - "); reamde.append(Om_toUTF8(this->_src_entry.path(i))); reamde.append("\r\n");
     }
     reamde.append("\r\n"
     "Once you made a backup of the original files, you can install Mod by extracting\r\n"
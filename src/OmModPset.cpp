@@ -395,21 +395,32 @@ size_t OmModPset::getSetupEntryList(const OmModChan* ModChan, OmPModPackArray* m
       OmXmlNodeArray xml_install;
       xml_setup.children(xml_install, L"install");
 
-      for(size_t i = 0; i < xml_install.size(); ++i) {
+      // index library Mods by hash and identity, first match is kept
+      // to behave like the Mod Channel search functions
+      std::map<uint64_t, OmModPack*> hash_map;
+      std::map<OmWString, OmModPack*> iden_map;
+
+      for(size_t i = 0; i < ModChan->modpackCount(); ++i) {
+        OmModPack* ModPack = ModChan->getModpack(i);
+        hash_map.insert(std::pair<uint64_t, OmModPack*>(ModPack->hash(), ModPack));
+        iden_map.insert(std::pair<OmWString, OmModPack*>(ModPack->iden(), ModPack));
+      }
 
-        OmModPack* ModPack;
+      for(size_t i = 0; i < xml_install.size(); ++i) {
 
         // first try and rely on package hash value
         if(xml_install[i].hasAttr(L"hash")) {
-          if((ModPack = ModChan->findModpack(xml_install[i].attrAsUint64(L"hash")))) {
-            mod_ls->push_back(ModPack); continue;
+          std::map<uint64_t, OmModPack*>::const_iterator it = hash_map.find(xml_install[i].attrAsUint64(L"hash"));
+          if(it != hash_map.end()) {
+            mod_ls->push_back(it->second); continue;
           }
         }
 
         // then try with identity
         if(xml_install[i].hasAttr(L"ident")) {
-          if((ModPack = ModChan->findModpack(xml_install[i].attrAsString(L"ident")))) {
-            mod_ls->push_back(ModPack); continue;
+          std::map<OmWString, OmModPack*>::const_iterator it = iden_map.find(xml_install[i].attrAsString(L"ident"));
+          if(it != iden_map.end()) {
+            mod_ls->push_back(it->second); continue;
           }
         }
       }
@@ -472,6 +483,10 @@ bool OmModPset::repair()
     // get Mod Channel
     OmModChan* ModChan = this->_ModHub->findChannel(xml_setup[i].attrAsString(L"uuid"));
 
+    // library not loaded yet, references cannot be checked
+    if(!ModChan->activated())
+      continue;
+
     // get install list for this setup
     xml_install.clear();
     xml_setup[i].children(xml_install, L"install");
@@ -0,0 +1,555 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
+#include <algorithm>          //< std::sort
+
+#include "OmBaseWin.h"        //< WinAPI
+
+#include "OmUtilStr.h"
+
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmNetIndex.h"
+
+/// \brief Index signature
+///
+/// Signature bytes at beginning of repository index file
+///
+static const char __idx_magic[8] = {'O','M','R','E','P','I','D','X'};
+
+/// \brief Index string reference
+///
+/// Location of UTF-8 string within index string pool
+///
+typedef struct {
+
+  uint32_t          off;    ///< Offset in string pool
+
+  uint32_t          len;    ///< Length in bytes
+
+} __idx_str_t;
+
+/// \brief Index header
+///
+/// Fixed index header structure, section offsets are relative
+/// to beginning of index data.
+///
+typedef struct {
+
+  char              magic[8];
+
+  uint32_t          version;
+
+  uint32_t          count;    ///< Count of Mod references
+
+  __idx_str_t       uuid;
+
+  __idx_str_t       title;
+
+  __idx_str_t       downpath;
+
+  uint64_t          ents_off; ///< Mod references table offset
+
+  uint64_t          deps_off; ///< Dependencies table offset
+
+  uint64_t          deps_cnt; ///< Dependencies table count
+
+  uint64_t          strs_off; ///< String pool offset
+
+  uint64_t          strs_len; ///< String pool size
+
+  uint64_t          blob_off; ///< Blobs offset
+
+  uint64_t          blob_len; ///< Blobs size
+
+} __idx_head_t;
+
+/// \brief Index Mod reference
+///
+/// Mod reference entry of index references table, entries are
+/// sorted by identity. Blobs offsets are relative to blobs section.
+///
+typedef struct {
+
+  __idx_str_t       ident;
+
+  __idx_str_t       file;
+
+  __idx_str_t       xxhsum;
+
+  __idx_str_t       md5sum;
+
+  __idx_str_t       category;
+
+  __idx_str_t       url;
+
+  uint64_t          bytes;
+
+  uint64_t          thumb_off;
+
+  uint64_t          thumb_len;
+
+  uint64_t          desc_off;
+
+  uint64_t          desc_len;
+
+  uint64_t          desc_bytes;
+
+  uint32_t          deps_idx; ///< First dependency in table
+
+  uint32_t          deps_cnt; ///< Count of dependencies
+
+} __idx_ent_t;
+
+/// \brief Check section bounds
+///
+/// Checks whether the given section lies within data of specified size.
+///
+/// \param[in]  size    : Size of data.
+/// \param[in]  off     : Section offset.
+/// \param[in]  len     : Section size.
+///
+/// \return True if section is within data, false otherwise.
+///
+static inline bool __in_bounds(uint64_t size, uint64_t off, uint64_t len)
+{
+  return (off <= size && len <= size - off);
+}
+
+/// \brief Add string to pool
+///
+/// Appends the given string to string pool as UTF-8.
+///
+/// \param[in]  pool    : String pool.
+/// \param[in]  str     : String to add.
+///
+/// \return String reference.
+///
+static __idx_str_t __pool_add(OmCString* pool, const OmWString& str)
+{
+  OmCString utf8;
+  Om_toUTF8(&utf8, str);
+
+  __idx_str_t sref;
+  sref.off = pool->size();
+  sref.len = utf8.size();
+
+  pool->append(utf8);
+
+  return sref;
+}
+
+/// \brief Compare identities
+///
+/// Compares UTF-8 identity with index string, bytewise.
+///
+/// \param[in]  a       : Pointer to first identity.
+/// \param[in]  a_len   : First identity length.
+/// \param[in]  b       : Pointer to second identity.
+/// \param[in]  b_len   : Second identity length.
+///
+/// \return Negative, zero or positive value as strcmp does.
+///
+static inline int __ident_cmp(const char* a, size_t a_len, const char* b, size_t b_len)
+{
+  int r = memcmp(a, b, (a_len < b_len) ? a_len : b_len);
+  if(r != 0) return r;
+
+  return (a_len < b_len) ? -1 : (a_len > b_len) ? 1 : 0;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmNetIndex::OmNetIndex() :
+  _data(nullptr),
+  _size(0),
+  _hfile(nullptr),
+  _hmap(nullptr)
+{
+
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmNetIndex::~OmNetIndex()
+{
+  this->close();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmNetIndex::open(const OmWString& path)
+{
+  this->close();
+
+  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(hFile == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER file_size;
+  if(!GetFileSizeEx(hFile, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(__idx_head_t))) {
+    CloseHandle(hFile);
+    return false;
+  }
+
+  HANDLE hMap = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(!hMap) {
+    CloseHandle(hFile);
+    return false;
+  }
+
+  const uint8_t* data = static_cast<const uint8_t*>(MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
+
+  if(!data || !OmNetIndex::_check(data, file_size.QuadPart)) {
+    if(data) UnmapViewOfFile(data);
+    CloseHandle(hMap);
+    CloseHandle(hFile);
+    return false;
+  }
+
+  this->_data = data;
+  this->_size = file_size.QuadPart;
+  this->_hfile = hFile;
+  this->_hmap = hMap;
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmNetIndex::attach(const uint8_t* data, size_t size)
+{
+  this->close();
+
+  if(!OmNetIndex::_check(data, size))
+    return false;
+
+  this->_data = data;
+  this->_size = size;
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmNetIndex::close()
+{
+  if(this->_hmap) {
+    UnmapViewOfFile(this->_data);
+    CloseHandle(static_cast<HANDLE>(this->_hmap));
+    CloseHandle(static_cast<HANDLE>(this->_hfile));
+  }
+
+  this->_data = nullptr;
+  this->_size = 0;
+  this->_hfile = nullptr;
+  this->_hmap = nullptr;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmNetIndex::uuid() const
+{
+  OmWString result;
+
+  if(this->_data)
+    this->_get_str(&reinterpret_cast<const __idx_head_t*>(this->_data)->uuid, &result);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmNetIndex::title() const
+{
+  OmWString result;
+
+  if(this->_data)
+    this->_get_str(&reinterpret_cast<const __idx_head_t*>(this->_data)->title, &result);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmNetIndex::downpath() const
+{
+  OmWString result;
+
+  if(this->_data)
+    this->_get_str(&reinterpret_cast<const __idx_head_t*>(this->_data)->downpath, &result);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+size_t OmNetIndex::referenceCount() const
+{
+  if(!this->_data)
+    return 0;
+
+  return reinterpret_cast<const __idx_head_t*>(this->_data)->count;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmNetIndex::getReference(size_t index, OmNetRef_t* ref) const
+{
+  if(index >= this->referenceCount())
+    return false;
+
+  const __idx_head_t* head = reinterpret_cast<const __idx_head_t*>(this->_data);
+  const __idx_ent_t* ent = reinterpret_cast<const __idx_ent_t*>(this->_data + head->ents_off) + index;
+
+  if(!this->_get_str(&ent->ident, &ref->ident) ||
+     !this->_get_str(&ent->file, &ref->file) ||
+     !this->_get_str(&ent->xxhsum, &ref->xxhsum) ||
+     !this->_get_str(&ent->md5sum, &ref->md5sum) ||
+     !this->_get_str(&ent->category, &ref->category) ||
+     !this->_get_str(&ent->url, &ref->url))
+    return false;
+
+  ref->bytes = ent->bytes;
+
+  // blobs are addressed directly, no DataURI
+  ref->thumbnail.clear();
+  ref->description.clear();
+  ref->desc_bytes = ent->desc_bytes;
+
+  if(!__in_bounds(head->blob_len, ent->thumb_off, ent->thumb_len) ||
+     !__in_bounds(head->blob_len, ent->desc_off, ent->desc_len))
+    return false;
+
+  const uint8_t* blob = this->_data + head->blob_off;
+
+  ref->thumb_data = ent->thumb_len ? blob + ent->thumb_off : nullptr;
+  ref->thumb_size = ent->thumb_len;
+  ref->desc_data = ent->desc_len ? blob + ent->desc_off : nullptr;
+  ref->desc_size = ent->desc_len;
+
+  ref->thumb_failed = false;
+  ref->desc_failed = false;
+
+  // dependencies
+  ref->depends.clear();
+
+  if(!__in_bounds(head->deps_cnt, ent->deps_idx, ent->deps_cnt))
+    return false;
+
+  const __idx_str_t* deps = reinterpret_cast<const __idx_str_t*>(this->_data + head->deps_off);
+
+  OmWString depend;
+  for(uint32_t i = 0; i < ent->deps_cnt; ++i) {
+    if(!this->_get_str(&deps[ent->deps_idx + i], &depend))
+      return false;
+    ref->depends.push_back(depend);
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t OmNetIndex::indexOfReference(const OmWString& ident) const
+{
+  if(!this->_data)
+    return -1;
+
+  OmCString utf8;
+  Om_toUTF8(&utf8, ident);
+
+  const __idx_head_t* head = reinterpret_cast<const __idx_head_t*>(this->_data);
+  const __idx_ent_t* ents = reinterpret_cast<const __idx_ent_t*>(this->_data + head->ents_off);
+  const char* strs = reinterpret_cast<const char*>(this->_data + head->strs_off);
+
+  size_t lo = 0, hi = head->count;
+
+  while(lo < hi) {
+
+    size_t mid = (lo + hi) / 2;
+
+    const __idx_str_t& sref = ents[mid].ident;
+    if(!__in_bounds(head->strs_len, sref.off, sref.len))
+      return -1;
+
+    int r = __ident_cmp(strs + sref.off, sref.len, utf8.data(), utf8.size());
+
+    if(r == 0)
+      return mid;
+
+    if(r < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return -1;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmNetIndex::write(const OmWString& path, const OmWString& uuid, const OmWString& title, const OmWString& downpath, const OmNetRefArray& refs)
+{
+  __idx_head_t head = {};
+  memcpy(head.magic, __idx_magic, 8);
+  head.version = OM_NETINDEX_VERSION;
+  head.count = refs.size();
+
+  OmCString strs;
+  OmCString blob;
+  std::vector<__idx_str_t> deps;
+  std::vector<__idx_ent_t> ents(refs.size());
+
+  head.uuid = __pool_add(&strs, uuid);
+  head.title = __pool_add(&strs, title);
+  head.downpath = __pool_add(&strs, downpath);
+
+  // sort references by UTF-8 identity for binary search, std::string
+  // comparison is bytewise as memcmp
+  std::vector<std::pair<OmCString, size_t>> order(refs.size());
+
+  for(size_t i = 0; i < refs.size(); ++i) {
+    Om_toUTF8(&order[i].first, refs[i].ident);
+    order[i].second = i;
+  }
+
+  std::sort(order.begin(), order.end());
+
+  for(size_t i = 0; i < refs.size(); ++i) {
+
+    const OmNetRef_t& ref = refs[order[i].second];
+    __idx_ent_t& ent = ents[i];
+
+    ent.ident = __pool_add(&strs, ref.ident);
+    ent.file = __pool_add(&strs, ref.file);
+    ent.xxhsum = __pool_add(&strs, ref.xxhsum);
+    ent.md5sum = __pool_add(&strs, ref.md5sum);
+    ent.category = __pool_add(&strs, ref.category);
+    ent.url = __pool_add(&strs, ref.url);
+
+    ent.bytes = ref.bytes;
+
+    ent.thumb_off = blob.size();
+    ent.thumb_len = ref.thumb_data ? ref.thumb_size : 0;
+    if(ent.thumb_len)
+      blob.append(reinterpret_cast<const char*>(ref.thumb_data), ent.thumb_len);
+
+    ent.desc_off = blob.size();
+    ent.desc_len = ref.desc_data ? ref.desc_size : 0;
+    ent.desc_bytes = ref.desc_bytes;
+    if(ent.desc_len)
+      blob.append(reinterpret_cast<const char*>(ref.desc_data), ent.desc_len);
+
+    ent.deps_idx = deps.size();
+    ent.deps_cnt = ref.depends.size();
+    for(size_t j = 0; j < ref.depends.size(); ++j)
+      deps.push_back(__pool_add(&strs, ref.depends[j]));
+  }
+
+  // compute sections layout
+  head.ents_off = sizeof(__idx_head_t);
+  head.deps_off = head.ents_off + ents.size() * sizeof(__idx_ent_t);
+  head.deps_cnt = deps.size();
+  head.strs_off = head.deps_off + deps.size() * sizeof(__idx_str_t);
+  head.strs_len = strs.size();
+  head.blob_off = head.strs_off + strs.size();
+  head.blob_len = blob.size();
+
+  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(hFile == INVALID_HANDLE_VALUE)
+    return false;
+
+  DWORD wb;
+  bool result = true;
+
+  result = result && WriteFile(hFile, &head, sizeof(__idx_head_t), &wb, nullptr);
+  if(ents.size())
+    result = result && WriteFile(hFile, ents.data(), ents.size() * sizeof(__idx_ent_t), &wb, nullptr);
+  if(deps.size())
+    result = result && WriteFile(hFile, deps.data(), deps.size() * sizeof(__idx_str_t), &wb, nullptr);
+  if(strs.size())
+    result = result && WriteFile(hFile, strs.data(), strs.size(), &wb, nullptr);
+  if(blob.size())
+    result = result && WriteFile(hFile, blob.data(), blob.size(), &wb, nullptr);
+
+  CloseHandle(hFile);
+
+  if(!result)
+    DeleteFileW(path.c_str());
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmNetIndex::_check(const uint8_t* data, size_t size)
+{
+  if(!data || size < sizeof(__idx_head_t))
+    return false;
+
+  const __idx_head_t* head = reinterpret_cast<const __idx_head_t*>(data);
+
+  if(memcmp(head->magic, __idx_magic, 8) != 0 || head->version != OM_NETINDEX_VERSION)
+    return false;
+
+  // tables must be aligned and within data
+  if((head->ents_off % 8) || (head->deps_off % 8))
+    return false;
+
+  if(head->count > (size / sizeof(__idx_ent_t)) || head->deps_cnt > (size / sizeof(__idx_str_t)))
+    return false;
+
+  return __in_bounds(size, head->ents_off, head->count * sizeof(__idx_ent_t)) &&
+         __in_bounds(size, head->deps_off, head->deps_cnt * sizeof(__idx_str_t)) &&
+         __in_bounds(size, head->strs_off, head->strs_len) &&
+         __in_bounds(size, head->blob_off, head->blob_len);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmNetIndex::_get_str(const void* ptr, OmWString* str) const
+{
+  const __idx_head_t* head = reinterpret_cast<const __idx_head_t*>(this->_data);
+  const __idx_str_t* sref = static_cast<const __idx_str_t*>(ptr);
+
+  if(!__in_bounds(head->strs_len, sref->off, sref->len))
+    return false;
+
+  OmCString utf8(reinterpret_cast<const char*>(this->_data + head->strs_off + sref->off), sref->len);
+  Om_toUTF16(str, utf8);
+
+  return true;
+}
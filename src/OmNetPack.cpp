@@ -19,12 +19,14 @@
 #include "OmXmlConf.h"
 
 #include "OmUtilStr.h"
+#include "OmUtilAlg.h"
 #include "OmUtilErr.h"
 #include "OmUtilHsh.h"
 #include "OmUtilPkg.h"
 #include "OmUtilB64.h"
 #include "OmUtilZip.h"
 #include "OmUtilFs.h"
+#include "OmUtilPrf.h"
 
 #include "OmModHub.h"
 #include "OmModChan.h"
@@ -55,6 +57,8 @@ OmNetPack::OmNetPack() :
   _dnl_result(OM_RESULT_UNKNOW),
   _dnl_remain(0),
   _dnl_percent(0),
+  _dnl_perf(0),
+  _dnl_csum_ok(false),
   _sps_percent(0)
 {
 
@@ -80,6 +84,8 @@ OmNetPack::OmNetPack(OmModChan* ModChan) :
   _dnl_result(OM_RESULT_UNKNOW),
   _dnl_remain(0),
   _dnl_percent(0),
+  _dnl_perf(0),
+  _dnl_csum_ok(false),
   _sps_percent(0)
 {
 
@@ -98,15 +104,28 @@ OmNetPack::~OmNetPack()
 ///
 bool OmNetPack::parseReference(OmNetRepo* NetRepo, size_t i)
 {
-  OmXmlNode ref_node = NetRepo->getReference(i);
+  OmNetRef_t ref;
 
-  if(!ref_node.hasAttr(L"file") || !ref_node.hasAttr(L"bytes")|| !ref_node.hasAttr(L"ident")) {
+  if(!NetRepo->getReference(i, &ref)) {
+    this->_error(L"parseReference", Om_errParse(L"Repository reference", L"<remote>", L"invalid reference index"));
+    return false;
+  }
+
+  return this->parseReference(NetRepo, &ref);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmNetPack::parseReference(OmNetRepo* NetRepo, const OmNetRef_t* ref)
+{
+  if(ref->file.empty() || !ref->bytes || ref->ident.empty()) {
     this->_error(L"parseReference", Om_errParse(L"Repository reference", L"<remote>", L"base attributes missing"));
     return false;
   }
 
-  if(!ref_node.hasAttr(L"xxhsum")) {
-    if(!ref_node.hasAttr(L"md5sum")) {
+  if(ref->xxhsum.empty()) {
+    if(ref->md5sum.empty()) {
       this->_error(L"parseReference", Om_errParse(L"Repository reference", L"<remote>", L"checksum attribute missing"));
       return false;
     }
@@ -114,20 +133,20 @@ bool OmNetPack::parseReference(OmNetRepo* NetRepo, size_t i)
 
   this->_NetRepo = NetRepo;
 
-  this->_file.assign(ref_node.attrAsString(L"file"));
-  this->_size = ref_node.attrAsUint64(L"bytes");
+  this->_file.assign(ref->file);
+  this->_size = ref->bytes;
   // create formated string
   Om_formatSizeSysStr(&this->_size_str, this->_size);
 
-  if(ref_node.hasAttr(L"xxhsum")) {
+  if(!ref->xxhsum.empty()) {
 
     this->_csum_is_md5 = false;
-    this->_csum.assign(ref_node.attrAsString(L"xxhsum"));
+    this->_csum.assign(ref->xxhsum);
 
-  } else if(ref_node.hasAttr(L"md5sum")) {
+  } else {
 
     this->_csum_is_md5 = true;
-    this->_csum.assign(ref_node.attrAsString(L"md5sum"));
+    this->_csum.assign(ref->md5sum);
   }
 
   // check whether we found a partial download data for this instance
@@ -137,10 +156,10 @@ bool OmNetPack::parseReference(OmNetRepo* NetRepo, size_t i)
   }
 
   // check for custom link
-  if(ref_node.hasChild(L"url")) {
+  if(!ref->url.empty()) {
 
     // get custom link
-    this->_cust_url = ref_node.child(L"url").content();
+    this->_cust_url = ref->url;
 
     // check whether the supplied custom link is a full URL
     if(Om_isUrl(this->_cust_url)) {
@@ -169,7 +188,9 @@ bool OmNetPack::parseReference(OmNetRepo* NetRepo, size_t i)
   }
 
   // add download URL to list
-  this->_iden = ref_node.attrAsString(L"ident");
+  this->_iden = ref->ident;
+  this->_iden_key = this->_iden;
+  Om_strToUpper(&this->_iden_key);
   this->_hash = Om_getXXHash3(this->_file);
 
   // parse other Mod common infos from identity
@@ -178,27 +199,26 @@ bool OmNetPack::parseReference(OmNetRepo* NetRepo, size_t i)
     this->_version.parse(vers_str);
 
   // check for category
-  if(ref_node.hasAttr(L"category"))
-    this->_category = ref_node.attrAsString(L"category");
+  if(!ref->category.empty()) {
+    this->_category = ref->category;
+    this->_category_key = this->_category;
+    Om_strToUpper(&this->_category_key);
+  }
 
   // check for dependencies
-  if(ref_node.hasChild(L"dependencies")) {
+  this->_depend = ref->depends;
 
-    OmXmlNodeArray ident_nodes;
-    ref_node.child(L"dependencies").children(ident_nodes, L"ident");
+  // check for thumbnail, raw data from binary index is used as is
+  if(ref->thumb_data) {
 
-    for(unsigned i = 0; i < ident_nodes.size(); ++i) {
-      this->_depend.push_back(ident_nodes[i].content());
-    }
-  }
+    this->_thumbnail.loadThumbnail(const_cast<uint8_t*>(ref->thumb_data), ref->thumb_size, OM_MODPACK_THUMB_SIZE, OM_SIZE_FILL);
 
-  // check for thumbnail
-  if(ref_node.hasChild(L"thumbnail")) {
+  } else if(!ref->thumbnail.empty()) {
 
     // decode the DataURI
     size_t jpg_size;
     OmWString mimetype, charset;
-    uint8_t* jpg_data = Om_decodeDataUri(&jpg_size, mimetype, charset, ref_node.child(L"thumbnail").content());
+    uint8_t* jpg_data = Om_decodeDataUri(&jpg_size, mimetype, charset, ref->thumbnail);
 
     // load Jpeg image
     if(jpg_data) {
@@ -209,20 +229,36 @@ bool OmNetPack::parseReference(OmNetRepo* NetRepo, size_t i)
     }
   }
 
-  if(ref_node.hasChild(L"description")) {
+  if(ref->desc_data) {
+
+    if(ref->desc_bytes) {
+
+      uint8_t* txt_data = Om_zInflate(ref->desc_data, ref->desc_size, ref->desc_bytes);
+
+      if(txt_data) {
+
+        this->_description = Om_toUTF16(reinterpret_cast<char*>(txt_data));
 
-    OmXmlNode description_node = ref_node.child(L"description");
+        Om_free(txt_data);
+      } else {
+        this->_log(OM_LOG_WRN, L"parseReference", L"description data zip inflate error");
+      }
+    } else {
+      this->_log(OM_LOG_WRN, L"parseReference", L"description 'bytes' attribute missing");
+    }
 
-    if(description_node.hasAttr(L"bytes")) {
+  } else if(!ref->description.empty()) {
+
+    if(ref->desc_bytes) {
 
       // decode the DataURI
       size_t dfl_size;
       OmWString mimetype, charset;
-      uint8_t* dfl_data = Om_decodeDataUri(&dfl_size, mimetype, charset, description_node.content());
+      uint8_t* dfl_data = Om_decodeDataUri(&dfl_size, mimetype, charset, ref->description);
 
       if(dfl_data) {
 
-        size_t txt_size = description_node.attrAsInt(L"bytes");
+        size_t txt_size = ref->desc_bytes;
 
         uint8_t* txt_data = Om_zInflate(dfl_data, dfl_size, txt_size);
 
@@ -426,6 +462,11 @@ bool OmNetPack::startDownload(Om_downloadCb download_cb, Om_resultCb result_cb,
 
   this->_dnl_percent = 0.0;
 
+  this->_dnl_csum_ok = false;
+
+  // download performance span start
+  this->_dnl_perf = Om_perfEnabled() ? Om_perfTime() : 0;
+
   // check for exception when download part is actually the completed download, in this case
   // we call result callback directly to prevent HTTP error 416
   if(Om_isFile(this->_dnl_temp)) {
@@ -526,13 +567,21 @@ bool OmNetPack::finalizeDownload()
     return false;
   }
 
-  // compare checksum
-  bool checksum_ok = false;
+  // compare checksum, unless already verified by batch
+  bool checksum_ok = this->_dnl_csum_ok;
 
-  if(this->_csum_is_md5) {
-    checksum_ok = Om_cmpMD5sum(hFile, this->_csum);
-  } else {
-    checksum_ok = Om_cmpXXHsum(hFile, this->_csum);
+  this->_dnl_csum_ok = false;
+
+  if(!checksum_ok) {
+
+    OmPerfScope perf(L"checksum", this->_iden);
+    perf.addFiles(1); perf.addBytes(this->_size);
+
+    if(this->_csum_is_md5) {
+      checksum_ok = Om_cmpMD5sum(hFile, this->_csum);
+    } else {
+      checksum_ok = Om_cmpXXHsum(hFile, this->_csum);
+    }
   }
 
   if(checksum_ok) {
@@ -567,6 +616,45 @@ bool OmNetPack::finalizeDownload()
   return !this->_has_error;
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmNetPack::verifyDownloads(const OmPNetPackArray& selection)
+{
+  for(size_t i = 0; i < selection.size(); ++i)
+    selection[i]->_dnl_csum_ok = false;
+
+  // downloads are verified by groups of same checksum algorithm
+  for(unsigned a = 0; a < 2; ++a) {
+
+    OmPNetPackArray group;
+    OmWStringArray paths, sums;
+
+    for(size_t i = 0; i < selection.size(); ++i) {
+
+      OmNetPack* NetPack = selection[i];
+
+      if(NetPack->_dnl_result != OM_RESULT_OK || NetPack->_csum_is_md5 != (a == 1))
+        continue;
+
+      group.push_back(NetPack);
+      paths.push_back(NetPack->_dnl_temp);
+      sums.push_back(NetPack->_csum);
+    }
+
+    if(group.empty())
+      continue;
+
+    OmIndexArray mismatch;
+    Om_cmpFileSums(&mismatch, paths, sums, (a == 1) ? OM_HASH_MD5 : OM_HASH_XXH3);
+
+    // files that failed, including those that could not be read, are left
+    // to finalizeDownload which verifies them again
+    for(size_t i = 0; i < group.size(); ++i)
+      group[i]->_dnl_csum_ok = !Om_arrayContain(mismatch, static_cast<uint32_t>(i));
+  }
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -597,6 +685,11 @@ void OmNetPack::_dnl_result_fn(void* ptr, OmResult result, uint64_t param)
 
   self->_dnl_result = result;
 
+  if(self->_dnl_perf && Om_perfEnabled()) {
+    Om_perfRecord(L"download", self->_iden, self->_dnl_perf, 1, Om_itemSize(self->_dnl_temp));
+    self->_dnl_perf = 0;
+  }
+
   if(self->_dnl_result == OM_RESULT_ERROR) {
 
     // delete temporary file if nothing was download
@@ -672,6 +765,8 @@ OmResult OmNetPack::supersede(Om_progressCb progress_cb, void* user_ptr)
   // to keep track of all uninstalled Mods to be re-installed
   OmUint64Array unins_hash;
 
+  bool has_abort = false;
+
   // 1. uninstall all replaced Mods before renaming/trashing them
 
   for(size_t i = 0; i < replaces.size(); ++i) {
@@ -682,19 +777,136 @@ OmResult OmNetPack::supersede(Om_progressCb progress_cb, void* user_ptr)
   // prepare Mods uninstall and backups restoration
   this->_ModChan->prepareRestores(selection, &restores, &overlaps, &depends);
 
+  // if only one installed Mod is to be replaced, it is replaced in place by
+  // applying only differences between the two Mods, unchanged files are
+  // left untouched. If not possible, we fall back to the standard process.
+  if(restores.size() == 1 && this_ModPack->canReplace(restores[0])) {
+
+    OmResult result = this_ModPack->replaceData(restores[0], OmNetPack::_sps_progress_fn, this);
+
+    if(result == OM_RESULT_ABORT) {
+
+      // aborted once replaced Mod was uninstalled, this Mod is only partly
+      // installed and is undone as it would be for a standard install
+      if(this_ModPack->hasBackup())
+        this_ModPack->restoreData(nullptr, nullptr, true);
+
+      has_abort = true;
+
+    } else if(result == OM_RESULT_OK || result == OM_RESULT_ERROR_APPLY) {
+
+      if(result == OM_RESULT_ERROR_APPLY) {
+        this->_error(L"supersede", this_ModPack->lastError());
+        has_error = true;
+      }
+
+      restores.clear(); //< replaced Mod is no longer installed
+    }
+  }
+
   // perform Mods uninstall and backups restoration
-  for(size_t i = 0; i < restores.size(); ++i) {
+  for(size_t i = 0; i < restores.size() && !has_abort; ++i) {
 
     // keep hash of uinstalled package to be re-installed later
     unins_hash.push_back(restores[i]->hash());
 
-    if(OM_HAS_BIT(restores[i]->restoreData(OmNetPack::_sps_progress_fn, this), OM_RESULT_ERROR)) {
+    OmResult result = restores[i]->restoreData(OmNetPack::_sps_progress_fn, this);
+
+    if(result == OM_RESULT_ABORT)
+      has_abort = true;
+
+    if(OM_HAS_BIT(result, OM_RESULT_ERROR)) {
       this->_error(L"supersede", restores[i]->lastError());
       has_error = true;
     }
   }
 
-  // 2. remove and replace all references in Mod Presets
+  // 2. install the new Mod if replaced ones was installed, so the standard
+  //    process ends in the same state as the in place replacement. Mods
+  //    uninstalled because they depend on replaced ones are installed back.
+
+  if(!has_abort && !unins_hash.empty()) {
+
+    OmPModPackArray installs;
+    OmWStringArray missings, conflicts;
+
+    selection.clear();
+
+    // add this instance corresponding Mod Pack
+    selection.push_back(this_ModPack);
+
+    // add previously uninstalled Mods, except replaced ones
+    for(size_t i = 0; i < unins_hash.size(); ++i) {
+
+      OmModPack* ModPack = this->_ModChan->findModpack(unins_hash[i], true);
+
+      if(ModPack && !Om_arrayContain(replaces, ModPack))
+        selection.push_back(ModPack);
+    }
+
+    // clear all our processing lists
+    overlaps.clear(); depends.clear();
+
+    // prepare for installation
+    this->_ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings, &conflicts);
+
+    // as Mods are not downloaded sequentially, dependencies may not be
+    // available yet or resolve to a replaced Mod, in which case Mods are
+    // left uninstalled, ready for manual install.
+    bool can_install = missings.empty() && conflicts.empty();
+
+    for(size_t i = 0; i < installs.size(); ++i)
+      if(Om_arrayContain(replaces, installs[i]))
+        can_install = false;
+
+    if(can_install) {
+
+      for(size_t i = 0; i < installs.size(); ++i) {
+
+        OmResult result = installs[i]->makeBackup(OmNetPack::_sps_progress_fn, this);
+        if(result == OM_RESULT_OK)
+          result = installs[i]->applySource(OmNetPack::_sps_progress_fn, this);
+
+        if(result != OM_RESULT_OK) {
+
+          if(result == OM_RESULT_ABORT) {
+            has_abort = true;
+          } else {
+            this->_error(L"supersede", installs[i]->lastError());
+            has_error = true;
+          }
+
+          // restore any stored Backup data
+          installs[i]->restoreData(nullptr, nullptr, true);
+
+          if(has_abort)
+            break;
+        }
+      }
+
+    } else {
+
+      this->_log(OM_LOG_WRN, L"supersede", L"dependencies not available, new version left uninstalled");
+    }
+  }
+
+  // when aborted, replaced Mods are kept in library and Presets unchanged
+  if(has_abort) {
+
+    this->_sps_percent = 0;
+
+    // reset client parameters
+    this->_cli_ptr = nullptr;
+    this->_cli_progress_cb = nullptr;
+
+    this->_is_superseding = false;
+
+    this->_log(OM_LOG_WRN, L"supersede", L"process aborted by user.");
+
+    return OM_RESULT_ABORT;
+  }
+
+  // 3. remove and replace all references in Mod Presets
   OmModHub* ModHub = this->_ModChan->ModHub();
 
   // remove package references from existing batches
@@ -725,7 +937,7 @@ OmResult OmNetPack::supersede(Om_progressCb progress_cb, void* user_ptr)
     ModPset->save();
   }
 
-  // 3. rename or move to trash replaced Mods, this will delete
+  // 4. rename or move to trash replaced Mods, this will delete
   //    old Mod Pack from Library
 
   for(size_t i = 0; i < replaces.size(); ++i) {
@@ -760,52 +972,6 @@ OmResult OmNetPack::supersede(Om_progressCb progress_cb, void* user_ptr)
     }
   }
 
-  // as Mods are not downloaded sequentially and because dependencies are
-  // not handled at download end, it may happen that a dependencies mods
-  // are available for install before the Mod they depend on, which corrupt
-  // installation process.
-  //
-  // Until a proper download/upgrade dependency handling mechanism was
-  // found and implemented, the following piece of code stay disabled,
-  // leaving Mods uninstalled ready for manual install.
-
-  /*
-  // 4. install the new Mod if replaced ones was installed
-
-  if(!selection.empty()) { //< this mean old mod was installed
-
-    OmPModPackArray installs;
-    OmWStringArray missings;
-
-    selection.clear(); //< our mods selection
-
-    // add previously uninstalled packages
-    for(size_t i = 0; i < unins_hash.size(); ++i) {
-
-      OmModPack* ModPack = this->_ModChan->findModpack(unins_hash[i], true);
-
-      if(ModPack)
-        selection.push_back(ModPack);
-    }
-
-    // add this instance corresponding Mod Pack
-    selection.push_back(this_ModPack);
-
-    // clear all our processing lists
-    overlaps.clear(); depends.clear();
-
-    // prepare for installation
-    this->_ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
-
-    for(size_t i = 0; i < installs.size(); ++i) {
-      if(!installs[i]->applySource(OmNetPack::_sps_progress_fn, this)) {
-        this->_error(L"supersede", installs[i]->lastError());
-        has_error = true;
-      }
-    }
-  }
-  */
-
   this->_sps_percent = 0;
 
   // clear the replaced list, pointers are now invalid
@@ -21,13 +21,463 @@
 #include "OmUtilZip.h"
 #include "OmUtilB64.h"
 #include "OmUtilPkg.h"
+#include "OmUtilFs.h"
+#include "OmUtilThd.h"
+#include "OmUtilPrf.h"
+#include <map>
+#include <ctime>
 
 #include "OmImage.h"
+#include "OmXmlReader.h"
+#include "OmNetIndex.h"
 
 #include "OmModChan.h"
 
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 #include "OmNetRepo.h"
+
+/// \brief Definition base nodes
+///
+/// Bits of repository definition mandatory nodes found by streaming parser
+///
+#define REPO_HAS_UUID       0x1
+#define REPO_HAS_TITLE      0x2
+#define REPO_HAS_DOWNPATH   0x4
+#define REPO_HAS_ALL        0x7
+
+/// \brief Streaming query context
+///
+/// Structure holding streaming parser state while definition is received
+///
+typedef struct {
+
+  OmXmlReader       reader;
+
+  OmCString         magic;
+
+  OmConnect*        connect;
+
+  Om_referenceCb    ref_cb;
+
+  void*             user_ptr;
+
+  OmWString*        uuid;
+
+  OmWString*        title;
+
+  OmWString*        downpath;
+
+  uint32_t          found;
+
+  bool              use_index;
+
+  bool              indexed;
+
+  OmWString         index_sum;
+
+  uint64_t          index_bytes;
+
+  size_t            emitted;
+
+  const char*       ref_tag;
+
+  bool              in_ref;
+
+  bool              in_deps;
+
+  OmNetRef_t        ref;
+
+  OmNetRefArray     held;
+
+  int               state;
+
+  bool              cancel;
+
+} __stream_ctx_t;
+
+/// \brief Emit streamed reference
+///
+/// Passes a completely read Mod reference to the query callback.
+///
+/// \param[in]  ctx     : Streaming query context.
+/// \param[in]  ref     : Mod reference to emit.
+///
+/// \return False if callback requested to abort, true otherwise.
+///
+static bool __stream_emit(__stream_ctx_t* ctx, const OmNetRef_t& ref)
+{
+  // references need download path to compose URL, if not yet
+  // found, they are held until it is
+  if(!(ctx->found & REPO_HAS_DOWNPATH)) {
+    ctx->held.push_back(ref);
+    return true;
+  }
+
+  ctx->emitted++;
+
+  if(ctx->ref_cb && !ctx->ref_cb(ctx->user_ptr, &ref)) {
+    ctx->cancel = true;
+    return false;
+  }
+
+  return true;
+}
+
+/// \brief Parse streamed definition
+///
+/// Process XML reader events for currently available data, filling
+/// repository base parameters and emitting Mod references.
+///
+/// \param[in]  ctx     : Streaming query context.
+///
+/// \return Last reader event, OM_XMLREAD_ERROR if definition is invalid.
+///
+static int __stream_parse(__stream_ctx_t* ctx)
+{
+  OmXmlReader& reader = ctx->reader;
+
+  int event;
+
+  while((event = reader.next()) == OM_XMLREAD_OPEN || event == OM_XMLREAD_CLOSE) {
+
+    unsigned depth = reader.depth();
+
+    if(event == OM_XMLREAD_OPEN) {
+
+      if(depth == 1) {
+
+        if(reader.name() != ctx->magic)
+          return OM_XMLREAD_ERROR;
+
+      } else if(depth == 2) {
+
+        // <remotes> is the old deprecated XML schema, each schema has
+        // its own reference element name
+        if(reader.isName("references")) {
+          ctx->ref_tag = "mod";
+        } else if(reader.isName("remotes")) {
+          ctx->ref_tag = "remote";
+        } else {
+          ctx->ref_tag = nullptr;
+        }
+
+        // declared binary index replaces the remaining of definition, it
+        // is ignored once references were passed to callback
+        if(reader.isName("index") && ctx->use_index && ctx->emitted == 0) {
+          ctx->index_sum = reader.attrAsString("xxhsum");
+          ctx->index_bytes = reader.attrAsUint64("bytes");
+          if(!ctx->index_sum.empty()) {
+            ctx->indexed = true;
+            return OM_XMLREAD_MORE;
+          }
+        }
+
+      } else if(depth == 3 && ctx->ref_tag) {
+
+        if(reader.isName(ctx->ref_tag)) {
+
+          ctx->in_ref = true;
+          ctx->ref = OmNetRef_t();
+          ctx->ref.ident = reader.attrAsString("ident");
+          ctx->ref.file = reader.attrAsString("file");
+          ctx->ref.bytes = reader.attrAsUint64("bytes");
+          ctx->ref.xxhsum = reader.attrAsString("xxhsum");
+          ctx->ref.md5sum = reader.attrAsString("md5sum");
+          ctx->ref.category = reader.attrAsString("category");
+          ctx->ref.desc_bytes = 0;
+        }
+
+      } else if(depth == 4 && ctx->in_ref) {
+
+        if(reader.isName("description")) {
+          ctx->ref.desc_bytes = reader.attrAsUint64("bytes");
+        } else if(reader.isName("dependencies")) {
+          ctx->in_deps = true;
+        }
+      }
+
+    } else {
+
+      if(depth == 2) {
+
+        if(reader.isName("uuid")) {
+          *ctx->uuid = reader.content();
+          ctx->found |= REPO_HAS_UUID;
+        } else if(reader.isName("title")) {
+          *ctx->title = reader.content();
+          ctx->found |= REPO_HAS_TITLE;
+        } else if(reader.isName("downpath")) {
+          *ctx->downpath = reader.content();
+          ctx->found |= REPO_HAS_DOWNPATH;
+          // release held references
+          for(size_t i = 0; i < ctx->held.size(); ++i)
+            if(!__stream_emit(ctx, ctx->held[i]))
+              return OM_XMLREAD_ERROR;
+          ctx->held.clear();
+        }
+
+        ctx->ref_tag = nullptr;
+
+      } else if(depth == 3 && ctx->in_ref) {
+
+        ctx->in_ref = false;
+
+        if(!__stream_emit(ctx, ctx->ref))
+          return OM_XMLREAD_ERROR;
+
+      } else if(depth == 4 && ctx->in_ref) {
+
+        // <picture> is the old deprecated <thumbnail>, used only
+        // when <thumbnail> is missing
+        if(reader.isName("url")) {
+          ctx->ref.url = reader.content();
+        } else if(reader.isName("thumbnail")) {
+          ctx->ref.thumbnail = reader.content();
+        } else if(reader.isName("picture")) {
+          if(ctx->ref.thumbnail.empty())
+            ctx->ref.thumbnail = reader.content();
+        } else if(reader.isName("description")) {
+          ctx->ref.description = reader.content();
+        } else if(reader.isName("dependencies")) {
+          ctx->in_deps = false;
+        }
+
+      } else if(depth == 5 && ctx->in_deps) {
+
+        if(reader.isName("ident"))
+          ctx->ref.depends.push_back(reader.content());
+      }
+    }
+  }
+
+  // document is complete only if all base nodes were found
+  if(event == OM_XMLREAD_END && ctx->found != REPO_HAS_ALL)
+    return OM_XMLREAD_ERROR;
+
+  return event;
+}
+
+/// \brief Streamed data callback
+///
+/// Response callback that feeds received data chunks to the parser.
+///
+static void __stream_recv_fn(void* ptr, uint8_t* buf, uint64_t len, uint64_t param)
+{
+  OM_UNUSED(param);
+
+  __stream_ctx_t* ctx = static_cast<__stream_ctx_t*>(ptr);
+
+  if(ctx->state == OM_XMLREAD_ERROR || ctx->indexed)
+    return;
+
+  ctx->reader.feed(buf, len);
+
+  ctx->state = __stream_parse(ctx);
+
+  // stop transfer as soon as data is found invalid or binary
+  // index is to be loaded instead
+  if(ctx->state == OM_XMLREAD_ERROR || ctx->indexed)
+    ctx->connect->abortRequest();
+}
+
+/// \brief Encode thumbnail
+///
+/// Encodes the given image as JPEG Base64 data URI.
+///
+/// \param[out] data_uri  : Pointer to string that receive data URI.
+/// \param[in]  image     : Image to encode.
+/// \param[in]  level     : JPEG compression level (0-100).
+///
+/// \return True if operation succeed, false if JPEG encode failed.
+///
+static bool __encode_thumbnail(OmWString* data_uri, const OmImage& image, uint8_t level)
+{
+  // Encode RGBA to JPEG
+  uint64_t jpg_size;
+  uint8_t* jpg_data = Om_imgEncodeJpg(&jpg_size, image.data(), image.width(), image.height(), image.bpp(), level);
+
+  if(!jpg_data)
+    return false;
+
+  // format jpeg to base64 encoded data URI
+  Om_encodeDataUri(*data_uri, L"image/jpeg", L"", jpg_data, jpg_size);
+
+  // free allocated data
+  Om_free(jpg_data);
+
+  return true;
+}
+
+/// \brief Encode description
+///
+/// Compresses the given text and encodes it as Base64 data URI.
+///
+/// \param[out] data_uri  : Pointer to string that receive data URI.
+/// \param[out] bytes     : Pointer to value that receive uncompressed size.
+/// \param[in]  text      : Description text to encode.
+/// \param[in]  level     : Deflate compression level.
+///
+/// \return True if operation succeed, false if deflate failed.
+///
+static bool __encode_description(OmWString* data_uri, size_t* bytes, const OmWString& text, uint8_t level)
+{
+  // convert to UTF-8
+  OmCString utf8 = Om_toUTF8(text);
+
+  // text buffer size with null char
+  size_t txt_size = utf8.size() + 1;
+
+  // compress data using defalte
+  size_t dfl_size;
+  uint8_t* dfl_data = Om_zDeflate(&dfl_size, reinterpret_cast<const uint8_t*>(utf8.c_str()), txt_size, level);
+
+  if(!dfl_data)
+    return false;
+
+  // encode raw data to data URI Base64
+  Om_encodeDataUri(*data_uri, L"application/octet-stream", L"", dfl_data, dfl_size);
+
+  // free deflated data
+  Om_free(dfl_data);
+
+  *bytes = txt_size;
+
+  return true;
+}
+
+/// \brief Read reference node
+///
+/// Extracts Mod reference parameters from the given XML node.
+///
+/// \param[in]  ref_node  : Reference XML node.
+/// \param[out] ref       : Pointer to structure that receive parameters.
+///
+static void __ref_from_node(const OmXmlNode& ref_node, OmNetRef_t* ref)
+{
+  ref->ident = ref_node.attrAsString(L"ident");
+  ref->file = ref_node.attrAsString(L"file");
+  ref->bytes = ref_node.attrAsUint64(L"bytes");
+  ref->xxhsum = ref_node.attrAsString(L"xxhsum");
+  ref->md5sum = ref_node.attrAsString(L"md5sum");
+  ref->category = ref_node.attrAsString(L"category");
+
+  ref->url = ref_node.child(L"url").content();
+
+  // <picture> is the old deprecated <thumbnail>, as streaming query does
+  // it is used only when <thumbnail> is missing
+  if(ref_node.hasChild(L"thumbnail")) {
+    ref->thumbnail = ref_node.child(L"thumbnail").content();
+  } else {
+    ref->thumbnail = ref_node.child(L"picture").content();
+  }
+
+  OmXmlNode desc_node = ref_node.child(L"description");
+  ref->description = desc_node.content();
+  ref->desc_bytes = desc_node.attrAsUint64(L"bytes");
+
+  // raw data only available from binary index
+  ref->thumb_data = nullptr;
+  ref->thumb_size = 0;
+  ref->desc_data = nullptr;
+  ref->desc_size = 0;
+
+  ref->thumb_failed = false;
+  ref->desc_failed = false;
+
+  ref->depends.clear();
+
+  OmXmlNode deps_node = ref_node.child(L"dependencies");
+  for(const OmXmlNode& ident_node : deps_node.children(L"ident"))
+    ref->depends.push_back(ident_node.content());
+}
+
+/// \brief Write reference node
+///
+/// Sets or replaces Mod reference package parameters of the given XML
+/// node. Identity and custom URL are left untouched, as well as existing
+/// thumbnail or description whose encode failed.
+///
+/// \param[in]  ref_node  : Reference XML node.
+/// \param[in]  ref       : Mod reference parameters.
+///
+static void __ref_to_node(OmXmlNode& ref_node, const OmNetRef_t* ref)
+{
+  // set or replace references bases values
+  ref_node.setAttr(L"file", ref->file);
+  ref_node.setAttr(L"bytes", ref->bytes);
+  ref_node.setAttr(L"xxhsum", ref->xxhsum);
+  ref_node.setAttr(L"category", ref->category);
+
+  // set or replace dependencies
+  if(ref_node.hasChild(L"dependencies"))
+    ref_node.remChild(L"dependencies");
+
+  if(ref->depends.size()) {
+    OmXmlNode dependencies_nodes = ref_node.addChild(L"dependencies");
+    for(size_t i = 0; i < ref->depends.size(); ++i) {
+      dependencies_nodes.addChild(L"ident").setContent(ref->depends[i]);
+    }
+  }
+
+  // set, replace or delete thumbnail data
+  if(!ref->thumbnail.empty()) {
+    if(ref_node.hasChild(L"thumbnail")) {
+      ref_node.child(L"thumbnail").setContent(ref->thumbnail);
+    } else {
+      ref_node.addChild(L"thumbnail").setContent(ref->thumbnail);
+    }
+  } else if(!ref->thumb_failed) {
+    if(ref_node.hasChild(L"thumbnail"))
+      ref_node.remChild(L"thumbnail");
+  }
+
+  // set, replace or delete description data
+  if(!ref->description.empty()) {
+    OmXmlNode description_node;
+    if(ref_node.hasChild(L"description")) {
+      description_node = ref_node.child(L"description");
+    } else {
+      description_node = ref_node.addChild(L"description");
+    }
+    description_node.setContent(ref->description);
+    description_node.setAttr(L"bytes", static_cast<int>(ref->desc_bytes));
+  } else if(!ref->desc_failed) {
+    if(ref_node.hasChild(L"description"))
+      ref_node.remChild(L"description");
+  }
+}
+
+/// \brief Build context
+///
+/// Structure holding repository build state shared between workers
+///
+typedef struct {
+
+  OmNetRepo*            NetRepo;
+
+  const OmWStringArray* paths;
+
+  std::vector<size_t>   jobs;     ///< Indexes of packages to parse
+
+  OmNetRefArray         refs;
+
+  std::vector<uint8_t>  valid;
+
+  OmWStringArray        errors;   ///< Parse error of each package, if any
+
+  Om_progressCb         progress_cb;
+
+  void*                 user_ptr;
+
+  size_t                progress_tot;
+
+  size_t                progress_cur;
+
+  bool                  has_abort;
+
+  CRITICAL_SECTION      lock;
+
+} __build_ctx_t;
 
 
 ///
@@ -193,6 +643,65 @@ OmResult OmNetRepo::load(const OmWString& path)
 ///
 OmResult OmNetRepo::save(const OmWString& path)
 {
+  // write binary index alongside definition, thumbnails and descriptions
+  // are stored raw so Data URI are decoded here once for all
+  OmNetRefArray refs(this->_reference_list.size());
+
+  OmWString mime_type, charset;
+
+  for(size_t i = 0; i < refs.size(); ++i) {
+
+    OmNetRef_t& ref = refs[i];
+
+    this->getReference(i, &ref);
+
+    if(!ref.thumbnail.empty())
+      ref.thumb_data = Om_decodeDataUri(&ref.thumb_size, mime_type, charset, ref.thumbnail);
+
+    if(!ref.description.empty())
+      ref.desc_data = Om_decodeDataUri(&ref.desc_size, mime_type, charset, ref.description);
+  }
+
+  OmWString idx_path = Om_concatPathsExt(Om_getDirPart(path), Om_getNamePart(path), OM_REP_IDX_FILE_EXT);
+
+  bool indexed = OmNetIndex::write(idx_path, this->_uuid, this->_title, this->_downpath, refs);
+
+  for(size_t i = 0; i < refs.size(); ++i) {
+    if(refs[i].thumb_data) Om_free(const_cast<uint8_t*>(refs[i].thumb_data));
+    if(refs[i].desc_data) Om_free(const_cast<uint8_t*>(refs[i].desc_data));
+  }
+
+  // index is declared in definition with its checksum, placed before
+  // references so streaming clients read it first. A definition without
+  // valid declaration is never paired with an index file.
+  OmWString idx_sum;
+
+  if(indexed)
+    indexed = Om_getXXHsum(&idx_sum, idx_path);
+
+  if(indexed) {
+
+    if(!this->_xml.hasChild(L"index")) {
+      if(this->_xml.hasChild(L"references")) {
+        this->_xml.insertChild(L"index", this->_xml.child(L"references"));
+      } else if(this->_xml.hasChild(L"remotes")) {
+        this->_xml.insertChild(L"index", this->_xml.child(L"remotes"));
+      } else {
+        this->_xml.addChild(L"index");
+      }
+    }
+
+    OmXmlNode index_node = this->_xml.child(L"index");
+    index_node.setAttr(L"xxhsum", idx_sum);
+    index_node.setAttr(L"bytes", Om_itemSize(idx_path));
+
+  } else {
+
+    this->_xml.remChild(L"index");
+
+    this->_log(OM_LOG_WRN, L"save", Om_errSave(L"repository index", idx_path, L"write failed"));
+  }
+
   if(!this->_xml.save(path)) {
 
     this->_error(L"save", Om_errSave(L"repository definition", path, this->_xml.lastErrorStr()));
@@ -230,24 +739,116 @@ OmResult OmNetRepo::query()
   if(this->_base.empty() && this->_name.empty())
     return this->_query_result;
 
+  OmPerfScope perf(L"query", this->_base);
+
+  // create list of URL to try
+  OmWStringArray urls;
+  this->_query_urls(&urls);
+
+  // send synchronous request
+  OmXmlDoc parsexml;
+  OmCString respdata;
+
+  // the stuff bellow is used for error reporting in various test
+  // situations such as properties and wizard dialogs in order to avoid
+  // duplicate code (poor maintainability) and keep consistent behavior.
+  this->_query_respdata.clear();
+  this->_query_respcode = 0;
+  this->_query_lasterr.clear();
+
+  // the general query result
+  this->_query_result = OM_RESULT_PENDING;
+
+  for(size_t i = 0; i < urls.size(); ++i) {
+
+    #ifdef DEBUG
+    std::wcout << L"DEBUG => OmNetRepo::query : try url=" << urls[i] << L"\n";
+    #endif // DEBUG
+
+    OmResult result = this->_query_connect.requestHttpGet(urls[i], &respdata);
+
+    if(result == OM_RESULT_OK) {
+
+      // store HTTP response code
+      this->_query_respdata = Om_toUTF16(respdata);
+      this->_query_respcode = this->_query_connect.httpGetResponse();
+
+      // we verify we received valid XML data
+      if(!parsexml.parse(this->_query_respdata)) {
+        this->_query_result = OM_RESULT_ERROR_PARSE;
+        this->_query_lasterr = L"Received invalid data";
+        return this->_query_result;
+      }
+
+      // try to parse the XML data as repository
+      if(!this->parse(this->_query_respdata)) {
+        this->_query_result = OM_RESULT_ERROR_PARSE;
+        this->_query_lasterr = L"Invalid Repository XML";
+        return this->_query_result;
+      }
+
+      this->_path = urls[i]; //< save the working URL in path
+      this->_query_result = OM_RESULT_OK;
+      return this->_query_result;
+
+    } else {
+
+      if(result == OM_RESULT_ABORT) {
+
+        // operation aborted, we simply return
+
+        this->_query_result = OM_RESULT_ABORT;
+
+        return this->_query_result;
+
+      } else {
+
+        // since we try several URLs, at least one will result in 404 error, so to keep
+        // consistent error reporting we ignore 404 error unless we are a the end of
+        // list. If other error type occur, statistically this will be the same for both
+        // URLs so we don't care if we store errors for the first or the second one
+
+        if((this->_query_connect.httpGetResponse() != 404) || (i == (urls.size() - 1))) {
+
+          // store data if any (should not)
+          if(!respdata.empty())
+            this->_query_respdata = Om_toUTF16(respdata);
+
+          // store HTTP response code and error string
+          this->_query_respcode = this->_query_connect.httpGetResponse();
+          this->_query_lasterr = this->_query_connect.lastError();
+        }
+
+        this->_error(L"query", Om_errHttp(L"repository def", urls[i], this->_query_connect.lastError()));
+      }
+    }
+  }
+
+  // arriving here mean no URL succeed, this is a fail
+  this->_query_result = OM_RESULT_ERROR;
+
+  return this->_query_result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmNetRepo::query(Om_referenceCb ref_cb, void* user_ptr)
+{
+  // check for basic setup
+  if(this->_base.empty() && this->_name.empty())
+    return this->_query_result;
+
+  OmPerfScope perf(L"query", this->_base);
+
   // create list of URL to try
   OmWStringArray urls;
+  this->_query_urls(&urls);
 
-  if(this->_name.empty()) {
-    urls.push_back(this->_base);
-  } else {
-    // we test repository coordinates with two possible extension
-    urls.push_back(Om_concatURLs(this->_base, this->_name) + L"." OM_XML_DEF_EXT);
-    urls.push_back(Om_concatURLs(this->_base, this->_name) + L".xml");
-  }
-
-  // send synchronous request
-  OmXmlDoc parsexml;
-  OmCString respdata;
+  // definition document is not built
+  this->_xml.clear();
+  this->_reference_list.clear();
 
-  // the stuff bellow is used for error reporting in various test
-  // situations such as properties and wizard dialogs in order to avoid
-  // duplicate code (poor maintainability) and keep consistent behavior.
   this->_query_respdata.clear();
   this->_query_respcode = 0;
   this->_query_lasterr.clear();
@@ -255,29 +856,80 @@ OmResult OmNetRepo::query()
   // the general query result
   this->_query_result = OM_RESULT_PENDING;
 
+  __stream_ctx_t ctx;
+  ctx.magic = Om_toUTF8(OM_XMAGIC_REP);
+  ctx.connect = &this->_query_connect;
+  ctx.ref_cb = ref_cb;
+  ctx.user_ptr = user_ptr;
+  ctx.uuid = &this->_uuid;
+  ctx.title = &this->_title;
+  ctx.downpath = &this->_downpath;
+  ctx.use_index = !this->_name.empty();
+
   for(size_t i = 0; i < urls.size(); ++i) {
 
     #ifdef DEBUG
     std::wcout << L"DEBUG => OmNetRepo::query : try url=" << urls[i] << L"\n";
     #endif // DEBUG
 
-    OmResult result = this->_query_connect.requestHttpGet(urls[i], &respdata);
+    // reset parser state for this attempt
+    ctx.reader.clear();
+    ctx.found = 0;
+    ctx.indexed = false;
+    ctx.index_sum.clear();
+    ctx.index_bytes = 0;
+    ctx.emitted = 0;
+    ctx.ref_tag = nullptr;
+    ctx.in_ref = false;
+    ctx.in_deps = false;
+    ctx.held.clear();
+    ctx.state = OM_XMLREAD_MORE;
+    ctx.cancel = false;
+
+    OmResult result = this->_query_connect.requestHttpStream(urls[i], __stream_recv_fn, &ctx);
+
+    // transfer was stopped to load declared binary index, if index is
+    // unavailable or does not match, definition is queried again
+    if(ctx.indexed) {
+
+      result = this->_query_index(ctx.index_sum, ctx.index_bytes, ref_cb, user_ptr);
+
+      if(result == OM_RESULT_OK) {
+        this->_path = urls[i]; //< save the working URL in path
+        this->_query_result = OM_RESULT_OK;
+        return this->_query_result;
+      }
+
+      if(result == OM_RESULT_ABORT) {
+        this->_query_result = OM_RESULT_ABORT;
+        return this->_query_result;
+      }
+
+      ctx.use_index = false;
+      --i;
+      continue;
+    }
+
+    // parse error cause transfer abort, this is not user abort
+    if(ctx.state == OM_XMLREAD_ERROR && !ctx.cancel) {
+      this->_query_respcode = this->_query_connect.httpGetResponse();
+      this->_query_result = OM_RESULT_ERROR_PARSE;
+      this->_query_lasterr = L"Invalid Repository XML";
+      return this->_query_result;
+    }
 
     if(result == OM_RESULT_OK) {
 
-      // store HTTP response code
-      this->_query_respdata = Om_toUTF16(respdata);
       this->_query_respcode = this->_query_connect.httpGetResponse();
 
-      // we verify we received valid XML data
-      if(!parsexml.parse(this->_query_respdata)) {
-        this->_query_result = OM_RESULT_ERROR_PARSE;
-        this->_query_lasterr = L"Received invalid data";
-        return this->_query_result;
-      }
+      // parse remaining data
+      ctx.reader.finish();
 
-      // try to parse the XML data as repository
-      if(!this->parse(this->_query_respdata)) {
+      if(__stream_parse(&ctx) != OM_XMLREAD_END) {
+        if(ctx.cancel) {
+          this->_query_result = OM_RESULT_ABORT;
+          return this->_query_result;
+        }
         this->_query_result = OM_RESULT_ERROR_PARSE;
         this->_query_lasterr = L"Invalid Repository XML";
         return this->_query_result;
@@ -299,18 +951,8 @@ OmResult OmNetRepo::query()
 
       } else {
 
-        // since we try several URLs, at least one will result in 404 error, so to keep
-        // consistent error reporting we ignore 404 error unless we are a the end of
-        // list. If other error type occur, statistically this will be the same for both
-        // URLs so we don't care if we store errors for the first or the second one
-
+        // see comment in query() about 404 errors
         if((this->_query_connect.httpGetResponse() != 404) || (i == (urls.size() - 1))) {
-
-          // store data if any (should not)
-          if(!respdata.empty())
-            this->_query_respdata = Om_toUTF16(respdata);
-
-          // store HTTP response code and error string
           this->_query_respcode = this->_query_connect.httpGetResponse();
           this->_query_lasterr = this->_query_connect.lastError();
         }
@@ -323,7 +965,78 @@ OmResult OmNetRepo::query()
   // arriving here mean no URL succeed, this is a fail
   this->_query_result = OM_RESULT_ERROR;
 
-  return this->_query_result;
+  return this->_query_result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmNetRepo::_query_urls(OmWStringArray* urls) const
+{
+  if(this->_name.empty()) {
+    urls->push_back(this->_base);
+  } else {
+    // we test repository coordinates with two possible extension
+    urls->push_back(Om_concatURLs(this->_base, this->_name) + L"." OM_XML_DEF_EXT);
+    urls->push_back(Om_concatURLs(this->_base, this->_name) + L".xml");
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmNetRepo::_query_index(const OmWString& xxhsum, uint64_t bytes, Om_referenceCb ref_cb, void* user_ptr)
+{
+  OmWString idx_url = Om_concatURLs(this->_base, this->_name) + L"." OM_REP_IDX_FILE_EXT;
+
+  #ifdef DEBUG
+  std::wcout << L"DEBUG => OmNetRepo::_query_index : try url=" << idx_url << L"\n";
+  #endif // DEBUG
+
+  OmCString idx_data;
+
+  OmResult result = this->_query_connect.requestHttpGet(idx_url, &idx_data);
+
+  if(result != OM_RESULT_OK) {
+    if(result != OM_RESULT_ABORT)
+      this->_log(OM_LOG_WRN, L"query", Om_errHttp(L"repository index", idx_url, this->_query_connect.lastError()));
+    return result;
+  }
+
+  // index must be the one definition was saved with, a stale or
+  // partially uploaded index is rejected
+  uint64_t xxh = Om_getXXHash3(idx_data.data(), idx_data.size());
+
+  OmWString idx_sum;
+  Om_bytesToStrBe(&idx_sum, reinterpret_cast<const uint8_t*>(&xxh), 8);
+
+  OmNetIndex index;
+
+  if((bytes && bytes != idx_data.size()) || idx_sum != xxhsum ||
+     !index.attach(reinterpret_cast<const uint8_t*>(idx_data.data()), idx_data.size())) {
+    this->_log(OM_LOG_WRN, L"query", L"repository index \"" + idx_url + L"\" does not match definition");
+    return OM_RESULT_ERROR;
+  }
+
+  this->_query_respcode = this->_query_connect.httpGetResponse();
+
+  this->_uuid = index.uuid();
+  this->_title = index.title();
+  this->_downpath = index.downpath();
+
+  OmNetRef_t ref;
+
+  size_t n = index.referenceCount();
+  for(size_t i = 0; i < n; ++i) {
+
+    if(!index.getReference(i, &ref))
+      continue;
+
+    if(!ref_cb(user_ptr, &ref))
+      return OM_RESULT_ABORT;
+  }
+
+  return OM_RESULT_OK;
 }
 
 ///
@@ -352,6 +1065,19 @@ void OmNetRepo::setDownpath(const OmWString& downpath)
   this->_xml.child(L"downpath").setContent(this->_downpath);
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmNetRepo::getReference(size_t index, OmNetRef_t* ref) const
+{
+  if(index >= this->_reference_list.size())
+    return false;
+
+  __ref_from_node(this->_reference_list[index], ref);
+
+  return true;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -459,10 +1185,59 @@ void OmNetRepo::deleteReference(size_t index)
   this->_reference_list.erase(this->_reference_list.begin() + index);
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmNetRepo::makeReference(const OmModPack* ModPack, OmNetRef_t* ref)
+{
+  *ref = OmNetRef_t();
+
+  ref->ident = ModPack->iden();
+  ref->file = Om_getFilePart(ModPack->sourcePath());
+  ref->bytes = Om_itemSize(ModPack->sourcePath());
+  ref->xxhsum = Om_getXXHsum(ModPack->sourcePath()); //< use XXHash3 by default
+  ref->category = ModPack->category();
+
+  for(size_t i = 0; i < ModPack->dependCount(); ++i)
+    ref->depends.push_back(ModPack->getDependIden(i));
+
+  // encode thumbnail and description, left empty and flagged if failed
+  if(ModPack->thumbnail().valid()) {
+    if(!__encode_thumbnail(&ref->thumbnail, ModPack->thumbnail(), 70)) {
+      ref->thumbnail.clear();
+      ref->thumb_failed = true;
+    }
+  }
+
+  if(!ModPack->description().empty()) {
+    if(!__encode_description(&ref->description, &ref->desc_bytes, ModPack->description(), 6)) {
+      ref->description.clear();
+      ref->desc_failed = true;
+    }
+  }
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 int32_t OmNetRepo::addReference(const OmModPack* ModPack)
+{
+  OmNetRef_t ref;
+  OmNetRepo::makeReference(ModPack, &ref);
+
+  if(ref.thumb_failed)
+    this->_log(OM_LOG_WRN, L"addReference", L"thumbnail JPEG encode failed");
+
+  if(ref.desc_failed)
+    this->_log(OM_LOG_WRN, L"addReference", L"description deflate failed");
+
+  return this->addReference(&ref);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t OmNetRepo::addReference(const OmNetRef_t* ref)
 {
   // get references root node
   OmXmlNode references_node = this->_xml.child(L"references");
@@ -474,52 +1249,234 @@ int32_t OmNetRepo::addReference(const OmModPack* ModPack)
   OmXmlNode ref_node;
 
   // search whether reference with same identity exists
-  int32_t found = this->indexOfReference(ModPack->iden());
+  int32_t found = this->indexOfReference(ref->ident);
 
   if(found >= 0) {
     ref_node = this->_reference_list[found];
   } else {
     ref_node = references_node.addChild(L"mod");
     this->_reference_list.push_back(ref_node);
-    ref_node.setAttr(L"ident", ModPack->iden());
+    ref_node.setAttr(L"ident", ref->ident);
   }
 
-  // set or replace references bases values
-  ref_node.setAttr(L"file", Om_getFilePart(ModPack->sourcePath()));
-  ref_node.setAttr(L"bytes", Om_itemSize(ModPack->sourcePath()));
-  ref_node.setAttr(L"xxhsum", Om_getXXHsum(ModPack->sourcePath())); //< use XXHash3 by default
-  ref_node.setAttr(L"category", ModPack->category());
+  __ref_to_node(ref_node, ref);
 
-  // set or replace dependencies
-  if(ref_node.hasChild(L"dependencies"))
-    ref_node.remChild(L"dependencies");
+  return found;
+}
 
-  if(ModPack->dependCount()) {
-    OmXmlNode dependencies_nodes = ref_node.addChild(L"dependencies");
-    for(size_t i = 0; i < ModPack->dependCount(); ++i) {
-      dependencies_nodes.addChild(L"ident").setContent(ModPack->getDependIden(i));
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmNetRepo::build(const OmWStringArray& paths, const OmWString& cache_path, Om_progressCb progress_cb, void* user_ptr, unsigned threads)
+{
+  // in case of invalid call
+  if(this->_xml.child(L"references").empty()) {
+    this->_error(L"build", L"repository definition not initialized");
+    return OM_RESULT_ERROR;
+  }
+
+  this->_build_errors.clear();
+
+  // initialize chrono
+  clock_t time = clock();
+
+  // load build cache, entries are references with package path and
+  // last write time, an invalid or missing cache is simply ignored
+  OmXmlConf cache_cfg;
+  std::map<OmWString, OmXmlNode> cache_map;
+
+  if(!cache_path.empty() && cache_cfg.load(cache_path, OM_XMAGIC_RBC)) {
+    for(const OmXmlNode& n : cache_cfg.children(L"mod"))
+      cache_map[n.attrAsString(L"path")] = n;
+  }
+
+  __build_ctx_t ctx;
+  ctx.NetRepo = this;
+  ctx.paths = &paths;
+  ctx.refs.resize(paths.size());
+  ctx.valid.assign(paths.size(), 0);
+  ctx.errors.resize(paths.size());
+  ctx.progress_cb = progress_cb;
+  ctx.user_ptr = user_ptr;
+  ctx.progress_tot = paths.size();
+  ctx.progress_cur = 0;
+  ctx.has_abort = false;
+
+  std::vector<uint64_t> mtimes(paths.size());
+
+  // unchanged packages are taken from cache, others are queued
+  for(size_t i = 0; i < paths.size(); ++i) {
+
+    uint64_t bytes = Om_itemSize(paths[i]);
+    mtimes[i] = Om_itemTime(paths[i]);
+
+    std::map<OmWString, OmXmlNode>::const_iterator it = cache_map.find(paths[i]);
+
+    if(it != cache_map.end() && it->second.attrAsUint64(L"bytes") == bytes && it->second.attrAsUint64(L"mtime") == mtimes[i]) {
+
+      __ref_from_node(it->second, &ctx.refs[i]);
+      ctx.valid[i] = 1;
+
+      ctx.progress_cur++;
+      if(progress_cb && !progress_cb(user_ptr, ctx.progress_tot, ctx.progress_cur, i))
+        return OM_RESULT_ABORT;
+
+    } else {
+      ctx.jobs.push_back(i);
     }
   }
 
-  // set, replace or delete thumbnail data
-  if(ModPack->thumbnail().valid()) {
-    if(!this->_save_thumbnail(ref_node, ModPack->thumbnail()))
-      this->_log(OM_LOG_WRN, L"addReference", L"thumbnail JPEG encode failed");
-  } else {
-    if(ref_node.hasChild(L"thumbnail"))
-      ref_node.remChild(L"thumbnail");
+  size_t cached = paths.size() - ctx.jobs.size();
+
+  // parse packages, compute checksums and encode blobs in parallel
+  InitializeCriticalSection(&ctx.lock);
+
+  Om_parallelFor(ctx.jobs.size(), OmNetRepo::_build_job_fn, &ctx, threads);
+
+  DeleteCriticalSection(&ctx.lock);
+
+  if(ctx.has_abort)
+    return OM_RESULT_ABORT;
+
+  // add references and rebuild cache in packages order, so produced
+  // definition does not depend on workers scheduling
+  cache_cfg.init(OM_XMAGIC_RBC);
+
+  size_t failed = 0;
+
+  for(size_t i = 0; i < paths.size(); ++i) {
+
+    if(!ctx.valid[i]) {
+      this->_build_errors.push_back(ctx.errors[i]);
+      failed++;
+      continue;
+    }
+
+    this->addReference(&ctx.refs[i]);
+
+    // failed encode is retried at next build
+    if(ctx.refs[i].thumb_failed || ctx.refs[i].desc_failed)
+      continue;
+
+    OmXmlNode cache_node = cache_cfg.addChild(L"mod");
+    cache_node.setAttr(L"path", paths[i]);
+    cache_node.setAttr(L"mtime", mtimes[i]);
+    cache_node.setAttr(L"ident", ctx.refs[i].ident);
+    __ref_to_node(cache_node, &ctx.refs[i]);
   }
 
-  // set, replace or delete description data
-  if(!ModPack->description().empty()) {
-    if(!this->_save_description(ref_node, ModPack->description()))
-      this->_log(OM_LOG_WRN, L"addReference", L"description deflate failed");
+  if(!cache_path.empty()) {
+    if(!cache_cfg.save(cache_path))
+      this->_log(OM_LOG_WRN, L"build", Om_errSave(L"build cache", cache_path, cache_cfg.lastErrorStr()));
+  }
+
+  // making report
+  wchar_t done_str[128];
+  swprintf(done_str, 128, L"%u references, %u from cache, %u failed, done in %.2fs",
+           static_cast<unsigned>(paths.size() - failed), static_cast<unsigned>(cached),
+           static_cast<unsigned>(failed), (double)(clock()-time)/CLOCKS_PER_SEC);
+  this->_log(OM_LOG_OK, L"build", done_str);
+
+  return failed ? OM_RESULT_ERROR : OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmNetRepo::_build_job_fn(void* ptr, size_t index, unsigned worker)
+{
+  OM_UNUSED(worker);
+
+  __build_ctx_t* ctx = static_cast<__build_ctx_t*>(ptr);
+
+  size_t i = ctx->jobs[index];
+  const OmWString& path = (*ctx->paths)[i];
+
+  OmModPack ModPack;
+
+  bool parsed = ModPack.parseSource(path);
+
+  if(parsed)
+    OmNetRepo::makeReference(&ModPack, &ctx->refs[i]);
+
+  EnterCriticalSection(&ctx->lock);
+
+  if(parsed) {
+    ctx->valid[i] = 1;
   } else {
-    if(ref_node.hasChild(L"description"))
-      ref_node.remChild(L"description");
+    ctx->errors[i] = Om_errParse(L"Mod package", path, ModPack.lastError());
+    ctx->NetRepo->_log(OM_LOG_WRN, L"build", ctx->errors[i]);
   }
 
-  return found;
+  if(ctx->refs[i].thumb_failed)
+    ctx->NetRepo->_log(OM_LOG_WRN, L"build", path + L": thumbnail JPEG encode failed");
+
+  if(ctx->refs[i].desc_failed)
+    ctx->NetRepo->_log(OM_LOG_WRN, L"build", path + L": description deflate failed");
+
+  ctx->progress_cur++;
+  if(ctx->progress_cb) {
+    if(!ctx->progress_cb(ctx->user_ptr, ctx->progress_tot, ctx->progress_cur, i))
+      ctx->has_abort = true;
+  }
+
+  bool result = !ctx->has_abort;
+
+  LeaveCriticalSection(&ctx->lock);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+size_t OmNetRepo::verify(const OmWString& pkg_dir, OmWStringArray* mismatch, OmWStringArray* missing, unsigned io_limit)
+{
+  mismatch->clear();
+  missing->clear();
+
+  // references are verified by groups of same checksum algorithm, XXHash
+  // is preferred when both are given, as for download
+  OmWStringArray idens[2], paths[2], sums[2];
+
+  OmNetRef_t ref;
+
+  for(size_t i = 0; i < this->_reference_list.size(); ++i) {
+
+    __ref_from_node(this->_reference_list[i], &ref);
+
+    OmWString path = Om_concatPaths(pkg_dir, ref.file);
+
+    if(!Om_isFile(path)) {
+      missing->push_back(ref.ident);
+      continue;
+    }
+
+    unsigned a = ref.xxhsum.empty() ? 1 : 0;
+
+    idens[a].push_back(ref.ident);
+    paths[a].push_back(path);
+    sums[a].push_back(a ? ref.md5sum : ref.xxhsum);
+  }
+
+  size_t matches = 0;
+
+  OmIndexArray failed;
+
+  for(unsigned a = 0; a < 2; ++a) {
+
+    if(paths[a].empty())
+      continue;
+
+    matches += Om_cmpFileSums(&failed, paths[a], sums[a], a ? OM_HASH_MD5 : OM_HASH_XXH3, io_limit);
+
+    for(size_t k = 0; k < failed.size(); ++k) {
+      mismatch->push_back(idens[a][failed[k]]);
+      this->_log(OM_LOG_WRN, L"verify", paths[a][failed[k]] + L": checksum mismatch the reference");
+    }
+  }
+
+  return matches;
 }
 
 ///
@@ -723,11 +1680,10 @@ void OmNetRepo::getReferenceDepends(size_t index, OmWStringArray* depends) const
   // check for dependencies
   if(ref_node.hasChild(L"dependencies")) {
 
-    OmXmlNodeArray ident_nodes;
-    ref_node.child(L"dependencies").children(ident_nodes, L"ident");
+    OmXmlNode deps_node = ref_node.child(L"dependencies");
 
-    for(size_t i = 0; i < ident_nodes.size(); ++i)
-      depends->push_back(ident_nodes[i].content());
+    for(const OmXmlNode& ident_node : deps_node.children(L"ident"))
+      depends->push_back(ident_node.content());
   }
 }
 
@@ -753,19 +1709,10 @@ size_t OmNetRepo::getReferenceDependCount(size_t index) const
 ///
 bool OmNetRepo::_save_thumbnail(OmXmlNode& modref, const OmImage& image, uint8_t level)
 {
-  // Encode RGBA to JPEG
-  uint64_t jpg_size;
-  uint8_t* jpg_data = Om_imgEncodeJpg(&jpg_size, image.data(), image.width(), image.height(), image.bpp(), level);
-
-  if(!jpg_data)
-    return false;
-
-  // format jpeg to base64 encoded data URI
   OmWString data_uri;
-  Om_encodeDataUri(data_uri, L"image/jpeg", L"", jpg_data, jpg_size);
 
-  // free allocated data
-  Om_free(jpg_data);
+  if(!__encode_thumbnail(&data_uri, image, level))
+    return false;
 
   // set node content to data URI string
   if(modref.hasChild(L"thumbnail")) {
@@ -782,25 +1729,11 @@ bool OmNetRepo::_save_thumbnail(OmXmlNode& modref, const OmImage& image, uint8_t
 ///
 bool OmNetRepo::_save_description(OmXmlNode& modref, const OmWString& text, uint8_t level)
 {
-  // convert to UTF-8
-  OmCString utf8 = Om_toUTF8(text);
-
-  // text buffer size with null char
-  size_t txt_size = utf8.size() + 1;
-
-  // compress data using defalte
-  size_t dfl_size;
-  uint8_t* dfl_data = Om_zDeflate(&dfl_size, reinterpret_cast<const uint8_t*>(utf8.c_str()), txt_size, level);
-
-  if(!dfl_data)
-    return false;
-
-  // encode raw data to data URI Base64
   OmWString data_uri;
-  Om_encodeDataUri(data_uri, L"application/octet-stream", L"", dfl_data, dfl_size);
+  size_t txt_size;
 
-  // free deflated data
-  Om_free(dfl_data);
+  if(!__encode_description(&data_uri, &txt_size, text, level))
+    return false;
 
   OmXmlNode description_node;
 
@@ -503,6 +503,9 @@ void OmUiAddPst::_onInit()
   if(!this->_ModHub)
     return;
 
+  // make sure all channels libraries are loaded
+  this->_ModHub->activateChannels();
+
   OmWString cb_entry;
 
   // add Mod Channel(s) to Combo-Box
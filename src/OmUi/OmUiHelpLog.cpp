@@ -25,6 +25,13 @@
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 #include "OmUiHelpLog.h"
 
+/// \brief Custom window Message
+///
+/// Custom window message to pass a batch of new log lines to the dialog
+/// window, the message owns the OmWString pointed by lParam.
+///
+#define UWM_LOG_APPEND          (WM_APP+1)
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -58,15 +65,16 @@ long OmUiHelpLog::id() const
 ///
 void OmUiHelpLog::_log_notify_cb(void* ptr, OmNotify notify, uint64_t param)
 {
+  // called from log writer thread with a batch of log lines, the UI thread
+  // may be logging itself, so lines are posted, never sent, to the dialog
   OM_UNUSED(notify);
 
   OmUiHelpLog* self = reinterpret_cast<OmUiHelpLog*>(ptr);
 
-  size_t len = self->msgItem(IDC_EC_RESUL, WM_GETTEXTLENGTH);
-  self->msgItem(IDC_EC_RESUL, EM_SETSEL, len, len);
-  self->msgItem(IDC_EC_RESUL, EM_REPLACESEL, 0, static_cast<LPARAM>(param));
-  self->msgItem(IDC_EC_RESUL, WM_VSCROLL, SB_BOTTOM, 0);
-  self->msgItem(IDC_EC_RESUL, 0, 0, RDW_ERASE|RDW_INVALIDATE);
+  OmWString* lines = new OmWString(reinterpret_cast<const wchar_t*>(param));
+
+  if(!self->postMessage(UWM_LOG_APPEND, 0, reinterpret_cast<LPARAM>(lines)))
+    delete lines;
 }
 
 
@@ -88,9 +96,12 @@ void OmUiHelpLog::_onInit()
   if(!ModMan) return;
 
   this->msgItem(IDC_EC_RESUL, EM_SETLIMITTEXT, 0, 0);
-  this->msgItem(IDC_EC_RESUL, WM_SETTEXT, 0, reinterpret_cast<LPARAM>(ModMan->currentLog().c_str()));
 
-  ModMan->addLogNotify(OmUiHelpLog::_log_notify_cb, this);
+  // register and get current log at once, so no line is missed
+  OmWString current_log;
+  ModMan->addLogNotify(OmUiHelpLog::_log_notify_cb, this, &current_log);
+
+  this->msgItem(IDC_EC_RESUL, WM_SETTEXT, 0, reinterpret_cast<LPARAM>(current_log.c_str()));
 }
 
 
@@ -119,6 +130,11 @@ void OmUiHelpLog::_onQuit()
   if(!ModMan) return;
 
   ModMan->removeLogNotify(OmUiHelpLog::_log_notify_cb);
+
+  // release lines posted but not yet received
+  MSG msg;
+  while(PeekMessageW(&msg, this->_hwnd, UWM_LOG_APPEND, UWM_LOG_APPEND, PM_REMOVE))
+    delete reinterpret_cast<OmWString*>(msg.lParam);
 }
 
 ///
@@ -126,7 +142,19 @@ void OmUiHelpLog::_onQuit()
 ///
 INT_PTR OmUiHelpLog::_onMsg(UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
-  OM_UNUSED(lParam);
+  if(uMsg == UWM_LOG_APPEND) {
+
+    OmWString* lines = reinterpret_cast<OmWString*>(lParam);
+
+    size_t len = this->msgItem(IDC_EC_RESUL, WM_GETTEXTLENGTH);
+    this->msgItem(IDC_EC_RESUL, EM_SETSEL, len, len);
+    this->msgItem(IDC_EC_RESUL, EM_REPLACESEL, 0, reinterpret_cast<LPARAM>(lines->c_str()));
+    this->msgItem(IDC_EC_RESUL, WM_VSCROLL, SB_BOTTOM, 0);
+
+    delete lines;
+
+    return true;
+  }
 
   if(uMsg == WM_COMMAND) {
     switch(LOWORD(wParam))
@@ -85,7 +85,6 @@ OmUiMan::OmUiMan(HINSTANCE hins) : OmDialog(hins),
   _listview_himl(nullptr),
   _listview_himl_size(0),
   _psexec_count(0),
-  _psexec_idch(-1),
   _psexec_abort(false),
   _delchan_hth(nullptr),
   _delchan_hwo(nullptr),
@@ -1107,9 +1106,6 @@ void OmUiMan::_psexec_begin_fn(void* ptr, uint64_t param)
   OmModHub* ModHub = static_cast<OmModMan*>(self->_data)->activeHub();
   if(!ModHub) return;
 
-  // store the currently selected channel to restore it after
-  self->_psexec_idch = ModHub->activeChannelIndex();
-
   OmModPset* ModPset = reinterpret_cast<OmModPset*>(param);
 
   // get index of Preset in Hub, therefore, in ListView
@@ -1119,6 +1115,10 @@ void OmUiMan::_psexec_begin_fn(void* ptr, uint64_t param)
   LVITEMW lvI = {};
   lvI.mask = LVIF_IMAGE; lvI.iItem = lv_index; lvI.iSubItem = 0; lvI.iImage = ICON_STS_WIP;
   self->msgItem(IDC_LV_PST, LVM_SETITEMW, 0, reinterpret_cast<LPARAM>(&lvI));
+
+  // enter processing state
+  if(self->_UiManMainLib)
+    self->_UiManMainLib->presetBegin();
 }
 
 ///
@@ -1126,38 +1126,20 @@ void OmUiMan::_psexec_begin_fn(void* ptr, uint64_t param)
 ///
 bool OmUiMan::_psexec_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t param)
 {
-  OM_UNUSED(cur);
-
   OmUiMan* self = reinterpret_cast<OmUiMan*>(ptr);
 
-  OmModHub* ModHub = static_cast<OmModMan*>(self->_data)->activeHub();
-  if(!ModHub) return false;
-
+  // Mod operations are performed by the Mod Hub, possibly for several Channels
+  // at once, we only reflect progress, tot and cur being global progress.
   OmModPack* ModPack = reinterpret_cast<OmModPack*>(param);
 
-  int32_t chn_index = ModHub->indexOfChannel(ModPack->ModChan());
-
-  // FIXME: le changement de selection de channel n'est pas visible lors de l'installation du Preset
-  self->selectChannel(chn_index);
-
-  #ifdef DEBUG
-  std::wcout << L"DEBUG => OmUiMan::_psexec_progress_fn : chn_index=" << chn_index << L"\n";
-  #endif // DEBUG
-
-  OmResult result;
+  uint32_t percent = tot ? static_cast<uint32_t>((cur * 100) / tot) : 0;
 
   if(self->_UiManMainLib) {
-    if(tot > 0) {
-      result = self->_UiManMainLib->execInstalls(OmPModPackArray(1, ModPack), ModHub->presetQuietMode());
-    } else {
-      result = self->_UiManMainLib->execRestores(OmPModPackArray(1, ModPack), ModHub->presetQuietMode());
-    }
+    if(!self->_UiManMainLib->presetProgress(ModPack, percent))
+      self->_psexec_abort = true;
   } else {
-    result = OM_RESULT_ABORT;
-  }
-
-  if(result == OM_RESULT_ABORT)
     self->_psexec_abort = true;
+  }
 
   return !self->_psexec_abort;
 }
@@ -1184,12 +1166,9 @@ void OmUiMan::_psexec_result_fn(void* ptr, OmResult result, uint64_t param)
   lvI.mask = LVIF_IMAGE; lvI.iItem = lv_index; lvI.iSubItem = 0; lvI.iImage = ICON_NONE;
   self->msgItem(IDC_LV_PST, LVM_SETITEMW, 0, reinterpret_cast<LPARAM>(&lvI));
 
-  // select the initially selected channel
-  self->selectChannel(self->_psexec_idch);
-
-  #ifdef DEBUG
-  std::wcout << L"DEBUG => OmUiMan::_psexec_result_fn : _psexec_chan_sel=" << self->_psexec_idch << L"\n";
-  #endif // DEBUG
+  // leave processing state
+  if(self->_UiManMainLib)
+    self->_UiManMainLib->presetEnd();
 }
 
 
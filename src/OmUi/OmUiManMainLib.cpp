@@ -628,6 +628,61 @@ void OmUiManMainLib::queueCleaning(bool silent)
   this->_modops_add(restores);
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmUiManMainLib::presetBegin()
+{
+  // reset abort state
+  this->_modops_abort = false;
+
+  // enable 'kill-switch" abort button
+  this->enableItem(IDC_BC_ABORT, true);
+
+  // reset progress bar and enable it
+  this->enableItem(IDC_PB_MOD, true);
+  this->msgItem(IDC_PB_MOD, PBM_SETRANGE, 0, MAKELPARAM(0, 100));
+  this->msgItem(IDC_PB_MOD, PBM_SETPOS, 0);
+
+  // Preset may run Mod operations on any Channel
+  this->_setSafe(false);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmUiManMainLib::presetProgress(OmModPack* ModPack, uint32_t percent)
+{
+  // update Mod progress only if dialog is showing its Channel
+  if(ModPack->ModChan() == static_cast<OmModMan*>(this->_data)->activeChannel()) {
+
+    // get ListView item index search using lparam, that is, Mod Pack hash value.
+    int32_t item_id = this->findLvParam(IDC_LV_MOD, ModPack->hash());
+
+    // Invalidate ListView subitem rect to call custom draw (progress bar)
+    if(item_id >= 0) {
+      RECT rect;
+      this->getLvSubRect(IDC_LV_MOD, item_id, 4 /* 'Progress' column */, &rect);
+      this->redrawItem(IDC_LV_MOD, &rect, RDW_INVALIDATE|RDW_NOERASE|RDW_UPDATENOW);
+    }
+  }
+
+  // update the general progress bar with global Preset progress
+  this->msgItem(IDC_PB_MOD, PBM_SETPOS, percent + 1); //< this prevent transition
+  this->msgItem(IDC_PB_MOD, PBM_SETPOS, percent);
+
+  return !this->_modops_abort;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmUiManMainLib::presetEnd()
+{
+  // leaving processing state
+  this->_refresh_processing();
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -652,10 +707,10 @@ void OmUiManMainLib::_modlib_notify_fn(void* ptr, OmNotify notify, uint64_t para
 
   OmUiManMainLib* self = static_cast<OmUiManMainLib*>(ptr);
 
-  if(notify == OM_NOTIFY_ALTERED || notify == OM_NOTIFY_DELETED)
+  if(notify == OM_NOTIFY_ALTERED || notify == OM_NOTIFY_DELETED || notify == OM_NOTIFY_CREATED)
     self->_lv_mod_alterate(notify, param);
 
-  if(notify == OM_NOTIFY_REBUILD || notify == OM_NOTIFY_CREATED)
+  if(notify == OM_NOTIFY_REBUILD)
     self->_lv_mod_populate();
 }
 
@@ -1199,7 +1254,9 @@ void OmUiManMainLib::_lv_mod_alterate(OmNotify action, uint64_t param)
       std::cout << "DEBUG => OmUiManMainLib::_lv_mod_alterate : CREATE\n";
       #endif
 
-      // the first column, Mod status, here we INSERT the new item
+      // the first column, Mod status, here we INSERT the new item at
+      // the same position it was inserted in Mod Library
+      lvI.iItem = ModChan->indexOfModpack(ModPack);
       lvI.iSubItem = 0; lvI.mask = LVIF_IMAGE|LVIF_PARAM; //< icon and special data
       lvI.iImage = this->_lv_mod_get_status_icon(ModPack);
       // notice for later : to work properly the lParam must be defined on the first SubItem (iSubItem = 0)
@@ -458,6 +458,9 @@ void OmUiPropPstLst::_onTbRefresh()
   if(!ModHub)
     return;
 
+  // make sure all channels libraries are loaded
+  ModHub->activateChannels();
+
   // empty the ComboBox
   this->msgItem(IDC_CB_CHN, CB_RESETCONTENT);
 
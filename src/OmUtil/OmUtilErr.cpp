@@ -16,7 +16,7 @@
 */
 #include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
 
-#include "OmUtilWin.h"   //< Om_getErrorStr
+#include "OmUtilPlt.h"   //< Om_pltErrorStr
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
@@ -31,7 +31,7 @@ OmWString Om_errNotDir(const OmWString& item,  const OmWString& path)
 ///
 OmWString Om_errCreate(const OmWString& item,  const OmWString& path, int result)
 {
-  return item + L" \"" + path + L"\" creation error: " + Om_getErrorStr(result);
+  return item + L" \"" + path + L"\" creation error: " + Om_pltErrorStr(result);
 }
 
 ///
@@ -39,7 +39,7 @@ OmWString Om_errCreate(const OmWString& item,  const OmWString& path, int result
 ///
 OmWString Om_errDelete(const OmWString& item,  const OmWString& path, int result)
 {
-  return item + L" \"" + path + L"\" delete error: " + Om_getErrorStr(result);
+  return item + L" \"" + path + L"\" delete error: " + Om_pltErrorStr(result);
 }
 
 ///
@@ -47,7 +47,7 @@ OmWString Om_errDelete(const OmWString& item,  const OmWString& path, int result
 ///
 OmWString Om_errRename(const OmWString& item,  const OmWString& path, int result)
 {
-  return item + L" \"" + path + L"\" rename error: " + Om_getErrorStr(result);
+  return item + L" \"" + path + L"\" rename error: " + Om_pltErrorStr(result);
 }
 
 ///
@@ -55,7 +55,7 @@ OmWString Om_errRename(const OmWString& item,  const OmWString& path, int result
 ///
 OmWString Om_errMove(const OmWString& item,  const OmWString& path, int result)
 {
-  return item + L" \"" + path + L"\" move error: " + Om_getErrorStr(result);
+  return item + L" \"" + path + L"\" move error: " + Om_pltErrorStr(result);
 }
 
 ///
@@ -63,7 +63,7 @@ OmWString Om_errMove(const OmWString& item,  const OmWString& path, int result)
 ///
 OmWString Om_errCopy(const OmWString& item, const OmWString& path, int result)
 {
-  return item + L" \"" + path + L"\" copy error: " + Om_getErrorStr(result);
+  return item + L" \"" + path + L"\" copy error: " + Om_pltErrorStr(result);
 }
 
 ///
@@ -71,7 +71,7 @@ OmWString Om_errCopy(const OmWString& item, const OmWString& path, int result)
 ///
 OmWString Om_errShell(const OmWString& item, const OmWString& path, int result)
 {
-  return item + L" \"" + path + L"\" shell error: " + Om_getErrorStr(result);
+  return item + L" \"" + path + L"\" shell error: " + Om_pltErrorStr(result);
 }
 
 ///
@@ -14,201 +14,92 @@
   You should have received a copy of the GNU General Public License
   along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
 */
-#include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
+#include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
+#include <cwctype>            //< towlower
 
-
-#include "OmBaseWin.h"        //< WinAPI
-#include <shlwapi.h>          //< PathIsDirectoryEmptyW
-#include <shlobj.h>           //< SHCreateDirectoryExW
+#ifdef _WIN32
+  #include "OmBaseWin.h"      //< WinAPI, file handle functions
+#endif
+
+#include "OmUtilThd.h"
+#include "OmUtilPlt.h"
 
-#include "OmUtilWin.h"
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmUtilFs.h"
 
 #define READ_BUF_SIZE 524288
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool Om_isDirEmpty(const OmWString& path)
-{
-  return PathIsDirectoryEmptyW(path.c_str());
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-int Om_dirCreate(const OmWString& path)
-{
-  if(!CreateDirectoryW(path.c_str(), nullptr)) {
-    return GetLastError();
-  }
-  return 0;
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-int Om_dirCreateRecursive(const OmWString& path)
-{
-  return SHCreateDirectoryExW(nullptr, path.c_str(), nullptr);
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-int Om_dirDelete(const OmWString& path)
-{
-  if(!RemoveDirectoryW(path.c_str())) {
-    return GetLastError();
-  }
-  return 0;
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-int Om_fileCopy(const OmWString& src, const OmWString& dst, bool ow = true)
-{
-  if(!ow) {
-    if(GetFileAttributesW(dst.c_str()) != INVALID_FILE_ATTRIBUTES)
-      return 0; /* we do not write, but this is not a error */
-  }
-  if(!CopyFileW(src.c_str(),dst.c_str(), false)) {
-    return GetLastError();
-  }
-  return 0;
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-int Om_fileMove(const OmWString& src, const OmWString& dst)
-{
-  if(!MoveFileExW(src.c_str(),dst.c_str(),MOVEFILE_REPLACE_EXISTING|MOVEFILE_COPY_ALLOWED|MOVEFILE_WRITE_THROUGH)) {
-    return GetLastError();
-  }
-  return 0;
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-int Om_fileDelete(const OmWString& path)
-{
-  if(!DeleteFileW(path.c_str())) {
-    return GetLastError();
-  }
-  return 0;
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool Om_isFile(const OmWString& path)
-{
-  DWORD attr = GetFileAttributesW(path.c_str());
-  if(attr != INVALID_FILE_ATTRIBUTES)
-    return !(attr & FILE_ATTRIBUTE_DIRECTORY);
-  return false;
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool Om_isDir(const OmWString& path)
-{
-  DWORD attr = GetFileAttributesW(path.c_str());
-  if(attr != INVALID_FILE_ATTRIBUTES)
-    return (attr & FILE_ATTRIBUTE_DIRECTORY);
-  return false;
-}
 
+/// \brief Tree parallel minimum
 ///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+/// Minimum count of folders of the same depth to explore them using
+/// worker threads.
 ///
-bool Om_isHidden(const OmWString& path)
+#define LSTREE_PARALLEL_MIN 4
+
+/// \brief Zip signature search size
+///
+/// Size of file tail where to search for Zip Central-Directory signature,
+/// which is maximum End-Of-Central-Directory size with comment.
+///
+#define ZIP_TAIL_SIZE 65557
+
+/// \brief Match wildcard filter
+///
+/// Checks whether item name matches the given filter using '*' and '?'
+/// wildcards, comparison is case insensitive the same way Windows does.
+///
+/// \param[in]  name    : Item name to check.
+/// \param[in]  filter  : Filter to match.
+///
+/// \return True if name matches filter, false otherwise.
+///
+static bool __wildcard_match(const wchar_t* name, const wchar_t* filter)
 {
-  DWORD attr = GetFileAttributesW(path.c_str());
-  if(attr != INVALID_FILE_ATTRIBUTES)
-    return (attr & FILE_ATTRIBUTE_HIDDEN);
-  return false;
+  const wchar_t* star = nullptr;
+  const wchar_t* back = nullptr;
+
+  while(*name) {
+
+    if(*filter == L'*') {
+      star = ++filter; back = name;
+      continue;
+    }
+
+    if(*filter == L'?' || towlower(*filter) == towlower(*name)) {
+      ++filter; ++name;
+      continue;
+    }
+
+    // mismatch, let the last star absorb one more character
+    if(!star)
+      return false;
+
+    filter = star; name = ++back;
+  }
+
+  while(*filter == L'*')
+    ++filter;
+
+  return (*filter == 0);
 }
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool Om_pathIsNetwork(const OmWString& path)
-{
-  return PathIsNetworkPathW(path.c_str());
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool Om_pathExists(const OmWString& path)
-{
-  return PathFileExistsW(path.c_str());
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool Om_itemSetAttr(const OmWString& path, uint32_t attr)
-{
-  return SetFileAttributesW(path.c_str(), attr);
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool Om_itemHasAttr(const OmWString& path, uint32_t mask)
-{
-  DWORD attr = GetFileAttributesW(path.c_str());
-  if(attr != INVALID_FILE_ATTRIBUTES)
-    return ((mask & attr) == mask);
-  return false;
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-int Om_dirDeleteRecursive(const OmWString& path)
-{
-  wchar_t path_buf[OM_MAX_PATH];
-
-  wcscpy(path_buf, path.c_str());
-  path_buf[path.size()+1] = 0; // the buffer must end with double null character
-
-  SHFILEOPSTRUCTW fop = {};
-  fop.pFrom = path_buf;
-  fop.wFunc = FO_DELETE;
-  fop.fFlags = FOF_NO_UI;
-
-  int result = SHFileOperationW(&fop);
-
-  return result;
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool Om_isFileZip(const OmWString& path, bool quick)
+
+/// \brief Check Zip signatures
+///
+/// Checks Zip file signatures from the given opened file.
+///
+/// \param[in]  hfile   : File handle.
+/// \param[in]  quick   : Perform quick check without Central-Directory verification.
+///
+/// \return True if file has Zip signatures, false otherwise.
+///
+static bool __zip_check(void* hfile, bool quick)
 {
-  uint8_t read_buf[65557];
-  DWORD rb = 0;
-
-  HANDLE hFile = CreateFileW(path.c_str(),
-                             GENERIC_READ,
-                             FILE_SHARE_READ|FILE_SHARE_WRITE,
-                             nullptr,
-                             OPEN_EXISTING,
-                             FILE_ATTRIBUTE_NORMAL,
-                             nullptr);
-
-  if(hFile == INVALID_HANDLE_VALUE)
-    return false;
+  uint8_t read_buf[ZIP_TAIL_SIZE];
 
   // read the first file bytes to check for Local-File header PK\3\4
-  ReadFile(hFile, &read_buf, 130, &rb, nullptr);
+  int64_t rb = 0;
+  if(Om_pltFileSeek(hfile, 0))
+    rb = Om_pltFileRead(hfile, read_buf, 130);
 
   bool has_PK34 = false;
   if(rb >= 128) //< too small data cannot be valid ZIP file
@@ -216,10 +107,8 @@ bool Om_isFileZip(const OmWString& path, bool quick)
 
   // if there is no Local-File header signature this cannot be a ZIP file, otherwise
   // if this is a quick check we return result now
-  if(!has_PK34 || quick) {
-    CloseHandle(hFile);
+  if(!has_PK34 || quick)
     return has_PK34;
-  }
 
   // we now check for ZIP central directory header signature near end of file, if it exist
   // we have almost 100% chance this is a valid ZIP file.
@@ -228,314 +117,561 @@ bool Om_isFileZip(const OmWString& path, bool quick)
   // the end of file. The interval where the EOCD signature may exist is between 65557 and
   // 18 from the end.
 
-  rb = 0;
-  LARGE_INTEGER LargeDist;
-  LargeDist.QuadPart = -65557;
-  SetFilePointerEx(hFile, LargeDist, nullptr, FILE_END);
+  uint64_t size = Om_pltFileSize(hfile);
+  uint64_t tail = (size > ZIP_TAIL_SIZE) ? size - ZIP_TAIL_SIZE : 0;
 
-  ReadFile(hFile, &read_buf, 65557, &rb, nullptr);
-  CloseHandle(hFile);
+  rb = 0;
+  if(Om_pltFileSeek(hfile, tail))
+    rb = Om_pltFileRead(hfile, read_buf, ZIP_TAIL_SIZE);
 
   if(rb < 128)  //< too small data cannot be valid ZIP file
     return false;
 
-  while(rb--) {
+  while(rb-- > 3) {
     // check for Central-Directory header signature: PK\1\2 (little-endian)
-    if(*reinterpret_cast<uint32_t*>(&read_buf[rb]) == 0x02014b50)
+    if(*reinterpret_cast<uint32_t*>(&read_buf[rb - 3]) == 0x02014b50)
       return true;
   }
-
-  return false;
-}
+
+  return false;
+}
+
+/// \brief List directory items
+///
+/// Lists items of the specified directory which match the given kind
+/// and filter.
+///
+/// \param[out] ls       : Pointer to array of OmWString to be filled with result.
+/// \param[in]  orig     : Path where to list items from.
+/// \param[in]  dirs     : Include folders.
+/// \param[in]  files    : Include files.
+/// \param[in]  filter   : Wildcard filter for items name or nullptr.
+/// \param[in]  absolute : Format result as absolute paths.
+/// \param[in]  hidden   : Include items marked as Hidden.
+///
+static void __ls_items(OmWStringArray* ls, const OmWString& orig, bool dirs, bool files, const wchar_t* filter, bool absolute, bool hidden)
+{
+  void* hdir = Om_pltDirOpen(orig);
+  if(!hdir)
+    return;
+
+  OmPltDirEnt_t ent;
+  OmWString item;
+
+  while(Om_pltDirNext(hdir, &ent)) {
+
+    if(ent.isdir ? !dirs : !files)
+      continue;
+
+    // skip in case we do not include hidden items
+    if(!hidden && ent.hidden)
+      continue;
+
+    if(filter && !__wildcard_match(ent.name.c_str(), filter))
+      continue;
+
+    if(absolute) {
+      item = orig; item += L"\\"; item += ent.name;
+      ls->push_back(item);
+    } else {
+      ls->push_back(ent.name);
+    }
+  }
+
+  Om_pltDirClose(hdir);
+}
+
+/// \brief Delete tree
+///
+/// Deletes the specified folder and all its content, linked folders are
+/// deleted without their content.
+///
+/// \param[in]  path    : Path of folder to delete.
+///
+/// \return 0 if operation succeed, system error code otherwise.
+///
+static int __delete_tree(const OmWString& path)
+{
+  void* hdir = Om_pltDirOpen(path);
+  if(hdir) {
+
+    OmPltDirEnt_t ent;
+    OmWString item;
+
+    while(Om_pltDirNext(hdir, &ent)) {
+
+      item = path; item += L"\\"; item += ent.name;
+
+      int result;
+
+      if(ent.isdir && !ent.islink) {
+        result = __delete_tree(item);
+      } else if(ent.isdir) {
+        result = Om_pltDirDelete(item);
+      } else {
+        result = Om_pltFileDelete(item);
+      }
+
+      if(result != 0) {
+        Om_pltDirClose(hdir);
+        return result;
+      }
+    }
+
+    Om_pltDirClose(hdir);
+  }
+
+  return Om_pltDirDelete(path);
+}
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool Om_isFileZip(void* hFile, bool quick)
+bool Om_isDirEmpty(const OmWString& path)
 {
-  uint8_t read_buf[65557];
-  DWORD rb = 0;
+  void* hdir = Om_pltDirOpen(path);
+  if(!hdir)
+    return false;
 
-  // read first bytes of file
-  SetFilePointer(hFile, 0, 0, FILE_BEGIN);
-  ReadFile(hFile, &read_buf, 130, &rb, nullptr);
+  OmPltDirEnt_t ent;
+  bool empty = !Om_pltDirNext(hdir, &ent);
 
-  bool has_PK34 = false;
-  if(rb >= 128)  //< too small data cannot be valid ZIP file
-    has_PK34 = (*reinterpret_cast<uint32_t*>(read_buf) == 0x04034b50); //< Local-File header signature: PK\3\4 (little-endian)
+  Om_pltDirClose(hdir);
 
-  // if there is no Local-File header signature this cannot be a ZIP file, otherwise
-  // if this is a quick check we return result now
-  if(!has_PK34 || quick)
-    return has_PK34;
+  return empty;
+}
 
-  // we now check for ZIP central directory header signature near end of file, if it exist
-  // we have almost 100% chance this is a valid ZIP file.
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_dirCreate(const OmWString& path)
+{
+  return Om_pltDirCreate(path);
+}
 
-  // Depending on the comment length, the start of the EOCD will be at different offsets from
-  // the end of file. The interval where the EOCD signature may exist is between 65557 and
-  // 18 from the end.
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_dirCreateRecursive(const OmWString& path)
+{
+  OmPltItemStat_t stat;
+
+  // parent must exist, unless path is root of volume or share
+  size_t pos = path.find_last_of(L"\\/");
+  if(pos != OmWString::npos && pos > 0) {
+
+    OmWString parent = path.substr(0, pos);
+
+    if(parent.back() != L':' && !Om_pltItemStat(parent, &stat)) {
+      int result = Om_dirCreateRecursive(parent);
+      if(result != 0)
+        return result;
+    }
+  }
+
+  int result = Om_pltDirCreate(path);
+
+  // folder may have been created meanwhile by another thread
+  if(result != 0 && Om_pltItemStat(path, &stat) && stat.isdir)
+    return 0;
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_dirDelete(const OmWString& path)
+{
+  return Om_pltDirDelete(path);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_fileCopy(const OmWString& src, const OmWString& dst, bool ow)
+{
+  if(!ow) {
+    if(Om_pathExists(dst))
+      return 0; /* we do not write, but this is not a error */
+  }
+
+  return Om_pltFileCopy(src, dst);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_fileMove(const OmWString& src, const OmWString& dst)
+{
+  return Om_pltFileMove(src, dst);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_fileDelete(const OmWString& path)
+{
+  return Om_pltFileDelete(path);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_isFile(const OmWString& path)
+{
+  OmPltItemStat_t stat;
+  if(Om_pltItemStat(path, &stat))
+    return !stat.isdir;
+  return false;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_isDir(const OmWString& path)
+{
+  OmPltItemStat_t stat;
+  if(Om_pltItemStat(path, &stat))
+    return stat.isdir;
+  return false;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_isHidden(const OmWString& path)
+{
+  OmPltItemStat_t stat;
+  if(Om_pltItemStat(path, &stat))
+    return stat.hidden;
+  return false;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pathIsNetwork(const OmWString& path)
+{
+  return Om_pltPathIsNetwork(path);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pathExists(const OmWString& path)
+{
+  OmPltItemStat_t stat;
+  return Om_pltItemStat(path, &stat);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_dirDeleteRecursive(const OmWString& path)
+{
+  return __delete_tree(path);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_isFileZip(const OmWString& path, bool quick)
+{
+  void* hfile = Om_pltFileOpen(path, OM_PLT_FILE_READ);
+  if(!hfile)
+    return false;
+
+  bool result = __zip_check(hfile, quick);
 
-  rb = 0;
-  LARGE_INTEGER LargeDist;
-  LargeDist.QuadPart = -65557;
-  SetFilePointerEx(hFile, LargeDist, nullptr, FILE_END);
+  Om_pltFileClose(hfile);
 
-  ReadFile(hFile, &read_buf, 65557, &rb, nullptr);
+  return result;
+}
 
-  if(rb < 128)  //< too small data cannot be valid ZIP file
-    return false;
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_isFileZip(void* hFile, bool quick)
+{
+  return __zip_check(hFile, quick);
+}
 
-  while(rb--) {
-    // check for Central-Directory header signature: PK\1\2 (little-endian)
-    if(*reinterpret_cast<uint32_t*>(&read_buf[rb]) == 0x02014b50)
-      return true;
-  }
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_lsDir(OmWStringArray* ls, const OmWString& orig, bool absolute, bool hidden)
+{
+  __ls_items(ls, orig, true, false, nullptr, absolute, hidden);
+}
 
-  return false;
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_lsFile(OmWStringArray* ls, const OmWString& orig, bool absolute, bool hidden)
+{
+  __ls_items(ls, orig, false, true, nullptr, absolute, hidden);
 }
-
+
+/// \brief Folder tree node
 ///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+/// Explored folder with its enumerated items, in enumeration order. Items
+/// which are folders reference their own node.
 ///
-void Om_lsDir(OmWStringArray* ls, const OmWString& orig, bool absolute, bool hidden)
-{
-  OmWString item;
-
-  OmWString srch(orig);
-  srch += L"\\*";
-
-  WIN32_FIND_DATAW fd;
-  HANDLE hnd = FindFirstFileW(srch.c_str(), &fd);
-  if(hnd != INVALID_HANDLE_VALUE) {
-    do {
-      if(fd.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY) {
-        // skip this and parent folder
-        if(!wcscmp(fd.cFileName, L".")) continue;
-        if(!wcscmp(fd.cFileName, L"..")) continue;
-
-        // skip in case we do not include hidden items
-        if(!hidden && (fd.dwFileAttributes&FILE_ATTRIBUTE_HIDDEN))
-          continue;
+typedef struct {
+  OmWString       path;     //< folder absolute path
+  OmWString       from;     //< folder path relative to tree origin
+  int32_t         parent;   //< parent node index, -1 for origin
+  OmWStringArray  name;     //< items names
+  std::vector<int32_t> node; //< items node index, -1 for files, -2 for folders not explored
+} __tree_node_t;
 
-        if(absolute) {
-          item = orig; item += L"\\"; item += fd.cFileName;
-          ls->push_back(item);
-        } else {
-          ls->push_back(fd.cFileName);
-        }
-      }
-    } while(FindNextFileW(hnd, &fd));
-  }
-  FindClose(hnd);
-}
+/// \brief Folder tree exploration context
+///
+/// Shared data for folder tree exploration workers.
+///
+typedef struct {
+  std::vector<__tree_node_t*> nodes;
+  std::vector<size_t>   level;
+  bool                  hidden;
+} __tree_ctx_t;
 
+/// \brief Check tree loop
 ///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+/// Checks whether the given linked folder resolves to the folder which
+/// contains it or one of its ancestors, in which case exploring it would
+/// never end.
 ///
-void Om_lsFile(OmWStringArray* ls, const OmWString& orig, bool absolute, bool hidden)
+/// \param[in]  ctx     : Pointer to exploration context.
+/// \param[in]  node    : Node of folder which contains the link.
+/// \param[in]  path    : Path to linked folder.
+///
+/// \return True if linked folder is an ancestor, false otherwise.
+///
+static bool __tree_is_loop(const __tree_ctx_t* ctx, const __tree_node_t* node, const OmWString& path)
 {
-  OmWString item;
+  uint64_t vol, idx, anc_vol, anc_idx;
 
-  OmWString srch(orig);
-  srch += L"\\*";
+  if(!Om_pltItemIdent(path, &vol, &idx))
+    return true; //< broken link, nothing to explore
 
-  WIN32_FIND_DATAW fd;
-  HANDLE hnd = FindFirstFileW(srch.c_str(), &fd);
-  if(hnd != INVALID_HANDLE_VALUE) {
-    do {
-      if(!(fd.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY)) {
+  while(node) {
 
-        // skip in case we do not include hidden items
-        if(!hidden && (fd.dwFileAttributes&FILE_ATTRIBUTE_HIDDEN))
-          continue;
+    if(Om_pltItemIdent(node->path, &anc_vol, &anc_idx))
+      if(anc_vol == vol && anc_idx == idx)
+        return true;
 
-        if(absolute) {
-          item = orig; item += L"\\"; item += fd.cFileName;
-          ls->push_back(item);
-        } else {
-          ls->push_back(fd.cFileName);
-        }
-      }
-    } while(FindNextFileW(hnd, &fd));
+    node = (node->parent >= 0) ? ctx->nodes[node->parent] : nullptr;
   }
-  FindClose(hnd);
+
+  return false;
 }
 
-/// \brief List files recursively
+/// \brief Explore tree folder
+///
+/// Job callback that enumerates items of a single folder of the current
+/// explored depth.
 ///
-/// This is the static function used to list files recursively.
+/// \param[in]  ptr     : Pointer to exploration context.
+/// \param[in]  index   : Index of folder in current level.
+/// \param[in]  worker  : Worker index.
 ///
-/// \param[out] ls      : Pointer to array of OmWString to be filled with result.
-/// \param[in]  orig    : Path where to list items from.
-/// \param[in]  from    : Path to prepend to result to obtain the item full
-///                       path from the beginning of the tree exploration.
-/// \param[in]  hidden  : Include items marked as Hidden.
+/// \return Always true.
 ///
-static void __lsFile_Recurse(OmWStringArray* ls, const OmWString& orig, const OmWString& from, bool hidden)
+static bool __tree_job_fn(void* ptr, size_t index, unsigned worker)
 {
-  OmWString item;
-  OmWString root;
+  OM_UNUSED(worker);
+
+  __tree_ctx_t* ctx = static_cast<__tree_ctx_t*>(ptr);
+  __tree_node_t* node = ctx->nodes[ctx->level[index]];
 
-  OmWString srch(orig);
-  srch += L"\\*";
+  void* hdir = Om_pltDirOpen(node->path);
+  if(hdir) {
 
-  WIN32_FIND_DATAW fd;
-  HANDLE hnd = FindFirstFileW(srch.c_str(), &fd);
-  if(hnd != INVALID_HANDLE_VALUE) {
-    do {
-      // skip this and parent folder
-      if(!wcscmp(fd.cFileName, L".")) continue;
-      if(!wcscmp(fd.cFileName, L"..")) continue;
+    OmPltDirEnt_t ent;
+
+    while(Om_pltDirNext(hdir, &ent)) {
 
       // skip in case we do not include hidden items
-      if(!hidden && (fd.dwFileAttributes&FILE_ATTRIBUTE_HIDDEN))
+      if(!ctx->hidden && ent.hidden)
         continue;
 
-      if(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-        item = from; item += L"\\"; item += fd.cFileName;
-        root = orig; root += L"\\"; root += fd.cFileName;
-        // go deep in tree
-        __lsFile_Recurse(ls, root, item, hidden);
+      node->name.push_back(ent.name);
 
-      } else {
-        item = from; item += L"\\"; item += fd.cFileName;
-        ls->push_back(item);
+      // linked folders are followed unless they lead back to an ancestor
+      if(ent.isdir && ent.islink) {
+        OmWString path = node->path; path += L"\\"; path += ent.name;
+        if(__tree_is_loop(ctx, node, path)) {
+          node->node.push_back(-2);
+          continue;
+        }
       }
-    } while(FindNextFileW(hnd, &fd));
-  }
-  FindClose(hnd);
-}
 
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-void Om_lsFileRecursive(OmWStringArray* ls, const OmWString& origin, bool absolute, bool hidden)
-{
-  if(absolute) {
-    __lsFile_Recurse(ls, origin.c_str(), origin.c_str(), hidden);
-  } else {
-    __lsFile_Recurse(ls, origin.c_str(), L"", hidden);
+      // folders are given a node once the whole level is explored
+      node->node.push_back(ent.isdir ? 0 : -1);
+    }
+
+    Om_pltDirClose(hdir);
   }
+
+  return true;
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void Om_lsFileFiltered(OmWStringArray* ls, const OmWString& orig, const OmWString& filter, bool absolute, bool hidden)
+void Om_lsTree(OmTreeItemArray* ls, const OmWString& origin, bool hidden, unsigned threads)
 {
-  OmWString item;
-  OmWString root;
+  __tree_ctx_t ctx;
+  ctx.hidden = hidden;
+
+  __tree_node_t* root = new __tree_node_t;
+  root->path = origin;
+  root->parent = -1;
+
+  ctx.nodes.push_back(root);
+  ctx.level.push_back(0);
+
+  // explore tree breadth-first, folders of the same depth are queued then
+  // explored by workers, each one filling its own node.
+  while(ctx.level.size()) {
+
+    unsigned workers = (ctx.level.size() < LSTREE_PARALLEL_MIN) ? 1 : threads;
+
+    Om_parallelFor(ctx.level.size(), __tree_job_fn, &ctx, workers);
+
+    // queue sub-folders for the next depth, in tree order
+    std::vector<size_t> next;
+
+    for(size_t l = 0; l < ctx.level.size(); ++l) {
 
-  OmWString srch(orig);
-  srch += L"\\" + filter;
+      __tree_node_t* node = ctx.nodes[ctx.level[l]];
 
-  WIN32_FIND_DATAW fd;
-  HANDLE hnd = FindFirstFileW(srch.c_str(), &fd);
-  if(hnd != INVALID_HANDLE_VALUE) {
-    do {
-      if(!(fd.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY)) {
+      for(size_t i = 0; i < node->name.size(); ++i) {
 
-        // skip in case we do not include hidden items
-        if(!hidden && (fd.dwFileAttributes&FILE_ATTRIBUTE_HIDDEN))
+        if(node->node[i] < 0)
           continue;
 
-        if(absolute) {
-          item = orig; item += L"\\"; item += fd.cFileName;
-          ls->push_back(item);
+        __tree_node_t* child = new __tree_node_t;
+        child->path = node->path; child->path += L"\\"; child->path += node->name[i];
+        child->parent = ctx.level[l];
+
+        if(node->from.empty()) {
+          child->from = node->name[i];
         } else {
-          ls->push_back(fd.cFileName);
+          child->from = node->from; child->from += L"\\"; child->from += node->name[i];
         }
+
+        node->node[i] = ctx.nodes.size();
+        next.push_back(ctx.nodes.size());
+        ctx.nodes.push_back(child);
       }
-    } while(FindNextFileW(hnd, &fd));
+    }
+
+    ctx.level.swap(next);
   }
-  FindClose(hnd);
-}
 
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-void Om_lsAll(OmWStringArray* ls, const OmWString& orig, bool absolute, bool hidden)
-{
-  OmWString item;
+  // walk the explored tree depth-first to output items in the same
+  // order a recursive exploration would do
+  OmTreeItem_t item;
 
-  OmWString srch(orig); srch += L"\\*";
-  WIN32_FIND_DATAW fd;
-  HANDLE hnd = FindFirstFileW(srch.c_str(), &fd);
-  if(hnd != INVALID_HANDLE_VALUE) {
-    do {
-      // skip this and parent folder
-      if(!wcscmp(fd.cFileName, L".")) continue;
-      if(!wcscmp(fd.cFileName, L"..")) continue;
+  std::vector<size_t> stack_node, stack_item;
+  stack_node.push_back(0);
+  stack_item.push_back(0);
 
-      // skip in case we do not include hidden items
-      if(!hidden && (fd.dwFileAttributes&FILE_ATTRIBUTE_HIDDEN))
-        continue;
+  while(stack_node.size()) {
 
-      if(absolute) {
-        item = orig; item += L"\\"; item += fd.cFileName;
-        ls->push_back(item);
-      } else {
-        ls->push_back(fd.cFileName);
-      }
-    } while(FindNextFileW(hnd, &fd));
+    __tree_node_t* node = ctx.nodes[stack_node.back()];
+    size_t i = stack_item.back();
+
+    if(i >= node->name.size()) {
+      stack_node.pop_back(); stack_item.pop_back();
+      continue;
+    }
+
+    stack_item.back()++;
+
+    if(node->from.empty()) {
+      item.path = node->name[i];
+    } else {
+      item.path = node->from; item.path += L"\\"; item.path += node->name[i];
+    }
+
+    item.isdir = (node->node[i] >= 0 || node->node[i] == -2);
+
+    ls->push_back(item);
+
+    // go deep in tree
+    if(node->node[i] >= 0) {
+      stack_node.push_back(node->node[i]);
+      stack_item.push_back(0);
+    }
   }
-  FindClose(hnd);
+
+  for(size_t i = 0; i < ctx.nodes.size(); ++i)
+    delete ctx.nodes[i];
 }
 
-/// \brief List files and folders recursively
-///
-/// This is the static function used to list files and folder recursively.
 ///
-/// \param[out] ls      : Pointer to array of OmWString to be filled with result.
-/// \param[in]  orig    : Path where to list items from.
-/// \param[in]  from    : Path to prepend to result to obtain the item full
-///                       path from the beginning of the tree exploration.
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-static void __lsAll_Recurse(OmWStringArray* ls, const OmWString& orig, const OmWString& from, bool hidden)
+void Om_lsFileRecursive(OmWStringArray* ls, const OmWString& origin, bool absolute, bool hidden)
 {
-  OmWString item;
-  OmWString root;
+  OmTreeItemArray tree;
+  Om_lsTree(&tree, origin, hidden);
 
-  OmWString srch(orig);
-  srch += L"\\*";
+  OmWString item;
 
-  WIN32_FIND_DATAW fd;
-  HANDLE hnd = FindFirstFileW(srch.c_str(), &fd);
-  if(hnd != INVALID_HANDLE_VALUE) {
-    do {
-      // skip this and parent folder
-      if(!wcscmp(fd.cFileName, L".")) continue;
-      if(!wcscmp(fd.cFileName, L"..")) continue;
+  for(size_t i = 0; i < tree.size(); ++i) {
 
-      // skip in case we do not include hidden items
-      if(!hidden && (fd.dwFileAttributes&FILE_ATTRIBUTE_HIDDEN))
-        continue;
+    if(tree[i].isdir)
+      continue;
 
-      item = from; item += L"\\"; item += fd.cFileName;
+    if(absolute) {
+      item = origin; item += L"\\"; item += tree[i].path;
+    } else {
+      item = L"\\"; item += tree[i].path;
+    }
 
-      if(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-        ls->push_back(item);
-        // go deep in tree
-        root = orig; root += L"\\"; root += fd.cFileName;
-        __lsAll_Recurse(ls, root, item, hidden);
-      } else {
-        ls->push_back(item);
-      }
-    } while(FindNextFileW(hnd, &fd));
+    ls->push_back(item);
   }
-  FindClose(hnd);
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_lsFileFiltered(OmWStringArray* ls, const OmWString& orig, const OmWString& filter, bool absolute, bool hidden)
+{
+  __ls_items(ls, orig, false, true, filter.c_str(), absolute, hidden);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_lsAll(OmWStringArray* ls, const OmWString& orig, bool absolute, bool hidden)
+{
+  __ls_items(ls, orig, true, true, nullptr, absolute, hidden);
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 void Om_lsAllRecursive(OmWStringArray* ls, const OmWString& origin, bool absolute, bool hidden)
 {
-  if(absolute) {
-    __lsAll_Recurse(ls, origin.c_str(), origin.c_str(), hidden);
-  } else {
-    __lsAll_Recurse(ls, origin.c_str(), L"", hidden);
+  OmTreeItemArray tree;
+  Om_lsTree(&tree, origin, hidden);
+
+  OmWString item;
+
+  for(size_t i = 0; i < tree.size(); ++i) {
+
+    if(absolute) {
+      item = origin; item += L"\\"; item += tree[i].path;
+    } else {
+      item = L"\\"; item += tree[i].path;
+    }
+
+    ls->push_back(item);
   }
 }
 
@@ -548,247 +684,103 @@ void Om_lsAllRecursive(OmWStringArray* ls, const OmWString& origin, bool absolut
 /// \param[in]  orig    : Path of folder to get total size (start of recursive
 ///                       exploration).
 ///
-static void __folderSize(uint64_t* size, const OmWString& orig)
-{
-  OmWString root;
-
-  LARGE_INTEGER FileSize;
-
-  OmWString srch(orig); srch += L"\\*";
-  WIN32_FIND_DATAW fd;
-  HANDLE hnd = FindFirstFileW(srch.c_str(), &fd);
-  if(hnd != INVALID_HANDLE_VALUE) {
-    do {
-      // skip this and parent folder
-      if(!wcscmp(fd.cFileName, L".")) continue;
-      if(!wcscmp(fd.cFileName, L"..")) continue;
-
-      if(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-        root = orig; root += L"\\"; root += fd.cFileName;
-
-        // go deep in tree
-        __folderSize(size, root);
-
-      } else {
-        root = orig; root += L"\\"; root += fd.cFileName;
-        HANDLE hFile = CreateFileW(root.c_str(),
-                                   GENERIC_READ,
-                                   FILE_SHARE_READ,
-                                   nullptr,
-                                   OPEN_EXISTING,
-                                   FILE_ATTRIBUTE_NORMAL,
-                                   nullptr);
-
-        GetFileSizeEx(hFile, &FileSize);
-        *size += FileSize.QuadPart;
-
-        CloseHandle(hFile);
-      }
-    } while(FindNextFileW(hnd, &fd));
-  }
-  FindClose(hnd);
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-uint64_t Om_itemSize(const OmWString& path)
-{
-  uint64_t ret = 0;
-
-  if(Om_isFile(path)) {
-    LARGE_INTEGER FileSize;
-    HANDLE hFile = CreateFileW(path.c_str(),
-                               GENERIC_READ,
-                               FILE_SHARE_READ,
-                               nullptr,
-                               OPEN_EXISTING,
-                               FILE_ATTRIBUTE_NORMAL,
-                               nullptr);
-
-    GetFileSizeEx(hFile, &FileSize);
-    CloseHandle(hFile);
-    ret = FileSize.QuadPart;
-
-  } else {
-    ret = 0;
-    __folderSize(&ret, path);
-  }
-
-  return ret;
+static void __folderSize(uint64_t* size, const OmWString& orig)
+{
+  void* hdir = Om_pltDirOpen(orig);
+  if(!hdir)
+    return;
+
+  OmPltDirEnt_t ent;
+  OmPltItemStat_t stat;
+  OmWString root;
+
+  while(Om_pltDirNext(hdir, &ent)) {
+
+    root = orig; root += L"\\"; root += ent.name;
+
+    if(ent.isdir) {
+
+      // go deep in tree
+      __folderSize(size, root);
+
+    } else {
+
+      if(Om_pltItemStat(root, &stat))
+        *size += stat.size;
+    }
+  }
+
+  Om_pltDirClose(hdir);
 }
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-time_t Om_itemTime(const OmWString& path)
-{
-  HANDLE hFile = CreateFileW(path.c_str(),
-                             GENERIC_READ,
-                             FILE_SHARE_READ,
-                             nullptr,
-                             OPEN_EXISTING,
-                             FILE_ATTRIBUTE_NORMAL,
-                             nullptr);
-
-  if(hFile == INVALID_HANDLE_VALUE)
-    return 0;
-
-  FILETIME fTime;
-  GetFileTime(hFile, nullptr, nullptr, &fTime);
-  CloseHandle(hFile);
-
-  ULARGE_INTEGER ull;
-  ull.LowPart = fTime.dwLowDateTime;
-  ull.HighPart = fTime.dwHighDateTime;
-
-  return ull.QuadPart / 10000000ULL - 11644473600ULL;
-}
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-int Om_moveToTrash(const OmWString& path)
-{
-  wchar_t path_buf[OM_MAX_PATH];
-
-  wcscpy(path_buf, path.c_str());
-  path_buf[path.size()+1] = 0;
-
-  SHFILEOPSTRUCTW fop = {};
-  fop.pFrom = path_buf;
-  fop.wFunc = FO_DELETE;
-  fop.fFlags = FOF_NO_UI|FOF_ALLOWUNDO;
-
-  int result = SHFileOperationW(&fop);
-
-  return result;
-}
-
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint64_t Om_itemSize(const OmWString& path)
+{
+  uint64_t ret = 0;
+
+  OmPltItemStat_t stat;
+  if(!Om_pltItemStat(path, &stat))
+    return 0;
+
+  if(!stat.isdir) {
+    ret = stat.size;
+  } else {
+    ret = 0;
+    __folderSize(&ret, path);
+  }
+
+  return ret;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+time_t Om_itemTime(const OmWString& path)
+{
+  OmPltItemStat_t stat;
+  if(!Om_pltItemStat(path, &stat))
+    return 0;
+
+  return stat.mtime;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_moveToTrash(const OmWString& path)
+{
+  return Om_pltItemTrash(path);
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool Om_checkAccess(const OmWString& path, unsigned mask)
-{
-  // Thanks to this article for giving some clues :
-  // http://blog.aaronballman.com/2011/08/how-to-check-access-rights/
-
-  // STEP 1 - retrieve the "security descriptor" (i.e owner, group, access
-  // rights, etc. ) of the specified file or folder.
-  SECURITY_DESCRIPTOR* pSd;
-  DWORD sdSize;
-  // here is the mask for file permission informations we want to retrieve it
-  // seem to be the minimum required for an access check request
-  DWORD sdMask =  OWNER_SECURITY_INFORMATION | GROUP_SECURITY_INFORMATION
-                | DACL_SECURITY_INFORMATION;
-  // first call to get required SECURITY_DESCRIPTOR size
-  GetFileSecurityW(path.c_str(), sdMask, nullptr, 0, &sdSize);
-  // allocate new SECURITY_DESCRIPTOR of the proper size
-  pSd = reinterpret_cast<SECURITY_DESCRIPTOR*>(Om_alloc(sdSize + 1));
-  // second call to get SECURITY_DESCRIPTOR data
-  if(!GetFileSecurityW(path.c_str(), sdMask, pSd, sdSize, &sdSize)) {
-    Om_free(pSd);
-    #ifdef DEBUG
-    std::wcout << "DEBUG => Om_checkAccess :: GetFileSecurityW failed\n";
-    #endif
-    return false;
-  }
-
-  // STEP 2 - creates a "security token" of the current application process
-  //to be checked against the file or folder "security descriptor"
-  DWORD daMask =  TOKEN_IMPERSONATE | TOKEN_QUERY | TOKEN_DUPLICATE
-                | STANDARD_RIGHTS_READ;
-  HANDLE hTokenProc = nullptr;
-  if(!OpenProcessToken(GetCurrentProcess(), daMask, &hTokenProc)) {
-    Om_free(pSd);
-    #ifdef DEBUG
-    std::wcout << "DEBUG => Om_checkAccess :: OpenProcessToken failed\n";
-    #endif
-    return false;
-  }
-  // the current process token is a "primary" one (don't know what that mean)
-  // so we need to duplicate it to transform it into a standard "user" token by
-  // impersonate it...
-  HANDLE hTokenUser = nullptr;
-  if(!DuplicateToken(hTokenProc, SecurityImpersonation, &hTokenUser)) {
-    CloseHandle(hTokenProc); Om_free(pSd);
-    #ifdef DEBUG
-    std::wcout << "DEBUG => Om_checkAccess :: DuplicateToken failed\n";
-    #endif
-    return false;
-  }
-
-  // STEP 3 - Finally check if "security token" have the requested
-  // "mask" access to the "security descriptor" of the specified file
-  // or folder
-
-  // the GENERIC_MAPPING seem to be never used in most common scenarios,
-  // we set it here because the parameter is mandatory.
-  GENERIC_MAPPING gm = {GENERIC_READ,GENERIC_WRITE,GENERIC_EXECUTE,GENERIC_ALL};
-  PRIVILEGE_SET ps = {};
-  DWORD psSize = sizeof(PRIVILEGE_SET);
-  DWORD allowed = 0;      //< mask of allowed access
-  BOOL  status = false;   //< access status according supplied GENERIC_MAPPING
-  if(!AccessCheck(pSd, hTokenUser, mask, &gm, &ps, &psSize, &allowed, &status)) {
-    CloseHandle(hTokenProc); CloseHandle(hTokenUser); Om_free(pSd);
-    #ifdef DEBUG
-    std::wcout << L"DEBUG => Om_checkAccess :: AccessCheck failed: " << GetLastError() << L"\n";
-    #endif
-  }
-
-  if(!status) {
-    #ifdef DEBUG
-    std::wcout << "DEBUG => Om_checkAccess(";
-    if(mask & FILE_LIST_DIRECTORY) std::wcout << "FILE_LIST_DIRECTORY | ";
-    if(mask & FILE_TRAVERSE) std::wcout << "FILE_TRAVERSE | ";
-    if(mask & FILE_ADD_FILE) std::wcout << "FILE_ADD_FILE | ";
-    if(mask & FILE_ADD_SUBDIRECTORY) std::wcout << "FILE_ADD_SUBDIRECTORY | ";
-    if(mask & FILE_READ_DATA) std::wcout << "FILE_READ_DATA | ";
-    if(mask & FILE_WRITE_DATA) std::wcout << "FILE_WRITE_DATA | ";
-    if(mask & FILE_APPEND_DATA) std::wcout << "FILE_APPEND_DATA | ";
-    if(mask & FILE_EXECUTE) std::wcout << "FILE_EXECUTE";
-    if(mask & FILE_READ_ATTRIBUTES) std::wcout << "FILE_READ_ATTRIBUTES";
-    if(mask & FILE_WRITE_ATTRIBUTES) std::wcout << "FILE_WRITE_ATTRIBUTES";
-    std::wcout << ") : denied, allowed access: \n";
-    AccessCheck(pSd, hTokenUser, FILE_READ_DATA, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  FILE_READ_DATA + LIST_DIRECTORY\n";
-    AccessCheck(pSd, hTokenUser, FILE_WRITE_DATA, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  FILE_WRITE_DATA + ADD_FILE\n";
-    AccessCheck(pSd, hTokenUser, FILE_APPEND_DATA, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  FILE_APPEND_DATA + ADD_SUBDIRECTORY\n";
-    AccessCheck(pSd, hTokenUser, FILE_READ_EA, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  FILE_READ_EA\n";
-    AccessCheck(pSd, hTokenUser, FILE_WRITE_EA, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  FILE_WRITE_EA\n";
-    AccessCheck(pSd, hTokenUser, FILE_EXECUTE, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  FILE_EXECUTE + TRAVERSE\n";
-    AccessCheck(pSd, hTokenUser, FILE_DELETE_CHILD, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  FILE_DELETE_CHILD\n";
-    AccessCheck(pSd, hTokenUser, FILE_READ_ATTRIBUTES, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  FILE_READ_ATTRIBUTES\n";
-    AccessCheck(pSd, hTokenUser, FILE_WRITE_ATTRIBUTES, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  FILE_WRITE_ATTRIBUTES\n";
-    AccessCheck(pSd, hTokenUser, DELETE, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  DELETE\n";
-    AccessCheck(pSd, hTokenUser, READ_CONTROL, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  READ_CONTROL\n";
-    AccessCheck(pSd, hTokenUser, WRITE_DAC, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  WRITE_DAC\n";
-    AccessCheck(pSd, hTokenUser, WRITE_OWNER, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  WRITE_OWNER\n";
-    AccessCheck(pSd, hTokenUser, SYNCHRONIZE, &gm, &ps, &psSize, &allowed, &status);
-    std::wcout << ((status) ? "[x]" : "[ ]") << "  SYNCHRONIZE\n";
-    #endif
-    status = 0;
-  }
-
-  CloseHandle(hTokenProc);
-  CloseHandle(hTokenUser);
-  Om_free(pSd);
-
-  return status;
-}
-
+bool Om_checkAccess(const OmWString& path, unsigned mask)
+{
+  unsigned mode = 0;
+
+  if(mask & (OM_ACCESS_DIR_READ|OM_ACCESS_FILE_READ))
+    mode |= OM_PLT_ACCESS_READ;
+
+  if(mask & (OM_ACCESS_DIR_WRITE|OM_ACCESS_FILE_WRITE))
+    mode |= OM_PLT_ACCESS_WRITE;
+
+  // directory read includes traverse
+  if(mask & (OM_ACCESS_DIR_READ|OM_ACCESS_FILE_EXEC))
+    mode |= OM_PLT_ACCESS_EXEC;
+
+  bool status = Om_pltItemAccess(path, mode);
+
+  #ifdef DEBUG
+  if(!status)
+    std::wcout << L"DEBUG => Om_checkAccess(" << path << L", " << mask << L") : denied\n";
+  #endif
+
+  return status;
+}
+
 /// \brief Load plain text.
 ///
 /// Loads content of the specified file as plain-text into the given
@@ -799,42 +791,36 @@ bool Om_checkAccess(const OmWString& path, unsigned mask)
 ///
 /// \return Count of bytes read.
 ///
-inline static size_t __load_plaintxt(OmCString* pstr, const wchar_t* path)
-{
-  HANDLE hFile = CreateFileW( path, GENERIC_READ, FILE_SHARE_READ,
-                              nullptr, OPEN_EXISTING,
-                              FILE_ATTRIBUTE_NORMAL, nullptr);
-
-  if(hFile == INVALID_HANDLE_VALUE)
-    return 0;
-
-  DWORD rb;
+inline static size_t __load_plaintxt(OmCString* pstr, const OmWString& path)
+{
+  void* hfile = Om_pltFileOpen(path, OM_PLT_FILE_READ);
+  if(!hfile)
+    return 0;
+
+  int64_t rb;
   size_t rt = 0;
 
   uint8_t read_buf[READ_BUF_SIZE];
-
-  while(ReadFile(hFile, read_buf, READ_BUF_SIZE, &rb, nullptr)) {
-
-    if(rb == 0)
-      break;
-
-    rt += rb;
-
-    pstr->append(reinterpret_cast<char*>(read_buf), rb);
-  }
-
-  CloseHandle(hFile);
-
-  return rt;
-}
-
+
+  while((rb = Om_pltFileRead(hfile, read_buf, READ_BUF_SIZE)) > 0) {
+
+    rt += rb;
+
+    pstr->append(reinterpret_cast<char*>(read_buf), rb);
+  }
+
+  Om_pltFileClose(hfile);
+
+  return rt;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 OmCString Om_loadPlainText(const OmWString& path)
 {
   OmCString result;
-  __load_plaintxt(&result, path.c_str());
+  __load_plaintxt(&result, path);
   return result;
 }
 
@@ -843,60 +829,57 @@ OmCString Om_loadPlainText(const OmWString& path)
 ///
 size_t Om_loadPlainText(OmCString* text, const OmWString& path)
 {
-  return __load_plaintxt(text, path.c_str());
+  return __load_plaintxt(text, path);
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-uint8_t* Om_loadBinary(uint64_t* size, const OmWString& path)
-{
-  // initialize size
-  (*size) = 0;
-
-  // open file for reading
-  HANDLE hFile = CreateFileW( path.c_str(), GENERIC_READ, FILE_SHARE_READ,
-                              nullptr, OPEN_EXISTING,
-                              FILE_ATTRIBUTE_NORMAL, nullptr);
-
-  if(hFile == INVALID_HANDLE_VALUE)
-    return nullptr;
-
-  LARGE_INTEGER FileSize;
-  GetFileSizeEx(hFile, &FileSize);
-  uint64_t data_size = FileSize.QuadPart;
-
-  // allocate buffer and read
-  uint8_t* data = reinterpret_cast<uint8_t*>(Om_alloc(data_size));
-  if(!data) return nullptr;
-
-  // read full data at once
-  DWORD rb;
-  bool result = ReadFile(hFile, data, data_size, &rb, nullptr);
-
-  // close file
-  CloseHandle(hFile);
-
-  if(!result) {
-    Om_free(data);
-    return nullptr;
-  }
-
-  (*size) = data_size;
-
-  return data;
-}
+uint8_t* Om_loadBinary(uint64_t* size, const OmWString& path)
+{
+  // initialize size
+  (*size) = 0;
+
+  // open file for reading
+  void* hfile = Om_pltFileOpen(path, OM_PLT_FILE_READ);
+  if(!hfile)
+    return nullptr;
+
+  uint64_t data_size = Om_pltFileSize(hfile);
+
+  // allocate buffer and read
+  uint8_t* data = reinterpret_cast<uint8_t*>(Om_alloc(data_size));
+  if(!data) {
+    Om_pltFileClose(hfile);
+    return nullptr;
+  }
+
+  // read full data at once
+  bool result = (Om_pltFileRead(hfile, data, data_size) == static_cast<int64_t>(data_size));
+
+  // close file
+  Om_pltFileClose(hfile);
+
+  if(!result) {
+    Om_free(data);
+    return nullptr;
+  }
+
+  (*size) = data_size;
+
+  return data;
+}
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 uint64_t Om_fileSize(void* hFile)
 {
-  LARGE_INTEGER LargeInt;
-  GetFileSizeEx(static_cast<HANDLE>(hFile), &LargeInt);
-  return LargeInt.QuadPart;
+  return Om_pltFileSize(hFile);
 }
 
+#ifdef _WIN32
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -938,6 +921,8 @@ int32_t Om_fileDelete(void* hFile)
   return 0;
 }
 
+#endif // _WIN32
+
 /// \brief List files recursively
 ///
 /// This is the static function used to list files recursively.
@@ -948,38 +933,34 @@ int32_t Om_fileDelete(void* hFile)
 ///
 static void __findFiles_Recurse(OmWStringArray* result, const OmWStringArray& search, const OmWString& start, bool hidden)
 {
+  void* hdir = Om_pltDirOpen(start);
+  if(!hdir)
+    return;
+
+  OmPltDirEnt_t ent;
   OmWString item;
-  OmWString path(start);
-  path += L"\\*";
-
-  WIN32_FIND_DATAW fd;
-  HANDLE hnd = FindFirstFileW(path.c_str(), &fd);
-  if(hnd != INVALID_HANDLE_VALUE) {
-    do {
-      // skip this and parent folder
-      if(!wcscmp(fd.cFileName, L".")) continue;
-      if(!wcscmp(fd.cFileName, L"..")) continue;
-
-      // skip in case we do not include hidden items
-      if(!hidden && (fd.dwFileAttributes&FILE_ATTRIBUTE_HIDDEN))
-        continue;
-
-      // update path
-      item = start; item += L"\\"; item += fd.cFileName;
-
-      if(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-        // go deep in tree
-        __findFiles_Recurse(result, search, item, hidden);
-      } else {
-        // search for occurrences
-        for(size_t i = 0; i < search.size(); ++i)
-          if(item.find(search[i], item.size() - search[i].size()) != -1)
-            result->push_back(item);
-      }
-    } while(FindNextFileW(hnd, &fd));
+
+  while(Om_pltDirNext(hdir, &ent)) {
+
+    // skip in case we do not include hidden items
+    if(!hidden && ent.hidden)
+      continue;
+
+    // update path
+    item = start; item += L"\\"; item += ent.name;
+
+    if(ent.isdir) {
+      // go deep in tree
+      __findFiles_Recurse(result, search, item, hidden);
+    } else {
+      // search for occurrences
+      for(size_t i = 0; i < search.size(); ++i)
+        if(item.size() >= search[i].size() && item.find(search[i], item.size() - search[i].size()) != OmWString::npos)
+          result->push_back(item);
+    }
   }
 
-  FindClose(hnd);
+  Om_pltDirClose(hdir);
 }
 
 ///
@@ -20,14 +20,239 @@
 
 #include "OmBaseWin.h"        //< WinAPI
 
+#include "OmUtilThd.h"        //< Om_parallelFor
+#include "OmUtilPrf.h"        //< OmPerfScope
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>        //< SSE2/AVX2 intrinsics
+#define OM_HSH_SIMD
+#endif
+
 #include "xxhash/xxh3.h"
 #include "md5/md5.h"
 
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmUtilHsh.h"
+
 static std::mt19937                             __rnd_generator(time(0));
 static std::uniform_int_distribution<uint8_t>   __rnd_uint8dist(0, 255);
 
 #define READ_BUF_SIZE 524288
 
+#define HASH_IO_LIMIT 4
+
+/// \brief Digest update callback
+///
+/// Callback function to update digest state with a chunk of file data.
+///
+/// \param[in]  state : Pointer to digest state.
+/// \param[in]  data  : Chunk of data.
+/// \param[in]  size  : Size of data chunk.
+///
+typedef void (*__digest_update_fn)(void* state, const uint8_t* data, size_t size);
+
+
+#ifdef OM_HSH_SIMD
+#ifdef __AVX2__
+#define MD5_MB_LANES        8
+typedef __m256i             __md5_vec_t;
+#define MD5V_ADD(a,b)       _mm256_add_epi32(a,b)
+#define MD5V_AND(a,b)       _mm256_and_si256(a,b)
+#define MD5V_ANDNOT(a,b)    _mm256_andnot_si256(a,b)
+#define MD5V_OR(a,b)        _mm256_or_si256(a,b)
+#define MD5V_XOR(a,b)       _mm256_xor_si256(a,b)
+#define MD5V_SET1(v)        _mm256_set1_epi32(v)
+#define MD5V_ROTL(a,n)      _mm256_or_si256(_mm256_sll_epi32(a,_mm_cvtsi32_si128(n)),_mm256_srl_epi32(a,_mm_cvtsi32_si128(32-(n))))
+#define MD5V_STORE(p,a)     _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),a)
+#define MD5V_LOAD(p)        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))
+#else
+#define MD5_MB_LANES        4
+typedef __m128i             __md5_vec_t;
+#define MD5V_ADD(a,b)       _mm_add_epi32(a,b)
+#define MD5V_AND(a,b)       _mm_and_si128(a,b)
+#define MD5V_ANDNOT(a,b)    _mm_andnot_si128(a,b)
+#define MD5V_OR(a,b)        _mm_or_si128(a,b)
+#define MD5V_XOR(a,b)       _mm_xor_si128(a,b)
+#define MD5V_SET1(v)        _mm_set1_epi32(v)
+#define MD5V_ROTL(a,n)      _mm_or_si128(_mm_sll_epi32(a,_mm_cvtsi32_si128(n)),_mm_srl_epi32(a,_mm_cvtsi32_si128(32-(n))))
+#define MD5V_STORE(p,a)     _mm_storeu_si128(reinterpret_cast<__m128i*>(p),a)
+#define MD5V_LOAD(p)        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))
+#endif // __AVX2__
+
+/// \brief MD5 round constants
+///
+/// Sine derived additive constants of MD5 64 steps
+///
+static const uint32_t __md5_K[64] = {
+  0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+  0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+  0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+  0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+  0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+  0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+  0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+  0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+/// \brief MD5 rotations
+///
+/// Left rotation amounts of MD5 64 steps
+///
+static const int __md5_R[64] = {
+  7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+  5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+  4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+  6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+/// \brief Multi-buffer MD5 state
+///
+/// MD5 state of several independent streams, one per SIMD lane
+///
+typedef struct {
+
+  __md5_vec_t       a;
+
+  __md5_vec_t       b;
+
+  __md5_vec_t       c;
+
+  __md5_vec_t       d;
+
+} __md5_mb_t;
+
+/// \brief Multi-buffer MD5 initialization
+///
+/// Initializes all lanes of multi-buffer MD5 state.
+///
+/// \param[in]  st    : Multi-buffer MD5 state.
+///
+static inline void __md5_mb_init(__md5_mb_t* st)
+{
+  st->a = MD5V_SET1(0x67452301);
+  st->b = MD5V_SET1(static_cast<int>(0xefcdab89));
+  st->c = MD5V_SET1(static_cast<int>(0x98badcfe));
+  st->d = MD5V_SET1(0x10325476);
+}
+
+/// \brief Multi-buffer MD5 block
+///
+/// Processes one 64 bytes block of each stream, lanes not selected by
+/// mask are left unchanged.
+///
+/// \param[in]  st      : Multi-buffer MD5 state.
+/// \param[in]  blocks  : Pointers to block of each lane.
+/// \param[in]  mask    : Active lanes mask, all bits set for active lanes.
+///
+static void __md5_mb_block(__md5_mb_t* st, const uint8_t* const* blocks, __md5_vec_t mask)
+{
+  // transpose message words so each vector holds the same word of all lanes
+  __md5_vec_t x[16];
+  uint32_t w[MD5_MB_LANES];
+
+  for(unsigned j = 0; j < 16; ++j) {
+    for(unsigned l = 0; l < MD5_MB_LANES; ++l) {
+      const uint8_t* p = blocks[l] + j * 4;
+      w[l] = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+             (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+    x[j] = MD5V_LOAD(w);
+  }
+
+  const __md5_vec_t ones = MD5V_SET1(-1);
+
+  __md5_vec_t a = st->a, b = st->b, c = st->c, d = st->d;
+
+  for(unsigned i = 0; i < 64; ++i) {
+
+    __md5_vec_t f;
+    unsigned g;
+
+    if(i < 16) {
+      f = MD5V_OR(MD5V_AND(b, c), MD5V_ANDNOT(b, d));
+      g = i;
+    } else if(i < 32) {
+      f = MD5V_OR(MD5V_AND(d, b), MD5V_ANDNOT(d, c));
+      g = (5 * i + 1) & 15;
+    } else if(i < 48) {
+      f = MD5V_XOR(b, MD5V_XOR(c, d));
+      g = (3 * i + 5) & 15;
+    } else {
+      f = MD5V_XOR(c, MD5V_OR(b, MD5V_XOR(d, ones)));
+      g = (7 * i) & 15;
+    }
+
+    f = MD5V_ADD(MD5V_ADD(a, f), MD5V_ADD(MD5V_SET1(static_cast<int>(__md5_K[i])), x[g]));
+
+    a = d; d = c; c = b;
+    b = MD5V_ADD(b, MD5V_ROTL(f, __md5_R[i]));
+  }
+
+  // add to previous state, only for active lanes
+  st->a = MD5V_OR(MD5V_AND(mask, MD5V_ADD(st->a, a)), MD5V_ANDNOT(mask, st->a));
+  st->b = MD5V_OR(MD5V_AND(mask, MD5V_ADD(st->b, b)), MD5V_ANDNOT(mask, st->b));
+  st->c = MD5V_OR(MD5V_AND(mask, MD5V_ADD(st->c, c)), MD5V_ANDNOT(mask, st->c));
+  st->d = MD5V_OR(MD5V_AND(mask, MD5V_ADD(st->d, d)), MD5V_ANDNOT(mask, st->d));
+}
+
+/// \brief Multi-buffer MD5 lane digest
+///
+/// Extracts final digest of the specified lane, then reset lane to
+/// initial state.
+///
+/// \param[in]  st    : Multi-buffer MD5 state.
+/// \param[in]  lane  : Lane index.
+/// \param[out] md5   : 16 bytes buffer that receive digest.
+///
+static void __md5_mb_digest(__md5_mb_t* st, unsigned lane, uint8_t* md5)
+{
+  uint32_t v[4][MD5_MB_LANES];
+
+  MD5V_STORE(v[0], st->a); MD5V_STORE(v[1], st->b);
+  MD5V_STORE(v[2], st->c); MD5V_STORE(v[3], st->d);
+
+  for(unsigned i = 0; i < 4; ++i) {
+    md5[i*4]   = static_cast<uint8_t>(v[i][lane]);
+    md5[i*4+1] = static_cast<uint8_t>(v[i][lane] >> 8);
+    md5[i*4+2] = static_cast<uint8_t>(v[i][lane] >> 16);
+    md5[i*4+3] = static_cast<uint8_t>(v[i][lane] >> 24);
+  }
+
+  // reset lane for next stream
+  v[0][lane] = 0x67452301; v[1][lane] = 0xefcdab89;
+  v[2][lane] = 0x98badcfe; v[3][lane] = 0x10325476;
+
+  st->a = MD5V_LOAD(v[0]); st->b = MD5V_LOAD(v[1]);
+  st->c = MD5V_LOAD(v[2]); st->d = MD5V_LOAD(v[3]);
+}
+
+/// \brief Append MD5 padding
+///
+/// Appends MD5 padding and message length to the given stream tail, so
+/// its size becomes multiple of 64 bytes. Buffer must have at least 72
+/// bytes available after tail.
+///
+/// \param[in]  tail  : Pointer to stream tail.
+/// \param[in]  size  : Size of tail.
+/// \param[in]  total : Total size of stream in bytes.
+///
+/// \return New size of tail, including padding.
+///
+static size_t __md5_pad(uint8_t* tail, size_t size, uint64_t total)
+{
+  tail[size++] = 0x80;
+
+  while((size & 63) != 56)
+    tail[size++] = 0;
+
+  uint64_t bits = total << 3;
+  for(unsigned i = 0; i < 8; ++i)
+    tail[size++] = static_cast<uint8_t>(bits >> (i * 8));
+
+  return size;
+}
+#endif // OM_HSH_SIMD
+
 /// \brief Swap bytes
 ///
 /// Swap bytes order in 32 bits value, to convert endianes.
@@ -367,6 +592,205 @@ uint64_t Om_getCRC64(const OmWString& str)
   return __CRC64(0, (unsigned char*)str.c_str(), str.size()*sizeof(wchar_t));
 }
 
+/// \brief Read file synchronously
+///
+/// Reads file from beginning using the given handle and updates digest
+/// with read data, file is read synchronously.
+///
+/// \param[in]  hFile     : File handle to read.
+/// \param[in]  update_fn : Digest update callback.
+/// \param[in]  state     : Digest state pointer to pass to callback.
+///
+/// \return True if operation succeed, false if read error occurred.
+///
+static bool __file_digest_sync(HANDLE hFile, __digest_update_fn update_fn, void* state)
+{
+  uint8_t* read_buf = static_cast<uint8_t*>(Om_alloc(READ_BUF_SIZE));
+  if(!read_buf)
+    return false;
+
+  SetFilePointer(hFile, 0, 0, FILE_BEGIN);
+
+  bool result = true;
+  DWORD rb;
+
+  while(true) {
+
+    if(!ReadFile(hFile, read_buf, READ_BUF_SIZE, &rb, nullptr)) {
+      result = false;
+      break;
+    }
+
+    if(rb == 0)
+      break;
+
+    update_fn(state, read_buf, rb);
+  }
+
+  Om_free(read_buf);
+
+  return result;
+}
+
+/// \brief Issue asynchronous read
+///
+/// Starts overlapped read of one buffer at specified file offset.
+///
+/// \param[in]  hFile   : File handle opened for overlapped I/O.
+/// \param[in]  buf     : Buffer that receive data.
+/// \param[in]  ov      : Overlapped structure for this buffer.
+/// \param[in]  offset  : File offset to read at.
+///
+/// \return 1 if read started, 0 if end of file reached, -1 if error occurred.
+///
+static inline int __file_read_issue(HANDLE hFile, uint8_t* buf, OVERLAPPED* ov, uint64_t offset)
+{
+  ov->Offset = static_cast<DWORD>(offset);
+  ov->OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+  if(ReadFile(hFile, buf, READ_BUF_SIZE, nullptr, ov))
+    return 1; //< completed synchronously, result is retrieved the same way
+
+  DWORD error = GetLastError();
+
+  if(error == ERROR_IO_PENDING)
+    return 1;
+
+  return (error == ERROR_HANDLE_EOF) ? 0 : -1;
+}
+
+/// \brief Read file asynchronously
+///
+/// Reads file from beginning using the given handle and updates digest
+/// with read data. File is read using two buffers, the next chunk is read
+/// while the previous one is hashed so reading and hashing overlap.
+///
+/// \param[in]  hFile     : File handle opened for overlapped I/O.
+/// \param[in]  update_fn : Digest update callback.
+/// \param[in]  state     : Digest state pointer to pass to callback.
+///
+/// \return True if operation succeed, false if read error occurred.
+///
+static bool __file_digest_async(HANDLE hFile, __digest_update_fn update_fn, void* state)
+{
+  uint8_t* read_buf = static_cast<uint8_t*>(Om_alloc(READ_BUF_SIZE * 2));
+  if(!read_buf)
+    return false;
+
+  OVERLAPPED ov[2] = {};
+  ov[0].hEvent = CreateEventW(nullptr, true, false, nullptr);
+  ov[1].hEvent = CreateEventW(nullptr, true, false, nullptr);
+
+  bool result = (ov[0].hEvent && ov[1].hEvent);
+
+  uint64_t offset = 0;
+  unsigned cur = 0;
+
+  int pending = result ? __file_read_issue(hFile, read_buf, &ov[0], 0) : 0;
+
+  // only one read is pending at a time, the one for next chunk
+  while(pending > 0) {
+
+    DWORD rb;
+
+    if(!GetOverlappedResult(hFile, &ov[cur], &rb, true)) {
+      if(GetLastError() != ERROR_HANDLE_EOF)
+        result = false;
+      break;
+    }
+
+    if(rb == 0)
+      break;
+
+    offset += rb;
+
+    // start reading next chunk into the other buffer, a short
+    // read means we reached end of file
+    unsigned nxt = cur ^ 1;
+
+    pending = (rb == READ_BUF_SIZE) ? __file_read_issue(hFile, read_buf + nxt * READ_BUF_SIZE, &ov[nxt], offset) : 0;
+
+    // hash current chunk while next one is read
+    update_fn(state, read_buf + cur * READ_BUF_SIZE, rb);
+
+    cur = nxt;
+  }
+
+  if(pending < 0)
+    result = false;
+
+  if(ov[0].hEvent) CloseHandle(ov[0].hEvent);
+  if(ov[1].hEvent) CloseHandle(ov[1].hEvent);
+
+  Om_free(read_buf);
+
+  return result;
+}
+
+/// \brief Generate file digest
+///
+/// Reads the whole file opened with the given handle and updates digest
+/// with read data. The handle is reopened for overlapped reading so
+/// reading and hashing overlap, if this is not possible (such as share
+/// mode conflict) the file is read synchronously through the given handle.
+///
+/// \param[in]  hFile     : File handle to read.
+/// \param[in]  update_fn : Digest update callback.
+/// \param[in]  state     : Digest state pointer to pass to callback.
+///
+/// \return True if operation succeed, false if read error occurred.
+///
+static bool __file_digest(HANDLE hFile, __digest_update_fn update_fn, void* state)
+{
+  HANDLE hAsync = ReOpenFile(hFile, GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,
+                             FILE_FLAG_OVERLAPPED|FILE_FLAG_SEQUENTIAL_SCAN);
+
+  if(hAsync == INVALID_HANDLE_VALUE)
+    return __file_digest_sync(hFile, update_fn, state);
+
+  bool result = __file_digest_async(hAsync, update_fn, state);
+
+  CloseHandle(hAsync);
+
+  return result;
+}
+
+/// \brief Generate file digest
+///
+/// Opens the specified file for overlapped reading and updates digest
+/// with its whole content, reading and hashing overlap.
+///
+/// \param[in]  path      : Path to file to read.
+/// \param[in]  share     : File share mode to open file with.
+/// \param[in]  update_fn : Digest update callback.
+/// \param[in]  state     : Digest state pointer to pass to callback.
+///
+/// \return True if operation succeed, false if file open or read error.
+///
+static bool __file_digest(const OmWString& path, DWORD share, __digest_update_fn update_fn, void* state)
+{
+  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, share, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL|FILE_FLAG_OVERLAPPED|FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+  if(hFile == INVALID_HANDLE_VALUE)
+    return false;
+
+  bool result = __file_digest_async(hFile, update_fn, state);
+
+  CloseHandle(hFile);
+
+  return result;
+}
+
+/// \brief XXHash3 digest update
+///
+/// Digest update callback for XXHash3 algorithm.
+///
+static void __XXHash3_update_fn(void* state, const uint8_t* data, size_t size)
+{
+  XXH3_64bits_update(static_cast<XXH3_state_t*>(state), data, size);
+}
+
 /// \brief Generate file XXHash3 digest (checksum)
 ///
 /// Generate file digest (checksum) string using XXHash3 64 bits digest
@@ -375,26 +799,15 @@ uint64_t Om_getCRC64(const OmWString& str)
 /// \param[out] xxh   : Pointer to uint64_t that receive hash value.
 /// \param[in]  hFile : File handle to generate digest from.
 ///
-/// \return True if operation succeed, false if file open error.
+/// \return True if operation succeed, false if file read error.
 ///
 static inline bool __XXHash3_file_digest(uint64_t* xxh, const HANDLE hFile)
 {
-  DWORD rb;
-
   XXH3_state_t xxhst;
   XXH3_64bits_reset(&xxhst);
 
-  uint8_t read_buf[READ_BUF_SIZE];
-
-  SetFilePointer(hFile, 0, 0, FILE_BEGIN);
-
-  while(ReadFile(hFile, read_buf, READ_BUF_SIZE, &rb, nullptr)) {
-
-    if(rb == 0)
-      break;
-
-    XXH3_64bits_update(&xxhst, read_buf, rb);
-  }
+  if(!__file_digest(hFile, __XXHash3_update_fn, &xxhst))
+    return false;
 
   *xxh = XXH3_64bits_digest(&xxhst);
 
@@ -413,28 +826,11 @@ static inline bool __XXHash3_file_digest(uint64_t* xxh, const HANDLE hFile)
 ///
 static inline bool __XXHash3_file_digest(uint64_t* xxh, const OmWString& path)
 {
-  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
-                              FILE_ATTRIBUTE_NORMAL, nullptr);
-
-  if(hFile == INVALID_HANDLE_VALUE)
-    return false;
-
-  DWORD rb;
-
   XXH3_state_t xxhst;
   XXH3_64bits_reset(&xxhst);
 
-  uint8_t read_buf[READ_BUF_SIZE];
-
-  while(ReadFile(hFile, read_buf, READ_BUF_SIZE, &rb, nullptr)) {
-
-    if(rb == 0)
-      break;
-
-    XXH3_64bits_update(&xxhst, read_buf, rb);
-  }
-
-  CloseHandle(hFile);
+  if(!__file_digest(path, FILE_SHARE_READ, __XXHash3_update_fn, &xxhst))
+    return false;
 
   *xxh = XXH3_64bits_digest(&xxhst);
 
@@ -533,6 +929,15 @@ bool Om_cmpXXHsum(void* hFile, const OmWString& str)
   return (xxh_l == xxh_r);
 }
 
+/// \brief MD5 digest update
+///
+/// Digest update callback for MD5 algorithm.
+///
+static void __MD5_update_fn(void* state, const uint8_t* data, size_t size)
+{
+  MD5_Update(static_cast<MD5_CTX*>(state), const_cast<uint8_t*>(data), size);
+}
+
 /// \brief Generate file MD5 digest (checksum)
 ///
 /// Generate file digest (checksum) using MD5 digest algorithm
@@ -540,26 +945,15 @@ bool Om_cmpXXHsum(void* hFile, const OmWString& str)
 /// \param[out] md5   : 16 bytes buffer that receive digest result.
 /// \param[in]  hFile : File handle to generate digest from.
 ///
-/// \return True if operation succeed, false if file open error.
+/// \return True if operation succeed, false if file read error.
 ///
 static inline bool __MD5_file_digest(uint8_t* md5, const HANDLE hFile)
 {
-  DWORD rb;
-
   MD5_CTX md5ct;
   MD5_Init(&md5ct);
 
-  uint8_t read_buf[READ_BUF_SIZE];
-
-  SetFilePointer(hFile, 0, 0, FILE_BEGIN);
-
-  while(ReadFile(hFile, read_buf, READ_BUF_SIZE, &rb, nullptr)) {
-
-    if(rb == 0)
-      break;
-
-    MD5_Update(&md5ct, read_buf, rb);
-  }
+  if(!__file_digest(hFile, __MD5_update_fn, &md5ct))
+    return false;
 
   MD5_Final(md5, &md5ct);
 
@@ -578,30 +972,13 @@ static inline bool __MD5_file_digest(uint8_t* md5, const HANDLE hFile)
 ///
 static inline bool __MD5_file_digest(uint8_t* md5, const OmWString& path)
 {
-  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, 0, nullptr, OPEN_EXISTING,
-                              FILE_ATTRIBUTE_NORMAL, nullptr);
-
-  if(hFile == INVALID_HANDLE_VALUE)
-    return false;
-
-  DWORD rb;
-
   MD5_CTX md5ct;
   MD5_Init(&md5ct);
 
-  uint8_t read_buf[READ_BUF_SIZE];
-
-  while(ReadFile(hFile, read_buf, READ_BUF_SIZE, &rb, nullptr)) {
-
-    if(rb == 0)
-      break;
-
-    MD5_Update(&md5ct, read_buf, rb);
-  }
+  if(!__file_digest(path, 0, __MD5_update_fn, &md5ct))
+    return false;
 
   MD5_Final(md5, &md5ct);
-
-  CloseHandle(hFile);
 
   return true;
 }
@@ -685,6 +1062,369 @@ bool Om_cmpMD5sum(void* hFile, const OmWString& str)
 }
 
 
+/// \brief Batch hashing context
+///
+/// Structure holding batch hashing state shared between workers
+///
+typedef struct {
+
+  const OmWStringArray* paths;
+
+  OmWStringArray*       sums;
+
+  unsigned              algo;
+
+  size_t                groups;   ///< Count of files groups for multi-buffer
+
+  Om_progressCb         progress_cb;
+
+  void*                 user_ptr;
+
+  size_t                progress_cur;
+
+  size_t                done;
+
+  uint64_t              bytes;
+
+  bool                  has_abort;
+
+  CRITICAL_SECTION      lock;
+
+} __hash_batch_ctx_t;
+
+/// \brief Batch hashing file done
+///
+/// Updates batch hashing counters and calls progression callback once
+/// a file was processed.
+///
+/// \param[in]  ctx     : Batch hashing context.
+/// \param[in]  index   : Index of processed file.
+/// \param[in]  result  : Whether file was successfully hashed.
+/// \param[in]  bytes   : Count of hashed bytes.
+///
+/// \return False if process must be aborted, true otherwise.
+///
+static bool __hash_batch_done(__hash_batch_ctx_t* ctx, size_t index, bool result, uint64_t bytes)
+{
+  EnterCriticalSection(&ctx->lock);
+
+  if(result) {
+    ctx->done++;
+    ctx->bytes += bytes;
+  }
+
+  ctx->progress_cur++;
+  if(ctx->progress_cb) {
+    if(!ctx->progress_cb(ctx->user_ptr, ctx->paths->size(), ctx->progress_cur, index))
+      ctx->has_abort = true;
+  }
+
+  bool has_abort = ctx->has_abort;
+
+  LeaveCriticalSection(&ctx->lock);
+
+  return !has_abort;
+}
+
+/// \brief Batch hashing job
+///
+/// Parallel job callback to compute checksum of one file.
+///
+static bool __hash_batch_job_fn(void* ptr, size_t index, unsigned worker)
+{
+  OM_UNUSED(worker);
+
+  __hash_batch_ctx_t* ctx = static_cast<__hash_batch_ctx_t*>(ptr);
+
+  const OmWString& path = (*ctx->paths)[index];
+  OmWString& sum = (*ctx->sums)[index];
+
+  bool result;
+
+  if(ctx->algo == OM_HASH_MD5) {
+    uint8_t md5[16] = {};
+    result = __MD5_file_digest(md5, path);
+    if(result) __bytes_to_hex_le(&sum, md5, 16);
+  } else {
+    uint64_t xxh;
+    result = __XXHash3_file_digest(&xxh, path);
+    if(result) __bytes_to_hex_be(&sum, reinterpret_cast<const uint8_t*>(&xxh), 8);
+  }
+
+  WIN32_FILE_ATTRIBUTE_DATA attr = {};
+  if(result)
+    GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &attr);
+
+  return __hash_batch_done(ctx, index, result, (static_cast<uint64_t>(attr.nFileSizeHigh) << 32) | attr.nFileSizeLow);
+}
+
+#ifdef OM_HSH_SIMD
+/// \brief Multi-buffer MD5 lane
+///
+/// Stream state of one multi-buffer MD5 lane
+///
+typedef struct {
+
+  HANDLE            hFile;
+
+  size_t            index;    ///< Index of file being hashed
+
+  uint8_t*          buf;
+
+  size_t            len;
+
+  size_t            pos;
+
+  uint64_t          total;
+
+  bool              eof;
+
+} __md5_lane_t;
+
+/// \brief Multi-buffer MD5 batch job
+///
+/// Parallel job callback to compute MD5 checksums of one group of files,
+/// files of the group are hashed concurrently, one per SIMD lane. Each
+/// time a lane finishes its file, it takes the next one of the group.
+///
+static bool __hash_batch_md5_fn(void* ptr, size_t index, unsigned worker)
+{
+  __hash_batch_ctx_t* ctx = static_cast<__hash_batch_ctx_t*>(ptr);
+
+  const OmWStringArray& paths = *ctx->paths;
+
+  // lanes buffers, with room for padding after data
+  uint8_t* bufs = static_cast<uint8_t*>(Om_alloc(MD5_MB_LANES * (READ_BUF_SIZE + 128)));
+
+  if(!bufs) {
+    // fall back to one file at a time
+    for(size_t i = index; i < paths.size(); i += ctx->groups)
+      if(!__hash_batch_job_fn(ptr, i, worker))
+        return false;
+    return true;
+  }
+
+  __md5_lane_t lane[MD5_MB_LANES];
+
+  for(unsigned l = 0; l < MD5_MB_LANES; ++l) {
+    lane[l].hFile = INVALID_HANDLE_VALUE;
+    lane[l].buf = bufs + l * (READ_BUF_SIZE + 128);
+    lane[l].len = lane[l].pos = 0;
+  }
+
+  __md5_mb_t st;
+  __md5_mb_init(&st);
+
+  static const uint8_t idle_block[64] = {};
+
+  size_t next = index; //< next file of group
+  bool has_abort = false;
+  uint8_t md5[16];
+
+  while(!has_abort) {
+
+    unsigned active = 0;
+
+    // feed lanes that consumed their data
+    for(unsigned l = 0; l < MD5_MB_LANES; ++l) {
+
+      __md5_lane_t& ln = lane[l];
+
+      while(ln.pos == ln.len && !has_abort) {
+
+        if(ln.hFile == INVALID_HANDLE_VALUE) {
+
+          // lane is idle, take next file of group
+          if(next >= paths.size())
+            break;
+
+          ln.index = next;
+          next += ctx->groups;
+
+          ln.hFile = CreateFileW(paths[ln.index].c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+          ln.len = ln.pos = 0;
+          ln.total = 0;
+          ln.eof = false;
+
+          if(ln.hFile == INVALID_HANDLE_VALUE)
+            has_abort = !__hash_batch_done(ctx, ln.index, false, 0);
+
+          continue;
+        }
+
+        if(ln.eof) {
+
+          // stream complete, get digest and reset lane
+          __md5_mb_digest(&st, l, md5);
+          __bytes_to_hex_le(&(*ctx->sums)[ln.index], md5, 16);
+
+          CloseHandle(ln.hFile);
+          ln.hFile = INVALID_HANDLE_VALUE;
+
+          has_abort = !__hash_batch_done(ctx, ln.index, true, ln.total);
+
+          continue;
+        }
+
+        DWORD rb;
+
+        if(!ReadFile(ln.hFile, ln.buf, READ_BUF_SIZE, &rb, nullptr)) {
+
+          // read error, discard stream and reset lane
+          __md5_mb_digest(&st, l, md5);
+
+          CloseHandle(ln.hFile);
+          ln.hFile = INVALID_HANDLE_VALUE;
+
+          has_abort = !__hash_batch_done(ctx, ln.index, false, 0);
+
+          continue;
+        }
+
+        ln.pos = 0;
+        ln.len = rb;
+        ln.total += rb;
+
+        // short read means end of file, we append padding
+        if(rb < READ_BUF_SIZE) {
+          ln.len = __md5_pad(ln.buf, rb, ln.total);
+          ln.eof = true;
+        }
+      }
+
+      if(ln.pos < ln.len)
+        active++;
+    }
+
+    if(!active || has_abort)
+      break;
+
+    // process blocks available in all active lanes, data and padding
+    // sizes are multiples of block size
+    size_t blocks = READ_BUF_SIZE;
+    int32_t mask[MD5_MB_LANES];
+
+    for(unsigned l = 0; l < MD5_MB_LANES; ++l) {
+      if(lane[l].pos < lane[l].len) {
+        mask[l] = -1;
+        if(((lane[l].len - lane[l].pos) >> 6) < blocks)
+          blocks = (lane[l].len - lane[l].pos) >> 6;
+      } else {
+        mask[l] = 0;
+      }
+    }
+
+    __md5_vec_t vmask = MD5V_LOAD(mask);
+    const uint8_t* ptrs[MD5_MB_LANES];
+
+    for(size_t b = 0; b < blocks; ++b) {
+      for(unsigned l = 0; l < MD5_MB_LANES; ++l)
+        ptrs[l] = mask[l] ? lane[l].buf + lane[l].pos + (b << 6) : idle_block;
+      __md5_mb_block(&st, ptrs, vmask);
+    }
+
+    for(unsigned l = 0; l < MD5_MB_LANES; ++l)
+      if(mask[l]) lane[l].pos += blocks << 6;
+  }
+
+  for(unsigned l = 0; l < MD5_MB_LANES; ++l)
+    if(lane[l].hFile != INVALID_HANDLE_VALUE)
+      CloseHandle(lane[l].hFile);
+
+  Om_free(bufs);
+
+  return !has_abort;
+}
+#endif // OM_HSH_SIMD
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+size_t Om_getFileSums(OmWStringArray* sums, const OmWStringArray& paths, unsigned algo, unsigned io_limit, Om_progressCb progress_cb, void* user_ptr)
+{
+  sums->assign(paths.size(), OmWString());
+
+  __hash_batch_ctx_t ctx;
+  ctx.paths = &paths;
+  ctx.sums = sums;
+  ctx.algo = algo;
+  ctx.groups = 0;
+  ctx.progress_cb = progress_cb;
+  ctx.user_ptr = user_ptr;
+  ctx.progress_cur = 0;
+  ctx.done = 0;
+  ctx.bytes = 0;
+  ctx.has_abort = false;
+
+  // processed files and bytes are recorded so throughput can be compared
+  // to raw read bandwidth
+  OmPerfScope perf(L"file sums", (algo == OM_HASH_MD5) ? L"md5" : L"xxh3");
+
+  // each worker has one read pending while hashing, so count of workers
+  // bounds count of concurrent I/O
+  InitializeCriticalSection(&ctx.lock);
+
+  #ifdef OM_HSH_SIMD
+  if(algo == OM_HASH_MD5 && paths.size() >= MD5_MB_LANES) {
+
+    // MD5 cannot be parallelized within one stream, files are distributed
+    // in groups each hashed by one worker with several streams in SIMD lanes
+    ctx.groups = Om_workerCount((paths.size() + MD5_MB_LANES - 1) / MD5_MB_LANES, io_limit ? io_limit : HASH_IO_LIMIT);
+
+    Om_parallelFor(ctx.groups, __hash_batch_md5_fn, &ctx, ctx.groups);
+
+  } else {
+    Om_parallelFor(paths.size(), __hash_batch_job_fn, &ctx, io_limit ? io_limit : HASH_IO_LIMIT);
+  }
+  #else
+  Om_parallelFor(paths.size(), __hash_batch_job_fn, &ctx, io_limit ? io_limit : HASH_IO_LIMIT);
+  #endif // OM_HSH_SIMD
+
+  DeleteCriticalSection(&ctx.lock);
+
+  perf.addFiles(ctx.done);
+  perf.addBytes(ctx.bytes);
+
+  return ctx.done;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+size_t Om_cmpFileSums(OmIndexArray* mismatch, const OmWStringArray& paths, const OmWStringArray& sums, unsigned algo, unsigned io_limit)
+{
+  mismatch->clear();
+
+  OmWStringArray ctrls;
+  Om_getFileSums(&ctrls, paths, algo, io_limit);
+
+  size_t matches = 0;
+
+  for(size_t i = 0; i < paths.size(); ++i) {
+
+    bool match = false;
+
+    if(!ctrls[i].empty() && i < sums.size()) {
+      if(algo == OM_HASH_MD5) {
+        match = (ctrls[i] == sums[i]);
+      } else {
+        match = (__hex_to_uint64(ctrls[i].c_str()) == __hex_to_uint64(sums[i].c_str()));
+      }
+    }
+
+    if(match) {
+      matches++;
+    } else {
+      mismatch->push_back(i);
+    }
+  }
+
+  return matches;
+}
+
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -15,9 +15,13 @@
   along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
 */
 #include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
-#include <algorithm>          //< std::sort
 #include <cmath>              //< modf, floor, etc.
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>        //< SSE2 intrinsics
+#define OM_IMG_SSE2
+#endif
+
 #ifdef DEBUG
 #include <ctime>
 #endif // DEBUG
@@ -25,6 +29,7 @@
 #include "OmBaseWin.h"        //< WinAPI
 
 #include "OmUtilImg.h"        //< OM_IMAGE_TYPE_*
+#include "OmUtilThd.h"        //< Om_parallelFor
 
 #include "jpeg/jpeglib.h"
 #include "png/png.h"
@@ -123,6 +128,9 @@ inline static void __inplace_rgb_to_rgba(uint8_t* data, uint32_t n, uint8_t a)
     (*reinterpret_cast<uint32_t*>(dp)) = (*reinterpret_cast<uint32_t*>(sp));
     dp[3] = a;
   }
+
+  // first pixel RGB is already in place
+  if(n) data[3] = a;
 }
 
 /// \brief Set pixel color
@@ -182,197 +190,458 @@ inline static void __cpy_pixel_32(uint8_t* dst, const uint8_t* src)
 #define CLAMP(l, n, u) (((n) <= (l)) ? (l) : ((n) >= (u)) ? (u) : (n))
 #define MIN(n, u) (((n) >= (u)) ? (u) : (n))
 
-/// \brief Cubic interpolation Macro.
+/// \brief Resampling filters
 ///
-/// Cubic interpolation equation.
+/// Filter types for separable resampling.
+///
+#define RS_FILTER_BOX   0
+#define RS_FILTER_LIN   1
+#define RS_FILTER_CUB   2
+
+/// \brief Resampling fixed-point
 ///
-/// \param[in]  a : Start handle
-/// \param[in]  b : Start node
-/// \param[in]  c : End node
-/// \param[in]  d : End handle
-/// \param[in]  t : Interpolation phase
+/// Resampling weights are stored as 16 bits signed fixed-point values
+/// with 14 bits of fractional part, allowing cubic negative lobes.
 ///
-#define CUBIC_INTERP(a, b, c, d, t) ((b) + 0.5f * (t) * ((c) - (a) + (t) * (2.0f * (a) - 5.0f * (b) + 4.0f * (c) - (d) + (t) * (3.0f * ((b) - (c)) + (d) - (a)))))
+#define RS_WGT_BITS     14
+#define RS_WGT_ONE      (1 << RS_WGT_BITS)
+#define RS_WGT_RND      (1 << (RS_WGT_BITS - 1))
 
-/// \brief Linear interpolation Macro.
+/// \brief Resampling parallel threshold
 ///
-/// Linear interpolation equation.
+/// Minimum count of processed pixels (source and destination) above which
+/// resampling passes are split across worker threads.
 ///
-/// \param[in]  a : Start
-/// \param[in]  b : End
-/// \param[in]  t : Interpolation phase
+#define RS_PARALLEL_MIN (1 << 18)
+
+/// \brief Resampling rows per job
+///
+/// Count of rows processed by each parallel resampling job.
 ///
-#define LERP(a, b, t) ((a) + (t) * ((b) - (a)))
+#define RS_JOB_ROWS     16
 
-/// \brief Get bicubic interpolated pixel.
+/// \brief Resampling axis filter
 ///
-/// Compute the bicubic interpolated pixel sample at the specified
-/// coordinates of the given source image.
+/// Precomputed filter taps for one axis of separable resampling. For each
+/// destination index, taps are pairs of source index and fixed-point weight
+/// stored contiguously starting at offset given by tap_ofs. Tap count is
+/// always even so taps are processed by pairs.
 ///
-/// \param[in]  sample  : Array to receive interpolated pixel components.
-/// \param[in]  u       : Sample horizontal coordinate in image, from 0.0 to 1.0.
-/// \param[in]  v       : Sample vertical coordinate in image, from 0.0 to 1.0.
-/// \param[in]  src_pix : Input image RGB(A) data.
-/// \param[in]  src_w   : Input image width.
-/// \param[in]  src_h   : Input image height.
+typedef struct {
+
+  std::vector<uint32_t>   tap_ofs;
+
+  std::vector<int32_t>    tap_idx;
+
+  std::vector<int16_t>    tap_wgt;
+
+} __rs_axis_t;
+
+/// \brief Build resampling axis filter
+///
+/// Compute filter taps for one axis, source sample position of each
+/// destination index is given by off + (index * scale), as pixel coordinate
+/// where pixel centers lie at integer positions.
 ///
-inline static void __get_sample_cub_32(uint8_t* sample, float u, float v, const uint8_t* src_pix, unsigned src_w, unsigned src_h, int max_w, int max_h, uint32_t row_bytes)
+/// \param[out] axis    : Axis filter to build.
+/// \param[in]  filter  : Filter type, one of RS_FILTER_* value.
+/// \param[in]  dst_n   : Destination pixels count.
+/// \param[in]  src_n   : Source pixels count.
+/// \param[in]  off     : Sample position of first destination pixel.
+/// \param[in]  scale   : Sample position step between destination pixels.
+/// \param[in]  box_n   : Box width in pixels, for box filter.
+///
+static void __resample_axis(__rs_axis_t* axis, int filter, unsigned dst_n, unsigned src_n, float off, float scale, int box_n)
 {
-  float u_x, v_y;
+  int32_t max_n = static_cast<int32_t>(src_n) - 1;
 
-  float t_x = std::modf((u * src_w) - 0.5f, &u_x);
-  float t_y = std::modf((v * src_h) - 0.5f, &v_y);
+  axis->tap_ofs.resize(dst_n + 1);
+  axis->tap_idx.clear();
+  axis->tap_wgt.clear();
 
-  int32_t b_x = static_cast<int32_t>(u_x) - 1;
-  int32_t b_y = static_cast<int32_t>(v_y) - 1;
+  std::vector<int32_t> idx;
+  std::vector<float> wgt;
 
-  const uint8_t* sp[4];
+  for(unsigned i = 0; i < dst_n; ++i) {
 
-  float r[4]; float g[4]; float b[4]; float a[4];
+    float p = off + (i * scale);
 
-  for(int32_t j = 0; j < 4; ++j) {
+    idx.clear(); wgt.clear();
 
-    int32_t y = CLAMP(0, b_y + j, max_h) * row_bytes;
+    if(filter == RS_FILTER_BOX) {
 
-    for(int32_t i = 0; i < 4; ++i) {
+      // box top-left corner position
+      int32_t b_x = static_cast<int32_t>((p + 0.5f) - (0.5f * box_n));
 
-      int32_t x = CLAMP(0, b_x + i, max_w) * 4;
+      for(int32_t k = 0; k < box_n; ++k) {
+        int32_t x = b_x + k;
+        if(x < 0 || x > max_n) continue;
+        idx.push_back(x); wgt.push_back(1.0f);
+      }
 
-      sp[i] = src_pix + (y + x);
+      if(idx.empty()) {
+        idx.push_back(CLAMP(0, b_x, max_n)); wgt.push_back(1.0f);
+      }
+
+      for(size_t k = 0; k < wgt.size(); ++k)
+        wgt[k] /= wgt.size();
+
+    } else {
+
+      float b = std::floor(p);
+      float t = p - b;
+
+      int32_t b_x = static_cast<int32_t>(b);
+
+      if(filter == RS_FILTER_CUB) {
+
+        // Catmull-Rom weights, see CUBIC_INTERP
+        float t2 = t * t;
+        float t3 = t2 * t;
+
+        idx.push_back(CLAMP(0, b_x - 1, max_n)); wgt.push_back(0.5f * (-t + 2.0f * t2 - t3));
+        idx.push_back(CLAMP(0, b_x    , max_n)); wgt.push_back(1.0f + 0.5f * (-5.0f * t2 + 3.0f * t3));
+        idx.push_back(CLAMP(0, b_x + 1, max_n)); wgt.push_back(0.5f * (t + 4.0f * t2 - 3.0f * t3));
+        idx.push_back(CLAMP(0, b_x + 2, max_n)); wgt.push_back(0.5f * (-t2 + t3));
+
+      } else {
+
+        idx.push_back(CLAMP(0, b_x    , max_n)); wgt.push_back(1.0f - t);
+        idx.push_back(CLAMP(0, b_x + 1, max_n)); wgt.push_back(t);
+      }
     }
 
-    r[j] = CUBIC_INTERP(sp[0][0], sp[1][0], sp[2][0], sp[3][0], t_x);
-    g[j] = CUBIC_INTERP(sp[0][1], sp[1][1], sp[2][1], sp[3][1], t_x);
-    b[j] = CUBIC_INTERP(sp[0][2], sp[1][2], sp[2][2], sp[3][2], t_x);
-    a[j] = CUBIC_INTERP(sp[0][3], sp[1][3], sp[2][3], sp[3][3], t_x);
-  }
+    axis->tap_ofs[i] = axis->tap_idx.size();
+
+    // convert to fixed-point, the rounding error is given to the heaviest
+    // weight so weights sum is exactly one
+    int32_t sum = 0;
+    size_t heavy = 0;
 
-  float m[4];
+    for(size_t k = 0; k < idx.size(); ++k) {
 
-  m[0] = CUBIC_INTERP(r[0], r[1], r[2], r[3], t_y);
-  m[1] = CUBIC_INTERP(g[0], g[1], g[2], g[3], t_y);
-  m[2] = CUBIC_INTERP(b[0], b[1], b[2], b[3], t_y);
-  m[3] = CUBIC_INTERP(a[0], a[1], a[2], a[3], t_y);
+      int16_t w = static_cast<int16_t>(std::floor(wgt[k] * RS_WGT_ONE + 0.5f));
 
-  sample[0] = static_cast<uint8_t>(CLAMP(0.0f, m[0], 255.0f));
-  sample[1] = static_cast<uint8_t>(CLAMP(0.0f, m[1], 255.0f));
-  sample[2] = static_cast<uint8_t>(CLAMP(0.0f, m[2], 255.0f));
-  sample[3] = static_cast<uint8_t>(CLAMP(0.0f, m[3], 255.0f));
+      axis->tap_idx.push_back(idx[k]);
+      axis->tap_wgt.push_back(w);
+
+      sum += w;
+
+      if(wgt[k] > wgt[heavy]) heavy = k;
+    }
+
+    axis->tap_wgt[axis->tap_ofs[i] + heavy] += (RS_WGT_ONE - sum);
+
+    // pad with null weight to get even tap count
+    if(idx.size() & 1) {
+      axis->tap_idx.push_back(idx[0]);
+      axis->tap_wgt.push_back(0);
+    }
+  }
+
+  axis->tap_ofs[dst_n] = axis->tap_idx.size();
 }
 
-/// \brief Get bilinear interpolated pixel.
+/// \brief Horizontal resampling pass
 ///
-/// Compute the bilinear interpolated pixel sample at the specified
-/// coordinates of the given source image.
+/// Resamples one row of RGBA pixels according the given axis filter.
 ///
-/// \param[in]  sample  : Array to receive interpolated pixel components.
-/// \param[in]  u       : Sample horizontal coordinate in image, from 0.0 to 1.0.
-/// \param[in]  v       : Sample vertical coordinate in image, from 0.0 to 1.0.
-/// \param[in]  src_pix : Input image RGB(A) data.
-/// \param[in]  src_w   : Input image width.
-/// \param[in]  src_h   : Input image height.
+/// \param[out] dp      : Destination row.
+/// \param[in]  sp      : Source row.
+/// \param[in]  axis    : Horizontal axis filter.
+/// \param[in]  dst_w   : Destination row width in pixels.
 ///
-inline static void __get_sample_lin_32(uint8_t* sample, float u, float v, const uint8_t* src_pix, unsigned src_w, unsigned src_h, int max_w, int max_h, uint32_t row_bytes)
+inline static void __resample_row_h(uint8_t* dp, const uint8_t* sp, const __rs_axis_t* axis, unsigned dst_w)
 {
-  float u_x, v_y;
+  const uint32_t* ofs = axis->tap_ofs.data();
+  const int32_t*  idx = axis->tap_idx.data();
+  const int16_t*  wgt = axis->tap_wgt.data();
 
-  float t_x = std::modf((u * src_w) - 0.5f, &u_x);
-  float t_y = std::modf((v * src_h) - 0.5f, &v_y);
+  #ifdef OM_IMG_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rnd = _mm_set1_epi32(RS_WGT_RND);
+  #endif // OM_IMG_SSE2
 
-  int b_x = static_cast<int>(u_x) - 1;
-  int b_y = static_cast<int>(v_y) - 1;
+  for(unsigned x = 0; x < dst_w; ++x, dp += 4) {
 
-  const uint8_t* sp[2];
+    #ifdef OM_IMG_SSE2
+    __m128i acc = zero;
 
-  float r[2];
-  float g[2];
-  float b[2];
-  float a[2];
+    for(uint32_t k = ofs[x]; k < ofs[x+1]; k += 2) {
 
-  for(int32_t j = 0; j < 2; ++j) {
+      int32_t p0, p1;
+      memcpy(&p0, sp + (idx[k] * 4), 4);
+      memcpy(&p1, sp + (idx[k+1] * 4), 4);
 
-    int32_t y = CLAMP(0, b_y + j, max_h) * row_bytes;
+      // interleave the two pixels components as 16 bits values so both taps
+      // are multiplied and summed at once
+      __m128i pp = _mm_unpacklo_epi8(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p0), _mm_cvtsi32_si128(p1)), zero);
+      __m128i ww = _mm_set1_epi32((static_cast<uint16_t>(wgt[k+1]) << 16) | static_cast<uint16_t>(wgt[k]));
 
-    for(int32_t i = 0; i < 2; ++i) {
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(pp, ww));
+    }
 
-      int32_t x = CLAMP(0, b_x + i, max_w) * 4;
+    acc = _mm_srai_epi32(_mm_add_epi32(acc, rnd), RS_WGT_BITS);
+    acc = _mm_packs_epi32(acc, acc);
+    acc = _mm_packus_epi16(acc, acc);
+
+    int32_t px = _mm_cvtsi128_si32(acc);
+    memcpy(dp, &px, 4);
+    #else
+    int32_t r = RS_WGT_RND, g = RS_WGT_RND, b = RS_WGT_RND, a = RS_WGT_RND;
+
+    for(uint32_t k = ofs[x]; k < ofs[x+1]; ++k) {
+      const uint8_t* p = sp + (idx[k] * 4);
+      r += wgt[k] * p[0];
+      g += wgt[k] * p[1];
+      b += wgt[k] * p[2];
+      a += wgt[k] * p[3];
+    }
 
-      sp[i] = src_pix + (y + x);
+    dp[0] = CLAMP(0, r >> RS_WGT_BITS, 255);
+    dp[1] = CLAMP(0, g >> RS_WGT_BITS, 255);
+    dp[2] = CLAMP(0, b >> RS_WGT_BITS, 255);
+    dp[3] = CLAMP(0, a >> RS_WGT_BITS, 255);
+    #endif // OM_IMG_SSE2
+  }
+}
+
+/// \brief Vertical resampling pass
+///
+/// Computes one destination row as weighted sum of the given rows.
+///
+/// \param[out] dp        : Destination row.
+/// \param[in]  tmp_pix   : Intermediate pixel buffer.
+/// \param[in]  row_bytes : Intermediate and destination row size in bytes.
+/// \param[in]  idx       : Taps rows indexes in intermediate buffer.
+/// \param[in]  wgt       : Taps weights.
+/// \param[in]  n_taps    : Taps count, must be even.
+///
+inline static void __resample_row_v(uint8_t* dp, const uint8_t* tmp_pix, uint32_t row_bytes, const int32_t* idx, const int16_t* wgt, uint32_t n_taps)
+{
+  uint32_t x = 0;
+
+  #ifdef OM_IMG_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rnd = _mm_set1_epi32(RS_WGT_RND);
+
+  // 2 pixels per iteration
+  for(; x + 8 <= row_bytes; x += 8) {
+
+    __m128i acc_lo = zero;
+    __m128i acc_hi = zero;
+
+    for(uint32_t k = 0; k < n_taps; k += 2) {
+
+      __m128i r0 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(tmp_pix + (idx[k] * row_bytes) + x)), zero);
+      __m128i r1 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(tmp_pix + (idx[k+1] * row_bytes) + x)), zero);
+      __m128i ww = _mm_set1_epi32((static_cast<uint16_t>(wgt[k+1]) << 16) | static_cast<uint16_t>(wgt[k]));
+
+      acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(_mm_unpacklo_epi16(r0, r1), ww));
+      acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(_mm_unpackhi_epi16(r0, r1), ww));
     }
 
-    r[j] = LERP(sp[0][0], sp[1][0], t_x);
-    g[j] = LERP(sp[0][1], sp[1][1], t_x);
-    b[j] = LERP(sp[0][2], sp[1][2], t_x);
-    a[j] = LERP(sp[0][3], sp[1][3], t_x);
+    acc_lo = _mm_srai_epi32(_mm_add_epi32(acc_lo, rnd), RS_WGT_BITS);
+    acc_hi = _mm_srai_epi32(_mm_add_epi32(acc_hi, rnd), RS_WGT_BITS);
+
+    __m128i px = _mm_packs_epi32(acc_lo, acc_hi);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dp + x), _mm_packus_epi16(px, px));
   }
+  #endif // OM_IMG_SSE2
+
+  for(; x < row_bytes; ++x) {
+
+    int32_t c = RS_WGT_RND;
 
-  sample[0] = static_cast<uint8_t>(LERP(r[0], r[1], t_y));
-  sample[1] = static_cast<uint8_t>(LERP(g[0], g[1], t_y));
-  sample[2] = static_cast<uint8_t>(LERP(b[0], b[1], t_y));
-  sample[3] = static_cast<uint8_t>(LERP(a[0], a[1], t_y));
+    for(uint32_t k = 0; k < n_taps; ++k)
+      c += wgt[k] * tmp_pix[(idx[k] * row_bytes) + x];
+
+    dp[x] = CLAMP(0, c >> RS_WGT_BITS, 255);
+  }
 }
 
+/// \brief Resampling context
+///
+/// Structure shared by workers during separable resampling
+///
+typedef struct {
+
+  uint8_t*            dst_pix;
+
+  uint32_t            dst_row_bytes;
+
+  unsigned            dst_w;
+
+  unsigned            dst_h;
+
+  const uint8_t*      src_pix;
+
+  uint32_t            src_row_bytes;
+
+  uint8_t*            tmp_pix;
+
+  unsigned            tmp_h;
+
+  const int32_t*      tmp_rows;
+
+  const int32_t*      tmp_map;
+
+  const __rs_axis_t*  axis_x;
+
+  const __rs_axis_t*  axis_y;
+
+} __rs_ctx_t;
 
-/// \brief Get box sample pixel.
 ///
-/// Get the box pixel sample at the specified coordinates of the given
-/// source image.
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-/// \param[in]  sample    : Array to receive interpolated pixel components.
-/// \param[in]  b_w       : Box width in pixels.
-/// \param[in]  b_h       : Box height in pixels.
-/// \param[in]  u         : Sample horizontal coordinate in image, from 0.0 to 1.0.
-/// \param[in]  v         : Sample vertical coordinate in image, from 0.0 to 1.0.
-/// \param[in]  src_pix   : Input image RGB(A) data.
-/// \param[in]  src_w     : Input image width.
-/// \param[in]  src_h     : Input image height.
-/// \param[in]  max_w     : Input image X index limit, should be src_w - 1.
-/// \param[in]  max_h     : Input image Y index limit, should be src_h - 1.
-/// \param[in]  row_bytes : size in bytes of an input image row
+static bool __resample_h_job_fn(void* ptr, size_t index, unsigned worker)
+{
+  OM_UNUSED(worker);
+
+  __rs_ctx_t* ctx = static_cast<__rs_ctx_t*>(ptr);
+
+  uint32_t tmp_row_bytes = ctx->dst_w * 4;
+
+  unsigned y = index * RS_JOB_ROWS;
+  unsigned e = MIN(y + RS_JOB_ROWS, ctx->tmp_h);
+
+  for(; y < e; ++y)
+    __resample_row_h(ctx->tmp_pix + (y * tmp_row_bytes), ctx->src_pix + (ctx->tmp_rows[y] * ctx->src_row_bytes), ctx->axis_x, ctx->dst_w);
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-inline static void __get_sample_box_32(uint8_t* sample, int b_w, int b_h, float u, float v, const uint8_t* src_pix, unsigned src_w, unsigned src_h, int max_w, int max_h, uint32_t row_bytes)
+static bool __resample_v_job_fn(void* ptr, size_t index, unsigned worker)
 {
-  float r = 0.0f;
-  float g = 0.0f;
-  float b = 0.0f;
-  float a = 0.0f;
+  OM_UNUSED(worker);
 
-  const uint8_t *sp;
+  __rs_ctx_t* ctx = static_cast<__rs_ctx_t*>(ptr);
 
-  float n = 0;
+  uint32_t tmp_row_bytes = ctx->dst_w * 4;
 
-  // box top-left corner position
-  int b_x = (u * src_w) - (0.5f * b_w);
-  int b_y = (v * src_h) - (0.5f * b_h);
+  const uint32_t* ofs = ctx->axis_y->tap_ofs.data();
+  const int32_t*  idx = ctx->axis_y->tap_idx.data();
+  const int16_t*  wgt = ctx->axis_y->tap_wgt.data();
 
-  for(int32_t j = 0; j < b_h; ++j) {
+  unsigned y = index * RS_JOB_ROWS;
+  unsigned e = MIN(y + RS_JOB_ROWS, ctx->dst_h);
 
-    int32_t y = b_y + j;
-    if(y < 0 || y > max_h) continue;
+  int32_t row_idx[64];
 
-    y *= row_bytes;
+  for(; y < e; ++y) {
 
-    for(int32_t i = 0; i < b_w; ++i) {
+    uint32_t n_taps = ofs[y+1] - ofs[y];
 
-      int32_t x = b_x + i;
-      if(x < 0 || x > max_w) continue;
+    // taps indexes of rows in intermediate buffer
+    int32_t* tmp_idx = (n_taps <= 64) ? row_idx : new int32_t[n_taps];
 
-      sp = src_pix + (y + (x * 4));
+    for(uint32_t k = 0; k < n_taps; ++k)
+      tmp_idx[k] = ctx->tmp_map[idx[ofs[y] + k]];
 
-      r += sp[0];
-      g += sp[1];
-      b += sp[2];
-      a += sp[3];
+    __resample_row_v(ctx->dst_pix + (y * ctx->dst_row_bytes), ctx->tmp_pix, tmp_row_bytes, tmp_idx, wgt + ofs[y], n_taps);
 
-      n += 1.0f;
-    }
+    if(tmp_idx != row_idx) delete [] tmp_idx;
+  }
+
+  return true;
+}
+
+/// \brief Separable resampling.
+///
+/// Resamples source image to destination using the given precomputed axis
+/// filters, horizontally then vertically through an intermediate buffer.
+/// Rows are processed in parallel for large images.
+///
+/// \param[out] dst_pix       : Destination pixel buffer that receive result.
+/// \param[in]  dst_w         : Destination width in pixel.
+/// \param[in]  dst_h         : Destination height in pixel.
+/// \param[in]  dst_row_bytes : Destination row size in bytes.
+/// \param[in]  src_pix       : Source pixel buffer.
+/// \param[in]  src_w         : Source width.
+/// \param[in]  src_h         : source height.
+/// \param[in]  axis_x        : Horizontal axis filter.
+/// \param[in]  axis_y        : Vertical axis filter.
+///
+static void __resample_32(uint8_t* dst_pix, unsigned dst_w, unsigned dst_h, uint32_t dst_row_bytes, const uint8_t* src_pix, unsigned src_w, unsigned src_h, const __rs_axis_t* axis_x, const __rs_axis_t* axis_y)
+{
+  if(!dst_w || !dst_h)
+    return;
+
+  // only source rows used by vertical filter need horizontal pass, we
+  // build the list of these rows and their index in intermediate buffer
+  std::vector<int32_t> tmp_map(src_h, -1);
+  for(size_t k = 0; k < axis_y->tap_idx.size(); ++k)
+    tmp_map[axis_y->tap_idx[k]] = 0;
+
+  std::vector<int32_t> tmp_rows;
+  for(unsigned y = 0; y < src_h; ++y) {
+    if(tmp_map[y] < 0) continue;
+    tmp_map[y] = tmp_rows.size();
+    tmp_rows.push_back(y);
   }
 
-  // assign average pixel
-  sample[0] = r / n;
-  sample[1] = g / n;
-  sample[2] = b / n;
-  sample[3] = a / n;
+  __rs_ctx_t ctx;
+  ctx.dst_pix = dst_pix;
+  ctx.dst_row_bytes = dst_row_bytes;
+  ctx.dst_w = dst_w;
+  ctx.dst_h = dst_h;
+  ctx.src_pix = src_pix;
+  ctx.src_row_bytes = src_w * 4; //< assuming RGBA data
+  ctx.tmp_h = tmp_rows.size();
+  ctx.tmp_rows = tmp_rows.data();
+  ctx.tmp_map = tmp_map.data();
+  ctx.axis_x = axis_x;
+  ctx.axis_y = axis_y;
+
+  ctx.tmp_pix = reinterpret_cast<uint8_t*>(Om_alloc(dst_w * ctx.tmp_h * 4));
+  if(!ctx.tmp_pix) return;
+
+  unsigned threads = ((src_w * src_h) + (dst_w * dst_h) > RS_PARALLEL_MIN) ? 0 : 1;
+
+  Om_parallelFor((ctx.tmp_h + RS_JOB_ROWS - 1) / RS_JOB_ROWS, __resample_h_job_fn, &ctx, threads);
+
+  Om_parallelFor((dst_h + RS_JOB_ROWS - 1) / RS_JOB_ROWS, __resample_v_job_fn, &ctx, threads);
+
+  Om_free(ctx.tmp_pix);
+}
+
+/// \brief Copy and resample using separable filter.
+///
+/// Copy and resamples the specified rectangle of source image to destination
+/// using the specified filter.
+///
+/// \param[out] dst_pix   : Destination pixel buffer that receive result.
+/// \param[in]  dst_w     : Destination width in pixel.
+/// \param[in]  dst_h     : Destination height in pixel.
+/// \param[in]  src_pix   : Source pixel buffer.
+/// \param[in]  src_w     : Source width.
+/// \param[in]  src_h     : source height.
+/// \param[in]  rec_x     : Rectangle top-left corner x coordinate in source.
+/// \param[in]  rec_y     : Rectangle top-left corner y coordinate in source
+/// \param[in]  rec_w     : Rectangle width
+/// \param[in]  rec_h     : Rectangle height.
+/// \param[in]  filter    : Filter type, one of RS_FILTER_* value.
+///
+inline static void __copy_resample_sep(uint8_t* dst_pix, unsigned dst_w, unsigned dst_h, const uint8_t* src_pix, unsigned src_w, unsigned src_h, unsigned rec_x, unsigned rec_y, unsigned rec_w, unsigned rec_h, int filter)
+{
+  // compute box size
+  int b_w = ceil(static_cast<float>(rec_w) / dst_w);
+  int b_h = ceil(static_cast<float>(rec_h) / dst_h);
+
+  // sample position factor corresponding to rectangle width and height
+  float f_x = static_cast<float>(rec_w) / dst_w;
+  float f_y = static_cast<float>(rec_h) / dst_h;
+
+  __rs_axis_t axis_x, axis_y;
+
+  __resample_axis(&axis_x, filter, dst_w, src_w, rec_x - 0.5f, f_x, b_w);
+  __resample_axis(&axis_y, filter, dst_h, src_h, rec_y - 0.5f, f_y, b_h);
+
+  __resample_32(dst_pix, dst_w, dst_h, dst_w * 4, src_pix, src_w, src_h, &axis_x, &axis_y);
 }
 
 /// \brief Copy and resample using bicubic interpolation.
@@ -401,29 +670,7 @@ inline static void __copy_resample_cub(uint8_t* dst_pix, unsigned dst_w, unsigne
   clock_t t = clock();
   #endif // DEBUG
 
-  // U and V shift corresponding to rectangle top-left corner
-  float s_u = static_cast<float>(rec_x) / src_w;
-  float s_v = static_cast<float>(rec_y) / src_h;
-
-  // U and V factor corresponding to rectangle width and height
-  float f_u = (1.0f / static_cast<float>(dst_w)) * (static_cast<float>(rec_w) / src_w);
-  float f_v = (1.0f / static_cast<float>(dst_h)) * (static_cast<float>(rec_h) / src_h);
-
-  // some constants
-  uint32_t dst_row_bytes = (dst_w * 4); //< assuming RGBA data
-  uint32_t src_row_bytes = (src_w * 4); //< assuming RGBA data
-  int max_w = (src_w - 1);
-  int max_h = (src_h - 1);
-
-  // Loop for RGBA
-  for(unsigned y = 0; y < dst_h; ++y) {
-    uint8_t* dp = dst_pix + (dst_row_bytes * y);
-    float v = s_v + (y * f_v);
-    for(unsigned x = 0; x < dst_w; ++x, dp += 4) {
-      float u = s_u + (x * f_u);
-      __get_sample_cub_32(dp, u, v, src_pix, src_w, src_h, max_w, max_h, src_row_bytes);
-    }
-  }
+  __copy_resample_sep(dst_pix, dst_w, dst_h, src_pix, src_w, src_h, rec_x, rec_y, rec_w, rec_h, RS_FILTER_CUB);
 
   #ifdef DEBUG
   t = clock() - t;
@@ -454,29 +701,7 @@ inline static void __copy_resample_lin(uint8_t* dst_pix, unsigned dst_w, unsigne
   clock_t t = clock();
   #endif // DEBUG
 
-  // U and V shift corresponding to rectangle top-left corner
-  float s_u = static_cast<float>(rec_x) / src_w;
-  float s_v = static_cast<float>(rec_y) / src_h;
-
-  // U and V factor corresponding to rectangle width and height
-  float f_u = (1.0f / static_cast<float>(dst_w)) * (static_cast<float>(rec_w) / src_w);
-  float f_v = (1.0f / static_cast<float>(dst_h)) * (static_cast<float>(rec_h) / src_h);
-
-  // some constants
-  uint32_t dst_row_bytes = (dst_w * 4); //< assuming RGBA data
-  uint32_t src_row_bytes = (src_w * 4); //< assuming RGBA data
-  int max_w = (src_w - 1);
-  int max_h = (src_h - 1);
-
-  // Loop for RGBA
-  for(unsigned y = 0; y < dst_h; ++y) {
-    uint8_t* dp = dst_pix + (dst_row_bytes * y);
-    float v = s_v + (y * f_v);
-    for(unsigned x = 0; x < dst_w; ++x, dp += 4) {
-      float u = s_u + (x * f_u);
-      __get_sample_lin_32(dp, u, v, src_pix, src_w, src_h, max_w, max_h, src_row_bytes);
-    }
-  }
+  __copy_resample_sep(dst_pix, dst_w, dst_h, src_pix, src_w, src_h, rec_x, rec_y, rec_w, rec_h, RS_FILTER_LIN);
 
   #ifdef DEBUG
   t = clock() - t;
@@ -510,33 +735,7 @@ inline static void __copy_resample_box(uint8_t* dst_pix, unsigned dst_w, unsigne
   clock_t t = clock();
   #endif // DEBUG
 
-  // compute box size
-  int b_w = ceil(static_cast<float>(rec_w) / dst_w);
-  int b_h = ceil(static_cast<float>(rec_h) / dst_h);
-
-  // U and V shift corresponding to rectangle top-left corner
-  float s_u = static_cast<float>(rec_x) / src_w;
-  float s_v = static_cast<float>(rec_y) / src_h;
-
-  // U and V factor corresponding to rectangle width and height
-  float f_u = (1.0f / static_cast<float>(dst_w)) * (static_cast<float>(rec_w) / src_w);
-  float f_v = (1.0f / static_cast<float>(dst_h)) * (static_cast<float>(rec_h) / src_h);
-
-  // some constants
-  uint32_t dst_row_bytes = (dst_w * 4); //< assuming RGBA data
-  uint32_t src_row_bytes = (src_w * 4); //< assuming RGBA data
-  int max_w = (src_w - 1);
-  int max_h = (src_h - 1);
-
-  for(unsigned y = 0; y < dst_h; ++y) {
-    uint8_t* dp = dst_pix + (dst_row_bytes * y);
-    float v = s_v + (y * f_v);
-    for(unsigned x = 0; x < dst_w; ++x, dp += 4) {
-      float u = s_u + (x * f_u);
-      __get_sample_box_32(dp, b_w, b_h, u, v, src_pix, src_w, src_h, max_w, max_h, src_row_bytes);
-    }
-  }
-
+  __copy_resample_sep(dst_pix, dst_w, dst_h, src_pix, src_w, src_h, rec_x, rec_y, rec_w, rec_h, RS_FILTER_BOX);
 
   #ifdef DEBUG
   t = clock() - t;
@@ -584,14 +783,9 @@ inline static void __copy_resample(uint8_t* dst_pix, unsigned dst_w, unsigned ds
     uint32_t row_shift = (rec_x * 4); //< assuming RGBA data
 
     for(unsigned y = 0; y < dst_h; ++y) {
-      const uint8_t* sp = src_pix + ((y + rec_y) * row_bytes) + row_shift;
+      const uint8_t* sp = src_pix + ((y + rec_y) * src_w * 4) + row_shift;
       uint8_t* dp = dst_pix + (y * row_bytes);
-      for(unsigned x = 0; x < dst_w; ++x, dp += 4, sp += 4) {
-        dp[0] = sp[0];
-        dp[1] = sp[1];
-        dp[2] = sp[2];
-        dp[3] = sp[3];
-      }
+      memcpy(dp, sp, row_bytes);
     }
 
     #ifdef DEBUG
@@ -601,13 +795,10 @@ inline static void __copy_resample(uint8_t* dst_pix, unsigned dst_w, unsigned ds
   }
 }
 
-/// \brief Draw image in destination canvas
+/// \brief Draw image in destination canvas using separable filter.
 ///
 /// Draws the source image to fit into the given canvas keeping the source
-/// aspect ratio, resampling source image using bicubic interpolation.
-///
-/// This function should be preferred for upsampling operation, meaning when
-/// the destination resolution is greater than the specified source rectangle.
+/// aspect ratio, resampling source image using the specified filter.
 ///
 /// \param[out] cv_pix    : Canvas pixel buffer that receive result.
 /// \param[in]  cv_w      : Canvas width in pixel.
@@ -615,15 +806,11 @@ inline static void __copy_resample(uint8_t* dst_pix, unsigned dst_w, unsigned ds
 /// \param[in]  src_pix   : Source pixel buffer.
 /// \param[in]  src_w     : Source width.
 /// \param[in]  src_h     : source height.
-/// \param[in]  src_c     : Source component count (bytes per pixel)
 /// \param[in]  bck       : Background color
+/// \param[in]  filter    : Filter type, one of RS_FILTER_* value.
 ///
-inline static void __draw_canvas_cub(uint8_t* cv_pix, unsigned cv_w, unsigned cv_h, const uint8_t* src_pix, unsigned src_w, unsigned src_h, uint32_t bck)
+inline static void __draw_canvas_sep(uint8_t* cv_pix, unsigned cv_w, unsigned cv_h, const uint8_t* src_pix, unsigned src_w, unsigned src_h, uint32_t bck, int filter)
 {
-  #ifdef DEBUG
-  clock_t t = clock();
-  #endif // DEBUG
-
   unsigned dst_x, dst_y, dst_w, dst_h;
 
   if((static_cast<float>(src_w) / src_h) > (static_cast<float>(cv_w) / cv_h)) {
@@ -641,37 +828,68 @@ inline static void __draw_canvas_cub(uint8_t* cv_pix, unsigned cv_w, unsigned cv
     dst_y = 0;
   }
 
-  // U and V factor corresponding to rectangle width and height
-  float f_u = 1.0f / static_cast<float>(dst_w - 1);
-  float f_v = 1.0f / static_cast<float>(dst_h - 1);
+  dst_w = CLAMP(1, dst_w, cv_w);
+  dst_h = CLAMP(1, dst_h, cv_h);
+  if(dst_x + dst_w > cv_w) dst_x = cv_w - dst_w;
+  if(dst_y + dst_h > cv_h) dst_y = cv_h - dst_h;
 
-  // U and V shift corresponding to destination top-left corner in canvas
-  float s_u = f_u * dst_x;
-  float s_v = f_v * dst_y;
-
-  // some constants
   uint32_t dst_row_bytes = (cv_w  * 4); //< assuming RGBA data
-  uint32_t src_row_bytes = (src_w * 4); //< assuming RGBA data
-  int max_w = (src_w - 1);
-  int max_h = (src_h - 1);
 
+  // fill canvas area outside the drawn image with background color
   for(unsigned y = 0; y < cv_h; ++y) {
     uint8_t* dp = cv_pix + (dst_row_bytes * y);
-    float v = (y * f_v) - s_v;
-    if(v < 0.0 || v > 1.0) {
+    if(y < dst_y || y >= (dst_y + dst_h)) {
       __set_row_32(dp, cv_w, bck);
-      continue;
-    }
-    for(unsigned x = 0; x < cv_w; ++x, dp += 4) {
-      float u = (x * f_u) - s_u;
-      if(u < 0.0 || u > 1.0) {
-        __set_pixel_32(dp, bck);
-      } else {
-        __get_sample_cub_32(dp, u, v, src_pix, src_w, src_h, max_w, max_h, src_row_bytes);
-      }
+    } else {
+      __set_row_32(dp, dst_x, bck);
+      __set_row_32(dp + ((dst_x + dst_w) * 4), cv_w - (dst_x + dst_w), bck);
     }
   }
 
+  // compute box size
+  int b_w = ceil(static_cast<float>(src_w) / dst_w);
+  int b_h = ceil(static_cast<float>(src_h) / dst_h);
+
+  // sample position factor, first and last destination pixels map to the
+  // source image edges
+  float f_x = (dst_w > 1) ? static_cast<float>(src_w) / (dst_w - 1) : 0.0f;
+  float f_y = (dst_h > 1) ? static_cast<float>(src_h) / (dst_h - 1) : 0.0f;
+
+  __rs_axis_t axis_x, axis_y;
+
+  __resample_axis(&axis_x, filter, dst_w, src_w, -0.5f, f_x, b_w);
+  __resample_axis(&axis_y, filter, dst_h, src_h, -0.5f, f_y, b_h);
+
+  uint8_t* dp = cv_pix + (dst_row_bytes * dst_y) + (dst_x * 4);
+
+  __resample_32(dp, dst_w, dst_h, dst_row_bytes, src_pix, src_w, src_h, &axis_x, &axis_y);
+}
+
+/// \brief Draw image in destination canvas
+///
+/// Draws the source image to fit into the given canvas keeping the source
+/// aspect ratio, resampling source image using bicubic interpolation.
+///
+/// This function should be preferred for upsampling operation, meaning when
+/// the destination resolution is greater than the specified source rectangle.
+///
+/// \param[out] cv_pix    : Canvas pixel buffer that receive result.
+/// \param[in]  cv_w      : Canvas width in pixel.
+/// \param[in]  cv_h      : Canvas height in pixel.
+/// \param[in]  src_pix   : Source pixel buffer.
+/// \param[in]  src_w     : Source width.
+/// \param[in]  src_h     : source height.
+/// \param[in]  src_c     : Source component count (bytes per pixel)
+/// \param[in]  bck       : Background color
+///
+inline static void __draw_canvas_cub(uint8_t* cv_pix, unsigned cv_w, unsigned cv_h, const uint8_t* src_pix, unsigned src_w, unsigned src_h, uint32_t bck)
+{
+  #ifdef DEBUG
+  clock_t t = clock();
+  #endif // DEBUG
+
+  __draw_canvas_sep(cv_pix, cv_w, cv_h, src_pix, src_w, src_h, bck, RS_FILTER_CUB);
+
   #ifdef DEBUG
   t = clock() - t;
   std::cout << "DEBUG => __draw_canvas_cub : " << 1000.0 * ((double)t / CLOCKS_PER_SEC) << " ms\n";
@@ -702,53 +920,7 @@ inline static void __draw_canvas_lin(uint8_t* cv_pix, unsigned cv_w, unsigned cv
   clock_t t = clock();
   #endif // DEBUG
 
-  unsigned dst_x, dst_y, dst_w, dst_h;
-
-  if((static_cast<float>(src_w) / src_h) > (static_cast<float>(cv_w) / cv_h)) {
-
-    dst_w = cv_w;
-    dst_h = cv_w * (static_cast<float>(src_h) / src_w);
-    dst_x = 0;
-    dst_y = (0.5f * cv_h) - (0.5f * dst_h);
-
-  } else {
-
-    dst_w = cv_h * (static_cast<float>(src_w) / src_h);
-    dst_h = cv_h;
-    dst_x = (0.5f * cv_w) - (0.5f * dst_w);
-    dst_y = 0;
-  }
-
-  // U and V factor corresponding to rectangle width and height
-  float f_u = 1.0f / static_cast<float>(dst_w - 1);
-  float f_v = 1.0f / static_cast<float>(dst_h - 1);
-
-  // U and V shift corresponding to destination top-left corner in canvas
-  float s_u = f_u * dst_x;
-  float s_v = f_v * dst_y;
-
-  // some constants
-  uint32_t dst_row_bytes = (cv_w  * 4); //< assuming RGBA data
-  uint32_t src_row_bytes = (src_w * 4); //< assuming RGBA data
-  int max_w = (src_w - 1);
-  int max_h = (src_h - 1);
-
-  for(unsigned y = 0; y < cv_h; ++y) {
-    uint8_t* dp = cv_pix + (dst_row_bytes * y);
-    float v = (y * f_v) - s_v;
-    if(v < 0.0 || v > 1.0) {
-      __set_row_32(dp, cv_w, bck);
-      continue;
-    }
-    for(unsigned x = 0; x < cv_w; ++x, dp += 4) {
-      float u = (x * f_u) - s_u;
-      if(u < 0.0 || u > 1.0) {
-        __set_pixel_32(dp, bck);
-      } else {
-        __get_sample_lin_32(dp, u, v, src_pix, src_w, src_h, max_w, max_h, src_row_bytes);
-      }
-    }
-  }
+  __draw_canvas_sep(cv_pix, cv_w, cv_h, src_pix, src_w, src_h, bck, RS_FILTER_LIN);
 
   #ifdef DEBUG
   t = clock() - t;
@@ -780,57 +952,7 @@ inline static void __draw_canvas_box(uint8_t* cv_pix, unsigned cv_w, unsigned cv
   clock_t t = clock();
   #endif // DEBUG
 
-  unsigned dst_x, dst_y, dst_w, dst_h;
-
-  if((static_cast<float>(src_w) / src_h) > (static_cast<float>(cv_w) / cv_h)) {
-
-    dst_w = cv_w;
-    dst_h = cv_w * (static_cast<float>(src_h) / src_w);
-    dst_x = 0;
-    dst_y = (0.5f * cv_h) - (0.5f * dst_h);
-
-  } else {
-
-    dst_w = cv_h * (static_cast<float>(src_w) / src_h);
-    dst_h = cv_h;
-    dst_x = (0.5f * cv_w) - (0.5f * dst_w);
-    dst_y = 0;
-  }
-
-  // compute box size
-  int b_w = ceil(static_cast<float>(src_w) / dst_w);
-  int b_h = ceil(static_cast<float>(src_h) / dst_h);
-
-  // U and V factor corresponding to rectangle width and height
-  float f_u = 1.0f / static_cast<float>(dst_w - 1);
-  float f_v = 1.0f / static_cast<float>(dst_h - 1);
-
-  // U and V shift corresponding to destination top-left corner in canvas
-  float s_u = f_u * dst_x;
-  float s_v = f_v * dst_y;
-
-  // some constants
-  uint32_t dst_row_bytes = (cv_w  * 4); //< assuming RGBA data
-  uint32_t src_row_bytes = (src_w * 4); //< assuming RGBA data
-  int max_w = (src_w - 1);
-  int max_h = (src_h - 1);
-
-  for(unsigned y = 0; y < cv_h; ++y) {
-    uint8_t* dp = cv_pix + (dst_row_bytes * y);
-    float v = (y * f_v) - s_v;
-    if(v < 0.0f || v > 1.0f) {
-      __set_row_32(dp, cv_w, bck);
-      continue;
-    }
-    for(unsigned x = 0; x < cv_w; ++x, dp += 4) {
-      float u = (x * f_u) - s_u;
-      if(u < 0.0f || u > 1.0f) {
-        __set_pixel_32(dp, bck);
-      } else {
-        __get_sample_box_32(dp, b_w, b_h, u, v, src_pix, src_w, src_h, max_w, max_h, src_row_bytes);
-      }
-    }
-  }
+  __draw_canvas_sep(cv_pix, cv_w, cv_h, src_pix, src_w, src_h, bck, RS_FILTER_BOX);
 
   #ifdef DEBUG
   t = clock() - t;
@@ -917,6 +1039,168 @@ inline static void __draw_canvas(uint8_t* cv_pix, unsigned cv_w, unsigned cv_h,
   }
 }
 
+/// \brief Get thumbnail reduction factor
+///
+/// Computes the largest power-of-two reduction factor, up to 8, which can be
+/// applied to an image of the given size while still having enough pixels
+/// to make a thumbnail of the given span.
+///
+/// \param[in]  w     : Image width.
+/// \param[in]  h     : Image height.
+/// \param[in]  span  : Thumbnail span, or 0 for full resolution.
+/// \param[in]  mode  : Thumbnail resize mode.
+///
+/// \return Reduction factor, either 1, 2, 4 or 8.
+///
+inline static unsigned __thumb_reduce_factor(unsigned w, unsigned h, unsigned span, OmSizeMode mode)
+{
+  if(!span)
+    return 1;
+
+  // with fill mode the smaller side is cropped to span, while with fit mode
+  // the larger side is resized to span
+  unsigned side = (mode == OM_SIZE_FILL) ? MIN(w, h) : ((w > h) ? w : h);
+
+  unsigned d = 8;
+  while(d > 1 && (side / d) < span)
+    d >>= 1;
+
+  return d;
+}
+
+/// \brief Row reduction context
+///
+/// Structure used to box-reduce image by an integer factor while rows are
+/// decoded, so full resolution image never lie in memory.
+///
+typedef struct {
+
+  uint8_t*    pixels;
+
+  uint32_t*   acc;
+
+  unsigned    src_w;
+
+  unsigned    out_w;
+
+  unsigned    out_h;
+
+  unsigned    c;
+
+  unsigned    d;
+
+  bool        flip_y;
+
+} __reduce_ctx_t;
+
+/// \brief Initialize row reduction
+///
+/// Initializes row reduction context and allocates output buffer, large
+/// enough to store **RGBA** data.
+///
+/// \param[out] ctx     : Row reduction context to initialize.
+/// \param[in]  src_w   : Source image width.
+/// \param[in]  src_h   : Source image height.
+/// \param[in]  src_c   : Source image color component count.
+/// \param[in]  d       : Reduction factor.
+/// \param[in]  flip_y  : Output image for bottom-left origin usage (upside down)
+///
+/// \return True if succeed, false if allocation failed.
+///
+static bool __reduce_init(__reduce_ctx_t* ctx, unsigned src_w, unsigned src_h, unsigned src_c, unsigned d, bool flip_y)
+{
+  // image may be too small in one dimension
+  while(d > 1 && (src_w < d || src_h < d))
+    d >>= 1;
+
+  ctx->src_w = src_w;
+  ctx->out_w = src_w / d;
+  ctx->out_h = src_h / d;
+  ctx->c = src_c;
+  ctx->d = d;
+  ctx->flip_y = flip_y;
+
+  ctx->pixels = reinterpret_cast<uint8_t*>(Om_alloc(ctx->out_w * ctx->out_h * 4));
+  if(!ctx->pixels) return false;
+
+  ctx->acc = reinterpret_cast<uint32_t*>(Om_alloc(ctx->out_w * src_c * sizeof(uint32_t)));
+  if(!ctx->acc) {
+    Om_free(ctx->pixels);
+    return false;
+  }
+
+  memset(ctx->acc, 0, ctx->out_w * src_c * sizeof(uint32_t));
+
+  return true;
+}
+
+/// \brief Add row to reduction
+///
+/// Accumulates the given decoded source row, then writes the output row
+/// once enough rows were accumulated. Remaining rows and columns which does
+/// not fill a complete box are ignored.
+///
+/// \param[in]  ctx     : Row reduction context.
+/// \param[in]  y       : Source row index.
+/// \param[in]  row     : Source row data.
+///
+static void __reduce_row(__reduce_ctx_t* ctx, unsigned y, const uint8_t* row)
+{
+  unsigned oy = y / ctx->d;
+  if(oy >= ctx->out_h)
+    return;
+
+  unsigned c = ctx->c;
+  unsigned n = MIN(ctx->out_w * ctx->d, ctx->src_w);
+
+  for(unsigned x = 0; x < n; ++x) {
+    uint32_t* ap = ctx->acc + ((x / ctx->d) * c);
+    const uint8_t* sp = row + (x * c);
+    for(unsigned k = 0; k < c; ++k)
+      ap[k] += sp[k];
+  }
+
+  // last row of box, write averaged output row
+  if((y % ctx->d) == (ctx->d - 1)) {
+
+    if(ctx->flip_y) oy = (ctx->out_h - 1) - oy;
+
+    uint32_t div = ctx->d * ctx->d;
+    uint32_t row_size = ctx->out_w * c;
+
+    uint8_t* dp = ctx->pixels + (oy * row_size);
+    for(uint32_t i = 0; i < row_size; ++i)
+      dp[i] = ctx->acc[i] / div;
+
+    memset(ctx->acc, 0, row_size * sizeof(uint32_t));
+  }
+}
+
+/// \brief Finalize row reduction
+///
+/// Frees row reduction context temporary data and converts output pixels to
+/// RGBA if needed.
+///
+/// \param[in]  ctx     : Row reduction context.
+/// \param[out] w       : Pointer that receive reduced image width.
+/// \param[out] h       : Pointer that receive reduced image height.
+///
+/// \return Pointer to reduced image RGBA pixels.
+///
+static uint8_t* __reduce_finish(__reduce_ctx_t* ctx, unsigned* w, unsigned* h)
+{
+  Om_free(ctx->acc);
+
+  // in-place conversion RGB to RGBA
+  if(ctx->c == 3)
+    __inplace_rgb_to_rgba(ctx->pixels, ctx->out_w * ctx->out_h, 0xFF);
+
+  (*w) = ctx->out_w;
+  (*h) = ctx->out_h;
+
+  return ctx->pixels;
+}
+
 /* we make sure structures are packed to be properly aligned with
  read buffer */
 #pragma pack(1)
@@ -1003,76 +1287,64 @@ struct __qz_map {
   __qz_rgb* node_list;
 };
 
-/// \brief Quantized color sorting function
-///
-/// Quantized color node sorting function along Red axis
+/// \brief Quantized map bounds
 ///
-static bool __qz_sort_r_fn(const __qz_rgb* a, const __qz_rgb* b)
-{
-  unsigned h1 = a->rgb[0] * 256 * 256 + a->rgb[1] * 256 + a->rgb[2];
-  unsigned h2 = b->rgb[0] * 256 * 256 + b->rgb[1] * 256 + b->rgb[2];
-  return (h1 < h2);
-}
-
-/// \brief Quantized color sorting function
+/// Computes the tight bounding box, in reduced 5 bits color space, of
+/// quantized colors contained in the given color map entry.
 ///
-/// Quantized color node sorting function along Green axis
+/// \param[in]  cmap      : Pointer to color map entry
 ///
-static bool __qz_sort_g_fn(const __qz_rgb* a, const __qz_rgb* b)
+static inline void __image_quantize_bounds(__qz_map* cmap)
 {
-  unsigned h1 = a->rgb[1] * 256 * 256 + a->rgb[2] * 256 + a->rgb[0];
-  unsigned h2 = b->rgb[1] * 256 * 256 + b->rgb[2] * 256 + b->rgb[0];
-  return (h1 < h2);
-}
+  uint8_t lo[3] = {31, 31, 31};
+  uint8_t hi[3] = { 0,  0,  0};
 
-/// \brief Quantized color sorting function
-///
-/// Quantized color node sorting function along Blue axis
-///
-static bool __qz_sort_b_fn(const __qz_rgb* a, const __qz_rgb* b)
-{
-  unsigned h1 = a->rgb[2] * 256 * 256 + a->rgb[0] * 256 + a->rgb[1];
-  unsigned h2 = b->rgb[2] * 256 * 256 + b->rgb[0] * 256 + b->rgb[1];
-  return (h1 < h2);
-}
+  for(__qz_rgb* node = cmap->node_list; node != nullptr; node = node->next) {
+    for(unsigned j = 0; j < 3; ++j) {
+      if(node->rgb[j] < lo[j]) lo[j] = node->rgb[j];
+      if(node->rgb[j] > hi[j]) hi[j] = node->rgb[j];
+    }
+  }
 
-/// \brief Quantized color sort functions array
-///
-/// Array containing pointers to quantized color sort functions
-///
-static bool (*__qz_sort_fn[])(const __qz_rgb*, const __qz_rgb*) = {
-  __qz_sort_r_fn,
-  __qz_sort_g_fn,
-  __qz_sort_b_fn
-  };
+  for(unsigned j = 0; j < 3; ++j) {
+    cmap->rgb_min[j] = (hi[j] >= lo[j]) ? lo[j] : 0;
+    cmap->rgb_rng[j] = (hi[j] >= lo[j]) ? hi[j] - lo[j] : 0;
+  }
+}
 
 /// \brief Quantization subdivision
 ///
 /// Color quantization function to subdivide the RGB space recursively
-/// using median cut in each axes alternatingly until ColorMapSize different
-/// cubes exists.
-/// The biggest cube in one dimension is subdivide unless it has only one entry.
+/// using median cut until ColorMapSize different cubes exists.
+/// The cube with the widest range in one dimension is subdivided along
+/// this dimension at the median of its pixels count.
+///
+/// Since quantized colors components are 5 bits values, the median is found
+/// using a 32 entries histogram along the split axis instead of sorting the
+/// cube colors, and the cube is partitioned in a single pass.
 ///
 /// \param[in]  cmap      : Pointer to color map to subdivide
 /// \param[in]  in_size   : Initial size of the supplied color map
 /// \param[in]  out_size  : New size of the subdivided color map
 ///
-/// the following implementation is a rewriting of the SubdivColorMap
+/// the following implementation is derived from the SubdivColorMap
 /// function from the quantize.c file of the GifLib library.
 ///
 static inline void __image_quantize_subdiv(__qz_map* cmap, unsigned* out_size, unsigned in_size)
 {
   __qz_rgb* node;
-  std::vector<__qz_rgb*> sort_list;
-  unsigned sort_axis, min_color, max_color, n, c, i, j, u = 0;
-  int rng_max, r;
+  unsigned sort_axis = 0, i, j, u = 0;
+  int rng_max;
 
   while(in_size > *out_size) {
-    // Find candidate for subdivision:
-    rng_max = -1;
+
+    // Find candidate for subdivision, a cube with more than one color
+    // always has a non-null range in at least one axis
+    rng_max = 0;
     for(i = 0; i < *out_size; ++i) {
+      if(cmap[i].size < 2) continue;
       for(j = 0; j < 3; ++j) {
-        if((static_cast<int>(cmap[i].rgb_rng[j]) > rng_max) && (cmap[i].size > 1)) {
+        if(static_cast<int>(cmap[i].rgb_rng[j]) > rng_max) {
           rng_max = cmap[i].rgb_rng[j];
           u = i;
           sort_axis = j;
@@ -1080,77 +1352,129 @@ static inline void __image_quantize_subdiv(__qz_map* cmap, unsigned* out_size, u
       }
     }
 
-    if(rng_max == -1)
+    if(rng_max == 0)
       return;
 
-    // Split the entry Index into two along the axis SortRGBAxis:
+    // Pixels count histogram along the split axis
+    uint32_t hist[32] = {0};
 
-    // Sort all elements in that entry along the given axis and split at
-    // the median.
-    sort_list.reserve(cmap[u].size);
+    for(node = cmap[u].node_list; node != nullptr; node = node->next)
+      hist[node->rgb[sort_axis]] += node->ref_count;
 
-    for(j = 0, node = cmap[u].node_list; j < cmap[u].size && node != nullptr; j++, node = node->next) {
-      sort_list.push_back(node);
-    }
+    // Find the split value, last value of the first half, it must let at
+    // least one color in the second half
+    unsigned s_lo = cmap[u].rgb_min[sort_axis];
+    unsigned s_hi = s_lo + cmap[u].rgb_rng[sort_axis];
+    unsigned split = s_lo;
+    uint32_t half = cmap[u].idx_count / 2, acc = 0;
 
-    // Because qsort isn't stable, this can produce differing
-    // results for the order of tuples depending on platform
-    // details of how qsort() is implemented.
-    //
-    // We mitigate this problem by sorting on all three axes rather
-    // than only the one specied by SortRGBAxis; that way the instability
-    // can only become an issue if there are multiple color indices
-    // referring to identical RGB tuples.  Older versions of this
-    // sorted on only the one axis.
-    sort(sort_list.begin(), sort_list.end(), __qz_sort_fn[sort_axis]);
-
-    for(j = 0; j < cmap[u].size - 1; ++j)
-      sort_list[j]->next = sort_list[j+1];
-
-    sort_list[cmap[u].size - 1]->next = nullptr;
-    cmap[u].node_list = node = sort_list[0];
-
-    sort_list.clear();
-
-    // Now simply add the Counts until we have half of the Count:
-    r = cmap[u].idx_count / 2 - node->ref_count;
-    n = 1;
-    c = node->ref_count;
-    while(node->next != nullptr && (r -= node->next->ref_count) >= 0 && node->next->next != nullptr) {
-      node = node->next;
-      n++;
-      c += node->ref_count;
+    for(split = s_lo; split < s_hi - 1; ++split) {
+      acc += hist[split];
+      if(acc >= half) break;
     }
-    // Save the values of the last color of the first half, and first
-    // of the second half so we can update the Bounding Boxes later.
-    // Also as the colors are quantized and the BBoxes are full 0..255,
-    // they need to be rescaled.
-    max_color = node->rgb[sort_axis]; //< Max. of first half
-    // coverity[var_deref_op]
-    min_color = node->next->rgb[sort_axis]; //< of second
-    max_color <<= 3;
-    min_color <<= 3;
-
-    // Partition right here:
-    cmap[*out_size].node_list = node->next;
-    node->next = nullptr;
-    cmap[*out_size].idx_count = c;
-    cmap[u].idx_count -= c;
-    cmap[*out_size].size = cmap[u].size - n;
-    cmap[u].size = n;
-    for(j = 0; j < 3; ++j) {
-      cmap[*out_size].rgb_min[j] = cmap[u].rgb_min[j];
-      cmap[*out_size].rgb_rng[j] = cmap[u].rgb_rng[j];
+
+    // Partition colors in two lists
+    __qz_rgb *a_head = nullptr, *a_tail = nullptr;
+    __qz_rgb *b_head = nullptr, *b_tail = nullptr;
+    unsigned a_size = 0, b_size = 0;
+    uint32_t a_count = 0, b_count = 0;
+
+    node = cmap[u].node_list;
+    while(node != nullptr) {
+
+      __qz_rgb* next = node->next;
+      node->next = nullptr;
+
+      if(node->rgb[sort_axis] <= split) {
+        if(a_tail) a_tail->next = node; else a_head = node;
+        a_tail = node; a_size++; a_count += node->ref_count;
+      } else {
+        if(b_tail) b_tail->next = node; else b_head = node;
+        b_tail = node; b_size++; b_count += node->ref_count;
+      }
+
+      node = next;
     }
-    cmap[*out_size].rgb_rng[sort_axis] = cmap[*out_size].rgb_min[sort_axis] + cmap[*out_size].rgb_rng[sort_axis] - min_color;
-    cmap[*out_size].rgb_min[sort_axis] = min_color;
 
-    cmap[u].rgb_rng[sort_axis] = max_color - cmap[u].rgb_min[sort_axis];
+    cmap[u].node_list = a_head;
+    cmap[u].size = a_size;
+    cmap[u].idx_count = a_count;
+    __image_quantize_bounds(&cmap[u]);
+
+    cmap[*out_size].node_list = b_head;
+    cmap[*out_size].size = b_size;
+    cmap[*out_size].idx_count = b_count;
+    __image_quantize_bounds(&cmap[*out_size]);
 
     (*out_size)++;
   }
 }
 
+/// \brief Quantization pixels per job
+///
+/// Count of pixels processed by each parallel quantization job.
+///
+#define QZ_JOB_PIXELS   65536
+
+/// \brief Quantization context
+///
+/// Structure shared by workers during color quantization passes
+///
+typedef struct {
+
+  const uint8_t*      in_rgb;
+
+  unsigned            in_c;
+
+  uint32_t            count;
+
+  uint32_t*           hist;
+
+  const __qz_rgb*     node_list;
+
+  uint8_t*            out_idx;
+
+} __qz_ctx_t;
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __image_quantize_hist_fn(void* ptr, size_t index, unsigned worker)
+{
+  __qz_ctx_t* ctx = static_cast<__qz_ctx_t*>(ptr);
+
+  // each worker has its own histogram
+  uint32_t* hist = ctx->hist + (worker * 32768);
+
+  uint32_t i = index * QZ_JOB_PIXELS;
+  uint32_t e = MIN(i + QZ_JOB_PIXELS, ctx->count);
+
+  const uint8_t* sp = ctx->in_rgb + (i * ctx->in_c);
+  for(; i < e; ++i, sp += ctx->in_c)
+    hist[((sp[0] >> 3) << 10) + ((sp[1] >> 3) << 5) + (sp[2] >> 3)]++;
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __image_quantize_map_fn(void* ptr, size_t index, unsigned worker)
+{
+  OM_UNUSED(worker);
+
+  __qz_ctx_t* ctx = static_cast<__qz_ctx_t*>(ptr);
+
+  uint32_t i = index * QZ_JOB_PIXELS;
+  uint32_t e = MIN(i + QZ_JOB_PIXELS, ctx->count);
+
+  const uint8_t* sp = ctx->in_rgb + (i * ctx->in_c);
+  for(; i < e; ++i, sp += ctx->in_c)
+    ctx->out_idx[i] = ctx->node_list[((sp[0] >> 3) << 10) + ((sp[1] >> 3) << 5) + (sp[2] >> 3)].pos;
+
+  return true;
+}
+
 /// \brief Color quantization
 ///
 /// Function to Quantize high resolution image into lower one. Input image
@@ -1189,6 +1513,8 @@ static bool __image_quantize(uint8_t* out_idx, uint8_t* out_map, unsigned* map_s
 
   uint32_t mtx_bytes = in_w * in_h;
 
+  if(!mtx_bytes) return false;
+
   node_list = reinterpret_cast<__qz_rgb*>(Om_alloc(sizeof(__qz_rgb) * 32768));
   if(!node_list) return false;
 
@@ -1199,12 +1525,36 @@ static bool __image_quantize(uint8_t* out_idx, uint8_t* out_map, unsigned* map_s
     node_list[i].ref_count = 0;
   }
 
-  // Sample the colors and their distribution:
-  for(i = 0, sp = in_rgb; i < mtx_bytes; ++i, sp += in_c) {
-    u = ((sp[0] >> 3) << 10) + ((sp[1] >> 3) << 5) + (sp[2] >> 3);
-    node_list[u].ref_count++;
+  // Sample the colors and their distribution, large images are processed
+  // by several workers, each with its own histogram
+  __qz_ctx_t ctx;
+  ctx.in_rgb = in_rgb;
+  ctx.in_c = in_c;
+  ctx.count = mtx_bytes;
+  ctx.node_list = node_list;
+  ctx.out_idx = out_idx;
+
+  size_t jobs = (mtx_bytes + QZ_JOB_PIXELS - 1) / QZ_JOB_PIXELS;
+  unsigned workers = Om_workerCount(jobs);
+
+  ctx.hist = reinterpret_cast<uint32_t*>(Om_alloc(sizeof(uint32_t) * 32768 * workers));
+  if(!ctx.hist) {
+    Om_free(node_list);
+    return false;
   }
 
+  memset(ctx.hist, 0, sizeof(uint32_t) * 32768 * workers);
+
+  Om_parallelFor(jobs, __image_quantize_hist_fn, &ctx, workers);
+
+  for(unsigned w = 0; w < workers; ++w) {
+    uint32_t* hist = ctx.hist + (w * 32768);
+    for(i = 0; i < 32768; ++i)
+      node_list[i].ref_count += hist[i];
+  }
+
+  Om_free(ctx.hist);
+
   /* Put all the colors in the first entry of the color map, and call the
    * recursive subdivision process.  */
   for(i = 0; i < 256; i++) {
@@ -1235,6 +1585,7 @@ static bool __image_quantize(uint8_t* out_idx, uint8_t* out_map, unsigned* map_s
 
   new_cmap[0].size = n;               //< Different sampled colors
   new_cmap[0].idx_count = mtx_bytes;   //< Pixels
+  __image_quantize_bounds(&new_cmap[0]);
 
   unsigned new_size = 1;
 
@@ -1245,32 +1596,53 @@ static bool __image_quantize(uint8_t* out_idx, uint8_t* out_map, unsigned* map_s
     memset(out_map + (new_size * 3), 0, ((*map_size) - new_size) * 3);
   }
 
-  // Average the colors in each entry to be the color to be used in the
-  // output color map, and plug it into the output color map itself.
-  unsigned r, g, b;
+  // Average the colors in each entry, weighted by pixels count, to be the
+  // color to be used in the output color map, and plug it into the output
+  // color map itself.
+  uint64_t r, g, b;
   for(i = 0, dp = out_map; i < new_size; ++i, dp += 3) {
-    if((j = new_cmap[i].size) > 0) {
+    if(new_cmap[i].size > 0 && new_cmap[i].idx_count > 0) {
       node = new_cmap[i].node_list;
       r = g = b = 0;
       while(node) {
-        node->pos = i;
-        r += node->rgb[0];
-        g += node->rgb[1];
-        b += node->rgb[2];
+        r += ((node->rgb[0] << 3) + 4) * static_cast<uint64_t>(node->ref_count);
+        g += ((node->rgb[1] << 3) + 4) * static_cast<uint64_t>(node->ref_count);
+        b += ((node->rgb[2] << 3) + 4) * static_cast<uint64_t>(node->ref_count);
         node = node->next;
       }
-      dp[0] = (r << 3) / j;
-      dp[1] = (g << 3) / j;
-      dp[2] = (b << 3) / j;
+      dp[0] = r / new_cmap[i].idx_count;
+      dp[1] = g / new_cmap[i].idx_count;
+      dp[2] = b / new_cmap[i].idx_count;
+    }
+  }
+
+  // Build the lookup table of used colors to their nearest color in the
+  // output color map, this is the same as the entry they belong to in most
+  // cases, but not near entries boundaries.
+  for(i = 0; i < 32768; ++i) {
+
+    if(node_list[i].ref_count == 0)
+      continue;
+
+    int32_t cr = (node_list[i].rgb[0] << 3) + 4;
+    int32_t cg = (node_list[i].rgb[1] << 3) + 4;
+    int32_t cb = (node_list[i].rgb[2] << 3) + 4;
+
+    int32_t d_min = 0x7FFFFFFF;
+
+    for(j = 0, dp = out_map; j < new_size; ++j, dp += 3) {
+      int32_t dr = cr - dp[0], dg = cg - dp[1], db = cb - dp[2];
+      int32_t d = (dr * dr) + (dg * dg) + (db * db);
+      if(d < d_min) {
+        d_min = d;
+        node_list[i].pos = j;
+      }
     }
   }
 
   // Finally scan the input buffer again and put the mapped index in the
   // output buffer.
-  for(i = 0, sp = in_rgb; i < mtx_bytes; ++i, sp += in_c) {
-    u = ((sp[0] >> 3) << 10) + ((sp[1] >> 3) <<  5) + (sp[2] >> 3);
-    out_idx[i] = node_list[u].pos;
-  }
+  Om_parallelFor(jobs, __image_quantize_map_fn, &ctx, workers);
 
   Om_free(node_list);
 
@@ -1378,10 +1750,12 @@ static int __gif_write_buff_fn(GifFileType* gif, const uint8_t* src, int len)
 /// \param[out] h         : Pointer that receive decoded image height.
 /// \param[in]  gif       : GIF decoder structure pointer.
 /// \param[in]  flip_y    : Load image for bottom-left origin usage (upside down)
+/// \param[in]  span      : Thumbnail span to reduce image for, or 0 for full resolution.
+/// \param[in]  mode      : Thumbnail resize mode.
 ///
 /// \return Pointer to decoded image RGBA pixels or nullptr if failed.
 ///
-static uint8_t* __gif_decode_common(unsigned* w, unsigned* h, GifFileType* gif, bool flip_y)
+static uint8_t* __gif_decode_common(unsigned* w, unsigned* h, GifFileType* gif, bool flip_y, unsigned span = 0, OmSizeMode mode = OM_SIZE_FIT)
 {
   #ifdef DEBUG
   clock_t t = clock();
@@ -1417,6 +1791,42 @@ static uint8_t* __gif_decode_common(unsigned* w, unsigned* h, GifFileType* gif,
   uint32_t row_bytes = gif_w * 4;
   uint32_t tot_bytes = gif_h * row_bytes;
 
+  // for thumbnail, image is reduced while translating indexed colors
+  unsigned d = __thumb_reduce_factor(gif_w, gif_h, span, mode);
+
+  if(d > 1) {
+
+    __reduce_ctx_t reduce;
+
+    uint8_t* row = reinterpret_cast<uint8_t*>(Om_alloc(row_bytes));
+
+    if(!row || !__reduce_init(&reduce, gif_w, gif_h, 4, d, flip_y)) {
+      Om_free(row);
+      DGifCloseFile(gif, &error);
+      return nullptr;
+    }
+
+    const uint8_t* sp = static_cast<uint8_t*>(images[0].RasterBits);
+
+    for(unsigned y = 0; y < gif_h; ++y) {
+      uint8_t* dp = row;
+      for(unsigned x = 0; x < gif_w; ++x, ++sp, dp += 4) {
+        dp[0] = table->Colors[*sp].Red;
+        dp[1] = table->Colors[*sp].Green;
+        dp[2] = table->Colors[*sp].Blue;
+        dp[3] = 0xFF;
+      }
+      __reduce_row(&reduce, y, row);
+    }
+
+    Om_free(row);
+
+    // free decoder
+    DGifCloseFile(gif, &error);
+
+    return __reduce_finish(&reduce, w, h);
+  }
+
   // allocate new buffer
   uint8_t* pixels = reinterpret_cast<uint8_t*>(Om_alloc(tot_bytes));
   if(!pixels) {
@@ -1594,10 +2004,12 @@ static uint8_t* __gif_read(unsigned* w, unsigned* h, FILE* gif_file, bool flip_y
 /// \param[out] h         : Pointer that receive decoded image height.
 /// \param[in]  gif_data  : Buffer to GIF data to decode.
 /// \param[in]  flip_y    : Load image for bottom-left origin usage (upside down)
+/// \param[in]  span      : Thumbnail span to reduce image for, or 0 for full resolution.
+/// \param[in]  mode      : Thumbnail resize mode.
 ///
 /// \return Pointer to decoded image RGBA pixels or nullptr if failed.
 ///
-static uint8_t* __gif_decode(unsigned* w, unsigned* h, const uint8_t* gif_data, bool flip_y)
+static uint8_t* __gif_decode(unsigned* w, unsigned* h, const uint8_t* gif_data, bool flip_y, unsigned span = 0, OmSizeMode mode = OM_SIZE_FIT)
 {
   int error;
   GifFileType* gif;
@@ -1613,7 +2025,7 @@ static uint8_t* __gif_decode(unsigned* w, unsigned* h, const uint8_t* gif_data,
     return nullptr;
 
   // Decode GIF data
-  return __gif_decode_common(w, h, gif, flip_y);
+  return __gif_decode_common(w, h, gif, flip_y, span, mode);
 }
 
 /// \brief Write GIF file.
@@ -2260,10 +2672,12 @@ static uint8_t* __bmp_encode(uint64_t* out_size, const uint8_t* in_rgb, unsigned
 /// \param[out] h         : Pointer that receive decoded image height.
 /// \param[in]  jpg_dec   : JPEG decoder structure pointer.
 /// \param[in]  flip_y    : Load image for bottom-left origin usage (upside down)
+/// \param[in]  span      : Thumbnail span to reduce image for, or 0 for full resolution.
+/// \param[in]  mode      : Thumbnail resize mode.
 ///
 /// \return Pointer to decoded RGBA image pixels or nullptr if failed.
 ///
-static uint8_t* __jpg_decode_common(unsigned* w, unsigned* h, void* jpg_dec, bool flip_y)
+static uint8_t* __jpg_decode_common(unsigned* w, unsigned* h, void* jpg_dec, bool flip_y, unsigned span = 0, OmSizeMode mode = OM_SIZE_FIT)
 {
   #ifdef DEBUG
   clock_t t = clock();
@@ -2275,6 +2689,17 @@ static uint8_t* __jpg_decode_common(unsigned* w, unsigned* h, void* jpg_dec, boo
   if(jpeg_read_header(jpg, true) != 1)
     return nullptr;
 
+  // for thumbnail, let decoder scale down image in DCT domain, this
+  // avoid most of the IDCT and color conversion work
+  unsigned d = __thumb_reduce_factor(jpg->image_width, jpg->image_height, span, mode);
+
+  if(d > 1) {
+    jpg->scale_num = 1;
+    jpg->scale_denom = d;
+    jpg->dct_method = JDCT_IFAST;
+    jpg->do_fancy_upsampling = FALSE;
+  }
+
   // initialize decompression
   jpeg_start_decompress(jpg);
 
@@ -2462,10 +2887,12 @@ static uint8_t* __jpg_read(unsigned* w, unsigned* h, FILE* jpg_file, bool flip_y
 /// \param[in]  jpg_data  : Buffer to JPEG data to decode.
 /// \param[in]  jpg_size  : Size of JPEG data to decode.
 /// \param[in]  flip_y    : Load image for bottom-left origin usage (upside down)
+/// \param[in]  span      : Thumbnail span to reduce image for, or 0 for full resolution.
+/// \param[in]  mode      : Thumbnail resize mode.
 ///
 /// \return Pointer to decoded image RGBA pixels or nullptr if failed.
 ///
-static uint8_t* __jpg_decode(unsigned* w, unsigned* h, const uint8_t* jpg_data, size_t jpg_size, bool flip_y)
+static uint8_t* __jpg_decode(unsigned* w, unsigned* h, const uint8_t* jpg_data, size_t jpg_size, bool flip_y, unsigned span = 0, OmSizeMode mode = OM_SIZE_FIT)
 {
   // create base object for jpeg decoder
   jpeg_decompress_struct jpg;
@@ -2478,7 +2905,7 @@ static uint8_t* __jpg_decode(unsigned* w, unsigned* h, const uint8_t* jpg_data,
   // set read data pointer
   jpeg_mem_src(&jpg, jpg_data, jpg_size);
 
-  return __jpg_decode_common(w, h, &jpg, flip_y);
+  return __jpg_decode_common(w, h, &jpg, flip_y, span, mode);
 }
 
 /// \brief Write JPEG file.
@@ -2558,10 +2985,12 @@ static uint8_t* __jpg_encode(uint64_t* out_size, const uint8_t* in_rgb, unsigned
 /// \param[out] h         : Pointer that receive decoded image height.
 /// \param[in]  png       : PNG decoder structure pointer.
 /// \param[in]  flip_y    : Load image for bottom-left origin usage (upside down)
+/// \param[in]  span      : Thumbnail span to reduce image for, or 0 for full resolution.
+/// \param[in]  mode      : Thumbnail resize mode.
 ///
 /// \return Pointer to decoded image RGBA pixels or nullptr if failed.
 ///
-static uint8_t* __png_decode_common(unsigned* w, unsigned* h, png_structp png, bool flip_y)
+static uint8_t* __png_decode_common(unsigned* w, unsigned* h, png_structp png, bool flip_y, unsigned span = 0, OmSizeMode mode = OM_SIZE_FIT)
 {
   #ifdef DEBUG
   clock_t t = clock();
@@ -2586,6 +3015,35 @@ static uint8_t* __png_decode_common(unsigned* w, unsigned* h, png_structp png, b
   // retrieve and define useful sizes
   size_t row_bytes = png_w * png_c;
 
+  // for thumbnail, image is reduced while rows are decoded, this is not
+  // possible with interlaced image since rows are decoded in several passes
+  unsigned d = __thumb_reduce_factor(png_w, png_h, span, mode);
+
+  if(d > 1 && png_get_interlace_type(png, png_info) == PNG_INTERLACE_NONE) {
+
+    __reduce_ctx_t reduce;
+
+    uint8_t* row = reinterpret_cast<uint8_t*>(Om_alloc(row_bytes));
+
+    if(!row || !__reduce_init(&reduce, png_w, png_h, png_c, d, flip_y)) {
+      Om_free(row);
+      png_destroy_read_struct(&png, &png_info, nullptr);
+      return nullptr;
+    }
+
+    for(unsigned y = 0; y < png_h; ++y) {
+      png_read_row(png, row, nullptr);
+      __reduce_row(&reduce, y, row);
+    }
+
+    Om_free(row);
+
+    // cleanup
+    png_destroy_read_struct(&png, &png_info, nullptr);
+
+    return __reduce_finish(&reduce, w, h);
+  }
+
   // allocate buffer, large enough to store **RGBA** data
   uint8_t* pixels = reinterpret_cast<uint8_t*>(Om_alloc(png_w * png_h * 4));
   if(!pixels) return nullptr;
@@ -2740,10 +3198,12 @@ void __png_read_buff_fn(png_structp png, uint8_t* dst, size_t len)
 /// \param[out] h         : Pointer that receive decoded image height.
 /// \param[in]  png_data  : Buffer to read PNG data from.
 /// \param[in]  flip_y    : Load image for bottom-left origin usage (upside down)
+/// \param[in]  span      : Thumbnail span to reduce image for, or 0 for full resolution.
+/// \param[in]  mode      : Thumbnail resize mode.
 ///
 /// \return Pointer to decoded image RGB(A) data or nullptr if failed.
 ///
-static uint8_t* __png_decode(unsigned* w, unsigned* h, const uint8_t* png_data, bool flip_y)
+static uint8_t* __png_decode(unsigned* w, unsigned* h, const uint8_t* png_data, bool flip_y, unsigned span = 0, OmSizeMode mode = OM_SIZE_FIT)
 {
 
   // create PNG decoder structure
@@ -2758,7 +3218,7 @@ static uint8_t* __png_decode(unsigned* w, unsigned* h, const uint8_t* png_data,
   png_set_read_fn(png, &read_st, __png_read_buff_fn);
 
   // decode PNG data
-  return __png_decode_common(w, h, png, flip_y);
+  return __png_decode_common(w, h, png, flip_y, span, mode);
 }
 
 /// \brief Write PNG file.
@@ -3358,7 +3818,7 @@ uint8_t* Om_imgMakeThumb(unsigned span, OmSizeMode mode, const uint8_t* src_pix,
       uint8_t* dp;
 
       for(unsigned y = 0; y < span; ++y) {
-        sp = src_pix + ((y + rec_y) * row_bytes) + row_shift;
+        sp = src_pix + ((y + rec_y) * src_w * 4) + row_shift;
         dp = thumb + (y * row_bytes);
         for(unsigned x = 0; x < span; ++x, dp += 4, sp += 4) {
           __cpy_pixel_32(dp, sp);
@@ -3381,6 +3841,54 @@ uint8_t* Om_imgMakeThumb(unsigned span, OmSizeMode mode, const uint8_t* src_pix,
   return thumb;
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint8_t* Om_imgLoadThumb(unsigned span, OmSizeMode mode, const uint8_t* in_data, uint64_t in_size)
+{
+  #ifdef DEBUG
+  clock_t t = clock();
+  #endif // DEBUG
+
+  // prevent idiot attempts
+  if(!span || !in_data || !in_size)
+    return nullptr;
+
+  unsigned w = 0, h = 0;
+  uint8_t* pix = nullptr;
+
+  // decode image at the lowest resolution that is still sufficient
+  // for the thumbnail, when image format allows it
+  switch(__image_sign_matches(in_data))
+  {
+  case OM_IMAGE_BMP:
+    pix = __bmp_decode(&w, &h, in_data, false);
+    break;
+  case OM_IMAGE_JPG:
+    pix = __jpg_decode(&w, &h, in_data, in_size, false, span, mode);
+    break;
+  case OM_IMAGE_PNG:
+    pix = __png_decode(&w, &h, in_data, false, span, mode);
+    break;
+  case OM_IMAGE_GIF:
+    pix = __gif_decode(&w, &h, in_data, false, span, mode);
+    break;
+  }
+
+  if(!pix)
+    return nullptr;
+
+  uint8_t* thumb = Om_imgMakeThumb(span, mode, pix, w, h);
+
+  Om_free(pix);
+
+  #ifdef DEBUG
+  t = clock() - t;
+  std::cout << "DEBUG => Om_imgLoadThumb : " << 1000.0 * ((double)t / CLOCKS_PER_SEC) << " ms\n";
+  #endif // DEBUG
+
+  return thumb;
+}
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
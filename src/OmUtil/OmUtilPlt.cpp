@@ -0,0 +1,2046 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
+
+#ifdef _WIN32
+  #include "OmBaseWin.h"      //< WinAPI
+  #include "OmUtilWin.h"      //< Om_getErrorStr
+  #include <shlwapi.h>        //< PathIsNetworkPathW
+  #include <shellapi.h>       //< SHFileOperationW
+#else
+  #include <unistd.h>         //< read, write, close, pipe, usleep, sysconf
+  #include <fcntl.h>          //< open, fcntl
+  #include <poll.h>           //< poll
+  #include <pthread.h>        //< pthread_*
+  #include <dirent.h>         //< opendir, readdir
+  #include <sys/stat.h>       //< stat, fstat
+  #include <sys/file.h>       //< flock
+  #include <cstdlib>          //< getenv, realpath
+  #include <ctime>            //< clock_gettime
+  #include <cerrno>
+  #ifdef __linux__
+    #include <sys/syscall.h>  //< SYS_gettid
+    #include <sys/inotify.h>  //< inotify_*
+    #include <sys/vfs.h>      //< statfs
+  #endif
+#endif
+
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmUtilPlt.h"
+
+/// \brief Directory watch buffer size
+///
+/// Size in bytes of buffer receiving directory changes from system.
+///
+#define WATCH_BUFFER_SIZE   512000
+
+/// \brief File copy buffer size
+///
+/// Size in bytes of buffer used to copy file data.
+///
+#define COPY_BUFFER_SIZE    524288
+
+/// \brief Thread start parameters
+///
+/// Structure passed to thread trampoline function.
+///
+typedef struct {
+
+  Om_pltThreadFn    thread_fn;
+
+  void*             user_ptr;
+
+  #ifndef _WIN32
+  pthread_t         thread;
+
+  pthread_mutex_t   mutex;
+
+  pthread_cond_t    cond;
+
+  Om_pltThreadEndFn end_fn;
+
+  void*             end_ptr;
+
+  unsigned          refs;     //< references held by thread and handle owner
+
+  bool              returned; //< thread function returned
+
+  bool              ended;
+
+  bool              detached;
+  #endif
+
+} __thread_t;
+
+#ifdef _WIN32
+
+/// \brief Thread trampoline
+///
+/// System thread function which calls the user thread function.
+///
+/// \param[in]  ptr     : Pointer to thread start parameters.
+///
+/// \return Thread function result.
+///
+static DWORD WINAPI __thread_run_fn(void* ptr)
+{
+  __thread_t* th = static_cast<__thread_t*>(ptr);
+
+  Om_pltThreadFn thread_fn = th->thread_fn;
+  void* user_ptr = th->user_ptr;
+
+  delete th;
+
+  return thread_fn(user_ptr);
+}
+
+/// \brief Thread wait handle
+///
+/// Structure holding registered wait for thread end.
+///
+typedef struct {
+
+  HANDLE            hwait;
+
+  Om_pltThreadEndFn end_fn;
+
+  void*             user_ptr;
+
+} __thread_wait_t;
+
+/// \brief Thread end callback
+///
+/// System wait callback which calls the user thread end function.
+///
+/// \param[in]  ptr     : Pointer to thread wait handle.
+/// \param[in]  fired   : Wait timed out.
+///
+static VOID CALLBACK __thread_end_fn(void* ptr, BOOLEAN fired)
+{
+  __thread_wait_t* wait = static_cast<__thread_wait_t*>(ptr);
+
+  // wait handle may be released by end function
+  wait->end_fn(wait->user_ptr, fired);
+}
+
+/// \brief Directory enumeration handle
+///
+/// Structure holding directory enumeration state.
+///
+typedef struct {
+
+  HANDLE            hfind;
+
+  WIN32_FIND_DATAW  fd;
+
+  bool              first;
+
+} __dir_t;
+
+/// \brief Directory watch handle
+///
+/// Structure holding directory watch state.
+///
+typedef struct {
+
+  HANDLE            hdir;
+
+  OVERLAPPED        ov;
+
+  uint8_t*          buf;
+
+} __watch_t;
+
+/// \brief Request directory changes
+///
+/// Issues asynchronous request for changes in watched directory.
+///
+/// \param[in]  watch   : Pointer to directory watch.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static inline bool __watch_read(__watch_t* watch)
+{
+  DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME|FILE_NOTIFY_CHANGE_DIR_NAME|FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+  return ReadDirectoryChangesW(watch->hdir, watch->buf, WATCH_BUFFER_SIZE, true, filter, nullptr, &watch->ov, nullptr);
+}
+
+#else
+
+/// \brief Release thread
+///
+/// Releases a thread reference, thread parameters are deleted once
+/// both thread and handle owner released them.
+///
+/// \param[in]  th      : Pointer to thread parameters.
+///
+static void __thread_release(__thread_t* th)
+{
+  pthread_mutex_lock(&th->mutex);
+  unsigned refs = --th->refs;
+  pthread_mutex_unlock(&th->mutex);
+
+  if(refs)
+    return;
+
+  pthread_cond_destroy(&th->cond);
+  pthread_mutex_destroy(&th->mutex);
+
+  delete th;
+}
+
+
+/// \brief Thread trampoline
+///
+/// System thread function which calls the user thread function.
+///
+/// \param[in]  ptr     : Pointer to thread start parameters.
+///
+/// \return Thread function result.
+///
+static void* __thread_run_fn(void* ptr)
+{
+  __thread_t* th = static_cast<__thread_t*>(ptr);
+
+  uint32_t result = th->thread_fn(th->user_ptr);
+
+  pthread_mutex_lock(&th->mutex);
+  Om_pltThreadEndFn end_fn = th->end_fn;
+  th->returned = true;
+  pthread_mutex_unlock(&th->mutex);
+
+  // end function is called before thread is seen as ended, so a wait
+  // for thread end also waits for end function
+  if(end_fn)
+    end_fn(th->end_ptr, 0);
+
+  pthread_mutex_lock(&th->mutex);
+  th->ended = true;
+  pthread_cond_broadcast(&th->cond);
+  pthread_mutex_unlock(&th->mutex);
+
+  __thread_release(th);
+
+  return reinterpret_cast<void*>(static_cast<uintptr_t>(result));
+}
+
+/// \brief Event object
+///
+/// Event emulated using a pipe, so it can be polled along with other
+/// file descriptors. The pipe holds one byte while event is signaled.
+///
+typedef struct {
+
+  pthread_mutex_t   mutex;
+
+  int               fd[2];
+
+  bool              manual;
+
+  bool              signaled;
+
+} __event_t;
+
+/// \brief Directory enumeration handle
+///
+/// Structure holding directory enumeration state.
+///
+typedef struct {
+
+  DIR*              dir;
+
+} __dir_t;
+
+/// \brief Directory watch handle
+///
+/// Structure holding directory watch state.
+///
+typedef struct {
+
+  int               ifd;
+
+  OmCString         root;
+
+  std::map<int, OmWString> wd_path;   //< watched directories relative path
+
+  uint8_t*          buf;
+
+} __watch_t;
+
+/// \brief Get native path
+///
+/// Converts path to UTF-8 with slash separators.
+///
+/// \param[in]  path    : Path to convert.
+///
+/// \return Native path.
+///
+static OmCString __native_path(const OmWString& path)
+{
+  OmCString result;
+  result.reserve(path.size());
+
+  for(size_t i = 0; i < path.size(); ++i) {
+
+    uint32_t c = static_cast<uint32_t>(path[i]);
+
+    if(c == L'\\') {
+      result.push_back('/');
+    } else if(c < 0x80) {
+      result.push_back(c);
+    } else if(c < 0x800) {
+      result.push_back(0xC0 | (c >> 6));
+      result.push_back(0x80 | (c & 0x3F));
+    } else if(c < 0x10000) {
+      result.push_back(0xE0 | (c >> 12));
+      result.push_back(0x80 | ((c >> 6) & 0x3F));
+      result.push_back(0x80 | (c & 0x3F));
+    } else {
+      result.push_back(0xF0 | (c >> 18));
+      result.push_back(0x80 | ((c >> 12) & 0x3F));
+      result.push_back(0x80 | ((c >> 6) & 0x3F));
+      result.push_back(0x80 | (c & 0x3F));
+    }
+  }
+
+  return result;
+}
+
+/// \brief Get wide name
+///
+/// Converts UTF-8 item name to wide string, invalid bytes are kept as is.
+///
+/// \param[out] name    : Pointer to string that receive name.
+/// \param[in]  str     : UTF-8 name to convert.
+///
+static void __wide_name(OmWString* name, const char* str)
+{
+  name->clear();
+
+  const uint8_t* s = reinterpret_cast<const uint8_t*>(str);
+
+  while(*s) {
+
+    uint32_t c = *s;
+    size_t n = 0;
+
+    if(c >= 0xF0 && c < 0xF8) {
+      c &= 0x07; n = 3;
+    } else if(c >= 0xE0) {
+      c &= 0x0F; n = 2;
+    } else if(c >= 0xC0) {
+      c &= 0x1F; n = 1;
+    }
+
+    size_t i;
+    for(i = 1; i <= n; ++i) {
+      if((s[i] & 0xC0) != 0x80) break;
+      c = (c << 6) | (s[i] & 0x3F);
+    }
+
+    // malformed sequence, keep the lead byte alone
+    if(i <= n) {
+      c = *s; n = 0;
+    }
+
+    name->push_back(static_cast<wchar_t>(c));
+    s += n + 1;
+  }
+}
+
+/// \brief Get file descriptor
+///
+/// Returns file descriptor from file handle, handles are file descriptor
+/// plus one so the value zero is never a valid handle.
+///
+/// \param[in]  hfile   : File handle.
+///
+/// \return File descriptor.
+///
+static inline int __handle_fd(void* hfile)
+{
+  return static_cast<int>(reinterpret_cast<intptr_t>(hfile) - 1);
+}
+
+/// \brief Get poll timeout
+///
+/// Converts timeout to poll function timeout.
+///
+/// \param[in]  timeout : Timeout in milliseconds or OM_PLT_INFINITE.
+///
+/// \return Poll timeout.
+///
+static inline int __poll_timeout(uint32_t timeout)
+{
+  if(timeout == OM_PLT_INFINITE)
+    return -1;
+
+  return (timeout > 0x7FFFFFFF) ? 0x7FFFFFFF : static_cast<int>(timeout);
+}
+
+/// \brief Consume event
+///
+/// Checks whether event is signaled and reset it if this is an
+/// automatic reset event.
+///
+/// \param[in]  ev      : Pointer to event.
+///
+/// \return True if event was signaled, false otherwise.
+///
+static bool __event_take(__event_t* ev)
+{
+  pthread_mutex_lock(&ev->mutex);
+
+  bool signaled = ev->signaled;
+
+  if(signaled && !ev->manual) {
+    char b; ssize_t r = read(ev->fd[0], &b, 1); OM_UNUSED(r);
+    ev->signaled = false;
+  }
+
+  pthread_mutex_unlock(&ev->mutex);
+
+  return signaled;
+}
+
+/// \brief Get error message
+///
+/// Returns message from XSI variant of strerror_r result.
+///
+/// \param[in]  result  : Function result.
+/// \param[in]  buf     : Buffer passed to function.
+///
+/// \return Error message.
+///
+static inline const char* __strerror_msg(int result, const char* buf)
+{
+  return (result == 0) ? buf : "";
+}
+
+/// \brief Get error message
+///
+/// Returns message from GNU variant of strerror_r result.
+///
+/// \param[in]  result  : Function result.
+/// \param[in]  buf     : Buffer passed to function.
+///
+/// \return Error message.
+///
+static inline const char* __strerror_msg(const char* result, const char* buf)
+{
+  OM_UNUSED(buf);
+
+  return result;
+}
+
+/// \brief Create directory tree
+///
+/// Creates all missing directories of the specified native path.
+///
+/// \param[in]  path    : Native directory path.
+///
+/// \return Zero if operation succeed, error number otherwise.
+///
+static int __native_mkdirs(const OmCString& path)
+{
+  for(size_t i = 1; i <= path.size(); ++i) {
+
+    if(i < path.size() && path[i] != '/')
+      continue;
+
+    if(0 != mkdir(path.substr(0, i).c_str(), 0700) && errno != EEXIST)
+      return errno;
+  }
+
+  return 0;
+}
+
+/// \brief Copy native file
+///
+/// Copies file data, permissions and times between native paths.
+///
+/// \param[in]  src     : Native source path.
+/// \param[in]  dst     : Native destination path.
+///
+/// \return Zero if operation succeed, error number otherwise.
+///
+static int __native_copy(const OmCString& src, const OmCString& dst)
+{
+  int fsrc = open(src.c_str(), O_RDONLY|O_CLOEXEC);
+  if(fsrc < 0)
+    return errno;
+
+  struct stat st;
+  if(0 != fstat(fsrc, &st)) {
+    int result = errno;
+    close(fsrc);
+    return result;
+  }
+
+  int fdst = open(dst.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, st.st_mode & 07777);
+  if(fdst < 0) {
+    int result = errno;
+    close(fsrc);
+    return result;
+  }
+
+  int result = 0;
+
+  uint8_t* buf = new uint8_t[COPY_BUFFER_SIZE];
+
+  while(true) {
+
+    ssize_t rb = read(fsrc, buf, COPY_BUFFER_SIZE);
+    if(rb < 0) {
+      if(errno == EINTR) continue;
+      result = errno; break;
+    }
+
+    if(rb == 0) //< end of file
+      break;
+
+    if(Om_pltFileWrite(reinterpret_cast<void*>(static_cast<intptr_t>(fdst) + 1), buf, rb) < 0) {
+      result = errno; break;
+    }
+  }
+
+  delete [] buf;
+
+  if(result == 0) {
+    // same as Windows copy, destination gets source attributes and time
+    fchmod(fdst, st.st_mode & 07777);
+    struct timespec times[2] = {st.st_atim, st.st_mtim};
+    futimens(fdst, times);
+  }
+
+  close(fsrc);
+
+  if(0 != close(fdst) && result == 0)
+    result = errno;
+
+  return result;
+}
+
+#ifdef __linux__
+
+/// \brief Add directory watch
+///
+/// Adds watch for the specified directory and, recursively, its
+/// sub-directories.
+///
+/// \param[in]  watch   : Pointer to directory watch.
+/// \param[in]  from    : Directory path relative to watched root.
+///
+static void __watch_add(__watch_t* watch, const OmWString& from)
+{
+  OmCString path = watch->root;
+  if(!from.empty()) {
+    path.push_back('/');
+    path.append(__native_path(from));
+  }
+
+  uint32_t mask = IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO|IN_MODIFY|IN_ONLYDIR;
+
+  int wd = inotify_add_watch(watch->ifd, path.c_str(), mask);
+  if(wd < 0)
+    return;
+
+  watch->wd_path[wd] = from;
+
+  // watch sub-directories as well
+  DIR* dir = opendir(path.c_str());
+  if(!dir)
+    return;
+
+  OmWString name, sub;
+
+  struct dirent* de;
+  while((de = readdir(dir)) != nullptr) {
+
+    if(de->d_name[0] == '.' && (de->d_name[1] == 0 || (de->d_name[1] == '.' && de->d_name[2] == 0)))
+      continue;
+
+    bool isdir = (de->d_type == DT_DIR);
+
+    if(de->d_type == DT_UNKNOWN) {
+      struct stat st;
+      if(0 == fstatat(dirfd(dir), de->d_name, &st, AT_SYMLINK_NOFOLLOW))
+        isdir = S_ISDIR(st.st_mode);
+    }
+
+    if(!isdir)
+      continue;
+
+    __wide_name(&name, de->d_name);
+
+    if(from.empty()) {
+      sub = name;
+    } else {
+      sub = from; sub += L"\\"; sub += name;
+    }
+
+    __watch_add(watch, sub);
+  }
+
+  closedir(dir);
+}
+
+#endif // __linux__
+
+#endif // _WIN32
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString Om_pltErrorStr(int32_t code)
+{
+  #ifdef _WIN32
+  return Om_getErrorStr(code);
+  #else
+  wchar_t num_buf[32];
+  swprintf(num_buf, 32, L"%x", code);
+
+  OmWString ret = L"(0x"; ret.append(num_buf); ret.append(L") ");
+
+  char msg_buf[256];
+  msg_buf[0] = 0;
+
+  OmWString msg;
+  __wide_name(&msg, __strerror_msg(strerror_r(code, msg_buf, sizeof(msg_buf)), msg_buf));
+  ret.append(msg);
+
+  return ret;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+unsigned Om_pltCpuCount()
+{
+  #ifdef _WIN32
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+
+  return (si.dwNumberOfProcessors > 0) ? si.dwNumberOfProcessors : 1;
+  #else
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+  return (n > 0) ? static_cast<unsigned>(n) : 1;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void* Om_pltThreadCreate(Om_pltThreadFn thread_fn, void* user_ptr)
+{
+  __thread_t* th = new __thread_t;
+  th->thread_fn = thread_fn;
+  th->user_ptr = user_ptr;
+
+  #ifdef _WIN32
+  // parameters are released by the thread itself
+  HANDLE hth = CreateThread(nullptr, 0, __thread_run_fn, th, 0, nullptr);
+  if(!hth) {
+    delete th;
+    return nullptr;
+  }
+
+  return hth;
+  #else
+  // parameters hold the thread identifier and are released once both
+  // thread ended and handle was joined or cleared
+  pthread_mutex_init(&th->mutex, nullptr);
+  pthread_cond_init(&th->cond, nullptr);
+  th->end_fn = nullptr;
+  th->end_ptr = nullptr;
+  th->refs = 2;
+  th->returned = false;
+  th->ended = false;
+  th->detached = false;
+
+  if(0 != pthread_create(&th->thread, nullptr, __thread_run_fn, th)) {
+    pthread_cond_destroy(&th->cond);
+    pthread_mutex_destroy(&th->mutex);
+    delete th;
+    return nullptr;
+  }
+
+  return th;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint32_t Om_pltThreadJoin(void* hth)
+{
+  #ifdef _WIN32
+  DWORD result = 0;
+
+  WaitForSingleObject(hth, INFINITE);
+  GetExitCodeThread(hth, &result);
+  CloseHandle(hth);
+
+  return result;
+  #else
+  __thread_t* th = static_cast<__thread_t*>(hth);
+
+  void* result = nullptr;
+  pthread_join(th->thread, &result);
+
+  __thread_release(th);
+
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(result));
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void* Om_pltThreadWatch(void* hth, Om_pltThreadEndFn end_fn, void* user_ptr)
+{
+  #ifdef _WIN32
+  __thread_wait_t* wait = new __thread_wait_t;
+  wait->end_fn = end_fn;
+  wait->user_ptr = user_ptr;
+
+  if(!RegisterWaitForSingleObject(&wait->hwait, hth, __thread_end_fn, wait, INFINITE, WT_EXECUTEONLYONCE)) {
+    delete wait;
+    return nullptr;
+  }
+
+  return wait;
+  #else
+  __thread_t* th = static_cast<__thread_t*>(hth);
+
+  pthread_mutex_lock(&th->mutex);
+
+  bool returned = th->returned;
+  if(!returned) {
+    th->end_fn = end_fn;
+    th->end_ptr = user_ptr;
+  }
+
+  pthread_mutex_unlock(&th->mutex);
+
+  if(returned)
+    end_fn(user_ptr, 0);
+
+  // end function is held by thread itself
+  return th;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pltThreadWait(void* hth, uint32_t timeout)
+{
+  #ifdef _WIN32
+  return (WAIT_OBJECT_0 == WaitForSingleObject(hth, timeout));
+  #else
+  __thread_t* th = static_cast<__thread_t*>(hth);
+
+  struct timespec ts;
+  if(timeout != OM_PLT_INFINITE) {
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout / 1000;
+    ts.tv_nsec += (timeout % 1000) * 1000000L;
+    if(ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec++; ts.tv_nsec -= 1000000000L;
+    }
+  }
+
+  pthread_mutex_lock(&th->mutex);
+
+  while(!th->ended) {
+    if(timeout == OM_PLT_INFINITE) {
+      pthread_cond_wait(&th->cond, &th->mutex);
+    } else if(ETIMEDOUT == pthread_cond_timedwait(&th->cond, &th->mutex, &ts)) {
+      break;
+    }
+  }
+
+  bool ended = th->ended;
+
+  pthread_mutex_unlock(&th->mutex);
+
+  return ended;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltThreadClear(void* hth, void* hwait)
+{
+  #ifdef _WIN32
+  if(hth)
+    CloseHandle(hth);
+
+  if(hwait) {
+    __thread_wait_t* wait = static_cast<__thread_wait_t*>(hwait);
+    UnregisterWait(wait->hwait);
+    delete wait;
+  }
+  #else
+  OM_UNUSED(hwait);
+
+  if(!hth)
+    return;
+
+  __thread_t* th = static_cast<__thread_t*>(hth);
+
+  pthread_mutex_lock(&th->mutex);
+
+  if(!th->detached) {
+    pthread_detach(th->thread);
+    th->detached = true;
+  }
+
+  pthread_mutex_unlock(&th->mutex);
+
+  __thread_release(th);
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint32_t Om_pltThreadId()
+{
+  #if defined(_WIN32)
+  return GetCurrentThreadId();
+  #elif defined(__linux__)
+  return static_cast<uint32_t>(syscall(SYS_gettid));
+  #else
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(pthread_self()));
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltSleep(uint32_t ms)
+{
+  #ifdef _WIN32
+  Sleep(ms);
+  #else
+  struct timespec ts;
+  ts.tv_sec = ms / 1000;
+  ts.tv_nsec = (ms % 1000) * 1000000L;
+
+  while(nanosleep(&ts, &ts) != 0 && errno == EINTR);
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void* Om_pltEventCreate(bool manual)
+{
+  #ifdef _WIN32
+  return CreateEventW(nullptr, manual, false, nullptr);
+  #else
+  __event_t* ev = new __event_t;
+
+  if(0 != pipe(ev->fd)) {
+    delete ev;
+    return nullptr;
+  }
+
+  for(unsigned i = 0; i < 2; ++i) {
+    fcntl(ev->fd[i], F_SETFL, fcntl(ev->fd[i], F_GETFL) | O_NONBLOCK);
+    fcntl(ev->fd[i], F_SETFD, FD_CLOEXEC);
+  }
+
+  pthread_mutex_init(&ev->mutex, nullptr);
+  ev->manual = manual;
+  ev->signaled = false;
+
+  return ev;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltEventSet(void* hev)
+{
+  #ifdef _WIN32
+  SetEvent(hev);
+  #else
+  __event_t* ev = static_cast<__event_t*>(hev);
+
+  pthread_mutex_lock(&ev->mutex);
+
+  if(!ev->signaled) {
+    char b = 1; ssize_t w = write(ev->fd[1], &b, 1); OM_UNUSED(w);
+    ev->signaled = true;
+  }
+
+  pthread_mutex_unlock(&ev->mutex);
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltEventReset(void* hev)
+{
+  #ifdef _WIN32
+  ResetEvent(hev);
+  #else
+  __event_t* ev = static_cast<__event_t*>(hev);
+
+  pthread_mutex_lock(&ev->mutex);
+
+  if(ev->signaled) {
+    char b; ssize_t r = read(ev->fd[0], &b, 1); OM_UNUSED(r);
+    ev->signaled = false;
+  }
+
+  pthread_mutex_unlock(&ev->mutex);
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pltEventWait(void* hev, uint32_t timeout)
+{
+  #ifdef _WIN32
+  return (WAIT_OBJECT_0 == WaitForSingleObject(hev, timeout));
+  #else
+  __event_t* ev = static_cast<__event_t*>(hev);
+
+  uint64_t limit = Om_pltTickCount() + timeout;
+
+  struct pollfd pfd;
+  pfd.fd = ev->fd[0];
+  pfd.events = POLLIN;
+
+  while(true) {
+
+    if(__event_take(ev))
+      return true;
+
+    uint32_t remain = OM_PLT_INFINITE;
+
+    if(timeout != OM_PLT_INFINITE) {
+      uint64_t now = Om_pltTickCount();
+      if(now >= limit) return false;
+      remain = static_cast<uint32_t>(limit - now);
+    }
+
+    // another waiter may consume the event first, so we check again
+    poll(&pfd, 1, __poll_timeout(remain));
+  }
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltEventClose(void* hev)
+{
+  if(!hev)
+    return;
+
+  #ifdef _WIN32
+  CloseHandle(hev);
+  #else
+  __event_t* ev = static_cast<__event_t*>(hev);
+
+  close(ev->fd[0]);
+  close(ev->fd[1]);
+  pthread_mutex_destroy(&ev->mutex);
+
+  delete ev;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void* Om_pltLockCreate()
+{
+  #ifdef _WIN32
+  CRITICAL_SECTION* cs = new CRITICAL_SECTION;
+  InitializeCriticalSection(cs);
+
+  return cs;
+  #else
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+
+  pthread_mutex_t* mutex = new pthread_mutex_t;
+  pthread_mutex_init(mutex, &attr);
+
+  pthread_mutexattr_destroy(&attr);
+
+  return mutex;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltLockEnter(void* hlk)
+{
+  #ifdef _WIN32
+  EnterCriticalSection(static_cast<CRITICAL_SECTION*>(hlk));
+  #else
+  pthread_mutex_lock(static_cast<pthread_mutex_t*>(hlk));
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltLockLeave(void* hlk)
+{
+  #ifdef _WIN32
+  LeaveCriticalSection(static_cast<CRITICAL_SECTION*>(hlk));
+  #else
+  pthread_mutex_unlock(static_cast<pthread_mutex_t*>(hlk));
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltLockClose(void* hlk)
+{
+  if(!hlk)
+    return;
+
+  #ifdef _WIN32
+  DeleteCriticalSection(static_cast<CRITICAL_SECTION*>(hlk));
+  delete static_cast<CRITICAL_SECTION*>(hlk);
+  #else
+  pthread_mutex_destroy(static_cast<pthread_mutex_t*>(hlk));
+  delete static_cast<pthread_mutex_t*>(hlk);
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int64_t Om_pltAtomicInc(volatile int64_t* val)
+{
+  #ifdef _WIN32
+  return InterlockedIncrement64(reinterpret_cast<volatile LONG64*>(val));
+  #else
+  return __atomic_add_fetch(val, 1, __ATOMIC_SEQ_CST);
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_pltAtomicSet(volatile int32_t* val, int32_t set)
+{
+  #ifdef _WIN32
+  return InterlockedExchange(reinterpret_cast<volatile LONG*>(val), set);
+  #else
+  return __atomic_exchange_n(val, set, __ATOMIC_SEQ_CST);
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint64_t Om_pltTickCount()
+{
+  #ifdef _WIN32
+  return GetTickCount64();
+  #else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint64_t Om_pltTimeUs()
+{
+  #ifdef _WIN32
+  static LARGE_INTEGER freq = {};
+  if(!freq.QuadPart)
+    QueryPerformanceFrequency(&freq);
+
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+
+  uint64_t ticks = now.QuadPart;
+  uint64_t rate = freq.QuadPart;
+
+  // split to avoid overflow of multiplication
+  return (ticks / rate) * 1000000 + ((ticks % rate) * 1000000) / rate;
+  #else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void* Om_pltFileOpen(const OmWString& path, unsigned mode)
+{
+  #ifdef _WIN32
+  DWORD access = 0;
+  if(mode & OM_PLT_FILE_READ) access |= GENERIC_READ;
+  if(mode & OM_PLT_FILE_WRITE) access |= GENERIC_WRITE;
+
+  DWORD share = (mode & OM_PLT_FILE_EXCL) ? 0 : FILE_SHARE_READ;
+
+  DWORD disp = (mode & OM_PLT_FILE_CREATE) ? CREATE_ALWAYS : OPEN_EXISTING;
+
+  HANDLE hfile = CreateFileW(path.c_str(), access, share, nullptr, disp, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  return (hfile != INVALID_HANDLE_VALUE) ? hfile : nullptr;
+  #else
+  int flags = O_CLOEXEC;
+
+  if((mode & OM_PLT_FILE_READ) && (mode & OM_PLT_FILE_WRITE)) {
+    flags |= O_RDWR;
+  } else if(mode & OM_PLT_FILE_WRITE) {
+    flags |= O_WRONLY;
+  } else {
+    flags |= O_RDONLY;
+  }
+
+  if(mode & OM_PLT_FILE_CREATE)
+    flags |= O_CREAT|O_TRUNC;
+
+  int fd = open(__native_path(path).c_str(), flags, 0644);
+  if(fd < 0)
+    return nullptr;
+
+  // locks are only advisory, this is the closest to share mode
+  if(mode & OM_PLT_FILE_EXCL) {
+    if(0 != flock(fd, LOCK_EX|LOCK_NB)) {
+      close(fd);
+      return nullptr;
+    }
+  }
+
+  return reinterpret_cast<void*>(static_cast<intptr_t>(fd) + 1);
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int64_t Om_pltFileRead(void* hfile, void* buf, size_t len)
+{
+  uint8_t* dst = static_cast<uint8_t*>(buf);
+  size_t done = 0;
+
+  while(done < len) {
+
+    size_t chunk = len - done;
+    if(chunk > 0x40000000) chunk = 0x40000000;
+
+    #ifdef _WIN32
+    DWORD rb = 0;
+    if(!ReadFile(hfile, dst + done, static_cast<DWORD>(chunk), &rb, nullptr))
+      return -1;
+    #else
+    ssize_t rb = read(__handle_fd(hfile), dst + done, chunk);
+    if(rb < 0) {
+      if(errno == EINTR) continue;
+      return -1;
+    }
+    #endif
+
+    if(rb == 0) //< end of file
+      break;
+
+    done += rb;
+  }
+
+  return done;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int64_t Om_pltFileWrite(void* hfile, const void* buf, size_t len)
+{
+  const uint8_t* src = static_cast<const uint8_t*>(buf);
+  size_t done = 0;
+
+  while(done < len) {
+
+    size_t chunk = len - done;
+    if(chunk > 0x40000000) chunk = 0x40000000;
+
+    #ifdef _WIN32
+    DWORD wb = 0;
+    if(!WriteFile(hfile, src + done, static_cast<DWORD>(chunk), &wb, nullptr))
+      return -1;
+    #else
+    ssize_t wb = write(__handle_fd(hfile), src + done, chunk);
+    if(wb < 0) {
+      if(errno == EINTR) continue;
+      return -1;
+    }
+    #endif
+
+    if(wb == 0)
+      return -1;
+
+    done += wb;
+  }
+
+  return done;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pltFileSeek(void* hfile, uint64_t offset)
+{
+  #ifdef _WIN32
+  LARGE_INTEGER pos;
+  pos.QuadPart = offset;
+
+  return SetFilePointerEx(hfile, pos, nullptr, FILE_BEGIN);
+  #else
+  return (lseek(__handle_fd(hfile), offset, SEEK_SET) >= 0);
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint64_t Om_pltFileSize(void* hfile)
+{
+  #ifdef _WIN32
+  LARGE_INTEGER size;
+  if(!GetFileSizeEx(hfile, &size))
+    return 0;
+
+  return size.QuadPart;
+  #else
+  struct stat st;
+  if(0 != fstat(__handle_fd(hfile), &st))
+    return 0;
+
+  return st.st_size;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltFileClose(void* hfile)
+{
+  if(!hfile)
+    return;
+
+  #ifdef _WIN32
+  CloseHandle(hfile);
+  #else
+  close(__handle_fd(hfile));
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_pltItemProbe(const OmWString& path)
+{
+  #ifdef _WIN32
+  DWORD attr = GetFileAttributesW(path.c_str());
+  if(attr == INVALID_FILE_ATTRIBUTES)
+    return OM_PLT_ITEM_NONE;
+
+  DWORD flags = (attr & FILE_ATTRIBUTE_DIRECTORY) ? FILE_FLAG_BACKUP_SEMANTICS : 0;
+
+  // try to take exclusive control to ensure item is fully available
+  HANDLE hfile = CreateFileW(path.c_str(), GENERIC_READ|GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, flags, nullptr);
+  if(hfile == INVALID_HANDLE_VALUE)
+    return OM_PLT_ITEM_BUSY;
+
+  CloseHandle(hfile);
+
+  return OM_PLT_ITEM_READY;
+  #else
+  OmCString native = __native_path(path);
+
+  struct stat st;
+  if(0 != stat(native.c_str(), &st))
+    return OM_PLT_ITEM_NONE;
+
+  int fd = open(native.c_str(), O_RDONLY|O_CLOEXEC);
+  if(fd < 0)
+    return OM_PLT_ITEM_BUSY;
+
+  // locks are only advisory, writers that do not lock are not detected
+  int32_t result = (0 == flock(fd, LOCK_EX|LOCK_NB)) ? OM_PLT_ITEM_READY : OM_PLT_ITEM_BUSY;
+
+  close(fd);
+
+  return result;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pltItemIdent(const OmWString& path, uint64_t* volume, uint64_t* index)
+{
+  #ifdef _WIN32
+  // no access right is needed to query item information
+  HANDLE hfile = CreateFileW(path.c_str(), 0, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,
+                             nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+  if(hfile == INVALID_HANDLE_VALUE)
+    return false;
+
+  BY_HANDLE_FILE_INFORMATION info;
+  bool result = GetFileInformationByHandle(hfile, &info);
+
+  CloseHandle(hfile);
+
+  if(!result)
+    return false;
+
+  *volume = info.dwVolumeSerialNumber;
+  *index = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+
+  return true;
+  #else
+  struct stat st;
+  if(0 != stat(__native_path(path).c_str(), &st))
+    return false;
+
+  *volume = st.st_dev;
+  *index = st.st_ino;
+
+  return true;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pltItemStat(const OmWString& path, OmPltItemStat_t* stat)
+{
+  #ifdef _WIN32
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  if(!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data))
+    return false;
+
+  stat->isdir = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY);
+  stat->hidden = (data.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN);
+  stat->size = stat->isdir ? 0 : (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+
+  ULARGE_INTEGER ull;
+  ull.LowPart = data.ftLastWriteTime.dwLowDateTime;
+  ull.HighPart = data.ftLastWriteTime.dwHighDateTime;
+
+  stat->mtime = ull.QuadPart / 10000000ULL - 11644473600ULL;
+
+  return true;
+  #else
+  OmCString native = __native_path(path);
+
+  struct stat st;
+  if(0 != ::stat(native.c_str(), &st))
+    return false;
+
+  size_t pos = native.find_last_of('/');
+  const char* name = native.c_str() + ((pos != OmCString::npos) ? pos + 1 : 0);
+
+  stat->isdir = S_ISDIR(st.st_mode);
+  stat->hidden = (name[0] == '.' && name[1] != 0 && !(name[1] == '.' && name[2] == 0));
+  stat->size = stat->isdir ? 0 : st.st_size;
+  stat->mtime = st.st_mtime;
+
+  return true;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pltItemAccess(const OmWString& path, unsigned mode)
+{
+  #ifdef _WIN32
+  // directory specific rights share values with file ones
+  DWORD mask = 0;
+  if(mode & OM_PLT_ACCESS_READ) mask |= FILE_READ_DATA|FILE_READ_ATTRIBUTES;
+  if(mode & OM_PLT_ACCESS_WRITE) mask |= FILE_WRITE_DATA|FILE_APPEND_DATA|FILE_WRITE_ATTRIBUTES;
+  if(mode & OM_PLT_ACCESS_EXEC) mask |= FILE_EXECUTE;
+
+  // Thanks to this article for giving some clues :
+  // http://blog.aaronballman.com/2011/08/how-to-check-access-rights/
+
+  // retrieve the "security descriptor" (i.e owner, group, access rights,
+  // etc.) of the specified file or folder.
+  DWORD sdMask =  OWNER_SECURITY_INFORMATION | GROUP_SECURITY_INFORMATION
+                | DACL_SECURITY_INFORMATION;
+
+  DWORD sdSize = 0;
+  GetFileSecurityW(path.c_str(), sdMask, nullptr, 0, &sdSize);
+
+  SECURITY_DESCRIPTOR* pSd = reinterpret_cast<SECURITY_DESCRIPTOR*>(Om_alloc(sdSize + 1));
+  if(!GetFileSecurityW(path.c_str(), sdMask, pSd, sdSize, &sdSize)) {
+    Om_free(pSd);
+    return false;
+  }
+
+  // the current process token is a "primary" one, it must be duplicated
+  // to an impersonation token to be checked against security descriptor
+  DWORD daMask =  TOKEN_IMPERSONATE | TOKEN_QUERY | TOKEN_DUPLICATE
+                | STANDARD_RIGHTS_READ;
+
+  HANDLE hTokenProc = nullptr;
+  if(!OpenProcessToken(GetCurrentProcess(), daMask, &hTokenProc)) {
+    Om_free(pSd);
+    return false;
+  }
+
+  HANDLE hTokenUser = nullptr;
+  if(!DuplicateToken(hTokenProc, SecurityImpersonation, &hTokenUser)) {
+    CloseHandle(hTokenProc); Om_free(pSd);
+    return false;
+  }
+
+  // the GENERIC_MAPPING seem to be never used in most common scenarios,
+  // we set it here because the parameter is mandatory.
+  GENERIC_MAPPING gm = {GENERIC_READ,GENERIC_WRITE,GENERIC_EXECUTE,GENERIC_ALL};
+  PRIVILEGE_SET ps = {};
+  DWORD psSize = sizeof(PRIVILEGE_SET);
+  DWORD allowed = 0;      //< mask of allowed access
+  BOOL  status = false;   //< access status according supplied GENERIC_MAPPING
+
+  if(!AccessCheck(pSd, hTokenUser, mask, &gm, &ps, &psSize, &allowed, &status))
+    status = false;
+
+  CloseHandle(hTokenProc);
+  CloseHandle(hTokenUser);
+  Om_free(pSd);
+
+  return status;
+  #else
+  int amode = 0;
+  if(mode & OM_PLT_ACCESS_READ) amode |= R_OK;
+  if(mode & OM_PLT_ACCESS_WRITE) amode |= W_OK;
+  if(mode & OM_PLT_ACCESS_EXEC) amode |= X_OK;
+
+  return (0 == faccessat(AT_FDCWD, __native_path(path).c_str(), amode ? amode : F_OK, AT_EACCESS));
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_pltItemTrash(const OmWString& path)
+{
+  #ifdef _WIN32
+  wchar_t path_buf[OM_MAX_PATH + 1];
+
+  if(path.size() >= OM_MAX_PATH)
+    return ERROR_FILENAME_EXCED_RANGE;
+
+  // the buffer must end with double null character
+  wcscpy(path_buf, path.c_str());
+  path_buf[path.size()+1] = 0;
+
+  SHFILEOPSTRUCTW fop = {};
+  fop.pFrom = path_buf;
+  fop.wFunc = FO_DELETE;
+  fop.fFlags = FOF_NO_UI|FOF_ALLOWUNDO;
+
+  return SHFileOperationW(&fop);
+  #else
+  // freedesktop.org trash specification, home trash only
+  char* real = realpath(__native_path(path).c_str(), nullptr);
+  if(!real)
+    return errno;
+
+  OmCString src(real);
+  free(real);
+
+  OmCString trash;
+
+  const char* data_home = getenv("XDG_DATA_HOME");
+  const char* home = getenv("HOME");
+
+  if(data_home && data_home[0]) {
+    trash = data_home;
+  } else if(home && home[0]) {
+    trash = home; trash += "/.local/share";
+  } else {
+    return ENOENT;
+  }
+
+  trash += "/Trash";
+
+  int result = __native_mkdirs(trash + "/files");
+  if(result == 0)
+    result = __native_mkdirs(trash + "/info");
+
+  if(result != 0)
+    return result;
+
+  OmCString base = src.substr(src.find_last_of('/') + 1);
+  OmCString name = base;
+  OmCString info;
+
+  // info file is created first with exclusive flag to reserve name
+  int fd = -1;
+  for(unsigned n = 2; fd < 0; ++n) {
+
+    info = trash; info += "/info/"; info += name; info += ".trashinfo";
+
+    fd = open(info.c_str(), O_WRONLY|O_CREAT|O_EXCL|O_CLOEXEC, 0600);
+    if(fd < 0) {
+
+      if(errno != EEXIST || n > 9999)
+        return errno;
+
+      name = base; name += '.'; name += std::to_string(n);
+    }
+  }
+
+  OmCString text = "[Trash Info]\nPath=";
+
+  // path is stored as URL escaped string
+  const char* hex = "0123456789ABCDEF";
+  for(size_t i = 0; i < src.size(); ++i) {
+    uint8_t c = src[i];
+    if(isalnum(c) || c == '/' || c == '-' || c == '_' || c == '.' || c == '~') {
+      text.push_back(c);
+    } else {
+      text.push_back('%'); text.push_back(hex[c >> 4]); text.push_back(hex[c & 0xF]);
+    }
+  }
+
+  char date[32];
+  time_t now = time(nullptr);
+  struct tm tm_now;
+  localtime_r(&now, &tm_now);
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &tm_now);
+
+  text += "\nDeletionDate="; text += date; text += "\n";
+
+  if(Om_pltFileWrite(reinterpret_cast<void*>(static_cast<intptr_t>(fd) + 1), text.data(), text.size()) < 0)
+    result = errno;
+
+  close(fd);
+
+  OmCString dst = trash; dst += "/files/"; dst += name;
+
+  // trash on another volume is not supported, item stays in place
+  if(result == 0 && 0 != rename(src.c_str(), dst.c_str()))
+    result = errno;
+
+  if(result != 0)
+    unlink(info.c_str());
+
+  return result;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pltPathIsNetwork(const OmWString& path)
+{
+  #if defined(_WIN32)
+  return PathIsNetworkPathW(path.c_str());
+  #elif defined(__linux__)
+  struct statfs sf;
+  if(0 != statfs(__native_path(path).c_str(), &sf))
+    return false;
+
+  switch(static_cast<uint32_t>(sf.f_type)) {
+  case 0x6969:      //< NFS
+  case 0x517B:      //< SMB
+  case 0xFF534D42:  //< CIFS
+  case 0xFE534D42:  //< SMB2
+  case 0x564C:      //< NCP
+  case 0x73757245:  //< CODA
+  case 0x5346414F:  //< AFS
+  case 0x01021997:  //< V9FS
+    return true;
+  default:
+    return false;
+  }
+  #else
+  OM_UNUSED(path);
+
+  return false;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_pltDirCreate(const OmWString& path)
+{
+  #ifdef _WIN32
+  if(!CreateDirectoryW(path.c_str(), nullptr))
+    return GetLastError();
+
+  return 0;
+  #else
+  if(0 != mkdir(__native_path(path).c_str(), 0777))
+    return errno;
+
+  return 0;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_pltDirDelete(const OmWString& path)
+{
+  #ifdef _WIN32
+  if(!RemoveDirectoryW(path.c_str()))
+    return GetLastError();
+
+  return 0;
+  #else
+  OmCString native = __native_path(path);
+
+  if(0 != rmdir(native.c_str())) {
+    // symbolic link to directory is removed as Windows does for junctions
+    if(errno != ENOTDIR || 0 != unlink(native.c_str()))
+      return errno;
+  }
+
+  return 0;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_pltFileCopy(const OmWString& src, const OmWString& dst)
+{
+  #ifdef _WIN32
+  if(!CopyFileW(src.c_str(), dst.c_str(), false))
+    return GetLastError();
+
+  return 0;
+  #else
+  return __native_copy(__native_path(src), __native_path(dst));
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_pltFileMove(const OmWString& src, const OmWString& dst)
+{
+  #ifdef _WIN32
+  if(!MoveFileExW(src.c_str(), dst.c_str(), MOVEFILE_REPLACE_EXISTING|MOVEFILE_COPY_ALLOWED|MOVEFILE_WRITE_THROUGH))
+    return GetLastError();
+
+  return 0;
+  #else
+  OmCString native_src = __native_path(src);
+  OmCString native_dst = __native_path(dst);
+
+  if(0 == rename(native_src.c_str(), native_dst.c_str()))
+    return 0;
+
+  if(errno != EXDEV)
+    return errno;
+
+  // another volume, data must be copied
+  int result = __native_copy(native_src, native_dst);
+  if(result != 0)
+    return result;
+
+  if(0 != unlink(native_src.c_str()))
+    return errno;
+
+  return 0;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_pltFileDelete(const OmWString& path)
+{
+  #ifdef _WIN32
+  if(!DeleteFileW(path.c_str()))
+    return GetLastError();
+
+  return 0;
+  #else
+  if(0 != unlink(__native_path(path).c_str()))
+    return errno;
+
+  return 0;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void* Om_pltDirOpen(const OmWString& path)
+{
+  __dir_t* dir = new __dir_t;
+
+  #ifdef _WIN32
+  OmWString srch(path);
+  srch += L"\\*";
+
+  // large fetch buffer and no short names query to reduce system calls
+  dir->hfind = FindFirstFileExW(srch.c_str(), FindExInfoBasic, &dir->fd, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+  if(dir->hfind == INVALID_HANDLE_VALUE) {
+    delete dir;
+    return nullptr;
+  }
+
+  dir->first = true;
+  #else
+  dir->dir = opendir(__native_path(path).c_str());
+  if(!dir->dir) {
+    delete dir;
+    return nullptr;
+  }
+  #endif
+
+  return dir;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pltDirNext(void* hdir, OmPltDirEnt_t* ent)
+{
+  __dir_t* dir = static_cast<__dir_t*>(hdir);
+
+  #ifdef _WIN32
+  while(true) {
+
+    if(dir->first) {
+      dir->first = false;
+    } else {
+      if(!FindNextFileW(dir->hfind, &dir->fd))
+        return false;
+    }
+
+    // skip this and parent folder
+    if(!wcscmp(dir->fd.cFileName, L".")) continue;
+    if(!wcscmp(dir->fd.cFileName, L"..")) continue;
+
+    ent->name = dir->fd.cFileName;
+    ent->isdir = (dir->fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY);
+    ent->hidden = (dir->fd.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN);
+    ent->islink = (dir->fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT);
+
+    return true;
+  }
+  #else
+  struct dirent* de;
+
+  while((de = readdir(dir->dir)) != nullptr) {
+
+    // skip this and parent folder
+    if(de->d_name[0] == '.' && (de->d_name[1] == 0 || (de->d_name[1] == '.' && de->d_name[2] == 0)))
+      continue;
+
+    __wide_name(&ent->name, de->d_name);
+
+    ent->hidden = (de->d_name[0] == '.');
+    ent->isdir = (de->d_type == DT_DIR);
+    ent->islink = (de->d_type == DT_LNK);
+
+    struct stat st;
+
+    // file system does not provide type
+    if(de->d_type == DT_UNKNOWN) {
+      if(0 == fstatat(dirfd(dir->dir), de->d_name, &st, AT_SYMLINK_NOFOLLOW)) {
+        ent->isdir = S_ISDIR(st.st_mode);
+        ent->islink = S_ISLNK(st.st_mode);
+      }
+    }
+
+    // item is a link, follow it the same way Windows would do with
+    // junctions, callers must take care of loops
+    if(ent->islink) {
+      if(0 == fstatat(dirfd(dir->dir), de->d_name, &st, 0))
+        ent->isdir = S_ISDIR(st.st_mode);
+    }
+
+    return true;
+  }
+
+  return false;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltDirClose(void* hdir)
+{
+  if(!hdir)
+    return;
+
+  __dir_t* dir = static_cast<__dir_t*>(hdir);
+
+  #ifdef _WIN32
+  FindClose(dir->hfind);
+  #else
+  closedir(dir->dir);
+  #endif
+
+  delete dir;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void* Om_pltWatchOpen(const OmWString& path)
+{
+  #if defined(_WIN32)
+  __watch_t* watch = new __watch_t;
+
+  watch->hdir = CreateFileW(path.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ|FILE_SHARE_DELETE|FILE_SHARE_WRITE,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_BACKUP_SEMANTICS|FILE_FLAG_OVERLAPPED, nullptr);
+
+  if(watch->hdir == INVALID_HANDLE_VALUE) {
+    delete watch;
+    return nullptr;
+  }
+
+  memset(&watch->ov, 0, sizeof(OVERLAPPED));
+  watch->ov.hEvent = CreateEventW(nullptr, false, false, nullptr);
+
+  watch->buf = new uint8_t[WATCH_BUFFER_SIZE];
+
+  if(!__watch_read(watch)) {
+    Om_pltWatchClose(watch);
+    return nullptr;
+  }
+
+  return watch;
+  #elif defined(__linux__)
+  __watch_t* watch = new __watch_t;
+
+  watch->ifd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+  if(watch->ifd < 0) {
+    delete watch;
+    return nullptr;
+  }
+
+  watch->root = __native_path(path);
+  watch->buf = new uint8_t[WATCH_BUFFER_SIZE];
+
+  // inotify is not recursive, each sub-directory needs its own watch
+  __watch_add(watch, OmWString());
+
+  if(watch->wd_path.empty()) {
+    Om_pltWatchClose(watch);
+    return nullptr;
+  }
+
+  return watch;
+  #else
+  // no directory changes notification available
+  OM_UNUSED(path);
+
+  return nullptr;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_pltWatchWait(void* hwatch, void* hstop, uint32_t timeout, OmPltDirChangeArray* changes)
+{
+  __watch_t* watch = static_cast<__watch_t*>(hwatch);
+
+  #if defined(_WIN32)
+  // the stop event at the second position
+  HANDLE hev[] = {watch->ov.hEvent, hstop};
+
+  DWORD result = WaitForMultipleObjects(hstop ? 2 : 1, hev, false, timeout);
+
+  if(result == WAIT_TIMEOUT)
+    return OM_PLT_WATCH_TIMEOUT;
+
+  if(result == WAIT_OBJECT_0 + 1)
+    return OM_PLT_WATCH_STOPPED;
+
+  if(result != WAIT_OBJECT_0)
+    return OM_PLT_WATCH_ERROR;
+
+  DWORD bytes = 0;
+  GetOverlappedResult(watch->hdir, &watch->ov, &bytes, false);
+
+  // zero bytes means buffer overflow, changes are lost
+  FILE_NOTIFY_INFORMATION* notify = nullptr;
+  if(bytes)
+    notify = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(watch->buf);
+
+  OmPltDirChange_t change;
+
+  while(notify) {
+
+    // supplied length is in bytes count
+    change.path.assign(notify->FileName, notify->FileNameLength / sizeof(wchar_t));
+
+    switch(notify->Action)
+    {
+    case FILE_ACTION_ADDED:
+    case FILE_ACTION_RENAMED_NEW_NAME:
+      change.action = OM_PLT_CHANGE_ADDED;
+      break;
+    case FILE_ACTION_REMOVED:
+    case FILE_ACTION_RENAMED_OLD_NAME:
+      change.action = OM_PLT_CHANGE_REMOVED;
+      break;
+    default:
+      change.action = OM_PLT_CHANGE_MODIFIED;
+      break;
+    }
+
+    changes->push_back(change);
+
+    if(notify->NextEntryOffset == 0)
+      break;
+
+    notify = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(reinterpret_cast<uint8_t*>(notify) + notify->NextEntryOffset);
+  }
+
+  if(!__watch_read(watch))
+    return OM_PLT_WATCH_ERROR;
+
+  return OM_PLT_WATCH_CHANGES;
+  #elif defined(__linux__)
+  struct pollfd pfd[2];
+  pfd[0].fd = watch->ifd;
+  pfd[0].events = POLLIN;
+  pfd[1].fd = hstop ? static_cast<__event_t*>(hstop)->fd[0] : -1;
+  pfd[1].events = POLLIN;
+
+  int result = poll(pfd, hstop ? 2 : 1, __poll_timeout(timeout));
+
+  if(result < 0)
+    return (errno == EINTR) ? OM_PLT_WATCH_TIMEOUT : OM_PLT_WATCH_ERROR;
+
+  if(hstop && (pfd[1].revents & POLLIN) && __event_take(static_cast<__event_t*>(hstop)))
+    return OM_PLT_WATCH_STOPPED;
+
+  if(!(pfd[0].revents & POLLIN))
+    return OM_PLT_WATCH_TIMEOUT;
+
+  OmPltDirChange_t change;
+  OmWString name;
+
+  ssize_t len;
+  while((len = read(watch->ifd, watch->buf, WATCH_BUFFER_SIZE)) > 0) {
+
+    for(ssize_t off = 0; off < len; ) {
+
+      const struct inotify_event* ev = reinterpret_cast<const struct inotify_event*>(watch->buf + off);
+      off += sizeof(struct inotify_event) + ev->len;
+
+      // queue overflow, changes are lost
+      if(ev->mask & IN_Q_OVERFLOW)
+        continue;
+
+      std::map<int, OmWString>::iterator it = watch->wd_path.find(ev->wd);
+      if(it == watch->wd_path.end())
+        continue;
+
+      if(ev->mask & IN_IGNORED) {
+        watch->wd_path.erase(it);
+        continue;
+      }
+
+      if(!ev->len)
+        continue;
+
+      __wide_name(&name, ev->name);
+
+      if(it->second.empty()) {
+        change.path = name;
+      } else {
+        change.path = it->second; change.path += L"\\"; change.path += name;
+      }
+
+      if(ev->mask & (IN_CREATE|IN_MOVED_TO)) {
+        change.action = OM_PLT_CHANGE_ADDED;
+        // new sub-directory must be watched as well
+        if(ev->mask & IN_ISDIR)
+          __watch_add(watch, change.path);
+      } else if(ev->mask & (IN_DELETE|IN_MOVED_FROM)) {
+        change.action = OM_PLT_CHANGE_REMOVED;
+      } else {
+        change.action = OM_PLT_CHANGE_MODIFIED;
+      }
+
+      changes->push_back(change);
+    }
+  }
+
+  return OM_PLT_WATCH_CHANGES;
+  #else
+  OM_UNUSED(watch); OM_UNUSED(hstop); OM_UNUSED(timeout); OM_UNUSED(changes);
+
+  return OM_PLT_WATCH_ERROR;
+  #endif
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pltWatchClose(void* hwatch)
+{
+  if(!hwatch)
+    return;
+
+  __watch_t* watch = static_cast<__watch_t*>(hwatch);
+
+  #if defined(_WIN32)
+  CancelIo(watch->hdir);
+  CloseHandle(watch->ov.hEvent);
+  CloseHandle(watch->hdir);
+  #elif defined(__linux__)
+  close(watch->ifd);
+  #endif
+
+  delete [] watch->buf;
+  delete watch;
+}
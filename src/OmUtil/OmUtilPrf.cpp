@@ -0,0 +1,352 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
+#include <cstdio>             //< snprintf
+
+#include "OmUtilStr.h"
+#include "OmUtilPlt.h"
+
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmUtilPrf.h"
+
+/// \brief Performance spans store
+///
+/// Global recorded spans ring buffer and time reference, initialized
+/// at program start.
+///
+class __perf_store_t
+{
+  public:
+
+    __perf_store_t() : head(0), count(0), enabled(0) {
+      this->lock = Om_pltLockCreate();
+      this->base = Om_pltTimeUs();
+    }
+
+    ~__perf_store_t() {
+      Om_pltLockClose(this->lock);
+    }
+
+    void*                 lock;
+
+    OmPerfSpanArray       ring;
+
+    size_t                head;
+
+    size_t                count;
+
+    uint64_t              base;
+
+    volatile int32_t      enabled;
+};
+
+static __perf_store_t __perf_store;
+
+/// \brief Append JSON string
+///
+/// Appends the given string to JSON output as quoted and escaped
+/// UTF-8 string.
+///
+/// \param[out] json    : Pointer to JSON output string.
+/// \param[in]  str     : String to append.
+///
+static void __json_string(OmCString* json, const OmWString& str)
+{
+  OmCString utf8;
+  Om_toUTF8(&utf8, str);
+
+  json->push_back('"');
+
+  for(size_t i = 0; i < utf8.size(); ++i) {
+
+    char c = utf8[i];
+
+    switch(c)
+    {
+    case '"':  json->append("\\\""); break;
+    case '\\': json->append("\\\\"); break;
+    case '\n': json->append("\\n"); break;
+    case '\r': json->append("\\r"); break;
+    case '\t': json->append("\\t"); break;
+    default:
+      if(static_cast<unsigned char>(c) < 0x20) {
+        char esc[8];
+        snprintf(esc, 8, "\\u%04x", c);
+        json->append(esc);
+      } else {
+        json->push_back(c);
+      }
+      break;
+    }
+  }
+
+  json->push_back('"');
+}
+
+/// \brief Append JSON number
+///
+/// Appends the given unsigned integer to JSON output.
+///
+/// \param[out] json    : Pointer to JSON output string.
+/// \param[in]  num     : Number to append.
+///
+static inline void __json_number(OmCString* json, uint64_t num)
+{
+  char buf[32];
+  snprintf(buf, 32, "%llu", static_cast<unsigned long long>(num));
+  json->append(buf);
+}
+
+/// \brief Write file
+///
+/// Creates or overwrites file with the given data.
+///
+/// \param[in]  path    : Path to file to write.
+/// \param[in]  data    : Data to write.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __write_file(const OmWString& path, const OmCString& data)
+{
+  void* hfile = Om_pltFileOpen(path, OM_PLT_FILE_WRITE|OM_PLT_FILE_CREATE|OM_PLT_FILE_EXCL);
+  if(!hfile)
+    return false;
+
+  bool result = (Om_pltFileWrite(hfile, data.data(), data.size()) == static_cast<int64_t>(data.size()));
+
+  Om_pltFileClose(hfile);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_perfEnable(bool enable)
+{
+  Om_pltAtomicSet(&__perf_store.enabled, enable ? 1 : 0);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_perfEnabled()
+{
+  return (__perf_store.enabled != 0);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint64_t Om_perfTime()
+{
+  return Om_pltTimeUs() - __perf_store.base;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_perfRecord(const wchar_t* name, const OmWString& detail, uint64_t start, uint64_t files, uint64_t bytes)
+{
+  if(!__perf_store.enabled)
+    return;
+
+  uint64_t end = Om_perfTime();
+
+  Om_pltLockEnter(__perf_store.lock);
+
+  if(__perf_store.ring.empty())
+    __perf_store.ring.resize(OM_PERF_MAX_SPANS);
+
+  OmPerfSpan_t& span = __perf_store.ring[__perf_store.head];
+  span.name = name;
+  span.detail = detail;
+  span.thread = Om_pltThreadId();
+  span.start = start;
+  span.length = end - start;
+  span.files = files;
+  span.bytes = bytes;
+
+  __perf_store.head = (__perf_store.head + 1) % OM_PERF_MAX_SPANS;
+
+  if(__perf_store.count < OM_PERF_MAX_SPANS)
+    __perf_store.count++;
+
+  Om_pltLockLeave(__perf_store.lock);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_perfGetSpans(OmPerfSpanArray* spans)
+{
+  Om_pltLockEnter(__perf_store.lock);
+
+  // oldest span is at head once ring is full
+  size_t first = (__perf_store.head + OM_PERF_MAX_SPANS - __perf_store.count) % OM_PERF_MAX_SPANS;
+
+  for(size_t i = 0; i < __perf_store.count; ++i)
+    spans->push_back(__perf_store.ring[(first + i) % OM_PERF_MAX_SPANS]);
+
+  Om_pltLockLeave(__perf_store.lock);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_perfGetStats(OmPerfStatArray* stats)
+{
+  OmPerfSpanArray spans;
+  Om_perfGetSpans(&spans);
+
+  std::map<OmWString, size_t> index;
+
+  for(size_t i = 0; i < spans.size(); ++i) {
+
+    std::map<OmWString, size_t>::iterator it = index.find(spans[i].name);
+
+    if(it == index.end()) {
+
+      OmPerfStat_t stat;
+      stat.name = spans[i].name;
+      stat.count = 0;
+      stat.total = 0;
+      stat.longest = 0;
+      stat.files = 0;
+      stat.bytes = 0;
+
+      it = index.insert(std::pair<OmWString, size_t>(spans[i].name, stats->size())).first;
+      stats->push_back(stat);
+    }
+
+    OmPerfStat_t& stat = stats->at(it->second);
+
+    stat.count++;
+    stat.total += spans[i].length;
+    stat.files += spans[i].files;
+    stat.bytes += spans[i].bytes;
+
+    if(spans[i].length > stat.longest)
+      stat.longest = spans[i].length;
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_perfClear()
+{
+  Om_pltLockEnter(__perf_store.lock);
+
+  OmPerfSpanArray().swap(__perf_store.ring);
+  __perf_store.head = 0;
+  __perf_store.count = 0;
+
+  Om_pltLockLeave(__perf_store.lock);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_perfSaveJson(const OmWString& path)
+{
+  OmPerfSpanArray spans;
+  Om_perfGetSpans(&spans);
+
+  OmPerfStatArray stats;
+  Om_perfGetStats(&stats);
+
+  OmCString json;
+  json.reserve(128 * (spans.size() + stats.size()));
+
+  json.append("{\"stats\":[");
+
+  for(size_t i = 0; i < stats.size(); ++i) {
+
+    if(i > 0) json.push_back(',');
+
+    json.append("\n{\"name\":"); __json_string(&json, stats[i].name);
+    json.append(",\"count\":"); __json_number(&json, stats[i].count);
+    json.append(",\"total_us\":"); __json_number(&json, stats[i].total);
+    json.append(",\"longest_us\":"); __json_number(&json, stats[i].longest);
+    json.append(",\"files\":"); __json_number(&json, stats[i].files);
+    json.append(",\"bytes\":"); __json_number(&json, stats[i].bytes);
+    json.push_back('}');
+  }
+
+  json.append("],\n\"spans\":[");
+
+  for(size_t i = 0; i < spans.size(); ++i) {
+
+    if(i > 0) json.push_back(',');
+
+    json.append("\n{\"name\":"); __json_string(&json, spans[i].name);
+    json.append(",\"detail\":"); __json_string(&json, spans[i].detail);
+    json.append(",\"thread\":"); __json_number(&json, spans[i].thread);
+    json.append(",\"start_us\":"); __json_number(&json, spans[i].start);
+    json.append(",\"length_us\":"); __json_number(&json, spans[i].length);
+    json.append(",\"files\":"); __json_number(&json, spans[i].files);
+    json.append(",\"bytes\":"); __json_number(&json, spans[i].bytes);
+    json.push_back('}');
+  }
+
+  json.append("]}\n");
+
+  return __write_file(path, json);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_perfSaveTrace(const OmWString& path)
+{
+  OmPerfSpanArray spans;
+  Om_perfGetSpans(&spans);
+
+  OmCString json;
+  json.reserve(160 * spans.size());
+
+  json.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+  char buf[64];
+
+  for(size_t i = 0; i < spans.size(); ++i) {
+
+    if(i > 0) json.push_back(',');
+
+    // complete event, time values are in microseconds
+    json.append("\n{\"ph\":\"X\",\"cat\":\"omm\",\"pid\":1,\"name\":"); __json_string(&json, spans[i].name);
+    json.append(",\"tid\":"); __json_number(&json, spans[i].thread);
+    json.append(",\"ts\":"); __json_number(&json, spans[i].start);
+    json.append(",\"dur\":"); __json_number(&json, spans[i].length);
+    json.append(",\"args\":{\"detail\":"); __json_string(&json, spans[i].detail);
+    json.append(",\"files\":"); __json_number(&json, spans[i].files);
+    json.append(",\"bytes\":"); __json_number(&json, spans[i].bytes);
+
+    // throughput is more readable once computed
+    if(spans[i].bytes && spans[i].length) {
+      snprintf(buf, 64, ",\"MiB/s\":%.2f", (static_cast<double>(spans[i].bytes) / 1048576.0) / (static_cast<double>(spans[i].length) / 1000000.0));
+      json.append(buf);
+    }
+
+    json.append("}}");
+  }
+
+  json.append("]}\n");
+
+  return __write_file(path, json);
+}
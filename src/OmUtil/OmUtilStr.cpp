@@ -18,8 +18,22 @@
 #include <regex>              //< std::wregex
 #include <algorithm>          //< std::replace
 
-#include "OmBaseWin.h"        //< WinAPI
-#include <shlwapi.h>          //< StrFromKBSizeW, etc.
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>        //< SSE2/AVX2 intrinsics
+#if WCHAR_MAX <= 0xFFFF
+#define OM_STR_SIMD           //< SIMD paths assume 16-bit wchar_t
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>           //< _BitScanForward
+#endif
+#endif
+
+#ifdef _WIN32
+  #include "OmBaseWin.h"      //< WinAPI
+  #include <shlwapi.h>        //< StrFromKBSizeW, etc.
+#endif
+
+#include "OmUtilPlt.h"
 
 #define READ_BUF_SIZE 524288
 
@@ -177,13 +191,14 @@ inline static void __utf8_encode(OmCString& utf8, const OmWString& wstr)
 }
 */
 
+#ifdef _WIN32
 /// \brief Multibyte Decode
 ///
 /// Static inlined function to convert the given multibyte string into wide
 /// char string assuming the specified encoding.
 ///
-/// This function use the WinAPI MultiByteToWideChar implementation witch is
-/// currently the known fastest way.
+/// This function use the WinAPI MultiByteToWideChar implementation and is
+/// used for ANSI code page, UTF-8 conversion use __utf8_decode.
 ///
 /// \param[in]  cp      : Code page to use in performing the conversion.
 /// \param[in]  pwcs    : Wide char string to receive conversion result.
@@ -239,6 +254,319 @@ inline static size_t __multibyte_encode(UINT cp, OmCString* pstr, const wchar_t*
   }
   return 0;
 }
+#endif // _WIN32
+
+#ifdef OM_STR_SIMD
+/// \brief Count trailing zeros
+///
+/// Static function to get index of the lowest set bit of the given value,
+/// which must not be zero.
+///
+/// \param[in]  v       : Value to scan.
+///
+/// \return Index of lowest set bit.
+///
+static inline unsigned __ctz32(uint32_t v)
+{
+  #ifdef _MSC_VER
+  unsigned long idx;
+  _BitScanForward(&idx, v);
+  return static_cast<unsigned>(idx);
+  #else
+  return static_cast<unsigned>(__builtin_ctz(v));
+  #endif
+}
+#endif // OM_STR_SIMD
+
+/// \brief UTF-8 decode
+///
+/// Static function to convert the given UTF-8 data into UTF-16 in a single
+/// pass. ASCII runs are converted using SIMD instructions when available,
+/// other sequences are validated according RFC 3629, ill-formed sequences
+/// (overlong, surrogates, truncated) are replaced by U+FFFD.
+///
+/// The destination buffer must be able to hold at least as many wide chars
+/// as the count of input bytes.
+///
+/// \param[out] dst     : Pointer to buffer that receives conversion result.
+/// \param[in]  src     : Pointer to UTF-8 data to convert.
+/// \param[in]  len     : Size of UTF-8 data in bytes.
+///
+/// \return Count of written UTF-16 codet.
+///
+static size_t __utf8_decode(wchar_t* dst, const uint8_t* src, size_t len)
+{
+  wchar_t* out = dst;
+  const uint8_t* end = src + len;
+
+  while(src < end) {
+
+    uint8_t c = src[0];
+
+    if(c < 0x80) {
+
+      #ifdef OM_STR_SIMD
+      #ifdef __AVX2__
+      while((end - src) >= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+        if(mask != 0) break;
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+        src += 32; out += 32;
+      }
+      #endif // __AVX2__
+      const __m128i zero = _mm_setzero_si128();
+      while((end - src) >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(v));
+        if(mask != 0) {
+          // convert leading ASCII bytes, then fall back to scalar
+          unsigned n = __ctz32(mask);
+          for(unsigned i = 0; i < n; ++i)
+            out[i] = src[i];
+          src += n; out += n;
+          break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(v, zero));
+        src += 16; out += 16;
+      }
+      #endif // OM_STR_SIMD
+
+      // remaining ASCII tail
+      while(src < end && src[0] < 0x80)
+        *out++ = *src++;
+
+      continue;
+    }
+
+    size_t avail = end - src;
+    uint32_t u;
+    unsigned n;
+
+    if(c >= 0xC2 && c <= 0xDF) { //< 2 bytes (110X XXXX)
+
+      if(avail < 2 || (src[1] & 0xC0) != 0x80) {
+        *out++ = 0xFFFD; src += 1; continue;
+      }
+
+      *out++ = static_cast<wchar_t>((c & 0x1F) << 6 | (src[1] & 0x3F));
+      src += 2;
+
+    } else if(c >= 0xE0 && c <= 0xEF) { //< 3 bytes (1110 XXXX)
+
+      // second byte range excludes overlong and surrogates
+      uint8_t lo = (c == 0xE0) ? 0xA0 : 0x80;
+      uint8_t hi = (c == 0xED) ? 0x9F : 0xBF;
+
+      n = 1;
+      if(avail > 1 && src[1] >= lo && src[1] <= hi) {
+        n = 2;
+        if(avail > 2 && (src[2] & 0xC0) == 0x80)
+          n = 3;
+      }
+
+      if(n < 3) {
+        *out++ = 0xFFFD; src += n; continue;
+      }
+
+      *out++ = static_cast<wchar_t>((c & 0x0F) << 12 | (src[1] & 0x3F) << 6 | (src[2] & 0x3F));
+      src += 3;
+
+    } else if(c >= 0xF0 && c <= 0xF4) { //< 4 bytes (1111 0XXX)
+
+      // second byte range excludes overlong and above U+10FFFF
+      uint8_t lo = (c == 0xF0) ? 0x90 : 0x80;
+      uint8_t hi = (c == 0xF4) ? 0x8F : 0xBF;
+
+      n = 1;
+      if(avail > 1 && src[1] >= lo && src[1] <= hi) {
+        n = 2;
+        if(avail > 2 && (src[2] & 0xC0) == 0x80) {
+          n = 3;
+          if(avail > 3 && (src[3] & 0xC0) == 0x80)
+            n = 4;
+        }
+      }
+
+      if(n < 4) {
+        *out++ = 0xFFFD; src += n; continue;
+      }
+
+      u = (c & 0x07) << 18 | (src[1] & 0x3F) << 12 | (src[2] & 0x3F) << 6 | (src[3] & 0x3F);
+      src += 4;
+
+      #if WCHAR_MAX > 0xFFFF
+      *out++ = static_cast<wchar_t>(u);
+      #else
+      u -= 0x10000;
+      *out++ = static_cast<wchar_t>(0xD800 + (u >> 10));
+      *out++ = static_cast<wchar_t>(0xDC00 + (u & 0x03FF));
+      #endif
+
+    } else { //< continuation or invalid lead byte
+
+      *out++ = 0xFFFD; src += 1;
+    }
+  }
+
+  return out - dst;
+}
+
+/// \brief UTF-8 encode
+///
+/// Static function to convert the given UTF-16 data into UTF-8 in a single
+/// pass. ASCII runs are converted using SIMD instructions when available,
+/// unpaired surrogates are replaced by U+FFFD.
+///
+/// The destination buffer must be able to hold at least three bytes per
+/// input wide char (four if wchar_t is 32-bit).
+///
+/// \param[out] dst     : Pointer to buffer that receives conversion result.
+/// \param[in]  src     : Pointer to UTF-16 data to convert.
+/// \param[in]  len     : Count of UTF-16 codet to convert.
+///
+/// \return Count of written bytes.
+///
+static size_t __utf8_encode(uint8_t* dst, const wchar_t* src, size_t len)
+{
+  uint8_t* out = dst;
+  const wchar_t* end = src + len;
+
+  while(src < end) {
+
+    uint32_t u = static_cast<uint32_t>(src[0]);
+
+    if(u < 0x80) {
+
+      #ifdef OM_STR_SIMD
+      const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+      const __m128i zero = _mm_setzero_si128();
+      while((end - src) >= 16) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+        __m128i t = _mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(v0, v1), high), zero);
+        if(_mm_movemask_epi8(t) != 0xFFFF) break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(v0, v1));
+        src += 16; out += 16;
+      }
+      #endif // OM_STR_SIMD
+
+      // remaining ASCII tail
+      while(src < end && static_cast<uint32_t>(src[0]) < 0x80)
+        *out++ = static_cast<uint8_t>(*src++);
+
+      continue;
+    }
+
+    src++;
+
+    if(u >= 0xD800 && u <= 0xDFFF) {
+      // surrogates pair
+      if(u <= 0xDBFF && src < end && src[0] >= 0xDC00 && src[0] <= 0xDFFF) {
+        u = 0x10000 + ((u - 0xD800) << 10) + (static_cast<uint32_t>(src[0]) - 0xDC00);
+        src++;
+      } else {
+        u = 0xFFFD; //< unpaired surrogate
+      }
+    }
+
+    if(u < 0x800) {
+      out[0] = static_cast<uint8_t>(0xC0 | (u >> 6));
+      out[1] = static_cast<uint8_t>(0x80 | (u & 0x3F));
+      out += 2;
+    } else if(u < 0x10000) {
+      out[0] = static_cast<uint8_t>(0xE0 | (u >> 12));
+      out[1] = static_cast<uint8_t>(0x80 | ((u >> 6) & 0x3F));
+      out[2] = static_cast<uint8_t>(0x80 | (u & 0x3F));
+      out += 3;
+    } else if(u < 0x110000) {
+      out[0] = static_cast<uint8_t>(0xF0 | (u >> 18));
+      out[1] = static_cast<uint8_t>(0x80 | ((u >> 12) & 0x3F));
+      out[2] = static_cast<uint8_t>(0x80 | ((u >> 6) & 0x3F));
+      out[3] = static_cast<uint8_t>(0x80 | (u & 0x3F));
+      out += 4;
+    } else {
+      out[0] = 0xEF; out[1] = 0xBF; out[2] = 0xBD; //< U+FFFD
+      out += 3;
+    }
+  }
+
+  return out - dst;
+}
+
+/// \brief UTF-8 to UTF-16 string
+///
+/// Static inlined function to convert the given UTF-8 data into wide char
+/// string, the string is sized once and shrunk to the result.
+///
+/// \param[out] pwcs    : Wide char string to receive conversion result.
+/// \param[in]  utf8    : Pointer to UTF-8 data to convert.
+/// \param[in]  len     : Size of UTF-8 data in bytes.
+///
+/// \return Count of written UTF-16 codet.
+///
+inline static size_t __utf8_to_wstr(OmWString* pwcs, const char* utf8, size_t len)
+{
+  // one byte produces at most one UTF-16 codet
+  pwcs->resize(len);
+  size_t n = __utf8_decode(&(*pwcs)[0], reinterpret_cast<const uint8_t*>(utf8), len);
+  pwcs->resize(n);
+  return n;
+}
+
+/// \brief UTF-16 to UTF-8 string
+///
+/// Static inlined function to convert the given wide char data into UTF-8
+/// string, the string is sized once and shrunk to the result.
+///
+/// \param[out] pstr    : Multibyte string to receive conversion result.
+/// \param[in]  wstr    : Pointer to wide char data to convert.
+/// \param[in]  len     : Count of wide char to convert.
+///
+/// \return Count of written bytes.
+///
+inline static size_t __wstr_to_utf8(OmCString* pstr, const wchar_t* wstr, size_t len)
+{
+  // one UTF-16 codet produces at most three bytes
+  #if WCHAR_MAX > 0xFFFF
+  pstr->resize(len * 4);
+  #else
+  pstr->resize(len * 3);
+  #endif
+  size_t n = __utf8_encode(reinterpret_cast<uint8_t*>(&(*pstr)[0]), wstr, len);
+  pstr->resize(n);
+  return n;
+}
+
+#ifndef _WIN32
+/// \brief UTF-16 to UTF-8 buffer
+///
+/// Static function to convert the given wide char string into null
+/// terminated UTF-8 string written to the given buffer. As WinAPI does,
+/// nothing is written if buffer is too small.
+///
+/// \param[out] buf     : Buffer to receive conversion result.
+/// \param[in]  len     : Size of buffer in bytes.
+/// \param[in]  wstr    : Wide char string to convert.
+///
+/// \return Count of written bytes including null char, or zero if buffer
+///         is too small.
+///
+static size_t __wstr_to_buf(char* buf, size_t len, const OmWString& wstr)
+{
+  OmCString str;
+  __wstr_to_utf8(&str, wstr.data(), wstr.size());
+
+  if(str.size() >= len)
+    return 0;
+
+  memcpy(buf, str.c_str(), str.size() + 1);
+
+  return str.size() + 1;
+}
+#endif // _WIN32
 
 /// \brief Encode data to UTF-16
 ///
@@ -315,9 +643,14 @@ static inline size_t __utf16_encode(OmWString* pwcs, const uint8_t* data, size_t
         pwcs->push_back(static_cast<wchar_t>(c[0]));
         off++; len++;
       } else if(u > 0xFFFF)  { //< 4 bytes unicode
+        #if WCHAR_MAX > 0xFFFF
+        pwcs->push_back(static_cast<wchar_t>(u));
+        len++;
+        #else
         pwcs->push_back(static_cast<wchar_t>(0xD800 + (u >> 10)));
         pwcs->push_back(static_cast<wchar_t>(0xDC00 + (u & 0x03FF)));
         len+=2;
+        #endif
       } else if(u < 0xD800 || u >= 0xE000) { //< 2 bytes unicode
         pwcs->push_back(static_cast<wchar_t>(u));
         len++;
@@ -337,7 +670,7 @@ static inline size_t __utf16_encode(OmWString* pwcs, const uint8_t* data, size_t
 ///
 size_t Om_toUTF16(OmWString* pwcs, const OmCString& utf8)
 {
-  return __multibyte_decode(CP_UTF8, pwcs, utf8.data());
+  return __utf8_to_wstr(pwcs, utf8.data(), utf8.size());
 }
 
 ///
@@ -345,7 +678,7 @@ size_t Om_toUTF16(OmWString* pwcs, const OmCString& utf8)
 ///
 size_t Om_toUTF16(OmWString* pwcs, const char* utf8)
 {
-  return __multibyte_decode(CP_UTF8, pwcs, utf8);
+  return __utf8_to_wstr(pwcs, utf8, strlen(utf8));
 }
 
 ///
@@ -354,7 +687,7 @@ size_t Om_toUTF16(OmWString* pwcs, const char* utf8)
 OmWString Om_toUTF16(const OmCString& utf8)
 {
   OmWString result;
-  __multibyte_decode(CP_UTF8, &result, utf8.data());
+  __utf8_to_wstr(&result, utf8.data(), utf8.size());
   return result;
 }
 
@@ -364,7 +697,7 @@ OmWString Om_toUTF16(const OmCString& utf8)
 OmWString Om_toUTF16(const char* utf8)
 {
   OmWString result;
-  __multibyte_decode(CP_UTF8, &result, utf8);
+  __utf8_to_wstr(&result, utf8, strlen(utf8));
   return result;
 }
 
@@ -394,25 +727,20 @@ size_t Om_loadToUTF16(OmWString* result, const OmWString& path)
   size_t len = 0;
 
   // open file for reading
-  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, 0, nullptr, OPEN_EXISTING,
-                              FILE_ATTRIBUTE_NORMAL, nullptr);
-
-  if(hFile == INVALID_HANDLE_VALUE)
+  void* hfile = Om_pltFileOpen(path, OM_PLT_FILE_READ|OM_PLT_FILE_EXCL);
+  if(!hfile)
     return len;
 
   uint8_t read_buf[READ_BUF_SIZE];
-  DWORD rb;
-
-  while(ReadFile(hFile, read_buf, READ_BUF_SIZE, &rb, nullptr)) {
+  int64_t rb;
 
-    if(rb == 0)
-      break;
+  while((rb = Om_pltFileRead(hfile, read_buf, READ_BUF_SIZE)) > 0) {
 
     // guess encoding then convert to UTF-16
     len += __utf16_encode(result, read_buf, rb);
   }
 
-  CloseHandle(hFile);
+  Om_pltFileClose(hfile);
 
   return len;
 }
@@ -422,9 +750,13 @@ size_t Om_loadToUTF16(OmWString* result, const OmWString& path)
 ///
 size_t Om_toUTF8(char* utf8, size_t len, const OmWString& wstr)
 {
+  #ifdef _WIN32
   // The WinAPI implementation is the fastest one at this time
   int n = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, utf8, len, nullptr, nullptr);
   return (n > 0) ? static_cast<size_t>(n) : 0;
+  #else
+  return __wstr_to_buf(utf8, len, wstr);
+  #endif
 }
 
 
@@ -434,7 +766,7 @@ size_t Om_toUTF8(char* utf8, size_t len, const OmWString& wstr)
 OmCString Om_toUTF8(const OmWString& wstr)
 {
   OmCString result;
-  __multibyte_encode(CP_UTF8, &result, wstr.c_str());
+  __wstr_to_utf8(&result, wstr.data(), wstr.size());
   return result;
 }
 
@@ -444,7 +776,7 @@ OmCString Om_toUTF8(const OmWString& wstr)
 ///
 size_t Om_toUTF8(OmCString* utf8, const OmWString& wstr)
 {
-  return __multibyte_encode(CP_UTF8, utf8, wstr.c_str());
+  return __wstr_to_utf8(utf8, wstr.data(), wstr.size());
 }
 
 
@@ -453,9 +785,14 @@ size_t Om_toUTF8(OmCString* utf8, const OmWString& wstr)
 ///
 size_t Om_toANSI(char* ansi, size_t len, const OmWString& wstr)
 {
+  #ifdef _WIN32
   // The WinAPI implementation is the fastest one at this time
   int n = WideCharToMultiByte(CP_ACP, 0, wstr.c_str(), -1, ansi, len, nullptr, nullptr);
   return (n > 0) ? static_cast<size_t>(n) : 0;
+  #else
+  // system encoding is assumed to be UTF-8
+  return __wstr_to_buf(ansi, len, wstr);
+  #endif
 }
 
 
@@ -464,7 +801,12 @@ size_t Om_toANSI(char* ansi, size_t len, const OmWString& wstr)
 ///
 size_t Om_toANSI(OmCString* ansi, const OmWString& wstr)
 {
+  #ifdef _WIN32
   return __multibyte_encode(CP_ACP, ansi, wstr.c_str());
+  #else
+  // system encoding is assumed to be UTF-8
+  return __wstr_to_utf8(ansi, wstr.data(), wstr.size()) + 1;
+  #endif
 }
 
 
@@ -473,7 +815,12 @@ size_t Om_toANSI(OmCString* ansi, const OmWString& wstr)
 ///
 size_t Om_fromAnsiCp(OmWString* wstr, const char* ansi)
 {
+  #ifdef _WIN32
   return __multibyte_decode(CP_ACP, wstr, ansi);
+  #else
+  // system encoding is assumed to be UTF-8
+  return __utf8_to_wstr(wstr, ansi, strlen(ansi)) + 1;
+  #endif
 }
 
 
@@ -482,10 +829,14 @@ size_t Om_fromAnsiCp(OmWString* wstr, const char* ansi)
 ///
 size_t Om_toZipCDR(char* cdr, size_t len, const OmWString& wstr)
 {
+  #ifdef _WIN32
   // The WinAPI implementation is the fastest one at this time
   int n = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, cdr, len, nullptr, nullptr);
+  #else
+  int n = __wstr_to_buf(cdr, len, wstr);
+  #endif
 
-  for(size_t i = 0; cdr[i] != 0; ++i) {
+  for(size_t i = 0; n > 0 && cdr[i] != 0; ++i) {
     if(cdr[i] == '\\') cdr[i] = '/';
   }
 
@@ -503,7 +854,7 @@ size_t Om_toZipCDR(OmCString* cdr, const OmWString& wstr)
   if(c_wstr[0] == L'/' || c_wstr[0] == L'\\')
     c_wstr += 1;
 
-  __multibyte_encode(CP_UTF8, cdr, c_wstr);
+  __wstr_to_utf8(cdr, c_wstr, wcslen(c_wstr));
 
   std::replace(cdr->begin(), cdr->end(), '\\', '/');
 
@@ -515,7 +866,7 @@ size_t Om_toZipCDR(OmCString* cdr, const OmWString& wstr)
 ///
 size_t Om_fromZipCDR(OmWString* wstr, const char* cdr)
 {
-  __multibyte_decode(CP_UTF8, wstr, cdr);
+  __utf8_to_wstr(wstr, cdr, strlen(cdr));
 
   std::replace(wstr->begin(), wstr->end(), L'/', L'\\');
 
@@ -700,19 +1051,16 @@ bool Om_hasIllegalUrlChar(const OmWString& path)
 void Om_urlEscape(OmCString* esc, const OmWString& url)
 {
   // convert to UTF-8
-  int32_t mb_len = WideCharToMultiByte(CP_UTF8, 0, url.c_str(), -1, nullptr, 0, nullptr, nullptr);
+  OmCString mb_str;
+  int32_t mb_len = __wstr_to_utf8(&mb_str, url.data(), url.size());
   if(mb_len > 0) {
 
-    char* mb_buf = static_cast<char*>(Om_alloc(mb_len));
-
-    WideCharToMultiByte(CP_UTF8, 0, url.c_str(), -1, mb_buf, mb_len, nullptr, nullptr);
+    const char* mb_buf = mb_str.c_str();
 
     // set capacity for target string
     esc->clear();
     esc->reserve(mb_len * 2);
 
-    mb_len--; //< reduce to string length without nullchar
-
     for(int32_t i = 0; i < mb_len; ++i) {
 
       uint8_t c = mb_buf[i];
@@ -734,8 +1082,6 @@ void Om_urlEscape(OmCString* esc, const OmWString& url)
       if(!is_escaped)
         esc->push_back(c);
     }
-
-    Om_free(mb_buf);
   }
 }
 
@@ -1093,8 +1439,14 @@ void Om_formatSizeSysStr(OmWString* dest, int64_t bytes)
 {
   wchar_t buf[32];
 
+  #ifdef _WIN32
   if(StrFormatKBSizeW(bytes, buf, 32))
     dest->assign(buf);
+  #else
+  // same format as Windows Explorer, rounded up to next KB
+  swprintf(buf, 32, L"%lld KB", static_cast<long long>((bytes + 1023) / 1024));
+  dest->assign(buf);
+  #endif
 }
 
 ///
@@ -1106,8 +1458,14 @@ OmWString Om_formatSizeSysStr(int64_t bytes)
 
   wchar_t buf[32];
 
+  #ifdef _WIN32
   if(StrFormatKBSizeW(bytes, buf, 32))
     result.assign(buf);
+  #else
+  // same format as Windows Explorer, rounded up to next KB
+  swprintf(buf, 32, L"%lld KB", static_cast<long long>((bytes + 1023) / 1024));
+  result.assign(buf);
+  #endif
 
   return result;
 }
@@ -0,0 +1,163 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
+
+#include "OmUtilPlt.h"
+
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmUtilThd.h"
+
+/// \brief Maximum worker threads
+///
+/// Maximum count of worker threads for a single parallel for loop
+///
+#define PFOR_MAX_WORKERS    64
+
+/// \brief Worker thread marker
+///
+/// Set while the current thread processes parallel for items, loops
+/// started by jobs are then processed by the current thread alone instead
+/// of starting workers on top of already busy ones.
+///
+static thread_local bool __pfor_in_worker = false;
+
+/// \brief Parallel for shared context
+///
+/// Structure shared by all workers of a parallel for loop
+///
+typedef struct {
+
+  Om_jobCb          job_cb;
+
+  void*             user_ptr;
+
+  size_t            count;
+
+  volatile int64_t  next;
+
+  volatile int32_t  abort;
+
+} __pfor_ctx_t;
+
+/// \brief Parallel for worker parameters
+///
+/// Structure passed to each parallel for worker thread
+///
+typedef struct {
+
+  __pfor_ctx_t*     ctx;
+
+  unsigned          worker;
+
+} __pfor_wrk_t;
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static uint32_t __pfor_run_fn(void* ptr)
+{
+  __pfor_wrk_t* wrk = static_cast<__pfor_wrk_t*>(ptr);
+  __pfor_ctx_t* ctx = wrk->ctx;
+
+  // caller thread may already be a worker of an enclosing loop
+  bool in_worker = __pfor_in_worker;
+  __pfor_in_worker = true;
+
+  while(!ctx->abort) {
+
+    // fetch next item to process
+    size_t i = static_cast<size_t>(Om_pltAtomicInc(&ctx->next) - 1);
+    if(i >= ctx->count)
+      break;
+
+    if(!ctx->job_cb(ctx->user_ptr, i, wrk->worker))
+      Om_pltAtomicSet(&ctx->abort, 1);
+  }
+
+  __pfor_in_worker = in_worker;
+
+  return 0;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+unsigned Om_cpuCount()
+{
+  return Om_pltCpuCount();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+unsigned Om_workerCount(size_t count, unsigned threads)
+{
+  // nested loop runs on the worker which started it
+  if(__pfor_in_worker)
+    return 1;
+
+  if(threads == 0)
+    threads = Om_cpuCount();
+
+  if(threads > PFOR_MAX_WORKERS)
+    threads = PFOR_MAX_WORKERS;
+
+  if(count < threads)
+    threads = static_cast<unsigned>(count);
+
+  return (threads > 0) ? threads : 1;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_parallelFor(size_t count, Om_jobCb job_cb, void* user_ptr, unsigned threads)
+{
+  if(!count)
+    return true;
+
+  __pfor_ctx_t ctx;
+  ctx.job_cb = job_cb;
+  ctx.user_ptr = user_ptr;
+  ctx.count = count;
+  ctx.next = 0;
+  ctx.abort = 0;
+
+  unsigned n = Om_workerCount(count, threads);
+
+  __pfor_wrk_t wrk[PFOR_MAX_WORKERS];
+  void* hth[PFOR_MAX_WORKERS];
+
+  // the first worker is the calling thread itself
+  unsigned started = 0;
+  for(unsigned w = 1; w < n; ++w) {
+    wrk[started].ctx = &ctx;
+    wrk[started].worker = w;
+    hth[started] = Om_pltThreadCreate(__pfor_run_fn, &wrk[started]);
+    if(hth[started]) started++; //< if thread creation fail, remaining workers will do the job
+  }
+
+  __pfor_wrk_t self;
+  self.ctx = &ctx;
+  self.worker = 0;
+  __pfor_run_fn(&self);
+
+  for(unsigned i = 0; i < started; ++i)
+    Om_pltThreadJoin(hth[i]);
+
+  return (ctx.abort == 0);
+}
@@ -100,14 +100,12 @@ OmVersion::OmVersion(const OmWString& vstr) :
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 OmVersion::OmVersion(const OmVersion& other) :
-  _str(),
+  _str(other._str),
   _maj(other._maj),
   _min(other._min),
   _rev(other._rev)
 {
-  for(size_t i = 0; i < other._str.size(); ++i) {
-    _str.push_back(other._str[i]);
-  }
+
 }
 
 
@@ -125,7 +123,7 @@ OmVersion::~OmVersion()
 ///
 bool OmVersion::parse(const OmWString& vstr)
 {
-  wchar_t num[32];
+  uint64_t num[3] = {};
 
   _maj = 0;
   _min = 0;
@@ -133,50 +131,45 @@ bool OmVersion::parse(const OmWString& vstr)
 
   _str.clear();
 
-  unsigned j = 0;
+  // numbers are accumulated while digits are copied to string
+  unsigned n = 0, j = 0;
   for(size_t i = 0; i < vstr.size(); ++i) {
 
     if(vstr[i] > 47 && vstr[i] < 58) { // 0123456789
 
       if(j < 15) {
-        num[j] = vstr[i]; ++j;
+        if(j == 0 && n > 0) _str.push_back(L'.');
+        _str.push_back(vstr[i]);
+        num[n] = num[n] * 10 + (vstr[i] - 48); ++j;
       } else {
+        _str.clear();
         return false;
       }
 
     } else {
 
       if(vstr[i] == L'.' || vstr[i] == L'*') {
-        // add last gathered number
+        // close last gathered number
         if(j > 0) {
-          num[j] = L'\0';
-          _str.push_back(num);
-          j = 0;
+          ++n; j = 0;
         }
       }
 
-      if(_str.size() > 2)
+      if(n > 2)
         break;
     }
   }
 
-  if(j > 0 && _str.size() < 3) {
-    num[j] = 0; _str.push_back(num);
-  }
-
-  if(_str.size() > 0) {
-
-    _maj = wcstoul(_str[0].c_str(), nullptr, 10);
+  if(j > 0 && n < 3)
+    ++n;
 
-    if(_str.size() > 1) {
+  if(n > 0) {
 
-      _min = wcstoul(_str[1].c_str(), nullptr, 10);
+    // saturate as string to integer conversion does
+    _maj = (num[0] > 0xFFFFFFFF) ? 0xFFFFFFFF : static_cast<uint32_t>(num[0]);
+    _min = (num[1] > 0xFFFFFFFF) ? 0xFFFFFFFF : static_cast<uint32_t>(num[1]);
+    _rev = (num[2] > 0xFFFFFFFF) ? 0xFFFFFFFF : static_cast<uint32_t>(num[2]);
 
-      if(_str.size() > 2) {
-
-        _rev = wcstoul(_str[2].c_str(), nullptr, 10);
-      }
-    }
     return true;
   }
 
@@ -199,17 +192,17 @@ void OmVersion::define(uint32_t major, uint32_t minor, uint32_t revis)
 
   if(_maj > 0) {
     swprintf(wcbuf, 32, L"%u", _maj);
-    _str.push_back(wcbuf);
+    _str.append(wcbuf);
   }
 
   if(_min > 0) {
-    swprintf(wcbuf, 32, L"%u", _min);
-    _str.push_back(wcbuf);
+    swprintf(wcbuf, 32, _str.empty() ? L"%u" : L".%u", _min);
+    _str.append(wcbuf);
   }
 
   if(_rev > 0) {
-    swprintf(wcbuf, 32, L"%u", _rev);
-    _str.push_back(wcbuf);
+    swprintf(wcbuf, 32, _str.empty() ? L"%u" : L".%u", _rev);
+    _str.append(wcbuf);
   }
 }
 
@@ -223,9 +216,7 @@ OmVersion& OmVersion::operator=(const OmVersion& other)
   _min = other._min;
   _rev = other._rev;
 
-  for(size_t i = 0; i < other._str.size(); ++i) {
-    _str.push_back(other._str[i]);
-  }
+  _str = other._str;
 
   return *this;
 }
@@ -245,136 +236,71 @@ OmVersion& OmVersion::operator=(const OmWString& vstr)
 ///
 OmWString OmVersion::asString() const
 {
-  OmWString ret;
-
-  if(_str.size() > 0) {
-    ret = _str[0];
-    if(_str.size() > 1) {
-      ret += L"."; ret += _str[1];
-      if(_str.size() > 2) {
-        ret += L"."; ret += _str[2];
-      }
-    }
-  } else {
-    ret = L"N/A";
-  }
+  if(_str.empty())
+    return OmWString(L"N/A");
 
-  return ret;
+  return _str;
 }
 
-
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmVersion::operator<(const OmVersion& other) const
+bool OmVersion::match(const OmWString& filter) const
 {
-  if(_maj < other._maj) {
-    return true;
-  } else if(_maj == other._maj) {
-    if(_min < other._min) {
-      return true;
-    } else if(_min == other._min) {
-      if(_rev < other._rev) {
-        return true;
-      } else {
-        return false;
-      }
-    }
-  }
-  return false;
+  return OmVersionFilter(filter).match(*this);
 }
 
-
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmVersion::operator>(const OmVersion& other) const
+void OmVersion::clear()
 {
-  if(_maj > other._maj) {
-    return true;
-  } else if(_maj == other._maj) {
-    if(_min > other._min) {
-      return true;
-    } else if(_min == other._min) {
-      if(_rev > other._rev) {
-        return true;
-      } else {
-        return false;
-      }
-    }
-  }
-  return false;
+  _str.clear();
+  _maj = 0;
+  _min = 0;
+  _rev = 0;
 }
 
-
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmVersion::operator<=(const OmVersion& other) const
+OmVersionFilter::OmVersionFilter() :
+  _maj(0), _min(0), _rev(0),
+  _maj_mask(0), _min_mask(0), _rev_mask(0),
+  _valid(false)
 {
-  if(_maj == other._maj && _min == other._min && _rev == other._rev) {
-    return true;
-  } else {
-    if(_maj < other._maj) {
-      return true;
-    } else if(_maj == other._maj) {
-      if(_min < other._min) {
-        return true;
-      } else if(_min == other._min) {
-        if(_rev < other._rev) {
-          return true;
-        } else {
-          return false;
-        }
-      }
-    }
-  }
-  return false;
-}
 
+}
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmVersion::operator>=(const OmVersion& other) const
+OmVersionFilter::OmVersionFilter(const OmWString& str) :
+  _maj(0), _min(0), _rev(0),
+  _maj_mask(0), _min_mask(0), _rev_mask(0),
+  _valid(false)
 {
-  if(_maj == other._maj && _min == other._min && _rev == other._rev) {
-    return true;
-  } else {
-    if(_maj > other._maj) {
-      return true;
-    } else if(_maj == other._maj) {
-      if(_min > other._min) {
-        return true;
-      } else if(_min == other._min) {
-        if(_rev > other._rev) {
-          return true;
-        } else {
-          return false;
-        }
-      }
-    }
-  }
-  return false;
+  this->parse(str);
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmVersion::match(const OmWString& filter) const
+bool OmVersionFilter::parse(const OmWString& str)
 {
   int32_t major, minor, revis;
 
-  __parse_filter(filter, &major, &minor, &revis);
+  this->clear();
 
-  if((major >= 0) && ((int32_t)_maj != major))
-      return false;
+  if(!__parse_filter(str, &major, &minor, &revis))
+    return false;
 
-  if((minor >= 0) && ((int32_t)_min != minor))
-      return false;
+  // negative value is wildcard, the component is masked out
+  _maj = static_cast<uint32_t>(major); _maj_mask = (major >= 0) ? 0xFFFFFFFF : 0;
+  _min = static_cast<uint32_t>(minor); _min_mask = (minor >= 0) ? 0xFFFFFFFF : 0;
+  _rev = static_cast<uint32_t>(revis); _rev_mask = (revis >= 0) ? 0xFFFFFFFF : 0;
 
-  if((revis >= 0) && ((int32_t)_rev != revis))
-      return false;
+  _valid = true;
 
   return true;
 }
@@ -382,10 +308,9 @@ bool OmVersion::match(const OmWString& filter) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmVersion::clear()
+void OmVersionFilter::clear()
 {
-  _str.clear();
-  _maj = 0;
-  _min = 0;
-  _rev = 0;
+  _maj = _min = _rev = 0;
+  _maj_mask = _min_mask = _rev_mask = 0;
+  _valid = false;
 }
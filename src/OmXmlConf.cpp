@@ -14,6 +14,10 @@
   You should have received a copy of the GNU General Public License
   along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
 */
+#include "OmBase.h"
+
+#include "OmUtilPlt.h"
+
 #include "pugixml/pugixml.hpp"
 
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
@@ -24,18 +28,44 @@
 
 #define PUGI_NODE(x) static_cast<pugi::xml_node*>(x)
 
+#define PUGI_XNODE(x) pugi::xml_node(static_cast<pugi::xml_node_struct*>(x))
+
 /// \brief Hexadecimal digits
 ///
 /// Static translation string to convert integer value to hexadecimal digit.
 ///
 static const wchar_t __hex_digit[] = L"0123456789abcdef";
 
+/// \brief Document lock scope
+///
+/// Helper object to hold the owner document lock, if any, for the duration
+/// of its scope, so write-behind thread never snapshots a document being
+/// modified.
+///
+class __doc_lock
+{
+  public:
+
+    __doc_lock(void* lock) : _lock(lock) {
+      if(this->_lock) Om_pltLockEnter(this->_lock);
+    }
+
+    ~__doc_lock() {
+      if(this->_lock) Om_pltLockLeave(this->_lock);
+    }
+
+  private:
+
+    void*   _lock;
+};
+
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 OmXmlNode::OmXmlNode() :
-  _node(new pugi::xml_node)
+  _node(nullptr),
+  _lock(nullptr)
 {
 
 }
@@ -44,49 +74,45 @@ OmXmlNode::OmXmlNode() :
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmXmlNode::OmXmlNode(const OmXmlNode& other) :
-  _node(new pugi::xml_node)
-{
-  *PUGI_NODE(_node) = *PUGI_NODE(other._node);
-}
-
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-OmXmlNode::~OmXmlNode()
+bool OmXmlNode::empty() const
 {
-  delete PUGI_NODE(_node);
+  return PUGI_XNODE(_node).empty();
 }
 
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmXmlNode& OmXmlNode::operator=(const OmXmlNode& other)
+OmXmlNode OmXmlNode::parent() const
 {
-  *PUGI_NODE(_node) = *PUGI_NODE(other._node);
-  return *this;
+  OmXmlNode parent;
+  parent._node = PUGI_XNODE(_node).parent().internal_object();
+  parent._lock = _lock;
+  return parent;
 }
 
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmXmlNode::empty() const
+OmXmlNode OmXmlNode::next() const
 {
-  return PUGI_NODE(_node)->empty();
+  OmXmlNode result;
+  result._node = PUGI_XNODE(_node).next_sibling().internal_object();
+  result._lock = _lock;
+  return result;
 }
 
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmXmlNode OmXmlNode::parent() const
+OmXmlNode OmXmlNode::next(const OmWString& name) const
 {
-  OmXmlNode parent;
-  *PUGI_NODE(parent._node) = PUGI_NODE(_node)->parent();
-  return parent;
+  OmXmlNode result;
+  result._node = PUGI_XNODE(_node).next_sibling(name.c_str()).internal_object();
+  result._lock = _lock;
+  return result;
 }
 
 
@@ -95,7 +121,7 @@ OmXmlNode OmXmlNode::parent() const
 ///
 const wchar_t* OmXmlNode::name() const
 {
-  return PUGI_NODE(_node)->name();
+  return PUGI_XNODE(_node).name();
 }
 
 
@@ -104,7 +130,7 @@ const wchar_t* OmXmlNode::name() const
 ///
 const wchar_t* OmXmlNode::content() const
 {
-  return PUGI_NODE(_node)->child_value();
+  return PUGI_XNODE(_node).child_value();
 }
 
 
@@ -113,7 +139,7 @@ const wchar_t* OmXmlNode::content() const
 ///
 bool OmXmlNode::hasAttr(const OmWString& attr) const
 {
-  return !(PUGI_NODE(_node)->attribute(attr.c_str()).empty());
+  return !(PUGI_XNODE(_node).attribute(attr.c_str()).empty());
 }
 
 
@@ -122,7 +148,7 @@ bool OmXmlNode::hasAttr(const OmWString& attr) const
 ///
 const wchar_t* OmXmlNode::attrAsString(const OmWString& attr) const
 {
-  return PUGI_NODE(_node)->attribute(attr.c_str()).value();
+  return PUGI_XNODE(_node).attribute(attr.c_str()).value();
 }
 
 
@@ -131,7 +157,7 @@ const wchar_t* OmXmlNode::attrAsString(const OmWString& attr) const
 ///
 int OmXmlNode::attrAsInt(const OmWString& attr) const
 {
-  return PUGI_NODE(_node)->attribute(attr.c_str()).as_int();
+  return PUGI_XNODE(_node).attribute(attr.c_str()).as_int();
 }
 
 
@@ -140,7 +166,7 @@ int OmXmlNode::attrAsInt(const OmWString& attr) const
 ///
 float OmXmlNode::attrAsFloat(const OmWString& attr) const
 {
-  return PUGI_NODE(_node)->attribute(attr.c_str()).as_float();
+  return PUGI_XNODE(_node).attribute(attr.c_str()).as_float();
 }
 
 
@@ -149,7 +175,7 @@ float OmXmlNode::attrAsFloat(const OmWString& attr) const
 ///
 double OmXmlNode::attrAsDouble(const OmWString& attr) const
 {
-  return PUGI_NODE(_node)->attribute(attr.c_str()).as_double();
+  return PUGI_XNODE(_node).attribute(attr.c_str()).as_double();
 }
 
 
@@ -158,12 +184,12 @@ double OmXmlNode::attrAsDouble(const OmWString& attr) const
 ///
 uint64_t OmXmlNode::attrAsUint64(const OmWString& attr) const
 {
-  return PUGI_NODE(_node)->attribute(attr.c_str()).as_ullong();
+  return PUGI_XNODE(_node).attribute(attr.c_str()).as_ullong();
 }
 /*
 uint64_t OmXmlNode::attrAsUint64(const OmWString& attr, int base) const
 {
-  return wcstoull(PUGI_NODE(_node)->attribute(attr.c_str()).value(), nullptr, base);
+  return wcstoull(PUGI_XNODE(_node).attribute(attr.c_str()).value(), nullptr, base);
 }
 */
 
@@ -172,7 +198,9 @@ uint64_t OmXmlNode::attrAsUint64(const OmWString& attr, int base) const
 ///
 void OmXmlNode::setName(const OmWString& value)
 {
-  PUGI_NODE(_node)->set_name(value.c_str());
+  __doc_lock lock(_lock);
+
+  PUGI_XNODE(_node).set_name(value.c_str());
 }
 
 
@@ -181,10 +209,12 @@ void OmXmlNode::setName(const OmWString& value)
 ///
 void OmXmlNode::setContent(const OmWString& value)
 {
-  if(PUGI_NODE(_node)->first_child().type() == pugi::node_pcdata) {
-    PUGI_NODE(_node)->first_child().set_value(value.c_str());
+  __doc_lock lock(_lock);
+
+  if(PUGI_XNODE(_node).first_child().type() == pugi::node_pcdata) {
+    PUGI_XNODE(_node).first_child().set_value(value.c_str());
   } else {
-    PUGI_NODE(_node)->append_child(pugi::node_pcdata).set_value(value.c_str());
+    PUGI_XNODE(_node).append_child(pugi::node_pcdata).set_value(value.c_str());
   }
 }
 
@@ -194,9 +224,11 @@ void OmXmlNode::setContent(const OmWString& value)
 ///
 void OmXmlNode::setAttr(const OmWString& attr, const OmWString& value)
 {
-  pugi::xml_attribute attribute = PUGI_NODE(_node)->attribute(attr.c_str());
+  __doc_lock lock(_lock);
+
+  pugi::xml_attribute attribute = PUGI_XNODE(_node).attribute(attr.c_str());
   if(attribute.empty()) {
-    attribute = PUGI_NODE(_node)->append_attribute(attr.c_str());
+    attribute = PUGI_XNODE(_node).append_attribute(attr.c_str());
   }
   attribute.set_value(value.c_str());
 }
@@ -207,9 +239,11 @@ void OmXmlNode::setAttr(const OmWString& attr, const OmWString& value)
 ///
 void OmXmlNode::setAttr(const OmWString& attr, int value)
 {
-  pugi::xml_attribute attribute = PUGI_NODE(_node)->attribute(attr.c_str());
+  __doc_lock lock(_lock);
+
+  pugi::xml_attribute attribute = PUGI_XNODE(_node).attribute(attr.c_str());
   if(attribute.empty()) {
-    attribute = PUGI_NODE(_node)->append_attribute(attr.c_str());
+    attribute = PUGI_XNODE(_node).append_attribute(attr.c_str());
   }
   attribute.set_value(value);
 }
@@ -219,9 +253,11 @@ void OmXmlNode::setAttr(const OmWString& attr, int value)
 ///
 void OmXmlNode::setAttr(const OmWString& attr, float value)
 {
-  pugi::xml_attribute attribute = PUGI_NODE(_node)->attribute(attr.c_str());
+  __doc_lock lock(_lock);
+
+  pugi::xml_attribute attribute = PUGI_XNODE(_node).attribute(attr.c_str());
   if(attribute.empty()) {
-    attribute = PUGI_NODE(_node)->append_attribute(attr.c_str());
+    attribute = PUGI_XNODE(_node).append_attribute(attr.c_str());
   }
   attribute.set_value(value);
 }
@@ -232,9 +268,11 @@ void OmXmlNode::setAttr(const OmWString& attr, float value)
 ///
 void OmXmlNode::setAttr(const OmWString& attr, double value)
 {
-  pugi::xml_attribute attribute = PUGI_NODE(_node)->attribute(attr.c_str());
+  __doc_lock lock(_lock);
+
+  pugi::xml_attribute attribute = PUGI_XNODE(_node).attribute(attr.c_str());
   if(attribute.empty()) {
-    attribute = PUGI_NODE(_node)->append_attribute(attr.c_str());
+    attribute = PUGI_XNODE(_node).append_attribute(attr.c_str());
   }
   attribute.set_value(value);
 }
@@ -245,9 +283,11 @@ void OmXmlNode::setAttr(const OmWString& attr, double value)
 ///
 void OmXmlNode::setAttr(const OmWString& attr, uint64_t value)
 {
-  pugi::xml_attribute attribute = PUGI_NODE(_node)->attribute(attr.c_str());
+  __doc_lock lock(_lock);
+
+  pugi::xml_attribute attribute = PUGI_XNODE(_node).attribute(attr.c_str());
   if(attribute.empty()) {
-    attribute = PUGI_NODE(_node)->append_attribute(attr.c_str());
+    attribute = PUGI_XNODE(_node).append_attribute(attr.c_str());
   }
   attribute.set_value(value);
 }
@@ -259,9 +299,9 @@ void OmXmlNode::setAttr(const OmWString& attr, uint64_t value)
 /*
 void OmXmlNode::setAttr(const OmWString& attr, uint64_t value)
 {
-  pugi::xml_attribute attribute = PUGI_NODE(_node)->attribute(attr.c_str());
+  pugi::xml_attribute attribute = PUGI_XNODE(_node).attribute(attr.c_str());
   if(attribute.empty()) {
-    attribute = PUGI_NODE(_node)->append_attribute(attr.c_str());
+    attribute = PUGI_XNODE(_node).append_attribute(attr.c_str());
   }
 
   wchar_t buf[17];
@@ -286,7 +326,9 @@ void OmXmlNode::setAttr(const OmWString& attr, uint64_t value)
 ///
 bool OmXmlNode::remAttr(const OmWString& attr)
 {
-  return PUGI_NODE(_node)->remove_attribute(attr.c_str());
+  __doc_lock lock(_lock);
+
+  return PUGI_XNODE(_node).remove_attribute(attr.c_str());
 }
 
 
@@ -296,7 +338,7 @@ bool OmXmlNode::remAttr(const OmWString& attr)
 unsigned OmXmlNode::childCount() const
 {
   unsigned n = 0;
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
+  for(pugi::xml_node child = PUGI_XNODE(_node).first_child(); child; child = child.next_sibling()) {
     ++n;
   }
   return n;
@@ -310,9 +352,10 @@ OmXmlNode OmXmlNode::child(unsigned i) const
 {
   OmXmlNode result;
   unsigned n = 0;
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
+  for(pugi::xml_node child = PUGI_XNODE(_node).first_child(); child; child = child.next_sibling()) {
     if(n == i) {
-      *PUGI_NODE(result._node) = child;
+      result._node = child.internal_object();
+      result._lock = _lock;
       return result;
     }
     ++n;
@@ -324,16 +367,12 @@ OmXmlNode OmXmlNode::child(unsigned i) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmXmlNodeArray OmXmlNode::children() const
+OmXmlNodeRange OmXmlNode::children() const
 {
-  OmXmlNodeArray result;
-
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
-    OmXmlNode node;
-    *PUGI_NODE(node._node) = child;
-    result.push_back(node);
-  }
-  return result;
+  OmXmlNode first;
+  first._node = PUGI_XNODE(_node).first_child().internal_object();
+  first._lock = _lock;
+  return OmXmlNodeRange(first, nullptr);
 }
 
 
@@ -343,9 +382,10 @@ OmXmlNodeArray OmXmlNode::children() const
 void OmXmlNode::children(OmXmlNodeArray& result) const
 {
   result.clear();
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
+  for(pugi::xml_node child = PUGI_XNODE(_node).first_child(); child; child = child.next_sibling()) {
     OmXmlNode node;
-    *PUGI_NODE(node._node) = child;
+    node._node = child.internal_object();
+    node._lock = _lock;
     result.push_back(node);
   }
 }
@@ -356,7 +396,7 @@ void OmXmlNode::children(OmXmlNodeArray& result) const
 ///
 bool OmXmlNode::hasChild(const OmWString& name) const
 {
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
+  for(pugi::xml_node child = PUGI_XNODE(_node).first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       return true;
     }
@@ -372,7 +412,7 @@ bool OmXmlNode::hasChild(const OmWString& name, const OmWString& attr, const OmW
 {
   pugi::xml_attribute xml_attr;
 
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
+  for(pugi::xml_node child = PUGI_XNODE(_node).first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       xml_attr = child.attribute(attr.c_str());
       if(!xml_attr.empty()) {
@@ -392,7 +432,7 @@ bool OmXmlNode::hasChild(const OmWString& name, const OmWString& attr, const OmW
 unsigned OmXmlNode::childCount(const OmWString& name) const
 {
   unsigned n = 0;
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
+  for(pugi::xml_node child = PUGI_XNODE(_node).first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       ++n;
     }
@@ -409,10 +449,11 @@ OmXmlNode OmXmlNode::child(const OmWString& name, unsigned i) const
   OmXmlNode result;
 
   unsigned n = 0;
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
+  for(pugi::xml_node child = PUGI_XNODE(_node).first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       if(n == i) {
-        *PUGI_NODE(result._node) = child;
+        result._node = child.internal_object();
+        result._lock = _lock;
         return result;
       }
       ++n;
@@ -433,12 +474,13 @@ OmXmlNode OmXmlNode::child(const OmWString& name, const OmWString& attr, const O
 
   pugi::xml_attribute xml_attr;
 
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
+  for(pugi::xml_node child = PUGI_XNODE(_node).first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       xml_attr = child.attribute(attr.c_str());
       if(!xml_attr.empty()) {
         if(!wcscmp(value.c_str(), xml_attr.as_string())) {
-          *PUGI_NODE(result._node) = child;
+          result._node = child.internal_object();
+          result._lock = _lock;
           return result;
         }
       }
@@ -452,18 +494,12 @@ OmXmlNode OmXmlNode::child(const OmWString& name, const OmWString& attr, const O
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmXmlNodeArray OmXmlNode::children(const OmWString& name) const
+OmXmlNodeRange OmXmlNode::children(const wchar_t* name) const
 {
-  OmXmlNodeArray result;
-
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
-    if(!wcscmp(name.c_str(), child.name())) {
-      OmXmlNode node;
-      *PUGI_NODE(node._node) = child;
-      result.push_back(node);
-    }
-  }
-  return result;
+  OmXmlNode first;
+  first._node = PUGI_XNODE(_node).child(name).internal_object();
+  first._lock = _lock;
+  return OmXmlNodeRange(first, name);
 }
 
 
@@ -473,10 +509,11 @@ OmXmlNodeArray OmXmlNode::children(const OmWString& name) const
 void OmXmlNode::children(OmXmlNodeArray& result, const OmWString& name) const
 {
   result.clear();
-  for(pugi::xml_node child = PUGI_NODE(_node)->first_child(); child; child = child.next_sibling()) {
+  for(pugi::xml_node child = PUGI_XNODE(_node).first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       OmXmlNode node;
-      *PUGI_NODE(node._node) = child;
+      node._node = child.internal_object();
+      node._lock = _lock;
       result.push_back(node);
     }
   }
@@ -488,8 +525,25 @@ void OmXmlNode::children(OmXmlNodeArray& result, const OmWString& name) const
 ///
 OmXmlNode OmXmlNode::addChild(const OmWString& name)
 {
+  __doc_lock lock(_lock);
+
   OmXmlNode result;
-  *static_cast<pugi::xml_node*>(result._node) = PUGI_NODE(_node)->append_child(name.c_str());
+  result._node = PUGI_XNODE(_node).append_child(name.c_str()).internal_object();
+  result._lock = _lock;
+  return result;
+}
+
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmXmlNode OmXmlNode::insertChild(const OmWString& name, const OmXmlNode& next)
+{
+  __doc_lock lock(_lock);
+
+  OmXmlNode result;
+  result._node = PUGI_XNODE(_node).insert_child_before(name.c_str(), PUGI_XNODE(next._node)).internal_object();
+  result._lock = _lock;
   return result;
 }
 
@@ -499,7 +553,9 @@ OmXmlNode OmXmlNode::addChild(const OmWString& name)
 ///
 bool OmXmlNode::remChild(const OmXmlNode& child)
 {
-  return PUGI_NODE(_node)->remove_child(*PUGI_NODE(child._node));
+  __doc_lock lock(_lock);
+
+  return PUGI_XNODE(_node).remove_child(PUGI_XNODE(child._node));
 }
 
 
@@ -508,7 +564,9 @@ bool OmXmlNode::remChild(const OmXmlNode& child)
 ///
 bool OmXmlNode::remChild(const OmWString& name)
 {
-  return PUGI_NODE(_node)->remove_child(name.c_str());
+  __doc_lock lock(_lock);
+
+  return PUGI_XNODE(_node).remove_child(name.c_str());
 }
 
 
@@ -517,8 +575,22 @@ bool OmXmlNode::remChild(const OmWString& name)
 ///
 void OmXmlNode::clear()
 {
-  delete PUGI_NODE(_node);
-  _node = new pugi::xml_node;
+  _node = nullptr;
+}
+
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmXmlNodeRange::iterator& OmXmlNodeRange::iterator::operator++()
+{
+  if(_name) {
+    _node._node = PUGI_XNODE(_node._node).next_sibling(_name).internal_object();
+  } else {
+    _node._node = PUGI_XNODE(_node._node).next_sibling().internal_object();
+  }
+
+  return *this;
 }
 
 
@@ -656,7 +728,7 @@ bool OmXmlDoc::empty() const
 OmXmlNode OmXmlDoc::root() const
 {
   OmXmlNode node;
-  *PUGI_NODE(node._node) = PUGI_DOC(_docu)->document_element();
+  node._node = PUGI_DOC(_docu)->document_element().internal_object();
   return node;
 }
 
@@ -682,7 +754,7 @@ OmXmlNode OmXmlDoc::child(unsigned i) const
   unsigned n = 0;
   for(pugi::xml_node child = PUGI_DOC(_docu)->first_child(); child; child = child.next_sibling()) {
     if(n == i) {
-      *static_cast<pugi::xml_node*>(result._node) = child;
+      result._node = child.internal_object();
       return result;
     }
     ++n;
@@ -694,16 +766,11 @@ OmXmlNode OmXmlDoc::child(unsigned i) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmXmlNodeArray OmXmlDoc::children() const
+OmXmlNodeRange OmXmlDoc::children() const
 {
-  OmXmlNodeArray result;
-
-  for(pugi::xml_node child = PUGI_DOC(_docu)->first_child(); child; child = child.next_sibling()) {
-    OmXmlNode node;
-    *static_cast<pugi::xml_node*>(node._node) = child;
-    result.push_back(node);
-  }
-  return result;
+  OmXmlNode first;
+  first._node = PUGI_DOC(_docu)->first_child().internal_object();
+  return OmXmlNodeRange(first, nullptr);
 }
 
 
@@ -715,7 +782,7 @@ void OmXmlDoc::children(OmXmlNodeArray& result) const
   result.clear();
   for(pugi::xml_node child = PUGI_DOC(_docu)->first_child(); child; child = child.next_sibling()) {
     OmXmlNode node;
-    *PUGI_NODE(node._node) = child;
+    node._node = child.internal_object();
     result.push_back(node);
   }
 }
@@ -761,7 +828,7 @@ OmXmlNode OmXmlDoc::child(const OmWString& name, unsigned i) const
   for(pugi::xml_node child = PUGI_DOC(_docu)->first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       if(n == i) {
-        *PUGI_NODE(result._node) = child;
+        result._node = child.internal_object();
         return result;
       }
       ++n;
@@ -775,18 +842,11 @@ OmXmlNode OmXmlDoc::child(const OmWString& name, unsigned i) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmXmlNodeArray OmXmlDoc::children(const OmWString& name) const
+OmXmlNodeRange OmXmlDoc::children(const wchar_t* name) const
 {
-  OmXmlNodeArray result;
-
-  for(pugi::xml_node child = PUGI_DOC(_docu)->first_child(); child; child = child.next_sibling()) {
-    if(!wcscmp(name.c_str(), child.name())) {
-      OmXmlNode node;
-      *PUGI_NODE(node._node) = child;
-      result.push_back(node);
-    }
-  }
-  return result;
+  OmXmlNode first;
+  first._node = PUGI_DOC(_docu)->child(name).internal_object();
+  return OmXmlNodeRange(first, name);
 }
 
 
@@ -799,7 +859,7 @@ void OmXmlDoc::children(OmXmlNodeArray& result, const OmWString& name) const
   for(pugi::xml_node child = PUGI_DOC(_docu)->first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       OmXmlNode node;
-      *PUGI_NODE(node._node) = child;
+      node._node = child.internal_object();
       result.push_back(node);
     }
   }
@@ -812,7 +872,18 @@ void OmXmlDoc::children(OmXmlNodeArray& result, const OmWString& name) const
 OmXmlNode OmXmlDoc::addChild(const OmWString& name)
 {
   OmXmlNode result;
-  *PUGI_NODE(result._node) = PUGI_DOC(_docu)->append_child(name.c_str());
+  result._node = PUGI_DOC(_docu)->append_child(name.c_str()).internal_object();
+  return result;
+}
+
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmXmlNode OmXmlDoc::insertChild(const OmWString& name, const OmXmlNode& next)
+{
+  OmXmlNode result;
+  result._node = PUGI_DOC(_docu)->insert_child_before(name.c_str(), PUGI_XNODE(next._node)).internal_object();
   return result;
 }
 
@@ -822,7 +893,7 @@ OmXmlNode OmXmlDoc::addChild(const OmWString& name)
 ///
 bool OmXmlDoc::remChild(const OmXmlNode& child)
 {
-  return PUGI_DOC(_docu)->remove_child(*PUGI_NODE(child._node));
+  return PUGI_DOC(_docu)->remove_child(PUGI_XNODE(child._node));
 }
 
 
@@ -920,12 +991,114 @@ OmWString OmXmlDoc::lastErrorStr() const
 
 
 
+/// \brief Write-behind context
+///
+/// Structure shared between XML config and its write-behind thread. The
+/// lock is the owner document lock, it also protects context members.
+///
+typedef struct {
+
+  void*               lock;
+
+  void*               wake_hev;
+
+  void*               hth;
+
+  pugi::xml_document* docu;
+
+  OmWString           path;
+
+  uint64_t            stamp;
+
+  uint32_t            delay;
+
+  bool                pending;
+
+  bool                stop;
+
+  bool                failed;
+
+} __flush_ctx_t;
+
+/// \brief Save document atomically
+///
+/// Save document to temporary file then replace destination file by
+/// the temporary one, so the destination is never left truncated.
+///
+static bool __save_atomic(const pugi::xml_document* doc, const OmWString& path)
+{
+  OmWString temp_path = path;
+  temp_path += L".tmp";
+
+  if(!doc->save_file(temp_path.c_str(), L"  ", pugi::format_default|pugi::format_save_file_text, pugi::encoding_utf8))
+    return false;
+
+  if(0 != Om_pltFileMove(temp_path, path)) {
+    Om_pltFileDelete(temp_path);
+    return false;
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static uint32_t __flush_run_fn(void* ptr)
+{
+  __flush_ctx_t* ctx = static_cast<__flush_ctx_t*>(ptr);
+
+  pugi::xml_document doc;
+  OmWString path;
+
+  while(true) {
+
+    Om_pltLockEnter(ctx->lock);
+
+    bool pending = ctx->pending;
+    bool stop = ctx->stop;
+    uint32_t delay = ctx->delay;
+    uint64_t elapsed = Om_pltTickCount() - ctx->stamp;
+
+    // wait until no new save occurred during delay, unless asked to stop,
+    // then take a snapshot of the owner document, which is locked
+    if(pending && (stop || elapsed >= delay)) {
+      doc.reset(*ctx->docu);
+      path = ctx->path;
+      ctx->pending = false;
+    }
+
+    Om_pltLockLeave(ctx->lock);
+
+    if(!pending) {
+      if(stop) break;
+      Om_pltEventWait(ctx->wake_hev);
+      continue;
+    }
+
+    if(!stop && elapsed < delay) {
+      Om_pltEventWait(ctx->wake_hev, static_cast<uint32_t>(delay - elapsed));
+      continue;
+    }
+
+    if(!__save_atomic(&doc, path)) {
+      Om_pltLockEnter(ctx->lock);
+      ctx->failed = true;
+      Om_pltLockLeave(ctx->lock);
+    }
+  }
+
+  return 0;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 OmXmlConf::OmXmlConf() :
   _docu(new pugi::xml_document),
   _root(new pugi::xml_node),
+  _lock(Om_pltLockCreate()),
+  _flush(nullptr),
   _ercode(0),
   _erpoff(0)
 {
@@ -939,6 +1112,8 @@ OmXmlConf::OmXmlConf() :
 OmXmlConf::OmXmlConf(const OmXmlConf& other) :
   _docu(new pugi::xml_document),
   _root(new pugi::xml_node),
+  _lock(Om_pltLockCreate()),
+  _flush(nullptr),
   _ercode(0),
   _erpoff(0)
 {
@@ -953,6 +1128,8 @@ OmXmlConf::OmXmlConf(const OmXmlConf& other) :
 OmXmlConf::OmXmlConf(const OmWString& sign) :
   _docu(new pugi::xml_document),
   _root(new pugi::xml_node),
+  _lock(Om_pltLockCreate()),
+  _flush(nullptr),
   _ercode(0),
   _erpoff(0)
 {
@@ -964,8 +1141,12 @@ OmXmlConf::OmXmlConf(const OmWString& sign) :
 ///
 OmXmlConf::~OmXmlConf()
 {
+  this->setWriteBehind(0);
+
   delete PUGI_DOC(_docu);
   delete PUGI_NODE(_root);
+
+  Om_pltLockClose(_lock);
 }
 
 
@@ -974,6 +1155,8 @@ OmXmlConf::~OmXmlConf()
 ///
 OmXmlConf& OmXmlConf::operator=(const OmXmlConf& other)
 {
+  this->flush();
+
   PUGI_DOC(_docu)->reset(*PUGI_DOC(other._docu));
   *PUGI_NODE(_root) = PUGI_DOC(_docu)->document_element();
   _ercode = 0;
@@ -1061,40 +1244,152 @@ void OmXmlConf::init(const OmWString& path, const OmWString& sign)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmXmlConf::save()
-{
-  if(!PUGI_DOC(_docu)->empty() && _path.size()) {
-
-    if(!PUGI_DOC(_docu)->save_file(_path.c_str(), L"  ", pugi::format_default|pugi::format_save_file_text, pugi::encoding_utf8)) {
-      _ercode = pugi::status_io_error;
-      return false;
-    }
-
-    return true;
-  }
-
-  return false;
-}
-
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool OmXmlConf::save(const OmWString& path)
-{
-  if(!PUGI_DOC(_docu)->empty()) {
-
-    if(!PUGI_DOC(_docu)->save_file(path.c_str(), L"  ", pugi::format_default|pugi::format_save_file_text, pugi::encoding_utf8)) {
-      _ercode = pugi::status_io_error;
-      return false;
-    }
-
-    return true;
-  }
-
-  return false;
-}
-
+bool OmXmlConf::save()
+{
+  if(!PUGI_DOC(_docu)->empty() && _path.size()) {
+
+    if(_flush) {
+
+      // write-behind, we only mark document as modified, the snapshot is
+      // taken by the thread once delay expired
+      __flush_ctx_t* ctx = static_cast<__flush_ctx_t*>(_flush);
+
+      Om_pltLockEnter(ctx->lock);
+      ctx->path = _path;
+      ctx->stamp = Om_pltTickCount();
+      ctx->pending = true;
+      Om_pltLockLeave(ctx->lock);
+
+      if(!ctx->hth)
+        ctx->hth = Om_pltThreadCreate(__flush_run_fn, ctx);
+
+      // if thread creation failed, we save now
+      if(!ctx->hth)
+        return this->flush();
+
+      Om_pltEventSet(ctx->wake_hev);
+
+      return true;
+    }
+
+    if(!__save_atomic(PUGI_DOC(_docu), _path)) {
+      _ercode = pugi::status_io_error;
+      return false;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmXmlConf::save(const OmWString& path)
+{
+  if(!PUGI_DOC(_docu)->empty()) {
+
+    if(!__save_atomic(PUGI_DOC(_docu), path)) {
+      _ercode = pugi::status_io_error;
+      return false;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmXmlConf::setWriteBehind(uint32_t delay)
+{
+  if(delay) {
+
+    if(!_flush) {
+
+      __flush_ctx_t* ctx = new __flush_ctx_t;
+      ctx->lock = _lock;
+      ctx->wake_hev = Om_pltEventCreate(false);
+      ctx->hth = nullptr;
+      ctx->docu = PUGI_DOC(_docu);
+      ctx->delay = 0;
+      ctx->stamp = 0;
+      ctx->pending = false;
+      ctx->stop = false;
+      ctx->failed = false;
+
+      _flush = ctx;
+    }
+
+    __flush_ctx_t* ctx = static_cast<__flush_ctx_t*>(_flush);
+
+    Om_pltLockEnter(ctx->lock);
+    ctx->delay = delay;
+    Om_pltLockLeave(ctx->lock);
+
+    Om_pltEventSet(ctx->wake_hev);
+
+  } else {
+
+    if(_flush) {
+
+      this->flush();
+
+      __flush_ctx_t* ctx = static_cast<__flush_ctx_t*>(_flush);
+      Om_pltEventClose(ctx->wake_hev);
+      delete ctx;
+
+      _flush = nullptr;
+    }
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmXmlConf::flush()
+{
+  if(!_flush)
+    return true;
+
+  __flush_ctx_t* ctx = static_cast<__flush_ctx_t*>(_flush);
+
+  if(ctx->hth) {
+
+    // ask thread to write pending snapshot now and quit
+    Om_pltLockEnter(ctx->lock);
+    ctx->stop = true;
+    Om_pltLockLeave(ctx->lock);
+
+    Om_pltEventSet(ctx->wake_hev);
+
+    Om_pltThreadJoin(ctx->hth);
+
+    ctx->hth = nullptr;
+    ctx->stop = false;
+  }
+
+  // save may remain pending if thread could not be started
+  if(ctx->pending) {
+    ctx->pending = false;
+    if(!__save_atomic(ctx->docu, ctx->path))
+      ctx->failed = true;
+  }
+
+  bool result = !ctx->failed;
+
+  if(ctx->failed) {
+    _ercode = pugi::status_io_error;
+    ctx->failed = false;
+  }
+
+  return result;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -1145,7 +1440,8 @@ OmXmlNode OmXmlConf::child(unsigned i) const
   unsigned n = 0;
   for(pugi::xml_node child = PUGI_NODE(_root)->first_child(); child; child = child.next_sibling()) {
     if(n == i) {
-      *PUGI_NODE(result._node) = child;
+      result._node = child.internal_object();
+      result._lock = _lock;
       return result;
     }
     ++n;
@@ -1157,16 +1453,12 @@ OmXmlNode OmXmlConf::child(unsigned i) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmXmlNodeArray OmXmlConf::children() const
+OmXmlNodeRange OmXmlConf::children() const
 {
-  OmXmlNodeArray result;
-
-  for(pugi::xml_node child = PUGI_NODE(_root)->first_child(); child; child = child.next_sibling()) {
-    OmXmlNode node;
-    *static_cast<pugi::xml_node*>(node._node) = child;
-    result.push_back(node);
-  }
-  return result;
+  OmXmlNode first;
+  first._node = PUGI_NODE(_root)->first_child().internal_object();
+  first._lock = _lock;
+  return OmXmlNodeRange(first, nullptr);
 }
 
 
@@ -1178,7 +1470,8 @@ void OmXmlConf::children(OmXmlNodeArray& result) const
   result.clear();
   for(pugi::xml_node child = PUGI_NODE(_root)->first_child(); child; child = child.next_sibling()) {
     OmXmlNode node;
-    *PUGI_NODE(node._node) = child;
+    node._node = child.internal_object();
+    node._lock = _lock;
     result.push_back(node);
   }
 }
@@ -1224,7 +1517,8 @@ OmXmlNode OmXmlConf::child(const OmWString& name, unsigned i) const
   for(pugi::xml_node child = PUGI_NODE(_root)->first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       if(n == i) {
-        *PUGI_NODE(result._node) = child;
+        result._node = child.internal_object();
+        result._lock = _lock;
         return result;
       }
       ++n;
@@ -1238,18 +1532,12 @@ OmXmlNode OmXmlConf::child(const OmWString& name, unsigned i) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmXmlNodeArray OmXmlConf::children(const OmWString& name) const
+OmXmlNodeRange OmXmlConf::children(const wchar_t* name) const
 {
-  OmXmlNodeArray result;
-
-  for(pugi::xml_node child = PUGI_NODE(_root)->first_child(); child; child = child.next_sibling()) {
-    if(!wcscmp(name.c_str(), child.name())) {
-      OmXmlNode node;
-      *PUGI_NODE(node._node) = child;
-      result.push_back(node);
-    }
-  }
-  return result;
+  OmXmlNode first;
+  first._node = PUGI_NODE(_root)->child(name).internal_object();
+  first._lock = _lock;
+  return OmXmlNodeRange(first, name);
 }
 
 
@@ -1262,7 +1550,8 @@ void OmXmlConf::children(OmXmlNodeArray& result, const OmWString& name) const
   for(pugi::xml_node child = PUGI_NODE(_root)->first_child(); child; child = child.next_sibling()) {
     if(!wcscmp(name.c_str(), child.name())) {
       OmXmlNode node;
-      *PUGI_NODE(node._node) = child;
+      node._node = child.internal_object();
+      node._lock = _lock;
       result.push_back(node);
     }
   }
@@ -1284,7 +1573,8 @@ OmXmlNode OmXmlConf::child(const OmWString& name, const OmWString& attr, const O
       xml_attr = child.attribute(attr.c_str());
       if(!xml_attr.empty()) {
         if(!wcscmp(value.c_str(), xml_attr.as_string())) {
-          *PUGI_NODE(result._node) = child;
+          result._node = child.internal_object();
+          result._lock = _lock;
           return result;
         }
       }
@@ -1299,8 +1589,25 @@ OmXmlNode OmXmlConf::child(const OmWString& name, const OmWString& attr, const O
 ///
 OmXmlNode OmXmlConf::addChild(const OmWString& name)
 {
+  __doc_lock lock(_lock);
+
+  OmXmlNode result;
+  result._node = PUGI_NODE(_root)->append_child(name.c_str()).internal_object();
+  result._lock = _lock;
+  return result;
+}
+
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmXmlNode OmXmlConf::insertChild(const OmWString& name, const OmXmlNode& next)
+{
+  __doc_lock lock(_lock);
+
   OmXmlNode result;
-  *PUGI_NODE(result._node) = PUGI_NODE(_root)->append_child(name.c_str());
+  result._node = PUGI_NODE(_root)->insert_child_before(name.c_str(), PUGI_XNODE(next._node)).internal_object();
+  result._lock = _lock;
   return result;
 }
 
@@ -1310,7 +1617,9 @@ OmXmlNode OmXmlConf::addChild(const OmWString& name)
 ///
 bool OmXmlConf::remChild(const OmXmlNode& child)
 {
-  return PUGI_NODE(_root)->remove_child(*PUGI_NODE(child._node));
+  __doc_lock lock(_lock);
+
+  return PUGI_NODE(_root)->remove_child(PUGI_XNODE(child._node));
 }
 
 
@@ -1319,6 +1628,8 @@ bool OmXmlConf::remChild(const OmXmlNode& child)
 ///
 bool OmXmlConf::remChild(const OmWString& name)
 {
+  __doc_lock lock(_lock);
+
   return PUGI_NODE(_root)->remove_child(name.c_str());
 }
 
@@ -1326,8 +1637,10 @@ bool OmXmlConf::remChild(const OmWString& name)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmXmlConf::clear()
+void OmXmlConf::clear()
 {
+  this->flush();
+
   *PUGI_NODE(_root) = pugi::xml_node();
   PUGI_DOC(_docu)->reset();
   _path.clear();
@@ -0,0 +1,507 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "OmBase.h"           //< string, vector, Om_alloc, OM_MAX_PATH, etc.
+
+#include "OmUtilStr.h"
+
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmXmlReader.h"
+
+/// \brief Check XML whitespace
+///
+/// Checks whether the given character is an XML whitespace.
+///
+/// \param[in]  c       : Character to check.
+///
+/// \return True if character is whitespace, false otherwise.
+///
+static inline bool __is_space(char c)
+{
+  return (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+}
+
+/// \brief Check markup prefix
+///
+/// Compares buffer at the given position with the specified markup prefix,
+/// taking in account the buffer may not yet hold enough data.
+///
+/// \param[in]  buf     : Buffer to check.
+/// \param[in]  pos     : Position in buffer.
+/// \param[in]  str     : Prefix string to compare.
+///
+/// \return 1 if prefix matches, 0 if not, -1 if more data is needed.
+///
+static inline int __match_prefix(const OmCString& buf, size_t pos, const char* str)
+{
+  size_t len = strlen(str);
+  size_t avail = buf.size() - pos;
+  size_t n = (avail < len) ? avail : len;
+
+  if(buf.compare(pos, n, str, n) != 0)
+    return 0;
+
+  return (n < len) ? -1 : 1;
+}
+
+/// \brief Append Unicode code point
+///
+/// Appends the given Unicode code point to string as UTF-8 sequence.
+///
+/// \param[out] str     : String to append sequence to.
+/// \param[in]  u       : Unicode code point.
+///
+static inline void __append_utf8(OmCString* str, uint32_t u)
+{
+  if(u < 0x80) {
+    str->push_back(static_cast<char>(u));
+  } else if(u < 0x800) {
+    str->push_back(static_cast<char>(0xC0 | (u >> 6)));
+    str->push_back(static_cast<char>(0x80 | (u & 0x3F)));
+  } else if(u < 0x10000) {
+    str->push_back(static_cast<char>(0xE0 | (u >> 12)));
+    str->push_back(static_cast<char>(0x80 | ((u >> 6) & 0x3F)));
+    str->push_back(static_cast<char>(0x80 | (u & 0x3F)));
+  } else if(u < 0x110000) {
+    str->push_back(static_cast<char>(0xF0 | (u >> 18)));
+    str->push_back(static_cast<char>(0x80 | ((u >> 12) & 0x3F)));
+    str->push_back(static_cast<char>(0x80 | ((u >> 6) & 0x3F)));
+    str->push_back(static_cast<char>(0x80 | (u & 0x3F)));
+  }
+}
+
+/// \brief Decode character data
+///
+/// Appends the given character data to string, replacing entity and
+/// character references by their values and normalizing line breaks.
+///
+/// \param[out] str     : String to append decoded data to.
+/// \param[in]  data    : Pointer to character data to decode.
+/// \param[in]  size    : Size of character data.
+/// \param[in]  attr    : Character data is an attribute value.
+///
+static void __decode_chars(OmCString* str, const char* data, size_t size, bool attr)
+{
+  size_t i = 0;
+
+  while(i < size) {
+
+    // copy run of plain characters
+    size_t j = i;
+    while(j < size && data[j] != '&' && data[j] != '\r' && !(attr && (data[j] == '\n' || data[j] == '\t')))
+      ++j;
+
+    str->append(data + i, j - i);
+
+    if(j >= size)
+      break;
+
+    i = j;
+
+    if(data[i] == '\r') {
+      // CR LF or single CR become LF, or space in attribute
+      str->push_back(attr ? ' ' : '\n');
+      i += (i + 1 < size && data[i + 1] == '\n') ? 2 : 1;
+      continue;
+    }
+
+    if(data[i] != '&') {
+      // whitespace in attribute value
+      str->push_back(' ');
+      ++i;
+      continue;
+    }
+
+    // entity or character reference
+    const char* e = static_cast<const char*>(memchr(data + i, ';', size - i));
+
+    if(!e) { //< not a reference, keep as is
+      str->push_back('&');
+      ++i;
+      continue;
+    }
+
+    const char* r = data + i + 1;
+    size_t n = e - r;
+
+    if(n > 1 && r[0] == '#') {
+
+      uint32_t u = (r[1] == 'x') ? strtoul(r + 2, nullptr, 16) : strtoul(r + 1, nullptr, 10);
+      __append_utf8(str, u);
+
+    } else if(n == 2 && r[0] == 'l' && r[1] == 't') {
+      str->push_back('<');
+    } else if(n == 2 && r[0] == 'g' && r[1] == 't') {
+      str->push_back('>');
+    } else if(n == 3 && memcmp(r, "amp", 3) == 0) {
+      str->push_back('&');
+    } else if(n == 4 && memcmp(r, "quot", 4) == 0) {
+      str->push_back('"');
+    } else if(n == 4 && memcmp(r, "apos", 4) == 0) {
+      str->push_back('\'');
+    } else { //< unknown entity, keep as is
+      str->push_back('&');
+      ++i;
+      continue;
+    }
+
+    i = (e - data) + 1;
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmXmlReader::OmXmlReader() :
+  _pos(0),
+  _done(false),
+  _depth(0),
+  _empty(false),
+  _root(false),
+  _reset(false)
+{
+
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmXmlReader::~OmXmlReader()
+{
+
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmXmlReader::clear()
+{
+  this->_buf.clear();
+  this->_pos = 0;
+  this->_done = false;
+  this->_stack.clear();
+  this->_depth = 0;
+  this->_empty = false;
+  this->_root = false;
+  this->_reset = false;
+  this->_name.clear();
+  this->_attr_name.clear();
+  this->_attr_value.clear();
+  this->_text.clear();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmXmlReader::feed(const uint8_t* data, size_t size)
+{
+  // discard already parsed data, only incomplete token remains
+  if(this->_pos) {
+    this->_buf.erase(0, this->_pos);
+    this->_pos = 0;
+  }
+
+  this->_buf.append(reinterpret_cast<const char*>(data), size);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int OmXmlReader::next()
+{
+  // previous event text no longer relevant
+  if(this->_reset) {
+    this->_text.clear();
+    this->_reset = false;
+  }
+
+  // close the previous empty-element tag
+  if(this->_empty) {
+    this->_empty = false;
+    this->_depth = this->_stack.size();
+    this->_stack.pop_back();
+    this->_attr_name.clear();
+    this->_attr_value.clear();
+    this->_reset = true;
+    return OM_XMLREAD_CLOSE;
+  }
+
+  const OmCString& buf = this->_buf;
+
+  while(true) {
+
+    size_t size = buf.size();
+
+    if(this->_pos >= size) {
+
+      if(!this->_done)
+        return OM_XMLREAD_MORE;
+
+      return (this->_root && this->_stack.empty()) ? OM_XMLREAD_END : OM_XMLREAD_ERROR;
+    }
+
+    if(buf[this->_pos] != '<') {
+
+      // character data up to next markup
+      size_t end = buf.find('<', this->_pos);
+
+      if(end == OmCString::npos) {
+
+        end = size;
+
+        if(!this->_done) {
+          // keep incomplete reference or line break for next round
+          size_t amp = buf.rfind('&');
+          if(amp != OmCString::npos && amp >= this->_pos && buf.find(';', amp) == OmCString::npos)
+            end = amp;
+          if(end > this->_pos && buf[end - 1] == '\r')
+            end--;
+        }
+      }
+
+      // character data outside root element is ignored
+      if(!this->_stack.empty())
+        __decode_chars(&this->_text, buf.data() + this->_pos, end - this->_pos, false);
+
+      if(end == this->_pos)
+        return OM_XMLREAD_MORE;
+
+      this->_pos = end;
+      continue;
+    }
+
+    int m;
+    size_t end;
+
+    // processing instruction or XML declaration
+    if((m = __match_prefix(buf, this->_pos, "<?")) != 0) {
+      if(m < 0 || (end = buf.find("?>", this->_pos + 2)) == OmCString::npos)
+        return this->_done ? OM_XMLREAD_ERROR : OM_XMLREAD_MORE;
+      this->_pos = end + 2;
+      continue;
+    }
+
+    // comment
+    if((m = __match_prefix(buf, this->_pos, "<!--")) != 0) {
+      if(m < 0 || (end = buf.find("-->", this->_pos + 4)) == OmCString::npos)
+        return this->_done ? OM_XMLREAD_ERROR : OM_XMLREAD_MORE;
+      this->_pos = end + 3;
+      continue;
+    }
+
+    // CDATA section
+    if((m = __match_prefix(buf, this->_pos, "<![CDATA[")) != 0) {
+      if(m < 0 || (end = buf.find("]]>", this->_pos + 9)) == OmCString::npos)
+        return this->_done ? OM_XMLREAD_ERROR : OM_XMLREAD_MORE;
+      if(!this->_stack.empty())
+        this->_text.append(buf, this->_pos + 9, end - (this->_pos + 9));
+      this->_pos = end + 3;
+      continue;
+    }
+
+    // document type declaration, internal subset not supported
+    if((m = __match_prefix(buf, this->_pos, "<!")) != 0) {
+      if(m < 0 || (end = buf.find('>', this->_pos + 2)) == OmCString::npos)
+        return this->_done ? OM_XMLREAD_ERROR : OM_XMLREAD_MORE;
+      this->_pos = end + 1;
+      continue;
+    }
+
+    // end tag
+    if((m = __match_prefix(buf, this->_pos, "</")) != 0) {
+
+      if(m < 0 || (end = buf.find('>', this->_pos + 2)) == OmCString::npos)
+        return this->_done ? OM_XMLREAD_ERROR : OM_XMLREAD_MORE;
+
+      size_t e = end;
+      while(e > this->_pos + 2 && __is_space(buf[e - 1]))
+        e--;
+
+      // end tag must match the currently opened element
+      if(this->_stack.empty() || buf.compare(this->_pos + 2, e - (this->_pos + 2), this->_stack.back()) != 0)
+        return OM_XMLREAD_ERROR;
+
+      this->_name = this->_stack.back();
+      this->_depth = this->_stack.size();
+      this->_stack.pop_back();
+      this->_attr_name.clear();
+      this->_attr_value.clear();
+
+      this->_pos = end + 1;
+      this->_reset = true;
+      return OM_XMLREAD_CLOSE;
+    }
+
+    // start tag, search closing bracket outside of quoted values
+    char quote = 0;
+    for(end = this->_pos + 1; end < size; ++end) {
+      char c = buf[end];
+      if(quote) {
+        if(c == quote) quote = 0;
+      } else {
+        if(c == '"' || c == '\'') quote = c;
+        else if(c == '>') break;
+      }
+    }
+
+    if(end >= size)
+      return this->_done ? OM_XMLREAD_ERROR : OM_XMLREAD_MORE;
+
+    // only one root element allowed
+    if(this->_stack.empty() && this->_root)
+      return OM_XMLREAD_ERROR;
+
+    if(!this->_parse_tag(end))
+      return OM_XMLREAD_ERROR;
+
+    this->_root = true;
+    this->_stack.push_back(this->_name);
+    this->_depth = this->_stack.size();
+
+    this->_pos = end + 1;
+    this->_reset = true;
+    return OM_XMLREAD_OPEN;
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmXmlReader::hasAttr(const char* name) const
+{
+  return (this->_find_attr(name) != nullptr);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmXmlReader::attrAsString(const char* name) const
+{
+  OmWString result;
+
+  const OmCString* value = this->_find_attr(name);
+  if(value)
+    Om_toUTF16(&result, *value);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint64_t OmXmlReader::attrAsUint64(const char* name) const
+{
+  const OmCString* value = this->_find_attr(name);
+  if(value)
+    return strtoull(value->c_str(), nullptr, 10);
+
+  return 0;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmXmlReader::content() const
+{
+  OmWString result;
+  Om_toUTF16(&result, this->_text);
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmXmlReader::_parse_tag(size_t end)
+{
+  const char* p = this->_buf.data();
+  size_t i = this->_pos + 1;
+
+  this->_attr_name.clear();
+  this->_attr_value.clear();
+
+  // empty-element tag
+  if(end > i && p[end - 1] == '/') {
+    this->_empty = true;
+    end--;
+  }
+
+  // element name
+  size_t s = i;
+  while(i < end && !__is_space(p[i]))
+    ++i;
+
+  if(i == s)
+    return false;
+
+  this->_name.assign(p + s, i - s);
+
+  // attributes
+  while(true) {
+
+    while(i < end && __is_space(p[i]))
+      ++i;
+
+    if(i >= end)
+      break;
+
+    s = i;
+    while(i < end && p[i] != '=' && !__is_space(p[i]))
+      ++i;
+
+    size_t n = i - s;
+
+    while(i < end && __is_space(p[i]))
+      ++i;
+
+    if(n == 0 || i >= end || p[i] != '=')
+      return false;
+
+    ++i;
+
+    while(i < end && __is_space(p[i]))
+      ++i;
+
+    if(i >= end || (p[i] != '"' && p[i] != '\''))
+      return false;
+
+    char quote = p[i++];
+
+    const char* q = static_cast<const char*>(memchr(p + i, quote, end - i));
+    if(!q)
+      return false;
+
+    this->_attr_name.push_back(OmCString(p + s, n));
+    this->_attr_value.push_back(OmCString());
+    __decode_chars(&this->_attr_value.back(), p + i, q - (p + i), true);
+
+    i = (q - p) + 1;
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+const OmCString* OmXmlReader::_find_attr(const char* name) const
+{
+  for(size_t i = 0; i < this->_attr_name.size(); ++i) {
+    if(this->_attr_name[i].compare(name) == 0)
+      return &this->_attr_value[i];
+  }
+
+  return nullptr;
+}